@@ -73,7 +73,9 @@ layout (std140) uniform Spotlights {
     Spotlight spotlights[MAX_SPOT_LIGHT_COUNT];
 };
 
-uniform sampler2DArrayShadow spotShadowMaps;
+#ifdef ENGINE_SHADOWS
+    uniform sampler2DArrayShadow spotShadowMaps;
+#endif
 uniform int isSpotlightCulled[MAX_SPOT_LIGHT_COUNT];
 
 // ------------------------------------------------------------------------------------------------
@@ -194,12 +196,14 @@ vec3 calculateColorFromLights(vec3 fragmentPosition, vec3 fragmentNormalUnit, ve
         // Combine with shadow.
         vec3 light = fragmentDiffuseColor * attenuatedLightColor;
         float lightFactor = 1.0F;
-        if (spotlights[i].iShadowMapIndex >= 0) {
-            vec3 adjustedPos = fragmentPosition + fragmentNormalUnit * 0.025F; // <- normal bias
-            vec3 fragmentShadowCoords = convertWorldPosToShadowMapSpace(
-                adjustedPos, spotlights[i].viewProjectionMatrix);
-            lightFactor = texture(spotShadowMaps, vec4(fragmentShadowCoords.xy, spotlights[i].iShadowMapIndex, fragmentShadowCoords.z));
-        }
+        #ifdef ENGINE_SHADOWS
+            if (spotlights[i].iShadowMapIndex >= 0) {
+                vec3 adjustedPos = fragmentPosition + fragmentNormalUnit * 0.025F; // <- normal bias
+                vec3 fragmentShadowCoords = convertWorldPosToShadowMapSpace(
+                    adjustedPos, spotlights[i].viewProjectionMatrix);
+                lightFactor = texture(spotShadowMaps, vec4(fragmentShadowCoords.xy, spotlights[i].iShadowMapIndex, fragmentShadowCoords.z));
+            }
+        #endif
         lightColor += light * lightFactor;
     }
 
@@ -7,13 +7,17 @@ in vec3 viewSpacePosition;
 
 uniform vec4 diffuseColor;
 
-uniform sampler2D diffuseTexture;
-uniform vec2 textureTilingMultiplier; // stores -1 if diffuseTexture is not set
-uniform vec2 textureUvOffset;
+#ifdef ENGINE_DIFFUSE_TEXTURE
+    uniform sampler2D diffuseTexture;
+    uniform vec2 textureTilingMultiplier;
+    uniform vec2 textureUvOffset;
+#endif
 
-// Distance fog settings.
-uniform vec3 distanceFogColor;
-uniform vec2 distanceFogRange; // -1 if distance fog disabled
+#ifdef ENGINE_DISTANCE_FOG
+    // Distance fog settings.
+    uniform vec3 distanceFogColor;
+    uniform vec2 distanceFogRange; // -1 if distance fog is disabled in the world
+#endif
 
 #ifdef ENGINE_EDITOR
     // Used for GPU picking.
@@ -36,19 +40,20 @@ void main() {
 
     // Diffuse color.
     vec4 fragmentDiffuseColor = diffuseColor;
-    bool bIsUsingDiffuseTexture = textureTilingMultiplier.x >= 0.0F;
-    if (bIsUsingDiffuseTexture) {
+    #ifdef ENGINE_DIFFUSE_TEXTURE
         fragmentDiffuseColor *= texture(diffuseTexture, (fragmentUv + textureUvOffset) * textureTilingMultiplier);
-    }
+    #endif
 
     // Light.
     vec3 lightColor = calculateColorFromLights(fragmentPosition, fragmentNormalUnit, fragmentDiffuseColor.rgb);
 
     // Distance fog.
-    if (distanceFogRange.x >= 0.0F) {
-        float fogPortion = smoothstep(distanceFogRange.x, distanceFogRange.y, length(viewSpacePosition));
-        lightColor = mix(lightColor, distanceFogColor, fogPortion);
-    }
+    #ifdef ENGINE_DISTANCE_FOG
+        if (distanceFogRange.x >= 0.0F) {
+            float fogPortion = smoothstep(distanceFogRange.x, distanceFogRange.y, length(viewSpacePosition));
+            lightColor = mix(lightColor, distanceFogColor, fogPortion);
+        }
+    #endif
 
     // Define this macro before including this file to add custom logic in a simple way:
     #ifdef CUSTOM_CODE
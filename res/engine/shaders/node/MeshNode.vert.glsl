@@ -11,11 +11,17 @@ uniform mat4 worldMatrix;
 uniform mat3 normalMatrix;
 uniform mat4 viewMatrix;
 uniform mat4 viewProjectionMatrix;
-uniform float outlineWidth;
+#ifdef ENGINE_OUTLINE
+    uniform float outlineWidth;
+#endif
 
 void main() {
     // Calculate position.
-    vec4 posWorldSpace = worldMatrix * vec4(position + normalize(position) * outlineWidth, 1.0F);
+    #ifdef ENGINE_OUTLINE
+        vec4 posWorldSpace = worldMatrix * vec4(position + normalize(position) * outlineWidth, 1.0F);
+    #else
+        vec4 posWorldSpace = worldMatrix * vec4(position, 1.0F);
+    #endif
     gl_Position = viewProjectionMatrix * posWorldSpace;
 
     viewSpacePosition = (viewMatrix * posWorldSpace).xyz;
@@ -193,40 +193,45 @@ void ContentBrowser::showDirectoryContextMenu(const std::filesystem::path& pathT
                      rebuildFileTree();
                  });
              }});
-        vOptions.push_back(
-            {u"Import .gltf/.glb", [this, pathToDirectory]() {
-                 getWorldRootNodeWhileSpawned()->addChildNode(std::make_unique<FileDialogMenu>(
-                     ProjectPaths::getPathToResDirectory(ResourceDirectory::GAME),
-                     std::vector<std::string>{".gltf", ".glb"},
-                     [this, pathToDirectory](const std::filesystem::path& selectedPath) {
-                         // Do async import to view import progress (messages in the log)
-                         // and don't block the whole UI while importing large files.
-                         getGameInstanceWhileSpawned()->addTaskToThreadPool(
-                             [this, selectedPath, pathToDirectory]() {
-                                 const auto sRelativeOutputPath =
-                                     std::filesystem::relative(
-                                         pathToDirectory,
-                                         ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT))
-                                         .string();
+        const auto addGltfImportOption = [&](std::u16string sOptionName, GltfImportOptions importOptions) {
+            vOptions.push_back(
+                {sOptionName, [this, pathToDirectory, importOptions]() {
+                     getWorldRootNodeWhileSpawned()->addChildNode(std::make_unique<FileDialogMenu>(
+                         ProjectPaths::getPathToResDirectory(ResourceDirectory::GAME),
+                         std::vector<std::string>{".gltf", ".glb"},
+                         [this, pathToDirectory, importOptions](const std::filesystem::path& selectedPath) {
+                             // Do async import to view import progress (messages in the log)
+                             // and don't block the whole UI while importing large files.
+                             getGameInstanceWhileSpawned()->addTaskToThreadPool(
+                                 [this, selectedPath, pathToDirectory, importOptions]() {
+                                     const auto sRelativeOutputPath =
+                                         std::filesystem::relative(
+                                             pathToDirectory,
+                                             ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT))
+                                             .string();
 
-                                 const auto optionalError = GltfImporter::importFileAsNodeTree(
-                                     selectedPath,
-                                     sRelativeOutputPath,
-                                     selectedPath.stem().string(),
-                                     [](std::string_view sMessage) { Log::info(sMessage); });
-                                 if (optionalError.has_value()) [[unlikely]] {
-                                     Log::error(std::format(
-                                         "failed to import the file, error: {}",
-                                         optionalError->getInitialMessage()));
-                                 } else {
-                                     Log::info(std::format(
-                                         "file \"{}\" was successfully imported",
-                                         selectedPath.filename().string()));
-                                     rebuildFileTree();
-                                 }
-                             });
-                     }));
-             }});
+                                     const auto optionalError = GltfImporter::importFileAsNodeTree(
+                                         selectedPath,
+                                         sRelativeOutputPath,
+                                         selectedPath.stem().string(),
+                                         [](std::string_view sMessage) { Log::info(sMessage); },
+                                         importOptions);
+                                     if (optionalError.has_value()) [[unlikely]] {
+                                         Log::error(std::format(
+                                             "failed to import the file, error: {}",
+                                             optionalError->getInitialMessage()));
+                                     } else {
+                                         Log::info(std::format(
+                                             "file \"{}\" was successfully imported",
+                                             selectedPath.filename().string()));
+                                         rebuildFileTree();
+                                     }
+                                 });
+                         }));
+                 }});
+        };
+        addGltfImportOption(u"Import .gltf/.glb", GltfImportOptions{});
+        addGltfImportOption(u"Import .gltf/.glb (with LODs)", GltfImportOptions{.iLodCount = 3});
         vOptions.push_back(
             {u"Import collision shape", [this, pathToDirectory]() {
                  getWorldRootNodeWhileSpawned()->addChildNode(std::make_unique<FileDialogMenu>(
@@ -136,15 +136,48 @@ void DebugConsole::onBeforeNewFrame(float timeSincePrevFrameInSec, Renderer* pRe
                 pRenderer->getRenderStatistics().getFramesPerSecond(),
                 pRenderer->getFpsLimit()));
             drawText(sRamStats);
-            drawText(std::format("active moving bodies: {}", stats.iActiveMovingBodyCount));
-            drawText(std::format("active simulated bodies: {}", stats.iActiveSimulatedBodyCount));
+            drawText(std::format(
+                "active moving bodies: {}/{}", stats.iActiveMovingBodyCount, stats.iTotalMovingBodyCount));
+            drawText(std::format(
+                "active simulated bodies: {}/{}",
+                stats.iActiveSimulatedBodyCount,
+                stats.iTotalSimulatedBodyCount));
             drawText(std::format("active character bodies: {}", stats.iActiveCharacterBodyCount));
+            drawText(std::format("animated skeletons: {}", stats.iAnimatedSkeletonCount));
             drawText(std::format("rendered meshes: {}", stats.iRenderedMeshCount));
             drawText(std::format(
                 "rendered lights: {}/{}",
                 stats.iActiveLightSourceCount - stats.iCulledLightSourceCount,
                 stats.iActiveLightSourceCount));
+            drawText(std::format(
+                "textures (KB): resident {}, pending upload {}, uploaded last frame {}, decoding: {}",
+                stats.iTextureResidentBytes / 1024,
+                stats.iTexturePendingUploadBytes / 1024,
+                stats.iTextureUploadedBytesLastFrame / 1024,
+                stats.iDecodingTextureCount));
+            drawText(std::format(
+                "texture budget (KB): {}, reduced: {}, evicted: {}, total evictions: {}",
+                stats.iTextureMemoryBudgetBytes / 1024,
+                stats.iReducedTextureCount,
+                stats.iEvictedTextureCount,
+                stats.iTotalTextureEvictionCount));
+            drawText(std::format(
+                "streamed last frame (KB): {} (region size: {})",
+                stats.iStreamedBytesLastFrame / 1024,
+                stats.iStreamingBufferFrameRegionBytes / 1024));
+            drawText(std::format(
+                "GPU memory (KB, now/peak): VAOs {}/{}, buffers {}/{}, framebuffers {}/{}, textures {}/{}",
+                stats.iGpuVertexArrayBytes / 1024,
+                stats.iGpuVertexArrayPeakBytes / 1024,
+                stats.iGpuBufferBytes / 1024,
+                stats.iGpuBufferPeakBytes / 1024,
+                stats.iGpuFramebufferBytes / 1024,
+                stats.iGpuFramebufferPeakBytes / 1024,
+                stats.iGpuTextureBytes / 1024,
+                stats.iGpuTexturePeakBytes / 1024));
             drawText(std::format("CPU time for game tick (ms): {:.1F}", stats.cpuTickTimeMs));
+            drawText(std::format("- animations: {:.1F}", stats.animationUpdateTimeMs));
+            drawText(std::format("- physics write-back: {:.1F}", stats.physicsWriteBackTimeMs));
             drawText(std::format("CPU time to submit frame (ms): {:.1F}", stats.cpuSubmitFrameTimeMs));
             drawText(std::format("- shadow pass: {:.1F}", stats.cpuTimeToSubmitShadowPassMs));
             drawText(std::format("- depth prepass: {:.1F}", stats.cpuTimeToSubmitDepthPrepassMs));
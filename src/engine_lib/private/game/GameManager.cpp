@@ -11,6 +11,7 @@
 #include "sound/SoundManager.h"
 #include "game/DebugConsole.h"
 #include "game/script/ScriptManager.h"
+#include "game/animation/AnimationManager.h"
 #ifndef ENGINE_UI_ONLY
 #include "game/physics/PhysicsManager.h"
 #endif
@@ -51,6 +52,7 @@ GameManager::GameManager(
     this->pRenderer = std::move(pRenderer);
     this->pGameInstance = std::move(pGameInstance);
     pSoundManager = std::unique_ptr<SoundManager>(new SoundManager());
+    pAnimationManager = std::unique_ptr<AnimationManager>(new AnimationManager(this));
 #ifndef ENGINE_UI_ONLY
     pPhysicsManager = std::unique_ptr<PhysicsManager>(new PhysicsManager(this));
 #endif
@@ -104,6 +106,7 @@ void GameManager::destroy() {
 #ifndef ENGINE_UI_ONLY
     pPhysicsManager = nullptr;
 #endif
+    pAnimationManager = nullptr;
 
     // After game instance, destroy the renderer.
     pRenderer = nullptr;
@@ -399,6 +402,13 @@ void GameManager::onBeforeNewFrame(float timeSincePrevCallInSec) {
             // Tick nodes.
             {
                 PROFILE_SCOPE("tick nodes")
+
+#if defined(ENGINE_DEBUG_TOOLS)
+                // Accumulated by the animation manager for each world.
+                DebugConsole::getStats().iAnimatedSkeletonCount = 0;
+                DebugConsole::getStats().animationUpdateTimeMs = 0.0f;
+#endif
+
                 for (const auto& pWorld : vWorlds) {
                     pWorld->tickTickableNodes(timeSincePrevCallInSec);
                 }
@@ -945,6 +955,8 @@ PhysicsManager& GameManager::getPhysicsManager() const {
     Error::showErrorAndThrowException("physics manager is not available in UI only applications");
 }
 
+AnimationManager& GameManager::getAnimationManager() const { return *pAnimationManager; }
+
 ScriptManager& GameManager::getScriptManager() {
     if (pScriptManager == nullptr) {
         // We are not creating the scripting fuctionality unless it's needed.
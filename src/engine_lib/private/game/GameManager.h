@@ -23,6 +23,7 @@ class CameraManager;
 class SoundManager;
 class PhysicsManager;
 class ScriptManager;
+class AnimationManager;
 
 /**
  * Controls main game objects: game instance, input manager, renderer,
@@ -258,6 +259,13 @@ public:
      */
     ScriptManager& getScriptManager();
 
+    /**
+     * Returns animation manager.
+     *
+     * @return Animation manager.
+     */
+    AnimationManager& getAnimationManager() const;
+
     /**
      * Returns info about existing worlds.
      *
@@ -472,6 +480,9 @@ private:
     /** Manager game scripts. */
     std::unique_ptr<ScriptManager> pScriptManager;
 
+    /** Shares skeletons and animations between skeleton nodes. */
+    std::unique_ptr<AnimationManager> pAnimationManager;
+
 #ifndef ENGINE_UI_ONLY
     /** Manages game physics. */
     std::unique_ptr<PhysicsManager> pPhysicsManager;
@@ -7,13 +7,11 @@
 #include "render/UiNodeManager.h"
 #include "game/camera/CameraManager.h"
 #include "game/GameManager.h"
+#include "game/animation/AnimationManager.h"
 #include "render/MeshRenderer.h"
 #include "render/LightSourceManager.h"
 #include "render/GpuTimeQuery.hpp"
 #include "render/ParticleRenderer.h"
-#if !defined(ENGINE_UI_ONLY)
-#include "game/physics/PhysicsManager.h"
-#endif
 
 World::~World() {
     std::scoped_lock gaurd(mtxRootNode.first);
@@ -79,11 +77,6 @@ World::World(GameManager* pGameManager, const std::string& sName, std::unique_pt
     mtxRootNode.second->spawn();
 
     pUiNodeManager->onNewWorldLoaded();
-
-#if !defined(ENGINE_UI_ONLY)
-    // After we spawned all nodes (maybe from a big node tree) all physics bodies should've been created.
-    getGameManager().getPhysicsManager().optimizeBroadPhase();
-#endif
 }
 
 void World::destroyWorld() {
@@ -157,6 +150,14 @@ void World::tickTickableNodes(float timeSincePrevCallInSec) {
         callTickOnGroup(&mtxTickableNodes.second.firstTickGroup);
         executeTasksAfterNodeTick();
 
+        // Animations use state set by the first tick group and are used by the second one.
+        auto optionalError =
+            pGameManager->getAnimationManager().updateSkeletons(this, timeSincePrevCallInSec);
+        if (optionalError.has_value()) [[unlikely]] {
+            optionalError->addCurrentLocationToErrorStack();
+            optionalError->showErrorAndThrowException();
+        }
+
         callTickOnGroup(&mtxTickableNodes.second.secondTickGroup);
         executeTasksAfterNodeTick();
     }
@@ -0,0 +1,412 @@
+#include "game/animation/AnimationManager.h"
+
+// Standard.
+#include <format>
+#include <fstream>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+
+// Custom.
+#include "game/GameManager.h"
+#include "game/DebugConsole.h"
+#include "io/Serializable.h"
+#include "misc/ProjectPaths.h"
+#include "misc/Error.h"
+#include "misc/Profiler.hpp"
+
+// External.
+#include "ozz/base/io/stream.h"
+#include "ozz/base/io/archive.h"
+
+namespace {
+    /** Minimum number of skeleton nodes that a single job updates. */
+    constexpr size_t MIN_SKELETONS_PER_JOB = 8;
+
+    /** Number of skeleton nodes that can store skinning matrices in a single page. */
+    constexpr size_t SKINNING_SLOTS_PER_PAGE = 64;
+}
+
+AnimationManager::AnimationManager(GameManager* pGameManager) : pGameManager(pGameManager) {
+    // The calling thread also processes jobs.
+    iWorkerThreadCount = std::max(std::thread::hardware_concurrency(), 1U) - 1;
+}
+
+AnimationManager::~AnimationManager() {
+    std::scoped_lock guard(mtxSpawnedSkeletons.first);
+
+    if (!mtxSpawnedSkeletons.second.nodesByWorld.empty()) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format(
+            "animation manager is being destroyed but there are still spawned skeleton nodes in {} world(s)",
+            mtxSpawnedSkeletons.second.nodesByWorld.size()));
+    }
+}
+
+void AnimationManager::registerSkeleton(SkeletonNode* pNode) {
+    std::scoped_lock guard(mtxSpawnedSkeletons.first);
+    auto& spawned = mtxSpawnedSkeletons.second;
+
+    if (pNode->pSkinningMatrices != nullptr) [[unlikely]] {
+        Error::showErrorAndThrowException(
+            std::format("skeleton node \"{}\" is already registered", pNode->getNodeName()));
+    }
+
+    // Get memory for skinning matrices.
+    if (spawned.vFreeSkinningSlots.empty()) {
+        auto pPage = std::make_unique<SkinningMatrices[]>(SKINNING_SLOTS_PER_PAGE);
+        for (size_t i = SKINNING_SLOTS_PER_PAGE; i > 0; i--) {
+            spawned.vFreeSkinningSlots.push_back(&pPage[i - 1]);
+        }
+        spawned.vSkinningPages.push_back(std::move(pPage));
+    }
+    pNode->pSkinningMatrices = spawned.vFreeSkinningSlots.back();
+    spawned.vFreeSkinningSlots.pop_back();
+    pNode->pSkinningMatrices->fill(glm::identity<glm::mat4x4>());
+
+    auto& vNodes = spawned.nodesByWorld[pNode->getWorldWhileSpawned()];
+    pNode->iSpawnedSkeletonIndex = vNodes.size();
+    vNodes.push_back(pNode);
+}
+
+void AnimationManager::unregisterSkeleton(SkeletonNode* pNode) {
+    std::scoped_lock guard(mtxSpawnedSkeletons.first);
+    auto& spawned = mtxSpawnedSkeletons.second;
+
+    const auto worldIt = spawned.nodesByWorld.find(pNode->getWorldWhileSpawned());
+    if (worldIt == spawned.nodesByWorld.end()) [[unlikely]] {
+        Error::showErrorAndThrowException(
+            std::format("skeleton node \"{}\" is not registered", pNode->getNodeName()));
+    }
+    auto& vNodes = worldIt->second;
+
+    if (pNode->iSpawnedSkeletonIndex >= vNodes.size() || vNodes[pNode->iSpawnedSkeletonIndex] != pNode)
+        [[unlikely]] {
+        Error::showErrorAndThrowException(
+            std::format("skeleton node \"{}\" is not registered", pNode->getNodeName()));
+    }
+
+    // Replace with the last node.
+    vNodes[pNode->iSpawnedSkeletonIndex] = vNodes.back();
+    vNodes[pNode->iSpawnedSkeletonIndex]->iSpawnedSkeletonIndex = pNode->iSpawnedSkeletonIndex;
+    vNodes.pop_back();
+    if (vNodes.empty()) {
+        spawned.nodesByWorld.erase(worldIt);
+    }
+
+    spawned.vFreeSkinningSlots.push_back(pNode->pSkinningMatrices);
+    pNode->pSkinningMatrices = nullptr;
+}
+
+std::optional<Error> AnimationManager::updateSkeletons(World* pWorld, float deltaTime) {
+    PROFILE_FUNC
+
+#if defined(ENGINE_DEBUG_TOOLS)
+    const auto startTime = std::chrono::steady_clock::now();
+#endif
+
+    std::scoped_lock guard(mtxSpawnedSkeletons.first);
+
+    const auto worldIt = mtxSpawnedSkeletons.second.nodesByWorld.find(pWorld);
+    if (worldIt == mtxSpawnedSkeletons.second.nodesByWorld.end()) {
+        return {};
+    }
+
+    // Worker threads that did not find any jobs in the previous batch might still reference it.
+    if (pJobBatch == nullptr || pJobBatch.use_count() > 1) {
+        pJobBatch = std::make_shared<AnimationJobBatch>();
+    }
+    auto& batch = *pJobBatch;
+
+    // Collect nodes that play animations.
+    batch.vNodes.clear();
+    for (const auto& pNode : worldIt->second) {
+        if (!pNode->animState.vPlayingAnimations.empty()) {
+            batch.vNodes.push_back(pNode);
+        }
+    }
+
+#if defined(ENGINE_DEBUG_TOOLS)
+    DebugConsole::getStats().iAnimatedSkeletonCount += batch.vNodes.size();
+#endif
+
+    if (batch.vNodes.empty()) {
+        return {};
+    }
+
+    batch.deltaTime = deltaTime;
+    batch.iJobCount = (batch.vNodes.size() + MIN_SKELETONS_PER_JOB - 1) / MIN_SKELETONS_PER_JOB;
+    batch.iNextJobIndex.store(0, std::memory_order_relaxed);
+    batch.iFinishedJobCount.store(0, std::memory_order_relaxed);
+    batch.pFailedNode.store(nullptr, std::memory_order_relaxed);
+
+    // Start workers, if they are busy with other tasks the calling thread will process all jobs.
+    const size_t iWorkerCount = std::min(batch.iJobCount - 1, iWorkerThreadCount);
+    for (size_t i = 0; i < iWorkerCount; i++) {
+        pGameManager->addTaskToThreadPool([pBatch = pJobBatch]() { processAnimationJobs(*pBatch); });
+    }
+    processAnimationJobs(batch);
+
+    // Wait for jobs that were started by workers.
+    {
+        PROFILE_SCOPE("wait for animation jobs")
+
+        size_t iFinishedJobCount = batch.iFinishedJobCount.load(std::memory_order_acquire);
+        while (iFinishedJobCount != batch.iJobCount) {
+            batch.iFinishedJobCount.wait(iFinishedJobCount, std::memory_order_acquire);
+            iFinishedJobCount = batch.iFinishedJobCount.load(std::memory_order_acquire);
+        }
+    }
+
+    const auto pFailedNode = batch.pFailedNode.load(std::memory_order_relaxed);
+    if (pFailedNode != nullptr) [[unlikely]] {
+        return Error(
+            std::format("failed to update animations of skeleton node \"{}\"", pFailedNode->getNodeName()));
+    }
+
+#if defined(ENGINE_DEBUG_TOOLS)
+    DebugConsole::getStats().animationUpdateTimeMs +=
+        std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+#endif
+
+    return {};
+}
+
+void AnimationManager::processAnimationJobs(AnimationJobBatch& batch) {
+    PROFILE_FUNC
+
+    while (true) {
+        const size_t iJobIndex = batch.iNextJobIndex.fetch_add(1, std::memory_order_relaxed);
+        if (iJobIndex >= batch.iJobCount) {
+            return;
+        }
+
+        const size_t iStart = iJobIndex * MIN_SKELETONS_PER_JOB;
+        const size_t iEnd = std::min(iStart + MIN_SKELETONS_PER_JOB, batch.vNodes.size());
+        for (size_t i = iStart; i < iEnd; i++) {
+            if (!batch.vNodes[i]->updateAnimations(batch.deltaTime)) [[unlikely]] {
+                batch.pFailedNode.store(batch.vNodes[i], std::memory_order_relaxed);
+            }
+        }
+
+        batch.iFinishedJobCount.fetch_add(1, std::memory_order_release);
+        batch.iFinishedJobCount.notify_one();
+    }
+}
+
+std::shared_ptr<const SkeletonAsset>
+AnimationManager::getSkeleton(const std::string& sPathToSkeletonRelativeRes) {
+    PROFILE_FUNC
+
+    std::scoped_lock guard(mtxLoadedSkeletons.first);
+    auto& loadedSkeletons = mtxLoadedSkeletons.second;
+
+    // See if this skeleton is already loaded.
+    const auto it = loadedSkeletons.find(sPathToSkeletonRelativeRes);
+    if (it != loadedSkeletons.end()) {
+        auto pSkeleton = it->second.lock();
+        if (pSkeleton != nullptr) {
+            return pSkeleton;
+        }
+    }
+
+    // Construct full path.
+    const auto pathToSkeletonFile =
+        ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sPathToSkeletonRelativeRes;
+    if (!std::filesystem::exists(pathToSkeletonFile)) [[unlikely]] {
+        Error::showErrorAndThrowException(
+            std::format("expected path to skeleton to exist \"{}\"", pathToSkeletonFile.string()));
+    }
+
+    auto pSkeleton = loadSkeleton(pathToSkeletonFile);
+
+    // Don't keep entries of skeletons that are no longer used.
+    std::erase_if(loadedSkeletons, [](const auto& item) { return item.second.expired(); });
+    loadedSkeletons[sPathToSkeletonRelativeRes] = pSkeleton;
+
+    return pSkeleton;
+}
+
+std::shared_ptr<const ozz::animation::Animation> AnimationManager::getAnimation(
+    const std::string& sRelativePathToAnimation, const ozz::animation::Skeleton& skeleton) {
+    PROFILE_FUNC
+
+    std::shared_ptr<ozz::animation::Animation> pAnimation;
+    {
+        std::scoped_lock guard(mtxLoadedAnimations.first);
+        auto& loadedAnimations = mtxLoadedAnimations.second;
+
+        // See if this animation is already loaded.
+        const auto it = loadedAnimations.find(sRelativePathToAnimation);
+        if (it != loadedAnimations.end()) {
+            pAnimation = it->second.lock();
+        }
+
+        if (pAnimation == nullptr) {
+            pAnimation = loadAnimation(sRelativePathToAnimation);
+
+            // Don't keep entries of animations that are no longer used.
+            std::erase_if(loadedAnimations, [](const auto& item) { return item.second.expired(); });
+            loadedAnimations[sRelativePathToAnimation] = pAnimation;
+        }
+    }
+
+    // Make sure animation is compatible (the same animation can be used with different skeletons).
+    if (pAnimation->num_tracks() != skeleton.num_joints()) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format(
+            "animation \"{}\" is not compatible with the skeleton, animation has {} track(s) and "
+            "skeleton {} bone(s) these numbers need to match",
+            sRelativePathToAnimation,
+            pAnimation->num_tracks(),
+            skeleton.num_joints()));
+    }
+
+    return pAnimation;
+}
+
+size_t AnimationManager::getLoadedSkeletonCount() {
+    std::scoped_lock guard(mtxLoadedSkeletons.first);
+
+    return static_cast<size_t>(std::count_if(
+        mtxLoadedSkeletons.second.begin(), mtxLoadedSkeletons.second.end(), [](const auto& item) {
+            return !item.second.expired();
+        }));
+}
+
+size_t AnimationManager::getLoadedAnimationCount() {
+    std::scoped_lock guard(mtxLoadedAnimations.first);
+
+    return static_cast<size_t>(std::count_if(
+        mtxLoadedAnimations.second.begin(), mtxLoadedAnimations.second.end(), [](const auto& item) {
+            return !item.second.expired();
+        }));
+}
+
+std::shared_ptr<SkeletonAsset> AnimationManager::loadSkeleton(const std::filesystem::path& pathToSkeleton) {
+    PROFILE_FUNC
+
+    auto pAsset = std::make_shared<SkeletonAsset>();
+
+    unsigned int iBoneCount = 0;
+    {
+        // Open file.
+        const std::string sFullPathToSkeletonFile = pathToSkeleton.string();
+        ozz::io::File file(sFullPathToSkeletonFile.c_str(), "rb");
+        if (!file.opened()) [[unlikely]] {
+            Error::showErrorAndThrowException(
+                std::format("unable to open the skeleton file \"{}\"", sFullPathToSkeletonFile));
+        }
+        ozz::io::IArchive archive(&file);
+        if (!archive.TestTag<ozz::animation::Skeleton>()) [[unlikely]] {
+            Error::showErrorAndThrowException(std::format(
+                "the skeleton file does not seem to store a skeleton \"{}\"", sFullPathToSkeletonFile));
+        }
+
+        // Create skeleton.
+        archive >> pAsset->skeleton;
+
+        iBoneCount = static_cast<unsigned int>(pAsset->skeleton.num_joints());
+        if (iBoneCount > SkeletonNode::getMaxBoneCountAllowed()) [[unlikely]] {
+            Error::showErrorAndThrowException(std::format(
+                "skeleton \"{}\" bone count {} exceeds the maximum allowed bone count of {}",
+                sFullPathToSkeletonFile,
+                iBoneCount,
+                SkeletonNode::getMaxBoneCountAllowed()));
+        }
+    }
+
+    // Load inverse bind pose matrices.
+    std::vector<glm::mat4x4> vInverseBindPoseMatrices;
+    {
+        // Open file.
+        const auto pathToInverseBindPoseFile =
+            pathToSkeleton.parent_path() /
+            ("skeletonInverseBindPose." + std::string(Serializable::getBinaryFileExtension()));
+        std::ifstream file(pathToInverseBindPoseFile.c_str(), std::ios::binary);
+        if (!file.is_open()) [[unlikely]] {
+            Error::showErrorAndThrowException(
+                std::format("unable to open the file \"{}\"", pathToInverseBindPoseFile.string().c_str()));
+        }
+
+        // Get file size.
+        file.seekg(0, std::ios::end);
+        const size_t iFileSizeInBytes = static_cast<size_t>(file.tellg());
+        file.seekg(0);
+
+        // Read matrix count.
+        size_t iReadByteCount = 0;
+        unsigned int iMatrixCount = 0;
+        if (iReadByteCount + sizeof(iMatrixCount) > iFileSizeInBytes) [[unlikely]] {
+            Error::showErrorAndThrowException(
+                std::format("unexpected end of file \"{}\"", pathToInverseBindPoseFile.string().c_str()));
+        }
+        file.read(reinterpret_cast<char*>(&iMatrixCount), sizeof(iMatrixCount));
+        iReadByteCount += sizeof(iMatrixCount);
+
+        // Check matrix count.
+        if (iBoneCount != iMatrixCount) [[unlikely]] {
+            Error::showErrorAndThrowException(std::format(
+                "skeleton bone count {} does not match inverse bind pose matrix count {}",
+                iBoneCount,
+                iMatrixCount));
+        }
+
+        // Read matrices.
+        vInverseBindPoseMatrices.resize(iMatrixCount);
+        for (unsigned int i = 0; i < iMatrixCount; i++) {
+            if (iReadByteCount + sizeof(glm::mat4x4) > iFileSizeInBytes) [[unlikely]] {
+                Error::showErrorAndThrowException(
+                    std::format("unexpected end of file \"{}\"", pathToInverseBindPoseFile.string()));
+            }
+
+            file.read(
+                reinterpret_cast<char*>(glm::value_ptr(vInverseBindPoseMatrices[i])), sizeof(glm::mat4x4));
+            iReadByteCount += sizeof(glm::mat4x4);
+        }
+    }
+
+    // Convert to SIMD matrices to quickly compute skinning matrices.
+    pAsset->vInverseBindPoseMatrices.resize(vInverseBindPoseMatrices.size());
+    for (size_t i = 0; i < vInverseBindPoseMatrices.size(); i++) {
+        for (int k = 0; k < 4; k++) {
+            pAsset->vInverseBindPoseMatrices[i].cols[k] =
+                ozz::math::simd_float4::LoadPtrU(&vInverseBindPoseMatrices[i][k].x);
+        }
+    }
+
+    return pAsset;
+}
+
+std::shared_ptr<ozz::animation::Animation>
+AnimationManager::loadAnimation(const std::string& sRelativePathToAnimation) {
+    PROFILE_FUNC
+
+    // Construct full path.
+    const auto pathToAnimationFile =
+        ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sRelativePathToAnimation;
+    if (!std::filesystem::exists(pathToAnimationFile)) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format(
+            "path to animation \"{}\" results in the full path of \"{}\" which does not exist",
+            sRelativePathToAnimation,
+            pathToAnimationFile.string()));
+    }
+
+    const std::string sFullPathToAnimationFile = pathToAnimationFile.string();
+
+    // Open file.
+    ozz::io::File file(sFullPathToAnimationFile.c_str(), "rb");
+    if (!file.opened()) [[unlikely]] {
+        Error::showErrorAndThrowException(
+            std::format("unable to open the animation file \"{}\"", sFullPathToAnimationFile));
+    }
+    ozz::io::IArchive archive(&file);
+    if (!archive.TestTag<ozz::animation::Animation>()) {
+        Error::showErrorAndThrowException(std::format(
+            "the animation file does not seem to store an animation \"{}\"", sFullPathToAnimationFile));
+    }
+
+    // Create animation.
+    auto pAnimation = std::make_shared<ozz::animation::Animation>();
+    archive >> *pAnimation;
+
+    return pAnimation;
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+// Standard.
+#include <string>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <filesystem>
+#include <array>
+#include <atomic>
+#include <optional>
+
+// Custom.
+#include "game/node/SkeletonNode.h"
+#include "misc/Error.h"
+
+// External.
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/base/maths/simd_math.h"
+#include "ozz/base/containers/vector.h"
+
+class GameManager;
+class World;
+
+/** Skeleton loaded from a file, shared between all skeleton nodes that use the same file. */
+struct SkeletonAsset {
+    /** Loaded skeleton. */
+    ozz::animation::Skeleton skeleton;
+
+    /** Matrix per bone of the @ref skeleton (in the same order) to create skinning matrices. */
+    ozz::vector<ozz::math::Float4x4> vInverseBindPoseMatrices;
+};
+
+/**
+ * Loads skeletons and animation clips and shares them between skeleton nodes so that each file is read
+ * from disk and stored in the memory only once no matter how many nodes use it. Also updates animations
+ * of all spawned skeleton nodes in parallel.
+ *
+ * @remark Loaded assets are immutable, each node only stores its own playback state.
+ */
+class AnimationManager {
+    // Only game manager is supposed to create this.
+    friend class GameManager;
+
+    // Skeleton nodes register themselves while spawned.
+    friend class SkeletonNode;
+
+public:
+    AnimationManager(const AnimationManager&) = delete;
+    AnimationManager& operator=(const AnimationManager&) = delete;
+
+    /** Makes sure that no skeleton node is still registered. */
+    ~AnimationManager();
+
+    /**
+     * Returns a previously loaded skeleton (if it's still used by someone) or loads it.
+     *
+     * @remark Thread safe.
+     *
+     * @param sPathToSkeletonRelativeRes Path to the `skeleton.ozz` file relative to the `res` directory
+     * (the file with inverse bind pose matrices is expected to be located in the same directory).
+     *
+     * @return Loaded skeleton, it's released from the memory when the last returned pointer is destroyed.
+     */
+    std::shared_ptr<const SkeletonAsset> getSkeleton(const std::string& sPathToSkeletonRelativeRes);
+
+    /**
+     * Returns a previously loaded animation (if it's still used by someone) or loads it.
+     *
+     * @remark Thread safe.
+     *
+     * @param sRelativePathToAnimation Path to .ozz animation file relative to the `res` directory.
+     * @param skeleton                 Skeleton that will be used with the animation (to check that
+     * the animation is compatible).
+     *
+     * @return Loaded animation, it's released from the memory when the last returned pointer is destroyed.
+     */
+    std::shared_ptr<const ozz::animation::Animation>
+    getAnimation(const std::string& sRelativePathToAnimation, const ozz::animation::Skeleton& skeleton);
+
+    /**
+     * Returns the number of skeletons that are currently loaded in the memory.
+     *
+     * @return Skeleton count.
+     */
+    size_t getLoadedSkeletonCount();
+
+    /**
+     * Returns the number of animations that are currently loaded in the memory.
+     *
+     * @return Animation count.
+     */
+    size_t getLoadedAnimationCount();
+
+    /**
+     * Updates animations and skinning matrices of all spawned skeleton nodes of the specified world
+     * that play animations. Nodes are updated in the thread pool while the calling thread also
+     * processes nodes.
+     *
+     * @remark Called by the world every frame between the first and the second tick group.
+     *
+     * @param pWorld    World to update.
+     * @param deltaTime Time in seconds that has passed since the last update.
+     *
+     * @return Error if some node failed to update its animations (reported on the calling thread after
+     * all nodes were processed).
+     */
+    [[nodiscard]] std::optional<Error> updateSkeletons(World* pWorld, float deltaTime);
+
+private:
+    /** Matrices used for skinning by a single skeleton node. */
+    using SkinningMatrices = std::array<glm::mat4x4, SkeletonNode::getMaxBoneCountAllowed()>;
+
+    /** Spawned skeleton nodes and memory for their skinning matrices. */
+    struct SpawnedSkeletons {
+        /** Spawned nodes of each world. */
+        std::unordered_map<World*, std::vector<SkeletonNode*>> nodesByWorld;
+
+        /**
+         * Skinning matrices of all spawned nodes, allocated in pages (that are never moved or freed while
+         * the manager is alive) because skeletal meshes store pointers to skinning matrices.
+         */
+        std::vector<std::unique_ptr<SkinningMatrices[]>> vSkinningPages;
+
+        /** Unused skinning matrices from @ref vSkinningPages (last element has the lowest address). */
+        std::vector<SkinningMatrices*> vFreeSkinningSlots;
+    };
+
+    /** Skeleton nodes to update in a frame, shared with worker threads. */
+    struct AnimationJobBatch {
+        /** Nodes that play animations. */
+        std::vector<SkeletonNode*> vNodes;
+
+        /** Time in seconds that has passed since the last update. */
+        float deltaTime = 0.0f;
+
+        /** Number of jobs (groups of nodes) in the batch. */
+        size_t iJobCount = 0;
+
+        /** Index of the next job to process. */
+        std::atomic<size_t> iNextJobIndex{0};
+
+        /** Number of processed jobs. */
+        std::atomic<size_t> iFinishedJobCount{0};
+
+        /** Node that failed to update its animations (if any). */
+        std::atomic<SkeletonNode*> pFailedNode{nullptr};
+    };
+
+    /**
+     * Creates a new manager.
+     *
+     * @param pGameManager Game manager that owns this manager.
+     */
+    AnimationManager(GameManager* pGameManager);
+
+    /**
+     * Called by spawned skeleton nodes to be updated every frame and to get memory for skinning matrices.
+     *
+     * @param pNode Spawned node.
+     */
+    void registerSkeleton(SkeletonNode* pNode);
+
+    /**
+     * Called by skeleton nodes that are being despawned.
+     *
+     * @param pNode Node to remove.
+     */
+    void unregisterSkeleton(SkeletonNode* pNode);
+
+    /**
+     * Updates nodes of the specified batch until there are no more jobs left to start.
+     *
+     * @remark Called from worker threads and from the thread that called @ref updateSkeletons.
+     *
+     * @param batch Batch to process.
+     */
+    static void processAnimationJobs(AnimationJobBatch& batch);
+
+    /**
+     * Loads skeleton and its inverse bind pose matrices from files.
+     *
+     * @param pathToSkeleton Path to skeleton .ozz file.
+     *
+     * @return Loaded skeleton.
+     */
+    static std::shared_ptr<SkeletonAsset> loadSkeleton(const std::filesystem::path& pathToSkeleton);
+
+    /**
+     * Loads animation from file.
+     *
+     * @param sRelativePathToAnimation Path to .ozz animation file relative to the `res` directory.
+     *
+     * @return Loaded animation.
+     */
+    static std::shared_ptr<ozz::animation::Animation>
+    loadAnimation(const std::string& sRelativePathToAnimation);
+
+    /**
+     * Pairs of "path to skeleton file relative to the `res` directory" - "loaded skeleton".
+     * Skeletons are owned by their users, expired entries are removed when new skeletons are loaded.
+     */
+    std::pair<std::mutex, std::unordered_map<std::string, std::weak_ptr<SkeletonAsset>>> mtxLoadedSkeletons;
+
+    /**
+     * Pairs of "path to animation file relative to the `res` directory" - "loaded animation".
+     * Animations are owned by their users, expired entries are removed when new animations are loaded.
+     */
+    std::pair<std::mutex, std::unordered_map<std::string, std::weak_ptr<ozz::animation::Animation>>>
+        mtxLoadedAnimations;
+
+    /** Spawned skeleton nodes. */
+    std::pair<std::mutex, SpawnedSkeletons> mtxSpawnedSkeletons;
+
+    /**
+     * Batch used in the last call to @ref updateSkeletons, reused if worker threads no longer
+     * reference it.
+     */
+    std::shared_ptr<AnimationJobBatch> pJobBatch;
+
+    /** Do not delete (free) this pointer. Game manager that owns this manager. */
+    GameManager* const pGameManager = nullptr;
+
+    /** Number of worker threads to use in @ref updateSkeletons. */
+    size_t iWorkerThreadCount = 0;
+};
@@ -0,0 +1,156 @@
+#include "game/geometry/HeightFieldGeometry.h"
+
+// Standard.
+#include <fstream>
+#include <format>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+// Custom.
+#include "misc/Error.h"
+
+namespace {
+    constexpr uint16_t iSupportedFileVersion = 0;
+
+    /** Maximum value of a sample. */
+    constexpr float maxSampleValue = static_cast<float>(std::numeric_limits<uint16_t>::max());
+}
+
+void HeightFieldGeometry::setHeights(const std::vector<float>& vHeights, unsigned int iNewSampleCount) {
+    if (vHeights.size() != static_cast<size_t>(iNewSampleCount) * iNewSampleCount) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format(
+            "expected {} heights for a height field with {} samples per side but received {}",
+            static_cast<size_t>(iNewSampleCount) * iNewSampleCount,
+            iNewSampleCount,
+            vHeights.size()));
+    }
+
+    iSampleCount = iNewSampleCount;
+    vSamples.resize(vHeights.size());
+    if (vHeights.empty()) {
+        minHeight = 0.0f;
+        maxHeight = 0.0f;
+        return;
+    }
+
+    const auto [minIt, maxIt] = std::minmax_element(vHeights.begin(), vHeights.end());
+    minHeight = *minIt;
+    maxHeight = *maxIt;
+
+    // Flat height fields have all samples equal to 0.
+    const auto heightRange = maxHeight - minHeight;
+    for (size_t i = 0; i < vHeights.size(); i++) {
+        const auto normalizedHeight = heightRange > 0.0f ? (vHeights[i] - minHeight) / heightRange : 0.0f;
+        vSamples[i] = static_cast<uint16_t>(std::round(normalizedHeight * maxSampleValue));
+    }
+}
+
+void HeightFieldGeometry::setSampleSpacing(float spacing) { sampleSpacing = std::max(spacing, 0.001f); }
+
+std::vector<float> HeightFieldGeometry::getHeights() const {
+    std::vector<float> vHeights(vSamples.size());
+
+    const auto heightRange = maxHeight - minHeight;
+    for (size_t i = 0; i < vSamples.size(); i++) {
+        vHeights[i] = minHeight + static_cast<float>(vSamples[i]) / maxSampleValue * heightRange;
+    }
+
+    return vHeights;
+}
+
+void HeightFieldGeometry::serialize(const std::filesystem::path& pathToFile) const {
+    std::ofstream file(pathToFile, std::ios::binary);
+    if (!file.is_open()) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format("unable to create file \"{}\"", pathToFile.string()));
+    }
+
+    // Write file version.
+    file.write(reinterpret_cast<const char*>(&iSupportedFileVersion), sizeof(iSupportedFileVersion));
+
+    // Write grid parameters.
+    file.write(reinterpret_cast<const char*>(&iSampleCount), sizeof(iSampleCount));
+    file.write(reinterpret_cast<const char*>(&sampleSpacing), sizeof(sampleSpacing));
+    file.write(reinterpret_cast<const char*>(&minHeight), sizeof(minHeight));
+    file.write(reinterpret_cast<const char*>(&maxHeight), sizeof(maxHeight));
+
+    // Write samples.
+    if (!vSamples.empty()) {
+        file.write(
+            reinterpret_cast<const char*>(vSamples.data()),
+            static_cast<long>(vSamples.size() * sizeof(vSamples[0])));
+    }
+
+#if defined(DEBUG)
+    static_assert(sizeof(HeightFieldGeometry) == 40, "add new variables here");
+#endif
+}
+
+HeightFieldGeometry HeightFieldGeometry::deserialize(const std::filesystem::path& pathToFile) {
+    std::ifstream file(pathToFile, std::ios::binary);
+    if (!file.is_open()) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format("unable to open the file \"{}\"", pathToFile.string()));
+    }
+
+    // Get file size.
+    file.seekg(0, std::ios::end);
+    const size_t iFileSizeInBytes = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+
+    size_t iReadByteCount = 0;
+
+    // Read file version.
+    uint16_t iFileVersion = 0;
+    file.read(reinterpret_cast<char*>(&iFileVersion), sizeof(iFileVersion));
+    iReadByteCount += sizeof(iFileVersion);
+
+    // Check file version.
+    // TODO: add backwards compatibility here when needed.
+    if (iSupportedFileVersion != iFileVersion) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format(
+            "file \"{}\" has unsupported format version {} while the supported version is {}",
+            pathToFile.string(),
+            iFileVersion,
+            iSupportedFileVersion));
+    }
+
+    HeightFieldGeometry geometry;
+
+    // Read grid parameters.
+    constexpr size_t iParametersSize = sizeof(geometry.iSampleCount) + sizeof(geometry.sampleSpacing) +
+                                       sizeof(geometry.minHeight) + sizeof(geometry.maxHeight);
+    if (iReadByteCount + iParametersSize > iFileSizeInBytes) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format("unexpected end of file \"{}\"", pathToFile.string()));
+    }
+    file.read(reinterpret_cast<char*>(&geometry.iSampleCount), sizeof(geometry.iSampleCount));
+    file.read(reinterpret_cast<char*>(&geometry.sampleSpacing), sizeof(geometry.sampleSpacing));
+    file.read(reinterpret_cast<char*>(&geometry.minHeight), sizeof(geometry.minHeight));
+    file.read(reinterpret_cast<char*>(&geometry.maxHeight), sizeof(geometry.maxHeight));
+    iReadByteCount += iParametersSize;
+
+    // Read samples.
+    const size_t iTotalSampleCount = static_cast<size_t>(geometry.iSampleCount) * geometry.iSampleCount;
+    if (iReadByteCount + iTotalSampleCount * sizeof(uint16_t) > iFileSizeInBytes) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format("unexpected end of file \"{}\"", pathToFile.string()));
+    }
+    geometry.vSamples.resize(iTotalSampleCount);
+    file.read(
+        reinterpret_cast<char*>(geometry.vSamples.data()),
+        static_cast<long>(geometry.vSamples.size() * sizeof(geometry.vSamples[0])));
+    iReadByteCount += geometry.vSamples.size() * sizeof(geometry.vSamples[0]);
+
+    if (iReadByteCount != iFileSizeInBytes) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format(
+            "read byte count vs file size mismatch {} != {}, file \"{}\"",
+            iReadByteCount,
+            iFileSizeInBytes,
+            pathToFile.string()));
+    }
+
+#if defined(DEBUG)
+    //                        ALSO UPDATE FILE VERSION and backwards compatibility checks
+    static_assert(sizeof(HeightFieldGeometry) == 40, "add new variables here");
+#endif
+
+    return geometry;
+}
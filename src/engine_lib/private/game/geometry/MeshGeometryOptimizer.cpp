@@ -0,0 +1,553 @@
+#include "game/geometry/MeshGeometryOptimizer.h"
+
+// Standard.
+#include <format>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <unordered_map>
+
+// Custom.
+#include "misc/Profiler.hpp"
+
+namespace {
+    /** Marks an index that was not assigned yet. */
+    constexpr size_t iInvalidIndex = std::numeric_limits<size_t>::max();
+
+    /**
+     * Hashes raw bytes of a vertex.
+     *
+     * @remark We compare vertices bitwise (not using the vertex's `operator==` which uses an epsilon)
+     * because an epsilon-based comparison can't be used with a hash.
+     */
+    template <typename TVertex> struct VertexBitwiseHash {
+        /**
+         * Calculates hash of the vertex.
+         *
+         * @param pVertex Vertex to hash.
+         *
+         * @return Hash.
+         */
+        size_t operator()(const TVertex* pVertex) const {
+            // FNV-1a.
+            constexpr uint64_t iOffsetBasis = 14695981039346656037ULL;
+            constexpr uint64_t iPrime = 1099511628211ULL;
+
+            const auto pBytes = reinterpret_cast<const unsigned char*>(pVertex);
+            uint64_t iHash = iOffsetBasis;
+            for (size_t i = 0; i < sizeof(TVertex); i++) {
+                iHash ^= pBytes[i];
+                iHash *= iPrime;
+            }
+
+            return static_cast<size_t>(iHash);
+        }
+    };
+
+    /** Compares raw bytes of two vertices. */
+    template <typename TVertex> struct VertexBitwiseEqual {
+        /**
+         * Compares two vertices.
+         *
+         * @param pA First vertex.
+         * @param pB Second vertex.
+         *
+         * @return `true` if vertices are bitwise equal.
+         */
+        bool operator()(const TVertex* pA, const TVertex* pB) const {
+            return std::memcmp(pA, pB, sizeof(TVertex)) == 0;
+        }
+    };
+
+    /** Simulates a FIFO post-transform vertex cache. */
+    class VertexCacheSimulator {
+    public:
+        /**
+         * Creates a new simulator.
+         *
+         * @param iVertexCount Total number of vertices that indices reference.
+         * @param iCacheSize   Size of the simulated cache.
+         */
+        VertexCacheSimulator(size_t iVertexCount, size_t iCacheSize)
+            : vCacheTimestamps(iVertexCount, 0), iCacheSize(iCacheSize), iTimestamp(iCacheSize + 1) {}
+
+        /**
+         * Simulates processing of a vertex.
+         *
+         * @param iVertexIndex Index of the vertex.
+         *
+         * @return `true` if the vertex was not in the cache (cache miss).
+         */
+        bool processVertex(size_t iVertexIndex) {
+            if (iTimestamp - vCacheTimestamps[iVertexIndex] <= iCacheSize) {
+                return false;
+            }
+
+            vCacheTimestamps[iVertexIndex] = iTimestamp;
+            iTimestamp += 1;
+
+            return true;
+        }
+
+        /** Clears the cache. */
+        void flush() { iTimestamp += iCacheSize + 1; }
+
+    private:
+        /** Stores "time" of the moment when a vertex was put into the cache. */
+        std::vector<size_t> vCacheTimestamps;
+
+        /** Size of the simulated cache. */
+        const size_t iCacheSize = 0;
+
+        /** Current "time", incremented on each cache miss. */
+        size_t iTimestamp = 0;
+    };
+
+    /**
+     * Runs all optimization stages on the specified vertices and indices.
+     *
+     * @param vVertices Vertices to optimize.
+     * @param vIndices  Triangle list indices to optimize.
+     *
+     * @return Error if the geometry is invalid, otherwise optimization stats.
+     */
+    template <typename TVertex>
+    std::variant<Error, MeshOptimizationStats>
+    optimizeGeometry(std::vector<TVertex>& vVertices, std::vector<MeshIndexType>& vIndices) {
+        // Validate input.
+        if (vIndices.size() % 3 != 0) [[unlikely]] {
+            return Error(std::format(
+                "expected the number of mesh indices to be a multiple of 3 (triangle list), index count: {}",
+                vIndices.size()));
+        }
+        for (const auto iIndex : vIndices) {
+            if (iIndex >= vVertices.size()) [[unlikely]] {
+                return Error(std::format(
+                    "found mesh index {} which is out of bounds of the vertex array (size {})",
+                    iIndex,
+                    vVertices.size()));
+            }
+        }
+
+        MeshOptimizationStats stats;
+        stats.acmrBefore = MeshGeometryOptimizer::calculateAcmr(vIndices);
+        stats.iVertexCountBefore = vVertices.size();
+        stats.iTriangleCountBefore = vIndices.size() / 3;
+
+        // Remove duplicate vertices (only referenced vertices are considered so the number of unique
+        // vertices never exceeds the index type limit).
+        std::vector<TVertex> vUniqueVertices;
+        {
+            std::vector<size_t> vOldToUnique(vVertices.size(), iInvalidIndex);
+            std::unordered_map<
+                const TVertex*,
+                size_t,
+                VertexBitwiseHash<TVertex>,
+                VertexBitwiseEqual<TVertex>>
+                uniqueVertexToIndex;
+            uniqueVertexToIndex.reserve(vVertices.size());
+
+            for (auto& iIndex : vIndices) {
+                auto& iUniqueIndex = vOldToUnique[iIndex];
+                if (iUniqueIndex == iInvalidIndex) {
+                    const auto [it, bInserted] =
+                        uniqueVertexToIndex.try_emplace(&vVertices[iIndex], vUniqueVertices.size());
+                    if (bInserted) {
+                        vUniqueVertices.push_back(vVertices[iIndex]);
+                    }
+                    iUniqueIndex = it->second;
+                }
+                iIndex = static_cast<MeshIndexType>(iUniqueIndex);
+            }
+        }
+
+        // Remove degenerate triangles (they don't produce any pixels).
+        {
+            size_t iWriteIndex = 0;
+            for (size_t i = 0; i < vIndices.size(); i += 3) {
+                const auto iA = vIndices[i];
+                const auto iB = vIndices[i + 1];
+                const auto iC = vIndices[i + 2];
+                if (iA == iB || iB == iC || iA == iC) {
+                    continue;
+                }
+
+                vIndices[iWriteIndex] = iA;
+                vIndices[iWriteIndex + 1] = iB;
+                vIndices[iWriteIndex + 2] = iC;
+                iWriteIndex += 3;
+            }
+            vIndices.resize(iWriteIndex);
+        }
+
+        // Reorder triangles for vertex cache.
+        vIndices = MeshGeometryOptimizer::optimizeVertexCache(vIndices, vUniqueVertices.size());
+
+        // Reorder triangle clusters to reduce overdraw.
+        {
+            std::vector<glm::vec3> vPositions(vUniqueVertices.size());
+            for (size_t i = 0; i < vUniqueVertices.size(); i++) {
+                vPositions[i] = vUniqueVertices[i].position;
+            }
+            MeshGeometryOptimizer::optimizeOverdraw(vIndices, vPositions);
+        }
+
+        // Reorder vertices for vertex fetch.
+        const auto vNewToOld = MeshGeometryOptimizer::optimizeVertexFetch(vIndices, vUniqueVertices.size());
+        vVertices.resize(vNewToOld.size());
+        for (size_t i = 0; i < vNewToOld.size(); i++) {
+            vVertices[i] = std::move(vUniqueVertices[vNewToOld[i]]);
+        }
+
+        stats.acmrAfter = MeshGeometryOptimizer::calculateAcmr(vIndices);
+        stats.iVertexCountAfter = vVertices.size();
+        stats.iTriangleCountAfter = vIndices.size() / 3;
+
+        return stats;
+    }
+}
+
+std::variant<Error, MeshOptimizationStats> MeshGeometryOptimizer::optimize(MeshNodeGeometry& geometry) {
+    PROFILE_FUNC
+
+    static_assert(sizeof(MeshNodeVertex) == 32, "make sure the vertex has no padding (we hash bytes)");
+
+    auto result = optimizeGeometry(geometry.getVertices(), geometry.getIndices());
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        auto error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        return error;
+    }
+
+    return result;
+}
+
+std::variant<Error, MeshOptimizationStats>
+MeshGeometryOptimizer::optimize(SkeletalMeshNodeGeometry& geometry) {
+    PROFILE_FUNC
+
+    static_assert(
+        sizeof(SkeletalMeshNodeVertex) == 52, "make sure the vertex has no padding (we hash bytes)");
+
+    auto result = optimizeGeometry(geometry.getVertices(), geometry.getIndices());
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        auto error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        return error;
+    }
+
+    return result;
+}
+
+float MeshGeometryOptimizer::calculateAcmr(const std::vector<MeshIndexType>& vIndices, size_t iCacheSize) {
+    const size_t iTriangleCount = vIndices.size() / 3;
+    if (iTriangleCount == 0) {
+        return 0.0f;
+    }
+
+    const size_t iVertexCount = static_cast<size_t>(*std::max_element(vIndices.begin(), vIndices.end())) + 1;
+    VertexCacheSimulator cache(iVertexCount, iCacheSize);
+
+    size_t iMissCount = 0;
+    for (size_t i = 0; i < iTriangleCount * 3; i++) {
+        if (cache.processVertex(vIndices[i])) {
+            iMissCount += 1;
+        }
+    }
+
+    return static_cast<float>(iMissCount) / static_cast<float>(iTriangleCount);
+}
+
+std::vector<MeshIndexType> MeshGeometryOptimizer::optimizeVertexCache(
+    const std::vector<MeshIndexType>& vIndices, size_t iVertexCount, size_t iCacheSize) {
+    PROFILE_FUNC
+
+    // Implementation of "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"
+    // (Sander, Nehab, Barczak, 2007).
+
+    const size_t iTriangleCount = vIndices.size() / 3;
+    if (iTriangleCount == 0 || iVertexCount == 0) {
+        return vIndices;
+    }
+
+    // Count triangles that use each vertex.
+    std::vector<size_t> vLiveTriangleCount(iVertexCount, 0);
+    for (size_t i = 0; i < iTriangleCount * 3; i++) {
+        vLiveTriangleCount[vIndices[i]] += 1;
+    }
+
+    // Build vertex-triangle adjacency.
+    std::vector<size_t> vAdjacencyOffsets(iVertexCount + 1, 0);
+    for (size_t i = 0; i < iVertexCount; i++) {
+        vAdjacencyOffsets[i + 1] = vAdjacencyOffsets[i] + vLiveTriangleCount[i];
+    }
+    std::vector<size_t> vAdjacentTriangles(iTriangleCount * 3);
+    {
+        std::vector<size_t> vWriteOffsets(vAdjacencyOffsets.begin(), vAdjacencyOffsets.end() - 1);
+        for (size_t iTriangle = 0; iTriangle < iTriangleCount; iTriangle++) {
+            for (size_t i = 0; i < 3; i++) {
+                auto& iWriteOffset = vWriteOffsets[vIndices[iTriangle * 3 + i]];
+                vAdjacentTriangles[iWriteOffset] = iTriangle;
+                iWriteOffset += 1;
+            }
+        }
+    }
+
+    std::vector<size_t> vCacheTimestamps(iVertexCount, 0);
+    std::vector<bool> vIsTriangleEmitted(iTriangleCount, false);
+    std::vector<MeshIndexType> vDeadEndStack;
+    std::vector<MeshIndexType> vCandidates;
+    vDeadEndStack.reserve(iTriangleCount * 3);
+
+    std::vector<MeshIndexType> vOutputIndices;
+    vOutputIndices.reserve(iTriangleCount * 3);
+
+    size_t iTimestamp = iCacheSize + 1;
+    size_t iNextVertexToScan = 0;
+    size_t iFanningVertex = 0;
+
+    while (iFanningVertex != iInvalidIndex) {
+        vCandidates.clear();
+
+        // Emit all not emitted triangles around the fanning vertex.
+        for (size_t i = vAdjacencyOffsets[iFanningVertex]; i < vAdjacencyOffsets[iFanningVertex + 1]; i++) {
+            const auto iTriangle = vAdjacentTriangles[i];
+            if (vIsTriangleEmitted[iTriangle]) {
+                continue;
+            }
+
+            for (size_t iCorner = 0; iCorner < 3; iCorner++) {
+                const auto iVertex = vIndices[iTriangle * 3 + iCorner];
+
+                vOutputIndices.push_back(iVertex);
+                vDeadEndStack.push_back(iVertex);
+                vCandidates.push_back(iVertex);
+                vLiveTriangleCount[iVertex] -= 1;
+
+                if (iTimestamp - vCacheTimestamps[iVertex] > iCacheSize) {
+                    vCacheTimestamps[iVertex] = iTimestamp;
+                    iTimestamp += 1;
+                }
+            }
+
+            vIsTriangleEmitted[iTriangle] = true;
+        }
+
+        // Pick the next fanning vertex: prefer the oldest vertex that will still be in the cache
+        // after all of its triangles are emitted.
+        iFanningVertex = iInvalidIndex;
+        size_t iBestPriority = 0;
+        for (const auto iVertex : vCandidates) {
+            if (vLiveTriangleCount[iVertex] == 0) {
+                continue;
+            }
+
+            size_t iPriority = 0;
+            const auto iAge = iTimestamp - vCacheTimestamps[iVertex];
+            if (iAge + 2 * vLiveTriangleCount[iVertex] <= iCacheSize) {
+                iPriority = iAge;
+            }
+
+            if (iFanningVertex == iInvalidIndex || iPriority > iBestPriority) {
+                iBestPriority = iPriority;
+                iFanningVertex = iVertex;
+            }
+        }
+
+        if (iFanningVertex != iInvalidIndex) {
+            continue;
+        }
+
+        // Dead end, try recently used vertices first.
+        while (!vDeadEndStack.empty()) {
+            const auto iVertex = vDeadEndStack.back();
+            vDeadEndStack.pop_back();
+
+            if (vLiveTriangleCount[iVertex] > 0) {
+                iFanningVertex = iVertex;
+                break;
+            }
+        }
+
+        if (iFanningVertex != iInvalidIndex) {
+            continue;
+        }
+
+        // Scan for any vertex that still has triangles.
+        while (iNextVertexToScan < iVertexCount) {
+            if (vLiveTriangleCount[iNextVertexToScan] > 0) {
+                iFanningVertex = iNextVertexToScan;
+                break;
+            }
+            iNextVertexToScan += 1;
+        }
+    }
+
+    return vOutputIndices;
+}
+
+void MeshGeometryOptimizer::optimizeOverdraw(
+    std::vector<MeshIndexType>& vIndices,
+    const std::vector<glm::vec3>& vPositions,
+    float threshold,
+    size_t iCacheSize) {
+    PROFILE_FUNC
+
+    const size_t iTriangleCount = vIndices.size() / 3;
+    if (iTriangleCount == 0) {
+        return;
+    }
+
+    // Find hard cluster boundaries: triangles for which all vertices missed the cache.
+    std::vector<size_t> vHardClusterStarts;
+    {
+        VertexCacheSimulator cache(vPositions.size(), iCacheSize);
+        for (size_t iTriangle = 0; iTriangle < iTriangleCount; iTriangle++) {
+            size_t iMissCount = 0;
+            for (size_t i = 0; i < 3; i++) {
+                if (cache.processVertex(vIndices[iTriangle * 3 + i])) {
+                    iMissCount += 1;
+                }
+            }
+
+            if (iTriangle == 0 || iMissCount == 3) {
+                vHardClusterStarts.push_back(iTriangle);
+            }
+        }
+    }
+    vHardClusterStarts.push_back(iTriangleCount);
+
+    // Split hard clusters into smaller (soft) clusters while keeping the ACMR of each
+    // soft cluster close to the ACMR of its hard cluster.
+    std::vector<size_t> vClusterStarts;
+    {
+        VertexCacheSimulator cache(vPositions.size(), iCacheSize);
+        const auto countTriangleMisses = [&](size_t iTriangle) -> size_t {
+            size_t iMissCount = 0;
+            for (size_t i = 0; i < 3; i++) {
+                if (cache.processVertex(vIndices[iTriangle * 3 + i])) {
+                    iMissCount += 1;
+                }
+            }
+            return iMissCount;
+        };
+
+        for (size_t iCluster = 0; iCluster + 1 < vHardClusterStarts.size(); iCluster++) {
+            const auto iStart = vHardClusterStarts[iCluster];
+            const auto iEnd = vHardClusterStarts[iCluster + 1];
+
+            // Calculate ACMR of the hard cluster.
+            cache.flush();
+            size_t iClusterMissCount = 0;
+            for (size_t iTriangle = iStart; iTriangle < iEnd; iTriangle++) {
+                iClusterMissCount += countTriangleMisses(iTriangle);
+            }
+            const float clusterThreshold =
+                threshold * static_cast<float>(iClusterMissCount) / static_cast<float>(iEnd - iStart);
+
+            // Split.
+            vClusterStarts.push_back(iStart);
+            cache.flush();
+            size_t iRunningMissCount = 0;
+            size_t iRunningTriangleCount = 0;
+            for (size_t iTriangle = iStart; iTriangle < iEnd; iTriangle++) {
+                iRunningMissCount += countTriangleMisses(iTriangle);
+                iRunningTriangleCount += 1;
+
+                if (iTriangle + 1 < iEnd && static_cast<float>(iRunningMissCount) /
+                                                    static_cast<float>(iRunningTriangleCount) <=
+                                                clusterThreshold) {
+                    vClusterStarts.push_back(iTriangle + 1);
+                    cache.flush();
+                    iRunningMissCount = 0;
+                    iRunningTriangleCount = 0;
+                }
+            }
+        }
+    }
+    vClusterStarts.push_back(iTriangleCount);
+
+    const size_t iClusterCount = vClusterStarts.size() - 1;
+    if (iClusterCount <= 1) {
+        return;
+    }
+
+    // Calculate mesh centroid.
+    glm::vec3 meshCentroid = glm::vec3(0.0f, 0.0f, 0.0f);
+    for (size_t i = 0; i < iTriangleCount * 3; i++) {
+        meshCentroid += vPositions[vIndices[i]];
+    }
+    meshCentroid /= static_cast<float>(iTriangleCount * 3);
+
+    // Calculate sort key for each cluster: clusters that face away from the mesh center
+    // are likely to occlude other clusters so they should be drawn first.
+    std::vector<float> vClusterSortKeys(iClusterCount, 0.0f);
+    for (size_t iCluster = 0; iCluster < iClusterCount; iCluster++) {
+        glm::vec3 centroid = glm::vec3(0.0f, 0.0f, 0.0f);
+        glm::vec3 normal = glm::vec3(0.0f, 0.0f, 0.0f);
+        float totalArea = 0.0f;
+
+        for (size_t iTriangle = vClusterStarts[iCluster]; iTriangle < vClusterStarts[iCluster + 1];
+             iTriangle++) {
+            const auto& a = vPositions[vIndices[iTriangle * 3]];
+            const auto& b = vPositions[vIndices[iTriangle * 3 + 1]];
+            const auto& c = vPositions[vIndices[iTriangle * 3 + 2]];
+
+            const auto triangleNormal = glm::cross(b - a, c - a); // length is 2x area
+            const auto area = glm::length(triangleNormal);
+
+            centroid += (a + b + c) * (area / 3.0f);
+            normal += triangleNormal;
+            totalArea += area;
+        }
+
+        const auto normalLength = glm::length(normal);
+        if (totalArea <= 0.0f || normalLength <= 0.0f) {
+            continue;
+        }
+
+        centroid /= totalArea;
+        vClusterSortKeys[iCluster] = glm::dot(centroid - meshCentroid, normal / normalLength);
+    }
+
+    // Sort clusters (stable to keep results deterministic).
+    std::vector<size_t> vClusterOrder(iClusterCount);
+    for (size_t i = 0; i < iClusterCount; i++) {
+        vClusterOrder[i] = i;
+    }
+    std::stable_sort(vClusterOrder.begin(), vClusterOrder.end(), [&](size_t iA, size_t iB) {
+        return vClusterSortKeys[iA] > vClusterSortKeys[iB];
+    });
+
+    std::vector<MeshIndexType> vOutputIndices;
+    vOutputIndices.reserve(iTriangleCount * 3);
+    for (const auto iCluster : vClusterOrder) {
+        vOutputIndices.insert(
+            vOutputIndices.end(),
+            vIndices.begin() + static_cast<std::ptrdiff_t>(vClusterStarts[iCluster] * 3),
+            vIndices.begin() + static_cast<std::ptrdiff_t>(vClusterStarts[iCluster + 1] * 3));
+    }
+
+    vIndices = std::move(vOutputIndices);
+}
+
+std::vector<size_t>
+MeshGeometryOptimizer::optimizeVertexFetch(std::vector<MeshIndexType>& vIndices, size_t iVertexCount) {
+    PROFILE_FUNC
+
+    std::vector<size_t> vOldToNew(iVertexCount, iInvalidIndex);
+    std::vector<size_t> vNewToOld;
+    vNewToOld.reserve(iVertexCount);
+
+    for (auto& iIndex : vIndices) {
+        auto& iNewIndex = vOldToNew[iIndex];
+        if (iNewIndex == iInvalidIndex) {
+            iNewIndex = vNewToOld.size();
+            vNewToOld.push_back(iIndex);
+        }
+        iIndex = static_cast<MeshIndexType>(iNewIndex);
+    }
+
+    return vNewToOld;
+}
@@ -0,0 +1,560 @@
+#include "game/geometry/MeshSimplifier.h"
+
+// Standard.
+#include <queue>
+#include <array>
+#include <optional>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <unordered_map>
+
+// Custom.
+#include "game/geometry/MeshGeometryOptimizer.h"
+#include "misc/Profiler.hpp"
+
+namespace {
+    /** Weight of planes that keep open borders of a mesh in place. */
+    constexpr double borderPlaneWeight = 10.0;
+
+    /** Collapses that rotate a triangle's normal so that the cosine is below this value are rejected. */
+    constexpr float minNormalCosineAfterCollapse = 0.25f;
+
+    /** Symmetric 4x4 matrix that accumulates squared distances to planes. */
+    struct Quadric {
+        /**
+         * Creates a quadric of a plane.
+         *
+         * @param normal   Normalized plane normal.
+         * @param distance Plane distance (`-dot(normal, pointOnPlane)`).
+         * @param weight   Weight of the plane.
+         *
+         * @return Quadric.
+         */
+        static Quadric fromPlane(const glm::vec3& normal, float distance, double weight) {
+            const double a = normal.x;
+            const double b = normal.y;
+            const double c = normal.z;
+            const double d = distance;
+
+            Quadric quadric;
+            quadric.a2 = a * a * weight;
+            quadric.ab = a * b * weight;
+            quadric.ac = a * c * weight;
+            quadric.ad = a * d * weight;
+            quadric.b2 = b * b * weight;
+            quadric.bc = b * c * weight;
+            quadric.bd = b * d * weight;
+            quadric.c2 = c * c * weight;
+            quadric.cd = c * d * weight;
+            quadric.d2 = d * d * weight;
+            quadric.weight = weight;
+
+            return quadric;
+        }
+
+        /**
+         * Adds another quadric to this one.
+         *
+         * @param other Quadric to add.
+         */
+        void add(const Quadric& other) {
+            a2 += other.a2;
+            ab += other.ab;
+            ac += other.ac;
+            ad += other.ad;
+            b2 += other.b2;
+            bc += other.bc;
+            bd += other.bd;
+            c2 += other.c2;
+            cd += other.cd;
+            d2 += other.d2;
+            weight += other.weight;
+        }
+
+        /**
+         * Calculates weighted average of squared distances from the point to the accumulated planes.
+         *
+         * @param point Point.
+         *
+         * @return Error.
+         */
+        double evaluate(const glm::vec3& point) const {
+            if (weight <= 0.0) {
+                return 0.0;
+            }
+
+            const double x = point.x;
+            const double y = point.y;
+            const double z = point.z;
+
+            const double error = a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x + b2 * y * y +
+                                 2.0 * bc * y * z + 2.0 * bd * y + c2 * z * z + 2.0 * cd * z + d2;
+
+            return std::max(error, 0.0) / weight;
+        }
+
+        /// @cond UNDOCUMENTED
+        double a2 = 0.0;
+        double ab = 0.0;
+        double ac = 0.0;
+        double ad = 0.0;
+        double b2 = 0.0;
+        double bc = 0.0;
+        double bd = 0.0;
+        double c2 = 0.0;
+        double cd = 0.0;
+        double d2 = 0.0;
+        /// @endcond
+
+        /** Sum of weights of all accumulated planes. */
+        double weight = 0.0;
+    };
+
+    /** Describes a possible collapse of one position into another. */
+    struct CollapseCandidate {
+        /** Error of the collapse. */
+        double cost = 0.0;
+
+        /** Position that will be removed. */
+        uint32_t iFrom = 0;
+
+        /** Position that @ref iFrom will be moved to. */
+        uint32_t iTo = 0;
+
+        /** Version of @ref iFrom at the moment the cost was calculated. */
+        uint32_t iFromVersion = 0;
+
+        /**
+         * Used by the priority queue (min-heap), ties are resolved by indices to keep results deterministic.
+         *
+         * @param other Other candidate.
+         *
+         * @return Whether this candidate should be processed after the other one.
+         */
+        bool operator>(const CollapseCandidate& other) const {
+            if (cost != other.cost) {
+                return cost > other.cost;
+            }
+            if (iFrom != other.iFrom) {
+                return iFrom > other.iFrom;
+            }
+            return iTo > other.iTo;
+        }
+    };
+
+    /** Hashes bits of a position. */
+    struct PositionBitwiseHash {
+        /**
+         * Calculates hash.
+         *
+         * @param position Position.
+         *
+         * @return Hash.
+         */
+        size_t operator()(const glm::vec3& position) const {
+            std::array<uint32_t, 3> vBits{};
+            std::memcpy(vBits.data(), &position.x, sizeof(float));
+            std::memcpy(vBits.data() + 1, &position.y, sizeof(float));
+            std::memcpy(vBits.data() + 2, &position.z, sizeof(float));
+
+            size_t iHash = vBits[0];
+            iHash = iHash * 73856093 ^ vBits[1];
+            iHash = iHash * 19349663 ^ vBits[2];
+            return iHash;
+        }
+    };
+
+    /** Compares bits of positions. */
+    struct PositionBitwiseEqual {
+        /**
+         * Compares positions.
+         *
+         * @param a First position.
+         * @param b Second position.
+         *
+         * @return `true` if bitwise equal.
+         */
+        bool operator()(const glm::vec3& a, const glm::vec3& b) const {
+            return std::memcmp(&a, &b, sizeof(glm::vec3)) == 0;
+        }
+    };
+}
+
+MeshNodeGeometry MeshSimplifier::simplify(
+    const MeshNodeGeometry& geometry, size_t iTargetTriangleCount, float maxError) {
+    PROFILE_FUNC
+
+    const auto& vVertices = geometry.getVertices();
+    const size_t iTriangleCount = geometry.getIndices().size() / 3;
+
+    // Copy indices, we will modify them.
+    std::vector<MeshIndexType> vIndices(geometry.getIndices().begin(), geometry.getIndices().end());
+    vIndices.resize(iTriangleCount * 3);
+
+    // Weld vertices by position (vertices on UV/normal seams share a position).
+    std::vector<uint32_t> vVertexToPosition(vVertices.size(), 0);
+    std::vector<glm::vec3> vPositions;
+    std::vector<std::vector<MeshIndexType>> vPositionVertices;
+    {
+        std::unordered_map<glm::vec3, uint32_t, PositionBitwiseHash, PositionBitwiseEqual> positionToIndex;
+        for (size_t i = 0; i < vVertices.size(); i++) {
+            const auto [it, bInserted] =
+                positionToIndex.try_emplace(vVertices[i].position, static_cast<uint32_t>(vPositions.size()));
+            if (bInserted) {
+                vPositions.push_back(vVertices[i].position);
+                vPositionVertices.emplace_back();
+            }
+            vVertexToPosition[i] = it->second;
+            vPositionVertices[it->second].push_back(static_cast<MeshIndexType>(i));
+        }
+    }
+    const auto getPosition = [&](size_t iTriangle, size_t iCorner) -> uint32_t {
+        return vVertexToPosition[vIndices[iTriangle * 3 + iCorner]];
+    };
+
+    // Calculate max allowed error.
+    glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+    for (const auto& position : vPositions) {
+        min = glm::min(min, position);
+        max = glm::max(max, position);
+    }
+    const double maxAbsoluteError = static_cast<double>(maxError) * static_cast<double>(glm::length(max - min));
+    const double maxCost = maxAbsoluteError * maxAbsoluteError;
+
+    // Prepare triangle adjacency.
+    std::vector<bool> vIsTriangleRemoved(iTriangleCount, false);
+    std::vector<std::vector<uint32_t>> vPositionTriangles(vPositions.size());
+    size_t iAliveTriangleCount = 0;
+    for (size_t iTriangle = 0; iTriangle < iTriangleCount; iTriangle++) {
+        const auto iA = getPosition(iTriangle, 0);
+        const auto iB = getPosition(iTriangle, 1);
+        const auto iC = getPosition(iTriangle, 2);
+        if (iA == iB || iB == iC || iA == iC) {
+            vIsTriangleRemoved[iTriangle] = true;
+            continue;
+        }
+
+        vPositionTriangles[iA].push_back(static_cast<uint32_t>(iTriangle));
+        vPositionTriangles[iB].push_back(static_cast<uint32_t>(iTriangle));
+        vPositionTriangles[iC].push_back(static_cast<uint32_t>(iTriangle));
+        iAliveTriangleCount += 1;
+    }
+
+    // Calculate quadrics.
+    std::vector<Quadric> vQuadrics(vPositions.size());
+    {
+        std::unordered_map<uint64_t, uint32_t> edgeUseCount;
+        const auto getEdgeKey = [](uint32_t iA, uint32_t iB) -> uint64_t {
+            return (static_cast<uint64_t>(std::min(iA, iB)) << 32) | std::max(iA, iB);
+        };
+
+        for (size_t iTriangle = 0; iTriangle < iTriangleCount; iTriangle++) {
+            if (vIsTriangleRemoved[iTriangle]) {
+                continue;
+            }
+            for (size_t i = 0; i < 3; i++) {
+                edgeUseCount[getEdgeKey(getPosition(iTriangle, i), getPosition(iTriangle, (i + 1) % 3))] += 1;
+            }
+        }
+
+        for (size_t iTriangle = 0; iTriangle < iTriangleCount; iTriangle++) {
+            if (vIsTriangleRemoved[iTriangle]) {
+                continue;
+            }
+
+            const auto& p0 = vPositions[getPosition(iTriangle, 0)];
+            const auto& p1 = vPositions[getPosition(iTriangle, 1)];
+            const auto& p2 = vPositions[getPosition(iTriangle, 2)];
+
+            auto normal = glm::cross(p1 - p0, p2 - p0);
+            const auto doubleArea = glm::length(normal);
+            if (doubleArea <= 0.0f) {
+                continue;
+            }
+            normal /= doubleArea;
+
+            const auto faceQuadric =
+                Quadric::fromPlane(normal, -glm::dot(normal, p0), static_cast<double>(doubleArea) * 0.5);
+            for (size_t i = 0; i < 3; i++) {
+                vQuadrics[getPosition(iTriangle, i)].add(faceQuadric);
+            }
+
+            // Add planes perpendicular to open borders to keep them in place.
+            for (size_t i = 0; i < 3; i++) {
+                const auto iA = getPosition(iTriangle, i);
+                const auto iB = getPosition(iTriangle, (i + 1) % 3);
+                if (edgeUseCount[getEdgeKey(iA, iB)] != 1) {
+                    continue;
+                }
+
+                const auto edge = vPositions[iB] - vPositions[iA];
+                const auto edgeLength = glm::length(edge);
+                auto borderNormal = glm::cross(edge, normal);
+                const auto borderNormalLength = glm::length(borderNormal);
+                if (edgeLength <= 0.0f || borderNormalLength <= 0.0f) {
+                    continue;
+                }
+                borderNormal /= borderNormalLength;
+
+                const auto borderQuadric = Quadric::fromPlane(
+                    borderNormal,
+                    -glm::dot(borderNormal, vPositions[iA]),
+                    borderPlaneWeight * static_cast<double>(edgeLength * edgeLength));
+                vQuadrics[iA].add(borderQuadric);
+                vQuadrics[iB].add(borderQuadric);
+            }
+        }
+    }
+
+    std::vector<bool> vIsPositionRemoved(vPositions.size(), false);
+    std::vector<uint32_t> vPositionVersions(vPositions.size(), 0);
+    std::priority_queue<CollapseCandidate, std::vector<CollapseCandidate>, std::greater<CollapseCandidate>>
+        candidates;
+
+    // Prepare a helper lambda that adds collapse candidates for all edges of a position.
+    const auto addCandidatesForPosition = [&](uint32_t iPosition) {
+        for (const auto iTriangle : vPositionTriangles[iPosition]) {
+            if (vIsTriangleRemoved[iTriangle]) {
+                continue;
+            }
+            for (size_t i = 0; i < 3; i++) {
+                const auto iOther = getPosition(iTriangle, i);
+                if (iOther == iPosition) {
+                    continue;
+                }
+
+                candidates.push(CollapseCandidate{
+                    .cost = vQuadrics[iPosition].evaluate(vPositions[iOther]),
+                    .iFrom = iPosition,
+                    .iTo = iOther,
+                    .iFromVersion = vPositionVersions[iPosition]});
+                candidates.push(CollapseCandidate{
+                    .cost = vQuadrics[iOther].evaluate(vPositions[iPosition]),
+                    .iFrom = iOther,
+                    .iTo = iPosition,
+                    .iFromVersion = vPositionVersions[iOther]});
+            }
+        }
+    };
+    for (uint32_t iPosition = 0; iPosition < vPositions.size(); iPosition++) {
+        addCandidatesForPosition(iPosition);
+    }
+
+    // Prepare helper lambdas for checking topology.
+    std::vector<uint32_t> vNeighbours;
+    const auto isBorderPosition = [&](uint32_t iPosition) -> bool {
+        // Edge is on the border if it's used by only 1 triangle.
+        vNeighbours.clear();
+        for (const auto iTriangle : vPositionTriangles[iPosition]) {
+            if (vIsTriangleRemoved[iTriangle]) {
+                continue;
+            }
+            for (size_t i = 0; i < 3; i++) {
+                const auto iOther = getPosition(iTriangle, i);
+                if (iOther != iPosition) {
+                    vNeighbours.push_back(iOther);
+                }
+            }
+        }
+        std::sort(vNeighbours.begin(), vNeighbours.end());
+        for (size_t i = 0; i < vNeighbours.size(); i++) {
+            const bool bSameAsPrev = i > 0 && vNeighbours[i - 1] == vNeighbours[i];
+            const bool bSameAsNext = i + 1 < vNeighbours.size() && vNeighbours[i + 1] == vNeighbours[i];
+            if (!bSameAsPrev && !bSameAsNext) {
+                return true;
+            }
+        }
+        return false;
+    };
+    const auto countTrianglesWithEdge = [&](uint32_t iFrom, uint32_t iTo) -> size_t {
+        size_t iCount = 0;
+        for (const auto iTriangle : vPositionTriangles[iFrom]) {
+            if (vIsTriangleRemoved[iTriangle]) {
+                continue;
+            }
+            if (getPosition(iTriangle, 0) == iTo || getPosition(iTriangle, 1) == iTo ||
+                getPosition(iTriangle, 2) == iTo) {
+                iCount += 1;
+            }
+        }
+        return iCount;
+    };
+    const auto isCollapseFlippingTriangles = [&](uint32_t iFrom, uint32_t iTo) -> bool {
+        for (const auto iTriangle : vPositionTriangles[iFrom]) {
+            if (vIsTriangleRemoved[iTriangle]) {
+                continue;
+            }
+
+            std::array<glm::vec3, 3> vOld{};
+            std::array<glm::vec3, 3> vNew{};
+            bool bHasTarget = false;
+            for (size_t i = 0; i < 3; i++) {
+                const auto iPosition = getPosition(iTriangle, i);
+                bHasTarget = bHasTarget || iPosition == iTo;
+                vOld[i] = vPositions[iPosition];
+                vNew[i] = iPosition == iFrom ? vPositions[iTo] : vPositions[iPosition];
+            }
+            if (bHasTarget) {
+                // Will be removed.
+                continue;
+            }
+
+            const auto oldNormal = glm::cross(vOld[1] - vOld[0], vOld[2] - vOld[0]);
+            const auto newNormal = glm::cross(vNew[1] - vNew[0], vNew[2] - vNew[0]);
+            if (glm::dot(oldNormal, newNormal) <=
+                minNormalCosineAfterCollapse * glm::length(oldNormal) * glm::length(newNormal)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // Collapse.
+    std::vector<std::pair<MeshIndexType, MeshIndexType>> vVertexRemap;
+    while (iAliveTriangleCount > iTargetTriangleCount && !candidates.empty()) {
+        const auto candidate = candidates.top();
+        candidates.pop();
+
+        if (candidate.cost > maxCost) {
+            break;
+        }
+        if (vIsPositionRemoved[candidate.iFrom] || vIsPositionRemoved[candidate.iTo] ||
+            vPositionVersions[candidate.iFrom] != candidate.iFromVersion) {
+            // Outdated.
+            continue;
+        }
+
+        const auto iFrom = candidate.iFrom;
+        const auto iTo = candidate.iTo;
+
+        // Make sure the edge still exists and keep open borders.
+        const auto iSharedTriangleCount = countTrianglesWithEdge(iFrom, iTo);
+        if (iSharedTriangleCount == 0) {
+            continue;
+        }
+        if (isBorderPosition(iFrom) && iSharedTriangleCount != 1) {
+            continue;
+        }
+        if (isCollapseFlippingTriangles(iFrom, iTo)) {
+            continue;
+        }
+
+        // Find which vertex of the target position will replace each vertex of the removed position
+        // (use vertices from triangles that share the collapsed edge to keep attributes continuous).
+        vVertexRemap.clear();
+        for (const auto iTriangle : vPositionTriangles[iFrom]) {
+            if (vIsTriangleRemoved[iTriangle]) {
+                continue;
+            }
+
+            MeshIndexType iFromVertex = 0;
+            std::optional<MeshIndexType> optToVertex;
+            for (size_t i = 0; i < 3; i++) {
+                const auto iVertex = vIndices[iTriangle * 3 + i];
+                if (vVertexToPosition[iVertex] == iFrom) {
+                    iFromVertex = iVertex;
+                } else if (vVertexToPosition[iVertex] == iTo) {
+                    optToVertex = iVertex;
+                }
+            }
+            if (!optToVertex.has_value()) {
+                continue;
+            }
+
+            const auto it = std::find_if(vVertexRemap.begin(), vVertexRemap.end(), [&](const auto& pair) {
+                return pair.first == iFromVertex;
+            });
+            if (it == vVertexRemap.end()) {
+                vVertexRemap.push_back({iFromVertex, *optToVertex});
+            }
+        }
+        const auto getReplacementVertex = [&](MeshIndexType iFromVertex) -> MeshIndexType {
+            const auto it = std::find_if(vVertexRemap.begin(), vVertexRemap.end(), [&](const auto& pair) {
+                return pair.first == iFromVertex;
+            });
+            if (it != vVertexRemap.end()) {
+                return it->second;
+            }
+
+            // Pick a vertex with the most similar attributes.
+            const auto& fromVertex = vVertices[iFromVertex];
+            MeshIndexType iBestVertex = vPositionVertices[iTo][0];
+            float bestDistance = std::numeric_limits<float>::max();
+            for (const auto iCandidateVertex : vPositionVertices[iTo]) {
+                const auto& toVertex = vVertices[iCandidateVertex];
+                const auto normalDiff = toVertex.normal - fromVertex.normal;
+                const auto uvDiff = toVertex.uv - fromVertex.uv;
+                const auto distance = glm::dot(normalDiff, normalDiff) + glm::dot(uvDiff, uvDiff);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    iBestVertex = iCandidateVertex;
+                }
+            }
+            return iBestVertex;
+        };
+
+        // Update triangles.
+        for (const auto iTriangle : vPositionTriangles[iFrom]) {
+            if (vIsTriangleRemoved[iTriangle]) {
+                continue;
+            }
+
+            if (getPosition(iTriangle, 0) == iTo || getPosition(iTriangle, 1) == iTo ||
+                getPosition(iTriangle, 2) == iTo) {
+                vIsTriangleRemoved[iTriangle] = true;
+                iAliveTriangleCount -= 1;
+                continue;
+            }
+
+            for (size_t i = 0; i < 3; i++) {
+                auto& iVertex = vIndices[iTriangle * 3 + i];
+                if (vVertexToPosition[iVertex] == iFrom) {
+                    iVertex = getReplacementVertex(iVertex);
+                }
+            }
+            vPositionTriangles[iTo].push_back(iTriangle);
+        }
+
+        // Update target position.
+        vQuadrics[iTo].add(vQuadrics[iFrom]);
+        vIsPositionRemoved[iFrom] = true;
+        vPositionTriangles[iFrom].clear();
+        vPositionVersions[iTo] += 1;
+
+        auto& vTargetTriangles = vPositionTriangles[iTo];
+        vTargetTriangles.erase(
+            std::remove_if(
+                vTargetTriangles.begin(),
+                vTargetTriangles.end(),
+                [&](uint32_t iTriangle) { return vIsTriangleRemoved[iTriangle]; }),
+            vTargetTriangles.end());
+
+        addCandidatesForPosition(iTo);
+    }
+
+    // Collect results.
+    MeshNodeGeometry simplifiedGeometry;
+    auto& vNewIndices = simplifiedGeometry.getIndices();
+    vNewIndices.reserve(iAliveTriangleCount * 3);
+    for (size_t iTriangle = 0; iTriangle < iTriangleCount; iTriangle++) {
+        if (vIsTriangleRemoved[iTriangle]) {
+            continue;
+        }
+        vNewIndices.push_back(vIndices[iTriangle * 3]);
+        vNewIndices.push_back(vIndices[iTriangle * 3 + 1]);
+        vNewIndices.push_back(vIndices[iTriangle * 3 + 2]);
+    }
+
+    // Remove unused vertices.
+    const auto vNewToOld = MeshGeometryOptimizer::optimizeVertexFetch(vNewIndices, vVertices.size());
+    auto& vNewVertices = simplifiedGeometry.getVertices();
+    vNewVertices.reserve(vNewToOld.size());
+    for (const auto iOldVertex : vNewToOld) {
+        vNewVertices.push_back(vVertices[iOldVertex]);
+    }
+
+    return simplifiedGeometry;
+}
@@ -1,9 +1,16 @@
 #include "game/geometry/shapes/CollisionShape.h"
 
+// Standard.
+#include <fstream>
+#include <format>
+
 // Custom.
 #include "misc/Error.h"
+#include "misc/Profiler.hpp"
 #include "game/physics/CoordinateConversions.hpp"
 #include "game/geometry/ConvexShapeGeometry.h"
+#include "game/geometry/MeshNodeGeometry.h"
+#include "game/geometry/HeightFieldGeometry.h"
 #include "game/geometry/PrimitiveMeshGenerator.h"
 
 // External.
@@ -14,6 +21,9 @@
 #include "Jolt/Physics/Collision/Shape/CylinderShape.h"
 #include "Jolt/Physics/Collision/Shape/SphereShape.h"
 #include "Jolt/Physics/Collision/Shape/ConvexHullShape.h"
+#include "Jolt/Physics/Collision/Shape/MeshShape.h"
+#include "Jolt/Physics/Collision/Shape/HeightFieldShape.h"
+#include "Jolt/Core/StreamWrapper.h"
 
 namespace {
     constexpr std::string_view sCollisionShapeTypeGuid = "ced888f6-24f5-425b-a600-ad78f8868593";
@@ -22,8 +32,206 @@ namespace {
     constexpr std::string_view sCapsuleCollisionShapeTypeGuid = "5383bd42-6857-45e2-a45e-8bc799abc387";
     constexpr std::string_view sCylinderCollisionShapeTypeGuid = "a9dca02e-4283-4d62-bed7-85de22c9af7e";
     constexpr std::string_view sConvexCollisionShapeTypeGuid = "f7961b43-393a-43df-bf8c-07d5bf0148a0";
+    constexpr std::string_view sMeshCollisionShapeTypeGuid = "3f0b9a5e-6c2d-4d7a-9e41-b8a2c6f1d053";
+    constexpr std::string_view sHeightFieldCollisionShapeTypeGuid = "c84e27d1-95b3-4f60-a7de-2e19f0b6c4a8";
 
     constexpr float minSize = 0.1f;
+
+    /** Appended to the path of a geometry file to get path to the cooked Jolt shape. */
+    constexpr std::string_view sCookedShapeFileSuffix = ".cooked";
+
+    /**
+     * Converts convex shape geometry to vertices for Jolt.
+     *
+     * @param positions Geometry positions.
+     *
+     * @return Vertices.
+     */
+    JPH::Array<JPH::Vec3> convertConvexShapePositionsToJolt(const std::vector<glm::vec3>& positions) {
+        JPH::Array<JPH::Vec3> vVertices;
+        vVertices.resize(positions.size());
+        for (size_t i = 0; i < positions.size(); i++) {
+            vVertices[i] = convertPosDirToJolt(positions[i]);
+        }
+        return vVertices;
+    }
+
+    /**
+     * Builds a triangle mesh shape for Jolt.
+     *
+     * @param geometry Mesh geometry.
+     *
+     * @return Shape or an error.
+     */
+    JPH::Result<JPH::Ref<JPH::Shape>> buildMeshShape(const MeshNodeGeometry& geometry) {
+        JPH::VertexList vVertices;
+        vVertices.resize(geometry.getVertices().size());
+        for (size_t i = 0; i < geometry.getVertices().size(); i++) {
+            const auto& position = geometry.getVertices()[i].position;
+            vVertices[i] = JPH::Float3(position.x, position.y, position.z);
+        }
+
+        const auto& vIndices = geometry.getIndices();
+        JPH::IndexedTriangleList vTriangles;
+        vTriangles.reserve(vIndices.size() / 3);
+        for (size_t i = 0; i + 2 < vIndices.size(); i += 3) {
+            vTriangles.push_back(JPH::IndexedTriangle(vIndices[i], vIndices[i + 1], vIndices[i + 2]));
+        }
+
+        JPH::MeshShapeSettings settings(std::move(vVertices), std::move(vTriangles));
+        return settings.Create();
+    }
+
+    /**
+     * Builds a height field shape for Jolt.
+     *
+     * @param geometry Height field geometry.
+     *
+     * @return Shape or an error.
+     */
+    JPH::Result<JPH::Ref<JPH::Shape>> buildHeightFieldShape(const HeightFieldGeometry& geometry) {
+        const auto iSampleCount = geometry.getSampleCount();
+        if (iSampleCount < 2) [[unlikely]] {
+            JPH::Result<JPH::Ref<JPH::Shape>> result;
+            result.SetError("expected a height field to have at least 2 samples per side");
+            return result;
+        }
+
+        // Center the grid.
+        const auto spacing = geometry.getSampleSpacing();
+        const auto halfSize = static_cast<float>(iSampleCount - 1) * spacing * 0.5f;
+
+        const auto vHeights = geometry.getHeights();
+        JPH::HeightFieldShapeSettings settings(
+            vHeights.data(),
+            JPH::Vec3(-halfSize, 0.0f, -halfSize),
+            JPH::Vec3(spacing, 1.0f, spacing),
+            iSampleCount);
+        return settings.Create();
+    }
+
+    /**
+     * Makes sure the path to a geometry file exists and points to a file.
+     *
+     * @param pathToGeometryFile Path to check.
+     *
+     * @return Error if the path is invalid.
+     */
+    std::optional<Error> checkPathToGeometryFile(const std::filesystem::path& pathToGeometryFile) {
+        if (!std::filesystem::exists(pathToGeometryFile)) [[unlikely]] {
+            return Error(std::format("expected the path \"{}\" to exist", pathToGeometryFile.string()));
+        }
+        if (std::filesystem::is_directory(pathToGeometryFile)) [[unlikely]] {
+            return Error(
+                std::format("expected the path \"{}\" to point to a file", pathToGeometryFile.string()));
+        }
+        return {};
+    }
+
+    /**
+     * Returns path to the file that stores a cooked Jolt shape of the specified geometry file.
+     *
+     * @param pathToGeometryFile Path to the geometry file.
+     *
+     * @return Path to the cooked shape (the file might not exist).
+     */
+    std::filesystem::path getPathToCookedShape(const std::filesystem::path& pathToGeometryFile) {
+        auto pathToCookedShape = pathToGeometryFile;
+        pathToCookedShape += sCookedShapeFileSuffix;
+        return pathToCookedShape;
+    }
+
+    /**
+     * Saves a Jolt shape next to the geometry file it was built from (see @ref getPathToCookedShape).
+     *
+     * @param shape              Shape to save.
+     * @param pathToGeometryFile Path to the geometry file the shape was built from.
+     *
+     * @return Error if something went wrong.
+     */
+    std::optional<Error>
+    saveCookedShape(const JPH::Shape& shape, const std::filesystem::path& pathToGeometryFile) {
+        const auto pathToCookedShape = getPathToCookedShape(pathToGeometryFile);
+        std::ofstream file(pathToCookedShape, std::ios::binary);
+        if (!file.is_open()) [[unlikely]] {
+            return Error(std::format("unable to create file \"{}\"", pathToCookedShape.string()));
+        }
+
+        JPH::StreamOutWrapper stream(file);
+        shape.SaveBinaryState(stream);
+        if (stream.IsFailed()) [[unlikely]] {
+            return Error(std::format("failed to write to the file \"{}\"", pathToCookedShape.string()));
+        }
+
+        return {};
+    }
+
+    /**
+     * Loads a shape saved by @ref saveCookedShape if the cooked shape exists and the geometry file was not
+     * modified after the shape was cooked.
+     *
+     * @param pathToGeometryFile Path to the geometry file the shape was built from.
+     * @param expectedSubType    Expected type of the cooked shape.
+     *
+     * @return Empty if there's no up to date cooked shape, otherwise shape or an error.
+     */
+    std::optional<JPH::Result<JPH::Ref<JPH::Shape>>>
+    loadCookedShape(const std::filesystem::path& pathToGeometryFile, JPH::EShapeSubType expectedSubType) {
+        const auto pathToCookedShape = getPathToCookedShape(pathToGeometryFile);
+        const bool bIsCookedShapeUpToDate =
+            std::filesystem::exists(pathToCookedShape) &&
+            std::filesystem::last_write_time(pathToCookedShape) >=
+                std::filesystem::last_write_time(pathToGeometryFile);
+        if (!bIsCookedShapeUpToDate) {
+            return {};
+        }
+
+        JPH::Result<JPH::Ref<JPH::Shape>> result;
+
+        std::ifstream file(pathToCookedShape, std::ios::binary);
+        if (!file.is_open()) [[unlikely]] {
+            result.SetError("unable to open the file");
+            return result;
+        }
+
+        JPH::StreamInWrapper stream(file);
+        result = JPH::Shape::sRestoreFromBinaryState(stream);
+        if (!result.IsValid()) [[unlikely]] {
+            return result;
+        }
+        if (result.Get()->GetSubType() != expectedSubType) [[unlikely]] {
+            result.SetError("the file stores a shape of an unexpected type");
+            return result;
+        }
+
+        return result;
+    }
+
+    /**
+     * Returns a key for @ref CollisionShape::getShapeCacheKey of a shape that is built from a geometry file.
+     * The key includes the last write time of the file so that shapes created from the old version of
+     * a modified file are not reused.
+     *
+     * @param sTypeGuid                  GUID of the collision shape type.
+     * @param sPathToGeometryRelativeRes Path to the geometry file relative to the `res` directory.
+     *
+     * @return Cache key.
+     */
+    std::string
+    getGeometryFileShapeCacheKey(std::string_view sTypeGuid, const std::string& sPathToGeometryRelativeRes) {
+        const auto pathToGeometryFile =
+            ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sPathToGeometryRelativeRes;
+
+        std::error_code errorCode;
+        const auto lastWriteTime = std::filesystem::last_write_time(pathToGeometryFile, errorCode);
+        if (errorCode) {
+            // Invalid path, shape will use a placeholder geometry.
+            return std::format("{} {}", sTypeGuid, sPathToGeometryRelativeRes);
+        }
+
+        return std::format(
+            "{} {} {}", sTypeGuid, sPathToGeometryRelativeRes, lastWriteTime.time_since_epoch().count());
+    }
 }
 
 std::string CollisionShape::getTypeGuidStatic() { return sCollisionShapeTypeGuid.data(); }
@@ -45,6 +253,8 @@ JPH::Result<JPH::Ref<JPH::Shape>> CollisionShape::createShape(float density) con
     Error::showErrorAndThrowException("derived type not implemented this method");
 }
 
+std::string CollisionShape::getShapeCacheKey() const { return ""; }
+
 void CollisionShape::propertyChanged() {
     if (onChanged) {
         onChanged();
@@ -85,6 +295,10 @@ JPH::Result<JPH::Ref<JPH::Shape>> BoxCollisionShape::createShape(float density)
     return settings.Create();
 }
 
+std::string BoxCollisionShape::getShapeCacheKey() const {
+    return std::format("{} {} {} {}", sBoxCollisionShapeTypeGuid, halfExtent.x, halfExtent.y, halfExtent.z);
+}
+
 // ------------------------------------------------------------------------------------------------
 
 std::string SphereCollisionShape::getTypeGuidStatic() { return sSphereCollisionShapeTypeGuid.data(); }
@@ -119,6 +333,10 @@ JPH::Result<JPH::Ref<JPH::Shape>> SphereCollisionShape::createShape(float densit
     return settings.Create();
 }
 
+std::string SphereCollisionShape::getShapeCacheKey() const {
+    return std::format("{} {}", sSphereCollisionShapeTypeGuid, radius);
+}
+
 // ------------------------------------------------------------------------------------------------
 
 std::string CapsuleCollisionShape::getTypeGuidStatic() { return sCapsuleCollisionShapeTypeGuid.data(); }
@@ -166,6 +384,10 @@ JPH::Result<JPH::Ref<JPH::Shape>> CapsuleCollisionShape::createShape(float densi
     return settings.Create();
 }
 
+std::string CapsuleCollisionShape::getShapeCacheKey() const {
+    return std::format("{} {} {}", sCapsuleCollisionShapeTypeGuid, halfHeight, radius);
+}
+
 // ------------------------------------------------------------------------------------------------
 
 std::string CylinderCollisionShape::getTypeGuidStatic() { return sCylinderCollisionShapeTypeGuid.data(); }
@@ -214,6 +436,10 @@ JPH::Result<JPH::Ref<JPH::Shape>> CylinderCollisionShape::createShape(float dens
     return settings.Create();
 }
 
+std::string CylinderCollisionShape::getShapeCacheKey() const {
+    return std::format("{} {} {}", sCylinderCollisionShapeTypeGuid, halfHeight, radius);
+}
+
 // ------------------------------------------------------------------------------------------------
 
 std::string ConvexCollisionShape::getTypeGuidStatic() { return sConvexCollisionShapeTypeGuid.data(); }
@@ -243,30 +469,69 @@ void ConvexCollisionShape::setPathToGeometryRelativeRes(const std::string& sRela
     propertyChanged();
 }
 
+std::filesystem::path
+ConvexCollisionShape::getPathToCookedConvexHull(const std::filesystem::path& pathToGeometryFile) {
+    return getPathToCookedShape(pathToGeometryFile);
+}
+
+std::optional<Error> ConvexCollisionShape::cookConvexHull(const std::filesystem::path& pathToGeometryFile) {
+    auto optionalError = checkPathToGeometryFile(pathToGeometryFile);
+    if (optionalError.has_value()) [[unlikely]] {
+        optionalError->addCurrentLocationToErrorStack();
+        return optionalError;
+    }
+
+    // Build hull.
+    const auto geometry = ConvexShapeGeometry::deserialize(pathToGeometryFile);
+    JPH::ConvexHullShapeSettings settings(convertConvexShapePositionsToJolt(geometry.getPositions()));
+    const auto shapeResult = settings.Create();
+    if (!shapeResult.IsValid()) [[unlikely]] {
+        return Error(std::format(
+            "failed to build a convex hull from \"{}\", error: {}",
+            pathToGeometryFile.string(),
+            shapeResult.GetError().data()));
+    }
+
+    // Save.
+    optionalError = saveCookedShape(*shapeResult.Get(), pathToGeometryFile);
+    if (optionalError.has_value()) [[unlikely]] {
+        optionalError->addCurrentLocationToErrorStack();
+        return optionalError;
+    }
+
+    return {};
+}
+
 JPH::Result<JPH::Ref<JPH::Shape>> ConvexCollisionShape::createShape(float density) const {
+    PROFILE_FUNC
+
     // Construct full path.
     const auto pathToFile =
         ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sPathToGeometryRelativeRes;
-    bool bIsPathInvalid = false;
-    if (!std::filesystem::exists(pathToFile)) {
-        Log::error(
-            std::format("the path to convex shape geometry does not exist ({})", pathToFile.string()));
-        bIsPathInvalid = true;
-    } else if (std::filesystem::is_directory(pathToFile)) {
+    auto optionalError = checkPathToGeometryFile(pathToFile);
+    if (optionalError.has_value()) {
         Log::error(std::format(
-            "expected the path to convex shape geometry to point to a file ({})", pathToFile.string()));
-        bIsPathInvalid = true;
+            "invalid path to convex shape geometry, error: {}", optionalError->getInitialMessage()));
     }
 
     JPH::Array<JPH::Vec3> vVertices;
-    if (!bIsPathInvalid) {
-        const auto geometry = ConvexShapeGeometry::deserialize(pathToFile);
-        const auto& positions = geometry.getPositions();
-
-        vVertices.resize(positions.size());
-        for (size_t i = 0; i < positions.size(); i++) {
-            vVertices[i] = convertPosDirToJolt(positions[i]);
+    if (!optionalError.has_value()) {
+        // Prefer a cooked hull (if it's up to date) to avoid building the hull.
+        auto optionalCookedHull = loadCookedShape(pathToFile, JPH::EShapeSubType::ConvexHull);
+        if (optionalCookedHull.has_value()) {
+            if (optionalCookedHull->IsValid()) {
+                // Hulls are cooked with the default density.
+                static_cast<JPH::ConvexHullShape*>(optionalCookedHull->Get().GetPtr())->SetDensity(density);
+                return *optionalCookedHull;
+            }
+            Log::warn(std::format(
+                "failed to load cooked convex hull \"{}\", building the hull from the geometry, error: {}",
+                getPathToCookedConvexHull(pathToFile).string(),
+                optionalCookedHull->GetError().data()));
         }
+
+        const auto geometry = ConvexShapeGeometry::deserialize(pathToFile);
+        vVertices = convertConvexShapePositionsToJolt(geometry.getPositions());
     } else {
         // Use a placeholder geometry.
         const auto geometry = PrimitiveMeshGenerator::createCube(1.0f);
@@ -282,3 +547,204 @@ JPH::Result<JPH::Ref<JPH::Shape>> ConvexCollisionShape::createShape(float densit
     settings.SetDensity(density);
     return settings.Create();
 }
+
+std::string ConvexCollisionShape::getShapeCacheKey() const {
+    return getGeometryFileShapeCacheKey(sConvexCollisionShapeTypeGuid, sPathToGeometryRelativeRes);
+}
+
+// ------------------------------------------------------------------------------------------------
+
+std::string MeshCollisionShape::getTypeGuidStatic() { return sMeshCollisionShapeTypeGuid.data(); }
+std::string MeshCollisionShape::getTypeGuid() const { return sMeshCollisionShapeTypeGuid.data(); }
+TypeReflectionInfo MeshCollisionShape::getReflectionInfo() {
+    ReflectedVariables variables;
+
+    variables.strings[NAMEOF_MEMBER(&MeshCollisionShape::sPathToGeometryRelativeRes).data()] =
+        ReflectedVariableInfo<std::string>{
+            .setter =
+                [](Serializable* pThis, const std::string& sNewValue) {
+                    reinterpret_cast<MeshCollisionShape*>(pThis)->setPathToGeometryRelativeRes(sNewValue);
+                },
+            .getter = [](Serializable* pThis) -> std::string {
+                return reinterpret_cast<MeshCollisionShape*>(pThis)->getPathToGeometryRelativeRes();
+            }};
+
+    return TypeReflectionInfo(
+        CollisionShape::getTypeGuidStatic(),
+        NAMEOF_SHORT_TYPE(MeshCollisionShape).data(),
+        []() -> std::unique_ptr<Serializable> { return std::make_unique<MeshCollisionShape>(); },
+        std::move(variables));
+}
+
+void MeshCollisionShape::setPathToGeometryRelativeRes(const std::string& sRelativePath) {
+    sPathToGeometryRelativeRes = sRelativePath;
+    propertyChanged();
+}
+
+std::filesystem::path
+MeshCollisionShape::getPathToCookedMesh(const std::filesystem::path& pathToGeometryFile) {
+    return getPathToCookedShape(pathToGeometryFile);
+}
+
+std::optional<Error> MeshCollisionShape::cookMesh(const std::filesystem::path& pathToGeometryFile) {
+    auto optionalError = checkPathToGeometryFile(pathToGeometryFile);
+    if (optionalError.has_value()) [[unlikely]] {
+        optionalError->addCurrentLocationToErrorStack();
+        return optionalError;
+    }
+
+    // Build mesh.
+    const auto shapeResult = buildMeshShape(MeshNodeGeometry::deserialize(pathToGeometryFile));
+    if (!shapeResult.IsValid()) [[unlikely]] {
+        return Error(std::format(
+            "failed to build a triangle mesh from \"{}\", error: {}",
+            pathToGeometryFile.string(),
+            shapeResult.GetError().data()));
+    }
+
+    // Save.
+    optionalError = saveCookedShape(*shapeResult.Get(), pathToGeometryFile);
+    if (optionalError.has_value()) [[unlikely]] {
+        optionalError->addCurrentLocationToErrorStack();
+        return optionalError;
+    }
+
+    return {};
+}
+
+JPH::Result<JPH::Ref<JPH::Shape>> MeshCollisionShape::createShape(float density) const {
+    PROFILE_FUNC
+
+    // Construct full path.
+    const auto pathToFile =
+        ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sPathToGeometryRelativeRes;
+    const auto optionalError = checkPathToGeometryFile(pathToFile);
+    if (optionalError.has_value()) {
+        Log::error(std::format(
+            "invalid path to mesh collision geometry, error: {}", optionalError->getInitialMessage()));
+
+        // Use a placeholder geometry.
+        return buildMeshShape(PrimitiveMeshGenerator::createCube(1.0f));
+    }
+
+    // Prefer a cooked mesh (if it's up to date) to avoid building the bounding volume hierarchy.
+    auto optionalCookedMesh = loadCookedShape(pathToFile, JPH::EShapeSubType::Mesh);
+    if (optionalCookedMesh.has_value()) {
+        if (optionalCookedMesh->IsValid()) {
+            return *optionalCookedMesh;
+        }
+        Log::warn(std::format(
+            "failed to load cooked triangle mesh \"{}\", building the mesh from the geometry, error: {}",
+            getPathToCookedMesh(pathToFile).string(),
+            optionalCookedMesh->GetError().data()));
+    }
+
+    return buildMeshShape(MeshNodeGeometry::deserialize(pathToFile));
+}
+
+std::string MeshCollisionShape::getShapeCacheKey() const {
+    return getGeometryFileShapeCacheKey(sMeshCollisionShapeTypeGuid, sPathToGeometryRelativeRes);
+}
+
+// ------------------------------------------------------------------------------------------------
+
+std::string HeightFieldCollisionShape::getTypeGuidStatic() {
+    return sHeightFieldCollisionShapeTypeGuid.data();
+}
+std::string HeightFieldCollisionShape::getTypeGuid() const {
+    return sHeightFieldCollisionShapeTypeGuid.data();
+}
+TypeReflectionInfo HeightFieldCollisionShape::getReflectionInfo() {
+    ReflectedVariables variables;
+
+    variables.strings[NAMEOF_MEMBER(&HeightFieldCollisionShape::sPathToGeometryRelativeRes).data()] =
+        ReflectedVariableInfo<std::string>{
+            .setter =
+                [](Serializable* pThis, const std::string& sNewValue) {
+                    reinterpret_cast<HeightFieldCollisionShape*>(pThis)->setPathToGeometryRelativeRes(
+                        sNewValue);
+                },
+            .getter = [](Serializable* pThis) -> std::string {
+                return reinterpret_cast<HeightFieldCollisionShape*>(pThis)->getPathToGeometryRelativeRes();
+            }};
+
+    return TypeReflectionInfo(
+        CollisionShape::getTypeGuidStatic(),
+        NAMEOF_SHORT_TYPE(HeightFieldCollisionShape).data(),
+        []() -> std::unique_ptr<Serializable> { return std::make_unique<HeightFieldCollisionShape>(); },
+        std::move(variables));
+}
+
+void HeightFieldCollisionShape::setPathToGeometryRelativeRes(const std::string& sRelativePath) {
+    sPathToGeometryRelativeRes = sRelativePath;
+    propertyChanged();
+}
+
+std::filesystem::path
+HeightFieldCollisionShape::getPathToCookedHeightField(const std::filesystem::path& pathToGeometryFile) {
+    return getPathToCookedShape(pathToGeometryFile);
+}
+
+std::optional<Error>
+HeightFieldCollisionShape::cookHeightField(const std::filesystem::path& pathToGeometryFile) {
+    auto optionalError = checkPathToGeometryFile(pathToGeometryFile);
+    if (optionalError.has_value()) [[unlikely]] {
+        optionalError->addCurrentLocationToErrorStack();
+        return optionalError;
+    }
+
+    // Build height field.
+    const auto shapeResult = buildHeightFieldShape(HeightFieldGeometry::deserialize(pathToGeometryFile));
+    if (!shapeResult.IsValid()) [[unlikely]] {
+        return Error(std::format(
+            "failed to build a height field from \"{}\", error: {}",
+            pathToGeometryFile.string(),
+            shapeResult.GetError().data()));
+    }
+
+    // Save.
+    optionalError = saveCookedShape(*shapeResult.Get(), pathToGeometryFile);
+    if (optionalError.has_value()) [[unlikely]] {
+        optionalError->addCurrentLocationToErrorStack();
+        return optionalError;
+    }
+
+    return {};
+}
+
+JPH::Result<JPH::Ref<JPH::Shape>> HeightFieldCollisionShape::createShape(float density) const {
+    PROFILE_FUNC
+
+    // Construct full path.
+    const auto pathToFile =
+        ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sPathToGeometryRelativeRes;
+    const auto optionalError = checkPathToGeometryFile(pathToFile);
+    if (optionalError.has_value()) {
+        Log::error(std::format(
+            "invalid path to height field geometry, error: {}", optionalError->getInitialMessage()));
+
+        // Use a placeholder geometry.
+        HeightFieldGeometry geometry;
+        geometry.setHeights(std::vector<float>(4, 0.0f), 2);
+        return buildHeightFieldShape(geometry);
+    }
+
+    // Prefer a cooked height field (if it's up to date) to avoid building it.
+    auto optionalCookedHeightField = loadCookedShape(pathToFile, JPH::EShapeSubType::HeightField);
+    if (optionalCookedHeightField.has_value()) {
+        if (optionalCookedHeightField->IsValid()) {
+            return *optionalCookedHeightField;
+        }
+        Log::warn(std::format(
+            "failed to load cooked height field \"{}\", building the height field from the geometry, "
+            "error: {}",
+            getPathToCookedHeightField(pathToFile).string(),
+            optionalCookedHeightField->GetError().data()));
+    }
+
+    return buildHeightFieldShape(HeightFieldGeometry::deserialize(pathToFile));
+}
+
+std::string HeightFieldCollisionShape::getShapeCacheKey() const {
+    return getGeometryFileShapeCacheKey(sHeightFieldCollisionShapeTypeGuid, sPathToGeometryRelativeRes);
+}
@@ -117,6 +117,24 @@ TypeReflectionInfo MeshNode::getReflectionInfo() {
             return reinterpret_cast<MeshNode*>(pThis)->getMaterial().isTransparencyEnabled();
         }};
 
+    variables.bools["bEnableDistanceFog"] = ReflectedVariableInfo<bool>{
+        .setter =
+            [](Serializable* pThis, const bool& bNewValue) {
+                reinterpret_cast<MeshNode*>(pThis)->getMaterial().setEnableDistanceFog(bNewValue);
+            },
+        .getter = [](Serializable* pThis) -> bool {
+            return reinterpret_cast<MeshNode*>(pThis)->getMaterial().isDistanceFogEnabled();
+        }};
+
+    variables.bools["bEnableShadows"] = ReflectedVariableInfo<bool>{
+        .setter =
+            [](Serializable* pThis, const bool& bNewValue) {
+                reinterpret_cast<MeshNode*>(pThis)->getMaterial().setEnableShadows(bNewValue);
+            },
+        .getter = [](Serializable* pThis) -> bool {
+            return reinterpret_cast<MeshNode*>(pThis)->getMaterial().isShadowsEnabled();
+        }};
+
     variables.meshNodeGeometries[NAMEOF_MEMBER(&MeshNode::meshGeometry).data()] =
         ReflectedVariableInfo<MeshNodeGeometry>{
             .setter =
@@ -127,6 +145,20 @@ TypeReflectionInfo MeshNode::getReflectionInfo() {
                 return reinterpret_cast<MeshNode*>(pThis)->copyMeshData();
             }};
 
+    for (size_t iLodIndex = 1; iLodIndex < MAX_MESH_LOD_COUNT; iLodIndex++) {
+        variables.meshNodeGeometries[std::format("meshGeometryLod{}", iLodIndex)] =
+            ReflectedVariableInfo<MeshNodeGeometry>{
+                .setter =
+                    [iLodIndex](Serializable* pThis, const MeshNodeGeometry& newValue) {
+                        auto geometry = newValue;
+                        reinterpret_cast<MeshNode*>(pThis)->setLodGeometryBeforeSpawned(
+                            iLodIndex, std::move(geometry));
+                    },
+                .getter = [iLodIndex](Serializable* pThis) -> MeshNodeGeometry {
+                    return reinterpret_cast<MeshNode*>(pThis)->copyLodMeshData(iLodIndex);
+                }};
+    }
+
     return TypeReflectionInfo(
         SpatialNode::getTypeGuidStatic(),
         NAMEOF_SHORT_TYPE(MeshNode).data(),
@@ -199,6 +231,44 @@ void MeshNode::setMeshGeometryBeforeSpawned(MeshNodeGeometry&& meshGeometry) {
     this->meshGeometry = std::move(meshGeometry);
 }
 
+void MeshNode::setLodGeometryBeforeSpawned(size_t iLodIndex, MeshNodeGeometry&& meshGeometry) {
+    if (iLodIndex == 0 || iLodIndex >= MAX_MESH_LOD_COUNT) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format(
+            "LOD index {} is out of range [1; {}] (node \"{}\")",
+            iLodIndex,
+            MAX_MESH_LOD_COUNT - 1,
+            getNodeName()));
+    }
+
+    if (isUsingSkeletalMeshGeometry() &&
+        (!meshGeometry.getVertices().empty() || !meshGeometry.getIndices().empty())) [[unlikely]] {
+        Error::showErrorAndThrowException(
+            std::format("LODs are not supported for skeletal meshes (node \"{}\")", getNodeName()));
+    }
+
+    std::scoped_lock guard(getSpawnDespawnMutex());
+
+    // For simplicity we don't allow changing geometry while spawned.
+    if (isSpawned()) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format(
+            "changing LOD geometry of a spawned node is not allowed (node \"{}\")", getNodeName()));
+    }
+
+    vLodGeometries[iLodIndex - 1] = std::move(meshGeometry);
+}
+
+MeshNodeGeometry MeshNode::copyLodMeshData(size_t iLodIndex) const {
+    if (iLodIndex == 0 || iLodIndex >= MAX_MESH_LOD_COUNT) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format(
+            "LOD index {} is out of range [1; {}] (node \"{}\")",
+            iLodIndex,
+            MAX_MESH_LOD_COUNT - 1,
+            getNodeName()));
+    }
+
+    return vLodGeometries[iLodIndex - 1];
+}
+
 void MeshNode::setIsVisible(bool bNewVisible) {
     std::scoped_lock guard(getSpawnDespawnMutex());
 
@@ -246,6 +316,14 @@ void MeshNode::registerToRendering() {
     // Init render resources.
     material.initShaderProgramAndResources(this, getGameInstanceWhileSpawned()->getRenderer());
     pVao = createVertexArrayObject();
+    for (size_t i = 0; i < vLodGeometries.size(); i++) {
+        const auto& lodGeometry = vLodGeometries[i];
+        if (lodGeometry.getVertices().empty() || lodGeometry.getIndices().empty()) {
+            // Only use LODs without gaps.
+            break;
+        }
+        vLodVaos[i] = GpuResourceManager::createVertexArrayObject(lodGeometry);
+    }
 
     // After we initialized render resources, add to rendering.
     pRenderingHandle = getWorldWhileSpawned()->getMeshRenderer().addMeshForRendering(
@@ -269,6 +347,7 @@ void MeshNode::updateRenderData(bool bJustRegistered) {
     if (bJustRegistered) {
         aabbLocal = calculateBoundingBoxFromGeometry();
         data.aabbWorld = aabbLocal.convertToWorldSpace(getWorldMatrix());
+        data.iMainViewLod = 0;
     }
 
     data.worldMatrix = getWorldMatrix();
@@ -277,8 +356,18 @@ void MeshNode::updateRenderData(bool bJustRegistered) {
     data.textureTilingMultiplier = material.getTextureTilingMultiplier();
     data.textureUvOffset = material.getTextureUvOffset();
     data.iDiffuseTextureId = material.getDiffuseTextureId();
-    data.iVertexArrayObject = pVao->getVertexArrayObjectId();
-    data.iIndexCount = pVao->getIndexCount();
+    data.vVertexArrayObjects[0] = pVao->getVertexArrayObjectId();
+    data.vIndexCounts[0] = pVao->getIndexCount();
+    size_t iLodCount = 1;
+    for (const auto& pLodVao : vLodVaos) {
+        if (pLodVao == nullptr) {
+            break;
+        }
+        data.vVertexArrayObjects[iLodCount] = pLodVao->getVertexArrayObjectId();
+        data.vIndexCounts[iLodCount] = pLodVao->getIndexCount();
+        iLodCount += 1;
+    }
+    data.iLodCount = static_cast<unsigned char>(iLodCount);
     data.outlineWidth = material.getOutlineWidth();
 #if defined(ENGINE_EDITOR)
     auto iNodeId = *getNodeId();
@@ -334,6 +423,9 @@ void MeshNode::unregisterFromRendering() {
 
     // Deinit render resources.
     pVao = nullptr;
+    for (auto& pLodVao : vLodVaos) {
+        pLodVao = nullptr;
+    }
     material.deinitShaderProgramAndResources(this, getGameInstanceWhileSpawned()->getRenderer());
 }
 
@@ -360,11 +452,11 @@ void MeshNode::onWorldLocationRotationScaleChanged() {
         return;
     }
 
-    // Update shader data.
-    auto renderDataGuard = getWorldWhileSpawned()->getMeshRenderer().getMeshRenderData(*pRenderingHandle);
-    auto& data = renderDataGuard.getData();
-
-    data.worldMatrix = getWorldMatrix();
-    data.normalMatrix = glm::transpose(glm::inverse(data.worldMatrix));
-    data.aabbWorld = aabbLocal.convertToWorldSpace(getWorldMatrix());
+    // Update shader data (queued if many meshes are moved at once, see `PhysicsManager`).
+    const auto worldMatrix = getWorldMatrix();
+    MeshRenderer::setMeshTransform(MeshRenderer::MeshTransform{
+        .pHandle = pRenderingHandle.get(),
+        .worldMatrix = worldMatrix,
+        .normalMatrix = glm::transpose(glm::inverse(worldMatrix)),
+        .aabbWorld = aabbLocal.convertToWorldSpace(worldMatrix)});
 }
@@ -6,6 +6,9 @@
 // Custom.
 #include "game/World.h"
 #include "game/GameManager.h"
+#if !defined(ENGINE_UI_ONLY)
+#include "game/physics/PhysicsManager.h"
+#endif
 #include "game/node/SpatialNode.h"
 #include "io/Log.h"
 
@@ -244,6 +247,11 @@ Node::deserializeNodeTree(const std::filesystem::path& pathToFile) {
 }
 
 std::optional<Error> Node::serializeNodeTree(std::filesystem::path pathToFile, bool bEnableBackup) {
+    return serializeNodeTree(std::move(pathToFile), bEnableBackup, false);
+}
+
+std::optional<Error>
+Node::serializeNodeTree(std::filesystem::path pathToFile, bool bEnableBackup, bool bSkipGeometry) {
     // Self check: make sure this node is marked to be serialized.
     if (!bSerialize) [[unlikely]] {
         return Error(std::format(
@@ -261,7 +269,7 @@ std::optional<Error> Node::serializeNodeTree(std::filesystem::path pathToFile, b
     const std::string sFilename = pathToFile.stem().string();
     const auto pathToGeoDir =
         pathToFile.parent_path() / (sFilename + std::string(Serializable::getNodeTreeGeometryDirSuffix()));
-    if (std::filesystem::exists(pathToGeoDir)) {
+    if (!bSkipGeometry && std::filesystem::exists(pathToGeoDir)) {
         // Delete old geometry files.
         // This will cleanup any no longer needed geometry files (for ex. if we saved a mesh node but
         // then deleted and now saving again).
@@ -286,6 +294,7 @@ std::optional<Error> Node::serializeNodeTree(std::filesystem::path pathToFile, b
         vNodesInfo.reserve(vOriginalNodesInfo.size());
         for (auto& info : vOriginalNodesInfo) {
             vNodesInfo.push_back(std::move(info.info));
+            vNodesInfo.back().bSkipGeometry = bSkipGeometry;
         }
 
         // Serialize.
@@ -625,6 +634,12 @@ void Node::spawn() {
     }
 #endif
 
+#if !defined(ENGINE_UI_ONLY)
+    // Add physics bodies of the whole node tree to the physics world at once.
+    auto& physicsManager = pWorldWeSpawnedIn->getGameManager().getPhysicsManager();
+    physicsManager.beginBodyBatch();
+#endif
+
     // Get unique ID.
     iNodeId = iAvailableNodeId.fetch_add(1);
     if (iNodeId.value() + 1 == (std::numeric_limits<size_t>::max)()) [[unlikely]] {
@@ -671,6 +686,10 @@ void Node::spawn() {
         PROFILE_ADD_SCOPE_TEXT(sNodeName.c_str(), sNodeName.size());
         onChildNodesSpawned();
     }
+
+#if !defined(ENGINE_UI_ONLY)
+    physicsManager.endBodyBatch();
+#endif
 }
 
 void Node::despawn() {
@@ -686,6 +705,12 @@ void Node::despawn() {
         return;
     }
 
+#if !defined(ENGINE_UI_ONLY)
+    // Remove physics bodies of the whole node tree from the physics world at once.
+    auto& physicsManager = pWorldWeSpawnedIn->getGameManager().getPhysicsManager();
+    physicsManager.beginBodyBatch();
+#endif
+
     // Despawn children first.
     // This despawn order is required for some nodes and engine parts to work correctly.
     // With this despawn order we will not make "holes" in world's node tree
@@ -709,6 +734,10 @@ void Node::despawn() {
 
     // Don't allow accessing world at this point.
     pWorldWeSpawnedIn = nullptr;
+
+#if !defined(ENGINE_UI_ONLY)
+    physicsManager.endBodyBatch();
+#endif
 }
 
 void Node::notifyAboutAttachedToNewParent(bool bThisNodeBeingAttached) {
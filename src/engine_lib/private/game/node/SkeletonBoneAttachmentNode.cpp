@@ -41,7 +41,7 @@ SkeletonBoneAttachmentNode::SkeletonBoneAttachmentNode()
 SkeletonBoneAttachmentNode::SkeletonBoneAttachmentNode(const std::string& sNodeName)
     : SpatialNode(sNodeName) {
     setIsCalledEveryFrame(true);
-    setTickGroup(TickGroup::SECOND); // skeleton node first, then this node second
+    setTickGroup(TickGroup::SECOND); // skeleton animations are updated right before the second group
 }
 
 void SkeletonBoneAttachmentNode::setBoneIndex(unsigned int iNewBoneIndex) { iBoneIndex = iNewBoneIndex; }
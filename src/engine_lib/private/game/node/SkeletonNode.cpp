@@ -1,9 +1,12 @@
 #include "game/node/SkeletonNode.h"
 
+// Custom.
+#include "game/GameManager.h"
+#include "game/World.h"
+#include "game/animation/AnimationManager.h"
+
 // External.
 #include "nameof.hpp"
-#include "ozz/base/io/stream.h"
-#include "ozz/base/io/archive.h"
 #include "ozz/base/span.h"
 #include "ozz/animation/runtime/animation.h"
 #include "ozz/animation/runtime/skeleton.h"
@@ -15,7 +18,7 @@ namespace {
 }
 
 AnimationSampler::AnimationSampler(
-    std::unique_ptr<ozz::animation::Animation> pInAnimation, ozz::animation::Skeleton* pSkeleton)
+    std::shared_ptr<const ozz::animation::Animation> pInAnimation, const ozz::animation::Skeleton* pSkeleton)
     : pSkeleton(pSkeleton) {
     pAnimation = std::move(pInAnimation);
 
@@ -39,7 +42,7 @@ void AnimationSampler::prepareForPlaying(bool bLoop) {
     bLoopAnimation = bLoop;
 }
 
-void AnimationSampler::updateAnimation(float deltaTime, bool bSampleBoneMatrices) {
+bool AnimationSampler::updateAnimation(float deltaTime, bool bSampleBoneMatrices) {
     animationRatio += deltaTime * playbackSpeed / pAnimation->duration();
     if (bLoopAnimation) {
         // Wraps in [0; 1] interval.
@@ -51,7 +54,7 @@ void AnimationSampler::updateAnimation(float deltaTime, bool bSampleBoneMatrices
     }
 
     if (!bSampleBoneMatrices) {
-        return;
+        return true;
     }
 
     // Sample bone local transforms.
@@ -60,9 +63,7 @@ void AnimationSampler::updateAnimation(float deltaTime, bool bSampleBoneMatrices
     samplingJob.context = pSamplingJobContext.get();
     samplingJob.ratio = animationRatio;
     samplingJob.output = ozz::make_span(vLocalTransforms);
-    if (!samplingJob.Run()) [[unlikely]] {
-        Error::showErrorAndThrowException("skeleton sampling job failed for node \"{}\"");
-    }
+    return samplingJob.Run();
 }
 
 float AnimationSampler::getDuration() const { return pAnimation->duration(); }
@@ -93,8 +94,23 @@ TypeReflectionInfo SkeletonNode::getReflectionInfo() {
 SkeletonNode::SkeletonNode() : SkeletonNode("Skeleton Node") {}
 
 SkeletonNode::SkeletonNode(const std::string& sNodeName) : SpatialNode(sNodeName) {
+    // Animations are updated by the animation manager but keep ticking in the first group so that
+    // derived nodes can change playing animations before they are updated (bone attachments tick second).
     setIsCalledEveryFrame(true);
-    setTickGroup(TickGroup::FIRST); // this node first, then bone attachment node second
+    setTickGroup(TickGroup::FIRST);
+}
+
+const std::array<glm::mat4x4, SkeletonNode::iMaxBoneCountAllowed>& SkeletonNode::getSkinningMatrices() const {
+    if (pSkinningMatrices == nullptr) {
+        static const auto vIdentityMatrices = []() {
+            std::array<glm::mat4x4, iMaxBoneCountAllowed> vMatrices;
+            vMatrices.fill(glm::identity<glm::mat4x4>());
+            return vMatrices;
+        }();
+        return vIdentityMatrices;
+    }
+
+    return *pSkinningMatrices;
 }
 
 void SkeletonNode::setPathToSkeletonRelativeRes(std::string sPathToNewSkeleton) {
@@ -151,7 +167,7 @@ void SkeletonNode::stopAnimation() {
 
     // Set rest pose.
     for (size_t i = 0; i < vResultingLocalTransforms.size(); i++) {
-        vResultingLocalTransforms[i] = pSkeleton->joint_rest_poses()[i];
+        vResultingLocalTransforms[i] = pSkeleton->skeleton.joint_rest_poses()[i];
     }
     convertResultingLocalTransformsToSkinning();
 }
@@ -169,7 +185,7 @@ AnimationSampler* SkeletonNode::findOrLoadAnimation(const std::string& sRelative
                 std::format("path to animation \"{}\" does not exist", sRelativePathToAnimation));
         }
 
-        loadAnimation(sRelativePathToAnimation, pSkeleton.get());
+        loadAnimation(sRelativePathToAnimation);
         animationIt = loadedAnimations.find(sRelativePathToAnimation);
         if (animationIt == loadedAnimations.end()) [[unlikely]] {
             Error::showErrorAndThrowException(
@@ -223,6 +239,9 @@ void SkeletonNode::playBlendedAnimations(
 void SkeletonNode::onSpawning() {
     SpatialNode::onSpawning();
 
+    // Register even without a skeleton so that child meshes have skinning matrices to reference.
+    getWorldWhileSpawned()->getGameManager().getAnimationManager().registerSkeleton(this);
+
     if (sPathToSkeletonRelativeRes.empty()) {
         Log::warn(std::format(
             "path to skeleton file was not specified for node \"{}\", node will do nothing", getNodeName()));
@@ -236,17 +255,13 @@ void SkeletonNode::onDespawning() {
     SpatialNode::onDespawning();
 
     unloadAnimationContextData();
+
+    getWorldWhileSpawned()->getGameManager().getAnimationManager().unregisterSkeleton(this);
 }
 
-void SkeletonNode::onBeforeNewFrame(float timeSincePrevFrameInSec) {
+bool SkeletonNode::updateAnimations(float deltaTime) {
     PROFILE_FUNC
 
-    SpatialNode::onBeforeNewFrame(timeSincePrevFrameInSec);
-
-    if (animState.vPlayingAnimations.empty()) {
-        return;
-    }
-
     if (animState.vPlayingAnimations.size() > 1) {
         // Calculate weights for blending.
         const size_t iIntervalCount = animState.vPlayingAnimations.size() - 1;
@@ -279,53 +294,64 @@ void SkeletonNode::onBeforeNewFrame(float timeSincePrevFrameInSec) {
 
     // Update each playing animation (no blending yet).
     for (auto& pSampler : animState.vPlayingAnimations) {
-        pSampler->updateAnimation(timeSincePrevFrameInSec, pSampler->getWeight() > 0.0f);
+        if (!pSampler->updateAnimation(deltaTime, pSampler->getWeight() > 0.0f)) [[unlikely]] {
+            return false;
+        }
     }
 
-    if (animState.vPlayingAnimations.size() > 1) {
-        // Prepare for blending.
-        ozz::vector<ozz::animation::BlendingJob::Layer> vLayers(animState.vPlayingAnimations.size());
-        for (size_t i = 0; i < vLayers.size(); ++i) {
-            vLayers[i].transform = ozz::make_span(animState.vPlayingAnimations[i]->getLocalTransforms());
-            vLayers[i].weight = animState.vPlayingAnimations[i]->getWeight();
-        }
+    if (animState.vPlayingAnimations.size() == 1) {
+        // Nothing to blend, convert sampled transforms directly.
+        return convertLocalTransformsToSkinning(
+            ozz::make_span(animState.vPlayingAnimations[0]->getLocalTransforms()));
+    }
 
-        // Blend animations.
-        ozz::animation::BlendingJob blendJob;
-        blendJob.threshold = ozz::animation::BlendingJob().threshold;
-        blendJob.layers = ozz::make_span(vLayers);
-        blendJob.rest_pose = pSkeleton->joint_rest_poses();
-        blendJob.output = ozz::make_span(vResultingLocalTransforms);
-        if (!blendJob.Run()) [[unlikely]] {
-            Error::showErrorAndThrowException(
-                std::format("failed to run animation blend job for node \"{}\"", getNodeName()));
-        }
-    } else {
-        vResultingLocalTransforms = animState.vPlayingAnimations[0]->getLocalTransforms();
+    // Prepare for blending.
+    vBlendLayers.resize(animState.vPlayingAnimations.size());
+    for (size_t i = 0; i < vBlendLayers.size(); ++i) {
+        vBlendLayers[i].transform = ozz::make_span(animState.vPlayingAnimations[i]->getLocalTransforms());
+        vBlendLayers[i].weight = animState.vPlayingAnimations[i]->getWeight();
     }
 
-    convertResultingLocalTransformsToSkinning();
+    // Blend animations.
+    ozz::animation::BlendingJob blendJob;
+    blendJob.layers = ozz::make_span(vBlendLayers);
+    blendJob.rest_pose = pSkeleton->skeleton.joint_rest_poses();
+    blendJob.output = ozz::make_span(vResultingLocalTransforms);
+    if (!blendJob.Run()) [[unlikely]] {
+        return false;
+    }
+
+    return convertLocalTransformsToSkinning(ozz::make_span(vResultingLocalTransforms));
 }
 
-void SkeletonNode::convertResultingLocalTransformsToSkinning() {
+bool SkeletonNode::convertLocalTransformsToSkinning(
+    ozz::span<const ozz::math::SoaTransform> vLocalTransforms) {
     // Convert local space matrices to model space.
     ozz::animation::LocalToModelJob localToModelJob;
-    localToModelJob.skeleton = pSkeleton.get();
-    localToModelJob.input = ozz::make_span(vResultingLocalTransforms);
+    localToModelJob.skeleton = &pSkeleton->skeleton;
+    localToModelJob.input = vLocalTransforms;
     localToModelJob.output = ozz::make_span(vBoneMatrices);
     if (!localToModelJob.Run()) [[unlikely]] {
-        Error::showErrorAndThrowException(std::format(
-            "failed to convert bone local space matrices to model space for node \"{}\"", getNodeName()));
+        return false;
     }
 
-    // Prepare skinning matrices.
+    // Prepare skinning matrices (using SIMD math and writing directly to the skinning buffer).
+    const auto& vInverseBindPoseMatrices = pSkeleton->vInverseBindPoseMatrices;
+    auto& vSkinningMatrices = *pSkinningMatrices;
     for (size_t i = 0; i < vBoneMatrices.size(); i++) {
-        glm::mat4x4 boneMatrix = glm::identity<glm::mat4x4>();
+        const auto skinningMatrix = vInverseBindPoseMatrices[i] * vBoneMatrices[i];
         for (int k = 0; k < 4; k++) {
-            ozz::math::StorePtr(vBoneMatrices[i].cols[k], &boneMatrix[k].x);
+            ozz::math::StorePtrU(skinningMatrix.cols[k], &vSkinningMatrices[i][k].x);
         }
+    }
+
+    return true;
+}
 
-        vSkinningMatrices[i] = vInverseBindPoseMatrices[i] * boneMatrix;
+void SkeletonNode::convertResultingLocalTransformsToSkinning() {
+    if (!convertLocalTransformsToSkinning(ozz::make_span(vResultingLocalTransforms))) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format(
+            "failed to convert bone local space matrices to model space for node \"{}\"", getNodeName()));
     }
 }
 
@@ -335,40 +361,36 @@ void SkeletonNode::loadAnimationContextData() {
             std::format("expected path to the skeleton to be valid, node \"{}\"", getNodeName()));
     }
 
-    // Load skeleton.
-    const auto pathToSkeletonFile =
-        ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sPathToSkeletonRelativeRes;
-    if (!std::filesystem::exists(pathToSkeletonFile)) [[unlikely]] {
-        Error::showErrorAndThrowException(
-            std::format("expected path to skeleton to exist \"{}\"", pathToSkeletonFile.string()));
-    }
-    pSkeleton = loadSkeleton(pathToSkeletonFile, vInverseBindPoseMatrices);
+    // Get skeleton (shared with other nodes).
+    auto& animationManager = getWorldWhileSpawned()->getGameManager().getAnimationManager();
+    pSkeleton = animationManager.getSkeleton(sPathToSkeletonRelativeRes);
+    const auto& skeleton = pSkeleton->skeleton;
 
     // Preload some animations.
     for (const auto& sRelativePath : pathsToAnimationsToPreload) {
-        loadAnimation(sRelativePath, pSkeleton.get());
+        loadAnimation(sRelativePath);
     }
     pathsToAnimationsToPreload.clear();
 
     // Allocate matrices.
-    vResultingLocalTransforms.resize(static_cast<size_t>(pSkeleton->num_soa_joints()));
-    vBoneMatrices.resize(static_cast<size_t>(pSkeleton->num_joints()));
-    if (vInverseBindPoseMatrices.size() > vSkinningMatrices.size()) [[unlikely]] {
+    vResultingLocalTransforms.resize(static_cast<size_t>(skeleton.num_soa_joints()));
+    vBoneMatrices.resize(static_cast<size_t>(skeleton.num_joints()));
+    if (pSkeleton->vInverseBindPoseMatrices.size() > pSkinningMatrices->size()) [[unlikely]] {
         Error::showErrorAndThrowException(std::format(
             "skeleton bone matrix mismatch {} != {}",
-            vInverseBindPoseMatrices.size(),
-            vSkinningMatrices.size()));
+            pSkeleton->vInverseBindPoseMatrices.size(),
+            pSkinningMatrices->size()));
     }
 
     // Set rest pose.
-    if (pSkeleton->joint_rest_poses().size() != vResultingLocalTransforms.size()) [[unlikely]] {
+    if (skeleton.joint_rest_poses().size() != vResultingLocalTransforms.size()) [[unlikely]] {
         Error::showErrorAndThrowException(std::format(
             "mismatched local transform count {} != {}",
-            pSkeleton->joint_rest_poses().size(),
+            skeleton.joint_rest_poses().size(),
             vResultingLocalTransforms.size()));
     }
     for (size_t i = 0; i < vResultingLocalTransforms.size(); i++) {
-        vResultingLocalTransforms[i] = pSkeleton->joint_rest_poses()[i];
+        vResultingLocalTransforms[i] = skeleton.joint_rest_poses()[i];
     }
     convertResultingLocalTransformsToSkinning();
 }
@@ -376,8 +398,9 @@ void SkeletonNode::loadAnimationContextData() {
 void SkeletonNode::unloadAnimationContextData() {
     animState.vPlayingAnimations.clear();
 
-    pSkeleton = nullptr;
+    // Samplers reference the skeleton.
     loadedAnimations.clear();
+    pSkeleton = nullptr;
 
     vResultingLocalTransforms.clear();
     vResultingLocalTransforms.shrink_to_fit();
@@ -385,110 +408,14 @@ void SkeletonNode::unloadAnimationContextData() {
     vBoneMatrices.clear();
     vBoneMatrices.shrink_to_fit();
 
-    vInverseBindPoseMatrices.clear();
-    vInverseBindPoseMatrices.shrink_to_fit();
-}
-
-std::unique_ptr<ozz::animation::Skeleton> SkeletonNode::loadSkeleton(
-    const std::filesystem::path& pathToSkeleton, std::vector<glm::mat4x4>& vInverseBindPoseMatrices) {
-    unsigned int iBoneCount = 0;
-    std::unique_ptr<ozz::animation::Skeleton> pSkeleton;
-    {
-        // Open file.
-        const std::string sFullPathToSkeletonFile = pathToSkeleton.string();
-        ozz::io::File file(sFullPathToSkeletonFile.c_str(), "rb");
-        if (!file.opened()) [[unlikely]] {
-            Error::showErrorAndThrowException(
-                std::format("unable to open the skeleton file \"{}\"", sFullPathToSkeletonFile));
-        }
-        ozz::io::IArchive archive(&file);
-        if (!archive.TestTag<ozz::animation::Skeleton>()) [[unlikely]] {
-            Error::showErrorAndThrowException(std::format(
-                "the skeleton file does not seem to store a skeleton \"{}\"", sFullPathToSkeletonFile));
-        }
-
-        // Create skeleton.
-        pSkeleton = std::make_unique<ozz::animation::Skeleton>();
-        archive >> *pSkeleton;
-
-        iBoneCount = static_cast<unsigned int>(pSkeleton->num_joints());
-        if (iBoneCount > SkeletonNode::getMaxBoneCountAllowed()) [[unlikely]] {
-            Error::showErrorAndThrowException(std::format(
-                "skeleton \"{}\" bone count {} exceeds the maximum allowed bone count of {}",
-                sFullPathToSkeletonFile,
-                iBoneCount,
-                SkeletonNode::getMaxBoneCountAllowed()));
-        }
-    }
-
-    // Load inverse bind pose matrices.
-    {
-        // Open file.
-        const auto pathToInverseBindPoseFile =
-            pathToSkeleton.parent_path() /
-            ("skeletonInverseBindPose." + std::string(Serializable::getBinaryFileExtension()));
-        std::ifstream file(pathToInverseBindPoseFile.c_str(), std::ios::binary);
-        if (!file.is_open()) [[unlikely]] {
-            Error::showErrorAndThrowException(
-                std::format("unable to open the file \"{}\"", pathToInverseBindPoseFile.string().c_str()));
-        }
-
-        // Get file size.
-        file.seekg(0, std::ios::end);
-        const size_t iFileSizeInBytes = static_cast<size_t>(file.tellg());
-        file.seekg(0);
-
-        // Read matrix count.
-        size_t iReadByteCount = 0;
-        unsigned int iMatrixCount = 0;
-        if (iReadByteCount + sizeof(iMatrixCount) > iFileSizeInBytes) [[unlikely]] {
-            Error::showErrorAndThrowException(
-                std::format("unexpected end of file \"{}\"", pathToInverseBindPoseFile.string().c_str()));
-        }
-        file.read(reinterpret_cast<char*>(&iMatrixCount), sizeof(iMatrixCount));
-        iReadByteCount += sizeof(iMatrixCount);
-
-        // Check matrix count.
-        if (iBoneCount != iMatrixCount) [[unlikely]] {
-            Error::showErrorAndThrowException(std::format(
-                "skeleton bone count {} does not match inverse bind pose matrix count {}",
-                iBoneCount,
-                vInverseBindPoseMatrices.size()));
-        }
-
-        // Read matrices.
-        vInverseBindPoseMatrices.resize(iMatrixCount);
-        for (unsigned int i = 0; i < iMatrixCount; i++) {
-            if (iReadByteCount + sizeof(glm::mat4x4) > iFileSizeInBytes) [[unlikely]] {
-                Error::showErrorAndThrowException(
-                    std::format("unexpected end of file \"{}\"", pathToInverseBindPoseFile.string()));
-            }
-
-            file.read(
-                reinterpret_cast<char*>(glm::value_ptr(vInverseBindPoseMatrices[i])), sizeof(glm::mat4x4));
-            iReadByteCount += sizeof(glm::mat4x4);
-        }
-    }
-
-    return pSkeleton;
+    vBlendLayers.clear();
+    vBlendLayers.shrink_to_fit();
 }
 
-void SkeletonNode::loadAnimation(
-    const std::string& sRelativePathToAnimation, ozz::animation::Skeleton* pSkeleton) {
+void SkeletonNode::loadAnimation(const std::string& sRelativePathToAnimation) {
     if (pSkeleton == nullptr) [[unlikely]] {
         Error::showErrorAndThrowException(std::format(
-            "unable to load animation \"{}\" because the specified skeleton is `nullptr`",
-            sRelativePathToAnimation));
-    }
-
-    // Construct full path.
-    const auto pathToAnimationFile =
-        ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sRelativePathToAnimation;
-    if (!std::filesystem::exists(pathToAnimationFile)) [[unlikely]] {
-        Error::showErrorAndThrowException(std::format(
-            "path to animation \"{}\" results in the full path of \"{}\" which does not exist",
-            sRelativePathToAnimation,
-            pathToAnimationFile.string()));
+            "unable to load animation \"{}\" because the skeleton is not loaded", sRelativePathToAnimation));
     }
 
     if (loadedAnimations.find(sRelativePathToAnimation) != loadedAnimations.end()) [[unlikely]] {
@@ -496,34 +423,11 @@ void SkeletonNode::loadAnimation(
             std::format("animation for path \"{}\" is already loaded", sRelativePathToAnimation));
     }
 
-    std::string sFullPathToAnimationFile = pathToAnimationFile.string();
-
-    // Open file.
-    ozz::io::File file(sFullPathToAnimationFile.c_str(), "rb");
-    if (!file.opened()) [[unlikely]] {
-        Error::showErrorAndThrowException(
-            std::format("unable to open the animation file \"{}\"", sFullPathToAnimationFile));
-    }
-    ozz::io::IArchive archive(&file);
-    if (!archive.TestTag<ozz::animation::Animation>()) {
-        Error::showErrorAndThrowException(std::format(
-            "the animation file does not seem to store an animation \"{}\"", sFullPathToAnimationFile));
-    }
-
-    // Create animation.
-    auto pAnimation = std::make_unique<ozz::animation::Animation>();
-    archive >> *pAnimation;
-
-    // Make sure animation is compatible.
-    if (pAnimation->num_tracks() != pSkeleton->num_joints()) [[unlikely]] {
-        Error::showErrorAndThrowException(std::format(
-            "animation \"{}\" is not compatible with the skeleton, animation has {} track(s) and "
-            "skeleton {} bone(s) these numbers need to match",
-            sRelativePathToAnimation,
-            pAnimation->num_tracks(),
-            pSkeleton->num_joints()));
-    }
+    // Get animation (shared with other nodes).
+    auto& animationManager = getWorldWhileSpawned()->getGameManager().getAnimationManager();
+    auto pAnimation = animationManager.getAnimation(sRelativePathToAnimation, pSkeleton->skeleton);
 
     loadedAnimations.emplace(
-        sRelativePathToAnimation, std::make_unique<AnimationSampler>(std::move(pAnimation), pSkeleton));
+        sRelativePathToAnimation,
+        std::make_unique<AnimationSampler>(std::move(pAnimation), &pSkeleton->skeleton));
 }
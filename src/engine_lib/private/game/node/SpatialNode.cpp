@@ -176,6 +176,37 @@ void SpatialNode::setWorldRotation(const glm::vec3& rotation) {
     recalculateWorldMatrix();
 }
 
+void SpatialNode::setWorldLocationRotation(const glm::vec3& location, const glm::vec3& rotation) {
+    glm::vec3 targetWorldRotation;
+    targetWorldRotation.x = MathHelpers::normalizeToRange(rotation.x, -360.0f, 360.0f); // NOLINT
+    targetWorldRotation.y = MathHelpers::normalizeToRange(rotation.y, -360.0f, 360.0f); // NOLINT
+    targetWorldRotation.z = MathHelpers::normalizeToRange(rotation.z, -360.0f, 360.0f); // NOLINT
+
+    std::scoped_lock guard(mtxWorldMatrix.first, mtxSpatialParent.first);
+
+    // See if we have a parent.
+    if (mtxSpatialParent.second != nullptr) {
+        // Get parent location/rotation/scale.
+        const auto parentLocation = mtxSpatialParent.second->getWorldLocation();
+        const auto inverseParentQuat = glm::inverse(mtxSpatialParent.second->getWorldRotationQuaternion());
+        const auto invertedScale =
+            MathHelpers::calculateReciprocalVector(mtxSpatialParent.second->getWorldScale());
+
+        // Calculate relative location (see `setWorldLocation`).
+        relativeLocation = (inverseParentQuat * (location - parentLocation)) * invertedScale;
+
+        // Calculate relative rotation (see `setWorldRotation`).
+        const auto rotationQuat = glm::toQuat(MathHelpers::buildRotationMatrix(targetWorldRotation));
+        relativeRotation = glm::degrees(glm::eulerAngles(inverseParentQuat * rotationQuat));
+    } else {
+        relativeLocation = location;
+        relativeRotation = targetWorldRotation;
+    }
+
+    recalculateLocalMatrix();
+    recalculateWorldMatrix();
+}
+
 void SpatialNode::setWorldScale(const glm::vec3& scale) {
 #if defined(DEBUG)
     // Make sure we don't have negative scale specified.
@@ -304,7 +304,9 @@ void CharacterBodyNode::updateCharacterPosition(
         {},
         {},
         tempAllocator);
+}
 
+void CharacterBodyNode::applyCharacterPosition() {
     bIsApplyingUpdateResults = true;
     {
         setWorldLocation(convertPosDirFromJolt(pCharacterBody->GetPosition()));
@@ -320,8 +322,8 @@ void CharacterBodyNode::onWorldLocationRotationScaleChanged() {
     }
 
     if (!bIsApplyingUpdateResults) {
-        pCharacterBody->SetPosition(convertPosDirToJolt(getWorldLocation()));
-        pCharacterBody->SetRotation(convertRotationToJolt(getWorldRotation()));
+        getWorldWhileSpawned()->getGameManager().getPhysicsManager().setCharacterLocationRotation(
+            this, getWorldLocation(), getWorldRotation());
     }
 
 #if defined(DEBUG)
@@ -172,6 +172,9 @@ void MovingBodyNode::onWorldLocationRotationScaleChanged() {
 
     auto& physicsManager = getWorldWhileSpawned()->getGameManager().getPhysicsManager();
     physicsManager.setBodyLocationRotation(pBody, getWorldLocation(), getWorldRotation());
+
+    // The body was teleported, don't interpolate from the old location.
+    physicsInterpolationState.reset(getWorldLocation(), getWorldRotation());
 }
 
 glm::vec3 MovingBodyNode::getGravityWhileSpawned() {
@@ -183,8 +186,7 @@ void MovingBodyNode::setPhysicsSimulationResults(
     const glm::vec3& worldLocation, const glm::vec3& worldRotation) {
     bIsApplyingSimulationResults = true;
 
-    setWorldLocation(worldLocation);
-    setWorldRotation(worldRotation);
+    setWorldLocationRotation(worldLocation, worldRotation);
 
     bIsApplyingSimulationResults = false;
 }
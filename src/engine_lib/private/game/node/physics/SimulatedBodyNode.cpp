@@ -253,8 +253,7 @@ void SimulatedBodyNode::setPhysicsSimulationResults(
     const glm::vec3& worldLocation, const glm::vec3& worldRotation) {
     bIsApplyingSimulationResults = true;
 
-    setWorldLocation(worldLocation);
-    setWorldRotation(worldRotation);
+    setWorldLocationRotation(worldLocation, worldRotation);
 
     bIsApplyingSimulationResults = false;
 }
@@ -288,6 +287,9 @@ void SimulatedBodyNode::onWorldLocationRotationScaleChanged() {
 
     auto& physicsManager = getWorldWhileSpawned()->getGameManager().getPhysicsManager();
     physicsManager.setBodyLocationRotation(pBody, getWorldLocation(), getWorldRotation());
+
+    // The body was teleported, don't interpolate from the old location.
+    physicsInterpolationState.reset(getWorldLocation(), getWorldRotation());
 }
 
 glm::vec3 SimulatedBodyNode::getGravityWhileSpawned() {
@@ -0,0 +1,61 @@
+#include "game/physics/CollisionShapeCache.h"
+
+// Standard.
+#include <format>
+#include <algorithm>
+
+// Custom.
+#include "game/geometry/shapes/CollisionShape.h"
+#include "misc/Profiler.hpp"
+
+JPH::Result<JPH::Ref<JPH::Shape>> CollisionShapeCache::getShape(const CollisionShape& shape, float density) {
+    PROFILE_FUNC
+
+    const auto sShapeKey = shape.getShapeCacheKey();
+    if (!bIsEnabled || sShapeKey.empty()) {
+        return shape.createShape(density);
+    }
+
+    // Shapes with different densities have different mass properties.
+    const auto sKey = std::format("{} {}", sShapeKey, density);
+
+    const auto it = cachedShapes.find(sKey);
+    if (it != cachedShapes.end()) {
+        JPH::Result<JPH::Ref<JPH::Shape>> result;
+        result.Set(it->second);
+        return result;
+    }
+
+    auto result = shape.createShape(density);
+    if (!result.IsValid()) {
+        // Don't cache errors.
+        return result;
+    }
+
+    if (cachedShapes.size() >= iCleanupShapeCount) {
+        // Don't keep shapes that are no longer used (for example after shape's properties were changed).
+        releaseUnusedShapes();
+        iCleanupShapeCount = std::max(iCleanupShapeCount, cachedShapes.size() * 2);
+    }
+    cachedShapes[sKey] = result.Get();
+
+    return result;
+}
+
+void CollisionShapeCache::setEnabled(bool bEnable) {
+    bIsEnabled = bEnable;
+
+    if (!bIsEnabled) {
+        // Bodies that use these shapes keep them alive.
+        cachedShapes.clear();
+    }
+}
+
+void CollisionShapeCache::releaseUnusedShapes() {
+    PROFILE_FUNC
+
+    std::erase_if(cachedShapes, [](const auto& item) {
+        // Only referenced by the cache.
+        return item.second->GetRefCount() == 1;
+    });
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+// Standard.
+#include <string>
+#include <unordered_map>
+
+// External.
+#include "Jolt/Jolt.h" // Always include Jolt.h before including any other Jolt header.
+#include "Jolt/Physics/Collision/Shape/Shape.h"
+
+class CollisionShape;
+
+/**
+ * Shares Jolt shapes between physics bodies that use identical collision shapes (same type, parameters
+ * and density) so that, for example, a convex hull used by many bodies is loaded and built only once.
+ *
+ * @remark Jolt shapes are immutable and reference counted so a single shape can be used by multiple bodies.
+ */
+class CollisionShapeCache {
+public:
+    CollisionShapeCache() = default;
+    ~CollisionShapeCache() = default;
+
+    CollisionShapeCache(const CollisionShapeCache&) = delete;
+    CollisionShapeCache& operator=(const CollisionShapeCache&) = delete;
+
+    /**
+     * Returns a previously created Jolt shape for the specified collision shape or creates a new one.
+     *
+     * @param shape   Collision shape.
+     * @param density Uniform density of the interior of the convex object (kg / m^3).
+     *
+     * @return Shape or an error if failed to create a new shape.
+     */
+    JPH::Result<JPH::Ref<JPH::Shape>> getShape(const CollisionShape& shape, float density = 1000.0f);
+
+    /**
+     * Enables/disables the cache (enabled by default). When disabled every call to @ref getShape creates a
+     * new Jolt shape, mostly used to compare performance.
+     *
+     * @param bEnable New state.
+     */
+    void setEnabled(bool bEnable);
+
+    /** Removes shapes that are only referenced by this cache (not used by any physics body). */
+    void releaseUnusedShapes();
+
+    /**
+     * Returns the number of shapes in the cache.
+     *
+     * @return Shape count.
+     */
+    size_t getCachedShapeCount() const { return cachedShapes.size(); }
+
+private:
+    /** Created shapes where key is a combination of shape's cache key and density. */
+    std::unordered_map<std::string, JPH::Ref<JPH::Shape>> cachedShapes;
+
+    /** Once the cache has this many shapes unused shapes will be released (see @ref releaseUnusedShapes). */
+    size_t iCleanupShapeCount = 64;
+
+    /** `false` to create a new shape in every call to @ref getShape. */
+    bool bIsEnabled = true;
+};
@@ -39,6 +39,17 @@ static inline JPH::Quat convertRotationToJolt(const glm::vec3& rotation) {
     return JPH::Quat(quat.x, quat.y, quat.z, quat.w);
 }
 
+/**
+ * Convert type.
+ *
+ * @param rotation Rotation.
+ *
+ * @return Result.
+ */
+static inline glm::quat convertQuatFromJolt(const JPH::Quat& rotation) {
+    return glm::quat(rotation.GetW(), rotation.GetX(), rotation.GetY(), rotation.GetZ());
+}
+
 /**
  * Convert type.
  *
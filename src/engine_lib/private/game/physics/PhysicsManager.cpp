@@ -3,13 +3,19 @@
 
 // Standard.
 #include <thread>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
 
 // Custom.
 #include "misc/Error.h"
+#include "io/Log.h"
 #include "misc/Profiler.hpp"
 #include "game/GameManager.h"
 #include "game/physics/PhysicsLayers.h"
 #include "game/physics/CoordinateConversions.hpp"
+#include "game/physics/PhysicsStepThread.h"
+#include "game/physics/CollisionShapeCache.h"
 #include "game/node/physics/CollisionNode.h"
 #include "game/node/physics/SimulatedBodyNode.h"
 #include "game/node/physics/MovingBodyNode.h"
@@ -18,6 +24,7 @@
 #include "game/node/physics/TriggerVolumeNode.h"
 #include "game/geometry/shapes/CollisionShape.h"
 #include "render/PhysicsDebugDrawer.hpp"
+#include "render/MeshRenderer.h"
 #include "game/DebugConsole.h"
 
 #if defined(__aarch64__) || defined(__ARM64__)
@@ -41,11 +48,14 @@
 #include "Jolt/Physics/PhysicsSettings.h"
 #include "Jolt/Physics/Body/BodyCreationSettings.h"
 #include "Jolt/Physics/Collision/ContactListener.h"
+#include "Jolt/Physics/Body/BodyActivationListener.h"
 #include "Jolt/Physics/Collision/Shape/StaticCompoundShape.h"
 #include "Jolt/Physics/Character/CharacterVirtual.h"
 #include "Jolt/Physics/Collision/RayCast.h"
 #include "Jolt/Physics/Collision/CastResult.h"
 #include "Jolt/Physics/Collision/CollisionCollectorImpl.h"
+#include "Jolt/Physics/Collision/ShapeCast.h"
+#include "Jolt/Physics/Collision/Shape/SphereShape.h"
 
 static void checkJoltInstructionSupport() {
 #ifndef IS_ARM64
@@ -107,22 +117,65 @@ static void checkJoltInstructionSupport() {
 namespace {
     // This is the max amount of rigid bodies that you can add to the physics system. If you try to create
     // more that this you'll get an error.
-    constexpr unsigned int MAX_BODIES = 1024;
+    constexpr unsigned int MAX_BODIES = 16384;
 
     // This is the max amount of body pairs that can be queued at any time (the broad phase will detect
     // overlapping body pairs based on their bounding boxes and will insert them into a queue for the
     // narrowphase). If you make this buffer too small the queue will fill up and the broad phase jobs will
     // start to do narrow phase work. This is slightly less efficient.
-    constexpr unsigned int MAX_BODY_PAIRS = 1024;
+    constexpr unsigned int MAX_BODY_PAIRS = 8192;
 
     // This is the maximum size of the contact constraint buffer. If more contacts (collisions between bodies)
     // are detected than this number then these contacts will be ignored and bodies will start
     // interpenetrating / fall through the world.
-    constexpr unsigned int MAX_CONTACT_CONSTRAINTS = 1024;
+    constexpr unsigned int MAX_CONTACT_CONSTRAINTS = 8192;
 
     // This determines how many mutexes to allocate to protect rigid bodies from concurrent access. Set it to
     // 0 for the default settings. Should be a power of 2 in the range [1, 64], use 0 to auto detect.
     constexpr unsigned int MAX_BODY_MUTEXES = 0;
+
+    // If a batch of body creation/destruction added/removed at least this number of bodies the broad phase
+    // is optimized (rebuilt) after the batch.
+    constexpr size_t MIN_BATCH_SIZE_TO_OPTIMIZE_BROAD_PHASE = 256;
+
+    // Batched queries are split into jobs with at least this number of queries per job (smaller batches
+    // are processed on the calling thread).
+    constexpr size_t MIN_QUERIES_PER_JOB = 64;
+
+    // Groups of characters are split into jobs with at least this number of groups per job.
+    constexpr size_t MIN_CHARACTER_GROUPS_PER_JOB = 2;
+
+    // Size of the temp allocator used by one job that updates characters.
+    constexpr unsigned int CHARACTER_JOB_TEMP_ALLOCATOR_SIZE = 512 * 1024; // 512 KB
+
+    // Distance (in meters) added to the area that a character can reach during an update to cover
+    // stair walking, sticking to the floor, contact distance and movement of the ground.
+    constexpr float CHARACTER_REACH_MARGIN = 1.0f;
+
+    /** Body filter that ignores bodies from an array without copying the array. */
+    class IgnoredBodiesFilter : public JPH::BodyFilter {
+    public:
+        /**
+         * Constructor.
+         *
+         * @param vIgnoredBodies Bodies to ignore, expected to be valid while the filter is used.
+         */
+        IgnoredBodiesFilter(std::span<const JPH::BodyID> vIgnoredBodies) : vIgnoredBodies(vIgnoredBodies) {}
+        virtual ~IgnoredBodiesFilter() override = default;
+
+        /**
+         * @param inBodyID Body to test.
+         *
+         * @return `false` if the body should be ignored.
+         */
+        virtual bool ShouldCollide(const JPH::BodyID& inBodyID) const override {
+            return std::find(vIgnoredBodies.begin(), vIgnoredBodies.end(), inBodyID) == vIgnoredBodies.end();
+        }
+
+    private:
+        /** Bodies to ignore (usually just a few so a linear search is fine). */
+        const std::span<const JPH::BodyID> vIgnoredBodies;
+    };
 }
 
 /** A listener class that receives collision contact events. */
@@ -162,21 +215,15 @@ public:
             return;
         }
 
-        auto& mtxData = pManager->mtxContactData;
-        std::scoped_lock guard(mtxData.first);
-
-        mtxData.second.newContactsAdded.push(PhysicsManager::ContactInfo{
-            .bIsAdded = true,
+        auto& data = pManager->contactData;
+        data.addedEvents.push(PhysicsManager::ContactAddedEvent{
+            .subShapePair = JPH::SubShapeIDPair(
+                inBody1.GetID(), inManifold.mSubShapeID1, inBody2.GetID(), inManifold.mSubShapeID2),
             .iSensorNodeId = pSensorBody->GetUserData(),
             .iOtherNodeId = pOtherBody->GetUserData(),
             .worldNormal = convertPosDirFromJolt(inManifold.mWorldSpaceNormal),
             .contactPointLocation = convertPosDirFromJolt(inManifold.GetWorldSpaceContactPointOn1(0)),
-        });
-
-        mtxData.second.activeSensorContacts[JPH::SubShapeIDPair(
-            inBody1.GetID(), inManifold.mSubShapeID1, inBody2.GetID(), inManifold.mSubShapeID2)] =
-            PhysicsManager::SensorContactInfo{
-                .iSensorNodeId = pSensorBody->GetUserData(), .iOtherNodeId = pOtherBody->GetUserData()};
+            .iEventIndex = data.iNextEventIndex.fetch_add(1, std::memory_order_relaxed)});
     }
 
     /**
@@ -186,20 +233,49 @@ public:
         // Note: this function is called from Jolt's thread pool when all bodies are locked.
 
         // Body can be destroyed at this point so we can't use it.
-        auto& mtxData = pManager->mtxContactData;
-        std::scoped_lock guard(mtxData.first);
-
-        const auto it = mtxData.second.activeSensorContacts.find(inSubShapePair);
-        if (it == mtxData.second.activeSensorContacts.end()) {
+        const auto& vIsSensorBody = pManager->vIsSensorBody;
+        if (!vIsSensorBody[inSubShapePair.GetBody1ID().GetIndex()] &&
+            !vIsSensorBody[inSubShapePair.GetBody2ID().GetIndex()]) {
             return;
         }
 
-        mtxData.second.newContactsRemoved.push(PhysicsManager::ContactInfo{
-            .bIsAdded = false,
-            .iSensorNodeId = it->second.iSensorNodeId,
-            .iOtherNodeId = it->second.iOtherNodeId});
+        auto& data = pManager->contactData;
+        data.removedEvents.push(PhysicsManager::ContactRemovedEvent{
+            .subShapePair = inSubShapePair,
+            .iEventIndex = data.iNextEventIndex.fetch_add(1, std::memory_order_relaxed)});
+    }
+
+private:
+    /** Physics manager. */
+    PhysicsManager* const pManager = nullptr;
+};
+
+/** A listener class that receives body activation events. */
+class BodyActivationListener : public JPH::BodyActivationListener {
+public:
+    /**
+     * Constructor.
+     *
+     * @param pManager Physics manager.
+     */
+    BodyActivationListener(PhysicsManager* pManager) : pManager(pManager) {}
+    virtual ~BodyActivationListener() override = default;
+
+    /**
+     * @param inBodyID       Activated body.
+     * @param inBodyUserData Body's user data.
+     */
+    virtual void OnBodyActivated(const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData) override {
+        // Note: this function can be called from Jolt's thread pool.
+        pManager->onBodyActivated(inBodyID);
+    }
 
-        mtxData.second.activeSensorContacts.erase(it);
+    /**
+     * @param inBodyID       Deactivated body.
+     * @param inBodyUserData Body's user data.
+     */
+    virtual void OnBodyDeactivated(const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData) override {
+        // Nodes of deactivated bodies are moved to sleeping nodes after they receive the final transform.
     }
 
 private:
@@ -211,6 +287,7 @@ PhysicsManager::PhysicsManager(GameManager* pGameManager) : pGameManager(pGameMa
     checkJoltInstructionSupport();
 
     pTempAllocator = std::make_unique<JPH::TempAllocatorImpl>(1024 * 1024); // 1 MB
+    pCollisionShapeCache = std::make_unique<CollisionShapeCache>();
 
     pJobSystem = std::make_unique<JPH::JobSystemThreadPool>(
         JPH::cMaxPhysicsJobs,
@@ -224,8 +301,10 @@ PhysicsManager::PhysicsManager(GameManager* pGameManager) : pGameManager(pGameMa
     pBroadPhaseLayerInterfaceImpl = std::make_unique<BroadPhaseLayerInterfaceImpl>();
     pObjectVsBroadPhaseLayerFilterImpl = std::make_unique<ObjectVsBroadPhaseLayerFilterImpl>();
     pObjectLayerPairFilterImpl = std::make_unique<ObjectLayerPairFilterImpl>();
-    pCharVsCharCollision = std::make_unique<JPH::CharacterVsCharacterCollisionSimple>();
     pContactListener = std::make_unique<ContactListener>(this);
+    pBodyActivationListener = std::make_unique<BodyActivationListener>(this);
+    vIsSensorBody.resize(MAX_BODIES, false);
+    vBodyNodeSlots.resize(MAX_BODIES);
 
     pPhysicsSystem->Init(
         MAX_BODIES,
@@ -236,12 +315,11 @@ PhysicsManager::PhysicsManager(GameManager* pGameManager) : pGameManager(pGameMa
         *pObjectVsBroadPhaseLayerFilterImpl,
         *pObjectLayerPairFilterImpl);
 
-    // Configure physics settings.
-    auto settings = pPhysicsSystem->GetPhysicsSettings();
-    settings.mAllowSleeping =
-        false; // disable because sleeping bodies don't notify contact callbacks which can be inconvenient
-    pPhysicsSystem->SetPhysicsSettings(settings);
+    // Note: sleeping is allowed. Sleeping bodies keep their contacts but static sensors don't detect them
+    // so sensors wake up bodies they overlap when added or moved (see `activateBodiesInSensor`), the inner
+    // body of characters never sleeps (Jolt disables sleeping for it).
     pPhysicsSystem->SetContactListener(pContactListener.get());
+    pPhysicsSystem->SetBodyActivationListener(pBodyActivationListener.get());
 
 #if defined(ENGINE_DEBUG_TOOLS)
     pPhysicsDebugDrawer = std::make_unique<PhysicsDebugDrawer>();
@@ -258,11 +336,18 @@ PhysicsManager::PhysicsManager(GameManager* pGameManager) : pGameManager(pGameMa
 }
 
 PhysicsManager::~PhysicsManager() {
-    if (!simulatedBodies.empty()) [[unlikely]] {
+    waitForAsyncPhysicsStep();
+
+    if (bodyBatch.iDepth != 0) [[unlikely]] {
+        Error::showErrorAndThrowException(
+            "physics manager is being destroyed but a batch of body creation/destruction was not finished");
+    }
+
+    if (!simulatedBodies.vNodes.empty()) [[unlikely]] {
         Error::showErrorAndThrowException(
             "physics manager is being destroyed but there are still some simulated bodies registered");
     }
-    if (!movingBodies.empty()) [[unlikely]] {
+    if (!movingBodies.vNodes.empty()) [[unlikely]] {
         Error::showErrorAndThrowException(
             "physics manager is being destroyed but there are still some moving bodies registered");
     }
@@ -275,11 +360,6 @@ PhysicsManager::~PhysicsManager() {
             "physics manager is being destroyed but there are still some alive bodies registered");
     }
 
-    if (!pCharVsCharCollision->mCharacters.empty()) [[unlikely]] {
-        Error::showErrorAndThrowException(
-            "physics manager is being destroyed but there are still some characters registered");
-    }
-
     JPH::UnregisterTypes();
 
     delete JPH::Factory::sInstance;
@@ -289,220 +369,534 @@ PhysicsManager::~PhysicsManager() {
 void PhysicsManager::onBeforeNewFrame(float timeSincePrevFrameInSec) {
     PROFILE_FUNC
 
-    // Ideally we should separate rendering and physics, have 60 tickrate for physics
-    // and do physics interpolation in case the FPS is higher than 60 but because
-    // physics interpolation is a pain in the back I go the stupid way:
+    // Make sure all created bodies are in the physics world.
+    flushBodyBatch();
+
+#if !defined(ENGINE_EDITOR)
+    // Physics runs with a fixed tick rate (so that the simulation does not depend on the framerate) and
+    // nodes are rendered in-between the last 2 physics updates.
+    unsigned int iTicksToRun = 0;
+    if (bIsAsyncPhysicsStepEnabled) {
+        // Apply the step that was running while the previous frame was rendered.
+        applyAsyncPhysicsStepResults();
+
+        timeNotSimulatedSec += timeSincePrevFrameInSec;
+
+        // Nodes are one physics update behind the simulation so interpolate in the last finished update
+        // (done before starting the next step because it reads the state of bodies).
+        if (lastPhysicsUpdateTimeSec > 0.0f) {
+            interpolateBodyTransforms(std::min(timeNotSimulatedSec / lastPhysicsUpdateTimeSec, 1.0f));
+        }
+
+        while (timeNotSimulatedSec >= physicsTickTimeSec && iTicksToRun < iMaxPhysicsTicksPerFrame) {
+            timeNotSimulatedSec -= physicsTickTimeSec;
+            iTicksToRun += 1;
+        }
+    } else {
+        timeNotSimulatedSec += timeSincePrevFrameInSec;
+
+        unsigned int iTicksRun = 0;
+        while (timeNotSimulatedSec >= physicsTickTimeSec && iTicksRun < iMaxPhysicsTicksPerFrame) {
+            PROFILE_SCOPE("physics tick")
+
+            runPhysicsTick(physicsTickTimeSec);
 
-    // If the framerate is too low we will try to make sure bodies don't fall through each other but the
-    // physics will slow down (it might seem like we're in slow motion).
-    constexpr float MIN_UPDATE_TIME = 1.0f / 25.0f;
+            timeNotSimulatedSec -= physicsTickTimeSec;
+            iTicksRun += 1;
+        }
+    }
+
+    if (timeNotSimulatedSec >= physicsTickTimeSec) {
+        // The framerate is too low, drop the time we can't catch up with to avoid running more and more
+        // ticks each frame (the physics will slow down).
+        timeNotSimulatedSec = std::fmod(timeNotSimulatedSec, physicsTickTimeSec);
+    }
+
+    if (!bIsAsyncPhysicsStepEnabled) {
+        interpolateBodyTransforms(timeNotSimulatedSec / physicsTickTimeSec);
+    }
+#endif
+
+#if defined(ENGINE_DEBUG_TOOLS)
+    if (bEnableDebugRendering) {
+        PROFILE_SCOPE("draw collision")
+
+        JPH::BodyManager::DrawSettings drawSettings;
+        pPhysicsSystem->DrawBodies(drawSettings, pPhysicsDebugDrawer.get());
+
+        // Character bodies must be drawn explicitly.
+        for (const auto& pCharacterBody : characterBodies) {
+            pPhysicsDebugDrawer->DrawCapsule(
+                pCharacterBody->pCharacterBody->GetCenterOfMassTransform(),
+                pCharacterBody->pCollisionShape->getHalfHeight(),
+                pCharacterBody->pCollisionShape->getRadius(),
+                JPH::Color::sGrey,
+                JPH::DebugRenderer::ECastShadow::Off,
+                JPH::DebugRenderer::EDrawMode::Solid);
+        }
+
+        pPhysicsDebugDrawer->submitDrawData();
+    }
+
+    {
+        PROFILE_SCOPE("collect debug stats")
+
+        auto& stats = DebugConsole::getStats();
+        stats.iActiveCharacterBodyCount = characterBodies.size();
+        stats.iTotalSimulatedBodyCount = simulatedBodies.vNodes.size();
+        stats.iTotalMovingBodyCount = movingBodies.vNodes.size();
+        stats.iActiveSimulatedBodyCount = 0;
+        stats.iActiveMovingBodyCount = 0;
+
+        // Active bodies are only among awake nodes.
+        for (size_t i = 0; i < simulatedBodies.iAwakeCount; i++) {
+            if (simulatedBodies.vNodes[i]->pBody->IsActive()) {
+                stats.iActiveSimulatedBodyCount += 1;
+            }
+        }
+
+        for (size_t i = 0; i < movingBodies.iAwakeCount; i++) {
+            if (movingBodies.vNodes[i]->pBody->IsActive()) {
+                stats.iActiveMovingBodyCount += 1;
+            }
+        }
+    }
+#endif
 
 #if !defined(ENGINE_EDITOR)
-    float deltaTimeLeftToSimulate = std::min(timeSincePrevFrameInSec, 2.0f * MIN_UPDATE_TIME);
-    for (size_t i = 0; (i < 2) && (deltaTimeLeftToSimulate > 0.001f); i++) { // do at max 2 iterations
-        PROFILE_SCOPE("physics tick")
+    // Start the step last since it will access the physics world until the next frame.
+    if (iTicksToRun > 0) {
+        startAsyncPhysicsStep(iTicksToRun);
+    }
+#endif
+}
 
-        const float deltaTime = std::min(MIN_UPDATE_TIME, deltaTimeLeftToSimulate);
-        deltaTimeLeftToSimulate -= deltaTime;
+void PhysicsManager::setEnableAsyncPhysicsStep(bool bEnable) {
+    if (bIsAsyncPhysicsStepEnabled == bEnable) {
+        return;
+    }
 
-        {
-            PROFILE_SCOPE("onBeforePhysicsUpdate - SimulatedBodyNode")
-            for (const auto& pSimulatedNode : simulatedBodies) {
-                if (!pSimulatedNode->pBody->IsActive()) {
-                    continue;
-                }
-                pSimulatedNode->onBeforePhysicsUpdate(deltaTime);
+    if (bEnable) {
+        if (pPhysicsStepThread == nullptr) {
+            pPhysicsStepThread = std::make_unique<PhysicsStepThread>();
+        }
+    } else {
+        applyAsyncPhysicsStepResults();
+    }
+
+    bIsAsyncPhysicsStepEnabled = bEnable;
+}
+
+void PhysicsManager::runPhysicsTick(float deltaTime) {
+    runPhysicsUpdateCallbacks(deltaTime);
+
+    iPendingSensorFlagCountBeforeStep = vPendingSensorFlags.size();
+    {
+        PROFILE_SCOPE("JPH::PhysicsSystem::Update")
+        pPhysicsSystem->Update(deltaTime, 1, pTempAllocator.get(), pJobSystem.get());
+    }
+    lastPhysicsUpdateTimeSec = deltaTime;
+    applyPendingSensorFlags();
+
+    saveBodyTransformsForInterpolation();
+    processCharacterContactEvents();
+    processSensorContactEvents(false);
+}
+
+void PhysicsManager::runPhysicsUpdateCallbacks(float deltaTime) {
+    // Callbacks can activate bodies which appends nodes to awake nodes so only iterate over nodes that were
+    // awake before the callbacks.
+    {
+        PROFILE_SCOPE("onBeforePhysicsUpdate - SimulatedBodyNode")
+        const auto iAwakeCount = simulatedBodies.iAwakeCount;
+        for (size_t i = 0; i < iAwakeCount; i++) {
+            const auto pSimulatedNode = simulatedBodies.vNodes[i];
+            if (!pSimulatedNode->pBody->IsActive()) {
+                continue;
             }
+            pSimulatedNode->onBeforePhysicsUpdate(deltaTime);
         }
+    }
 
-        {
-            PROFILE_SCOPE("onBeforePhysicsUpdate - MovingBodyNode")
-            for (const auto& pMovingBody : movingBodies) {
-                if (!pMovingBody->pBody->IsActive()) {
-                    continue;
-                }
+    {
+        PROFILE_SCOPE("onBeforePhysicsUpdate - MovingBodyNode")
+        const auto iAwakeCount = movingBodies.iAwakeCount;
+        for (size_t i = 0; i < iAwakeCount; i++) {
+            const auto pMovingBody = movingBodies.vNodes[i];
+            if (!pMovingBody->pBody->IsActive()) {
+                continue;
+            }
 #if defined(DEBUG)
-                pMovingBody->bIsInPhysicsTick = true;
+            pMovingBody->bIsInPhysicsTick = true;
 #endif
-                pMovingBody->onBeforePhysicsUpdate(deltaTime);
+            pMovingBody->onBeforePhysicsUpdate(deltaTime);
 #if defined(DEBUG)
-                pMovingBody->bIsInPhysicsTick = false;
+            pMovingBody->bIsInPhysicsTick = false;
 #endif
-            }
         }
+    }
 
-        {
-            PROFILE_SCOPE("onBeforePhysicsUpdate - CharacterBodyNode")
-            for (const auto& pCharacterBody : characterBodies) {
+    {
+        PROFILE_SCOPE("onBeforePhysicsUpdate - CharacterBodyNode")
+        for (const auto& pCharacterBody : characterBodies) {
 #if defined(DEBUG)
-                pCharacterBody->bIsInPhysicsTick = true;
+            pCharacterBody->bIsInPhysicsTick = true;
 #endif
-                pCharacterBody->onBeforePhysicsUpdate(deltaTime);
+            pCharacterBody->onBeforePhysicsUpdate(deltaTime);
 #if defined(DEBUG)
-                pCharacterBody->bIsInPhysicsTick = false;
+            pCharacterBody->bIsInPhysicsTick = false;
 #endif
-                pCharacterBody->updateCharacterPosition(*pPhysicsSystem, *pTempAllocator, deltaTime);
-            }
         }
+    }
 
-        {
-            PROFILE_SCOPE("JPH::PhysicsSystem::Update")
-            pPhysicsSystem->Update(deltaTime, 1, pTempAllocator.get(), pJobSystem.get());
-        }
+    updateCharacterPositions(deltaTime);
+}
 
-        // Update nodes according to simulation results.
-        if (!simulatedBodies.empty()) {
-            PROFILE_SCOPE("update simulated bodies after simulation")
+void PhysicsManager::startAsyncPhysicsStep(unsigned int iTickCount) {
+    PROFILE_FUNC
 
-            for (const auto& pSimulatedBodyNode : simulatedBodies) {
-                if (!pSimulatedBodyNode->pBody->IsActive()) {
-                    continue;
-                }
+    // Callbacks must run before each tick and they run game code on the main thread so ticks that the
+    // frame needs to catch up with are simulated here.
+    for (unsigned int i = 1; i < iTickCount; i++) {
+        PROFILE_SCOPE("physics tick")
+        runPhysicsTick(physicsTickTimeSec);
+    }
 
-                JPH::Vec3 position{};
-                JPH::Quat rotation{};
-                pPhysicsSystem->GetBodyInterface().GetPositionAndRotation(
-                    pSimulatedBodyNode->pBody->GetID(), position, rotation);
+    const auto deltaTime = physicsTickTimeSec;
+    runPhysicsUpdateCallbacks(deltaTime);
 
-                pSimulatedBodyNode->setPhysicsSimulationResults(
-                    convertPosDirFromJolt(position), convertRotationFromJolt(rotation));
-            }
+    // Character contacts are found while moving characters (not during the update) so process them now.
+    processCharacterContactEvents();
+
+    iPendingSensorFlagCountBeforeStep = vPendingSensorFlags.size();
+    asyncPhysicsStepResult = pPhysicsStepThread->addTask(std::packaged_task<void()>([this, deltaTime]() {
+        PROFILE_SCOPE("JPH::PhysicsSystem::Update")
+        pPhysicsSystem->Update(deltaTime, 1, pTempAllocator.get(), pJobSystem.get());
+    }));
+    bIsAsyncPhysicsStepResultPending = true;
+    lastPhysicsUpdateTimeSec = deltaTime;
+}
+
+void PhysicsManager::waitForAsyncPhysicsStep() {
+    if (!asyncPhysicsStepResult.valid()) {
+        return;
+    }
+
+    PROFILE_FUNC
+
+    // Rethrows the exception (if the step failed).
+    asyncPhysicsStepResult.get();
+}
+
+void PhysicsManager::applyAsyncPhysicsStepResults() {
+    waitForAsyncPhysicsStep();
+
+    if (!bIsAsyncPhysicsStepResultPending) {
+        return;
+    }
+    bIsAsyncPhysicsStepResultPending = false;
+
+    applyPendingSensorFlags();
+    saveBodyTransformsForInterpolation();
+
+    // Nodes could be despawned while the step was running.
+    processSensorContactEvents(true);
+}
+
+void PhysicsManager::saveBodyTransformsForInterpolation() {
+    // The simulation is not running at this point so don't lock every body.
+    auto& bodyInterface = pPhysicsSystem->GetBodyInterfaceNoLock();
+
+    const auto updateInterpolationState = [&bodyInterface](
+                                              JPH::Body* pBody, PhysicsBodyInterpolationState& state) {
+        if (state.bIsSettled && !pBody->IsActive()) {
+            // Sleeping and the node already has the final transform.
+            return;
         }
-        if (!movingBodies.empty()) {
-            PROFILE_SCOPE("update moving bodies after simulation")
 
-            for (const auto& pMovingBodyNode : movingBodies) {
-                if (!pMovingBodyNode->pBody->IsActive()) {
-                    continue;
-                }
+        JPH::Vec3 position{};
+        JPH::Quat rotation{};
+        bodyInterface.GetPositionAndRotation(pBody->GetID(), position, rotation);
+
+        state.previousLocation = state.currentLocation;
+        state.previousRotation = state.currentRotation;
+        state.currentLocation = convertPosDirFromJolt(position);
+        state.currentRotation = convertQuatFromJolt(rotation);
+        state.bIsSettled = false;
+    };
+    if (simulatedBodies.iAwakeCount > 0) {
+        PROFILE_SCOPE("update simulated bodies after simulation")
+        for (size_t i = 0; i < simulatedBodies.iAwakeCount; i++) {
+            const auto pSimulatedBodyNode = simulatedBodies.vNodes[i];
+            updateInterpolationState(
+                pSimulatedBodyNode->pBody, pSimulatedBodyNode->physicsInterpolationState);
+        }
+    }
+    if (movingBodies.iAwakeCount > 0) {
+        PROFILE_SCOPE("update moving bodies after simulation")
+        for (size_t i = 0; i < movingBodies.iAwakeCount; i++) {
+            const auto pMovingBodyNode = movingBodies.vNodes[i];
+            updateInterpolationState(pMovingBodyNode->pBody, pMovingBodyNode->physicsInterpolationState);
+        }
+    }
+}
 
-                JPH::Vec3 position{};
-                JPH::Quat rotation{};
-                pPhysicsSystem->GetBodyInterface().GetPositionAndRotation(
-                    pMovingBodyNode->pBody->GetID(), position, rotation);
+void PhysicsManager::processCharacterContactEvents() {
+    PROFILE_SCOPE("CharacterBodyNode::processContactEvents")
 
-                pMovingBodyNode->setPhysicsSimulationResults(
-                    convertPosDirFromJolt(position), convertRotationFromJolt(rotation));
-            }
+    for (const auto& pCharacterBody : characterBodies) {
+        pCharacterBody->processContactEvents();
+    }
+}
+
+void PhysicsManager::processSensorContactEvents(bool bSkipDespawnedNodes) {
+    PROFILE_FUNC
+
+    // The physics step is not running at this point so only this thread accesses event buffers.
+    auto& data = contactData;
+    data.vContactsAdded.clear();
+    data.vContactsRemoved.clear();
+
+    // Update active contacts in the order events happened (a contact can be added and removed during
+    // multiple physics steps).
+    while (true) {
+        const auto pAddedEvent = data.addedEvents.peek();
+        const auto pRemovedEvent = data.removedEvents.peek();
+        if (pAddedEvent == nullptr && pRemovedEvent == nullptr) {
+            break;
         }
 
-        {
-            PROFILE_SCOPE("CharacterBodyNode::processContactEvents")
-            for (const auto& pCharacterBody : characterBodies) {
-                pCharacterBody->processContactEvents();
+        if (pRemovedEvent != nullptr &&
+            (pAddedEvent == nullptr || pRemovedEvent->iEventIndex < pAddedEvent->iEventIndex)) {
+            const auto it = data.activeSensorContacts.find(pRemovedEvent->subShapePair);
+            if (it != data.activeSensorContacts.end()) {
+                data.vContactsRemoved.push_back(ContactInfo{
+                    .bIsAdded = false,
+                    .iSensorNodeId = it->second.iSensorNodeId,
+                    .iOtherNodeId = it->second.iOtherNodeId});
+                data.activeSensorContacts.erase(it);
             }
+            data.removedEvents.pop();
+            continue;
         }
 
-        // Process contacts.
-        {
-            auto& mtxWorlds = pGameManager->getWorlds();
-            std::scoped_lock guardWorld(mtxWorlds.first);
-            if (!mtxWorlds.second.vWorlds.empty()) {
-                const auto pWorld = mtxWorlds.second.vWorlds[0].get();
-
-                std::scoped_lock guardContacts(mtxContactData.first);
+        data.activeSensorContacts[pAddedEvent->subShapePair] = SensorContactInfo{
+            .iSensorNodeId = pAddedEvent->iSensorNodeId, .iOtherNodeId = pAddedEvent->iOtherNodeId};
+        data.vContactsAdded.push_back(ContactInfo{
+            .bIsAdded = true,
+            .iSensorNodeId = pAddedEvent->iSensorNodeId,
+            .iOtherNodeId = pAddedEvent->iOtherNodeId,
+            .worldNormal = pAddedEvent->worldNormal,
+            .contactPointLocation = pAddedEvent->contactPointLocation});
+        data.addedEvents.pop();
+    }
+
+    // Report dropped events.
+    const auto iDroppedAddedCount = data.addedEvents.resetOverflowCount();
+    const auto iDroppedRemovedCount = data.removedEvents.resetOverflowCount();
+    if (iDroppedAddedCount + iDroppedRemovedCount > 0) [[unlikely]] {
+        data.iDroppedEventCount += iDroppedAddedCount + iDroppedRemovedCount;
+        Log::warn(std::format(
+            "dropped {} contact added and {} contact removed events because more than {} events of one "
+            "type happened during a physics step",
+            iDroppedAddedCount,
+            iDroppedRemovedCount,
+            ContactData::iMaxEventsPerStep));
+    }
 
-                // Prepare lambda to process contact events.
-                const auto processContacts = [pWorld](std::queue<ContactInfo>& contacts) {
-                    while (!contacts.empty()) {
-                        auto& info = contacts.front();
+    if (data.vContactsAdded.empty() && data.vContactsRemoved.empty()) {
+        return;
+    }
 
-                        // Get sensor node.
-                        const auto pSensorNode = pWorld->getSpawnedNodeById(info.iSensorNodeId);
-                        if (pSensorNode == nullptr) [[unlikely]] {
-                            Error::showErrorAndThrowException(
-                                "unable to determine contact node from body id");
-                        }
+    auto& mtxWorlds = pGameManager->getWorlds();
+    std::scoped_lock guardWorld(mtxWorlds.first);
+    if (mtxWorlds.second.vWorlds.empty()) {
+        return;
+    }
+    const auto pWorld = mtxWorlds.second.vWorlds[0].get();
+
+    // Prepare lambda to process contact events.
+    const auto processContacts = [pWorld, bSkipDespawnedNodes](const std::vector<ContactInfo>& vContacts) {
+        for (const auto& info : vContacts) {
+            // Get nodes.
+            const auto pSensorNode = pWorld->getSpawnedNodeById(info.iSensorNodeId);
+            const auto pHitNode = pWorld->getSpawnedNodeById(info.iOtherNodeId);
+            if (pSensorNode == nullptr || pHitNode == nullptr) [[unlikely]] {
+                if (!bSkipDespawnedNodes) {
+                    Error::showErrorAndThrowException("unable to determine contact node from body id");
+                }
+                continue;
+            }
 
-                        // Cast type.
+            // Cast type.
 #if defined(DEBUG)
-                        const auto pTriggerNode = dynamic_cast<TriggerVolumeNode*>(pSensorNode);
-                        if (pTriggerNode == nullptr) [[unlikely]] {
-                            Error::showErrorAndThrowException(std::format(
-                                "expected the node \"{}\" to be a trigger volume node",
-                                pSensorNode->getNodeName()));
-                        }
+            const auto pTriggerNode = dynamic_cast<TriggerVolumeNode*>(pSensorNode);
+            if (pTriggerNode == nullptr) [[unlikely]] {
+                Error::showErrorAndThrowException(std::format(
+                    "expected the node \"{}\" to be a trigger volume node", pSensorNode->getNodeName()));
+            }
 #else
-                        const auto pTriggerNode = reinterpret_cast<TriggerVolumeNode*>(pSensorNode);
+            const auto pTriggerNode = reinterpret_cast<TriggerVolumeNode*>(pSensorNode);
 #endif
 
-                        // Get other node.
-                        const auto pHitNode = pWorld->getSpawnedNodeById(info.iOtherNodeId);
-                        if (pHitNode == nullptr) [[unlikely]] {
-                            Error::showErrorAndThrowException(
-                                "unable to determine contact node from body id");
-                        }
-
-                        // Notify.
-                        if (info.bIsAdded) {
-                            pTriggerNode->onContactAdded(
-                                pHitNode, info.contactPointLocation, info.worldNormal);
-                        } else {
-                            pTriggerNode->onContactRemoved(pHitNode);
-                        }
-
-                        contacts.pop();
-                    }
-                };
-
-                // First process removed contacts because when a character changes its shape (possible due to
-                // crouching) in a single update we will receive 2 events (old shape removed and new shape
-                // added, the order might be different) but because we give nodes to the user (in contact
-                // callback) the events received by the user might look like this: "added node, tick, added
-                // node (again, new shape), removed node (old shape), tick" but we want: "added node, tick,
-                // removed node (old shape), added node (new shape), tick".
-                processContacts(mtxContactData.second.newContactsRemoved);
-                processContacts(mtxContactData.second.newContactsAdded);
-
-                mtxContactData.second.newContactsAdded = {};
-                mtxContactData.second.newContactsRemoved = {};
+            // Notify.
+            if (info.bIsAdded) {
+                pTriggerNode->onContactAdded(pHitNode, info.contactPointLocation, info.worldNormal);
+            } else {
+                pTriggerNode->onContactRemoved(pHitNode);
             }
         }
-    }
-#endif
+    };
+
+    // First process removed contacts because when a character changes its shape (possible due to
+    // crouching) in a single update we will receive 2 events (old shape removed and new shape added, the
+    // order might be different) but because we give nodes to the user (in contact callback) the events
+    // received by the user might look like this: "added node, tick, added node (again, new shape), removed
+    // node (old shape), tick" but we want: "added node, tick, removed node (old shape), added node (new
+    // shape), tick".
+    processContacts(data.vContactsRemoved);
+    processContacts(data.vContactsAdded);
+}
 
-#if defined(ENGINE_DEBUG_TOOLS)
-    if (bEnableDebugRendering) {
-        PROFILE_SCOPE("draw collision")
+void PhysicsManager::interpolateBodyTransforms(float alpha) {
+    PROFILE_FUNC
 
-        JPH::BodyManager::DrawSettings drawSettings;
-        pPhysicsSystem->DrawBodies(drawSettings, pPhysicsDebugDrawer.get());
+    const auto interpolate = [alpha](auto pNode) {
+        auto& state = pNode->physicsInterpolationState;
+        if (state.bIsSettled) {
+            return;
+        }
 
-        // Character bodies must be drawn explicitly.
-        for (const auto& pCharacterBody : characterBodies) {
-            pPhysicsDebugDrawer->DrawCapsule(
-                pCharacterBody->pCharacterBody->GetCenterOfMassTransform(),
-                pCharacterBody->pCollisionShape->getHalfHeight(),
-                pCharacterBody->pCollisionShape->getRadius(),
-                JPH::Color::sGrey,
-                JPH::DebugRenderer::ECastShadow::Off,
-                JPH::DebugRenderer::EDrawMode::Solid);
+        pNode->setPhysicsSimulationResults(
+            glm::mix(state.previousLocation, state.currentLocation, alpha),
+            glm::degrees(glm::eulerAngles(glm::slerp(state.previousRotation, state.currentRotation, alpha))));
+
+        if (!pNode->pBody->IsActive() && state.previousLocation == state.currentLocation &&
+            state.previousRotation == state.currentRotation) {
+            // The body fell asleep and the node received the final transform.
+            state.bIsSettled = true;
         }
+    };
 
-        pPhysicsDebugDrawer->submitDrawData();
+    if (simulatedBodies.iAwakeCount == 0 && movingBodies.iAwakeCount == 0) {
+        DebugConsole::getStats().physicsWriteBackTimeMs = 0.0f;
+        return;
     }
+    const auto startTime = std::chrono::steady_clock::now();
 
-    {
-        PROFILE_SCOPE("collect debug stats")
+    // Meshes attached to bodies queue their new transforms and they are written to render data in bulk
+    // (render data of each world is locked once).
+    MeshRenderer::beginTransformBatch();
 
-        auto& stats = DebugConsole::getStats();
-        stats.iActiveCharacterBodyCount = characterBodies.size();
-        stats.iActiveSimulatedBodyCount = 0;
-        stats.iActiveMovingBodyCount = 0;
+    const auto interpolateAwakeNodes = [this, &interpolate](auto& nodes) {
+        // Iterate backwards since settled nodes are swapped with the last awake node.
+        for (size_t i = nodes.iAwakeCount; i > 0; i--) {
+            const auto pNode = nodes.vNodes[i - 1];
+            interpolate(pNode);
 
-        for (const auto& pNode : simulatedBodies) {
-            if (pNode->pBody->IsActive()) {
-                stats.iActiveSimulatedBodyCount += 1;
+            if (pNode->physicsInterpolationState.bIsSettled && !pNode->pBody->IsActive()) {
+                setBodyNodeAwake(nodes, i - 1, false);
             }
         }
+    };
+    interpolateAwakeNodes(simulatedBodies);
+    interpolateAwakeNodes(movingBodies);
 
-        for (const auto& pNode : movingBodies) {
-            if (pNode->pBody->IsActive()) {
-                stats.iActiveMovingBodyCount += 1;
-            }
+    MeshRenderer::endTransformBatch();
+
+    DebugConsole::getStats().physicsWriteBackTimeMs =
+        std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+template <typename T>
+void PhysicsManager::registerBodyNode(PartitionedBodyNodes<T>& nodes, T* pNode, BodyNodeType type) {
+    auto& slot = vBodyNodeSlots[pNode->pBody->GetID().GetIndex()];
+    if (slot.type != BodyNodeType::NONE) [[unlikely]] {
+        Error::showErrorAndThrowException(
+            std::format("node \"{}\" was already registered as a body node", pNode->getNodeName()));
+    }
+
+    slot.type = type;
+    slot.iIndex = nodes.vNodes.size();
+    nodes.vNodes.push_back(pNode);
+
+    // The body could be activated before the node was registered.
+    if (pNode->pBody->IsActive()) {
+        setBodyNodeAwake(nodes, slot.iIndex, true);
+    }
+}
+
+template <typename T> void PhysicsManager::unregisterBodyNode(PartitionedBodyNodes<T>& nodes, T* pNode) {
+    auto& slot = vBodyNodeSlots[pNode->pBody->GetID().GetIndex()];
+    if (slot.type == BodyNodeType::NONE || slot.iIndex >= nodes.vNodes.size() ||
+        nodes.vNodes[slot.iIndex] != pNode) [[unlikely]] {
+        Error::showErrorAndThrowException(
+            std::format("node \"{}\" was not registered as a body node", pNode->getNodeName()));
+    }
+
+    // Move to the end of the array.
+    setBodyNodeAwake(nodes, slot.iIndex, false);
+    swapBodyNodes(nodes, slot.iIndex, nodes.vNodes.size() - 1);
+
+    nodes.vNodes.pop_back();
+    slot = BodyNodeSlot{};
+}
+
+template <typename T>
+void PhysicsManager::setBodyNodeAwake(PartitionedBodyNodes<T>& nodes, size_t iIndex, bool bAwake) {
+    if (bAwake) {
+        if (iIndex < nodes.iAwakeCount) {
+            return;
+        }
+        swapBodyNodes(nodes, iIndex, nodes.iAwakeCount);
+        nodes.iAwakeCount += 1;
+    } else {
+        if (iIndex >= nodes.iAwakeCount) {
+            return;
         }
+        swapBodyNodes(nodes, iIndex, nodes.iAwakeCount - 1);
+        nodes.iAwakeCount -= 1;
+    }
+}
+
+template <typename T>
+void PhysicsManager::swapBodyNodes(PartitionedBodyNodes<T>& nodes, size_t iFirst, size_t iSecond) {
+    if (iFirst == iSecond) {
+        return;
+    }
+
+    std::swap(nodes.vNodes[iFirst], nodes.vNodes[iSecond]);
+    vBodyNodeSlots[nodes.vNodes[iFirst]->pBody->GetID().GetIndex()].iIndex = iFirst;
+    vBodyNodeSlots[nodes.vNodes[iSecond]->pBody->GetID().GetIndex()].iIndex = iSecond;
+}
+
+void PhysicsManager::applyPendingSensorFlags() {
+    // Bodies created after the update was started (possible with the async step since its results are
+    // applied on the next frame) are applied after the next update.
+    const auto iCount = std::min(iPendingSensorFlagCountBeforeStep, vPendingSensorFlags.size());
+    for (size_t i = 0; i < iCount; i++) {
+        vIsSensorBody[vPendingSensorFlags[i].first] = vPendingSensorFlags[i].second;
+    }
+    vPendingSensorFlags.erase(vPendingSensorFlags.begin(), vPendingSensorFlags.begin() + iCount);
+    iPendingSensorFlagCountBeforeStep = 0;
+}
+
+void PhysicsManager::onBodyActivated(const JPH::BodyID& bodyId) {
+    // Bodies of other nodes (and bodies of nodes that are not registered yet) are ignored.
+    const auto& slot = vBodyNodeSlots[bodyId.GetIndex()];
+    switch (slot.type) {
+    case BodyNodeType::SIMULATED: {
+        setBodyNodeAwake(simulatedBodies, slot.iIndex, true);
+        break;
+    }
+    case BodyNodeType::MOVING: {
+        setBodyNodeAwake(movingBodies, slot.iIndex, true);
+        break;
+    }
+    default: {
+        break;
+    }
     }
-#endif
 }
 
 JPH::Body* PhysicsManager::createBody(const JPH::BodyCreationSettings& settings) {
@@ -519,6 +913,15 @@ JPH::Body* PhysicsManager::createBody(const JPH::BodyCreationSettings& settings)
     }
     bodyIdToPtr[pCreatedBody->GetID()] = pCreatedBody;
 
+    // The previous body with this index could be a destroyed sensor with contacts that will be reported as
+    // removed during the next physics update so keep the flag until then.
+    const auto iBodyIndex = pCreatedBody->GetID().GetIndex();
+    if (vIsSensorBody[iBodyIndex]) {
+        vPendingSensorFlags.push_back({iBodyIndex, settings.mIsSensor});
+    } else {
+        vIsSensorBody[iBodyIndex] = settings.mIsSensor;
+    }
+
     return pCreatedBody;
 }
 
@@ -530,7 +933,100 @@ void PhysicsManager::destroyBody(const JPH::BodyID& bodyId) {
     }
     bodyIdToPtr.erase(it);
 
-    pPhysicsSystem->GetBodyInterface().DestroyBody(bodyId);
+    auto& bodyInterface = pPhysicsSystem->GetBodyInterface();
+
+    // Bodies that were not added yet are simply destroyed.
+    if (bodyBatch.bodiesToAdd.erase(bodyId) == 0 && bodyInterface.IsAdded(bodyId)) {
+        if (bodyBatch.iDepth > 0) {
+            // Will be removed and destroyed together with other bodies of the batch.
+            bodyBatch.vBodiesToRemove.push_back(bodyId);
+            return;
+        }
+        bodyInterface.RemoveBody(bodyId);
+    }
+
+    bodyInterface.DestroyBody(bodyId);
+}
+
+void PhysicsManager::addBody(const JPH::BodyID& bodyId, JPH::EActivation activation) {
+    if (bodyBatch.iDepth > 0) {
+        bodyBatch.bodiesToAdd[bodyId] = activation;
+        return;
+    }
+
+    pPhysicsSystem->GetBodyInterface().AddBody(bodyId, activation);
+}
+
+void PhysicsManager::beginBodyBatch() { bodyBatch.iDepth += 1; }
+
+void PhysicsManager::endBodyBatch() {
+    if (bodyBatch.iDepth == 0) [[unlikely]] {
+        Error::showErrorAndThrowException(
+            "unable to end a batch of body creation/destruction because there are no started batches");
+    }
+
+    bodyBatch.iDepth -= 1;
+    if (bodyBatch.iDepth == 0) {
+        flushBodyBatch();
+    }
+}
+
+void PhysicsManager::flushBodyBatch() {
+    waitForAsyncPhysicsStep();
+
+    if (bodyBatch.bodiesToAdd.empty() && bodyBatch.vBodiesToRemove.empty()) {
+        return;
+    }
+
+    PROFILE_FUNC
+
+    auto& bodyInterface = pPhysicsSystem->GetBodyInterface();
+    const auto iBatchSize = bodyBatch.bodiesToAdd.size() + bodyBatch.vBodiesToRemove.size();
+
+    if (!bodyBatch.vBodiesToRemove.empty()) {
+        PROFILE_SCOPE("remove bodies")
+
+        const auto iBodyCount = static_cast<int>(bodyBatch.vBodiesToRemove.size());
+        bodyInterface.RemoveBodies(bodyBatch.vBodiesToRemove.data(), iBodyCount);
+        bodyInterface.DestroyBodies(bodyBatch.vBodiesToRemove.data(), iBodyCount);
+
+        bodyBatch.vBodiesToRemove.clear();
+    }
+
+    if (!bodyBatch.bodiesToAdd.empty()) {
+        PROFILE_SCOPE("add bodies")
+
+        // Bodies are added in groups with the same activation mode.
+        std::vector<JPH::BodyID> vBodiesToActivate;
+        std::vector<JPH::BodyID> vBodiesToNotActivate;
+        for (const auto& [bodyId, activation] : bodyBatch.bodiesToAdd) {
+            if (activation == JPH::EActivation::Activate) {
+                vBodiesToActivate.push_back(bodyId);
+            } else {
+                vBodiesToNotActivate.push_back(bodyId);
+            }
+        }
+        bodyBatch.bodiesToAdd.clear();
+
+        const auto addBodies = [&bodyInterface](
+                                   std::vector<JPH::BodyID>& vBodyIds, JPH::EActivation activation) {
+            if (vBodyIds.empty()) {
+                return;
+            }
+            const auto iBodyCount = static_cast<int>(vBodyIds.size());
+
+            // Note: prepare can reorder body IDs.
+            const auto addState = bodyInterface.AddBodiesPrepare(vBodyIds.data(), iBodyCount);
+            bodyInterface.AddBodiesFinalize(vBodyIds.data(), iBodyCount, addState, activation);
+        };
+        addBodies(vBodiesToActivate, JPH::EActivation::Activate);
+        addBodies(vBodiesToNotActivate, JPH::EActivation::DontActivate);
+    }
+
+    if (iBatchSize >= MIN_BATCH_SIZE_TO_OPTIMIZE_BROAD_PHASE) {
+        PROFILE_SCOPE("optimize broad phase")
+        pPhysicsSystem->OptimizeBroadPhase();
+    }
 }
 
 #if defined(ENGINE_DEBUG_TOOLS)
@@ -540,13 +1036,15 @@ void PhysicsManager::setEnableDebugRendering(bool bEnable) { bEnableDebugRenderi
 void PhysicsManager::createBodyForNode(CollisionNode* pNode) {
     PROFILE_FUNC
 
+    waitForAsyncPhysicsStep();
+
     if (pNode->pShape == nullptr) [[unlikely]] {
         Error::showErrorAndThrowException(
             std::format("expected the node \"{}\" to have a valid shape setup", pNode->getNodeName()));
     }
 
     // Create shape.
-    const auto shapeResult = pNode->pShape->createShape();
+    const auto shapeResult = pCollisionShapeCache->getShape(*pNode->pShape);
     if (!shapeResult.IsValid()) [[unlikely]] {
         Error::showErrorAndThrowException(std::format(
             "failed to create a physics shape for the node \"{}\", error: {}",
@@ -578,7 +1076,7 @@ void PhysicsManager::createBodyForNode(CollisionNode* pNode) {
 
     if (pNode->isCollisionEnabled()) {
         // Add to physics world.
-        pPhysicsSystem->GetBodyInterface().AddBody(pCreatedBody->GetID(), JPH::EActivation::DontActivate);
+        addBody(pCreatedBody->GetID(), JPH::EActivation::DontActivate);
     }
 
     // Save created body.
@@ -588,6 +1086,8 @@ void PhysicsManager::createBodyForNode(CollisionNode* pNode) {
 void PhysicsManager::destroyBodyForNode(CollisionNode* pNode) {
     PROFILE_FUNC
 
+    waitForAsyncPhysicsStep();
+
     if (pNode->pBody == nullptr) [[unlikely]] {
         Error::showErrorAndThrowException(std::format(
             "the node \"{}\" requested its physics body to be destroyed but this node has no physics body",
@@ -600,13 +1100,8 @@ void PhysicsManager::destroyBodyForNode(CollisionNode* pNode) {
             pNode->getNodeName()));
     }
 
-    // Collision nodes can temporary disable collision (removed from physics world) thus do a check:
-    if (pPhysicsSystem->GetBodyInterface().IsAdded(pNode->pBody->GetID())) {
-        // Remove from physics world.
-        pPhysicsSystem->GetBodyInterface().RemoveBody(pNode->pBody->GetID());
-    }
-
-    // Destroy body.
+    // Remove from physics world (collision nodes can temporary disable collision thus it might be not
+    // added) and destroy body.
     destroyBody(pNode->pBody->GetID());
     pNode->pBody = nullptr;
 }
@@ -614,13 +1109,15 @@ void PhysicsManager::destroyBodyForNode(CollisionNode* pNode) {
 void PhysicsManager::createBodyForNode(TriggerVolumeNode* pNode) {
     PROFILE_FUNC
 
+    waitForAsyncPhysicsStep();
+
     if (pNode->pShape == nullptr) [[unlikely]] {
         Error::showErrorAndThrowException(
             std::format("expected the node \"{}\" to have a valid shape setup", pNode->getNodeName()));
     }
 
     // Create shape.
-    const auto shapeResult = pNode->pShape->createShape();
+    const auto shapeResult = pCollisionShapeCache->getShape(*pNode->pShape);
     if (!shapeResult.IsValid()) [[unlikely]] {
         Error::showErrorAndThrowException(std::format(
             "failed to create a physics shape for the node \"{}\", error: {}",
@@ -653,7 +1150,8 @@ void PhysicsManager::createBodyForNode(TriggerVolumeNode* pNode) {
 
     if (pNode->isTriggerEnabled()) {
         // Add to physics world.
-        pPhysicsSystem->GetBodyInterface().AddBody(pCreatedBody->GetID(), JPH::EActivation::Activate);
+        addBody(pCreatedBody->GetID(), JPH::EActivation::Activate);
+        activateBodiesInSensor(pCreatedBody);
     }
 
     // Save created body.
@@ -663,6 +1161,8 @@ void PhysicsManager::createBodyForNode(TriggerVolumeNode* pNode) {
 void PhysicsManager::destroyBodyForNode(TriggerVolumeNode* pNode) {
     PROFILE_FUNC
 
+    waitForAsyncPhysicsStep();
+
     if (pNode->pBody == nullptr) [[unlikely]] {
         Error::showErrorAndThrowException(std::format(
             "the node \"{}\" requested its physics body to be destroyed but this node has no physics body",
@@ -675,13 +1175,8 @@ void PhysicsManager::destroyBodyForNode(TriggerVolumeNode* pNode) {
             pNode->getNodeName()));
     }
 
-    // Trigger volume nodes can temporary disable collision (removed from physics world) thus do a check:
-    if (pPhysicsSystem->GetBodyInterface().IsAdded(pNode->pBody->GetID())) {
-        // Remove from physics world.
-        pPhysicsSystem->GetBodyInterface().RemoveBody(pNode->pBody->GetID());
-    }
-
-    // Destroy body.
+    // Remove from physics world (trigger volume nodes can temporary disable collision thus it might be
+    // not added) and destroy body.
     destroyBody(pNode->pBody->GetID());
     pNode->pBody = nullptr;
 }
@@ -689,19 +1184,28 @@ void PhysicsManager::destroyBodyForNode(TriggerVolumeNode* pNode) {
 void PhysicsManager::createBodyForNode(SimulatedBodyNode* pNode) {
     PROFILE_FUNC
 
+    waitForAsyncPhysicsStep();
+
     if (pNode->pShape == nullptr) [[unlikely]] {
         Error::showErrorAndThrowException(
             std::format("expected the node \"{}\" to have a valid shape setup", pNode->getNodeName()));
     }
 
     // Create shape.
-    const auto shapeResult = pNode->pShape->createShape(pNode->density);
+    const auto shapeResult = pCollisionShapeCache->getShape(*pNode->pShape, pNode->density);
     if (!shapeResult.IsValid()) [[unlikely]] {
         Error::showErrorAndThrowException(std::format(
             "failed to create a physics shape for the node \"{}\", error: {}",
             pNode->getNodeName(),
             shapeResult.GetError().data()));
     }
+    const auto shapeType = shapeResult.Get()->GetType();
+    if (shapeType == JPH::EShapeType::Mesh || shapeType == JPH::EShapeType::HeightField) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format(
+            "the node \"{}\" uses a triangle mesh or a height field shape which can only be used by static "
+            "bodies (such as collision nodes)",
+            pNode->getNodeName()));
+    }
 
     // Create body.
     JPH::BodyCreationSettings bodySettings(
@@ -733,21 +1237,21 @@ void PhysicsManager::createBodyForNode(SimulatedBodyNode* pNode) {
 
     // Add to physics world.
     // don't activate here if node is simulated to keep all editor-related logic in the node
-    pPhysicsSystem->GetBodyInterface().AddBody(pCreatedBody->GetID(), JPH::EActivation::DontActivate);
+    addBody(pCreatedBody->GetID(), JPH::EActivation::DontActivate);
 
     // Save created body.
     pNode->pBody = pCreatedBody;
+    pNode->physicsInterpolationState.reset(pNode->getWorldLocation(), pNode->getWorldRotation());
 
     // Register.
-    if (!simulatedBodies.insert(pNode).second) [[unlikely]] {
-        Error::showErrorAndThrowException(
-            std::format("node \"{}\" was already registered as a simulated body", pNode->getNodeName()));
-    }
+    registerBodyNode(simulatedBodies, pNode, BodyNodeType::SIMULATED);
 }
 
 void PhysicsManager::destroyBodyForNode(SimulatedBodyNode* pNode) {
     PROFILE_FUNC
 
+    waitForAsyncPhysicsStep();
+
     if (pNode->pBody == nullptr) [[unlikely]] {
         Error::showErrorAndThrowException(std::format(
             "the node \"{}\" requested its physics body to be destroyed but this node has no physics body",
@@ -760,32 +1264,26 @@ void PhysicsManager::destroyBodyForNode(SimulatedBodyNode* pNode) {
             pNode->getNodeName()));
     }
 
-    // Remove from physics world.
-    pPhysicsSystem->GetBodyInterface().RemoveBody(pNode->pBody->GetID());
+    // Unregister.
+    unregisterBodyNode(simulatedBodies, pNode);
 
-    // Destroy body.
+    // Remove from physics world and destroy body.
     destroyBody(pNode->pBody->GetID());
     pNode->pBody = nullptr;
-
-    // Unregister.
-    const auto it = simulatedBodies.find(pNode);
-    if (it == simulatedBodies.end()) [[unlikely]] {
-        Error::showErrorAndThrowException(
-            std::format("node \"{}\" was not registered as a simulated body", pNode->getNodeName()));
-    }
-    simulatedBodies.erase(it);
 }
 
 void PhysicsManager::createBodyForNode(MovingBodyNode* pNode) {
     PROFILE_FUNC
 
+    waitForAsyncPhysicsStep();
+
     if (pNode->pShape == nullptr) [[unlikely]] {
         Error::showErrorAndThrowException(
             std::format("expected the node \"{}\" to have a valid shape setup", pNode->getNodeName()));
     }
 
     // Create shape.
-    const auto shapeResult = pNode->pShape->createShape();
+    const auto shapeResult = pCollisionShapeCache->getShape(*pNode->pShape);
     if (!shapeResult.IsValid()) [[unlikely]] {
         Error::showErrorAndThrowException(std::format(
             "failed to create a physics shape for the node \"{}\", error: {}",
@@ -816,21 +1314,21 @@ void PhysicsManager::createBodyForNode(MovingBodyNode* pNode) {
     }
 
     // Add to physics world.
-    pPhysicsSystem->GetBodyInterface().AddBody(pCreatedBody->GetID(), JPH::EActivation::Activate);
+    addBody(pCreatedBody->GetID(), JPH::EActivation::Activate);
 
     // Save created body.
     pNode->pBody = pCreatedBody;
+    pNode->physicsInterpolationState.reset(pNode->getWorldLocation(), pNode->getWorldRotation());
 
     // Register.
-    if (!movingBodies.insert(pNode).second) [[unlikely]] {
-        Error::showErrorAndThrowException(
-            std::format("node \"{}\" was already registered as a moving body", pNode->getNodeName()));
-    }
+    registerBodyNode(movingBodies, pNode, BodyNodeType::MOVING);
 }
 
 void PhysicsManager::destroyBodyForNode(MovingBodyNode* pNode) {
     PROFILE_FUNC
 
+    waitForAsyncPhysicsStep();
+
     if (pNode->pBody == nullptr) [[unlikely]] {
         Error::showErrorAndThrowException(std::format(
             "the node \"{}\" requested its physics body to be destroyed but this node has no physics body",
@@ -843,25 +1341,19 @@ void PhysicsManager::destroyBodyForNode(MovingBodyNode* pNode) {
             pNode->getNodeName()));
     }
 
-    // Remove from physics world.
-    pPhysicsSystem->GetBodyInterface().RemoveBody(pNode->pBody->GetID());
+    // Unregister.
+    unregisterBodyNode(movingBodies, pNode);
 
-    // Destroy body.
+    // Remove from physics world and destroy body.
     destroyBody(pNode->pBody->GetID());
     pNode->pBody = nullptr;
-
-    // Unregister.
-    const auto it = movingBodies.find(pNode);
-    if (it == movingBodies.end()) [[unlikely]] {
-        Error::showErrorAndThrowException(
-            std::format("node \"{}\" was not registered as a moving body", pNode->getNodeName()));
-    }
-    movingBodies.erase(it);
 }
 
 void PhysicsManager::createBodyForNode(CompoundCollisionNode* pNode) {
     PROFILE_FUNC
 
+    waitForAsyncPhysicsStep();
+
     const auto mtxChildNodes = pNode->getChildNodes();
     std::scoped_lock guard(*mtxChildNodes.first);
 
@@ -893,7 +1385,7 @@ void PhysicsManager::createBodyForNode(CompoundCollisionNode* pNode) {
         }
 
         // Create shape.
-        const auto shapeResult = pCollisionNode->pShape->createShape();
+        const auto shapeResult = pCollisionShapeCache->getShape(*pCollisionNode->pShape);
         if (!shapeResult.IsValid()) [[unlikely]] {
             Error::showErrorAndThrowException(std::format(
                 "failed to create a physics shape for the node \"{}\" which is child node of a compound node "
@@ -947,7 +1439,7 @@ void PhysicsManager::createBodyForNode(CompoundCollisionNode* pNode) {
     }
 
     // Add to physics world.
-    pPhysicsSystem->GetBodyInterface().AddBody(pCreatedBody->GetID(), JPH::EActivation::DontActivate);
+    addBody(pCreatedBody->GetID(), JPH::EActivation::DontActivate);
 
     // Save created body.
     pNode->pBody = pCreatedBody;
@@ -956,6 +1448,8 @@ void PhysicsManager::createBodyForNode(CompoundCollisionNode* pNode) {
 void PhysicsManager::destroyBodyForNode(CompoundCollisionNode* pNode) {
     PROFILE_FUNC
 
+    waitForAsyncPhysicsStep();
+
     if (pNode->pBody == nullptr) [[unlikely]] {
         Error::showErrorAndThrowException(std::format(
             "the node \"{}\" requested its physics body to be destroyed but this node has no physics body",
@@ -968,10 +1462,7 @@ void PhysicsManager::destroyBodyForNode(CompoundCollisionNode* pNode) {
             pNode->getNodeName()));
     }
 
-    // Remove from physics world.
-    pPhysicsSystem->GetBodyInterface().RemoveBody(pNode->pBody->GetID());
-
-    // Destroy body.
+    // Remove from physics world and destroy body.
     destroyBody(pNode->pBody->GetID());
     pNode->pBody = nullptr;
 }
@@ -979,6 +1470,8 @@ void PhysicsManager::destroyBodyForNode(CompoundCollisionNode* pNode) {
 void PhysicsManager::createBodyForNode(CharacterBodyNode* pNode) {
     PROFILE_FUNC
 
+    waitForAsyncPhysicsStep();
+
     // Prepare settings.
     JPH::Ref<JPH::CharacterVirtualSettings> settings = new JPH::CharacterVirtualSettings();
     settings->mMaxSlopeAngle = glm::radians(pNode->getMaxWalkSlopeAngle());
@@ -1003,7 +1496,6 @@ void PhysicsManager::createBodyForNode(CharacterBodyNode* pNode) {
         *pNode->getNodeId(),
         pPhysicsSystem.get());
 
-    pNode->pCharacterBody->SetCharacterVsCharacterCollision(pCharVsCharCollision.get());
     if (pNode->pContactListener == nullptr) [[unlikely]] {
         Error::showErrorAndThrowException(std::format(
             "expected the contact listener on the node \"{}\" to be valid", pNode->getNodeName()));
@@ -1011,19 +1503,23 @@ void PhysicsManager::createBodyForNode(CharacterBodyNode* pNode) {
     pNode->pCharacterBody->SetListener(pNode->pContactListener.get());
 
     // Register.
-    if (!characterBodies.insert(pNode).second) [[unlikely]] {
+    if (std::find(characterBodies.begin(), characterBodies.end(), pNode) != characterBodies.end())
+        [[unlikely]] {
         Error::showErrorAndThrowException(
             std::format("node \"{}\" was already registered as a character body", pNode->getNodeName()));
     }
+    characterBodies.push_back(pNode);
 }
 
 void PhysicsManager::destroyBodyForNode(CharacterBodyNode* pNode) {
     PROFILE_FUNC
 
+    waitForAsyncPhysicsStep();
+
     pNode->pCharacterBody = nullptr;
 
     // Unregister.
-    const auto it = characterBodies.find(pNode);
+    const auto it = std::find(characterBodies.begin(), characterBodies.end(), pNode);
     if (it == characterBodies.end()) [[unlikely]] {
         Error::showErrorAndThrowException(
             std::format("node \"{}\" was not registered as a character body", pNode->getNodeName()));
@@ -1037,6 +1533,8 @@ std::optional<PhysicsManager::RayCastHit> PhysicsManager::castRayUntilHit(
     const std::vector<JPH::BodyID>& vIgnoredBodies) {
     PROFILE_FUNC
 
+    flushBodyBatch();
+
     const auto rayDirectionAndLength = rayEndPosition - rayStartPosition;
 
     // Prepare filters.
@@ -1084,6 +1582,8 @@ std::vector<PhysicsManager::RayCastHit> PhysicsManager::castRayHitMultipleSort(
     const std::vector<JPH::BodyID>& vIgnoredBodies) {
     PROFILE_FUNC
 
+    flushBodyBatch();
+
     const auto rayDirectionAndLength = rayEndPosition - rayStartPosition;
 
     // Prepare filters.
@@ -1139,25 +1639,394 @@ std::vector<PhysicsManager::RayCastHit> PhysicsManager::castRayHitMultipleSort(
     return vHits;
 }
 
+void PhysicsManager::castRaysUntilHit(
+    std::span<const CastQuery> vQueries,
+    std::span<std::optional<RayCastHit>> vHits,
+    std::span<const JPH::BodyID> vIgnoredBodies) {
+    PROFILE_FUNC
+
+    if (vHits.size() < vQueries.size()) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format(
+            "hit buffer has {} elements but received {} queries", vHits.size(), vQueries.size()));
+    }
+
+    flushBodyBatch();
+
+    // Prepare filters (shared by all rays).
+    const JPH::DefaultBroadPhaseLayerFilter broadPhaseLayerFilter =
+        pPhysicsSystem->GetDefaultBroadPhaseLayerFilter(static_cast<JPH::ObjectLayer>(ObjectLayer::MOVING));
+    const JPH::DefaultObjectLayerFilter objectLayerFilter =
+        pPhysicsSystem->GetDefaultLayerFilter(static_cast<JPH::ObjectLayer>(ObjectLayer::MOVING));
+    const IgnoredBodiesFilter bodyFilter(vIgnoredBodies);
+
+    // The physics world is not modified while queries are running so no need to lock bodies.
+    const auto& narrowPhaseQuery = pPhysicsSystem->GetNarrowPhaseQueryNoLock();
+    const auto& bodyLockInterface = pPhysicsSystem->GetBodyLockInterfaceNoLock();
+
+    const auto iJobCount = getParallelJobCount(vQueries.size(), MIN_QUERIES_PER_JOB);
+    runParallelJobs(vQueries.size(), iJobCount, [&](size_t iJobIndex, size_t iStart, size_t iEnd) {
+        PROFILE_SCOPE("cast rays")
+
+        for (size_t i = iStart; i < iEnd; i++) {
+            const auto& query = vQueries[i];
+            const auto rayDirectionAndLength = query.endPosition - query.startPosition;
+
+            JPH::RRayCast ray(
+                convertPosDirToJolt(query.startPosition), convertPosDirToJolt(rayDirectionAndLength));
+            JPH::RayCastResult result{};
+            if (!narrowPhaseQuery.CastRay(
+                    ray, result, broadPhaseLayerFilter, objectLayerFilter, bodyFilter)) {
+                vHits[i] = {};
+                continue;
+            }
+
+            const auto pHitBody = bodyLockInterface.TryGetBody(result.mBodyID);
+            if (pHitBody == nullptr) [[unlikely]] {
+                vHits[i] = {};
+                continue;
+            }
+
+            vHits[i] = RayCastHit{
+                .bodyId = result.mBodyID,
+                .hitPosition = query.startPosition + rayDirectionAndLength * result.mFraction,
+                .hitNormal = convertPosDirFromJolt(pHitBody->GetWorldSpaceSurfaceNormal(
+                    result.mSubShapeID2, ray.GetPointOnRay(result.mFraction)))};
+        }
+    });
+}
+
+void PhysicsManager::castSpheresUntilHit(
+    std::span<const CastQuery> vQueries,
+    float sphereRadius,
+    std::span<std::optional<RayCastHit>> vHits,
+    std::span<const JPH::BodyID> vIgnoredBodies) {
+    PROFILE_FUNC
+
+    if (vHits.size() < vQueries.size()) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format(
+            "hit buffer has {} elements but received {} queries", vHits.size(), vQueries.size()));
+    }
+    if (sphereRadius <= 0.0f) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format("invalid sphere radius {}", sphereRadius));
+    }
+
+    flushBodyBatch();
+
+    // Prepare filters (shared by all spheres).
+    const JPH::DefaultBroadPhaseLayerFilter broadPhaseLayerFilter =
+        pPhysicsSystem->GetDefaultBroadPhaseLayerFilter(static_cast<JPH::ObjectLayer>(ObjectLayer::MOVING));
+    const JPH::DefaultObjectLayerFilter objectLayerFilter =
+        pPhysicsSystem->GetDefaultLayerFilter(static_cast<JPH::ObjectLayer>(ObjectLayer::MOVING));
+    const IgnoredBodiesFilter bodyFilter(vIgnoredBodies);
+
+    // Shape is shared by all casts and lives on the stack so it's not reference counted.
+    JPH::SphereShape sphereShape(sphereRadius);
+    sphereShape.SetEmbedded();
+
+    const JPH::ShapeCastSettings settings;
+
+    // The physics world is not modified while queries are running so no need to lock bodies.
+    const auto& narrowPhaseQuery = pPhysicsSystem->GetNarrowPhaseQueryNoLock();
+
+    const auto iJobCount = getParallelJobCount(vQueries.size(), MIN_QUERIES_PER_JOB);
+    runParallelJobs(vQueries.size(), iJobCount, [&](size_t iJobIndex, size_t iStart, size_t iEnd) {
+        PROFILE_SCOPE("cast spheres")
+
+        for (size_t i = iStart; i < iEnd; i++) {
+            const auto& query = vQueries[i];
+
+            const JPH::RShapeCast shapeCast(
+                &sphereShape,
+                JPH::Vec3::sReplicate(1.0f),
+                JPH::RMat44::sTranslation(convertPosDirToJolt(query.startPosition)),
+                convertPosDirToJolt(query.endPosition - query.startPosition));
+            JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> collector;
+            narrowPhaseQuery.CastShape(
+                shapeCast,
+                settings,
+                JPH::RVec3::sZero(),
+                collector,
+                broadPhaseLayerFilter,
+                objectLayerFilter,
+                bodyFilter);
+            if (!collector.HadHit()) {
+                vHits[i] = {};
+                continue;
+            }
+
+            vHits[i] = RayCastHit{
+                .bodyId = collector.mHit.mBodyID2,
+                .hitPosition = convertPosDirFromJolt(collector.mHit.mContactPointOn2),
+                .hitNormal = convertPosDirFromJolt(
+                    -collector.mHit.mPenetrationAxis.NormalizedOr(JPH::Vec3::sZero()))};
+        }
+    });
+}
+
+size_t PhysicsManager::getParallelJobCount(size_t iItemCount, size_t iMinItemsPerJob) const {
+    return std::max(
+        std::min(
+            (iItemCount + iMinItemsPerJob - 1) / iMinItemsPerJob,
+            static_cast<size_t>(pJobSystem->GetMaxConcurrency())),
+        static_cast<size_t>(1));
+}
+
+void PhysicsManager::runParallelJobs(
+    size_t iItemCount, size_t iJobCount, const std::function<void(size_t, size_t, size_t)>& processRange) {
+    if (iJobCount <= 1) {
+        processRange(0, 0, iItemCount);
+        return;
+    }
+
+    JPH::JobSystem::Barrier* pBarrier = pJobSystem->CreateBarrier();
+    if (pBarrier == nullptr) [[unlikely]] {
+        // All barriers are used.
+        processRange(0, 0, iItemCount);
+        return;
+    }
+
+    const auto iItemsPerJob = (iItemCount + iJobCount - 1) / iJobCount;
+    for (size_t iJobIndex = 0; iJobIndex * iItemsPerJob < iItemCount; iJobIndex++) {
+        const auto iStart = iJobIndex * iItemsPerJob;
+        const auto iEnd = std::min(iStart + iItemsPerJob, iItemCount);
+        pBarrier->AddJob(pJobSystem->CreateJob(
+            "physics job", JPH::Color::sGreen, [&processRange, iJobIndex, iStart, iEnd]() {
+                processRange(iJobIndex, iStart, iEnd);
+            }));
+    }
+
+    // The calling thread also processes jobs while waiting.
+    pJobSystem->WaitForJobs(pBarrier);
+    pJobSystem->DestroyBarrier(pBarrier);
+}
+
+void PhysicsManager::groupOverlappingSpheres(
+    const std::vector<glm::vec4>& vSpheres,
+    std::vector<size_t>& vGroupParents,
+    std::vector<size_t>& vSweepOrder) {
+    PROFILE_FUNC
+
+    const auto iSphereCount = vSpheres.size();
+
+    // Union-find where each sphere starts in its own group.
+    vGroupParents.resize(iSphereCount);
+    for (size_t i = 0; i < iSphereCount; i++) {
+        vGroupParents[i] = i;
+    }
+    const auto findRoot = [&vGroupParents](size_t i) {
+        while (vGroupParents[i] != i) {
+            vGroupParents[i] = vGroupParents[vGroupParents[i]];
+            i = vGroupParents[i];
+        }
+        return i;
+    };
+
+    // Sort by the minimum X so that each sphere is only checked against spheres that start before it ends.
+    vSweepOrder.resize(iSphereCount);
+    for (size_t i = 0; i < iSphereCount; i++) {
+        vSweepOrder[i] = i;
+    }
+    std::sort(vSweepOrder.begin(), vSweepOrder.end(), [&vSpheres](size_t iFirst, size_t iSecond) {
+        return vSpheres[iFirst].x - vSpheres[iFirst].w < vSpheres[iSecond].x - vSpheres[iSecond].w;
+    });
+
+    for (size_t iSweepIndex = 0; iSweepIndex < iSphereCount; iSweepIndex++) {
+        const auto i = vSweepOrder[iSweepIndex];
+        const auto& first = vSpheres[i];
+        const auto maxX = first.x + first.w;
+
+        for (size_t iOtherIndex = iSweepIndex + 1; iOtherIndex < iSphereCount; iOtherIndex++) {
+            const auto j = vSweepOrder[iOtherIndex];
+            const auto& second = vSpheres[j];
+            if (second.x - second.w > maxX) {
+                // This and all next spheres start after the current one ends.
+                break;
+            }
+
+            const auto maxDistance = first.w + second.w;
+            const auto toSecond = glm::vec3(second) - glm::vec3(first);
+            if (glm::dot(toSecond, toSecond) > maxDistance * maxDistance) {
+                continue;
+            }
+
+            // Smaller index becomes the root so that groups don't depend on the order of checks.
+            const auto iFirstRoot = findRoot(i);
+            const auto iSecondRoot = findRoot(j);
+            if (iFirstRoot < iSecondRoot) {
+                vGroupParents[iSecondRoot] = iFirstRoot;
+            } else if (iSecondRoot < iFirstRoot) {
+                vGroupParents[iFirstRoot] = iSecondRoot;
+            }
+        }
+    }
+    for (size_t i = 0; i < iSphereCount; i++) {
+        vGroupParents[i] = findRoot(i);
+    }
+}
+
+void PhysicsManager::updateCharacterPositions(float deltaTime) {
+    PROFILE_FUNC
+
+    if (characterBodies.empty()) {
+        return;
+    }
+
+    auto& data = characterUpdateData;
+    const auto iCharacterCount = characterBodies.size();
+
+    // Calculate areas that characters can reach during this update.
+    const auto gravity = pPhysicsSystem->GetGravity().Length();
+    data.vReachSpheres.resize(iCharacterCount);
+    for (size_t i = 0; i < iCharacterCount; i++) {
+        const auto pNode = characterBodies[i];
+        const auto& shape = *pNode->pCollisionShape;
+        const auto speed = pNode->pCharacterBody->GetLinearVelocity().Length();
+        const auto halfTotalHeight = shape.getHalfHeight() + shape.getRadius();
+        const auto reach = halfTotalHeight + pNode->maxStepHeight +
+                           (speed + gravity * deltaTime) * deltaTime + CHARACTER_REACH_MARGIN;
+
+        // The shape is adjusted so that the character's position is at its bottom.
+        const auto center = convertPosDirFromJolt(pNode->pCharacterBody->GetPosition()) +
+                            glm::vec3(Globals::WorldDirection::up) * halfTotalHeight;
+        data.vReachSpheres[i] = glm::vec4(center, reach);
+    }
+
+    // Group characters that can touch each other (directly or through inner bodies) so that they are
+    // updated one after another, characters of different groups can be updated at the same time.
+    groupOverlappingSpheres(data.vReachSpheres, data.vGroupParents, data.vSweepOrder);
+
+    // Sort by groups (characters of a group keep the order of registration).
+    data.vSortedCharacters.resize(iCharacterCount);
+    for (size_t i = 0; i < iCharacterCount; i++) {
+        data.vSortedCharacters[i] = i;
+    }
+    std::stable_sort(
+        data.vSortedCharacters.begin(), data.vSortedCharacters.end(), [&data](size_t iFirst, size_t iSecond) {
+            return data.vGroupParents[iFirst] < data.vGroupParents[iSecond];
+        });
+    data.vGroupStarts.clear();
+    for (size_t i = 0; i < iCharacterCount; i++) {
+        if (i == 0 || data.vGroupParents[data.vSortedCharacters[i]] !=
+                          data.vGroupParents[data.vSortedCharacters[i - 1]]) {
+            data.vGroupStarts.push_back(i);
+        }
+    }
+    const auto iGroupCount = data.vGroupStarts.size();
+    data.vGroupStarts.push_back(iCharacterCount);
+
+    // Each job needs a separate temp allocator and character vs character collision.
+    const auto iJobCount = getParallelJobCount(iGroupCount, MIN_CHARACTER_GROUPS_PER_JOB);
+    if (iJobCount > 1) {
+        while (data.vTempAllocators.size() < iJobCount) {
+            data.vTempAllocators.push_back(
+                std::make_unique<JPH::TempAllocatorImpl>(CHARACTER_JOB_TEMP_ALLOCATOR_SIZE));
+        }
+    }
+    while (data.vCharVsCharCollisions.size() < iJobCount) {
+        data.vCharVsCharCollisions.push_back(std::make_unique<JPH::CharacterVsCharacterCollisionSimple>());
+    }
+
+    // Update Jolt characters.
+    runParallelJobs(iGroupCount, iJobCount, [&](size_t iJobIndex, size_t iStart, size_t iEnd) {
+        PROFILE_SCOPE("update characters")
+
+        JPH::TempAllocator& tempAllocator =
+            iJobCount > 1 ? *data.vTempAllocators[iJobIndex] : *pTempAllocator;
+        auto& charVsCharCollision = *data.vCharVsCharCollisions[iJobIndex];
+
+        for (size_t iGroup = iStart; iGroup < iEnd; iGroup++) {
+            const auto iGroupStart = data.vGroupStarts[iGroup];
+            const auto iGroupEnd = data.vGroupStarts[iGroup + 1];
+
+            // Characters only collide with characters of their group (other groups are out of reach).
+            for (size_t i = iGroupStart; i < iGroupEnd; i++) {
+                const auto pCharacter = characterBodies[data.vSortedCharacters[i]]->pCharacterBody.GetPtr();
+                pCharacter->SetCharacterVsCharacterCollision(&charVsCharCollision);
+                charVsCharCollision.Add(pCharacter);
+            }
+
+            for (size_t i = iGroupStart; i < iGroupEnd; i++) {
+                characterBodies[data.vSortedCharacters[i]]->updateCharacterPosition(
+                    *pPhysicsSystem, tempAllocator, deltaTime);
+            }
+
+            // Don't keep pointers to characters that can be destroyed before the next update.
+            charVsCharCollision.mCharacters.clear();
+        }
+    });
+
+    // Apply results to nodes on this thread in a fixed order.
+    for (const auto& pCharacterBody : characterBodies) {
+        pCharacterBody->applyCharacterPosition();
+    }
+}
+
 void PhysicsManager::addRemoveBody(JPH::Body* pBody, bool bAdd, bool bActivate) {
+    waitForAsyncPhysicsStep();
+
     if (bAdd) {
-        pPhysicsSystem->GetBodyInterface().AddBody(
-            pBody->GetID(), bActivate ? JPH::EActivation::Activate : JPH::EActivation::DontActivate);
-    } else {
-        pPhysicsSystem->GetBodyInterface().RemoveBody(pBody->GetID());
+        addBody(pBody->GetID(), bActivate ? JPH::EActivation::Activate : JPH::EActivation::DontActivate);
+        if (pBody->IsSensor()) {
+            activateBodiesInSensor(pBody);
+        }
+        return;
+    }
+
+    if (bodyBatch.bodiesToAdd.erase(pBody->GetID()) > 0) {
+        // Was not added yet.
+        return;
     }
+    pPhysicsSystem->GetBodyInterface().RemoveBody(pBody->GetID());
+}
+
+void PhysicsManager::setMaxPhysicsTicksPerFrame(unsigned int iMaxTicks) {
+    iMaxPhysicsTicksPerFrame = std::max(iMaxTicks, 1U);
 }
 
 void PhysicsManager::setBodyLocationRotation(
     JPH::Body* pBody, const glm::vec3& location, const glm::vec3& rotation) {
+    waitForAsyncPhysicsStep();
+
     pPhysicsSystem->GetBodyInterface().SetPositionAndRotation(
         pBody->GetID(),
         convertPosDirToJolt(location),
         convertRotationToJolt(rotation),
         JPH::EActivation::DontActivate);
+
+    if (pBody->IsSensor()) {
+        activateBodiesInSensor(pBody);
+    }
+}
+
+void PhysicsManager::activateBodiesInSensor(JPH::Body* pSensorBody) {
+    PROFILE_FUNC
+
+    const auto objectLayer = pSensorBody->GetObjectLayer();
+    pPhysicsSystem->GetBodyInterface().ActivateBodiesInAABox(
+        pSensorBody->GetWorldSpaceBounds(),
+        pPhysicsSystem->GetDefaultBroadPhaseLayerFilter(objectLayer),
+        pPhysicsSystem->GetDefaultLayerFilter(objectLayer));
+}
+
+void PhysicsManager::setCharacterLocationRotation(
+    CharacterBodyNode* pNode, const glm::vec3& location, const glm::vec3& rotation) {
+    // The character's inner body is a body in the physics system.
+    waitForAsyncPhysicsStep();
+
+    pNode->pCharacterBody->SetPosition(convertPosDirToJolt(location));
+    pNode->pCharacterBody->SetRotation(convertRotationToJolt(rotation));
 }
 
 void PhysicsManager::setBodyActiveState(JPH::Body* pBody, bool bActivate) {
+    waitForAsyncPhysicsStep();
+
+    const auto batchIt = bodyBatch.bodiesToAdd.find(pBody->GetID());
+    if (batchIt != bodyBatch.bodiesToAdd.end()) {
+        // Will be activated when added.
+        batchIt->second = bActivate ? JPH::EActivation::Activate : JPH::EActivation::DontActivate;
+        return;
+    }
+
     if (bActivate) {
         pPhysicsSystem->GetBodyInterface().ActivateBody(pBody->GetID());
     } else {
@@ -1166,55 +2035,89 @@ void PhysicsManager::setBodyActiveState(JPH::Body* pBody, bool bActivate) {
 }
 
 void PhysicsManager::addImpulseToBody(JPH::Body* pBody, const glm::vec3& impulse) {
+    flushBodyBatch();
+
     pPhysicsSystem->GetBodyInterface().AddImpulse(pBody->GetID(), convertPosDirToJolt(impulse));
 }
 
 void PhysicsManager::addAngularImpulseToBody(JPH::Body* pBody, const glm::vec3& impulse) {
+    flushBodyBatch();
+
     pPhysicsSystem->GetBodyInterface().AddAngularImpulse(pBody->GetID(), convertPosDirToJolt(impulse));
 }
 
 void PhysicsManager::addForce(JPH::Body* pBody, const glm::vec3& force) {
+    flushBodyBatch();
+
     pPhysicsSystem->GetBodyInterface().AddForce(pBody->GetID(), convertPosDirToJolt(force));
 }
 
 void PhysicsManager::moveKinematic(
     JPH::Body* pBody, const glm::vec3& worldLocation, const glm::vec3& worldRotation, float deltaTime) {
+    flushBodyBatch();
+
     pPhysicsSystem->GetBodyInterface().MoveKinematic(
         pBody->GetID(), convertPosDirToJolt(worldLocation), convertRotationToJolt(worldRotation), deltaTime);
 }
 
 void PhysicsManager::setLinearVelocity(JPH::Body* pBody, const glm::vec3& velocity) {
+    flushBodyBatch();
+
     pPhysicsSystem->GetBodyInterface().SetLinearVelocity(pBody->GetID(), convertPosDirToJolt(velocity));
 }
 
 void PhysicsManager::setAngularVelocity(JPH::Body* pBody, const glm::vec3& velocity) {
+    flushBodyBatch();
+
     pPhysicsSystem->GetBodyInterface().SetAngularVelocity(pBody->GetID(), convertPosDirToJolt(velocity));
 }
 
 bool PhysicsManager::isBodySensor(JPH::BodyID bodyId) {
+    waitForAsyncPhysicsStep();
+
     return pPhysicsSystem->GetBodyInterface().IsSensor(bodyId);
 }
 
 glm::vec3 PhysicsManager::getLinearVelocity(JPH::Body* pBody) {
+    flushBodyBatch();
+
     return convertPosDirFromJolt(pPhysicsSystem->GetBodyInterface().GetLinearVelocity(pBody->GetID()));
 }
 
 glm::vec3 PhysicsManager::getAngularVelocity(JPH::Body* pBody) {
+    flushBodyBatch();
+
     return convertPosDirFromJolt(pPhysicsSystem->GetBodyInterface().GetAngularVelocity(pBody->GetID()));
 }
 
 uint64_t PhysicsManager::getUserDataFromBody(JPH::BodyID bodyId) {
+    waitForAsyncPhysicsStep();
+
     return pPhysicsSystem->GetBodyInterface().GetUserData(bodyId);
 }
 
 void PhysicsManager::optimizeBroadPhase() {
     PROFILE_FUNC
 
+    flushBodyBatch();
+
     pPhysicsSystem->OptimizeBroadPhase();
 }
 
-glm::vec3 PhysicsManager::getGravity() { return convertPosDirFromJolt(pPhysicsSystem->GetGravity()); }
+glm::vec3 PhysicsManager::getGravity() {
+    waitForAsyncPhysicsStep();
 
-JPH::PhysicsSystem& PhysicsManager::getPhysicsSystem() { return *pPhysicsSystem; }
+    return convertPosDirFromJolt(pPhysicsSystem->GetGravity());
+}
+
+JPH::PhysicsSystem& PhysicsManager::getPhysicsSystem() {
+    flushBodyBatch();
+
+    return *pPhysicsSystem;
+}
+
+JPH::TempAllocator& PhysicsManager::getTempAllocator() {
+    waitForAsyncPhysicsStep();
 
-JPH::TempAllocator& PhysicsManager::getTempAllocator() { return *pTempAllocator; }
+    return *pTempAllocator;
+}
@@ -3,20 +3,24 @@
 // Standard.
 #include <memory>
 #include <mutex>
-#include <unordered_set>
 #include <vector>
 #include <optional>
 #include <unordered_map>
-#include <queue>
+#include <atomic>
+#include <future>
+#include <span>
+#include <functional>
 
 // Custom.
 #include "math/GLMath.hpp"
+#include "misc/MpscRingBuffer.hpp"
 
 // External.
 #include "Jolt/Jolt.h" // Always include Jolt.h before including any other Jolt header.
 #include "Jolt/Physics/Body/BodyID.h"
 #include "Jolt/Physics/Collision/Shape/SubShapeIDPair.h"
 #include "Jolt/Physics/Body/BodyCreationSettings.h"
+#include "Jolt/Physics/EActivation.h"
 
 namespace JPH {
     class PhysicsSystem;
@@ -38,9 +42,12 @@ class CharacterBodyNode;
 class CapsuleCollisionShape;
 class TriggerVolumeNode;
 class ContactListener;
+class BodyActivationListener;
 class GameManager;
 class TriggerVolumeNode;
 class Node;
+class PhysicsStepThread;
+class CollisionShapeCache;
 
 #if defined(ENGINE_DEBUG_TOOLS)
 class PhysicsDebugDrawer;
@@ -51,9 +58,12 @@ class PhysicsManager {
     // Only game manager is expected to create physics manager.
     friend class GameManager;
 
-    // Adds contacts events to the queue.
+    // Adds contacts events to the event buffers.
     friend class ContactListener;
 
+    // Moves nodes of activated bodies to awake nodes.
+    friend class BodyActivationListener;
+
 public:
     /** Hit result of a ray cast. */
     struct RayCastHit {
@@ -67,11 +77,91 @@ public:
         glm::vec3 hitNormal;
     };
 
+    /** Single query of a batched cast (see @ref castRaysUntilHit). */
+    struct CastQuery {
+        /** Position where the cast starts. */
+        glm::vec3 startPosition;
+
+        /** Position where the cast ends. */
+        glm::vec3 endPosition;
+    };
+
+    /** Time (in seconds) that one physics tick simulates, physics runs with a fixed tick rate. */
+    static constexpr float physicsTickTimeSec = 1.0f / 60.0f;
+
+    /**
+     * Groups spheres that overlap each other (directly or through other spheres) using sort and sweep
+     * along the X axis (used to find characters that can touch each other during an update).
+     *
+     * @param vSpheres      Spheres (center and radius).
+     * @param vGroupParents Resized to the sphere count, after the call stores the group of each sphere
+     * (the smallest sphere index of the group) so groups don't depend on the order of spheres in space.
+     * @param vSweepOrder   Scratch array of sphere indices (reused to avoid allocations).
+     */
+    static void groupOverlappingSpheres(
+        const std::vector<glm::vec4>& vSpheres,
+        std::vector<size_t>& vGroupParents,
+        std::vector<size_t>& vSweepOrder);
+
     ~PhysicsManager();
 
     PhysicsManager(const PhysicsManager&) = delete;
     PhysicsManager& operator=(const PhysicsManager) = delete;
 
+    /**
+     * Sets the maximum number of physics ticks that can run during one frame. If the framerate is too low
+     * to catch up with the physics the rest of the frame time is dropped (physics will slow down) so that
+     * the physics does not take more and more time each frame.
+     *
+     * @param iMaxTicks Maximum number of ticks, clamped to 1 if 0.
+     */
+    void setMaxPhysicsTicksPerFrame(unsigned int iMaxTicks);
+
+    /**
+     * Returns the maximum number of physics ticks that can run during one frame.
+     *
+     * @return Tick count.
+     */
+    unsigned int getMaxPhysicsTicksPerFrame() const { return iMaxPhysicsTicksPerFrame; }
+
+    /**
+     * Enables/disables pipelined physics: the physics step of the current frame runs on a separate thread
+     * while the main thread renders the frame (and processes input of the next frame) instead of blocking
+     * the main thread.
+     *
+     * @remark Results of a physics step are applied to simulated/moving nodes (and contact events are
+     * triggered) at the start of the next frame's physics update, so nodes lag one frame behind the
+     * simulation.
+     *
+     * @remark Physics keeps its fixed tick: @ref SimulatedBodyNode::onBeforePhysicsUpdate (and similar
+     * functions of other body nodes) are called once per physics tick right before the tick is simulated.
+     * Because these functions run game code on the main thread, only the last tick of a frame runs on the
+     * physics step thread, if a frame needs more ticks to catch up (low framerate) the other ticks run on
+     * the main thread before it just like when this mode is disabled.
+     *
+     * @remark Functions of this manager that access the physics world wait for the running step to finish.
+     *
+     * @remark Disabled by default. Disabling waits for the running step and applies its results.
+     *
+     * @param bEnable New state.
+     */
+    void setEnableAsyncPhysicsStep(bool bEnable);
+
+    /**
+     * Tells if pipelined physics is enabled (see @ref setEnableAsyncPhysicsStep).
+     *
+     * @return Pipelined physics state.
+     */
+    bool isAsyncPhysicsStepEnabled() const { return bIsAsyncPhysicsStepEnabled; }
+
+    /**
+     * Tells if a physics step was started on the physics thread and its results were not applied yet
+     * (see @ref setEnableAsyncPhysicsStep).
+     *
+     * @return `true` if the step is running or waits for its results to be applied.
+     */
+    bool isAsyncPhysicsStepPending() const { return bIsAsyncPhysicsStepResultPending; }
+
 #if defined(ENGINE_DEBUG_TOOLS)
     /**
      * Enables/disabled rendering of the physics bodies.
@@ -84,9 +174,32 @@ public:
     /**
      * Optimizes broad phase if added a lot of bodies before a physics update.
      * Don't call this every frame.
+     *
+     * @remark Already done automatically after spawning/despawning a large node tree (see
+     * @ref endBodyBatch).
      */
     void optimizeBroadPhase();
 
+    /**
+     * Starts a batch of body creation/destruction: until @ref endBodyBatch is called bodies created by
+     * `createBodyForNode` are not added to the physics world one by one but are collected and added
+     * all at once (same for removed bodies) which is much faster than adding bodies one by one and
+     * results in a better broad phase tree.
+     *
+     * @remark Called by nodes when spawning/despawning a node tree, batches can be nested.
+     *
+     * @remark Functions of this manager that need bodies to be in the physics world (such as ray casts
+     * or adding impulses) add collected bodies before doing their work.
+     */
+    void beginBodyBatch();
+
+    /**
+     * Ends a batch of body creation/destruction (see @ref beginBodyBatch), if this was the outermost batch
+     * adds/removes collected bodies to/from the physics world. After a large batch the broad phase is
+     * optimized automatically.
+     */
+    void endBodyBatch();
+
     /**
      * Creates a physics body for the specified node.
      *
@@ -200,6 +313,40 @@ public:
         const glm::vec3& rayEndPosition,
         const std::vector<JPH::BodyID>& vIgnoredBodies = {});
 
+    /**
+     * Casts multiple rays (each until something is hit) in parallel on worker threads.
+     *
+     * @remark Prefer this function over calling @ref castRayUntilHit in a loop when there are many rays,
+     * no heap memory is allocated per ray.
+     *
+     * @param vQueries       Rays to cast.
+     * @param vHits          Buffer to write results to (at least the size of queries), result of query
+     * `i` is written to `vHits[i]` and is empty if nothing was hit.
+     * @param vIgnoredBodies Optional array of bodies to ignore (used by all rays).
+     */
+    void castRaysUntilHit(
+        std::span<const CastQuery> vQueries,
+        std::span<std::optional<RayCastHit>> vHits,
+        std::span<const JPH::BodyID> vIgnoredBodies = {});
+
+    /**
+     * Sweeps multiple spheres (each until something is hit) in parallel on worker threads.
+     *
+     * @remark Hit position is the contact point on the surface of the hit body, spheres that overlap
+     * something at the start position report a hit at the start.
+     *
+     * @param vQueries       Start/end positions of sphere centers.
+     * @param sphereRadius   Radius of all spheres.
+     * @param vHits          Buffer to write results to (at least the size of queries), result of query
+     * `i` is written to `vHits[i]` and is empty if nothing was hit.
+     * @param vIgnoredBodies Optional array of bodies to ignore (used by all spheres).
+     */
+    void castSpheresUntilHit(
+        std::span<const CastQuery> vQueries,
+        float sphereRadius,
+        std::span<std::optional<RayCastHit>> vHits,
+        std::span<const JPH::BodyID> vIgnoredBodies = {});
+
     /**
      * Adds or removes the body from the physics world (does not destroys the body).
      *
@@ -218,6 +365,16 @@ public:
      */
     void setBodyLocationRotation(JPH::Body* pBody, const glm::vec3& location, const glm::vec3& rotation);
 
+    /**
+     * Teleports the specified character (and its inner body) to a new location and rotation.
+     *
+     * @param pNode    Character node with a created character body.
+     * @param location New location of the character.
+     * @param rotation New rotation of the character.
+     */
+    void setCharacterLocationRotation(
+        CharacterBodyNode* pNode, const glm::vec3& location, const glm::vec3& rotation);
+
     /**
      * Activates or deactivates a body.
      *
@@ -335,6 +492,33 @@ public:
      */
     JPH::TempAllocator& getTempAllocator();
 
+    /**
+     * Returns cache of Jolt shapes that are shared between bodies with identical collision shapes.
+     *
+     * @return Shape cache.
+     */
+    CollisionShapeCache& getCollisionShapeCache() { return *pCollisionShapeCache; }
+
+    /**
+     * Returns the total number of sensor contact events that were dropped because too many events happened
+     * during a physics step (each drop is also reported in the log).
+     *
+     * @return Number of dropped events.
+     */
+    size_t getDroppedContactEventCount() const { return contactData.iDroppedEventCount; }
+
+    /**
+     * Returns the number of spawned simulated body nodes.
+     *
+     * @param bOnlyAwake `true` to only count nodes that are updated after physics ticks (see
+     * @ref PartitionedBodyNodes), `false` to count all nodes.
+     *
+     * @return Node count.
+     */
+    size_t getSimulatedBodyNodeCount(bool bOnlyAwake) const {
+        return bOnlyAwake ? simulatedBodies.iAwakeCount : simulatedBodies.vNodes.size();
+    }
+
 #if defined(ENGINE_DEBUG_TOOLS)
     /**
      * Returns physics debug drawer.
@@ -372,16 +556,134 @@ private:
         size_t iOtherNodeId = 0;
     };
 
+    /** Groups bodies collected during a batch (see @ref beginBodyBatch). */
+    struct BodyBatch {
+        /** Created bodies that should be added to the physics world and their activation mode. */
+        std::unordered_map<JPH::BodyID, JPH::EActivation> bodiesToAdd;
+
+        /** Bodies that should be removed from the physics world and then destroyed. */
+        std::vector<JPH::BodyID> vBodiesToRemove;
+
+        /** The number of not finished (nested) batches. */
+        size_t iDepth = 0;
+    };
+
+    /** Event about a new contact with a sensor, added by Jolt's threads during the physics step. */
+    struct ContactAddedEvent {
+        /** Pair of contacting shapes. */
+        JPH::SubShapeIDPair subShapePair;
+
+        /** Sensor node id. */
+        size_t iSensorNodeId = 0;
+
+        /** Other node id. */
+        size_t iOtherNodeId = 0;
+
+        /** World space normal of the contact. */
+        glm::vec3 worldNormal = glm::vec3(0.0f);
+
+        /** World space location of the contact point. */
+        glm::vec3 contactPointLocation = glm::vec3(0.0f);
+
+        /** Order of the event among all contact events (see @ref ContactData::iNextEventIndex). */
+        size_t iEventIndex = 0;
+    };
+
+    /** Event about a lost contact, added by Jolt's threads during the physics step. */
+    struct ContactRemovedEvent {
+        /** Pair of shapes that were contacting. */
+        JPH::SubShapeIDPair subShapePair;
+
+        /** Order of the event among all contact events (see @ref ContactData::iNextEventIndex). */
+        size_t iEventIndex = 0;
+    };
+
+    /** Type of a node that owns a body (see @ref vBodyNodeSlots). */
+    enum class BodyNodeType : uint8_t {
+        NONE,
+        SIMULATED,
+        MOVING,
+    };
+
+    /** Location of a body's node in @ref simulatedBodies or @ref movingBodies. */
+    struct BodyNodeSlot {
+        /** Index of the node in @ref PartitionedBodyNodes::vNodes. */
+        size_t iIndex = 0;
+
+        /** Array that stores the node. */
+        BodyNodeType type = BodyNodeType::NONE;
+    };
+
+    /**
+     * Body nodes of one type stored in a dense array where awake nodes are stored first so that per-tick
+     * work only iterates over awake nodes.
+     *
+     * @remark Awake nodes are nodes with an active body and nodes whose body fell asleep but that did not
+     * receive the final (interpolated) transform yet.
+     */
+    template <typename T> struct PartitionedBodyNodes {
+        /** Awake nodes in range [0; @ref iAwakeCount) and then sleeping nodes. */
+        std::vector<T*> vNodes;
+
+        /** Number of awake nodes at the beginning of @ref vNodes. */
+        size_t iAwakeCount = 0;
+    };
+
+    /** Groups data used to update character bodies in parallel (reused to avoid allocations). */
+    struct CharacterUpdateData {
+        /** Bounding spheres (center and radius) of areas that characters can reach during an update. */
+        std::vector<glm::vec4> vReachSpheres;
+
+        /** Group of each character (the group's smallest character index). */
+        std::vector<size_t> vGroupParents;
+
+        /** Indices of characters sorted by the minimum X of their reach spheres. */
+        std::vector<size_t> vSweepOrder;
+
+        /** Indices of characters sorted by groups. */
+        std::vector<size_t> vSortedCharacters;
+
+        /** Index of the first character of each group in @ref vSortedCharacters (and then the end index). */
+        std::vector<size_t> vGroupStarts;
+
+        /** Temp allocators for jobs (Jolt's temp allocator can only be used by one thread at a time). */
+        std::vector<std::unique_ptr<JPH::TempAllocatorImpl>> vTempAllocators;
+
+        /**
+         * Character vs character collision of each job, only contains characters of the group that is being
+         * updated by the job so that a character never sees characters that are moved by other jobs.
+         */
+        std::vector<std::unique_ptr<JPH::CharacterVsCharacterCollisionSimple>> vCharVsCharCollisions;
+    };
+
     /** Groups data related to contacts. */
     struct ContactData {
+        /** Maximum number of events of one type that can be added between 2 calls to process contacts. */
+        static constexpr size_t iMaxEventsPerStep = 8192;
+
         /** Contact add events to process. */
-        std::queue<ContactInfo> newContactsAdded;
+        MpscRingBuffer<ContactAddedEvent> addedEvents{iMaxEventsPerStep};
 
         /** Contact remove events to process. */
-        std::queue<ContactInfo> newContactsRemoved;
+        MpscRingBuffer<ContactRemovedEvent> removedEvents{iMaxEventsPerStep};
 
-        /** Added contacts that were not removed yet. */
+        /**
+         * Index of the next event, used to process add/remove events in the order they happened when
+         * multiple physics steps run before events are processed.
+         */
+        std::atomic<size_t> iNextEventIndex{0};
+
+        /** Added contacts that were not removed yet (only used on the main thread). */
         std::unordered_map<JPH::SubShapeIDPair, SensorContactInfo> activeSensorContacts;
+
+        /** Contacts added since the last processing (reused to avoid allocations). */
+        std::vector<ContactInfo> vContactsAdded;
+
+        /** Contacts removed since the last processing (reused to avoid allocations). */
+        std::vector<ContactInfo> vContactsRemoved;
+
+        /** Total number of events that were dropped because an event buffer was full. */
+        size_t iDroppedEventCount = 0;
     };
 
     /**
@@ -399,6 +701,56 @@ private:
      */
     void onBeforeNewFrame(float timeSincePrevFrameInSec);
 
+    /**
+     * Runs a single physics tick of @ref physicsTickTimeSec on the calling thread.
+     *
+     * @param deltaTime Time to simulate in seconds.
+     */
+    void runPhysicsTick(float deltaTime);
+
+    /**
+     * Calls "before physics update" functions on bodies and moves character bodies.
+     *
+     * @param deltaTime Time (in seconds) that the next physics update will simulate.
+     */
+    void runPhysicsUpdateCallbacks(float deltaTime);
+
+    /**
+     * Runs all ticks except for the last one on the calling thread and then starts the last tick on
+     * the physics step thread, its results are applied in @ref applyAsyncPhysicsStepResults.
+     *
+     * @param iTickCount Number of ticks of @ref physicsTickTimeSec to run (at least 1).
+     */
+    void startAsyncPhysicsStep(unsigned int iTickCount);
+
+    /** Waits for the physics step that runs on the physics step thread (if it's running) to finish. */
+    void waitForAsyncPhysicsStep();
+
+    /** Waits for the physics step that runs on the physics step thread and applies its results. */
+    void applyAsyncPhysicsStepResults();
+
+    /** Saves transforms of simulated and moving bodies after a physics update to interpolate nodes later. */
+    void saveBodyTransformsForInterpolation();
+
+    /** Notifies character bodies about contacts found while moving them. */
+    void processCharacterContactEvents();
+
+    /**
+     * Notifies trigger volumes about contacts found during a physics update.
+     *
+     * @param bSkipDespawnedNodes `true` to ignore contacts of nodes that were despawned after the physics
+     * update, `false` to treat them as an error.
+     */
+    void processSensorContactEvents(bool bSkipDespawnedNodes);
+
+    /**
+     * Sets transforms of simulated and moving nodes to be in-between the last 2 physics ticks.
+     *
+     * @param alpha Value in range [0.0; 1.0] where 0 means the state before the last tick and 1 means the
+     * state after the last tick.
+     */
+    void interpolateBodyTransforms(float alpha);
+
     /**
      * Creates a new body and adds to @ref bodyIdToPtr if successful.
      *
@@ -409,23 +761,159 @@ private:
     JPH::Body* createBody(const JPH::BodyCreationSettings& settings);
 
     /**
-     * Destroys a body and removes it from @ref bodyIdToPtr.
+     * Adds a created body to the physics world (or to the batch if there's an active batch).
+     *
+     * @param bodyId     ID of the body to add.
+     * @param activation Activation mode.
+     */
+    void addBody(const JPH::BodyID& bodyId, JPH::EActivation activation);
+
+    /**
+     * Removes a body from the physics world (if it was added), destroys it and removes it from
+     * @ref bodyIdToPtr.
      *
      * @param bodyId ID of the body to destroy.
      */
     void destroyBody(const JPH::BodyID& bodyId);
 
+    /**
+     * Wakes up sleeping bodies that overlap bounds of the specified sensor body, used after a sensor was
+     * added or moved because static sensors don't detect sleeping bodies.
+     *
+     * @param pSensorBody Sensor body.
+     */
+    void activateBodiesInSensor(JPH::Body* pSensorBody);
+
+    /**
+     * Waits for the physics step that runs on the physics step thread (if it's running) and then
+     * adds/removes bodies collected in @ref bodyBatch to/from the physics world.
+     */
+    void flushBodyBatch();
+
+    /**
+     * Adds a node to the array of nodes (as awake node if its body is active).
+     *
+     * @param nodes Array to add to.
+     * @param pNode Node with a created body.
+     * @param type  Type of the array.
+     */
+    template <typename T>
+    void registerBodyNode(PartitionedBodyNodes<T>& nodes, T* pNode, BodyNodeType type);
+
+    /**
+     * Removes a node from the array of nodes.
+     *
+     * @param nodes Array to remove from.
+     * @param pNode Node that still has its body.
+     */
+    template <typename T> void unregisterBodyNode(PartitionedBodyNodes<T>& nodes, T* pNode);
+
+    /**
+     * Moves a node between awake and sleeping nodes.
+     *
+     * @param nodes  Array of nodes.
+     * @param iIndex Index of the node in the array.
+     * @param bAwake `true` to move to awake nodes, `false` to sleeping nodes.
+     */
+    template <typename T> void setBodyNodeAwake(PartitionedBodyNodes<T>& nodes, size_t iIndex, bool bAwake);
+
+    /**
+     * Swaps 2 nodes in the array of nodes and updates their slots.
+     *
+     * @param nodes   Array of nodes.
+     * @param iFirst  Index of a node.
+     * @param iSecond Index of a node.
+     */
+    template <typename T> void swapBodyNodes(PartitionedBodyNodes<T>& nodes, size_t iFirst, size_t iSecond);
+
+    /** Applies sensor flags of bodies that were created before the last physics update. */
+    void applyPendingSensorFlags();
+
+    /**
+     * Called by Jolt after a body was activated to move its node to awake nodes.
+     *
+     * @remark Jolt calls this function with active bodies list locked so calls are never concurrent.
+     *
+     * @param bodyId Activated body.
+     */
+    void onBodyActivated(const JPH::BodyID& bodyId);
+
+    /**
+     * Returns the number of jobs to split items into (see @ref runParallelJobs).
+     *
+     * @param iItemCount      Total number of items.
+     * @param iMinItemsPerJob Minimum number of items that is worth a separate job.
+     *
+     * @return Job count, 1 if items should be processed on the calling thread.
+     */
+    size_t getParallelJobCount(size_t iItemCount, size_t iMinItemsPerJob) const;
+
+    /**
+     * Splits items into ranges and processes them on worker threads of the job system, returns after all
+     * ranges were processed.
+     *
+     * @param iItemCount   Total number of items.
+     * @param iJobCount    Number of jobs to create (see @ref getParallelJobCount).
+     * @param processRange Function that receives index of the job (smaller than job count) and processes
+     * items in range [start; end).
+     */
+    void runParallelJobs(
+        size_t iItemCount,
+        size_t iJobCount,
+        const std::function<void(size_t, size_t, size_t)>& processRange);
+
+    /**
+     * Updates positions of all character bodies: characters that can touch each other during this update
+     * are updated one after another in the same job while separate groups of characters are updated in
+     * parallel. Then nodes are moved to updated positions in the order of registration.
+     *
+     * @param deltaTime Time (in seconds) that has passed since the last physics update.
+     */
+    void updateCharacterPositions(float deltaTime);
+
     /** Data related to contacts. */
-    std::pair<std::mutex, ContactData> mtxContactData;
+    ContactData contactData;
+
+    /**
+     * Stores `true` at index of a body ID if the body with this index is a sensor. Only modified when
+     * the physics step is not running so that Jolt's threads can read it without synchronization.
+     *
+     * @remark Contacts of a destroyed sensor are reported as removed during the next physics update so the
+     * flag of a destroyed sensor is only cleared after that update (see @ref vPendingSensorFlags).
+     */
+    std::vector<bool> vIsSensorBody;
+
+    /**
+     * Pairs of "body index" - "is sensor" of bodies that were created at the index of a (possibly
+     * destroyed) sensor, applied to @ref vIsSensorBody in the order of creation after the next physics
+     * update.
+     */
+    std::vector<std::pair<JPH::uint32, bool>> vPendingSensorFlags;
+
+    /** Number of first items from @ref vPendingSensorFlags to apply after the running physics update. */
+    size_t iPendingSensorFlagCountBeforeStep = 0;
+
+    /** Bodies collected during a batch of body creation/destruction. */
+    BodyBatch bodyBatch;
 
     /** Used to update node position/rotation according to the simulated Jolt body. */
-    std::unordered_set<SimulatedBodyNode*> simulatedBodies;
+    PartitionedBodyNodes<SimulatedBodyNode> simulatedBodies;
 
     /** Used to update node position/rotation according to the Jolt body. */
-    std::unordered_set<MovingBodyNode*> movingBodies;
+    PartitionedBodyNodes<MovingBodyNode> movingBodies;
+
+    /**
+     * Stores location of a node in @ref simulatedBodies or @ref movingBodies at index of its body ID. Read
+     * by Jolt's threads in body activation callbacks and only modified when the physics step is not
+     * running.
+     */
+    std::vector<BodyNodeSlot> vBodyNodeSlots;
 
-    /** Active character bodies. */
-    std::unordered_set<CharacterBodyNode*> characterBodies;
+    /** Active character bodies in the order of registration. */
+    std::vector<CharacterBodyNode*> characterBodies;
+
+    /** Data used to update characters. */
+    CharacterUpdateData characterUpdateData;
 
     /** Mapping from body ID to body pointer for non destroyed bodies. */
     std::unordered_map<JPH::BodyID, JPH::Body*> bodyIdToPtr;
@@ -439,12 +927,12 @@ private:
     /** Mapping between broad phase layers and object layers. */
     std::unique_ptr<ObjectVsBroadPhaseLayerFilterImpl> pObjectVsBroadPhaseLayerFilterImpl;
 
-    /** List of active characters so they can collide. */
-    std::unique_ptr<JPH::CharacterVsCharacterCollisionSimple> pCharVsCharCollision;
-
     /** A listener class that receives collision contact events. */
     std::unique_ptr<ContactListener> pContactListener;
 
+    /** Receives events about activated bodies. */
+    std::unique_ptr<BodyActivationListener> pBodyActivationListener;
+
     /** Jolt physics system. */
     std::unique_ptr<JPH::PhysicsSystem> pPhysicsSystem;
 
@@ -454,9 +942,33 @@ private:
     /** Temp allocator. */
     std::unique_ptr<JPH::TempAllocatorImpl> pTempAllocator;
 
+    /** Shares Jolt shapes between bodies. */
+    std::unique_ptr<CollisionShapeCache> pCollisionShapeCache;
+
+    /** Runs physics steps when pipelined physics is enabled, `nullptr` if it was never enabled. */
+    std::unique_ptr<PhysicsStepThread> pPhysicsStepThread;
+
+    /** Result of the physics step that was started on @ref pPhysicsStepThread (if valid). */
+    std::future<void> asyncPhysicsStepResult;
+
     /** Game manager. */
     GameManager* const pGameManager = nullptr;
 
+    /** Frame time (in seconds) that was not simulated yet because it's smaller than a physics tick. */
+    float timeNotSimulatedSec = 0.0f;
+
+    /** The maximum number of physics ticks that can run during one frame. */
+    unsigned int iMaxPhysicsTicksPerFrame = 4;
+
+    /** Time (in seconds) that the last finished physics tick simulated. */
+    float lastPhysicsUpdateTimeSec = 0.0f;
+
+    /** `true` if the physics step is run on @ref pPhysicsStepThread. */
+    bool bIsAsyncPhysicsStepEnabled = false;
+
+    /** `true` if the started physics step was not applied yet (see @ref applyAsyncPhysicsStepResults). */
+    bool bIsAsyncPhysicsStepResultPending = false;
+
 #if defined(ENGINE_DEBUG_TOOLS)
     /** Debug rendering of the physics. */
     std::unique_ptr<PhysicsDebugDrawer> pPhysicsDebugDrawer;
@@ -0,0 +1,54 @@
+#include "game/physics/PhysicsStepThread.h"
+
+#if defined(ENGINE_PROFILER_ENABLED)
+#include "tracy/public/common/TracySystem.hpp"
+#endif
+
+PhysicsStepThread::PhysicsStepThread() { thread = std::thread(&PhysicsStepThread::processTasksThread, this); }
+
+PhysicsStepThread::~PhysicsStepThread() {
+    bIsShuttingDown.test_and_set();
+    {
+        // Lock to make sure the thread is either waiting or will see the flag before waiting.
+        std::scoped_lock guard(mtxTaskQueue.first);
+    }
+    cvNewTasks.notify_one();
+    thread.join();
+}
+
+std::future<void> PhysicsStepThread::addTask(std::packaged_task<void()>&& task) {
+    auto future = task.get_future();
+    {
+        std::scoped_lock guard(mtxTaskQueue.first);
+        mtxTaskQueue.second.push(std::move(task));
+    }
+    cvNewTasks.notify_one();
+
+    return future;
+}
+
+void PhysicsStepThread::processTasksThread() {
+#if defined(ENGINE_PROFILER_ENABLED)
+    tracy::SetThreadName("physics step thread");
+#endif
+
+    while (true) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock guard(mtxTaskQueue.first);
+            cvNewTasks.wait(
+                guard, [this] { return !mtxTaskQueue.second.empty() || bIsShuttingDown.test(); });
+
+            // Finish queued tasks before exiting because someone might be waiting for the results.
+            if (mtxTaskQueue.second.empty()) {
+                break;
+            }
+
+            task = std::move(mtxTaskQueue.second.front());
+            mtxTaskQueue.second.pop();
+        }
+
+        // Exceptions are stored in the future.
+        task();
+    }
+}
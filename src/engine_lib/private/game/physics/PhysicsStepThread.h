@@ -0,0 +1,53 @@
+#pragma once
+
+// Standard.
+#include <mutex>
+#include <queue>
+#include <future>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+
+/**
+ * Thread that runs physics steps in the background (while the main thread submits the frame) so that
+ * the main thread does not wait for the physics simulation.
+ *
+ * @remark A dedicated thread (and not the game manager's thread pool) so that a physics step never
+ * waits for unrelated long tasks (such as resource loading) to finish.
+ */
+class PhysicsStepThread {
+public:
+    /** Starts the thread. */
+    PhysicsStepThread();
+
+    PhysicsStepThread(const PhysicsStepThread&) = delete;
+    PhysicsStepThread& operator=(const PhysicsStepThread&) = delete;
+
+    /** Waits for queued tasks to be finished and stops the thread. */
+    ~PhysicsStepThread();
+
+    /**
+     * Queues a task to be executed on the physics step thread.
+     *
+     * @param task Task that runs a physics step.
+     *
+     * @return Future that will be ready once the task is finished.
+     */
+    std::future<void> addTask(std::packaged_task<void()>&& task);
+
+private:
+    /** Function that the thread is executing. */
+    void processTasksThread();
+
+    /** Tasks waiting to be executed. */
+    std::pair<std::mutex, std::queue<std::packaged_task<void()>>> mtxTaskQueue;
+
+    /** Condition variable to wait until new tasks are added. */
+    std::condition_variable cvNewTasks;
+
+    /** Set when the thread should finish. */
+    std::atomic_flag bIsShuttingDown;
+
+    /** Thread that executes tasks. */
+    std::thread thread;
+};
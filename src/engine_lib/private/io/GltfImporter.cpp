@@ -2,6 +2,16 @@
 
 // Standard.
 #include <format>
+#include <mutex>
+#include <latch>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <cctype>
+#include <fstream>
+#include <unordered_set>
+#include <unordered_map>
+#include <vector>
 
 // Custom.
 #include "misc/ProjectPaths.h"
@@ -9,51 +19,101 @@
 #include "game/node/SkeletonNode.h"
 #include "game/node/SkeletalMeshNode.h"
 #include "game/geometry/ConvexShapeGeometry.h"
+#include "game/geometry/shapes/CollisionShape.h"
+#include "game/geometry/MeshGeometryOptimizer.h"
+#include "game/geometry/MeshSimplifier.h"
 #include "material/TextureManager.h"
+#include "misc/ThreadPool.h"
+#include "misc/Profiler.hpp"
 
 // External.
 #define TINYGLTF_IMPLEMENTATION
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "tinygltf/tiny_gltf.h"
 #include "stb/stb_image.h"
-#include "subprocess.h/subprocess.h"
 #include "ozz/base/io/stream.h"
 #include "ozz/base/io/archive.h"
 #include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/offline/animation_builder.h"
+#include "ozz/animation/offline/animation_optimizer.h"
+#include "ozz/base/maths/transform.h"
 
 namespace {
     constexpr std::string_view sTexturesDirNameSuffix = "_tex";
     constexpr std::string_view sDiffuseTextureName = "diffuse";
+
+    /** LOD generation stops if a new LOD has more triangles than this fraction of the previous LOD. */
+    constexpr float minLodTriangleReduction = 0.9f;
+
+    constexpr std::string_view sSkeletonFileName = "skeleton.ozz";
+
+    /** Duration of imported animations that have only 1 key (or none). */
+    constexpr float minAnimationDuration = 0.001f;
 }
 
-inline std::string writeGltfTextureToDisk(
-    const std::filesystem::path& pathToImportFile,
-    const tinygltf::Image& image,
-    const std::filesystem::path& pathToTexturesDir,
-    size_t iPrimitive) {
+/**
+ * Returns name of the file that the specified GLTF image will be stored in (in the textures directory).
+ *
+ * @param pathToImportFile Path to the GLTF file being imported.
+ * @param image            Image.
+ * @param iImageIndex      Index of the image in the GLTF model.
+ *
+ * @return Empty if the image can't be imported.
+ */
+inline std::string getGltfTextureFileName(
+    const std::filesystem::path& pathToImportFile, const tinygltf::Image& image, size_t iImageIndex) {
     if (!image.uri.empty()) {
         if (image.uri.find('/') != std::string::npos || image.uri.find('\\') != std::string::npos) {
             Log::error(std::format("found path in image uri \"{}\"", image.uri));
             return "";
         }
 
-        const auto pathToSrcImage = pathToImportFile.parent_path() / image.uri;
-        const auto pathToDstImage = pathToTexturesDir / image.uri;
-
-        if (std::filesystem::exists(pathToSrcImage)) {
-            if (std::filesystem::exists(pathToDstImage)) {
-                return image.uri; // multiple primitives using the same texture
-            }
-            std::filesystem::copy_file(pathToSrcImage, pathToDstImage);
+        if (std::filesystem::exists(pathToImportFile.parent_path() / image.uri)) {
             return image.uri;
         }
     }
 
-    std::string sTextureName = std::string(sDiffuseTextureName) + "_" + std::to_string(iPrimitive);
+    std::string sTextureName = std::string(sDiffuseTextureName) + "_" + std::to_string(iImageIndex);
 
     if (image.mimeType == "image/jpeg") {
         sTextureName += ".jpg";
-        const auto sPathToDstImage = (pathToTexturesDir / sTextureName).string();
+    } else if (image.mimeType == "image/png") {
+        sTextureName += ".png";
+    } else {
+        Log::error("unknown texture format");
+        return "";
+    }
+
+    return sTextureName;
+}
+
+/**
+ * Copies (if the image references an existing file) or encodes the GLTF image to the textures directory.
+ *
+ * @param pathToImportFile  Path to the GLTF file being imported.
+ * @param image             Image.
+ * @param pathToTexturesDir Directory to write the image to.
+ * @param sTextureName      Name of the file from @ref getGltfTextureFileName.
+ *
+ * @return `false` if failed.
+ */
+inline bool writeGltfTextureToDisk(
+    const std::filesystem::path& pathToImportFile,
+    const tinygltf::Image& image,
+    const std::filesystem::path& pathToTexturesDir,
+    const std::string& sTextureName) {
+    const auto sPathToDstImage = (pathToTexturesDir / sTextureName).string();
+
+    if (sTextureName == image.uri) {
+        std::filesystem::copy_file(pathToImportFile.parent_path() / image.uri, sPathToDstImage);
+        return true;
+    }
+
+    if (image.mimeType == "image/jpeg") {
         if (stbi_write_jpg(
                 sPathToDstImage.c_str(),
                 image.width,
@@ -62,11 +122,9 @@ inline std::string writeGltfTextureToDisk(
                 image.image.data(),
                 100) != 1) {
             Log::error("failed to import texture");
-            return "";
+            return false;
         }
     } else if (image.mimeType == "image/png") {
-        sTextureName += ".png";
-        const auto sPathToDstImage = (pathToTexturesDir / sTextureName).string();
         if (stbi_write_png(
                 sPathToDstImage.c_str(),
                 image.width,
@@ -75,35 +133,46 @@ inline std::string writeGltfTextureToDisk(
                 image.image.data(),
                 image.width * image.component) != 1) {
             Log::error("failed to import texture");
-            return "";
+            return false;
         }
     } else {
         Log::error("unknown texture format");
-        return "";
+        return false;
     }
 
-    return sTextureName;
+    return true;
 }
 
+/**
+ * Converts meshes of a GLTF node to mesh nodes.
+ *
+ * @remark Can be called from multiple threads at the same time.
+ *
+ * @param model                    GLTF model.
+ * @param node                     GLTF node with a mesh.
+ * @param mesh                     Mesh of the node.
+ * @param pathToTexturesDir        Directory that stores imported textures.
+ * @param vTextureFileNames        Names of texture files for each GLTF image.
+ * @param options                  Import options.
+ * @param onProgress               Progress callback.
+ * @param iGltfNodeProcessedCount  Index of this GLTF node (for progress reporting).
+ * @param iTotalGltfNodesToProcess Total number of GLTF nodes with meshes (for progress reporting).
+ *
+ * @return Error if something went wrong, otherwise created mesh nodes.
+ */
 inline std::variant<Error, std::vector<std::unique_ptr<MeshNode>>> processGltfMesh(
     const tinygltf::Model& model,
     const tinygltf::Node& node,
     const tinygltf::Mesh& mesh,
-    const std::filesystem::path& pathToImportFile,
-    const std::filesystem::path& pathToOutputFile,
-    const std::string& sPathToOutputDirRelativeRes,
+    const std::filesystem::path& pathToTexturesDir,
+    const std::vector<std::string>& vTextureFileNames,
+    const GltfImportOptions& options,
     const std::function<void(std::string_view)>& onProgress,
-    size_t& iGltfNodeProcessedCount,
+    const size_t iGltfNodeProcessedCount,
     const size_t iTotalGltfNodesToProcess) {
     // Prepare array to fill.
     std::vector<std::unique_ptr<MeshNode>> vMeshNodes;
 
-    // Prepare textures directory.
-    const std::string sFilename = pathToOutputFile.stem().string();
-    const std::filesystem::path pathToTexturesDir =
-        ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sPathToOutputDirRelativeRes /
-        (sFilename + std::string(sTexturesDirNameSuffix));
-
     // Go through each mesh in this node.
     for (size_t iPrimitive = 0; iPrimitive < mesh.primitives.size(); iPrimitive++) {
         auto& primitive = mesh.primitives[iPrimitive];
@@ -424,6 +493,23 @@ inline std::variant<Error, std::vector<std::unique_ptr<MeshNode>>> processGltfMe
             continue;
         }
 
+        // Prepare a callback to report results of the geometry optimization.
+        const auto reportOptimizationStats = [&](const MeshOptimizationStats& stats) {
+            onProgress(std::format(
+                "optimized GLTF node {}/{}, mesh {}/{}: ACMR {:.3f} -> {:.3f}, vertices {} -> {}, "
+                "triangles {} -> {}",
+                iGltfNodeProcessedCount,
+                iTotalGltfNodesToProcess,
+                iPrimitive,
+                mesh.primitives.size(),
+                stats.acmrBefore,
+                stats.acmrAfter,
+                stats.iVertexCountBefore,
+                stats.iVertexCountAfter,
+                stats.iTriangleCountBefore,
+                stats.iTriangleCountAfter));
+        };
+
         // Create a new mesh node with the specified data.
         std::unique_ptr<MeshNode> pMeshNode;
         if (!vMeshBoneIndices.empty()) {
@@ -448,12 +534,83 @@ inline std::variant<Error, std::vector<std::unique_ptr<MeshNode>>> processGltfMe
                 dst.vBoneIndices = vMeshBoneIndices[i];
                 dst.vBoneWeights = vMeshBoneWeights[i];
             }
+
+            // Optimize for rendering.
+            auto optimizeResult = MeshGeometryOptimizer::optimize(skeletalGeometry);
+            if (std::holds_alternative<Error>(optimizeResult)) [[unlikely]] {
+                auto error = std::get<Error>(std::move(optimizeResult));
+                error.addCurrentLocationToErrorStack();
+                return error;
+            }
+            reportOptimizationStats(std::get<MeshOptimizationStats>(optimizeResult));
+
             auto pSkeletalMesh = std::make_unique<SkeletalMeshNode>();
             pSkeletalMesh->setSkeletalMeshGeometryBeforeSpawned(std::move(skeletalGeometry));
             pMeshNode = std::move(pSkeletalMesh);
         } else {
+            // Optimize for rendering.
+            auto optimizeResult = MeshGeometryOptimizer::optimize(geometry);
+            if (std::holds_alternative<Error>(optimizeResult)) [[unlikely]] {
+                auto error = std::get<Error>(std::move(optimizeResult));
+                error.addCurrentLocationToErrorStack();
+                return error;
+            }
+            reportOptimizationStats(std::get<MeshOptimizationStats>(optimizeResult));
+
+            // Generate LODs.
+            std::vector<MeshNodeGeometry> vLodGeometries;
+            const size_t iLodCount =
+                std::min(options.iLodCount, static_cast<size_t>(MAX_MESH_LOD_COUNT - 1));
+            for (size_t iLod = 1; iLod <= iLodCount; iLod++) {
+                const auto& previousGeometry = vLodGeometries.empty() ? geometry : vLodGeometries.back();
+                const size_t iPreviousTriangleCount = previousGeometry.getIndices().size() / 3;
+                const auto iTargetTriangleCount = static_cast<size_t>(
+                    static_cast<float>(iPreviousTriangleCount) * options.lodTriangleRatio);
+
+                auto lodGeometry =
+                    MeshSimplifier::simplify(previousGeometry, iTargetTriangleCount, options.lodMaxError);
+                const size_t iLodTriangleCount = lodGeometry.getIndices().size() / 3;
+                if (iLodTriangleCount == 0 ||
+                    static_cast<float>(iLodTriangleCount) >
+                        static_cast<float>(iPreviousTriangleCount) * minLodTriangleReduction) {
+                    // Not worth it (the error limit was reached).
+                    onProgress(std::format(
+                        "GLTF node {}/{}, mesh {}/{}: stopping LOD generation at LOD {} because "
+                        "simplification reached the error limit",
+                        iGltfNodeProcessedCount,
+                        iTotalGltfNodesToProcess,
+                        iPrimitive,
+                        mesh.primitives.size(),
+                        iLod));
+                    break;
+                }
+
+                // Optimize for rendering.
+                auto lodOptimizeResult = MeshGeometryOptimizer::optimize(lodGeometry);
+                if (std::holds_alternative<Error>(lodOptimizeResult)) [[unlikely]] {
+                    auto error = std::get<Error>(std::move(lodOptimizeResult));
+                    error.addCurrentLocationToErrorStack();
+                    return error;
+                }
+
+                onProgress(std::format(
+                    "generated LOD {} for GLTF node {}/{}, mesh {}/{}: triangles {} -> {}",
+                    iLod,
+                    iGltfNodeProcessedCount,
+                    iTotalGltfNodesToProcess,
+                    iPrimitive,
+                    mesh.primitives.size(),
+                    iPreviousTriangleCount,
+                    iLodTriangleCount));
+
+                vLodGeometries.push_back(std::move(lodGeometry));
+            }
+
             pMeshNode = std::make_unique<MeshNode>();
             pMeshNode->setMeshGeometryBeforeSpawned(std::move(geometry));
+            for (size_t i = 0; i < vLodGeometries.size(); i++) {
+                pMeshNode->setLodGeometryBeforeSpawned(i + 1, std::move(vLodGeometries[i]));
+            }
         }
         pMeshNode->setNodeName(!node.name.empty() ? node.name : "Mesh Node");
 
@@ -485,16 +642,8 @@ inline std::variant<Error, std::vector<std::unique_ptr<MeshNode>>> processGltfMe
             if (iDiffuseTextureIndex >= 0) {
                 auto& diffuseTexture = model.textures[static_cast<size_t>(iDiffuseTextureIndex)];
                 if (diffuseTexture.source >= 0) {
-                    // Get image.
-                    auto& diffuseImage = model.images[static_cast<size_t>(diffuseTexture.source)];
-
-                    if (!std::filesystem::exists(pathToTexturesDir)) {
-                        std::filesystem::create_directory(pathToTexturesDir);
-                    }
-
-                    // Write image to disk.
-                    const auto sTextureName =
-                        writeGltfTextureToDisk(pathToImportFile, diffuseImage, pathToTexturesDir, iPrimitive);
+                    // Image is written to disk by a separate task.
+                    const auto& sTextureName = vTextureFileNames[static_cast<size_t>(diffuseTexture.source)];
                     if (sTextureName.empty()) [[unlikely]] {
                         return Error("failed to import GLTF image");
                     }
@@ -518,32 +667,76 @@ inline std::variant<Error, std::vector<std::unique_ptr<MeshNode>>> processGltfMe
     return vMeshNodes;
 }
 
-inline std::optional<Error> processGltfNode(
+/** GLTF node with a mesh that is converted to mesh nodes on a worker thread. */
+struct GltfMeshImportTask {
+    /** GLTF node that has a mesh. */
+    const tinygltf::Node* pNode = nullptr;
+
+    /** Result of @ref processGltfMesh, empty until the task is finished. */
+    std::optional<std::variant<Error, std::vector<std::unique_ptr<MeshNode>>>> optResult;
+};
+
+/**
+ * Returns a temporary entity ID that mesh import tasks use to write geometry of created mesh nodes
+ * (geometry files are renamed to use IDs of the serialized node tree once the node tree is assembled).
+ *
+ * @param iTask     Index of the mesh import task.
+ * @param iMeshNode Index of the mesh node created by the task.
+ *
+ * @return Entity ID (never equal to an ID of a serialized node).
+ */
+inline std::string getGltfMeshGeometryStagingId(size_t iTask, size_t iMeshNode) {
+    return std::format("gltf{}mesh{}", iTask, iMeshNode);
+}
+
+/**
+ * Recursively collects GLTF nodes with meshes in the order they will be attached to the node tree.
+ *
+ * @param node   GLTF node to start from.
+ * @param model  GLTF model.
+ * @param vTasks Tasks to fill.
+ */
+inline void collectGltfMeshImportTasks(
+    const tinygltf::Node& node, const tinygltf::Model& model, std::vector<GltfMeshImportTask>& vTasks) {
+    if ((node.mesh >= 0) && (node.mesh < static_cast<int>(model.meshes.size()))) {
+        vTasks.push_back(GltfMeshImportTask{.pNode = &node});
+    }
+
+    for (const auto& iNode : node.children) {
+        collectGltfMeshImportTasks(model.nodes[static_cast<size_t>(iNode)], model, vTasks);
+    }
+}
+
+/**
+ * Recursively attaches mesh nodes created by finished tasks to the node tree (in the same order
+ * as the tasks were collected by @ref collectGltfMeshImportTasks).
+ *
+ * @param node            GLTF node to start from.
+ * @param model           GLTF model.
+ * @param pParentNode     Node to attach new nodes to.
+ * @param vTasks          Finished tasks.
+ * @param iNextTaskIndex  Index of the task that corresponds to the next GLTF node with a mesh.
+ *
+ * @return Error if something went wrong.
+ */
+inline std::optional<Error> attachGltfNode(
     const tinygltf::Node& node,
     const tinygltf::Model& model,
-    const std::filesystem::path& pathToImportFile,
-    const std::filesystem::path& pathToOutputFile,
-    const std::string& sPathToOutputDirRelativeRes,
     Node* pParentNode,
-    const std::function<void(std::string_view)>& onProgress,
-    size_t& iGltfNodeProcessedCount,
-    const size_t iTotalGltfNodesToProcess) {
+    std::vector<GltfMeshImportTask>& vTasks,
+    size_t& iNextTaskIndex) {
     // Prepare a node that will store this GLTF node.
     Node* pThisNode = pParentNode;
 
     // See if this node stores a mesh.
     if ((node.mesh >= 0) && (node.mesh < static_cast<int>(model.meshes.size()))) {
-        // Process mesh.
-        auto result = processGltfMesh(
-            model,
-            node,
-            model.meshes[static_cast<size_t>(node.mesh)],
-            pathToImportFile,
-            pathToOutputFile,
-            sPathToOutputDirRelativeRes,
-            onProgress,
-            iGltfNodeProcessedCount,
-            iTotalGltfNodesToProcess);
+        auto& task = vTasks[iNextTaskIndex];
+        iNextTaskIndex += 1;
+
+        if (task.pNode != &node || !task.optResult.has_value()) [[unlikely]] {
+            Error::showErrorAndThrowException("GLTF mesh import tasks are out of sync with GLTF nodes");
+        }
+        auto& result = *task.optResult;
         if (std::holds_alternative<Error>(result)) [[unlikely]] {
             auto error = std::get<Error>(std::move(result));
             error.addCurrentLocationToErrorStack();
@@ -561,23 +754,10 @@ inline std::optional<Error> processGltfNode(
         }
     }
 
-    // Mark node as processed.
-    iGltfNodeProcessedCount += 1;
-    onProgress(std::format("processing GLTF node {}/{}", iGltfNodeProcessedCount, iTotalGltfNodesToProcess));
-
     // Process child nodes.
     for (const auto& iNode : node.children) {
-        // Process child node.
-        auto optionalError = processGltfNode(
-            model.nodes[static_cast<size_t>(iNode)],
-            model,
-            pathToImportFile,
-            pathToOutputFile,
-            sPathToOutputDirRelativeRes,
-            pThisNode,
-            onProgress,
-            iGltfNodeProcessedCount,
-            iTotalGltfNodesToProcess);
+        auto optionalError =
+            attachGltfNode(model.nodes[static_cast<size_t>(iNode)], model, pThisNode, vTasks, iNextTaskIndex);
         if (optionalError.has_value()) [[unlikely]] {
             optionalError->addCurrentLocationToErrorStack();
             return optionalError;
@@ -587,11 +767,671 @@ inline std::optional<Error> processGltfNode(
     return {};
 }
 
+/**
+ * Reads floats of the specified accessor.
+ *
+ * @param model           GLTF model.
+ * @param iAccessorIndex  Index of the accessor to read.
+ * @param iComponentCount Expected number of components per element (for example 4 for `vec4`).
+ *
+ * @return Error if something went wrong, otherwise tightly packed floats.
+ */
+inline std::variant<Error, std::vector<float>>
+readGltfAccessorFloats(const tinygltf::Model& model, int iAccessorIndex, size_t iComponentCount) {
+    if (iAccessorIndex < 0 || static_cast<size_t>(iAccessorIndex) >= model.accessors.size()) [[unlikely]] {
+        return Error(std::format("invalid accessor index {}", iAccessorIndex));
+    }
+    const auto& accessor = model.accessors[static_cast<size_t>(iAccessorIndex)];
+
+    if (accessor.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT) [[unlikely]] {
+        return Error(std::format(
+            "expected accessor {} to store floats, actual component type: {}",
+            iAccessorIndex,
+            accessor.componentType));
+    }
+    const auto iActualComponentCount = tinygltf::GetNumComponentsInType(static_cast<uint32_t>(accessor.type));
+    if (iActualComponentCount < 0 || static_cast<size_t>(iActualComponentCount) != iComponentCount)
+        [[unlikely]] {
+        return Error(std::format(
+            "expected accessor {} to have {} components, actual: {}",
+            iAccessorIndex,
+            iComponentCount,
+            iActualComponentCount));
+    }
+    if (accessor.bufferView < 0 || static_cast<size_t>(accessor.bufferView) >= model.bufferViews.size())
+        [[unlikely]] {
+        return Error(std::format(
+            "accessor {} has no buffer view (sparse accessors are not supported)", iAccessorIndex));
+    }
+
+    const auto& bufferView = model.bufferViews[static_cast<size_t>(accessor.bufferView)];
+    const auto& buffer = model.buffers[static_cast<size_t>(bufferView.buffer)];
+    const int iByteStride = accessor.ByteStride(bufferView);
+    if (iByteStride <= 0) [[unlikely]] {
+        return Error(std::format("accessor {} has invalid byte stride", iAccessorIndex));
+    }
+
+    const size_t iElementSize = iComponentCount * sizeof(float);
+    const size_t iStartOffset = bufferView.byteOffset + accessor.byteOffset;
+    if (accessor.count > 0 &&
+        iStartOffset + (accessor.count - 1) * static_cast<size_t>(iByteStride) + iElementSize >
+            buffer.data.size()) [[unlikely]] {
+        return Error(std::format("accessor {} points outside of its buffer", iAccessorIndex));
+    }
+
+    std::vector<float> vFloats(accessor.count * iComponentCount);
+    for (size_t i = 0; i < accessor.count; i++) {
+        std::memcpy(
+            &vFloats[i * iComponentCount],
+            &buffer.data[iStartOffset + i * static_cast<size_t>(iByteStride)],
+            iElementSize);
+    }
+
+    return vFloats;
+}
+
+/**
+ * Returns local transform (relative to the parent) of the specified GLTF node.
+ *
+ * @param node GLTF node.
+ *
+ * @return Local transform.
+ */
+inline ozz::math::Transform getGltfNodeLocalTransform(const tinygltf::Node& node) {
+    auto transform = ozz::math::Transform::identity();
+
+    if (node.matrix.size() == 16) {
+        glm::mat4x4 matrix;
+        for (int col = 0; col < 4; col++) {
+            for (int row = 0; row < 4; row++) {
+                matrix[col][row] = static_cast<float>(node.matrix[static_cast<size_t>(col * 4 + row)]);
+            }
+        }
+
+        glm::vec3 scale;
+        glm::quat rotation;
+        glm::vec3 translation;
+        glm::vec3 skew;
+        glm::vec4 perspective;
+        glm::decompose(matrix, scale, rotation, translation, skew, perspective);
+
+        transform.translation = ozz::math::Float3(translation.x, translation.y, translation.z);
+        transform.rotation = ozz::math::Quaternion(rotation.x, rotation.y, rotation.z, rotation.w);
+        transform.scale = ozz::math::Float3(scale.x, scale.y, scale.z);
+
+        return transform;
+    }
+
+    if (node.translation.size() == 3) {
+        transform.translation = ozz::math::Float3(
+            static_cast<float>(node.translation[0]),
+            static_cast<float>(node.translation[1]),
+            static_cast<float>(node.translation[2]));
+    }
+    if (node.rotation.size() == 4) {
+        transform.rotation = ozz::math::Quaternion(
+            static_cast<float>(node.rotation[0]),
+            static_cast<float>(node.rotation[1]),
+            static_cast<float>(node.rotation[2]),
+            static_cast<float>(node.rotation[3]));
+    }
+    if (node.scale.size() == 3) {
+        transform.scale = ozz::math::Float3(
+            static_cast<float>(node.scale[0]),
+            static_cast<float>(node.scale[1]),
+            static_cast<float>(node.scale[2]));
+    }
+
+    return transform;
+}
+
+/**
+ * Returns index of a skin joint for each GLTF node.
+ *
+ * @param model GLTF model.
+ * @param skin  Skin of the model.
+ *
+ * @return Error if something went wrong, otherwise joint index per node (-1 if the node is not a joint).
+ */
+inline std::variant<Error, std::vector<int>>
+getGltfJointIndexPerNode(const tinygltf::Model& model, const tinygltf::Skin& skin) {
+    std::vector<int> vJointIndexPerNode(model.nodes.size(), -1);
+
+    for (size_t iJoint = 0; iJoint < skin.joints.size(); iJoint++) {
+        const auto iNode = skin.joints[iJoint];
+        if (iNode < 0 || static_cast<size_t>(iNode) >= model.nodes.size()) [[unlikely]] {
+            return Error(std::format("skin joint {} references invalid node index {}", iJoint, iNode));
+        }
+        if (vJointIndexPerNode[static_cast<size_t>(iNode)] != -1) [[unlikely]] {
+            return Error(std::format("node {} is used as a skin joint multiple times", iNode));
+        }
+        vJointIndexPerNode[static_cast<size_t>(iNode)] = static_cast<int>(iJoint);
+    }
+
+    return vJointIndexPerNode;
+}
+
+/**
+ * Recursively fills a raw skeleton joint (and its children) from the skin joints.
+ *
+ * @param model          GLTF model.
+ * @param skin           Skin of the model.
+ * @param vJointChildren Child joint indices of each joint.
+ * @param iJointIndex    Index of the skin joint to process.
+ * @param rawJoint       Joint to fill.
+ * @param vJointOrder    Order in which joints were visited (depth-first).
+ */
+inline void fillGltfRawSkeletonJoint(
+    const tinygltf::Model& model,
+    const tinygltf::Skin& skin,
+    const std::vector<std::vector<size_t>>& vJointChildren,
+    size_t iJointIndex,
+    ozz::animation::offline::RawSkeleton::Joint& rawJoint,
+    std::vector<size_t>& vJointOrder) {
+    const auto& node = model.nodes[static_cast<size_t>(skin.joints[iJointIndex])];
+
+    rawJoint.name = node.name.empty() ? std::format("joint_{}", iJointIndex) : node.name;
+    rawJoint.transform = getGltfNodeLocalTransform(node);
+    vJointOrder.push_back(iJointIndex);
+
+    const auto& vChildren = vJointChildren[iJointIndex];
+    rawJoint.children.resize(vChildren.size());
+    for (size_t i = 0; i < vChildren.size(); i++) {
+        fillGltfRawSkeletonJoint(
+            model, skin, vJointChildren, vChildren[i], rawJoint.children[i], vJointOrder);
+    }
+}
+
+/**
+ * Builds a skeleton from the joints of the specified skin.
+ *
+ * @remark Only skin joints become bones (non-joint nodes such as "Armature" are ignored)
+ * and bones are stored in the same order as the skin joints so that joint indices of vertices
+ * and inverse bind matrices can be used as bone indices.
+ *
+ * @param model              GLTF model.
+ * @param skin               Skin of the model.
+ * @param vJointIndexPerNode Result of @ref getGltfJointIndexPerNode.
+ *
+ * @return Error if something went wrong, otherwise built skeleton.
+ */
+inline std::variant<Error, ozz::unique_ptr<ozz::animation::Skeleton>> buildGltfSkeleton(
+    const tinygltf::Model& model, const tinygltf::Skin& skin, const std::vector<int>& vJointIndexPerNode) {
+    // Find parent of each node.
+    std::vector<int> vNodeParents(model.nodes.size(), -1);
+    for (size_t iNode = 0; iNode < model.nodes.size(); iNode++) {
+        for (const auto iChildNode : model.nodes[iNode].children) {
+            if (iChildNode < 0 || static_cast<size_t>(iChildNode) >= model.nodes.size()) [[unlikely]] {
+                return Error(std::format("node {} references invalid child node {}", iNode, iChildNode));
+            }
+            vNodeParents[static_cast<size_t>(iChildNode)] = static_cast<int>(iNode);
+        }
+    }
+
+    // Find parent joint of each joint (the closest ancestor that is a joint).
+    std::vector<int> vJointParents(skin.joints.size(), -1);
+    std::vector<std::vector<size_t>> vJointChildren(skin.joints.size());
+    std::vector<size_t> vRootJoints;
+    for (size_t iJoint = 0; iJoint < skin.joints.size(); iJoint++) {
+        int iParentNode = vNodeParents[static_cast<size_t>(skin.joints[iJoint])];
+        size_t iDepth = 0;
+        while (iParentNode != -1 && vJointIndexPerNode[static_cast<size_t>(iParentNode)] == -1) {
+            iParentNode = vNodeParents[static_cast<size_t>(iParentNode)];
+            iDepth += 1;
+            if (iDepth > model.nodes.size()) [[unlikely]] {
+                return Error("found a cycle in the node hierarchy");
+            }
+        }
+
+        if (iParentNode == -1) {
+            vRootJoints.push_back(iJoint);
+            continue;
+        }
+
+        const auto iParentJoint = vJointIndexPerNode[static_cast<size_t>(iParentNode)];
+        vJointParents[iJoint] = iParentJoint;
+        vJointChildren[static_cast<size_t>(iParentJoint)].push_back(iJoint);
+    }
+
+    // Fill raw skeleton.
+    ozz::animation::offline::RawSkeleton rawSkeleton;
+    std::vector<size_t> vJointOrder;
+    vJointOrder.reserve(skin.joints.size());
+    rawSkeleton.roots.resize(vRootJoints.size());
+    for (size_t i = 0; i < vRootJoints.size(); i++) {
+        fillGltfRawSkeletonJoint(
+            model, skin, vJointChildren, vRootJoints[i], rawSkeleton.roots[i], vJointOrder);
+    }
+
+    // Skeleton stores joints in depth-first order, make sure it matches the order of the skin joints.
+    for (size_t i = 0; i < vJointOrder.size(); i++) {
+        if (vJointOrder[i] != i) [[unlikely]] {
+            return Error(std::format(
+                "expected skin joints to be stored in depth-first order (parents before children) but "
+                "joint {} \"{}\" is out of order, try re-exporting the file",
+                vJointOrder[i],
+                model.nodes[static_cast<size_t>(skin.joints[vJointOrder[i]])].name));
+        }
+    }
+
+    // Build runtime skeleton.
+    ozz::animation::offline::SkeletonBuilder skeletonBuilder;
+    auto pSkeleton = skeletonBuilder(rawSkeleton);
+    if (pSkeleton == nullptr) [[unlikely]] {
+        return Error("failed to build a skeleton from the skin joints");
+    }
+
+    // Make sure hierarchy was not reordered.
+    const auto vBuiltParents = pSkeleton->joint_parents();
+    if (vBuiltParents.size() != vJointParents.size()) [[unlikely]] {
+        return Error(std::format(
+            "built skeleton has {} bones while the skin has {} joints",
+            vBuiltParents.size(),
+            vJointParents.size()));
+    }
+    for (size_t i = 0; i < vJointParents.size(); i++) {
+        if (static_cast<int>(vBuiltParents[i]) != vJointParents[i]) [[unlikely]] {
+            return Error(std::format("built skeleton has different parent for bone {} than the skin", i));
+        }
+    }
+
+    return pSkeleton;
+}
+
+/**
+ * Converts keys of a GLTF animation sampler to keys of an animation track.
+ *
+ * @param vTimes          Time of each key.
+ * @param vValues         Values of the sampler.
+ * @param iComponentCount Number of floats in a single value.
+ * @param sInterpolation  Interpolation of the sampler.
+ * @param makeValue       Converts a pointer to value floats to a value of a key.
+ * @param vKeys           Keys to add to.
+ *
+ * @return Error if something went wrong.
+ */
+template <typename KeyType, typename MakeValue>
+inline std::optional<Error> addGltfAnimationKeys(
+    const std::vector<float>& vTimes,
+    const std::vector<float>& vValues,
+    size_t iComponentCount,
+    const std::string& sInterpolation,
+    const MakeValue& makeValue,
+    std::vector<KeyType>& vKeys) {
+    // Cubic spline stores in-tangent, value and out-tangent for each key, only use values
+    // (the curve is approximated by the animation's linear interpolation).
+    const bool bIsCubicSpline = sInterpolation == "CUBICSPLINE";
+    const bool bIsStep = sInterpolation == "STEP";
+    const size_t iValuesPerKey = bIsCubicSpline ? 3 : 1;
+    const size_t iValueOffset = bIsCubicSpline ? 1 : 0;
+
+    if (vValues.size() != vTimes.size() * iValuesPerKey * iComponentCount) [[unlikely]] {
+        return Error(std::format(
+            "animation sampler has {} values for {} keys", vValues.size() / iComponentCount, vTimes.size()));
+    }
+
+    vKeys.reserve(vKeys.size() + vTimes.size() * (bIsStep ? 2 : 1));
+    for (size_t iKey = 0; iKey < vTimes.size(); iKey++) {
+        const float time = vTimes[iKey];
+
+        if (bIsStep && iKey > 0) {
+            // Emulate step interpolation by holding the previous value until right before this key.
+            const float previousTime = vTimes[iKey - 1];
+            const float holdTime = std::nextafter(time, previousTime);
+            if (holdTime > previousTime) {
+                const size_t iPreviousValue = ((iKey - 1) * iValuesPerKey + iValueOffset) * iComponentCount;
+                vKeys.push_back(KeyType{holdTime, makeValue(&vValues[iPreviousValue])});
+            }
+        }
+
+        vKeys.push_back(
+            KeyType{time, makeValue(&vValues[(iKey * iValuesPerKey + iValueOffset) * iComponentCount])});
+    }
+
+    return {};
+}
+
+/**
+ * Builds a runtime animation from a GLTF animation.
+ *
+ * @param model              GLTF model.
+ * @param gltfAnimation      Animation to build.
+ * @param skin               Skin of the model.
+ * @param vJointIndexPerNode Result of @ref getGltfJointIndexPerNode.
+ * @param skeleton           Skeleton built from the skin.
+ * @param options            Import options.
+ *
+ * @return Error if something went wrong, otherwise built animation.
+ */
+inline std::variant<Error, ozz::unique_ptr<ozz::animation::Animation>> buildGltfAnimation(
+    const tinygltf::Model& model,
+    const tinygltf::Animation& gltfAnimation,
+    const tinygltf::Skin& skin,
+    const std::vector<int>& vJointIndexPerNode,
+    const ozz::animation::Skeleton& skeleton,
+    const GltfImportOptions& options) {
+    ozz::animation::offline::RawAnimation rawAnimation;
+    rawAnimation.name = gltfAnimation.name;
+    rawAnimation.tracks.resize(skin.joints.size());
+
+    const auto makeFloat3 = [](const float* pValue) {
+        return ozz::math::Float3(pValue[0], pValue[1], pValue[2]);
+    };
+    const auto makeQuaternion = [](const float* pValue) {
+        return ozz::math::Normalize(ozz::math::Quaternion(pValue[0], pValue[1], pValue[2], pValue[3]));
+    };
+
+    float duration = 0.0f;
+    for (const auto& channel : gltfAnimation.channels) {
+        if (channel.target_node < 0 || static_cast<size_t>(channel.target_node) >= model.nodes.size())
+            [[unlikely]] {
+            return Error(std::format("animation channel references invalid node {}", channel.target_node));
+        }
+
+        const auto iJointIndex = vJointIndexPerNode[static_cast<size_t>(channel.target_node)];
+        if (iJointIndex == -1) {
+            // Animates a node that is not a bone.
+            continue;
+        }
+
+        size_t iComponentCount = 0;
+        if (channel.target_path == "translation" || channel.target_path == "scale") {
+            iComponentCount = 3;
+        } else if (channel.target_path == "rotation") {
+            iComponentCount = 4;
+        } else {
+            // Morph target weights are not supported.
+            continue;
+        }
+
+        if (channel.sampler < 0 || static_cast<size_t>(channel.sampler) >= gltfAnimation.samplers.size())
+            [[unlikely]] {
+            return Error(std::format("animation channel references invalid sampler {}", channel.sampler));
+        }
+        const auto& sampler = gltfAnimation.samplers[static_cast<size_t>(channel.sampler)];
+
+        // Read keys.
+        auto timesResult = readGltfAccessorFloats(model, sampler.input, 1);
+        if (std::holds_alternative<Error>(timesResult)) [[unlikely]] {
+            auto error = std::get<Error>(std::move(timesResult));
+            error.addCurrentLocationToErrorStack();
+            return error;
+        }
+        const auto vTimes = std::get<std::vector<float>>(std::move(timesResult));
+
+        auto valuesResult = readGltfAccessorFloats(model, sampler.output, iComponentCount);
+        if (std::holds_alternative<Error>(valuesResult)) [[unlikely]] {
+            auto error = std::get<Error>(std::move(valuesResult));
+            error.addCurrentLocationToErrorStack();
+            return error;
+        }
+        const auto vValues = std::get<std::vector<float>>(std::move(valuesResult));
+
+        if (!vTimes.empty()) {
+            duration = std::max(duration, vTimes.back());
+        }
+
+        // Add keys.
+        auto& track = rawAnimation.tracks[static_cast<size_t>(iJointIndex)];
+        std::optional<Error> optionalError;
+        if (channel.target_path == "translation") {
+            optionalError = addGltfAnimationKeys(
+                vTimes, vValues, iComponentCount, sampler.interpolation, makeFloat3, track.translations);
+        } else if (channel.target_path == "rotation") {
+            optionalError = addGltfAnimationKeys(
+                vTimes, vValues, iComponentCount, sampler.interpolation, makeQuaternion, track.rotations);
+        } else {
+            optionalError = addGltfAnimationKeys(
+                vTimes, vValues, iComponentCount, sampler.interpolation, makeFloat3, track.scales);
+        }
+        if (optionalError.has_value()) [[unlikely]] {
+            optionalError->addCurrentLocationToErrorStack();
+            return std::move(optionalError.value());
+        }
+    }
+
+    // Bones that are not animated keep their rest pose.
+    for (size_t iJoint = 0; iJoint < rawAnimation.tracks.size(); iJoint++) {
+        auto& track = rawAnimation.tracks[iJoint];
+        const auto restPose =
+            getGltfNodeLocalTransform(model.nodes[static_cast<size_t>(skin.joints[iJoint])]);
+
+        if (track.translations.empty()) {
+            track.translations.push_back({0.0f, restPose.translation});
+        }
+        if (track.rotations.empty()) {
+            track.rotations.push_back({0.0f, restPose.rotation});
+        }
+        if (track.scales.empty()) {
+            track.scales.push_back({0.0f, restPose.scale});
+        }
+    }
+
+    rawAnimation.duration = std::max(duration, minAnimationDuration);
+    if (!rawAnimation.Validate()) [[unlikely]] {
+        return Error(std::format(
+            "animation \"{}\" is invalid (make sure key times are positive and sorted)", gltfAnimation.name));
+    }
+
+    // Remove keys that can be interpolated from neighbour keys.
+    if (options.animationOptimizationTolerance > 0.0f) {
+        ozz::animation::offline::AnimationOptimizer optimizer;
+        optimizer.setting.tolerance = options.animationOptimizationTolerance;
+        optimizer.setting.distance = options.animationOptimizationDistance;
+
+        ozz::animation::offline::RawAnimation optimizedAnimation;
+        if (!optimizer(rawAnimation, skeleton, &optimizedAnimation)) [[unlikely]] {
+            return Error(std::format("failed to optimize animation \"{}\"", gltfAnimation.name));
+        }
+        rawAnimation = std::move(optimizedAnimation);
+    }
+
+    // Build runtime animation.
+    ozz::animation::offline::AnimationBuilder animationBuilder;
+    auto pAnimation = animationBuilder(rawAnimation);
+    if (pAnimation == nullptr) [[unlikely]] {
+        return Error(std::format("failed to build animation \"{}\"", gltfAnimation.name));
+    }
+
+    return pAnimation;
+}
+
+/**
+ * Serializes an ozz object (such as skeleton or animation) to a file.
+ *
+ * @param object     Object to serialize.
+ * @param pathToFile Path to the resulting file.
+ *
+ * @return Error if something went wrong.
+ */
+template <typename T>
+inline std::optional<Error> writeOzzFile(const T& object, const std::filesystem::path& pathToFile) {
+    // Serialize to memory first because ozz file streams don't report write errors.
+    ozz::io::MemoryStream memoryStream;
+    {
+        ozz::io::OArchive archive(&memoryStream);
+        archive << object;
+    }
+    std::vector<char> vData(memoryStream.Size());
+    memoryStream.Seek(0, ozz::io::Stream::kSet);
+    if (memoryStream.Read(vData.data(), vData.size()) != vData.size()) [[unlikely]] {
+        return Error(std::format("failed to serialize ozz object for the file \"{}\"", pathToFile.string()));
+    }
+
+    std::ofstream file(pathToFile, std::ios::binary);
+    if (!file.is_open()) [[unlikely]] {
+        return Error(std::format("unable to create the file \"{}\"", pathToFile.string()));
+    }
+    file.write(vData.data(), static_cast<std::streamsize>(vData.size()));
+    file.close();
+    if (file.fail()) [[unlikely]] {
+        return Error(std::format("failed to write the file \"{}\"", pathToFile.string()));
+    }
+
+    return {};
+}
+
+/**
+ * Builds skeleton and animations from the GLTF skin and writes them to the specified directory
+ * (along with inverse bind pose matrices).
+ *
+ * @param model           GLTF model.
+ * @param skin            Skin of the model.
+ * @param options         Import options.
+ * @param pathToOutputDir Directory to write results to (must exist).
+ * @param onProgress      Callback to report import stage.
+ *
+ * @return Error if something went wrong.
+ */
+inline std::optional<Error> importGltfSkeletonAndAnimations(
+    const tinygltf::Model& model,
+    const tinygltf::Skin& skin,
+    const GltfImportOptions& options,
+    const std::filesystem::path& pathToOutputDir,
+    const std::function<void(std::string_view)>& onProgress) {
+    PROFILE_FUNC
+
+    // Read inverse bind pose matrices.
+    if (skin.inverseBindMatrices < 0 ||
+        static_cast<size_t>(skin.inverseBindMatrices) >= model.accessors.size()) [[unlikely]] {
+        return Error("expected the skin to have inverse bind pose matrices");
+    }
+    std::vector<glm::mat4x4> vInverseBindPoseMatrices;
+    const auto& accessor = model.accessors[static_cast<size_t>(skin.inverseBindMatrices)];
+    const auto& bufferView = model.bufferViews[static_cast<size_t>(accessor.bufferView)];
+    const auto& buffer = model.buffers[static_cast<size_t>(bufferView.buffer)];
+    const size_t byteOffset = bufferView.byteOffset + accessor.byteOffset;
+    if (accessor.type != TINYGLTF_TYPE_MAT4 || accessor.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT)
+        [[unlikely]] {
+        return Error(std::format(
+            "expected inverse bind pose matrices to be stored as `mat4`, actual type: {}", accessor.type));
+    }
+
+    const float* matrixData = reinterpret_cast<const float*>(&buffer.data[byteOffset]);
+    vInverseBindPoseMatrices.resize(accessor.count);
+    for (size_t i = 0; i < accessor.count; ++i) {
+        const float* floats = &matrixData[i * 16];
+
+        for (int col = 0; col < 4; col++) {
+            for (int row = 0; row < 4; row++) {
+                vInverseBindPoseMatrices[i][col][row] = floats[row * 4 + col];
+            }
+        }
+    }
+
+    // Build skeleton.
+    onProgress("building skeleton");
+    auto jointIndexResult = getGltfJointIndexPerNode(model, skin);
+    if (std::holds_alternative<Error>(jointIndexResult)) [[unlikely]] {
+        auto error = std::get<Error>(std::move(jointIndexResult));
+        error.addCurrentLocationToErrorStack();
+        return error;
+    }
+    const auto vJointIndexPerNode = std::get<std::vector<int>>(std::move(jointIndexResult));
+
+    auto skeletonResult = buildGltfSkeleton(model, skin, vJointIndexPerNode);
+    if (std::holds_alternative<Error>(skeletonResult)) [[unlikely]] {
+        auto error = std::get<Error>(std::move(skeletonResult));
+        error.addCurrentLocationToErrorStack();
+        return error;
+    }
+    const auto pSkeleton = std::get<ozz::unique_ptr<ozz::animation::Skeleton>>(std::move(skeletonResult));
+
+    // Check bone count.
+    onProgress(std::format(
+        "for future reference note that allowed bone limit is {}", SkeletonNode::getMaxBoneCountAllowed()));
+    if (static_cast<unsigned int>(pSkeleton->num_joints()) > SkeletonNode::getMaxBoneCountAllowed()) {
+        return Error(std::format(
+            "skeleton bone count {} exceeds allowed limit of {} bones",
+            pSkeleton->num_joints(),
+            SkeletonNode::getMaxBoneCountAllowed()));
+    }
+    onProgress(std::format("imported skeleton has {} bones", pSkeleton->num_joints()));
+
+    // Check inverse bind pose matrices.
+    if (vInverseBindPoseMatrices.size() != static_cast<size_t>(pSkeleton->num_joints())) [[unlikely]] {
+        return Error(std::format(
+            "skeleton bone count {} don't not match inverse bind pose matrix count {}",
+            pSkeleton->num_joints(),
+            vInverseBindPoseMatrices.size()));
+    }
+
+    auto optionalError = writeOzzFile(*pSkeleton, pathToOutputDir / sSkeletonFileName);
+    if (optionalError.has_value()) [[unlikely]] {
+        optionalError->addCurrentLocationToErrorStack();
+        return optionalError;
+    }
+
+    // Build animations.
+    if (model.animations.empty()) {
+        onProgress("no animations found");
+    }
+    std::unordered_set<std::string> usedFileNames = {std::string(sSkeletonFileName)};
+    for (size_t iAnimation = 0; iAnimation < model.animations.size(); iAnimation++) {
+        const auto& gltfAnimation = model.animations[iAnimation];
+        onProgress(std::format(
+            "building animation {}/{} \"{}\"", iAnimation + 1, model.animations.size(), gltfAnimation.name));
+
+        auto animationResult =
+            buildGltfAnimation(model, gltfAnimation, skin, vJointIndexPerNode, *pSkeleton, options);
+        if (std::holds_alternative<Error>(animationResult)) [[unlikely]] {
+            auto error = std::get<Error>(std::move(animationResult));
+            error.addCurrentLocationToErrorStack();
+            return error;
+        }
+        const auto pAnimation =
+            std::get<ozz::unique_ptr<ozz::animation::Animation>>(std::move(animationResult));
+
+        // Pick a file name.
+        std::string sFileName =
+            gltfAnimation.name.empty() ? std::format("animation{}", iAnimation) : gltfAnimation.name;
+        for (auto& character : sFileName) {
+            if (std::isalnum(static_cast<unsigned char>(character)) == 0 && character != '_' &&
+                character != '-') {
+                character = '_';
+            }
+        }
+        sFileName += ".ozz";
+        if (usedFileNames.contains(sFileName)) {
+            sFileName = std::format("{}_{}.ozz", sFileName.substr(0, sFileName.size() - 4), iAnimation);
+        }
+        usedFileNames.insert(sFileName);
+
+        optionalError = writeOzzFile(*pAnimation, pathToOutputDir / sFileName);
+        if (optionalError.has_value()) [[unlikely]] {
+            optionalError->addCurrentLocationToErrorStack();
+            return optionalError;
+        }
+    }
+
+    // Save inverse bind pose matrices.
+    const auto pathToInverseBindPose =
+        pathToOutputDir / ("skeletonInverseBindPose." + std::string(Serializable::getBinaryFileExtension()));
+
+    std::ofstream file(pathToInverseBindPose.c_str(), std::ios::binary);
+    if (!file.is_open()) [[unlikely]] {
+        return Error(std::format("unable to create the file \"{}\"", pathToInverseBindPose.string().c_str()));
+    }
+
+    unsigned int iMatrixCount = static_cast<unsigned int>(vInverseBindPoseMatrices.size());
+    file.write(reinterpret_cast<char*>(&iMatrixCount), sizeof(iMatrixCount));
+    for (const auto& matrix : vInverseBindPoseMatrices) {
+        file.write(reinterpret_cast<const char*>(glm::value_ptr(matrix)), sizeof(matrix));
+    }
+    file.close();
+    if (file.fail()) [[unlikely]] {
+        return Error(std::format("failed to write the file \"{}\"", pathToInverseBindPose.string()));
+    }
+
+    return {};
+}
+
 std::optional<Error> GltfImporter::importFileAsNodeTree(
     const std::filesystem::path& pathToFile,
     const std::string& sPathToOutputDirRelativeRes,
     const std::string& sOutputDirectoryName,
-    const std::function<void(std::string_view)>& onProgress) {
+    const std::function<void(std::string_view)>& onProgress,
+    const GltfImportOptions& options) {
     // Make sure the file has ".GLTF" or ".GLB" extension.
     if (pathToFile.extension() != ".GLTF" && pathToFile.extension() != ".gltf" &&
         pathToFile.extension() != ".GLB" && pathToFile.extension() != ".glb") [[unlikely]] {
@@ -697,15 +1537,8 @@ std::optional<Error> GltfImporter::importFileAsNodeTree(
     // Get default scene.
     const auto& scene = model.scenes[static_cast<size_t>(model.defaultScene)];
 
-    // Create a scene root node to hold all GLTF nodes of the scene.
-    auto pSceneRootNode = std::make_unique<Node>("Scene Root");
-
-    // Prepare variable for processed nodes.
-    size_t iTotalNodeProcessedCount = 0;
-
-    // Now process GLTF nodes.
+    // Make sure root node indices are valid.
     for (const auto& iNode : scene.nodes) {
-        // Make sure this node index is valid.
         if (iNode < 0) [[unlikely]] {
             return Error(std::format("found a negative node index of {} in default scene", iNode));
         }
@@ -715,251 +1548,286 @@ std::optional<Error> GltfImporter::importFileAsNodeTree(
                 iNode,
                 model.nodes.size()));
         }
-
-        // Process node.
-        auto optionalError = processGltfNode(
-            model.nodes[static_cast<size_t>(iNode)],
-            model,
-            pathToFile,
-            pathToOutputFile,
-            std::format("{}/{}", sPathToOutputDirRelativeRes, sOutputDirectoryName),
-            pSceneRootNode.get(),
-            onProgress,
-            iTotalNodeProcessedCount,
-            scene.nodes.size());
-        if (optionalError.has_value()) [[unlikely]] {
-            optionalError->addCurrentLocationToErrorStack();
-            return optionalError;
-        }
     }
 
-    // Mark progress.
-    onProgress("serializing resulting node tree");
-
-    if (pSceneRootNode->mtxChildNodes.second.size() == 1 &&
-        pSceneRootNode->mtxChildNodes.second[0]->getChildNodes().second.empty()) {
-        // Only 1 node was imported, remove our scene root node since there's no need for it.
-        auto pNewRoot = std::move(pSceneRootNode->mtxChildNodes.second[0]);
-        pSceneRootNode->mtxChildNodes.second.clear();
-
-        pSceneRootNode = std::move(pNewRoot);
+    // Collect GLTF nodes with meshes.
+    std::vector<GltfMeshImportTask> vMeshTasks;
+    for (const auto& iNode : scene.nodes) {
+        collectGltfMeshImportTasks(model.nodes[static_cast<size_t>(iNode)], model, vMeshTasks);
     }
 
-    // Serialize scene node tree.
-    auto optionalError = pSceneRootNode->serializeNodeTree(pathToOutputFile, false);
-    if (optionalError.has_value()) [[unlikely]] {
-        optionalError->addCurrentLocationToErrorStack();
-        return optionalError;
+    // Collect used images.
+    std::vector<bool> vIsImageUsed(model.images.size(), false);
+    for (const auto& task : vMeshTasks) {
+        for (const auto& primitive : model.meshes[static_cast<size_t>(task.pNode->mesh)].primitives) {
+            if (primitive.material < 0) {
+                continue;
+            }
+            const auto& material = model.materials[static_cast<size_t>(primitive.material)];
+            const auto iDiffuseTextureIndex = material.pbrMetallicRoughness.baseColorTexture.index;
+            if (iDiffuseTextureIndex < 0) {
+                continue;
+            }
+            const auto iImageIndex = model.textures[static_cast<size_t>(iDiffuseTextureIndex)].source;
+            if (iImageIndex >= 0) {
+                vIsImageUsed[static_cast<size_t>(iImageIndex)] = true;
+            }
+        }
     }
 
-    onProgress("checking for skeleton/animations to import...");
+    // Prepare textures directory and names of texture files.
+    const std::filesystem::path pathToTexturesDir =
+        pathToOutputDirectory / (pathToOutputFile.stem().string() + std::string(sTexturesDirNameSuffix));
+    std::vector<std::string> vTextureFileNames(model.images.size());
+    std::vector<size_t> vImagesToWrite;
+    for (size_t i = 0; i < model.images.size(); i++) {
+        if (!vIsImageUsed[i]) {
+            continue;
+        }
+        vTextureFileNames[i] = getGltfTextureFileName(pathToFile, model.images[i], i);
+        if (vTextureFileNames[i].empty()) {
+            continue;
+        }
 
-    if (model.skins.empty()) {
-        onProgress("no skeleton/animations found");
-        return {};
+        // Multiple images may reference the same file.
+        const auto it = std::find_if(vImagesToWrite.begin(), vImagesToWrite.end(), [&](size_t iImage) {
+            return vTextureFileNames[iImage] == vTextureFileNames[i];
+        });
+        if (it == vImagesToWrite.end()) {
+            vImagesToWrite.push_back(i);
+        }
     }
-
-    // Read skinning info.
-    std::vector<glm::mat4x4> vInverseBindPoseMatrices;
-    if (model.skins.size() > 1) [[unlikely]] {
-        return Error(std::format("found multiple ({}) skins while expected only 1", model.skins.size()));
+    if (!vImagesToWrite.empty()) {
+        std::filesystem::create_directory(pathToTexturesDir);
     }
 
-    const auto& skin = model.skins[0];
-    const auto& accessor = model.accessors[static_cast<size_t>(skin.inverseBindMatrices)];
-    const auto& bufferView = model.bufferViews[static_cast<size_t>(accessor.bufferView)];
-    const auto& buffer = model.buffers[static_cast<size_t>(bufferView.buffer)];
-    const size_t byteOffset = bufferView.byteOffset + accessor.byteOffset;
-    if (accessor.type != TINYGLTF_TYPE_MAT4 || accessor.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT)
-        [[unlikely]] {
-        return Error(std::format(
-            "expected inverse bind pose matrices to be stored as `mat4`, actual type: {}", accessor.type));
-    }
+    // Progress callback is not expected to be thread-safe.
+    std::mutex mtxProgress;
+    const std::function<void(std::string_view)> onProgressSynchronized = [&](std::string_view sText) {
+        std::scoped_lock guard(mtxProgress);
+        onProgress(sText);
+    };
+
+    // Convert meshes and write textures on worker threads, results are stored per task
+    // so the node tree is assembled in the same order as in a serial import.
+    std::vector<unsigned char> vIsImageWritten(model.images.size(), 0); // not `bool` to write in parallel
+    std::pair<std::mutex, std::optional<Error>> mtxFirstTaskError;
+    {
+        std::latch tasksLeft(static_cast<std::ptrdiff_t>(vMeshTasks.size() + vImagesToWrite.size()));
+        ThreadPool threadPool(options.iWorkerThreadCount);
+
+        // Exceptions must not escape a task: the latch would never reach zero.
+        const auto storeTaskError = [&](std::string_view sTaskDescription, std::string_view sReason) {
+            std::scoped_lock guard(mtxFirstTaskError.first);
+            if (!mtxFirstTaskError.second.has_value()) {
+                mtxFirstTaskError.second = Error(std::format("{} failed: {}", sTaskDescription, sReason));
+            }
+        };
+
+        for (const auto iImageIndex : vImagesToWrite) {
+            threadPool.addTask([&, iImageIndex]() {
+                PROFILE_SCOPE("write GLTF texture")
+
+                try {
+                    vIsImageWritten[iImageIndex] = writeGltfTextureToDisk(
+                        pathToFile,
+                        model.images[iImageIndex],
+                        pathToTexturesDir,
+                        vTextureFileNames[iImageIndex]);
+                    onProgressSynchronized(
+                        std::format("written texture \"{}\"", vTextureFileNames[iImageIndex]));
+                } catch (const std::exception& exception) {
+                    storeTaskError(
+                        std::format("writing GLTF texture \"{}\"", vTextureFileNames[iImageIndex]),
+                        exception.what());
+                } catch (...) {
+                    storeTaskError(
+                        std::format("writing GLTF texture \"{}\"", vTextureFileNames[iImageIndex]),
+                        "unknown exception");
+                }
 
-    const float* matrixData = reinterpret_cast<const float*>(&buffer.data[byteOffset]);
-    vInverseBindPoseMatrices.resize(accessor.count);
-    for (size_t i = 0; i < accessor.count; ++i) {
-        const float* floats = &matrixData[i * 16];
+                tasksLeft.count_down();
+            });
+        }
 
-        for (int col = 0; col < 4; col++) {
-            for (int row = 0; row < 4; row++) {
-                vInverseBindPoseMatrices[i][col][row] = floats[row * 4 + col];
-            }
+        for (size_t iTask = 0; iTask < vMeshTasks.size(); iTask++) {
+            threadPool.addTask([&, iTask]() {
+                PROFILE_SCOPE("process GLTF mesh")
+
+                auto& task = vMeshTasks[iTask];
+                try {
+                    task.optResult = processGltfMesh(
+                        model,
+                        *task.pNode,
+                        model.meshes[static_cast<size_t>(task.pNode->mesh)],
+                        pathToTexturesDir,
+                        vTextureFileNames,
+                        options,
+                        onProgressSynchronized,
+                        iTask + 1,
+                        vMeshTasks.size());
+
+                    // Write geometry here instead of writing it while serializing the node tree.
+                    if (std::holds_alternative<std::vector<std::unique_ptr<MeshNode>>>(*task.optResult)) {
+                        const auto& vMeshNodes =
+                            std::get<std::vector<std::unique_ptr<MeshNode>>>(*task.optResult);
+                        for (size_t iMeshNode = 0; iMeshNode < vMeshNodes.size(); iMeshNode++) {
+                            auto optionalError = vMeshNodes[iMeshNode]->serializeGeometry(
+                                pathToOutputFile, getGltfMeshGeometryStagingId(iTask, iMeshNode));
+                            if (optionalError.has_value()) [[unlikely]] {
+                                optionalError->addCurrentLocationToErrorStack();
+                                task.optResult = std::move(*optionalError);
+                                break;
+                            }
+                        }
+                    }
+                } catch (const std::exception& exception) {
+                    storeTaskError(
+                        std::format("processing GLTF mesh \"{}\"", task.pNode->name), exception.what());
+                } catch (...) {
+                    storeTaskError(
+                        std::format("processing GLTF mesh \"{}\"", task.pNode->name), "unknown exception");
+                }
+
+                tasksLeft.count_down();
+            });
         }
-    }
 
-#ifndef GLTF2OZZ_BIN_PATH
-    static_assert(false, "need path to gltf2ozz for importing animations");
-#endif
-    std::filesystem::path pathToGltf2Ozz = GLTF2OZZ_BIN_PATH;
-    if (!std::filesystem::exists(pathToGltf2Ozz)) [[unlikely]] {
-        return Error(std::format("expected the path to exist \"{}\"", pathToGltf2Ozz.string()));
+        tasksLeft.wait();
+    }
+    if (mtxFirstTaskError.second.has_value()) [[unlikely]] {
+        auto error = std::move(*mtxFirstTaskError.second);
+        error.addCurrentLocationToErrorStack();
+        return error;
     }
 
-    // gltf2ozz will be invoked from the command line and will produce results in the working directory.
-    const auto pathToWorkingDirectory = Globals::getProcessWorkingDirectory();
-
-    // Clear any existing (old) .ozz files.
-    for (const auto& entry : std::filesystem::directory_iterator(pathToWorkingDirectory)) {
-        if (entry.is_directory()) {
+    // Remember which geometry files belong to which mesh nodes.
+    std::unordered_map<const Serializable*, std::string> geometryStagingIds;
+    for (size_t iTask = 0; iTask < vMeshTasks.size(); iTask++) {
+        const auto& result = *vMeshTasks[iTask].optResult;
+        if (!std::holds_alternative<std::vector<std::unique_ptr<MeshNode>>>(result)) {
             continue;
         }
-        if (entry.path().extension() != ".ozz") {
-            continue;
+        const auto& vMeshNodes = std::get<std::vector<std::unique_ptr<MeshNode>>>(result);
+        for (size_t iMeshNode = 0; iMeshNode < vMeshNodes.size(); iMeshNode++) {
+            geometryStagingIds[vMeshNodes[iMeshNode].get()] = getGltfMeshGeometryStagingId(iTask, iMeshNode);
         }
-        std::filesystem::remove(entry.path());
     }
 
-    // Run gltf2ozz.
-    const std::string sPathToGltf2Ozz = pathToGltf2Ozz.string();
-    const std::string sArgPathToGltfFile = std::format("--file={}", pathToFile.string());
-    std::array<const char*, 3> vCommandLine = {sPathToGltf2Ozz.c_str(), sArgPathToGltfFile.c_str(), NULL};
-    struct subprocess_s subprocess;
-    int iSubprocessOpResult = subprocess_create(vCommandLine.data(), 0, &subprocess);
-    if (iSubprocessOpResult != 0) [[unlikely]] {
-        return Error(std::format(
-            "failed to start subprocess for \"{}\", error code: {}", sPathToGltf2Ozz, iSubprocessOpResult));
+    // Assemble node tree.
+    auto pSceneRootNode = std::make_unique<Node>("Scene Root");
+    size_t iNextTaskIndex = 0;
+    for (const auto& iNode : scene.nodes) {
+        auto optionalError = attachGltfNode(
+            model.nodes[static_cast<size_t>(iNode)], model, pSceneRootNode.get(), vMeshTasks, iNextTaskIndex);
+        if (optionalError.has_value()) [[unlikely]] {
+            optionalError->addCurrentLocationToErrorStack();
+            return optionalError;
+        }
     }
 
-    // Wait for it to finish.
-    int iProcessReturnCode = 0;
-    iSubprocessOpResult = subprocess_join(&subprocess, &iProcessReturnCode);
-    if (iSubprocessOpResult != 0) [[unlikely]] {
-        return Error(std::format(
-            "failed to wait for subprocess \"{}\", error code: {}", sPathToGltf2Ozz, iSubprocessOpResult));
+    // Make sure all textures were written.
+    for (const auto iImageIndex : vImagesToWrite) {
+        if (vIsImageWritten[iImageIndex] == 0) [[unlikely]] {
+            return Error(std::format("failed to import GLTF image \"{}\"", vTextureFileNames[iImageIndex]));
+        }
     }
 
-    // Destroy subprocess object.
-    iSubprocessOpResult = subprocess_destroy(&subprocess);
-    if (iSubprocessOpResult != 0) [[unlikely]] {
-        return Error(std::format(
-            "failed to destroy subprocess object \"{}\", error code: {}",
-            sPathToGltf2Ozz,
-            iSubprocessOpResult));
-    }
+    // Mark progress.
+    onProgress("serializing resulting node tree");
 
-    if (iProcessReturnCode != 0) {
-        // Delete any imported files.
-        for (const auto& entry : std::filesystem::directory_iterator(pathToWorkingDirectory)) {
-            if (entry.is_directory()) {
-                continue;
-            }
-            if (entry.path().extension() != ".ozz") {
-                continue;
-            }
-            std::filesystem::remove(entry.path());
-        }
-        return Error(std::format(
-            "failed to check for/import animations, gltf2ozz returned: {}, make sure the path is correct and "
-            "has no spaces or special characters \"{}\"",
-            iProcessReturnCode,
-            pathToFile.string()));
+    if (pSceneRootNode->mtxChildNodes.second.size() == 1 &&
+        pSceneRootNode->mtxChildNodes.second[0]->getChildNodes().second.empty()) {
+        // Only 1 node was imported, remove our scene root node since there's no need for it.
+        auto pNewRoot = std::move(pSceneRootNode->mtxChildNodes.second[0]);
+        pSceneRootNode->mtxChildNodes.second.clear();
+
+        pSceneRootNode = std::move(pNewRoot);
     }
 
-    // See if any new .ozz files were created.
-    std::vector<std::filesystem::path> vPathsToOzzFiles;
-    for (const auto& entry : std::filesystem::directory_iterator(pathToWorkingDirectory)) {
-        if (entry.is_directory()) {
-            continue;
+    // Rename geometry files written by mesh tasks to use IDs of the serialized node tree.
+    {
+        size_t iId = 0;
+        auto result = pSceneRootNode->getInformationForSerialization(pathToOutputFile, iId, {});
+        if (std::holds_alternative<Error>(result)) [[unlikely]] {
+            auto error = std::get<Error>(std::move(result));
+            error.addCurrentLocationToErrorStack();
+            return error;
         }
-        if (entry.path().extension() != ".ozz") {
-            continue;
+        const auto vNodesInfo =
+            std::get<std::vector<Node::SerializableObjectInformationWithUniquePtr>>(std::move(result));
+
+        std::unordered_map<std::string, std::string> stagingIdToNodeId;
+        for (const auto& nodeInfo : vNodesInfo) {
+            const auto it = geometryStagingIds.find(nodeInfo.info.pObject);
+            if (it != geometryStagingIds.end()) {
+                stagingIdToNodeId[it->second] = nodeInfo.info.sObjectUniqueId;
+            }
         }
-        vPathsToOzzFiles.push_back(entry.path());
-    }
 
-    if (!vPathsToOzzFiles.empty()) {
-        if (vPathsToOzzFiles.size() == 1 && vPathsToOzzFiles[0].filename() == "skeleton.ozz") {
-            // Only skeleton was imported (no animations).
-            // If gltf scene has no skeleton and animations gltf2ozz considers the whole scene as a skeleton
-            // (which is not what we want) so in this case we think that there is no skeleton/animations to
-            // import.
-            std::filesystem::remove(vPathsToOzzFiles[0]);
-            onProgress("no animations found");
-        } else {
-            // Move new .ozz files into the imported directory.
-            const auto pathToAnimDir = pathToOutputDirectory / (pathToFile.stem().string() + "_anim");
-            std::filesystem::create_directory(pathToAnimDir);
-
-            std::string sFullPathToSkeletonFile;
-            for (const auto& pathToOzzFile : vPathsToOzzFiles) {
-                const auto newPath = pathToAnimDir / pathToOzzFile.filename();
-                if (newPath.filename().string() == "skeleton.ozz") {
-                    sFullPathToSkeletonFile = newPath.string();
-                }
-                std::filesystem::rename(pathToOzzFile, newPath);
+        const auto pathToGeoDir =
+            pathToOutputDirectory /
+            (pathToOutputFile.stem().string() + std::string(Serializable::getNodeTreeGeometryDirSuffix()));
+        if (std::filesystem::exists(pathToGeoDir)) {
+            // Collect paths first because the directory is modified while renaming.
+            std::vector<std::filesystem::path> vGeometryFiles;
+            for (const auto& entry : std::filesystem::directory_iterator(pathToGeoDir)) {
+                vGeometryFiles.push_back(entry.path());
             }
-            onProgress(std::format("found animations to import", vPathsToOzzFiles.size()));
 
-            // Do a few checks to make sure imported skeleton is valid.
-            if (sFullPathToSkeletonFile.empty()) [[unlikely]] {
-                return Error("expected to find a skeleton file to check bone count limit");
+            for (const auto& pathToGeometryFile : vGeometryFiles) {
+                // File names are "<entity ID>.<variable name>.<extension>".
+                const auto sFileName = pathToGeometryFile.filename().string();
+                const auto iIdEnd = sFileName.find('.');
+                const auto it = stagingIdToNodeId.find(sFileName.substr(0, iIdEnd));
+                if (iIdEnd == std::string::npos || it == stagingIdToNodeId.end()) [[unlikely]] {
+                    return Error(std::format("unexpected geometry file \"{}\"", sFileName));
+                }
+                std::filesystem::rename(
+                    pathToGeometryFile, pathToGeoDir / (it->second + sFileName.substr(iIdEnd)));
             }
+        }
+    }
 
-            // Open file.
-            ozz::io::File skeletonFile(sFullPathToSkeletonFile.c_str(), "rb");
-            if (!skeletonFile.opened()) [[unlikely]] {
-                return Error(std::format("unable to open the skeleton file \"{}\"", sFullPathToSkeletonFile));
-            }
-            ozz::io::IArchive skeletonArchive(&skeletonFile);
-            if (!skeletonArchive.TestTag<ozz::animation::Skeleton>()) [[unlikely]] {
-                return Error(std::format(
-                    "the skeleton file does not seem to store a skeleton \"{}\"", sFullPathToSkeletonFile));
-            }
-            auto pSkeleton = std::make_unique<ozz::animation::Skeleton>();
-            skeletonArchive >> *pSkeleton;
+    // Serialize scene node tree (geometry files are already written).
+    auto optionalError = pSceneRootNode->serializeNodeTree(pathToOutputFile, false, true);
+    if (optionalError.has_value()) [[unlikely]] {
+        optionalError->addCurrentLocationToErrorStack();
+        return optionalError;
+    }
 
-            // Check bone count.
-            if (static_cast<unsigned int>(pSkeleton->num_joints()) > SkeletonNode::getMaxBoneCountAllowed()) {
-                return Error(std::format(
-                    "skeleton bone count {} exceeds allowed limit of {} bones",
-                    pSkeleton->num_joints(),
-                    SkeletonNode::getMaxBoneCountAllowed()));
-            }
-            onProgress(std::format("imported skeleton has {} bones", pSkeleton->num_joints()));
-            bool bArmatureAsBoneFound = false;
-            for (const auto pName : pSkeleton->joint_names()) {
-                if (std::string_view(pName) == "Armature") [[unlikely]] {
-                    bArmatureAsBoneFound = true;
-                }
-            }
-            onProgress(std::format(
-                "for future reference note that allowed bone limit is {}",
-                SkeletonNode::getMaxBoneCountAllowed()));
-            if (bArmatureAsBoneFound) {
-                return Error(std::format(
-                    "found bone named \"Armature\" imported by gltf2ozz, Armature should not be imported "
-                    "as a bone which means gltf2ozz has a bug that imports non-skin bones"));
-            }
+    onProgress("checking for skeleton/animations to import...");
 
-            // Check inverse bind pose matrices.
-            if (vInverseBindPoseMatrices.size() != static_cast<size_t>(pSkeleton->num_joints()))
-                [[unlikely]] {
-                return Error(std::format(
-                    "skeleton bone count {} don't not match inverse bind pose matrix count {}",
-                    pSkeleton->num_joints(),
-                    vInverseBindPoseMatrices.size()));
-            }
+    if (model.skins.empty()) {
+        onProgress("no skeleton/animations found");
+        return {};
+    }
 
-            // Save inverse bind pose matrices.
-            const auto pathToInverseBindPose =
-                std::filesystem::path(sFullPathToSkeletonFile).parent_path() /
-                ("skeletonInverseBindPose." + std::string(Serializable::getBinaryFileExtension()));
+    if (model.skins.size() > 1) [[unlikely]] {
+        return Error(std::format("found multiple ({}) skins while expected only 1", model.skins.size()));
+    }
 
-            std::ofstream file(pathToInverseBindPose.c_str(), std::ios::binary);
-            if (!file.is_open()) [[unlikely]] {
-                return Error(
-                    std::format("unable to create the file \"{}\"", pathToInverseBindPose.string().c_str()));
-            }
+    // Import into a temporary directory so that a failed import does not leave partial results.
+    const auto pathToAnimDir = pathToOutputDirectory / (pathToFile.stem().string() + "_anim");
+    const auto pathToTempAnimDir = pathToOutputDirectory / (pathToFile.stem().string() + "_anim_tmp");
+    if (std::filesystem::exists(pathToTempAnimDir)) {
+        std::filesystem::remove_all(pathToTempAnimDir);
+    }
+    std::filesystem::create_directory(pathToTempAnimDir);
 
-            unsigned int iMatrixCount = static_cast<unsigned int>(vInverseBindPoseMatrices.size());
-            file.write(reinterpret_cast<char*>(&iMatrixCount), sizeof(iMatrixCount));
-            for (const auto& matrix : vInverseBindPoseMatrices) {
-                file.write(reinterpret_cast<const char*>(glm::value_ptr(matrix)), sizeof(matrix));
-            }
-        }
+    optionalError =
+        importGltfSkeletonAndAnimations(model, model.skins[0], options, pathToTempAnimDir, onProgress);
+    if (optionalError.has_value()) [[unlikely]] {
+        std::filesystem::remove_all(pathToTempAnimDir);
+        optionalError->addCurrentLocationToErrorStack();
+        return optionalError;
     }
 
+    if (std::filesystem::exists(pathToAnimDir)) {
+        std::filesystem::remove_all(pathToAnimDir);
+    }
+    std::filesystem::rename(pathToTempAnimDir, pathToAnimDir);
+
     onProgress("finished importing");
     return {};
 }
@@ -1114,6 +1982,14 @@ std::optional<Error> GltfImporter::importFileAsConvexShapeGeometry(
 
     geometry.serialize(pathToOutputFile);
 
+    // Cook the hull now so that it's not built every time a body with this shape is created.
+    onProgress("cooking convex hull");
+    auto optionalError = ConvexCollisionShape::cookConvexHull(pathToOutputFile);
+    if (optionalError.has_value()) [[unlikely]] {
+        optionalError->addCurrentLocationToErrorStack();
+        return optionalError;
+    }
+
     onProgress("finished importing");
     return {};
 }
@@ -263,7 +263,8 @@ std::optional<Error> Serializable::serializeMultiple(
             tomlData,
             objectData.pOriginalObject,
             objectData.sObjectUniqueId,
-            objectData.customAttributes);
+            objectData.customAttributes,
+            objectData.bSkipGeometry);
         if (std::holds_alternative<Error>(result)) [[unlikely]] {
             auto err = std::get<Error>(std::move(result));
             err.addCurrentLocationToErrorStack();
@@ -302,7 +303,8 @@ std::variant<std::string, Error> Serializable::serialize(
     toml::value& tomlData,
     Serializable* pOriginalObject,
     std::string sEntityId,
-    const std::unordered_map<std::string, std::string>& customAttributes) {
+    const std::unordered_map<std::string, std::string>& customAttributes,
+    bool bSkipGeometry) {
     if (sEntityId.empty()) {
         // Put something as entity ID so it would not look weird.
         sEntityId = "0";
@@ -492,78 +494,11 @@ std::variant<std::string, Error> Serializable::serialize(
             tomlData[sSectionName][sVariableName] = vArray;
         }
 
-        if (!typeInfo.reflectedVariables.meshNodeGeometries.empty() ||
-            !typeInfo.reflectedVariables.skeletalMeshNodeGeometries.empty()) {
-            // Prepare path to the geometry directory.
-            if (!pathToFile.has_parent_path()) [[unlikely]] {
-                return Error(std::format("expected a parent path to exist for \"{}\"", pathToFile.string()));
-            }
-            const std::string sFilename = pathToFile.stem().string();
-            const auto pathToGeoDir =
-                pathToFile.parent_path() / (sFilename + std::string(sNodeTreeGeometryDirSuffix));
-
-            if (!std::filesystem::exists(pathToGeoDir)) {
-                // Do not delete (clean) old (existing) geometry directory as we might delete previously
-                // serialized nodes in the node tree. Node class deletes (cleans) old geometry directory
-                // for us.
-                std::filesystem::create_directory(pathToGeoDir);
-            }
-
-            // Prepare a handy lambda.
-            const auto getPathToGeometryFile =
-                [&](const std::string& sVariableName) -> std::filesystem::path {
-                return pathToGeoDir /
-                       (sEntityId + "." + sVariableName + "." + std::string(sBinaryFileExtension));
-            };
-
-            // Mesh geometry
-            bool bFoundNonEmptyMesh = false;
-            if (!typeInfo.reflectedVariables.meshNodeGeometries.empty()) {
-                for (const auto& [sVariableName, variableInfo] :
-                     typeInfo.reflectedVariables.meshNodeGeometries) {
-                    // Get value.
-                    const auto currentValue = variableInfo.getter(this);
-                    if (currentValue.getIndices().empty() && currentValue.getVertices().empty()) {
-                        // This is a valid case when the type is SkeletalMeshNode - it has skeletal node
-                        // geometry and empty mesh node geometry.
-                        continue;
-                    }
-                    bFoundNonEmptyMesh = true;
-
-                    if (pOriginalObject != nullptr && variableInfo.getter(pOriginalObject) == currentValue) {
-                        // Value didn't changed, no need to save.
-                        continue;
-                    }
-
-                    // Save to file.
-                    const auto pathToGeometryFile = getPathToGeometryFile(sVariableName);
-                    currentValue.serialize(pathToGeometryFile);
-                }
-            }
-
-            // Skeletal mesh geometry
-            if (!typeInfo.reflectedVariables.skeletalMeshNodeGeometries.empty()) {
-                for (const auto& [sVariableName, variableInfo] :
-                     typeInfo.reflectedVariables.skeletalMeshNodeGeometries) {
-                    // Get value.
-                    const auto currentValue = variableInfo.getter(this);
-                    if (currentValue.getIndices().empty() && currentValue.getVertices().empty() &&
-                        !bFoundNonEmptyMesh) {
-                        Log::warn(std::format(
-                            "found empty geometry in variable \"{}\" for file \"{}\"",
-                            sVariableName,
-                            pathToFile.filename().string()));
-                        continue;
-                    }
-                    if (pOriginalObject != nullptr && variableInfo.getter(pOriginalObject) == currentValue) {
-                        // Value didn't changed, no need to save.
-                        continue;
-                    }
-
-                    // Save to file.
-                    const auto pathToGeometryFile = getPathToGeometryFile(sVariableName);
-                    currentValue.serialize(pathToGeometryFile);
-                }
+        if (!bSkipGeometry) {
+            auto optionalError = serializeGeometry(pathToFile, sEntityId, pOriginalObject);
+            if (optionalError.has_value()) [[unlikely]] {
+                optionalError->addCurrentLocationToErrorStack();
+                return optionalError.value();
             }
         }
 
@@ -590,6 +525,80 @@ std::variant<std::string, Error> Serializable::serialize(
     return sSectionName;
 }
 
+std::optional<Error> Serializable::serializeGeometry(
+    const std::filesystem::path& pathToFile, const std::string& sEntityId, Serializable* pOriginalObject) {
+    const auto& typeInfo = ReflectedTypeDatabase::getTypeInfo(getTypeGuid());
+    if (typeInfo.reflectedVariables.meshNodeGeometries.empty() &&
+        typeInfo.reflectedVariables.skeletalMeshNodeGeometries.empty()) {
+        return {};
+    }
+
+    // Prepare path to the geometry directory.
+    if (!pathToFile.has_parent_path()) [[unlikely]] {
+        return Error(std::format("expected a parent path to exist for \"{}\"", pathToFile.string()));
+    }
+    const std::string sFilename = pathToFile.stem().string();
+    const auto pathToGeoDir =
+        pathToFile.parent_path() / (sFilename + std::string(sNodeTreeGeometryDirSuffix));
+
+    if (!std::filesystem::exists(pathToGeoDir)) {
+        // Do not delete (clean) old (existing) geometry directory as we might delete previously
+        // serialized nodes in the node tree. Node class deletes (cleans) old geometry directory
+        // for us.
+        std::filesystem::create_directory(pathToGeoDir);
+    }
+
+    // Prepare a handy lambda.
+    const auto getPathToGeometryFile = [&](const std::string& sVariableName) -> std::filesystem::path {
+        return pathToGeoDir / (sEntityId + "." + sVariableName + "." + std::string(sBinaryFileExtension));
+    };
+
+    // Mesh geometry
+    bool bFoundNonEmptyMesh = false;
+    for (const auto& [sVariableName, variableInfo] : typeInfo.reflectedVariables.meshNodeGeometries) {
+        // Get value.
+        const auto currentValue = variableInfo.getter(this);
+        if (currentValue.getIndices().empty() && currentValue.getVertices().empty()) {
+            // This is a valid case when the type is SkeletalMeshNode - it has skeletal node
+            // geometry and empty mesh node geometry.
+            continue;
+        }
+        bFoundNonEmptyMesh = true;
+
+        if (pOriginalObject != nullptr && variableInfo.getter(pOriginalObject) == currentValue) {
+            // Value didn't changed, no need to save.
+            continue;
+        }
+
+        // Save to file.
+        const auto pathToGeometryFile = getPathToGeometryFile(sVariableName);
+        currentValue.serialize(pathToGeometryFile);
+    }
+
+    // Skeletal mesh geometry
+    for (const auto& [sVariableName, variableInfo] : typeInfo.reflectedVariables.skeletalMeshNodeGeometries) {
+        // Get value.
+        const auto currentValue = variableInfo.getter(this);
+        if (currentValue.getIndices().empty() && currentValue.getVertices().empty() && !bFoundNonEmptyMesh) {
+            Log::warn(std::format(
+                "found empty geometry in variable \"{}\" for file \"{}\"",
+                sVariableName,
+                pathToFile.filename().string()));
+            continue;
+        }
+        if (pOriginalObject != nullptr && variableInfo.getter(pOriginalObject) == currentValue) {
+            // Value didn't changed, no need to save.
+            continue;
+        }
+
+        // Save to file.
+        const auto pathToGeometryFile = getPathToGeometryFile(sVariableName);
+        currentValue.serialize(pathToGeometryFile);
+    }
+
+    return {};
+}
+
 std::optional<std::pair<std::string, std::string>>
 Serializable::getPathDeserializedFromRelativeToRes() const {
     return pathDeserializedFromRelativeToRes;
@@ -46,6 +46,44 @@ void Material::setEnableTransparency(bool bEnable) {
     pNode->registerToRendering();
 }
 
+void Material::setEnableDistanceFog(bool bEnable) {
+    if (pShaderProgram == nullptr) {
+        bIsDistanceFogEnabled = bEnable;
+        return;
+    }
+
+    if (pOwnerNode == nullptr) [[unlikely]] {
+        Error::showErrorAndThrowException("expected owner node to be valid");
+    }
+
+    // Distance fog is a compile-time shader feature thus:
+    const auto pNode = pOwnerNode;
+    pNode->unregisterFromRendering(); // removes shader program and `pOwnerNode`
+    {
+        bIsDistanceFogEnabled = bEnable;
+    }
+    pNode->registerToRendering();
+}
+
+void Material::setEnableShadows(bool bEnable) {
+    if (pShaderProgram == nullptr) {
+        bIsShadowsEnabled = bEnable;
+        return;
+    }
+
+    if (pOwnerNode == nullptr) [[unlikely]] {
+        Error::showErrorAndThrowException("expected owner node to be valid");
+    }
+
+    // Shadows are a compile-time shader feature thus:
+    const auto pNode = pOwnerNode;
+    pNode->unregisterFromRendering(); // removes shader program and `pOwnerNode`
+    {
+        bIsShadowsEnabled = bEnable;
+    }
+    pNode->registerToRendering();
+}
+
 void Material::setOpacity(float opacity) {
     diffuseColor.w = opacity;
 
@@ -195,11 +233,44 @@ void Material::setTextureTilingMultiplier(const glm::vec2& mult) {
 }
 
 void Material::setOutlineWidth(float width) {
-    outlineWidth = std::max(0.0f, width);
+    width = std::max(0.0f, width);
 
-    if (pOwnerNode != nullptr) {
-        pOwnerNode->updateRenderData();
+    // Outline is a compile-time shader feature so only enabling/disabling it requires a different program.
+    if (pShaderProgram == nullptr || (width > 0.0f) == (outlineWidth > 0.0f)) {
+        outlineWidth = width;
+        if (pOwnerNode != nullptr) {
+            pOwnerNode->updateRenderData();
+        }
+        return;
+    }
+
+    if (pOwnerNode == nullptr) [[unlikely]] {
+        Error::showErrorAndThrowException("expected owner node to be valid");
+    }
+
+    const auto pNode = pOwnerNode;
+    pNode->unregisterFromRendering(); // removes shader program and `pOwnerNode`
+    {
+        outlineWidth = width;
+    }
+    pNode->registerToRendering();
+}
+
+ShaderFeature Material::getShaderFeatures() const {
+    auto features = ShaderFeature::NONE;
+    if (!sPathToDiffuseTextureRelativeRes.empty()) {
+        features |= ShaderFeature::DIFFUSE_TEXTURE;
+    }
+    if (bIsDistanceFogEnabled) {
+        features |= ShaderFeature::DISTANCE_FOG;
+    }
+    if (bIsShadowsEnabled) {
+        features |= ShaderFeature::SHADOWS;
+    }
+    if (outlineWidth > 0.0f) {
+        features |= ShaderFeature::OUTLINE;
     }
+    return features;
 }
 
 void Material::initShaderProgramAndResources(MeshNode* pNode, Renderer* pRenderer) {
@@ -211,17 +282,18 @@ void Material::initShaderProgramAndResources(MeshNode* pNode, Renderer* pRendere
             std::format("material on node \"{}\" already requested shaders", pNode->getNodeName()));
     }
 
-    // Get program.
+    // Get program (meshes are not drawn until the program is compiled).
     auto& shaderManager = pRenderer->getShaderManager();
-    pShaderProgram = shaderManager.getShaderProgram(
+    pShaderProgram = shaderManager.getShaderProgramAsync(
         sPathToCustomVertexShader.empty() ? pNode->getPathToDefaultVertexShader().data()
                                           : sPathToCustomVertexShader,
         sPathToCustomFragmentShader.empty() ? MeshNode::getPathToDefaultFragmentShader().data()
-                                            : sPathToCustomFragmentShader);
+                                            : sPathToCustomFragmentShader,
+        getShaderFeatures());
 
     // Initialize diffuse texture.
     if (!sPathToDiffuseTextureRelativeRes.empty()) {
-        auto result = pRenderer->getTextureManager().getTexture(
+        auto result = pRenderer->getTextureManager().getTextureAsync(
             sPathToDiffuseTextureRelativeRes, TextureUsage::DIFFUSE);
         if (std::holds_alternative<Error>(result)) [[unlikely]] {
             auto error = std::get<Error>(std::move(result));
@@ -0,0 +1,658 @@
+#include "material/TextureCompressor.h"
+
+// Standard.
+#include <array>
+#include <format>
+#include <fstream>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+// Custom.
+#include "io/Log.h"
+#include "misc/Profiler.hpp"
+
+// External.
+#include "stb/stb_image.h"
+
+namespace {
+    /** Modifiers of ETC color subblocks (small and large, used with both signs). */
+    constexpr std::array<std::array<int, 2>, 8> vEtcModifierTables = {
+        {{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}}};
+
+    /** Modifiers of EAC alpha blocks. */
+    constexpr std::array<std::array<int, 8>, 16> vEacModifierTables = {{
+        {-3, -6, -9, -15, 2, 5, 8, 14},
+        {-3, -7, -10, -13, 2, 6, 9, 12},
+        {-2, -5, -8, -13, 1, 4, 7, 12},
+        {-2, -4, -6, -13, 1, 3, 5, 12},
+        {-3, -6, -8, -12, 2, 5, 7, 11},
+        {-3, -7, -9, -11, 2, 6, 8, 10},
+        {-4, -7, -8, -11, 3, 6, 7, 10},
+        {-3, -5, -8, -11, 2, 4, 7, 10},
+        {-2, -6, -8, -10, 1, 5, 7, 9},
+        {-2, -5, -8, -10, 1, 4, 7, 9},
+        {-2, -4, -8, -10, 1, 3, 7, 9},
+        {-2, -5, -7, -10, 1, 4, 6, 9},
+        {-3, -4, -7, -10, 2, 3, 6, 9},
+        {-1, -2, -3, -10, 0, 1, 2, 9},
+        {-4, -6, -8, -9, 3, 5, 7, 8},
+        {-3, -5, -7, -9, 2, 4, 6, 8},
+    }};
+
+    constexpr std::string_view sCookedTextureExtension = ".etc2";
+    constexpr std::array<char, 4> vCookedTextureMagic = {'E', 'T', 'C', '2'};
+
+    /** Increment when the encoder or the format of cooked files changes to re-cook old files. */
+    constexpr uint32_t iCookedTextureVersion = 1;
+
+    /** 4x4 block of RGBA pixels stored in ETC pixel order (column by column). */
+    using PixelBlock = std::array<std::array<uint8_t, 4>, 16>;
+}
+
+/**
+ * Calculates FNV-1a hash of the specified bytes.
+ *
+ * @param vBytes Bytes to hash.
+ *
+ * @return Hash.
+ */
+inline uint64_t calculateFnv1aHash(const std::vector<uint8_t>& vBytes) {
+    uint64_t iHash = 14695981039346656037ULL;
+    for (const auto iByte : vBytes) {
+        iHash ^= iByte;
+        iHash *= 1099511628211ULL;
+    }
+    return iHash;
+}
+
+/**
+ * Writes the specified value as big endian bytes (compressed blocks are stored as big endian).
+ *
+ * @param iValue Value to write.
+ * @param pOut   8 bytes to write to.
+ */
+inline void writeBigEndian(uint64_t iValue, uint8_t* pOut) {
+    for (size_t i = 0; i < 8; i++) {
+        pOut[i] = static_cast<uint8_t>(iValue >> (56 - i * 8));
+    }
+}
+
+/**
+ * Finds the best ETC modifier table and pixel indices for a subblock with the specified base color.
+ *
+ * @param block       Pixels of the block.
+ * @param vIsInBlock  Describes which pixels of the block belong to the subblock.
+ * @param vBaseColor  Base color of the subblock.
+ * @param iBestTable  Index of the best modifier table.
+ * @param vIndices    Pixel indices of the subblock pixels to fill.
+ *
+ * @return Squared error of the subblock.
+ */
+inline uint64_t encodeEtcSubblock(
+    const PixelBlock& block,
+    const std::array<bool, 16>& vIsInBlock,
+    const std::array<int, 3>& vBaseColor,
+    uint32_t& iBestTable,
+    std::array<uint8_t, 16>& vIndices) {
+    uint64_t iBestError = std::numeric_limits<uint64_t>::max();
+
+    for (uint32_t iTable = 0; iTable < vEtcModifierTables.size(); iTable++) {
+        // Pixel index order: +small, +large, -small, -large.
+        const std::array<int, 4> vModifiers = {
+            vEtcModifierTables[iTable][0],
+            vEtcModifierTables[iTable][1],
+            -vEtcModifierTables[iTable][0],
+            -vEtcModifierTables[iTable][1]};
+
+        uint64_t iTableError = 0;
+        std::array<uint8_t, 16> vTableIndices{};
+        for (size_t iPixel = 0; iPixel < block.size(); iPixel++) {
+            if (!vIsInBlock[iPixel]) {
+                continue;
+            }
+
+            uint64_t iBestPixelError = std::numeric_limits<uint64_t>::max();
+            for (uint8_t iIndex = 0; iIndex < vModifiers.size(); iIndex++) {
+                uint64_t iPixelError = 0;
+                for (size_t iChannel = 0; iChannel < 3; iChannel++) {
+                    const int iValue = std::clamp(vBaseColor[iChannel] + vModifiers[iIndex], 0, 255);
+                    const int iDiff = iValue - static_cast<int>(block[iPixel][iChannel]);
+                    iPixelError += static_cast<uint64_t>(iDiff * iDiff);
+                }
+                if (iPixelError < iBestPixelError) {
+                    iBestPixelError = iPixelError;
+                    vTableIndices[iPixel] = iIndex;
+                }
+            }
+
+            iTableError += iBestPixelError;
+        }
+
+        if (iTableError < iBestError) {
+            iBestError = iTableError;
+            iBestTable = iTable;
+            for (size_t iPixel = 0; iPixel < block.size(); iPixel++) {
+                if (vIsInBlock[iPixel]) {
+                    vIndices[iPixel] = vTableIndices[iPixel];
+                }
+            }
+        }
+    }
+
+    return iBestError;
+}
+
+/**
+ * Encodes RGB channels of a block to 8 bytes using ETC1 individual/differential modes
+ * (which are a valid subset of ETC2).
+ *
+ * @param block Pixels of the block.
+ * @param pOut  8 bytes to write to.
+ */
+inline void encodeEtcColorBlock(const PixelBlock& block, uint8_t* pOut) {
+    uint64_t iBestError = std::numeric_limits<uint64_t>::max();
+    uint64_t iBestBlock = 0;
+
+    for (uint32_t iFlip = 0; iFlip < 2; iFlip++) {
+        // Split into 2 subblocks: 2x4 side by side (no flip) or 4x2 on top of each other (flip).
+        std::array<std::array<bool, 16>, 2> vIsInSubblock{};
+        std::array<std::array<float, 3>, 2> vAverageColors{};
+        for (size_t iPixel = 0; iPixel < block.size(); iPixel++) {
+            const size_t iX = iPixel / 4;
+            const size_t iY = iPixel % 4;
+            const size_t iSubblock = iFlip == 0 ? iX / 2 : iY / 2;
+            vIsInSubblock[iSubblock][iPixel] = true;
+            for (size_t iChannel = 0; iChannel < 3; iChannel++) {
+                vAverageColors[iSubblock][iChannel] += static_cast<float>(block[iPixel][iChannel]) / 8.0f;
+            }
+        }
+
+        for (uint32_t iDiffMode = 0; iDiffMode < 2; iDiffMode++) {
+            // Quantize base colors to 4 bits (individual) or 5 bits (differential).
+            const float maxQuantized = iDiffMode == 1 ? 31.0f : 15.0f;
+            std::array<std::array<int, 3>, 2> vQuantized{};
+            std::array<std::array<int, 3>, 2> vBaseColors{};
+            for (size_t iSubblock = 0; iSubblock < 2; iSubblock++) {
+                for (size_t iChannel = 0; iChannel < 3; iChannel++) {
+                    const int iQuantized = static_cast<int>(
+                        std::round(vAverageColors[iSubblock][iChannel] * maxQuantized / 255.0f));
+                    vQuantized[iSubblock][iChannel] = iQuantized;
+                    vBaseColors[iSubblock][iChannel] =
+                        iDiffMode == 1 ? (iQuantized << 3) | (iQuantized >> 2) : iQuantized * 17;
+                }
+            }
+
+            // Differential mode stores the second color as a 3 bit offset from the first one.
+            std::array<int, 3> vDiffs{};
+            if (iDiffMode == 1) {
+                bool bFits = true;
+                for (size_t iChannel = 0; iChannel < 3; iChannel++) {
+                    vDiffs[iChannel] = vQuantized[1][iChannel] - vQuantized[0][iChannel];
+                    bFits = bFits && vDiffs[iChannel] >= -4 && vDiffs[iChannel] <= 3;
+                }
+                if (!bFits) {
+                    continue;
+                }
+            }
+
+            std::array<uint32_t, 2> vTables{};
+            std::array<uint8_t, 16> vIndices{};
+            const uint64_t iError =
+                encodeEtcSubblock(block, vIsInSubblock[0], vBaseColors[0], vTables[0], vIndices) +
+                encodeEtcSubblock(block, vIsInSubblock[1], vBaseColors[1], vTables[1], vIndices);
+            if (iError >= iBestError) {
+                continue;
+            }
+
+            uint64_t iBlock = 0;
+            for (size_t iChannel = 0; iChannel < 3; iChannel++) {
+                const auto iShift = 56 - iChannel * 8;
+                if (iDiffMode == 1) {
+                    iBlock |= static_cast<uint64_t>(vQuantized[0][iChannel]) << (iShift + 3);
+                    iBlock |= static_cast<uint64_t>(vDiffs[iChannel] & 0x7) << iShift;
+                } else {
+                    iBlock |= static_cast<uint64_t>(vQuantized[0][iChannel]) << (iShift + 4);
+                    iBlock |= static_cast<uint64_t>(vQuantized[1][iChannel]) << iShift;
+                }
+            }
+            iBlock |= static_cast<uint64_t>(vTables[0]) << 37;
+            iBlock |= static_cast<uint64_t>(vTables[1]) << 34;
+            iBlock |= static_cast<uint64_t>(iDiffMode) << 33;
+            iBlock |= static_cast<uint64_t>(iFlip) << 32;
+            for (size_t iPixel = 0; iPixel < vIndices.size(); iPixel++) {
+                iBlock |= static_cast<uint64_t>(vIndices[iPixel] & 0x1) << iPixel;
+                iBlock |= static_cast<uint64_t>(vIndices[iPixel] >> 1) << (16 + iPixel);
+            }
+
+            iBestError = iError;
+            iBestBlock = iBlock;
+        }
+    }
+
+    writeBigEndian(iBestBlock, pOut);
+}
+
+/**
+ * Encodes alpha channel of a block to 8 bytes using EAC.
+ *
+ * @param block Pixels of the block.
+ * @param pOut  8 bytes to write to.
+ */
+inline void encodeEacAlphaBlock(const PixelBlock& block, uint8_t* pOut) {
+    int iMinAlpha = 255;
+    int iMaxAlpha = 0;
+    for (const auto& pixel : block) {
+        iMinAlpha = std::min(iMinAlpha, static_cast<int>(pixel[3]));
+        iMaxAlpha = std::max(iMaxAlpha, static_cast<int>(pixel[3]));
+    }
+
+    uint64_t iBestError = std::numeric_limits<uint64_t>::max();
+    uint64_t iBestBlock = 0;
+
+    const auto tryEncode = [&](int iBase, int iMultiplier, uint32_t iTable) {
+        uint64_t iError = 0;
+        uint64_t iBlock = static_cast<uint64_t>(iBase) << 56 | static_cast<uint64_t>(iMultiplier) << 52 |
+                          static_cast<uint64_t>(iTable) << 48;
+
+        for (size_t iPixel = 0; iPixel < block.size(); iPixel++) {
+            uint64_t iBestPixelError = std::numeric_limits<uint64_t>::max();
+            uint64_t iBestIndex = 0;
+            for (uint64_t iIndex = 0; iIndex < 8; iIndex++) {
+                const int iValue =
+                    std::clamp(iBase + vEacModifierTables[iTable][iIndex] * iMultiplier, 0, 255);
+                const int iDiff = iValue - static_cast<int>(block[iPixel][3]);
+                const auto iPixelError = static_cast<uint64_t>(iDiff * iDiff);
+                if (iPixelError < iBestPixelError) {
+                    iBestPixelError = iPixelError;
+                    iBestIndex = iIndex;
+                }
+            }
+            iError += iBestPixelError;
+            iBlock |= iBestIndex << (45 - iPixel * 3);
+        }
+
+        if (iError < iBestError) {
+            iBestError = iError;
+            iBestBlock = iBlock;
+        }
+    };
+
+    if (iMinAlpha == iMaxAlpha) {
+        // Table 13 has a zero modifier.
+        tryEncode(iMinAlpha, 1, 13);
+    } else {
+        for (uint32_t iTable = 0; iTable < vEacModifierTables.size(); iTable++) {
+            const auto [iMinModifier, iMaxModifier] =
+                std::minmax_element(vEacModifierTables[iTable].begin(), vEacModifierTables[iTable].end());
+            const float modifierRange = static_cast<float>(*iMaxModifier - *iMinModifier);
+            const int iMultiplier = static_cast<int>(
+                std::round(static_cast<float>(iMaxAlpha - iMinAlpha) / modifierRange));
+
+            for (int iMultiplierOffset = -1; iMultiplierOffset <= 1; iMultiplierOffset++) {
+                const int iCurrentMultiplier = std::clamp(iMultiplier + iMultiplierOffset, 1, 15);
+                const int iBase = static_cast<int>(std::round(
+                    static_cast<float>(iMinAlpha + iMaxAlpha) * 0.5f -
+                    static_cast<float>(iCurrentMultiplier * (*iMinModifier + *iMaxModifier)) * 0.5f));
+
+                for (int iBaseOffset = -1; iBaseOffset <= 1; iBaseOffset++) {
+                    tryEncode(std::clamp(iBase + iBaseOffset, 0, 255), iCurrentMultiplier, iTable);
+                }
+            }
+        }
+    }
+
+    writeBigEndian(iBestBlock, pOut);
+}
+
+/**
+ * Creates the next (twice smaller) mip using a box filter.
+ *
+ * @param vPixels RGBA8 pixels of the current mip.
+ * @param iWidth  Width of the current mip (will be updated).
+ * @param iHeight Height of the current mip (will be updated).
+ *
+ * @return RGBA8 pixels of the next mip.
+ */
+inline std::vector<uint8_t>
+createNextMip(const std::vector<uint8_t>& vPixels, unsigned int& iWidth, unsigned int& iHeight) {
+    const unsigned int iNewWidth = std::max(iWidth / 2, 1U);
+    const unsigned int iNewHeight = std::max(iHeight / 2, 1U);
+
+    std::vector<uint8_t> vNewPixels(static_cast<size_t>(iNewWidth) * iNewHeight * 4);
+    for (unsigned int iY = 0; iY < iNewHeight; iY++) {
+        for (unsigned int iX = 0; iX < iNewWidth; iX++) {
+            const unsigned int iSourceX = std::min(iX * 2, iWidth - 1);
+            const unsigned int iSourceY = std::min(iY * 2, iHeight - 1);
+            const unsigned int iNextSourceX = std::min(iSourceX + 1, iWidth - 1);
+            const unsigned int iNextSourceY = std::min(iSourceY + 1, iHeight - 1);
+
+            for (size_t iChannel = 0; iChannel < 4; iChannel++) {
+                const auto getSource = [&](unsigned int iSampleX, unsigned int iSampleY) {
+                    return static_cast<unsigned int>(
+                        vPixels[(static_cast<size_t>(iSampleY) * iWidth + iSampleX) * 4 + iChannel]);
+                };
+                const unsigned int iSum = getSource(iSourceX, iSourceY) + getSource(iNextSourceX, iSourceY) +
+                                          getSource(iSourceX, iNextSourceY) +
+                                          getSource(iNextSourceX, iNextSourceY);
+                vNewPixels[(static_cast<size_t>(iY) * iNewWidth + iX) * 4 + iChannel] =
+                    static_cast<uint8_t>((iSum + 2) / 4);
+            }
+        }
+    }
+
+    iWidth = iNewWidth;
+    iHeight = iNewHeight;
+
+    return vNewPixels;
+}
+
+CompressedTexture TextureCompressor::compress(
+    const uint8_t* pPixels, unsigned int iWidth, unsigned int iHeight, bool bGenerateMipmaps) {
+    PROFILE_FUNC
+
+    CompressedTexture texture;
+    texture.iWidth = iWidth;
+    texture.iHeight = iHeight;
+
+    // Use alpha only if needed.
+    texture.format = CompressedTextureFormat::ETC2_RGB8;
+    const size_t iPixelCount = static_cast<size_t>(iWidth) * iHeight;
+    for (size_t i = 0; i < iPixelCount; i++) {
+        if (pPixels[i * 4 + 3] != 255) {
+            texture.format = CompressedTextureFormat::ETC2_RGBA8_EAC;
+            break;
+        }
+    }
+
+    texture.vMips.push_back(compressImage(pPixels, iWidth, iHeight, texture.format));
+    if (!bGenerateMipmaps) {
+        return texture;
+    }
+
+    std::vector<uint8_t> vMipPixels(pPixels, pPixels + iPixelCount * 4);
+    unsigned int iMipWidth = iWidth;
+    unsigned int iMipHeight = iHeight;
+    while (iMipWidth > 1 || iMipHeight > 1) {
+        vMipPixels = createNextMip(vMipPixels, iMipWidth, iMipHeight);
+        texture.vMips.push_back(compressImage(vMipPixels.data(), iMipWidth, iMipHeight, texture.format));
+    }
+
+    return texture;
+}
+
+std::vector<uint8_t> TextureCompressor::compressImage(
+    const uint8_t* pPixels, unsigned int iWidth, unsigned int iHeight, CompressedTextureFormat format) {
+    const bool bHasAlpha = format == CompressedTextureFormat::ETC2_RGBA8_EAC;
+    const size_t iBlockSize = bHasAlpha ? 16 : 8;
+    const unsigned int iBlockCountX = (iWidth + 3) / 4;
+    const unsigned int iBlockCountY = (iHeight + 3) / 4;
+
+    std::vector<uint8_t> vData(getCompressedSize(format, iWidth, iHeight));
+    for (unsigned int iBlockY = 0; iBlockY < iBlockCountY; iBlockY++) {
+        for (unsigned int iBlockX = 0; iBlockX < iBlockCountX; iBlockX++) {
+            // Gather block pixels (repeat edge pixels for partial blocks).
+            PixelBlock block{};
+            for (unsigned int iX = 0; iX < 4; iX++) {
+                for (unsigned int iY = 0; iY < 4; iY++) {
+                    const unsigned int iSourceX = std::min(iBlockX * 4 + iX, iWidth - 1);
+                    const unsigned int iSourceY = std::min(iBlockY * 4 + iY, iHeight - 1);
+                    const uint8_t* pSource =
+                        &pPixels[(static_cast<size_t>(iSourceY) * iWidth + iSourceX) * 4];
+                    std::copy(pSource, pSource + 4, block[iX * 4 + iY].begin());
+                }
+            }
+
+            uint8_t* pOut = &vData[(static_cast<size_t>(iBlockY) * iBlockCountX + iBlockX) * iBlockSize];
+            if (bHasAlpha) {
+                encodeEacAlphaBlock(block, pOut);
+                pOut += 8;
+            }
+            encodeEtcColorBlock(block, pOut);
+        }
+    }
+
+    return vData;
+}
+
+size_t TextureCompressor::getCompressedSize(
+    CompressedTextureFormat format, unsigned int iWidth, unsigned int iHeight) {
+    const size_t iBlockSize = format == CompressedTextureFormat::ETC2_RGBA8_EAC ? 16 : 8;
+    return static_cast<size_t>((iWidth + 3) / 4) * ((iHeight + 3) / 4) * iBlockSize;
+}
+
+std::filesystem::path
+TextureCompressor::getPathToCookedTexture(const std::filesystem::path& pathToSourceTexture) {
+    return pathToSourceTexture.string() + std::string(sCookedTextureExtension);
+}
+
+std::variant<Error, CompressedTexture> TextureCompressor::loadOrCook(
+    const std::filesystem::path& pathToSourceTexture,
+    bool bGenerateMipmaps,
+    unsigned int iMaxTextureSize) {
+    PROFILE_FUNC
+
+    // Read source file.
+    std::ifstream sourceFile(pathToSourceTexture, std::ios::binary);
+    if (!sourceFile.is_open()) [[unlikely]] {
+        return Error(std::format("unable to open the file \"{}\"", pathToSourceTexture.string()));
+    }
+    const std::vector<uint8_t> vSourceBytes(
+        (std::istreambuf_iterator<char>(sourceFile)), std::istreambuf_iterator<char>());
+    sourceFile.close();
+
+    const auto iSourceHash = calculateFnv1aHash(vSourceBytes);
+    const uint32_t iSettings = bGenerateMipmaps ? 1 : 0;
+
+    // See if there's an up to date cooked file.
+    const auto pathToCookedTexture = getPathToCookedTexture(pathToSourceTexture);
+    auto cookedResult = readCookedTexture(pathToCookedTexture, iSourceHash, iSettings, iMaxTextureSize);
+    if (std::holds_alternative<Error>(cookedResult)) [[unlikely]] {
+        // Treat as a cache miss, the file will be overwritten.
+        Log::warn(std::format(
+            "cooked texture will be cooked again because the cooked file is invalid, error: {}",
+            std::get<Error>(cookedResult).getInitialMessage()));
+    } else {
+        auto optCookedTexture = std::get<std::optional<CompressedTexture>>(std::move(cookedResult));
+        if (optCookedTexture.has_value()) {
+            return std::move(*optCookedTexture);
+        }
+    }
+
+    // Check image size before decoding.
+    int iWidth = 0;
+    int iHeight = 0;
+    int iChannelCount = 0;
+    if (stbi_info_from_memory(
+            vSourceBytes.data(), static_cast<int>(vSourceBytes.size()), &iWidth, &iHeight, &iChannelCount) ==
+        0) [[unlikely]] {
+        return Error(std::format("failed to load texture \"{}\"", pathToSourceTexture.string()));
+    }
+    if (iWidth <= 0 || iHeight <= 0 || static_cast<unsigned int>(iWidth) > iMaxTextureSize ||
+        static_cast<unsigned int>(iHeight) > iMaxTextureSize) [[unlikely]] {
+        return Error(std::format(
+            "texture \"{}\" has size {}x{} while the maximum supported size is {}",
+            pathToSourceTexture.string(),
+            iWidth,
+            iHeight,
+            iMaxTextureSize));
+    }
+
+    // Decode source image.
+    const auto pImageData = stbi_load_from_memory(
+        vSourceBytes.data(), static_cast<int>(vSourceBytes.size()), &iWidth, &iHeight, &iChannelCount, 4);
+    if (pImageData == nullptr) [[unlikely]] {
+        return Error(std::format("failed to load texture \"{}\"", pathToSourceTexture.string()));
+    }
+
+    auto texture = compress(
+        pImageData, static_cast<unsigned int>(iWidth), static_cast<unsigned int>(iHeight), bGenerateMipmaps);
+    stbi_image_free(pImageData);
+
+    // Cache the result (not critical if fails, for example if the directory is read-only).
+    auto optionalError = writeCookedTexture(pathToCookedTexture, texture, iSourceHash, iSettings);
+    if (optionalError.has_value()) [[unlikely]] {
+        Log::warn(std::format(
+            "failed to write cooked texture, error: {}", optionalError->getInitialMessage()));
+    } else {
+        Log::info(std::format("cooked texture \"{}\"", pathToSourceTexture.filename().string()));
+    }
+
+    return texture;
+}
+
+std::variant<Error, std::optional<CompressedTexture>> TextureCompressor::readCookedTexture(
+    const std::filesystem::path& pathToCookedTexture,
+    uint64_t iSourceHash,
+    uint32_t iSettings,
+    unsigned int iMaxTextureSize) {
+    std::ifstream file(pathToCookedTexture, std::ios::binary);
+    if (!file.is_open()) {
+        return std::optional<CompressedTexture>{};
+    }
+
+    // Check header.
+    std::array<char, 4> vMagic{};
+    uint32_t iVersion = 0;
+    uint64_t iFileSourceHash = 0;
+    uint32_t iFileSettings = 0;
+    file.read(vMagic.data(), vMagic.size());
+    file.read(reinterpret_cast<char*>(&iVersion), sizeof(iVersion));
+    file.read(reinterpret_cast<char*>(&iFileSourceHash), sizeof(iFileSourceHash));
+    file.read(reinterpret_cast<char*>(&iFileSettings), sizeof(iFileSettings));
+    if (!file || vMagic != vCookedTextureMagic || iVersion != iCookedTextureVersion ||
+        iFileSourceHash != iSourceHash || iFileSettings != iSettings) {
+        return std::optional<CompressedTexture>{};
+    }
+
+    // Read texture info.
+    CompressedTexture texture;
+    uint8_t iFormat = 0;
+    uint32_t iMipCount = 0;
+    file.read(reinterpret_cast<char*>(&iFormat), sizeof(iFormat));
+    file.read(reinterpret_cast<char*>(&texture.iWidth), sizeof(texture.iWidth));
+    file.read(reinterpret_cast<char*>(&texture.iHeight), sizeof(texture.iHeight));
+    file.read(reinterpret_cast<char*>(&iMipCount), sizeof(iMipCount));
+    if (!file) [[unlikely]] {
+        return Error(std::format(
+            "cooked texture \"{}\" is corrupted: unexpected end of the header",
+            pathToCookedTexture.string()));
+    }
+
+    // Validate texture info before allocating anything (the file might be corrupted).
+    if (iFormat > static_cast<uint8_t>(CompressedTextureFormat::ETC2_RGBA8_EAC)) [[unlikely]] {
+        return Error(std::format(
+            "cooked texture \"{}\" is corrupted: unknown format {}", pathToCookedTexture.string(), iFormat));
+    }
+    texture.format = static_cast<CompressedTextureFormat>(iFormat);
+    if (texture.iWidth == 0 || texture.iHeight == 0 || texture.iWidth > iMaxTextureSize ||
+        texture.iHeight > iMaxTextureSize) [[unlikely]] {
+        return Error(std::format(
+            "cooked texture \"{}\" has size {}x{} while the maximum supported size is {}",
+            pathToCookedTexture.string(),
+            texture.iWidth,
+            texture.iHeight,
+            iMaxTextureSize));
+    }
+    uint32_t iFullMipCount = 1;
+    for (unsigned int iSize = std::max(texture.iWidth, texture.iHeight); iSize > 1; iSize /= 2) {
+        iFullMipCount += 1;
+    }
+    if (iMipCount == 0 || iMipCount > iFullMipCount) [[unlikely]] {
+        return Error(std::format(
+            "cooked texture \"{}\" is corrupted: {} mips for size {}x{}",
+            pathToCookedTexture.string(),
+            iMipCount,
+            texture.iWidth,
+            texture.iHeight));
+    }
+
+    // Make sure the file stores exactly the expected mips.
+    size_t iExpectedDataSize = 0;
+    unsigned int iMipWidth = texture.iWidth;
+    unsigned int iMipHeight = texture.iHeight;
+    for (uint32_t iMip = 0; iMip < iMipCount; iMip++) {
+        iExpectedDataSize += getCompressedSize(texture.format, iMipWidth, iMipHeight);
+        iMipWidth = std::max(iMipWidth / 2, 1U);
+        iMipHeight = std::max(iMipHeight / 2, 1U);
+    }
+    const auto iHeaderSize = static_cast<size_t>(file.tellg());
+    std::error_code errorCode;
+    const auto iFileSize = std::filesystem::file_size(pathToCookedTexture, errorCode);
+    if (errorCode) [[unlikely]] {
+        return Error(std::format(
+            "failed to get size of the file \"{}\", error: {}",
+            pathToCookedTexture.string(),
+            errorCode.message()));
+    }
+    if (iFileSize < iHeaderSize || iFileSize - iHeaderSize != iExpectedDataSize) [[unlikely]] {
+        return Error(std::format(
+            "cooked texture \"{}\" is corrupted: expected {} bytes of mip data but the file has {}",
+            pathToCookedTexture.string(),
+            iExpectedDataSize,
+            iFileSize < iHeaderSize ? 0 : iFileSize - iHeaderSize));
+    }
+
+    // Read mips.
+    iMipWidth = texture.iWidth;
+    iMipHeight = texture.iHeight;
+    texture.vMips.resize(iMipCount);
+    for (auto& vMip : texture.vMips) {
+        vMip.resize(getCompressedSize(texture.format, iMipWidth, iMipHeight));
+        file.read(reinterpret_cast<char*>(vMip.data()), static_cast<std::streamsize>(vMip.size()));
+        iMipWidth = std::max(iMipWidth / 2, 1U);
+        iMipHeight = std::max(iMipHeight / 2, 1U);
+    }
+    if (!file) [[unlikely]] {
+        return Error(std::format("failed to read the file \"{}\"", pathToCookedTexture.string()));
+    }
+
+    return std::optional<CompressedTexture>(std::move(texture));
+}
+
+std::optional<Error> TextureCompressor::writeCookedTexture(
+    const std::filesystem::path& pathToCookedTexture,
+    const CompressedTexture& texture,
+    uint64_t iSourceHash,
+    uint32_t iSettings) {
+    // Write to a temporary file and then replace the cooked file so that a crash in the middle of writing
+    // never leaves a partially written cooked file.
+    const auto pathToTempFile = pathToCookedTexture.string() + ".tmp";
+    std::ofstream file(pathToTempFile, std::ios::binary);
+    if (!file.is_open()) [[unlikely]] {
+        return Error(std::format("unable to create the file \"{}\"", pathToTempFile));
+    }
+
+    const auto iFormat = static_cast<uint8_t>(texture.format);
+    const auto iMipCount = static_cast<uint32_t>(texture.vMips.size());
+    file.write(vCookedTextureMagic.data(), vCookedTextureMagic.size());
+    file.write(reinterpret_cast<const char*>(&iCookedTextureVersion), sizeof(iCookedTextureVersion));
+    file.write(reinterpret_cast<const char*>(&iSourceHash), sizeof(iSourceHash));
+    file.write(reinterpret_cast<const char*>(&iSettings), sizeof(iSettings));
+    file.write(reinterpret_cast<const char*>(&iFormat), sizeof(iFormat));
+    file.write(reinterpret_cast<const char*>(&texture.iWidth), sizeof(texture.iWidth));
+    file.write(reinterpret_cast<const char*>(&texture.iHeight), sizeof(texture.iHeight));
+    file.write(reinterpret_cast<const char*>(&iMipCount), sizeof(iMipCount));
+    for (const auto& vMip : texture.vMips) {
+        file.write(reinterpret_cast<const char*>(vMip.data()), static_cast<std::streamsize>(vMip.size()));
+    }
+
+    file.close();
+    if (!file) [[unlikely]] {
+        std::filesystem::remove(pathToTempFile);
+        return Error(std::format("failed to write the file \"{}\"", pathToTempFile));
+    }
+
+    std::error_code errorCode;
+    std::filesystem::rename(pathToTempFile, pathToCookedTexture, errorCode);
+    if (errorCode) [[unlikely]] {
+        std::filesystem::remove(pathToTempFile);
+        return Error(std::format(
+            "failed to move the file \"{}\" to \"{}\", error: {}",
+            pathToTempFile,
+            pathToCookedTexture.string(),
+            errorCode.message()));
+    }
+
+    return {};
+}
@@ -9,3 +9,5 @@ TextureHandle::TextureHandle(
       pTextureManager(pTextureManager) {}
 
 TextureHandle::~TextureHandle() { pTextureManager->releaseTextureIfNotUsed(sPathToTextureRelativeRes); }
+
+bool TextureHandle::isReady() const { return pTextureManager->isTextureReady(sPathToTextureRelativeRes); }
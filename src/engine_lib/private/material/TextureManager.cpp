@@ -3,12 +3,18 @@
 // Standard.
 #include <format>
 #include <cstring>
+#include <algorithm>
+#include <array>
 
 // Custom.
 #include "misc/ProjectPaths.h"
 #include "io/Log.h"
 #include "render/GpuResourceManager.h"
+#include "render/GpuMemoryTracker.h"
 #include "misc/Profiler.hpp"
+#include "render/Renderer.h"
+#include "game/Window.h"
+#include "game/GameManager.h"
 
 // External.
 #include "nameof.hpp"
@@ -16,9 +22,27 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb/stb_image.h"
 
+namespace {
+    /** Number of top mips that textures drop when they are not visible for a long time. */
+    constexpr size_t iDroppedMipCount = 2;
+
+    /** Default value of `GL_TEXTURE_MAX_LEVEL`. */
+    constexpr int iDefaultMaxMipLevel = 1000;
+}
+
+TextureManager::TextureManager(Renderer* pRenderer) : pRenderer(pRenderer) {
+    GLint iGlMaxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &iGlMaxTextureSize);
+    iMaxTextureSize = static_cast<unsigned int>(std::max(iGlMaxTextureSize, 0));
+}
+
 TextureManager::~TextureManager() {
     std::scoped_lock guard(mtxLoadedTextures.first);
 
+    if (iPixelUnpackBufferId != 0) {
+        GL_CHECK_ERROR(glDeleteBuffers(1, &iPixelUnpackBufferId));
+    }
+
     // Make sure no resource is loaded.
     if (!mtxLoadedTextures.second.empty()) [[unlikely]] {
         // Prepare a description of all not released resources.
@@ -49,6 +73,10 @@ void TextureManager::setUsePointFiltering(bool bUsePointFiltering) {
     bIsUsingPointFiltering = bUsePointFiltering;
 }
 
+void TextureManager::setUseTextureCompression(bool bUseTextureCompression) {
+    bIsUsingTextureCompression = bUseTextureCompression;
+}
+
 std::variant<std::unique_ptr<TextureHandle>, Error>
 TextureManager::getTexture(const std::string& sPathToTextureRelativeRes, TextureUsage usage) {
     PROFILE_FUNC
@@ -103,10 +131,29 @@ void TextureManager::releaseTextureIfNotUsed(const std::string& sPathToTextureRe
     it->second.iActiveTextureHandleCount -= 1;
 
     if (it->second.iActiveTextureHandleCount == 0) {
+        {
+            std::scoped_lock gpuGuard(GpuResourceManager::mtx);
+            GL_CHECK_ERROR(glDeleteTextures(1, &it->second.iTextureId));
+        }
+        if (it->second.optTrackedResourceId.has_value()) {
+            GpuMemoryTracker::unregisterResource(*it->second.optTrackedResourceId);
+        }
+        {
+            std::scoped_lock statsGuard(mtxStreamingStats.first);
+            mtxStreamingStats.second.iResidentBytes -= it->second.iSizeInBytes;
+        }
         mtxLoadedTextures.second.erase(it);
     }
 }
 
+bool TextureManager::isTextureReady(const std::string& sPathToTextureRelativeRes) {
+    std::scoped_lock guard(mtxLoadedTextures.first);
+
+    // Placeholders are not counted in the size.
+    const auto it = mtxLoadedTextures.second.find(sPathToTextureRelativeRes);
+    return it != mtxLoadedTextures.second.end() && it->second.iSizeInBytes > 0;
+}
+
 std::unique_ptr<TextureHandle> TextureManager::createNewHandleForLoadedTexture(
     const std::string& sPathToTextureRelativeRes, TextureUsage usage) {
     std::scoped_lock guard(mtxLoadedTextures.first);
@@ -167,70 +214,34 @@ std::variant<std::unique_ptr<TextureHandle>, Error> TextureManager::loadTextureA
         }
 
         // Load pixel data.
-        const auto sPathToTexture = pathToTexture.string();
-        int iWidth = 0;
-        int iHeight = 0;
-        int iChannelCount = 0;
-        const auto pImageData = stbi_load(sPathToTexture.c_str(), &iWidth, &iHeight, &iChannelCount, 0);
-        if (pImageData == nullptr) [[unlikely]] {
-            return Error(std::format("failed to load texture \"{}\"", sPathToTexture));
+        auto result = decodeTexture(pathToTexture, usage, bIsUsingTextureCompression, iMaxTextureSize);
+        if (std::holds_alternative<Error>(result)) [[unlikely]] {
+            auto error = std::get<Error>(std::move(result));
+            error.addCurrentLocationToErrorStack();
+            return error;
         }
-
-        const auto iGlFormat = iChannelCount == 4 ? GL_RGBA : GL_RGB;
-        const auto iGlInternalFormat = iGlFormat;
+        const auto texture = std::get<DecodedTexture>(std::move(result));
 
         // Create a new texture object.
         unsigned int iTextureId = 0;
         GL_CHECK_ERROR(glGenTextures(1, &iTextureId));
-
-        glBindTexture(GL_TEXTURE_2D, iTextureId);
-        {
-            // Copy pixels to the GPU resource.
-            GL_CHECK_ERROR(glTexImage2D(
-                GL_TEXTURE_2D,
-                0,
-                iGlInternalFormat,
-                iWidth,
-                iHeight,
-                0,
-                iGlFormat,
-                GL_UNSIGNED_BYTE,
-                pImageData));
-
-            if (usage == TextureUsage::DIFFUSE) {
-                GL_CHECK_ERROR(glGenerateMipmap(GL_TEXTURE_2D));
-            }
-
-            // Set texture wrapping.
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-            // Set texture filtering.
-            if (bIsUsingPointFiltering) {
-                if (usage == TextureUsage::DIFFUSE) {
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
-                } else {
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-                }
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            } else {
-                if (usage == TextureUsage::DIFFUSE) {
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-                } else {
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                }
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            }
-        }
-        glBindTexture(GL_TEXTURE_2D, 0);
-
-        stbi_image_free(pImageData);
+        const auto iSizeInBytes = uploadDecodedTexture(iTextureId, 1, texture);
 
         // Add new resource to be considered.
         TextureResource resourceInfo;
         resourceInfo.iActiveTextureHandleCount = 0; // 0 because `createNewTextureHandle` will increment it
         resourceInfo.iTextureId = iTextureId;
+        resourceInfo.iLoadRequestId = iNextLoadRequestId;
+        resourceInfo.iSizeInBytes = iSizeInBytes;
+        resourceInfo.iAllocatedMipCount = texture.getMipCount();
+        resourceInfo.iFullMipCount = resourceInfo.iAllocatedMipCount;
         resourceInfo.usage = usage;
+        trackTextureSize(resourceInfo);
         mtxLoadedTextures.second[sPathToTextureRelativeRes] = resourceInfo;
+        iNextLoadRequestId += 1;
+
+        std::scoped_lock statsGuard(mtxStreamingStats.first);
+        mtxStreamingStats.second.iResidentBytes += iSizeInBytes;
     } else {
         // Stores 6 textures.
         auto pathToTexDir =
@@ -248,6 +259,7 @@ std::variant<std::unique_ptr<TextureHandle>, Error> TextureManager::loadTextureA
         const std::array<std::string_view, 6> vFilenames = {
             "right.png", "left.png", "top.png", "bottom.png", "front.png", "back.png"};
 
+        size_t iCubemapSizeInBytes = 0;
         unsigned int iCubemapId = 0;
         glGenTextures(1, &iCubemapId);
         glBindTexture(GL_TEXTURE_CUBE_MAP, iCubemapId);
@@ -276,6 +288,9 @@ std::variant<std::unique_ptr<TextureHandle>, Error> TextureManager::loadTextureA
             const auto iGlFormat = iChannelCount == 4 ? GL_RGBA : GL_RGB;
             const auto iGlInternalFormat = iGlFormat;
 
+            iCubemapSizeInBytes += static_cast<size_t>(iWidth) * static_cast<size_t>(iHeight) *
+                                   static_cast<size_t>(iChannelCount == 4 ? 4 : 3);
+
             // Copy pixels to the GPU resource.
             GL_CHECK_ERROR(glTexImage2D(
                 GL_TEXTURE_CUBE_MAP_POSITIVE_X + static_cast<int>(i),
@@ -311,9 +326,545 @@ std::variant<std::unique_ptr<TextureHandle>, Error> TextureManager::loadTextureA
         TextureResource resourceInfo;
         resourceInfo.iActiveTextureHandleCount = 0; // 0 because `createNewTextureHandle` will increment it
         resourceInfo.iTextureId = iCubemapId;
+        resourceInfo.iLoadRequestId = iNextLoadRequestId;
+        resourceInfo.iSizeInBytes = iCubemapSizeInBytes;
         resourceInfo.usage = usage;
+        trackTextureSize(resourceInfo);
         mtxLoadedTextures.second[sPathToTextureRelativeRes] = resourceInfo;
+        iNextLoadRequestId += 1;
+
+        std::scoped_lock statsGuard(mtxStreamingStats.first);
+        mtxStreamingStats.second.iResidentBytes += iCubemapSizeInBytes;
+    }
+
+    return createNewHandleForLoadedTexture(sPathToTextureRelativeRes, usage);
+}
+
+std::variant<std::unique_ptr<TextureHandle>, Error>
+TextureManager::getTextureAsync(const std::string& sPathToTextureRelativeRes, TextureUsage usage) {
+    PROFILE_FUNC
+
+    if (usage == TextureUsage::CUBEMAP_NO_MIPMAP) {
+        return getTexture(sPathToTextureRelativeRes, usage);
+    }
+
+    std::scoped_lock guard(mtxLoadedTextures.first, GpuResourceManager::mtx);
+
+    // See if a texture by this path is already loaded (or being loaded).
+    if (mtxLoadedTextures.second.contains(sPathToTextureRelativeRes)) {
+        return createNewHandleForLoadedTexture(sPathToTextureRelativeRes, usage);
+    }
+
+    // Construct full path to the texture.
+    auto pathToTexture =
+        ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sPathToTextureRelativeRes;
+
+    // Make sure it's a file.
+    if (!std::filesystem::exists(pathToTexture)) [[unlikely]] {
+        return Error(std::format("expected the path \"{}\" to exist", pathToTexture.string()));
     }
+    if (std::filesystem::is_directory(pathToTexture)) [[unlikely]] {
+        return Error(std::format("expected the path \"{}\" to point to a file", pathToTexture.string()));
+    }
+
+    // Create a new texture object with a placeholder (the texture ID will stay the same after the load).
+    unsigned int iTextureId = 0;
+    GL_CHECK_ERROR(glGenTextures(1, &iTextureId));
+    uploadPlaceholderTexture(iTextureId, 1, usage);
+
+    // Add new resource to be considered.
+    TextureResource resourceInfo;
+    resourceInfo.iActiveTextureHandleCount = 0; // 0 because `createNewTextureHandle` will increment it
+    resourceInfo.iTextureId = iTextureId;
+    resourceInfo.iLastVisibleFrameIndex = iResidencyFrameIndex;
+    resourceInfo.usage = usage;
+    resourceInfo.bIsStreamable = true;
+    trackTextureSize(resourceInfo);
+    auto& resource = mtxLoadedTextures.second[sPathToTextureRelativeRes];
+    resource = resourceInfo;
+
+    requestTextureStreaming(sPathToTextureRelativeRes, resource, 0);
 
     return createNewHandleForLoadedTexture(sPathToTextureRelativeRes, usage);
 }
+
+void TextureManager::requestTextureStreaming(
+    const std::string& sPathToTextureRelativeRes, TextureResource& resource, size_t iSkippedMipCount) {
+    // New request ID makes the manager ignore data of previous requests.
+    const auto iLoadRequestId = iNextLoadRequestId;
+    iNextLoadRequestId += 1;
+    resource.iLoadRequestId = iLoadRequestId;
+    resource.iSkippedMipCount = iSkippedMipCount;
+
+    {
+        std::scoped_lock statsGuard(mtxStreamingStats.first);
+        mtxStreamingStats.second.iDecodingTextureCount += 1;
+    }
+
+    // Decode in the thread pool, the result will be uploaded in `uploadDecodedTextures`.
+    pRenderer->getWindow()->getGameManager()->addTaskToThreadPool(
+        [this,
+         sPathToTextureRelativeRes,
+         pathToTexture =
+             ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sPathToTextureRelativeRes,
+         usage = resource.usage,
+         iLoadRequestId,
+         iSkippedMipCount,
+         bUseTextureCompression = bIsUsingTextureCompression,
+         iMaxTextureSize = iMaxTextureSize]() {
+            PROFILE_SCOPE("decode texture")
+
+            auto result = decodeTexture(
+                pathToTexture, usage, bUseTextureCompression, iMaxTextureSize, iSkippedMipCount);
+            if (std::holds_alternative<Error>(result)) [[unlikely]] {
+                auto error = std::get<Error>(std::move(result));
+                Log::error(std::format(
+                    "failed to load texture \"{}\", the placeholder will be used, error: {}",
+                    sPathToTextureRelativeRes,
+                    error.getFullErrorMessage()));
+
+                std::scoped_lock statsGuard(mtxStreamingStats.first);
+                mtxStreamingStats.second.iDecodingTextureCount -= 1;
+                return;
+            }
+            auto texture = std::get<DecodedTexture>(std::move(result));
+            texture.sPathToTextureRelativeRes = sPathToTextureRelativeRes;
+            texture.iLoadRequestId = iLoadRequestId;
+
+            {
+                std::scoped_lock statsGuard(mtxStreamingStats.first);
+                mtxStreamingStats.second.iDecodingTextureCount -= 1;
+                mtxStreamingStats.second.iPendingUploadBytes += texture.getUploadSize();
+            }
+
+            std::scoped_lock decodedGuard(mtxDecodedTextures.first);
+            mtxDecodedTextures.second.push_back(std::move(texture));
+        });
+}
+
+void TextureManager::setUploadBudgetPerFrame(size_t iBudgetInBytes) {
+    iUploadBudgetPerFrameInBytes = iBudgetInBytes;
+}
+
+void TextureManager::setMemoryBudget(size_t iBudgetInBytes) { iMemoryBudgetInBytes = iBudgetInBytes; }
+
+void TextureManager::setFramesBeforeMipDrop(size_t iFrameCount) { iFramesBeforeMipDrop = iFrameCount; }
+
+TextureStreamingStats TextureManager::getStreamingStats() {
+    std::scoped_lock guard(mtxStreamingStats.first);
+
+    auto stats = mtxStreamingStats.second;
+    stats.iMemoryBudgetBytes = iMemoryBudgetInBytes;
+    return stats;
+}
+
+size_t TextureManager::DecodedTexture::getUploadSize() const {
+    if (!optCompressed.has_value()) {
+        return vPixels.size();
+    }
+
+    size_t iSize = 0;
+    for (const auto& vMip : optCompressed->vMips) {
+        iSize += vMip.size();
+    }
+    return iSize;
+}
+
+size_t TextureManager::DecodedTexture::getMipCount() const {
+    if (optCompressed.has_value()) {
+        return optCompressed->vMips.size();
+    }
+    if (usage != TextureUsage::DIFFUSE) {
+        return 1;
+    }
+
+    // Mips are generated down to 1x1.
+    size_t iMipCount = 1;
+    for (unsigned int iSize = std::max(iWidth, iHeight); iSize > 1; iSize /= 2) {
+        iMipCount += 1;
+    }
+    return iMipCount;
+}
+
+std::variant<Error, TextureManager::DecodedTexture> TextureManager::decodeTexture(
+    const std::filesystem::path& pathToTexture,
+    TextureUsage usage,
+    bool bUseTextureCompression,
+    unsigned int iMaxTextureSize,
+    size_t iSkippedMipCount) {
+    PROFILE_FUNC
+
+    DecodedTexture texture;
+    texture.usage = usage;
+
+    if (usage == TextureUsage::DIFFUSE && bUseTextureCompression) {
+        // Load compressed texture with precomputed mips.
+        auto result = TextureCompressor::loadOrCook(pathToTexture, true, iMaxTextureSize);
+        if (std::holds_alternative<Error>(result)) [[unlikely]] {
+            auto error = std::get<Error>(std::move(result));
+            error.addCurrentLocationToErrorStack();
+            return error;
+        }
+        texture.optCompressed = std::get<CompressedTexture>(std::move(result));
+        auto& compressed = *texture.optCompressed;
+
+        // Skip top mips (keep at least 1).
+        iSkippedMipCount = std::min(iSkippedMipCount, compressed.vMips.size() - 1);
+        if (iSkippedMipCount > 0) {
+            compressed.vMips.erase(
+                compressed.vMips.begin(),
+                compressed.vMips.begin() + static_cast<ptrdiff_t>(iSkippedMipCount));
+            compressed.iWidth = std::max(compressed.iWidth >> iSkippedMipCount, 1U);
+            compressed.iHeight = std::max(compressed.iHeight >> iSkippedMipCount, 1U);
+        }
+        texture.iSkippedMipCount = iSkippedMipCount;
+        texture.iWidth = compressed.iWidth;
+        texture.iHeight = compressed.iHeight;
+
+        return texture;
+    }
+
+    // Load pixel data (keep alpha only if the image has it).
+    const auto sPathToTexture = pathToTexture.string();
+    int iWidth = 0;
+    int iHeight = 0;
+    int iChannelCount = 0;
+    if (stbi_info(sPathToTexture.c_str(), &iWidth, &iHeight, &iChannelCount) == 0) [[unlikely]] {
+        return Error(std::format("failed to load texture \"{}\"", sPathToTexture));
+    }
+    if (iWidth <= 0 || iHeight <= 0 || static_cast<unsigned int>(iWidth) > iMaxTextureSize ||
+        static_cast<unsigned int>(iHeight) > iMaxTextureSize) [[unlikely]] {
+        return Error(std::format(
+            "texture \"{}\" has size {}x{} while the maximum supported size is {}",
+            sPathToTexture,
+            iWidth,
+            iHeight,
+            iMaxTextureSize));
+    }
+    const int iRequestedChannelCount = (iChannelCount == 2 || iChannelCount == 4) ? 4 : 3;
+    const auto pImageData =
+        stbi_load(sPathToTexture.c_str(), &iWidth, &iHeight, &iChannelCount, iRequestedChannelCount);
+    if (pImageData == nullptr) [[unlikely]] {
+        return Error(std::format("failed to load texture \"{}\"", sPathToTexture));
+    }
+
+    texture.iWidth = static_cast<unsigned int>(iWidth);
+    texture.iHeight = static_cast<unsigned int>(iHeight);
+    texture.vPixels.assign(
+        pImageData,
+        pImageData + static_cast<size_t>(iWidth) * static_cast<size_t>(iHeight) *
+                         static_cast<size_t>(iRequestedChannelCount));
+    stbi_image_free(pImageData);
+
+    return texture;
+}
+
+size_t TextureManager::uploadDecodedTexture(
+    unsigned int iTextureId, size_t iAllocatedMipCount, const DecodedTexture& texture) {
+    PROFILE_FUNC
+
+    const size_t iUploadSize = texture.getUploadSize();
+
+    // Copy data to the pixel buffer.
+    if (iPixelUnpackBufferId == 0) {
+        GL_CHECK_ERROR(glGenBuffers(1, &iPixelUnpackBufferId));
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, iPixelUnpackBufferId);
+    {
+        // Orphan the old storage so that we don't wait for previous uploads to finish reading from it.
+        GL_CHECK_ERROR(glBufferData(
+            GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(iUploadSize), nullptr, GL_STREAM_DRAW));
+        auto pMappedData = static_cast<uint8_t*>(glMapBufferRange(
+            GL_PIXEL_UNPACK_BUFFER,
+            0,
+            static_cast<GLsizeiptr>(iUploadSize),
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+        if (pMappedData == nullptr) [[unlikely]] {
+            Error::showErrorAndThrowException("failed to map the pixel unpack buffer");
+        }
+
+        if (texture.optCompressed.has_value()) {
+            for (const auto& vMip : texture.optCompressed->vMips) {
+                std::memcpy(pMappedData, vMip.data(), vMip.size());
+                pMappedData += vMip.size();
+            }
+        } else {
+            std::memcpy(pMappedData, texture.vPixels.data(), texture.vPixels.size());
+        }
+
+        if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_FALSE) [[unlikely]] {
+            Error::showErrorAndThrowException("the pixel unpack buffer was corrupted during the upload");
+        }
+    }
+
+    size_t iSizeInBytes = 0;
+    glBindTexture(GL_TEXTURE_2D, iTextureId);
+    {
+        if (texture.optCompressed.has_value()) {
+            const auto& compressed = *texture.optCompressed;
+            const auto iGlInternalFormat = compressed.format == CompressedTextureFormat::ETC2_RGBA8_EAC
+                                               ? GL_COMPRESSED_RGBA8_ETC2_EAC
+                                               : GL_COMPRESSED_RGB8_ETC2;
+
+            // Copy mips from the pixel buffer (pointers are offsets into the buffer).
+            unsigned int iMipWidth = compressed.iWidth;
+            unsigned int iMipHeight = compressed.iHeight;
+            size_t iOffset = 0;
+            for (size_t iMip = 0; iMip < compressed.vMips.size(); iMip++) {
+                GL_CHECK_ERROR(glCompressedTexImage2D(
+                    GL_TEXTURE_2D,
+                    static_cast<int>(iMip),
+                    iGlInternalFormat,
+                    static_cast<int>(iMipWidth),
+                    static_cast<int>(iMipHeight),
+                    0,
+                    static_cast<int>(compressed.vMips[iMip].size()),
+                    reinterpret_cast<const void*>(iOffset)));
+
+                iOffset += compressed.vMips[iMip].size();
+                iMipWidth = std::max(iMipWidth / 2, 1U);
+                iMipHeight = std::max(iMipHeight / 2, 1U);
+            }
+            glTexParameteri(
+                GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<int>(compressed.vMips.size()) - 1);
+
+            iSizeInBytes = iUploadSize;
+        } else {
+            const size_t iPixelCount = static_cast<size_t>(texture.iWidth) * texture.iHeight;
+            const auto iGlFormat = texture.vPixels.size() == iPixelCount * 4 ? GL_RGBA : GL_RGB;
+            const auto iGlInternalFormat = iGlFormat;
+
+            // Rows of RGB images are not aligned to 4 bytes.
+            GLint iPreviousUnpackAlignment = 0;
+            glGetIntegerv(GL_UNPACK_ALIGNMENT, &iPreviousUnpackAlignment);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+            // Copy pixels from the pixel buffer.
+            GL_CHECK_ERROR(glTexImage2D(
+                GL_TEXTURE_2D,
+                0,
+                iGlInternalFormat,
+                static_cast<int>(texture.iWidth),
+                static_cast<int>(texture.iHeight),
+                0,
+                iGlFormat,
+                GL_UNSIGNED_BYTE,
+                nullptr));
+
+            glPixelStorei(GL_UNPACK_ALIGNMENT, iPreviousUnpackAlignment);
+
+            iSizeInBytes = iUploadSize;
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, iDefaultMaxMipLevel);
+            if (texture.usage == TextureUsage::DIFFUSE) {
+                GL_CHECK_ERROR(glGenerateMipmap(GL_TEXTURE_2D));
+                iSizeInBytes += iUploadSize / 3; // all mips take 1/3 of the first mip
+            }
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        // Free mips that the previous data had but the new data does not.
+        for (size_t iMip = texture.getMipCount(); iMip < iAllocatedMipCount; iMip++) {
+            glTexImage2D(
+                GL_TEXTURE_2D, static_cast<int>(iMip), GL_RGBA, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+
+        setTextureParameters(texture.usage);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return iSizeInBytes;
+}
+
+void TextureManager::trackTextureSize(TextureResource& resource, const std::source_location& location) {
+    if (resource.optTrackedResourceId.has_value()) {
+        GpuMemoryTracker::unregisterResource(*resource.optTrackedResourceId);
+    }
+    resource.optTrackedResourceId =
+        GpuMemoryTracker::registerResource(GpuResourceCategory::TEXTURE, resource.iSizeInBytes, location);
+}
+
+void TextureManager::uploadPlaceholderTexture(
+    unsigned int iTextureId, size_t iAllocatedMipCount, TextureUsage usage) {
+    glBindTexture(GL_TEXTURE_2D, iTextureId);
+    {
+        constexpr std::array<uint8_t, 4> vPlaceholderPixel = {255, 255, 255, 255};
+        GL_CHECK_ERROR(glTexImage2D(
+            GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, vPlaceholderPixel.data()));
+
+        // Free other mips.
+        for (size_t iMip = 1; iMip < iAllocatedMipCount; iMip++) {
+            glTexImage2D(
+                GL_TEXTURE_2D, static_cast<int>(iMip), GL_RGBA, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+
+        // Make the texture complete even when a mipmap filter is used.
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        setTextureParameters(usage);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void TextureManager::setTextureParameters(TextureUsage usage) const {
+    // Set texture wrapping.
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    // Set texture filtering.
+    if (bIsUsingPointFiltering) {
+        if (usage == TextureUsage::DIFFUSE) {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+        } else {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    } else {
+        if (usage == TextureUsage::DIFFUSE) {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        } else {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+}
+
+void TextureManager::uploadDecodedTextures() {
+    PROFILE_FUNC
+
+    std::scoped_lock guard(mtxLoadedTextures.first, GpuResourceManager::mtx);
+
+    size_t iUploadedBytes = 0;
+    while (true) {
+        // Take the next decoded texture if it fits into the budget.
+        DecodedTexture texture;
+        {
+            std::scoped_lock decodedGuard(mtxDecodedTextures.first);
+            auto& decodedTextures = mtxDecodedTextures.second;
+            if (decodedTextures.empty()) {
+                break;
+            }
+            const auto iNextUploadSize = decodedTextures.front().getUploadSize();
+            if (iUploadedBytes > 0 && iUploadedBytes + iNextUploadSize > iUploadBudgetPerFrameInBytes) {
+                break;
+            }
+            texture = std::move(decodedTextures.front());
+            decodedTextures.pop_front();
+        }
+        const auto iUploadSize = texture.getUploadSize();
+
+        // Make sure the texture was not released while it was being decoded.
+        const auto it = mtxLoadedTextures.second.find(texture.sPathToTextureRelativeRes);
+        if (it == mtxLoadedTextures.second.end() || it->second.iLoadRequestId != texture.iLoadRequestId) {
+            std::scoped_lock statsGuard(mtxStreamingStats.first);
+            mtxStreamingStats.second.iPendingUploadBytes -= iUploadSize;
+            continue;
+        }
+
+        auto& resource = it->second;
+        const auto iPreviousSizeInBytes = resource.iSizeInBytes;
+        resource.iSizeInBytes =
+            uploadDecodedTexture(resource.iTextureId, resource.iAllocatedMipCount, texture);
+        resource.iAllocatedMipCount = texture.getMipCount();
+        resource.iSkippedMipCount = texture.iSkippedMipCount;
+        resource.bIsCompressed = texture.optCompressed.has_value();
+        if (texture.iSkippedMipCount == 0) {
+            resource.iFullMipCount = resource.iAllocatedMipCount;
+        }
+        trackTextureSize(resource);
+        iUploadedBytes += iUploadSize;
+
+        std::scoped_lock statsGuard(mtxStreamingStats.first);
+        mtxStreamingStats.second.iPendingUploadBytes -= iUploadSize;
+        mtxStreamingStats.second.iResidentBytes -= iPreviousSizeInBytes;
+        mtxStreamingStats.second.iResidentBytes += resource.iSizeInBytes;
+    }
+
+    std::scoped_lock statsGuard(mtxStreamingStats.first);
+    mtxStreamingStats.second.iUploadedBytesLastFrame = iUploadedBytes;
+}
+
+void TextureManager::updateTextureResidency() {
+    PROFILE_FUNC
+
+    std::scoped_lock guard(mtxLoadedTextures.first, GpuResourceManager::mtx);
+
+    iResidencyFrameIndex += 1;
+
+    size_t iReducedTextureCount = 0;
+    size_t iEvictedTextureCount = 0;
+    std::vector<std::pair<const std::string*, TextureResource*>> vEvictionCandidates;
+    for (auto& [sPath, resource] : mtxLoadedTextures.second) {
+        if (!resource.bIsStreamable) {
+            continue;
+        }
+
+        if (resource.iTextureId < vVisibleFrameIndexPerTextureId.size() &&
+            vVisibleFrameIndexPerTextureId[resource.iTextureId] == iResidencyFrameIndex) {
+            resource.iLastVisibleFrameIndex = iResidencyFrameIndex;
+
+            // Stream full mips back.
+            if (resource.bIsEvicted || resource.iSkippedMipCount > 0) {
+                resource.bIsEvicted = false;
+                requestTextureStreaming(sPath, resource, 0);
+            }
+            continue;
+        }
+
+        if (resource.bIsEvicted) {
+            iEvictedTextureCount += 1;
+            continue;
+        }
+
+        // Drop top mips if not visible for a long time (only compressed textures have
+        // precomputed mips that can be loaded separately).
+        const auto iFramesNotVisible = iResidencyFrameIndex - resource.iLastVisibleFrameIndex;
+        if (iFramesBeforeMipDrop > 0 && iFramesNotVisible >= iFramesBeforeMipDrop && resource.bIsCompressed &&
+            resource.iSkippedMipCount == 0 && resource.iFullMipCount > 1) {
+            requestTextureStreaming(sPath, resource, std::min(iDroppedMipCount, resource.iFullMipCount - 1));
+        }
+        if (resource.iSkippedMipCount > 0) {
+            iReducedTextureCount += 1;
+        }
+
+        if (resource.iSizeInBytes > 0) {
+            vEvictionCandidates.push_back({&sPath, &resource});
+        }
+    }
+
+    std::scoped_lock statsGuard(mtxStreamingStats.first);
+    auto& stats = mtxStreamingStats.second;
+
+    // Evict least recently visible textures until we fit into the budget.
+    if (iMemoryBudgetInBytes > 0 && stats.iResidentBytes > iMemoryBudgetInBytes) {
+        std::sort(vEvictionCandidates.begin(), vEvictionCandidates.end(), [](const auto& a, const auto& b) {
+            return a.second->iLastVisibleFrameIndex < b.second->iLastVisibleFrameIndex;
+        });
+
+        for (const auto& [pPath, pResource] : vEvictionCandidates) {
+            if (stats.iResidentBytes <= iMemoryBudgetInBytes) {
+                break;
+            }
+
+            uploadPlaceholderTexture(pResource->iTextureId, pResource->iAllocatedMipCount, pResource->usage);
+            stats.iResidentBytes -= pResource->iSizeInBytes;
+
+            // Make sure data of pending requests will be ignored.
+            pResource->iLoadRequestId = iNextLoadRequestId;
+            iNextLoadRequestId += 1;
+
+            if (pResource->iSkippedMipCount > 0) {
+                iReducedTextureCount -= 1;
+            }
+            pResource->iSizeInBytes = 0;
+            pResource->iAllocatedMipCount = 1;
+            pResource->iSkippedMipCount = 0;
+            pResource->bIsEvicted = true;
+            trackTextureSize(*pResource);
+
+            iEvictedTextureCount += 1;
+            iTotalEvictionCount += 1;
+        }
+    }
+
+    stats.iReducedTextureCount = iReducedTextureCount;
+    stats.iEvictedTextureCount = iEvictedTextureCount;
+    stats.iTotalEvictionCount = iTotalEvictionCount;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+// Standard.
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <format>
+
+// Custom.
+#include "misc/Error.h"
+
+/**
+ * Bounded lock-free queue where multiple threads can push items and a single thread pops them.
+ *
+ * @remark Memory for all items is allocated in the constructor, pushing to a full buffer fails (and is
+ * counted, see @ref resetOverflowCount) instead of allocating more memory.
+ */
+template <typename T> class MpscRingBuffer {
+public:
+    /**
+     * Constructor.
+     *
+     * @param iCapacity Maximum number of items in the buffer, must be a power of 2.
+     */
+    MpscRingBuffer(size_t iCapacity) : iIndexMask(iCapacity - 1) {
+        if (iCapacity < 2 || (iCapacity & (iCapacity - 1)) != 0) [[unlikely]] {
+            Error::showErrorAndThrowException(
+                std::format("ring buffer capacity {} must be a power of 2", iCapacity));
+        }
+
+        pCells = std::make_unique<Cell[]>(iCapacity);
+        for (size_t i = 0; i < iCapacity; i++) {
+            pCells[i].iSequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpscRingBuffer() = default;
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    /**
+     * Adds a new item to the buffer (can be called from multiple threads at the same time).
+     *
+     * @param item Item to add.
+     *
+     * @return `false` if the buffer is full (the item is not added and the overflow counter is increased).
+     */
+    bool push(const T& item) {
+        size_t iPosition = iPushPosition.load(std::memory_order_relaxed);
+        Cell* pCell = nullptr;
+
+        while (true) {
+            pCell = &pCells[iPosition & iIndexMask];
+            const auto iSequence = pCell->iSequence.load(std::memory_order_acquire);
+            const auto iDiff =
+                static_cast<std::ptrdiff_t>(iSequence) - static_cast<std::ptrdiff_t>(iPosition);
+
+            if (iDiff == 0) {
+                // The cell is free, try to reserve it.
+                if (iPushPosition.compare_exchange_weak(
+                        iPosition, iPosition + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (iDiff < 0) {
+                // The consumer did not pop this cell yet, the buffer is full.
+                iOverflowCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                // Another producer reserved this cell.
+                iPosition = iPushPosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        pCell->item = item;
+        pCell->iSequence.store(iPosition + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * Returns the oldest item without removing it (only the consumer thread can call this function).
+     *
+     * @return `nullptr` if the buffer is empty.
+     */
+    const T* peek() const {
+        const auto& cell = pCells[iPopPosition & iIndexMask];
+        if (cell.iSequence.load(std::memory_order_acquire) != iPopPosition + 1) {
+            return nullptr;
+        }
+
+        return &cell.item;
+    }
+
+    /**
+     * Removes the oldest item (only the consumer thread can call this function).
+     *
+     * @remark Expects that @ref peek returned an item.
+     */
+    void pop() {
+        auto& cell = pCells[iPopPosition & iIndexMask];
+        cell.iSequence.store(iPopPosition + iIndexMask + 1, std::memory_order_release);
+        iPopPosition += 1;
+    }
+
+    /**
+     * Returns the number of items that were not added because the buffer was full and resets the counter.
+     *
+     * @return Number of dropped items.
+     */
+    size_t resetOverflowCount() { return iOverflowCount.exchange(0, std::memory_order_relaxed); }
+
+private:
+    /** Slot of the buffer. */
+    struct Cell {
+        /** Tells if the cell can be written to or read from (depends on the current position). */
+        std::atomic<size_t> iSequence{0};
+
+        /** Stored item. */
+        T item{};
+    };
+
+    /** Cells of the buffer. */
+    std::unique_ptr<Cell[]> pCells;
+
+    /** Used to convert a position to a cell index (capacity - 1). */
+    const size_t iIndexMask = 0;
+
+    /** Position where the next item will be added (producers). */
+    alignas(64) std::atomic<size_t> iPushPosition{0};
+
+    /** Position of the next item to read (consumer). */
+    alignas(64) size_t iPopPosition = 0;
+
+    /** Number of items that were not added because the buffer was full. */
+    alignas(64) std::atomic<size_t> iOverflowCount{0};
+};
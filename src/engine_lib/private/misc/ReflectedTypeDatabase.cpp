@@ -82,6 +82,9 @@ void ReflectedTypeDatabase::registerEngineTypes() {
     registerType(CapsuleCollisionShape::getTypeGuidStatic(), CapsuleCollisionShape::getReflectionInfo());
     registerType(CylinderCollisionShape::getTypeGuidStatic(), CylinderCollisionShape::getReflectionInfo());
     registerType(ConvexCollisionShape::getTypeGuidStatic(), ConvexCollisionShape::getReflectionInfo());
+    registerType(MeshCollisionShape::getTypeGuidStatic(), MeshCollisionShape::getReflectionInfo());
+    registerType(
+        HeightFieldCollisionShape::getTypeGuidStatic(), HeightFieldCollisionShape::getReflectionInfo());
     registerType(CollisionNode::getTypeGuidStatic(), CollisionNode::getReflectionInfo());
     registerType(CompoundCollisionNode::getTypeGuidStatic(), CompoundCollisionNode::getReflectionInfo());
     registerType(SimulatedBodyNode::getTypeGuidStatic(), SimulatedBodyNode::getReflectionInfo());
@@ -11,14 +11,16 @@
 #include "tracy/public/common/TracySystem.hpp"
 #endif
 
-ThreadPool::ThreadPool() {
-    auto iThreadCount = std::thread::hardware_concurrency();
+ThreadPool::ThreadPool(unsigned int iThreadCount) {
     if (iThreadCount == 0) {
-        iThreadCount = iMinThreadCount;
-        Log::error(std::format(
-            "hardware concurrency information is not available, as a fallback creating {} thread(s) "
-            "for the thread pool",
-            iThreadCount));
+        iThreadCount = std::thread::hardware_concurrency();
+        if (iThreadCount == 0) {
+            iThreadCount = iMinThreadCount;
+            Log::error(std::format(
+                "hardware concurrency information is not available, as a fallback creating {} thread(s) "
+                "for the thread pool",
+                iThreadCount));
+        }
     }
 
     vRunningThreads.resize(iThreadCount);
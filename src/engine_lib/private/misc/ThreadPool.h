@@ -6,12 +6,18 @@
 #include <mutex>
 #include <queue>
 #include <condition_variable>
+#include <thread>
+#include <vector>
 
 /** A very simple thread pool. */
 class ThreadPool {
 public:
-    /** Creates threads to execute tasks. */
-    ThreadPool();
+    /**
+     * Creates threads to execute tasks.
+     *
+     * @param iThreadCount Number of threads to create, 0 to create a thread per hardware thread.
+     */
+    ThreadPool(unsigned int iThreadCount = 0);
 
     ThreadPool(const ThreadPool&) = delete;
     ThreadPool& operator=(const ThreadPool&) = delete;
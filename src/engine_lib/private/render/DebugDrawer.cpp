@@ -13,10 +13,20 @@
 #include "render/FontManager.h"
 #include "game/Window.h"
 #include "render/wrapper/Texture.h"
+#include "render/FrameStreamingBuffer.h"
 
 // External.
 #include "glad/glad.h"
 
+namespace {
+    /** Handles to shader uniforms that are set per drawn debug object. */
+    const ShaderUniformHandle worldMatrixUniform = ShaderProgram::getUniformHandle("worldMatrix");
+    const ShaderUniformHandle meshColorUniform = ShaderProgram::getUniformHandle("meshColor");
+    const ShaderUniformHandle colorUniform = ShaderProgram::getUniformHandle("color");
+    const ShaderUniformHandle isUsingTextureUniform = ShaderProgram::getUniformHandle("bIsUsingTexture");
+    const ShaderUniformHandle textColorUniform = ShaderProgram::getUniformHandle("textColor");
+}
+
 DebugDrawer::DebugDrawer() {
     // Precalculate cube positions.
     {
@@ -83,6 +93,7 @@ DebugDrawer& DebugDrawer::get() {
 void DebugDrawer::destroy() {
     pMeshShaderProgram = nullptr;
     pScreenQuadGeometry = nullptr;
+    pStreamedMeshVao = nullptr;
     textShaderInfo.pShaderProgram = nullptr;
     rectShaderInfo.pShaderProgram = nullptr;
 
@@ -114,8 +125,8 @@ void DebugDrawer::drawMesh(
         Error::showErrorAndThrowException("triangle positions array must store 3 positions per triangle");
     }
 
-    // Prepare vertex buffer.
-    std::unique_ptr<VertexArrayObject> pMeshVao;
+    // Prepare positions.
+    std::vector<glm::vec3> vPositions;
     if (bDrawAsWireframe) {
         std::vector<glm::vec3> vEdges;
         vEdges.reserve(vTrianglePositions.size() * 2); // 2 vertices to draw an edge of a triangle
@@ -130,15 +141,15 @@ void DebugDrawer::drawMesh(
             vEdges.push_back(vTrianglePositions[i]);
         }
 
-        pMeshVao = GpuResourceManager::createVertexArrayObject(false, vEdges);
+        vPositions = std::move(vEdges);
     } else {
-        pMeshVao = GpuResourceManager::createVertexArrayObject(false, vTrianglePositions);
+        vPositions = vTrianglePositions;
     }
 
     get().vMeshesToDraw.push_back(Mesh{
         .worldMatrix = worldMatrix,
         .color = color,
-        .pVao = std::move(pMeshVao),
+        .vPositions = std::move(vPositions),
         .timeLeftSec = timeInSec,
         .bDrawAsWireframe = bDrawAsWireframe});
 }
@@ -152,12 +163,10 @@ void DebugDrawer::drawLines(
         Error::showErrorAndThrowException("line positions array must store 2 positions per line");
     }
 
-    auto pLinesVao = GpuResourceManager::createVertexArrayObject(false, vLines);
-
     get().vMeshesToDraw.push_back(Mesh{
         .worldMatrix = worldMatrix,
         .color = color,
-        .pVao = std::move(pLinesVao),
+        .vPositions = vLines,
         .timeLeftSec = timeInSec,
         .bDrawAsWireframe = true});
 }
@@ -244,8 +253,20 @@ void DebugDrawer::drawDebugObjects(
         };
         std::array<unsigned short, ScreenQuadGeometry::iIndexCount> vIndices = {0, 1, 2, 0, 2, 3};
         pScreenQuadGeometry = GpuResourceManager::createScreenQuad(vVertices, vIndices);
+
+        pStreamedMeshVao = GpuResourceManager::createVertexArrayObject(true);
     }
 
+    // Copies mesh positions to the streaming buffer and binds them to the mesh VAO.
+    auto& streamingBuffer = pRenderer->getStreamingBuffer();
+    const auto bindMeshPositions = [&](const Mesh& mesh) {
+        const auto range = streamingBuffer.streamData(
+            mesh.vPositions.data(),
+            static_cast<unsigned int>(mesh.vPositions.size() * sizeof(mesh.vPositions[0])),
+            alignof(glm::vec3));
+        glBindVertexBuffer(0, range.iBufferId, range.iOffset, sizeof(glm::vec3));
+    };
+
     glDisable(GL_DEPTH_TEST);
     {
         // Prepare for drawing meshes.
@@ -262,12 +283,13 @@ void DebugDrawer::drawDebugObjects(
                 continue;
             }
 
-            glBindVertexArray(mesh.pVao->getVertexArrayObjectId());
+            glBindVertexArray(pStreamedMeshVao->getVertexArrayObjectId());
+            bindMeshPositions(mesh);
 
-            pMeshShaderProgram->setMatrix4ToActiveProgram("worldMatrix", mesh.worldMatrix);
-            pMeshShaderProgram->setVector4ToActiveProgram("meshColor", mesh.color);
+            pMeshShaderProgram->setMatrix4ToActiveProgram(worldMatrixUniform, mesh.worldMatrix);
+            pMeshShaderProgram->setVector4ToActiveProgram(meshColorUniform, mesh.color);
 
-            glDrawArrays(GL_LINES, 0, static_cast<int>(mesh.pVao->getVertexCount()));
+            glDrawArrays(GL_LINES, 0, static_cast<int>(mesh.vPositions.size()));
 
             // Update state.
             mesh.timeLeftSec -= timeSincePrevFrameInSec;
@@ -285,8 +307,9 @@ void DebugDrawer::drawDebugObjects(
 
         for (auto it = vRectsToDraw.begin(); it != vRectsToDraw.end();) {
             auto& rect = *it;
-            rectShaderInfo.pShaderProgram->setVector4ToActiveProgram("color", glm::vec4(rect.color, 1.0f));
-            rectShaderInfo.pShaderProgram->setBoolToActiveProgram("bIsUsingTexture", false);
+            rectShaderInfo.pShaderProgram->setVector4ToActiveProgram(
+                colorUniform, glm::vec4(rect.color, 1.0f));
+            rectShaderInfo.pShaderProgram->setBoolToActiveProgram(isUsingTextureUniform, false);
 
             glm::vec2 pos = rect.screenPos;
             glm::vec2 size = rect.screenSize;
@@ -335,7 +358,7 @@ void DebugDrawer::drawDebugObjects(
             }
 
             textShaderInfo.pShaderProgram->setVector4ToActiveProgram(
-                "textColor", glm::vec4(text.color, 1.0f));
+                textColorUniform, glm::vec4(text.color, 1.0f));
 
             const auto fontScale = text.textHeight / fontManager.getFontHeightToLoad();
             const float textHeightInPixels =
@@ -410,12 +433,13 @@ void DebugDrawer::drawDebugObjects(
             continue;
         }
 
-        glBindVertexArray(mesh.pVao->getVertexArrayObjectId());
+        glBindVertexArray(pStreamedMeshVao->getVertexArrayObjectId());
+        bindMeshPositions(mesh);
 
-        pMeshShaderProgram->setMatrix4ToActiveProgram("worldMatrix", mesh.worldMatrix);
-        pMeshShaderProgram->setVector4ToActiveProgram("meshColor", mesh.color);
+        pMeshShaderProgram->setMatrix4ToActiveProgram(worldMatrixUniform, mesh.worldMatrix);
+        pMeshShaderProgram->setVector4ToActiveProgram(meshColorUniform, mesh.color);
 
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<int>(mesh.pVao->getVertexCount()));
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<int>(mesh.vPositions.size()));
 
         // Update state.
         mesh.timeLeftSec -= timeSincePrevFrameInSec;
@@ -145,7 +145,12 @@ void FontManager::cacheGlyphs(const std::pair<unsigned long, unsigned long>& cha
             // Save.
             mtxLoadedGlyphs.second[iCharCode] = CharacterGlyph{
                 .pTexture = std::unique_ptr<Texture>(new Texture(
-                    iTextureId, pFtFace->glyph->bitmap.width, pFtFace->glyph->bitmap.rows, iGlFormat)),
+                    iTextureId,
+                    pFtFace->glyph->bitmap.width,
+                    pFtFace->glyph->bitmap.rows,
+                    iGlFormat,
+                    static_cast<size_t>(pFtFace->glyph->bitmap.width) * pFtFace->glyph->bitmap.rows, // GL_RED
+                    std::source_location::current())),
                 .size = glm::ivec2(pFtFace->glyph->bitmap.width, pFtFace->glyph->bitmap.rows),
                 .bearing = glm::ivec2(pFtFace->glyph->bitmap_left, pFtFace->glyph->bitmap_top),
                 .advance = static_cast<unsigned int>(pFtFace->glyph->advance.x)};
@@ -0,0 +1,112 @@
+#include "render/FrameStreamingBuffer.h"
+
+// Standard.
+#include <format>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+// Custom.
+#include "render/GpuResourceManager.h"
+#include "misc/Error.h"
+#include "misc/Profiler.hpp"
+#include "io/Log.h"
+
+// External.
+#include "glad/glad.h"
+
+FrameStreamingBuffer::FrameStreamingBuffer() {
+    int iAlignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &iAlignment);
+    if (iAlignment > 0) {
+        iUniformBufferOffsetAlignment = static_cast<unsigned int>(iAlignment);
+    }
+
+    pBuffer = GpuResourceManager::createStreamingBuffer(
+        iFrameRegionSizeInBytes * static_cast<unsigned int>(iFramesInFlight));
+}
+
+void FrameStreamingBuffer::onBeginFrame(unsigned int iFrameIndex) {
+    iStreamedBytesLastFrame = iStreamedBytesCurrentFrame;
+    iStreamedBytesCurrentFrame = 0;
+
+    iCurrentFrameIndex = iFrameIndex;
+    iCurrentRegionOffset = 0;
+
+    // Fences are waited in order so all frames that could use these buffers are finished.
+    vRetiredBuffers[iCurrentFrameIndex].clear();
+}
+
+StreamedBufferRange FrameStreamingBuffer::streamData(
+    const void* pData,
+    unsigned int iSizeInBytes,
+    unsigned int iAlignment,
+    unsigned int iMinRangeSizeInBytes) {
+    PROFILE_FUNC
+
+    if (iAlignment == 0) [[unlikely]] {
+        Error::showErrorAndThrowException("alignment can't be zero");
+    }
+    const auto iRangeSizeInBytes = std::max(iSizeInBytes, iMinRangeSizeInBytes);
+
+    // Align the offset.
+    auto iOffset = (iCurrentRegionOffset + iAlignment - 1) / iAlignment * iAlignment;
+    if (iOffset + iRangeSizeInBytes > iFrameRegionSizeInBytes) {
+        grow(iRangeSizeInBytes + iAlignment);
+        iOffset = 0;
+    }
+    iCurrentRegionOffset = iOffset + iRangeSizeInBytes;
+    iStreamedBytesCurrentFrame += iSizeInBytes;
+
+    const auto iBufferOffset = iCurrentFrameIndex * iFrameRegionSizeInBytes + iOffset;
+
+    if (iSizeInBytes > 0) {
+        std::scoped_lock guard(GpuResourceManager::mtx);
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, pBuffer->getBufferId());
+        {
+            // The region is not used by the GPU (we waited for the frame's fence) so don't synchronize.
+            const auto pMappedData = glMapBufferRange(
+                GL_COPY_WRITE_BUFFER,
+                static_cast<GLintptr>(iBufferOffset),
+                static_cast<GLsizeiptr>(iSizeInBytes),
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+            if (pMappedData == nullptr) [[unlikely]] {
+                Error::showErrorAndThrowException("failed to map the streaming buffer");
+            }
+
+            std::memcpy(pMappedData, pData, iSizeInBytes);
+
+            if (glUnmapBuffer(GL_COPY_WRITE_BUFFER) == GL_FALSE) [[unlikely]] {
+                Error::showErrorAndThrowException("the streaming buffer was corrupted during the upload");
+            }
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    return StreamedBufferRange{
+        .iBufferId = pBuffer->getBufferId(), .iOffset = iBufferOffset, .iSizeInBytes = iRangeSizeInBytes};
+}
+
+void FrameStreamingBuffer::grow(unsigned int iMinFrameRegionSizeInBytes) {
+    PROFILE_FUNC
+
+    size_t iNewRegionSize = std::max(
+        static_cast<size_t>(iFrameRegionSizeInBytes) * 2, static_cast<size_t>(iMinFrameRegionSizeInBytes));
+    if (iNewRegionSize * iFramesInFlight > std::numeric_limits<unsigned int>::max()) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format(
+            "streaming buffer region of {} bytes exceeds the type limit", iNewRegionSize));
+    }
+
+    Log::info(std::format(
+        "streaming buffer region is full, growing from {} KB to {} KB per frame",
+        iFrameRegionSizeInBytes / 1024,
+        iNewRegionSize / 1024));
+
+    // Ranges returned during this frame (and previous frames in-flight) still reference the old buffer.
+    vRetiredBuffers[iCurrentFrameIndex].push_back(std::move(pBuffer));
+
+    iFrameRegionSizeInBytes = static_cast<unsigned int>(iNewRegionSize);
+    pBuffer = GpuResourceManager::createStreamingBuffer(
+        iFrameRegionSizeInBytes * static_cast<unsigned int>(iFramesInFlight));
+}
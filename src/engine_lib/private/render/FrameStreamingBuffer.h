@@ -0,0 +1,134 @@
+#pragma once
+
+// Standard.
+#include <memory>
+#include <array>
+#include <vector>
+
+// Custom.
+#include "render/Renderer.h"
+#include "render/wrapper/Buffer.h"
+
+/** Part of the streaming buffer that stores data copied during the current frame. */
+struct StreamedBufferRange {
+    /** ID of the buffer that stores the data. */
+    unsigned int iBufferId = 0;
+
+    /** Offset in bytes from the start of the buffer to the data. */
+    unsigned int iOffset = 0;
+
+    /** Size of the data in bytes. */
+    unsigned int iSizeInBytes = 0;
+};
+
+/**
+ * Ring buffer for data that is uploaded to the GPU every frame (dynamic vertices, per-instance data).
+ *
+ * The buffer is split into one region per frame in-flight and each frame sub-allocates from its region
+ * using a linear (bump) pointer. A region is reused only after the renderer waited for the fence of
+ * the frame that previously used it so writes never wait for (or overwrite) data that the GPU still reads.
+ */
+class FrameStreamingBuffer {
+    // Notifies about new frames.
+    friend class Renderer;
+
+public:
+    /** Initial size (in bytes) of a region used by one frame. */
+    static constexpr unsigned int iInitialFrameRegionSizeInBytes = 512 * 1024;
+
+    FrameStreamingBuffer(const FrameStreamingBuffer&) = delete;
+    FrameStreamingBuffer& operator=(const FrameStreamingBuffer&) = delete;
+    FrameStreamingBuffer(FrameStreamingBuffer&&) noexcept = delete;
+    FrameStreamingBuffer& operator=(FrameStreamingBuffer&&) noexcept = delete;
+
+    ~FrameStreamingBuffer() = default;
+
+    /**
+     * Copies the specified data to the region of the current frame.
+     *
+     * @remark If the region does not have enough space the buffer grows (the previous buffer stays alive
+     * until the GPU finishes using it).
+     *
+     * @remark Must be called on the main thread.
+     *
+     * @param pData                Data to copy.
+     * @param iSizeInBytes         Size of the data in bytes.
+     * @param iAlignment           Alignment (in bytes) of the offset of the returned range, for example
+     * @ref getUniformBufferOffsetAlignment for uniform buffers.
+     * @param iMinRangeSizeInBytes Minimum size of the returned range, for example the size of a uniform
+     * block that is bigger than the copied data (bytes after the copied data are not initialized).
+     *
+     * @return Range that stores the data, valid until the end of the current frame.
+     */
+    StreamedBufferRange streamData(
+        const void* pData,
+        unsigned int iSizeInBytes,
+        unsigned int iAlignment,
+        unsigned int iMinRangeSizeInBytes = 0);
+
+    /**
+     * Returns alignment of offsets used to bind uniform buffers (`GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT`).
+     *
+     * @return Alignment in bytes.
+     */
+    unsigned int getUniformBufferOffsetAlignment() const { return iUniformBufferOffsetAlignment; }
+
+    /**
+     * Returns the number of bytes copied during the last finished frame.
+     *
+     * @return Size in bytes.
+     */
+    size_t getStreamedBytesLastFrame() const { return iStreamedBytesLastFrame; }
+
+    /**
+     * Returns size (in bytes) of a region used by one frame.
+     *
+     * @return Size in bytes.
+     */
+    unsigned int getFrameRegionSize() const { return iFrameRegionSizeInBytes; }
+
+private:
+    /** Creates a buffer with the initial size. */
+    FrameStreamingBuffer();
+
+    /**
+     * Called by the renderer after it waited for the fence of the frame with the specified index.
+     *
+     * @param iFrameIndex Index of the frame in-flight that will be submitted next.
+     */
+    void onBeginFrame(unsigned int iFrameIndex);
+
+    /**
+     * Replaces the buffer with a bigger one.
+     *
+     * @param iMinFrameRegionSizeInBytes Minimum size of a region used by one frame.
+     */
+    void grow(unsigned int iMinFrameRegionSizeInBytes);
+
+    /** Buffer with @ref iFramesInFlight regions. */
+    std::unique_ptr<Buffer> pBuffer;
+
+    /**
+     * Buffers replaced during @ref grow that might still be used by the GPU, index is the index of the
+     * frame in-flight that retired them (buffers are deleted once this frame index is reused).
+     */
+    std::array<std::vector<std::unique_ptr<Buffer>>, iFramesInFlight> vRetiredBuffers;
+
+    /** Size (in bytes) of a region used by one frame. */
+    unsigned int iFrameRegionSizeInBytes = iInitialFrameRegionSizeInBytes;
+
+    /** Index of the frame in-flight that is currently being submitted. */
+    unsigned int iCurrentFrameIndex = 0;
+
+    /** Offset (in bytes) from the start of the current frame's region to the free space. */
+    unsigned int iCurrentRegionOffset = 0;
+
+    /** `GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT`. */
+    unsigned int iUniformBufferOffsetAlignment = 256;
+
+    /** Bytes copied during the current frame. */
+    size_t iStreamedBytesCurrentFrame = 0;
+
+    /** Bytes copied during the last finished frame. */
+    size_t iStreamedBytesLastFrame = 0;
+};
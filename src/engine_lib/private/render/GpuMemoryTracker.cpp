@@ -0,0 +1,198 @@
+#include "render/GpuMemoryTracker.h"
+
+// Standard.
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <filesystem>
+#include <format>
+
+// Custom.
+#include "misc/Error.h"
+#include "io/Log.h"
+
+// External.
+#include "glad/glad.h"
+
+namespace {
+    /** Information about a resource that was not deleted yet. */
+    struct LiveResource {
+        /** Size of the resource in the GPU memory. */
+        size_t iSizeInBytes = 0;
+
+        /** Location of the code that requested the resource to be created. */
+        std::source_location location;
+
+        /** Category of the resource. */
+        GpuResourceCategory category = GpuResourceCategory::COUNT;
+    };
+
+    /** Groups tracked data. */
+    struct TrackedData {
+        /** Alive resources where key is a resource ID. */
+        std::unordered_map<size_t, LiveResource> liveResources;
+
+        /** Statistics where index is a category. */
+        std::array<GpuMemoryCategoryStats, static_cast<size_t>(GpuResourceCategory::COUNT)> vStats;
+
+        /** ID of the next registered resource. */
+        size_t iNextResourceId = 0;
+    };
+
+    /**
+     * Returns tracked data.
+     *
+     * @remark Function-local static so that it's alive when static objects that own resources are destroyed.
+     *
+     * @return Tracked data.
+     */
+    inline std::pair<std::mutex, TrackedData>& getTrackedData() {
+        static std::pair<std::mutex, TrackedData> mtxTrackedData;
+        return mtxTrackedData;
+    }
+}
+
+size_t GpuMemoryTracker::registerResource(
+    GpuResourceCategory category, size_t iSizeInBytes, const std::source_location& location) {
+    if (category == GpuResourceCategory::COUNT) [[unlikely]] {
+        Error::showErrorAndThrowException("invalid GPU resource category");
+    }
+
+    auto& mtxTrackedData = getTrackedData();
+    std::scoped_lock guard(mtxTrackedData.first);
+    auto& data = mtxTrackedData.second;
+
+    const auto iResourceId = data.iNextResourceId;
+    data.iNextResourceId += 1;
+    data.liveResources[iResourceId] =
+        LiveResource{.iSizeInBytes = iSizeInBytes, .location = location, .category = category};
+
+    auto& stats = data.vStats[static_cast<size_t>(category)];
+    stats.iLiveResourceCount += 1;
+    stats.iTotalBytes += iSizeInBytes;
+    stats.iPeakBytes = std::max(stats.iPeakBytes, stats.iTotalBytes);
+
+    return iResourceId;
+}
+
+void GpuMemoryTracker::unregisterResource(size_t iResourceId) {
+    auto& mtxTrackedData = getTrackedData();
+    std::scoped_lock guard(mtxTrackedData.first);
+    auto& data = mtxTrackedData.second;
+
+    const auto it = data.liveResources.find(iResourceId);
+    if (it == data.liveResources.end()) [[unlikely]] {
+        Error::showErrorAndThrowException(std::format("GPU resource {} is not registered", iResourceId));
+    }
+
+    auto& stats = data.vStats[static_cast<size_t>(it->second.category)];
+    stats.iLiveResourceCount -= 1;
+    stats.iTotalBytes -= it->second.iSizeInBytes;
+
+    data.liveResources.erase(it);
+}
+
+GpuMemoryCategoryStats GpuMemoryTracker::getStats(GpuResourceCategory category) {
+    if (category == GpuResourceCategory::COUNT) [[unlikely]] {
+        Error::showErrorAndThrowException("invalid GPU resource category");
+    }
+
+    auto& mtxTrackedData = getTrackedData();
+    std::scoped_lock guard(mtxTrackedData.first);
+
+    return mtxTrackedData.second.vStats[static_cast<size_t>(category)];
+}
+
+void GpuMemoryTracker::logLiveResources() {
+    auto& mtxTrackedData = getTrackedData();
+    std::scoped_lock guard(mtxTrackedData.first);
+    auto& data = mtxTrackedData.second;
+
+    std::string sPeakUsage;
+    for (size_t i = 0; i < data.vStats.size(); i++) {
+        sPeakUsage += std::format(
+            "{}{}: {} KB",
+            i == 0 ? "" : ", ",
+            getCategoryName(static_cast<GpuResourceCategory>(i)),
+            data.vStats[i].iPeakBytes / 1024);
+    }
+    Log::info(std::format("peak GPU memory usage of tracked resources: {}", sPeakUsage));
+
+    if (data.liveResources.empty()) {
+        return;
+    }
+
+    // Sort by creation order to make the report easier to read.
+    std::vector<std::pair<size_t, const LiveResource*>> vSortedResources;
+    vSortedResources.reserve(data.liveResources.size());
+    for (const auto& [iResourceId, resource] : data.liveResources) {
+        vSortedResources.push_back({iResourceId, &resource});
+    }
+    std::ranges::sort(vSortedResources, [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::string sReport = std::format("{} GPU resource(s) are still alive:", vSortedResources.size());
+    for (const auto& [iResourceId, pResource] : vSortedResources) {
+        sReport += std::format(
+            "\n- {} #{} ({} KB) created at {}, line {}",
+            getCategoryName(pResource->category),
+            iResourceId,
+            pResource->iSizeInBytes / 1024,
+            std::filesystem::path(pResource->location.file_name()).filename().string(),
+            pResource->location.line());
+    }
+    Log::warn(sReport);
+}
+
+size_t GpuMemoryTracker::getBytesPerPixel(int iGlFormat) {
+    switch (iGlFormat) {
+    case GL_R8:
+    case GL_RED:
+    case GL_ALPHA:
+    case GL_LUMINANCE:
+        return 1;
+    case GL_RG8:
+    case GL_R16F:
+    case GL_DEPTH_COMPONENT16:
+        return 2;
+    case GL_RGB8:
+    case GL_RGB:
+    case GL_DEPTH_COMPONENT24:
+        return 3;
+    case GL_RG16F:
+    case GL_R32F:
+    case GL_R32UI:
+    case GL_RGBA8:
+    case GL_RGBA:
+    case GL_R11F_G11F_B10F:
+    case GL_DEPTH_COMPONENT32F:
+    case GL_DEPTH24_STENCIL8:
+        return 4;
+    case GL_RGBA16F:
+    case GL_RG32F:
+    case GL_DEPTH32F_STENCIL8:
+        return 8;
+    case GL_RGBA32F:
+    case GL_RGBA32UI:
+        return 16;
+    default:
+        // Unknown format, consider it to be 4 bytes as most formats are.
+        return 4;
+    }
+}
+
+std::string_view GpuMemoryTracker::getCategoryName(GpuResourceCategory category) {
+    switch (category) {
+    case GpuResourceCategory::VERTEX_ARRAY_OBJECT:
+        return "VAO";
+    case GpuResourceCategory::BUFFER:
+        return "buffer";
+    case GpuResourceCategory::FRAMEBUFFER:
+        return "framebuffer";
+    case GpuResourceCategory::TEXTURE:
+        return "texture";
+    default:
+        Error::showErrorAndThrowException("unhandled case");
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+// Standard.
+#include <source_location>
+#include <string_view>
+
+/** Categories of GPU resources created through our wrappers. */
+enum class GpuResourceCategory : unsigned char {
+    VERTEX_ARRAY_OBJECT = 0,
+    BUFFER,
+    FRAMEBUFFER,
+    TEXTURE,
+
+    COUNT, // marks the size of this enum
+};
+
+/** Memory statistics of one GPU resource category. */
+struct GpuMemoryCategoryStats {
+    /** Number of currently alive resources. */
+    size_t iLiveResourceCount = 0;
+
+    /** Total size (in bytes) of currently alive resources. */
+    size_t iTotalBytes = 0;
+
+    /** The biggest value that @ref iTotalBytes ever had. */
+    size_t iPeakBytes = 0;
+};
+
+/**
+ * Keeps track of GPU memory used by resource wrappers (buffers, textures, etc.).
+ *
+ * @remark Wrappers register themselves when created and unregister when destroyed. Sizes are estimated
+ * from the data that we pass to OpenGL (the driver may allocate more).
+ *
+ * @remark Thread-safe.
+ */
+class GpuMemoryTracker {
+public:
+    GpuMemoryTracker() = delete;
+
+    /**
+     * Registers a new alive resource.
+     *
+     * @param category     Category of the resource.
+     * @param iSizeInBytes Size of the resource in the GPU memory.
+     * @param location     Location of the code that requested the resource to be created.
+     *
+     * @return Unique ID of the registered resource, used in @ref unregisterResource.
+     */
+    static size_t registerResource(
+        GpuResourceCategory category, size_t iSizeInBytes, const std::source_location& location);
+
+    /**
+     * Unregisters a resource that is about to be deleted.
+     *
+     * @param iResourceId ID returned by @ref registerResource.
+     */
+    static void unregisterResource(size_t iResourceId);
+
+    /**
+     * Returns memory statistics of the specified category.
+     *
+     * @param category Category of resources.
+     *
+     * @return Statistics.
+     */
+    static GpuMemoryCategoryStats getStats(GpuResourceCategory category);
+
+    /**
+     * Logs peak memory usage and all resources that are still alive with locations of code that
+     * created them.
+     *
+     * @remark Expected to be called right before the GL context is destroyed (at this point no resources
+     * should be alive).
+     */
+    static void logLiveResources();
+
+    /**
+     * Returns approximate size of one pixel of the specified format.
+     *
+     * @param iGlFormat Sized internal format, for example `GL_RGBA8`.
+     *
+     * @return Size in bytes.
+     */
+    static size_t getBytesPerPixel(int iGlFormat);
+
+    /**
+     * Returns human-readable name of the specified category.
+     *
+     * @param category Category.
+     *
+     * @return Name.
+     */
+    static std::string_view getCategoryName(GpuResourceCategory category);
+};
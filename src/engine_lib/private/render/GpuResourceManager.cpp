@@ -8,6 +8,7 @@
 // Custom.
 #include "misc/Error.h"
 #include "misc/Profiler.hpp"
+#include "render/GpuMemoryTracker.h"
 #include "render/wrapper/Texture.h"
 
 // External.
@@ -18,10 +19,8 @@ std::recursive_mutex GpuResourceManager::mtx{};
 std::unique_ptr<VertexArrayObject> GpuResourceManager::createVertexArrayObject(
     bool bIsVertexDataDynamic,
     const std::vector<glm::vec3>& vVertexPositions,
-    const std::vector<unsigned short>& vIndices) {
-    if (vVertexPositions.empty()) [[unlikely]] {
-        Error::showErrorAndThrowException("you must specify at least 1 position");
-    }
+    const std::vector<unsigned short>& vIndices,
+    const std::source_location location) {
     if (vVertexPositions.empty() && !bIsVertexDataDynamic) [[unlikely]] {
         Error::showErrorAndThrowException(
             "initial data must be specified because vertex data is not marked as dynamic");
@@ -34,17 +33,27 @@ std::unique_ptr<VertexArrayObject> GpuResourceManager::createVertexArrayObject(
     std::optional<unsigned int> optionalEbo;
     std::optional<int> optionalIndexCount;
     glGenVertexArrays(1, &iVao);
-    glGenBuffers(1, &iVbo);
 
     glBindVertexArray(iVao);
-    {
+    if (bIsVertexDataDynamic) {
+        // Describe vertex layout, the vertex buffer (range) will be bound before drawing.
+        glEnableVertexAttribArray(0);
+        glVertexAttribFormat(
+            0,        // attribute index (layout location)
+            3,        // number of components
+            GL_FLOAT, // type of component
+            GL_FALSE, // whether data should be normalized or not
+            0);       // offset relative to the bound vertex buffer range
+        glVertexAttribBinding(0, 0);
+    } else {
         // Allocate vertices.
+        glGenBuffers(1, &iVbo);
         glBindBuffer(GL_ARRAY_BUFFER, iVbo);
         GL_CHECK_ERROR(glBufferData(
             GL_ARRAY_BUFFER,
             static_cast<long long>(vVertexPositions.size() * sizeof(vVertexPositions[0])),
             vVertexPositions.data(),
-            bIsVertexDataDynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW));
+            GL_STATIC_DRAW));
 
         // Describe vertex layout.
         glEnableVertexAttribArray(0);
@@ -72,13 +81,25 @@ std::unique_ptr<VertexArrayObject> GpuResourceManager::createVertexArrayObject(
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
+    size_t iSizeInBytes = vIndices.size() * sizeof(vIndices[0]);
+    if (!bIsVertexDataDynamic) {
+        iSizeInBytes += vVertexPositions.size() * sizeof(vVertexPositions[0]);
+    }
+
     return std::unique_ptr<VertexArrayObject>(new VertexArrayObject(
-        iVao, iVbo, static_cast<unsigned int>(vVertexPositions.size()), optionalEbo, optionalIndexCount));
+        iVao,
+        iVbo,
+        bIsVertexDataDynamic ? 0 : static_cast<unsigned int>(vVertexPositions.size()),
+        optionalEbo,
+        optionalIndexCount,
+        iSizeInBytes,
+        location));
 }
 
 std::unique_ptr<ScreenQuadGeometry> GpuResourceManager::createScreenQuad(
     std::optional<std::array<ScreenQuadGeometry::VertexLayout, ScreenQuadGeometry::iVertexCount>> vertexData,
-    std::optional<std::array<unsigned short, ScreenQuadGeometry::iIndexCount>> indexData) {
+    std::optional<std::array<unsigned short, ScreenQuadGeometry::iIndexCount>> indexData,
+    const std::source_location location) {
     PROFILE_FUNC
 
     // Prepare initial vertex buffer (full screen quad with positions in normalized device coordinates).
@@ -150,11 +171,13 @@ std::unique_ptr<ScreenQuadGeometry> GpuResourceManager::createScreenQuad(
             iVbo,
             static_cast<unsigned int>(vVertices.size()),
             iEbo,
-            static_cast<int>(vIndices.size())))));
+            static_cast<int>(vIndices.size()),
+            sizeof(vVertices) + sizeof(vIndices),
+            location))));
 }
 
-std::unique_ptr<VertexArrayObject>
-GpuResourceManager::createVertexArrayObject(const MeshNodeGeometry& geometry) {
+std::unique_ptr<VertexArrayObject> GpuResourceManager::createVertexArrayObject(
+    const MeshNodeGeometry& geometry, const std::source_location location) {
     PROFILE_FUNC
 
     if (geometry.getVertices().empty() || geometry.getIndices().empty()) [[unlikely]] {
@@ -210,11 +233,14 @@ GpuResourceManager::createVertexArrayObject(const MeshNodeGeometry& geometry) {
         iVertexBufferObjectId,
         static_cast<unsigned int>(geometry.getVertices().size()),
         iIndexBufferObjectId,
-        iIndexCount));
+        iIndexCount,
+        geometry.getVertices().size() * sizeof(geometry.getVertices()[0]) +
+            geometry.getIndices().size() * sizeof(geometry.getIndices()[0]),
+        location));
 }
 
-std::unique_ptr<VertexArrayObject>
-GpuResourceManager::createVertexArrayObject(const SkeletalMeshNodeGeometry& geometry) {
+std::unique_ptr<VertexArrayObject> GpuResourceManager::createVertexArrayObject(
+    const SkeletalMeshNodeGeometry& geometry, const std::source_location location) {
     PROFILE_FUNC
 
     if (geometry.getVertices().empty() || geometry.getIndices().empty()) [[unlikely]] {
@@ -269,11 +295,18 @@ GpuResourceManager::createVertexArrayObject(const SkeletalMeshNodeGeometry& geom
         iVertexBufferObjectId,
         static_cast<unsigned int>(geometry.getVertices().size()),
         iIndexBufferObjectId,
-        iIndexCount));
+        iIndexCount,
+        geometry.getVertices().size() * sizeof(geometry.getVertices()[0]) +
+            geometry.getIndices().size() * sizeof(geometry.getIndices()[0]),
+        location));
 }
 
 std::unique_ptr<Framebuffer> GpuResourceManager::createFramebuffer(
-    unsigned int iWidth, unsigned int iHeight, int iColorGlFormat, int iDepthGlFormat) {
+    unsigned int iWidth,
+    unsigned int iHeight,
+    int iColorGlFormat,
+    int iDepthGlFormat,
+    const std::source_location location) {
     PROFILE_FUNC
 
     std::scoped_lock guard(mtx);
@@ -356,12 +389,26 @@ std::unique_ptr<Framebuffer> GpuResourceManager::createFramebuffer(
     glBindTexture(GL_TEXTURE_2D, 0);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-    return std::unique_ptr<Framebuffer>(
-        new Framebuffer(iFramebufferId, iColorTextureId, iDepthStencilBufferId, iWidth, iHeight));
+    size_t iBytesPerPixel = 0;
+    if (iColorGlFormat != 0) {
+        iBytesPerPixel += GpuMemoryTracker::getBytesPerPixel(iColorGlFormat);
+    }
+    if (iDepthGlFormat != 0) {
+        iBytesPerPixel += GpuMemoryTracker::getBytesPerPixel(iDepthGlFormat);
+    }
+
+    return std::unique_ptr<Framebuffer>(new Framebuffer(
+        iFramebufferId,
+        iColorTextureId,
+        iDepthStencilBufferId,
+        iWidth,
+        iHeight,
+        static_cast<size_t>(iWidth) * iHeight * iBytesPerPixel,
+        location));
 }
 
-std::unique_ptr<Framebuffer>
-GpuResourceManager::createShadowMapFramebuffer(Texture& shadowMapArray, unsigned int iTextureIndex) {
+std::unique_ptr<Framebuffer> GpuResourceManager::createShadowMapFramebuffer(
+    Texture& shadowMapArray, unsigned int iTextureIndex, const std::source_location location) {
     unsigned int iFramebufferId = 0;
     glGenFramebuffers(1, &iFramebufferId);
     glBindFramebuffer(GL_FRAMEBUFFER, iFramebufferId);
@@ -384,11 +431,18 @@ GpuResourceManager::createShadowMapFramebuffer(Texture& shadowMapArray, unsigned
         0,
         shadowMapArray.getTextureId(),
         shadowMapArray.getSize().first,
-        shadowMapArray.getSize().second));
+        shadowMapArray.getSize().second,
+        0, // memory is owned by the texture array
+        location));
 }
 
 std::unique_ptr<Texture> GpuResourceManager::createTextureArray(
-    unsigned int iWidth, unsigned int iHeight, int iGlFormat, unsigned int iArraySize, bool bIsShadowMaps) {
+    unsigned int iWidth,
+    unsigned int iHeight,
+    int iGlFormat,
+    unsigned int iArraySize,
+    bool bIsShadowMaps,
+    const std::source_location location) {
     unsigned int iTexArrayId = 0;
     glGenTextures(1, &iTexArrayId);
     glBindTexture(GL_TEXTURE_2D_ARRAY, iTexArrayId);
@@ -409,10 +463,18 @@ std::unique_ptr<Texture> GpuResourceManager::createTextureArray(
         glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     }
 
-    return std::unique_ptr<Texture>(new Texture(iTexArrayId, iWidth, iHeight, iGlFormat));
+    return std::unique_ptr<Texture>(new Texture(
+        iTexArrayId,
+        iWidth,
+        iHeight,
+        iGlFormat,
+        static_cast<size_t>(iWidth) * iHeight * iArraySize *
+            GpuMemoryTracker::getBytesPerPixel(iGlFormat),
+        location));
 }
 
-std::unique_ptr<Buffer> GpuResourceManager::createUniformBuffer(unsigned int iSizeInBytes, bool bIsDynamic) {
+std::unique_ptr<Buffer> GpuResourceManager::createUniformBuffer(
+    unsigned int iSizeInBytes, bool bIsDynamic, const std::source_location location) {
     PROFILE_FUNC
 
     std::scoped_lock guard(mtx);
@@ -428,10 +490,11 @@ std::unique_ptr<Buffer> GpuResourceManager::createUniformBuffer(unsigned int iSi
     }
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
-    return std::unique_ptr<Buffer>(new Buffer(iSizeInBytes, iBufferId, GL_UNIFORM_BUFFER, bIsDynamic));
+    return std::unique_ptr<Buffer>(new Buffer(iSizeInBytes, iBufferId, GL_UNIFORM_BUFFER, bIsDynamic, location));
 }
 
-std::unique_ptr<Buffer> GpuResourceManager::createStorageBuffer(unsigned int iSizeInBytes) {
+std::unique_ptr<Buffer>
+GpuResourceManager::createStorageBuffer(unsigned int iSizeInBytes, const std::source_location location) {
     PROFILE_FUNC
 
     std::scoped_lock guard(mtx);
@@ -446,11 +509,33 @@ std::unique_ptr<Buffer> GpuResourceManager::createStorageBuffer(unsigned int iSi
     }
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
-    return std::unique_ptr<Buffer>(new Buffer(iSizeInBytes, iBufferId, GL_SHADER_STORAGE_BUFFER, false));
+    return std::unique_ptr<Buffer>(
+        new Buffer(iSizeInBytes, iBufferId, GL_SHADER_STORAGE_BUFFER, false, location));
+}
+
+std::unique_ptr<Buffer>
+GpuResourceManager::createStreamingBuffer(unsigned int iSizeInBytes, const std::source_location location) {
+    PROFILE_FUNC
+
+    std::scoped_lock guard(mtx);
+
+    unsigned int iBufferId = 0;
+    glGenBuffers(1, &iBufferId);
+
+    // Allocate buffer (use a generic binding point because it will be used as vertex and uniform buffer).
+    glBindBuffer(GL_COPY_WRITE_BUFFER, iBufferId);
+    {
+        GL_CHECK_ERROR(glBufferData(GL_COPY_WRITE_BUFFER, iSizeInBytes, nullptr, GL_STREAM_DRAW));
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    // Data is written using mapping (not through `copyDataToBuffer`).
+    return std::unique_ptr<Buffer>(
+        new Buffer(iSizeInBytes, iBufferId, GL_COPY_WRITE_BUFFER, false, location));
 }
 
-std::unique_ptr<Texture>
-GpuResourceManager::createStorageTexture(unsigned int iWidth, unsigned int iHeight, int iFormat) {
+std::unique_ptr<Texture> GpuResourceManager::createStorageTexture(
+    unsigned int iWidth, unsigned int iHeight, int iFormat, const std::source_location location) {
     PROFILE_FUNC
 
     std::scoped_lock guard(mtx);
@@ -466,5 +551,11 @@ GpuResourceManager::createStorageTexture(unsigned int iWidth, unsigned int iHeig
     }
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    return std::unique_ptr<Texture>(new Texture(iTextureId, iWidth, iHeight, iFormat));
+    return std::unique_ptr<Texture>(new Texture(
+        iTextureId,
+        iWidth,
+        iHeight,
+        iFormat,
+        static_cast<size_t>(iWidth) * iHeight * GpuMemoryTracker::getBytesPerPixel(iFormat),
+        location));
 }
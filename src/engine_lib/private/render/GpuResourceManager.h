@@ -4,6 +4,7 @@
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <source_location>
 
 // Custom.
 #include "game/geometry/MeshNodeGeometry.h"
@@ -28,17 +29,22 @@ public:
     /**
      * Creates a new vertex array object for N positions (vec3) and optionally N indices.
      *
-     * @param bIsVertexDataDynamic Specify `true` if vertex positions will change, otherwise
-     * specify `false`.
-     * @param vVertexPositions     Specify non-empty to copy the data to the vertex buffer.
+     * @param bIsVertexDataDynamic Specify `true` if vertex positions will change every frame, in this
+     * case the VAO does not have its own vertex buffer, instead positions are expected to be copied to
+     * the @ref FrameStreamingBuffer and bound using `glBindVertexBuffer` (binding index 0) before drawing.
+     * Otherwise specify `false`.
+     * @param vVertexPositions     Positions to copy to the vertex buffer (ignored if data is dynamic).
      * @param vIndices             Specify empty array to avoid creating index buffer.
+     * @param location             Location of the code that requests the VAO (used in GPU memory
+     * tracking).
      *
      * @return VAO.
      */
     static std::unique_ptr<VertexArrayObject> createVertexArrayObject(
         bool bIsVertexDataDynamic,
         const std::vector<glm::vec3>& vVertexPositions = {},
-        const std::vector<unsigned short>& vIndices = {});
+        const std::vector<unsigned short>& vIndices = {},
+        const std::source_location location = std::source_location::current());
 
     /**
      * Creates a new quad.
@@ -46,32 +52,39 @@ public:
      * @param vertexData Optionally specify initial positions of quad vertices. If empty creates
      * a full screen quad with data in normalized device coordinates.
      * @param indexData  Optionally specify indices (otherwise default will be used).
+     * @param location   Location of the code that requests the quad (used in GPU memory tracking).
      *
      * @return Quad.
      */
     static std::unique_ptr<ScreenQuadGeometry> createScreenQuad(
         std::optional<std::array<ScreenQuadGeometry::VertexLayout, ScreenQuadGeometry::iVertexCount>>
             vertexData = {},
-        std::optional<std::array<unsigned short, ScreenQuadGeometry::iIndexCount>> indexData = {});
+        std::optional<std::array<unsigned short, ScreenQuadGeometry::iIndexCount>> indexData = {},
+        const std::source_location location = std::source_location::current());
 
     /**
      * Creates a VAO from the specified geometry.
      *
      * @param geometry Geometry to load.
+     * @param location Location of the code that requests the VAO (used in GPU memory tracking).
      *
      * @return Created VAO.
      */
-    static std::unique_ptr<VertexArrayObject> createVertexArrayObject(const MeshNodeGeometry& geometry);
+    static std::unique_ptr<VertexArrayObject> createVertexArrayObject(
+        const MeshNodeGeometry& geometry,
+        const std::source_location location = std::source_location::current());
 
     /**
      * Creates a VAO from the specified geometry.
      *
      * @param geometry Geometry to load.
+     * @param location Location of the code that requests the VAO (used in GPU memory tracking).
      *
      * @return Created VAO.
      */
-    static std::unique_ptr<VertexArrayObject>
-    createVertexArrayObject(const SkeletalMeshNodeGeometry& geometry);
+    static std::unique_ptr<VertexArrayObject> createVertexArrayObject(
+        const SkeletalMeshNodeGeometry& geometry,
+        const std::source_location location = std::source_location::current());
 
     /**
      * Creates a new framebuffer with textures.
@@ -82,22 +95,32 @@ public:
      * in the framebuffer.
      * @param iDepthGlFormat Specify 0 to create a framebuffer without depth. Otherwise GL format of the
      * depth/stencil buffer in the framebuffer.
+     * @param location       Location of the code that requests the framebuffer (used in GPU memory
+     * tracking).
      *
      * @return Created framebuffer.
      */
-    static std::unique_ptr<Framebuffer>
-    createFramebuffer(unsigned int iWidth, unsigned int iHeight, int iColorGlFormat, int iDepthGlFormat);
+    static std::unique_ptr<Framebuffer> createFramebuffer(
+        unsigned int iWidth,
+        unsigned int iHeight,
+        int iColorGlFormat,
+        int iDepthGlFormat,
+        const std::source_location location = std::source_location::current());
 
     /**
      * Creates a new framebuffer for shadow pass.
      *
      * @param shadowMapArray Texture array of shadow maps.
      * @param iTextureIndex  Index of the texture (in the array) to attach to framebuffer.
+     * @param location       Location of the code that requests the framebuffer (used in GPU memory
+     * tracking).
      *
      * @return Created framebuffer.
      */
-    static std::unique_ptr<Framebuffer>
-    createShadowMapFramebuffer(Texture& shadowMapArray, unsigned int iTextureIndex);
+    static std::unique_ptr<Framebuffer> createShadowMapFramebuffer(
+        Texture& shadowMapArray,
+        unsigned int iTextureIndex,
+        const std::source_location location = std::source_location::current());
 
     /**
      * Creates texture array object.
@@ -107,6 +130,7 @@ public:
      * @param iGlFormat  GL format of the textures.
      * @param iArraySize Size of the array.
      * @param bIsShadowMaps `true` to enable hardware anti-aliasing of shadow maps.
+     * @param location   Location of the code that requests the texture (used in GPU memory tracking).
      *
      * @return Created texture array.
      */
@@ -115,7 +139,8 @@ public:
         unsigned int iHeight,
         int iGlFormat,
         unsigned int iArraySize,
-        bool bIsShadowMaps);
+        bool bIsShadowMaps,
+        const std::source_location location = std::source_location::current());
 
     /**
      * Creates a new uniform buffer.
@@ -123,19 +148,36 @@ public:
      * @param iSizeInBytes Size of the buffer in bytes.
      * @param bIsDynamic   Specify `false` if this buffer will not be modified from the CPU side
      * and `true` if you plan on updating the contents of this buffer often.
+     * @param location     Location of the code that requests the buffer (used in GPU memory tracking).
      *
      * @return Created buffer.
      */
-    static std::unique_ptr<Buffer> createUniformBuffer(unsigned int iSizeInBytes, bool bIsDynamic);
+    static std::unique_ptr<Buffer> createUniformBuffer(
+        unsigned int iSizeInBytes,
+        bool bIsDynamic,
+        const std::source_location location = std::source_location::current());
 
     /**
      * Creates a new shader storage buffer object (SSBO).
      *
      * @param iSizeInBytes Size of the buffer in bytes.
+     * @param location     Location of the code that requests the buffer (used in GPU memory tracking).
      *
      * @return Created buffer.
      */
-    static std::unique_ptr<Buffer> createStorageBuffer(unsigned int iSizeInBytes);
+    static std::unique_ptr<Buffer> createStorageBuffer(
+        unsigned int iSizeInBytes, const std::source_location location = std::source_location::current());
+
+    /**
+     * Creates a new buffer for data that is rewritten every frame (see @ref FrameStreamingBuffer).
+     *
+     * @param iSizeInBytes Size of the buffer in bytes.
+     * @param location     Location of the code that requests the buffer (used in GPU memory tracking).
+     *
+     * @return Created buffer.
+     */
+    static std::unique_ptr<Buffer> createStreamingBuffer(
+        unsigned int iSizeInBytes, const std::source_location location = std::source_location::current());
 
     /**
      * Creates a new storage image (image to write to from shaders).
@@ -143,11 +185,15 @@ public:
      * @param iWidth  Width of the texture in pixels.
      * @param iHeight Height of the texture in pixels.
      * @param iFormat Format of the texture, for example `GL_R32UI`.
+     * @param location Location of the code that requests the texture (used in GPU memory tracking).
      *
      * @return Created texture.
      */
-    static std::unique_ptr<Texture>
-    createStorageTexture(unsigned int iWidth, unsigned int iHeight, int iFormat);
+    static std::unique_ptr<Texture> createStorageTexture(
+        unsigned int iWidth,
+        unsigned int iHeight,
+        int iFormat,
+        const std::source_location location = std::source_location::current());
 
     /**
      * Mutex to guard OpenGL context modification.
@@ -0,0 +1,3 @@
+#pragma once
+
+constexpr unsigned int MAX_MESH_LOD_COUNT = 5; // <- original geometry + simplified LODs
@@ -1,5 +1,9 @@
 #include "MeshRenderer.h"
 
+// Standard.
+#include <algorithm>
+#include <functional>
+
 // Custom.
 #include "game/node/MeshNode.h"
 #include "render/LightSourceManager.h"
@@ -11,6 +15,7 @@
 #include "render/RenderingHandle.h"
 #include "render/wrapper/Framebuffer.h"
 #include "render/wrapper/Texture.h"
+#include "material/TextureManager.h"
 #include "game/node/light/SpotlightNode.h"
 #include "game/node/light/PointLightNode.h"
 #include "render/GpuTimeQuery.hpp"
@@ -38,6 +43,12 @@ MeshRenderer::RenderData::ShaderInfo::create(ShaderProgram* pShaderProgram) {
     ShaderInfo info{};
     info.pShaderProgram = pShaderProgram;
 
+    // Uniforms will be cached once the program is compiled (see `updatePendingShaders`).
+    if (!pShaderProgram->isReady()) {
+        return info;
+    }
+    info.bIsReady = true;
+
     // Collect uniforms from a shader program that only has vertex shader linked.
     {
         const auto iVertexOnlyProgramId = pShaderProgram->getVertexOnlyShaderProgramId();
@@ -61,14 +72,19 @@ MeshRenderer::RenderData::ShaderInfo::create(ShaderProgram* pShaderProgram) {
     info.iWorldMatrixUniform = pShaderProgram->getShaderUniformLocation("worldMatrix");
     info.iNormalMatrixUniform = pShaderProgram->getShaderUniformLocation("normalMatrix");
     info.iDiffuseColorUniform = pShaderProgram->getShaderUniformLocation("diffuseColor");
+
+    // Uniforms below might be removed at compile time depending on the program's shader features
+    // (setting a uniform at location -1 is ignored by OpenGL).
     info.iTextureTilingMultiplierUniform =
-        pShaderProgram->getShaderUniformLocation("textureTilingMultiplier");
-    info.iTextureUvOffsetUniform = pShaderProgram->getShaderUniformLocation("textureUvOffset");
-    info.iDiffuseTextureUniform = pShaderProgram->getShaderUniformLocation("diffuseTexture");
-    info.iOutlineWidthUniform = pShaderProgram->getShaderUniformLocation("outlineWidth");
+        pShaderProgram->tryGetShaderUniformLocation("textureTilingMultiplier");
+    info.iTextureUvOffsetUniform = pShaderProgram->tryGetShaderUniformLocation("textureUvOffset");
+    info.iDiffuseTextureUniform = pShaderProgram->tryGetShaderUniformLocation("diffuseTexture");
+    info.iOutlineWidthUniform = pShaderProgram->tryGetShaderUniformLocation("outlineWidth");
+    info.iSpotShadowMapsUniform = pShaderProgram->tryGetShaderUniformLocation("spotShadowMaps");
+    info.iDistanceFogColorUniform = pShaderProgram->tryGetShaderUniformLocation("distanceFogColor");
+    info.iDistanceFogRangeUniform = pShaderProgram->tryGetShaderUniformLocation("distanceFogRange");
 
     info.iSkinningMatricesUniform = pShaderProgram->tryGetShaderUniformLocation("vSkinningMatrices[0]");
-    info.iSpotShadowMapsUniform = pShaderProgram->getShaderUniformLocation("spotShadowMaps");
     info.iIsSpotlightCulledUniform = pShaderProgram->getShaderUniformLocation("isSpotlightCulled[0]");
     info.iIsPointLightCulledUniform = pShaderProgram->getShaderUniformLocation("isPointLightCulled[0]");
 
@@ -83,9 +99,6 @@ MeshRenderer::RenderData::ShaderInfo::create(ShaderProgram* pShaderProgram) {
     info.iDirectionalLightsUniformBlockBindingIndex =
         pShaderProgram->getShaderUniformBlockBindingIndex("DirectionalLights");
 
-    info.iDistanceFogColorUniform = pShaderProgram->getShaderUniformLocation("distanceFogColor");
-    info.iDistanceFogRangeUniform = pShaderProgram->getShaderUniformLocation("distanceFogRange");
-
     info.iViewMatrixUniform = pShaderProgram->getShaderUniformLocation("viewMatrix");
     info.iViewProjectionMatrixUniform = pShaderProgram->getShaderUniformLocation("viewProjectionMatrix");
 
@@ -331,6 +344,13 @@ MeshRenderer::addMeshForRendering(ShaderProgram* pShaderProgram, bool bEnableTra
 void MeshRenderer::onBeforeHandleDestroyed(MeshRenderingHandle* pHandle) {
     PROFILE_FUNC
 
+    // Forget transforms queued for this mesh.
+    if (transformBatch.bIsActive) {
+        std::erase_if(transformBatch.vTransforms, [pHandle](const MeshTransform& transform) {
+            return transform.pHandle == pHandle;
+        });
+    }
+
     std::scoped_lock guard(mtxRenderData.first);
     auto& data = mtxRenderData.second;
 
@@ -512,6 +532,69 @@ void MeshRenderer::runDebugIndexValidation() {
 }
 #endif
 
+thread_local MeshRenderer::TransformBatch MeshRenderer::transformBatch;
+
+void MeshRenderer::beginTransformBatch() {
+    if (transformBatch.bIsActive) [[unlikely]] {
+        Error::showErrorAndThrowException("a mesh transform batch was already started on this thread");
+    }
+
+    transformBatch.bIsActive = true;
+}
+
+void MeshRenderer::endTransformBatch() {
+    PROFILE_FUNC
+
+    auto& vTransforms = transformBatch.vTransforms;
+    transformBatch.bIsActive = false;
+    if (vTransforms.empty()) {
+        return;
+    }
+
+    // Group by mesh renderer (keep the order of changes so that the last transform of a mesh wins).
+    std::stable_sort(
+        vTransforms.begin(), vTransforms.end(), [](const MeshTransform& a, const MeshTransform& b) {
+            return std::less<MeshRenderer*>{}(a.pHandle->pMeshRenderer, b.pHandle->pMeshRenderer);
+        });
+
+    size_t iGroupStart = 0;
+    for (size_t i = 1; i <= vTransforms.size(); i++) {
+        if (i < vTransforms.size() &&
+            vTransforms[i].pHandle->pMeshRenderer == vTransforms[iGroupStart].pHandle->pMeshRenderer) {
+            continue;
+        }
+
+        vTransforms[iGroupStart].pHandle->pMeshRenderer->writeMeshTransforms(
+            &vTransforms[iGroupStart], i - iGroupStart);
+        iGroupStart = i;
+    }
+
+    vTransforms.clear();
+}
+
+void MeshRenderer::setMeshTransform(const MeshTransform& transform) {
+    if (transformBatch.bIsActive) {
+        transformBatch.vTransforms.push_back(transform);
+        return;
+    }
+
+    transform.pHandle->pMeshRenderer->writeMeshTransforms(&transform, 1);
+}
+
+void MeshRenderer::writeMeshTransforms(const MeshTransform* pTransforms, size_t iCount) {
+    std::scoped_lock guard(mtxRenderData.first);
+    auto& data = mtxRenderData.second;
+
+    for (size_t i = 0; i < iCount; i++) {
+        const auto& transform = pTransforms[i];
+        auto& meshData = data.vMeshRenderData[transform.pHandle->iMeshRenderDataIndex];
+
+        meshData.worldMatrix = transform.worldMatrix;
+        meshData.normalMatrix = transform.normalMatrix;
+        meshData.aabbWorld = transform.aabbWorld;
+    }
+}
+
 MeshRenderDataGuard MeshRenderer::getMeshRenderData(MeshRenderingHandle& handle) {
     mtxRenderData.first.lock(); // guard will unlock it when destroyed
     auto& data = mtxRenderData.second;
@@ -523,6 +606,7 @@ void MeshRenderer::drawMeshes(
     Renderer* pRenderer,
     const glm::ivec4& viewportSize,
     const glm::mat4& viewMatrix,
+    const glm::mat4& projectionMatrix,
     const glm::mat4& viewProjectionMatrix,
     const Frustum& cameraFrustum,
     LightSourceManager& lightSourceManager,
@@ -549,6 +633,9 @@ void MeshRenderer::drawMeshes(
         mtxDirectionalLightData.second.visibleLightNodes.size();
 #endif
 
+    updatePendingShaders(data);
+    selectMainViewLods(data, viewMatrix, projectionMatrix);
+
     auto lightCullingInfo = drawShadowPass(
         data, cameraFrustum, mtxPointLightData.second, mtxSpotlightData.second, iGlDrawShadowPassQuery);
     glBindFramebuffer(GL_FRAMEBUFFER, 0); // <- restore framebuffer from shadow pass
@@ -616,13 +703,85 @@ void MeshRenderer::drawMeshes(
     }
 }
 
+unsigned char MeshRenderer::selectLod(
+    const MeshRenderData& meshData,
+    unsigned char iCurrentLod,
+    const glm::vec3& viewPosition,
+    float projectionScale,
+    float thresholdMultiplier) {
+    if (meshData.iLodCount <= 1) {
+        return 0;
+    }
+
+    // Calculate the projected size of the bounding sphere relative to the screen height.
+    const auto distance = glm::distance(viewPosition, meshData.aabbWorld.center);
+    const auto radius = glm::length(meshData.aabbWorld.extents);
+    if (distance <= radius) {
+        return 0;
+    }
+    const auto screenSize = radius * projectionScale / distance;
+
+    // Switch to less detailed LODs.
+    size_t iLod = std::min(static_cast<size_t>(iCurrentLod), static_cast<size_t>(meshData.iLodCount - 1));
+    while (iLod + 1 < meshData.iLodCount &&
+           screenSize < vLodScreenSizeThresholds[iLod] * thresholdMultiplier) {
+        iLod += 1;
+    }
+
+    // Switch to more detailed LODs (using hysteresis).
+    while (iLod > 0 &&
+           screenSize > vLodScreenSizeThresholds[iLod - 1] * thresholdMultiplier * (1.0f + lodHysteresis)) {
+        iLod -= 1;
+    }
+
+    return static_cast<unsigned char>(iLod);
+}
+
+void MeshRenderer::updatePendingShaders(RenderData& data) {
+    PROFILE_FUNC
+
+    for (auto pShaders : {&data.vOpaqueShaders, &data.vTransparentShaders}) {
+        for (auto& shaderInfo : *pShaders) {
+            if (shaderInfo.bIsReady || !shaderInfo.pShaderProgram->isReady()) {
+                continue;
+            }
+
+            const auto iFirstMeshIndex = shaderInfo.iFirstMeshIndex;
+            const auto iMeshCount = shaderInfo.iMeshCount;
+            shaderInfo = RenderData::ShaderInfo::create(shaderInfo.pShaderProgram);
+            shaderInfo.iFirstMeshIndex = iFirstMeshIndex;
+            shaderInfo.iMeshCount = iMeshCount;
+        }
+    }
+}
+
+void MeshRenderer::selectMainViewLods(
+    RenderData& data, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) {
+    PROFILE_FUNC
+
+    const auto viewPosition = glm::vec3(glm::inverse(viewMatrix)[3]);
+    const auto projectionScale = projectionMatrix[1][1];
+
+    for (unsigned short i = 0; i < data.iRegisteredMeshCount; i++) {
+        auto& meshData = data.vMeshRenderData[i];
+        meshData.iMainViewLod =
+            selectLod(meshData, meshData.iMainViewLod, viewPosition, projectionScale, 1.0f);
+    }
+}
+
 void MeshRenderer::drawMeshesVertexShaderOnly(
-    const RenderData& data,
+    RenderData& data,
     const std::vector<RenderData::ShaderInfo>& vShaders,
     const glm::mat4& viewMatrix,
     const glm::mat4& viewProjectionMatrix,
-    const Frustum& cameraFrustum) {
+    const Frustum& cameraFrustum,
+    bool bIsShadowView) {
     for (const auto& shaderInfo : vShaders) {
+        if (!shaderInfo.bIsReady) {
+            // Still compiling.
+            continue;
+        }
+
         glUseProgram(shaderInfo.pShaderProgram->getVertexOnlyShaderProgramId());
 
         glUniformMatrix4fv(shaderInfo.iVertexOnlyViewMatrixUniform, 1, GL_FALSE, glm::value_ptr(viewMatrix));
@@ -643,7 +802,15 @@ void MeshRenderer::drawMeshesVertexShaderOnly(
                 continue;
             }
 
-            glBindVertexArray(meshData.iVertexArrayObject);
+            // Select LOD.
+            unsigned char iLod = meshData.iMainViewLod;
+            if (bIsShadowView) {
+                iLod = static_cast<unsigned char>(
+                    std::min(iLod + iShadowLodBias, static_cast<int>(meshData.iLodCount) - 1));
+            }
+            const auto iIndexCount = meshData.vIndexCounts[iLod];
+
+            glBindVertexArray(meshData.vVertexArrayObjects[iLod]);
 
             glUniformMatrix4fv(
                 shaderInfo.iVertexOnlyWorldMatrixUniform, 1, GL_FALSE, glm::value_ptr(meshData.worldMatrix));
@@ -663,18 +830,18 @@ void MeshRenderer::drawMeshesVertexShaderOnly(
             if (meshData.outlineWidth > 0.0f) {
                 glUniform1f(shaderInfo.iVertexOnlyOutlineWidthUniform, meshData.outlineWidth);
                 glCullFace(GL_FRONT);
-                glDrawElements(GL_TRIANGLES, meshData.iIndexCount, GL_UNSIGNED_SHORT, nullptr);
+                glDrawElements(GL_TRIANGLES, iIndexCount, GL_UNSIGNED_SHORT, nullptr);
                 glCullFace(GL_BACK);
             }
 
             glUniform1f(shaderInfo.iVertexOnlyOutlineWidthUniform, 0.0f);
-            glDrawElements(GL_TRIANGLES, meshData.iIndexCount, GL_UNSIGNED_SHORT, nullptr);
+            glDrawElements(GL_TRIANGLES, iIndexCount, GL_UNSIGNED_SHORT, nullptr);
         }
     }
 }
 
 MeshRenderer::LightCullingInfo MeshRenderer::drawShadowPass(
-    const RenderData& data,
+    RenderData& data,
     const Frustum& cameraFrustum,
     LightSourceShaderArray::LightData& pointLightData,
     LightSourceShaderArray::LightData& spotlightData,
@@ -745,7 +912,8 @@ MeshRenderer::LightCullingInfo MeshRenderer::drawShadowPass(
             data.vOpaqueShaders,
             pShadowData->viewMatrix,
             pSpotlightNode->getLightViewProjectionMatrix(),
-            pShadowData->frustumWorld);
+            pShadowData->frustumWorld,
+            true);
 
         glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
     }
@@ -769,7 +937,7 @@ MeshRenderer::LightCullingInfo MeshRenderer::drawShadowPass(
 
 void MeshRenderer::drawDepthPrepass(
     Renderer* pRenderer,
-    const RenderData& data,
+    RenderData& data,
     const Frustum& cameraFrustum,
     const glm::mat4& viewMatrix,
     const glm::mat4& viewProjectionMatrix,
@@ -785,7 +953,8 @@ void MeshRenderer::drawDepthPrepass(
     glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
     glDepthFunc(GL_LESS);
 
-    drawMeshesVertexShaderOnly(data, data.vOpaqueShaders, viewMatrix, viewProjectionMatrix, cameraFrustum);
+    drawMeshesVertexShaderOnly(
+        data, data.vOpaqueShaders, viewMatrix, viewProjectionMatrix, cameraFrustum, false);
 
     glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
     glDepthFunc(pRenderer->getCurrentGlDepthFunc());
@@ -826,6 +995,11 @@ void MeshRenderer::drawMeshes(
     const auto& optDistanceFog = pRenderer->getDistanceFogSettings();
 
     for (const auto& shaderInfo : vShaders) {
+        if (!shaderInfo.bIsReady) {
+            // Still compiling.
+            continue;
+        }
+
         glUseProgram(shaderInfo.pShaderProgram->getShaderProgramId());
 
         shaderConstantsSetter.setConstantsToShader(shaderInfo.pShaderProgram);
@@ -894,6 +1068,7 @@ void MeshRenderer::drawMeshes(
         glActiveTexture(GL_TEXTURE1);
         glBindTexture(GL_TEXTURE_2D, 0);                   // <- empty for now
         glUniform1i(shaderInfo.iDiffuseTextureUniform, 1); // <- assign texture unit
+        auto& textureManager = pRenderer->getTextureManager();
 
         // Submit meshes.
         for (unsigned short iMeshDataIndex = shaderInfo.iFirstMeshIndex;
@@ -912,10 +1087,11 @@ void MeshRenderer::drawMeshes(
             glUniform1ui(shaderInfo.iNodeIdUniform, meshData.iNodeId);
 #endif
 
-            glBindVertexArray(meshData.iVertexArrayObject);
+            glBindVertexArray(meshData.vVertexArrayObjects[meshData.iMainViewLod]);
 
             // Binds 0 (no texture) if not set.
             glBindTexture(GL_TEXTURE_2D, meshData.iDiffuseTextureId);
+            textureManager.markTextureAsVisible(meshData.iDiffuseTextureId);
 
             // Set uniforms.
             glUniformMatrix4fv(
@@ -937,7 +1113,8 @@ void MeshRenderer::drawMeshes(
                     meshData.pSkinningMatrices);
             }
 
-            glDrawElements(GL_TRIANGLES, meshData.iIndexCount, GL_UNSIGNED_SHORT, nullptr);
+            glDrawElements(
+                GL_TRIANGLES, meshData.vIndexCounts[meshData.iMainViewLod], GL_UNSIGNED_SHORT, nullptr);
 #if defined(ENGINE_DEBUG_TOOLS)
             debugStats.iRenderedMeshCount += 1;
 #endif
@@ -13,6 +13,7 @@
 #include "render/ShaderConstantsSetter.hpp"
 #include "game/geometry/shapes/Frustum.h"
 #include "render/LightSourceLimits.hpp"
+#include "render/MeshLodLimits.hpp"
 #include "math/GLMath.hpp"
 
 #ifdef __cpp_lib_hardware_interference_size
@@ -38,8 +39,8 @@ struct alignas(hardware_constructive_interference_size) MeshRenderData {
     glm::vec2 textureTilingMultiplier;
     unsigned int iDiffuseTextureId = 0; // 0 if not used
     AABB aabbWorld;
-    unsigned int iVertexArrayObject = 0;
-    int iIndexCount = 0;
+    std::array<unsigned int, MAX_MESH_LOD_COUNT> vVertexArrayObjects{}; // index is LOD
+    std::array<int, MAX_MESH_LOD_COUNT> vIndexCounts{};                 // index is LOD
     glm::vec2 textureUvOffset;
 
     // for skeletal meshes:
@@ -51,8 +52,11 @@ struct alignas(hardware_constructive_interference_size) MeshRenderData {
 #if defined(ENGINE_EDITOR)
     unsigned int iNodeId = 0;
 #endif
+
+    unsigned char iLodCount = 1;    // number of valid elements in LOD arrays
+    unsigned char iMainViewLod = 0; // LOD selected for the camera
 };
-static_assert(sizeof(MeshRenderData) == hardware_constructive_interference_size * 3);
+static_assert(sizeof(MeshRenderData) == hardware_constructive_interference_size * 4);
 
 /// @endcond
 
@@ -111,6 +115,43 @@ class MeshRenderer {
     friend class MeshRenderDataGuard;
 
 public:
+    /**
+     * LOD N + 1 is used when the projected size of the mesh (relative to the screen height)
+     * becomes smaller than the value at index N.
+     */
+    static constexpr std::array<float, MAX_MESH_LOD_COUNT - 1> vLodScreenSizeThresholds = {
+        0.25f, 0.12f, 0.06f, 0.03f};
+
+    /**
+     * Relative amount that the projected size of the mesh should exceed a threshold by
+     * to switch back to a more detailed LOD (prevents LOD flickering on threshold boundaries).
+     */
+    static constexpr float lodHysteresis = 0.15f;
+
+    /**
+     * Number of LODs added to the LOD selected for the camera to get LOD for shadow map views (shadows
+     * use coarser LODs).
+     *
+     * @remark Shadow LODs are derived from the camera LOD (instead of having a state per shadow view)
+     * so that all shadow views of a mesh use the same LOD and its hysteresis.
+     */
+    static constexpr unsigned char iShadowLodBias = 1;
+
+    /** New world transform of a registered mesh. */
+    struct MeshTransform {
+        /** Handle of the mesh. */
+        MeshRenderingHandle* pHandle = nullptr;
+
+        /** World matrix of the mesh. */
+        glm::mat4 worldMatrix;
+
+        /** Normal matrix for @ref worldMatrix. */
+        glm::mat3 normalMatrix;
+
+        /** Bounds of the mesh in world space. */
+        AABB aabbWorld;
+    };
+
     /** Groups data for drawing. */
     struct RenderData {
         RenderData() = default;
@@ -131,7 +172,8 @@ public:
             ShaderInfo() = default;
 
             /**
-             * Creates a new shader info and caches locations of all uniform variables that we need.
+             * Creates a new shader info and caches locations of all uniform variables that we need
+             * (if the shader program finished compiling).
              *
              * @param pShaderProgram Shader program to use.
              *
@@ -142,6 +184,12 @@ public:
             /** Used shader program. */
             ShaderProgram* pShaderProgram = nullptr;
 
+            /**
+             * `false` if the shader program is still being compiled (uniform locations are not cached),
+             * meshes of such shader are not drawn.
+             */
+            bool bIsReady = false;
+
             /** First mesh in an array that uses the shader. */
             unsigned short iFirstMeshIndex = 0;
 
@@ -231,6 +279,7 @@ public:
      * @param pRenderer            Renderer.
      * @param viewportSize         Viewport size.
      * @param viewMatrix           Camera's view matrix.
+     * @param projectionMatrix     Camera's projection matrix.
      * @param viewProjectionMatrix Camera's view projection matrix.
      * @param cameraFrustum        Camera's frustum.
      * @param lightSourceManager   Light source manager.
@@ -242,6 +291,7 @@ public:
         Renderer* pRenderer,
         const glm::ivec4& viewportSize,
         const glm::mat4& viewMatrix,
+        const glm::mat4& projectionMatrix,
         const glm::mat4& viewProjectionMatrix,
         const Frustum& cameraFrustum,
         LightSourceManager& lightSourceManager,
@@ -270,6 +320,30 @@ public:
      */
     MeshRenderDataGuard getMeshRenderData(MeshRenderingHandle& handle);
 
+    /**
+     * Starts queueing world transforms of meshes that are moved on the calling thread (see
+     * @ref setMeshTransform) so that render data of each mesh renderer is locked only once
+     * in @ref endTransformBatch instead of once per moved mesh.
+     *
+     * @remark Meshes moved on the calling thread while the batch is active are expected to not be
+     * despawned on other threads until @ref endTransformBatch is called.
+     */
+    static void beginTransformBatch();
+
+    /**
+     * Writes transforms queued since @ref beginTransformBatch to render data of their mesh renderers,
+     * render data of each mesh renderer is locked once.
+     */
+    static void endTransformBatch();
+
+    /**
+     * Writes the specified transform to render data of the mesh or queues it if a transform batch was
+     * started on the calling thread (see @ref beginTransformBatch).
+     *
+     * @param transform New transform of a mesh.
+     */
+    static void setMeshTransform(const MeshTransform& transform);
+
     /**
      * Returns shader constants setter that will be called for every shader program used for rendering to set
      * custom global parameters.
@@ -288,8 +362,26 @@ private:
         std::array<int, MAX_POINT_LIGHT_COUNT> vIsPointLightCulled;
     };
 
+    /** Transforms queued on a thread while a transform batch is active. */
+    struct TransformBatch {
+        /** `true` between @ref beginTransformBatch and @ref endTransformBatch. */
+        bool bIsActive = false;
+
+        /** Queued transforms (in the order of changes). */
+        std::vector<MeshTransform> vTransforms;
+    };
+
     MeshRenderer() = default;
 
+    /**
+     * Writes the specified transforms (of meshes registered in this renderer) to render data
+     * under one lock.
+     *
+     * @param pTransforms Transforms to write.
+     * @param iCount      Number of transforms.
+     */
+    void writeMeshTransforms(const MeshTransform* pTransforms, size_t iCount);
+
     /**
      * Called from handle's destructor to remove a mesh from rendering.
      *
@@ -306,6 +398,41 @@ private:
     void runDebugIndexValidation();
 #endif
 
+    /**
+     * Selects LOD for a mesh based on its projected size.
+     *
+     * @param meshData             Mesh data.
+     * @param iCurrentLod          LOD that was used previously.
+     * @param viewPosition         World position of the view.
+     * @param projectionScale      Element [1][1] of the view's projection matrix.
+     * @param thresholdMultiplier  Multiplier for @ref vLodScreenSizeThresholds.
+     *
+     * @return LOD to use.
+     */
+    static unsigned char selectLod(
+        const MeshRenderData& meshData,
+        unsigned char iCurrentLod,
+        const glm::vec3& viewPosition,
+        float projectionScale,
+        float thresholdMultiplier);
+
+    /**
+     * Checks if shader programs that were still compiling are ready now and caches their uniforms.
+     *
+     * @param data Render data.
+     */
+    static void updatePendingShaders(RenderData& data);
+
+    /**
+     * Selects LODs of all registered meshes for the camera.
+     *
+     * @param data             Render data.
+     * @param viewMatrix       Camera's view matrix.
+     * @param projectionMatrix Camera's projection matrix.
+     */
+    static void
+    selectMainViewLods(RenderData& data, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix);
+
     /**
      * Submits OpenGL draw commands to draw meshes using a shader program that only has vertex shader linked.
      *
@@ -314,13 +441,16 @@ private:
      * @param viewMatrix           View matrix.
      * @param viewProjectionMatrix Camera's view projection matrix.
      * @param cameraFrustum        Camera's frustum.
+     * @param bIsShadowView        `true` to use LODs for shadow map views (see @ref iShadowLodBias),
+     * `false` to use LODs selected for the camera.
      */
     void drawMeshesVertexShaderOnly(
-        const RenderData& data,
+        RenderData& data,
         const std::vector<RenderData::ShaderInfo>& vShaders,
         const glm::mat4& viewMatrix,
         const glm::mat4& viewProjectionMatrix,
-        const Frustum& cameraFrustum);
+        const Frustum& cameraFrustum,
+        bool bIsShadowView);
 
     /**
      * Submits depth prepass commands.
@@ -334,7 +464,7 @@ private:
      */
     void drawDepthPrepass(
         Renderer* pRenderer,
-        const RenderData& data,
+        RenderData& data,
         const Frustum& cameraFrustum,
         const glm::mat4& viewMatrix,
         const glm::mat4& viewProjectionMatrix,
@@ -352,7 +482,7 @@ private:
      * @return Is light source culled (0 if culled).
      */
     [[nodiscard]] LightCullingInfo drawShadowPass(
-        const RenderData& data,
+        RenderData& data,
         const Frustum& cameraFrustum,
         LightSourceShaderArray::LightData& pointLightData,
         LightSourceShaderArray::LightData& spotlightData,
@@ -393,4 +523,7 @@ private:
 
     /** Groups data for rendering. */
     std::pair<std::mutex, RenderData> mtxRenderData{};
+
+    /** Transforms queued on the current thread (vector keeps its capacity between batches). */
+    static thread_local TransformBatch transformBatch;
 };
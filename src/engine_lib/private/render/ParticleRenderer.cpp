@@ -14,6 +14,7 @@
 #include "render/Renderer.h"
 #include "game/DebugConsole.h"
 #include "render/wrapper/ShaderProgram.h"
+#include "render/FrameStreamingBuffer.h"
 
 // External.
 #include "SDL3/SDL.h"
@@ -23,7 +24,7 @@ ParticleEmitterRenderDataGuard::~ParticleEmitterRenderDataGuard() {
     pParticleRenderer->onParticleRenderDataChanged(iEmitterIndex);
 }
 
-ParticleRenderer::ParticleRenderer(Renderer* pRenderer) {
+ParticleRenderer::ParticleRenderer(Renderer* pRenderer) : pRenderer(pRenderer) {
     auto& data = mtxRenderData.second;
 
     data.pShaderProgram = pRenderer->getShaderManager().getShaderProgram(
@@ -121,13 +122,14 @@ ParticleRenderer::registerParticleEmitter(unsigned int iMaxParticleCount) {
             iVbo,
             static_cast<unsigned int>(vVertices.size()),
             iEbo,
-            static_cast<unsigned int>(vIndices.size())));
+            static_cast<unsigned int>(vIndices.size()),
+            sizeof(vVertices) + sizeof(vIndices),
+            std::source_location::current()));
 
-        // Prepare instanced array size.
-        constexpr unsigned int iHardcodedParticleLimit = 512; // <- hardcoded array size from the shader
-        if (iMaxParticleCount > iHardcodedParticleLimit) {
+        // Clamp particle count to the instanced array size.
+        if (iMaxParticleCount > iShaderParticleArraySize) {
             const auto iOldParticleCount = iMaxParticleCount;
-            iMaxParticleCount = iHardcodedParticleLimit;
+            iMaxParticleCount = iShaderParticleArraySize;
 #if defined(DEBUG)
             Log::warn(std::format(
                 "emitter requested a GPU buffer for {} particles but the hardcoded limit is {}, particle "
@@ -137,22 +139,7 @@ ParticleRenderer::registerParticleEmitter(unsigned int iMaxParticleCount) {
                 iMaxParticleCount));
 #endif
         }
-        size_t iTestInstancedBufferSize = sizeof(ParticleRenderData) * static_cast<size_t>(iMaxParticleCount);
-        if (iTestInstancedBufferSize > std::numeric_limits<unsigned int>::max()) {
-            const auto iMaxCount = std::numeric_limits<unsigned int>::max() / sizeof(ParticleRenderData);
-            iTestInstancedBufferSize = iMaxCount * sizeof(ParticleRenderData);
-            Log::warn(std::format(
-                "emitter requested a GPU buffer for {} particles (which is too much) so the GPU buffer "
-                "will be created only for {} particles",
-                iMaxParticleCount,
-                iMaxCount));
-        }
-
-        // Create instanced array.
-        const auto iInstancedBufferSizeInBytes = static_cast<unsigned int>(iTestInstancedBufferSize);
-
-        newEmitterData.pInstancedArrayBuffer =
-            GpuResourceManager::createUniformBuffer(iInstancedBufferSizeInBytes, true);
+        newEmitterData.iMaxParticleCount = iMaxParticleCount;
     }
 
     return pNewHandle;
@@ -168,18 +155,7 @@ ParticleRenderer::getParticleEmitterRenderData(ParticleRenderingHandle& handle)
 }
 
 void ParticleRenderer::onParticleRenderDataChanged(size_t iEmitterIndex) {
-    auto& emitterData = mtxRenderData.second.vActiveEmitters[iEmitterIndex];
-
-    const auto iMaxElementCount =
-        emitterData.pInstancedArrayBuffer->getSizeInBytes() / sizeof(ParticleRenderData);
-
-    size_t iElementCount = std::min(emitterData.vParticleData.size(), iMaxElementCount);
-
-    emitterData.pInstancedArrayBuffer->copyDataToBuffer(
-        0,
-        static_cast<unsigned int>(iElementCount * sizeof(ParticleRenderData)),
-        emitterData.vParticleData.data());
-
+    // Particle data is streamed to the GPU during the drawing.
     mtxRenderData.first.unlock();
 }
 
@@ -212,24 +188,40 @@ void ParticleRenderer::drawParticles(const glm::mat4& viewMatrix, const glm::mat
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, 0);
 
+        auto& streamingBuffer = pRenderer->getStreamingBuffer();
+
         for (const auto& emitterData : data.vActiveEmitters) {
+            const auto iParticleCount = static_cast<unsigned int>(std::min(
+                emitterData.vParticleData.size(), static_cast<size_t>(emitterData.iMaxParticleCount)));
+            if (iParticleCount == 0) {
+                continue;
+            }
+
             glBindVertexArray(emitterData.pVao->getVertexArrayObjectId());
 
             glBindTexture(GL_TEXTURE_2D, emitterData.iTextureId);
             glUniform1i(data.iIsUsingTextureUniform, emitterData.iTextureId);
 
-            // Bind instanced array.
-            glBindBufferBase(
+            // Copy instanced array to this frame's region of the streaming buffer and bind it
+            // (the bound range must cover the whole uniform block even if fewer particles are copied).
+            const auto range = streamingBuffer.streamData(
+                emitterData.vParticleData.data(),
+                iParticleCount * static_cast<unsigned int>(sizeof(ParticleRenderData)),
+                streamingBuffer.getUniformBufferOffsetAlignment(),
+                iShaderParticleArraySize * static_cast<unsigned int>(sizeof(ParticleRenderData)));
+            glBindBufferRange(
                 GL_UNIFORM_BUFFER,
                 data.iInstancedDataUniformBlockBindingIndex,
-                emitterData.pInstancedArrayBuffer->getBufferId());
+                range.iBufferId,
+                range.iOffset,
+                range.iSizeInBytes);
 
             glDrawElementsInstanced(
                 GL_TRIANGLES,
                 6, // <- 6 indices (2 triangles) of a quad
                 GL_UNSIGNED_SHORT,
                 nullptr,
-                static_cast<GLsizei>(emitterData.vParticleData.size()));
+                static_cast<GLsizei>(iParticleCount));
         }
     }
     glDisable(GL_BLEND);
@@ -8,7 +8,6 @@
 // Custom.
 #include "math/GLMath.hpp"
 #include "render/wrapper/VertexArrayObject.h"
-#include "render/wrapper/Buffer.h"
 
 class ParticleRenderer;
 class ParticleRenderingHandle;
@@ -36,8 +35,11 @@ struct EmitterRenderData {
     /** Do not modify, renderer updates this automatically. VAO used for drawing particles. */
     std::unique_ptr<VertexArrayObject> pVao;
 
-    /** Do not modify, renderer updates this automatically. Stores per-particle (instanced) data. */
-    std::unique_ptr<Buffer> pInstancedArrayBuffer;
+    /**
+     * Do not modify, renderer updates this automatically. Maximum number of particles to draw
+     * (particle data is streamed to the GPU every frame).
+     */
+    unsigned int iMaxParticleCount = 0;
 
     /** Do not modify, renderer uses this pointer to update handle's index. */
     ParticleRenderingHandle* pHandle = nullptr;
@@ -130,6 +132,9 @@ public:
     ParticleEmitterRenderDataGuard getParticleEmitterRenderData(ParticleRenderingHandle& handle);
 
 private:
+    /** Size of the particle array in the uniform block of the shader. */
+    static constexpr unsigned int iShaderParticleArraySize = 512; // same as in shaders
+
     /** Groups data used for rendering. */
     struct RenderData {
         RenderData() = default;
@@ -176,4 +181,7 @@ private:
 
     /** Data used for rendering. */
     std::pair<std::mutex, RenderData> mtxRenderData;
+
+    /** Renderer that created this object. */
+    Renderer* const pRenderer = nullptr;
 };
@@ -18,6 +18,8 @@
 #include "render/GpuTimeQuery.hpp"
 #include "render/GpuDebugMarker.hpp"
 #include "render/ParticleRenderer.h"
+#include "render/FrameStreamingBuffer.h"
+#include "render/GpuMemoryTracker.h"
 
 // External.
 #include "glad/glad.h"
@@ -132,7 +134,8 @@ Renderer::Renderer(Window* pWindow, SDL_GLContext pCreatedContext) : pWindow(pWi
     glDepthFunc(iCurrentGlDepthFunc);
 
     pShaderManager = std::unique_ptr<ShaderManager>(new ShaderManager(this));
-    pTextureManager = std::unique_ptr<TextureManager>(new TextureManager());
+    pTextureManager = std::unique_ptr<TextureManager>(new TextureManager(this));
+    pStreamingBuffer = std::unique_ptr<FrameStreamingBuffer>(new FrameStreamingBuffer());
     pFontManager = FontManager::create(this);
 
     pFullscreenQuad = GpuResourceManager::createScreenQuad();
@@ -216,8 +219,12 @@ Renderer::~Renderer() {
     pFullscreenQuad = nullptr;
     pFontManager = nullptr;
     pTextureManager = nullptr;
+    pStreamingBuffer = nullptr;
     pShaderManager = nullptr; // delete shaders before context
 
+    // All worlds were destroyed so no GPU resources are expected to be alive at this point.
+    GpuMemoryTracker::logLiveResources();
+
     for (auto& fence : frameSyncData.vFences) {
         glDeleteSync(fence);
     }
@@ -251,6 +258,42 @@ void Renderer::drawNextFrame(float timeSincePrevCallInSec) {
     glDeleteSync(frameSyncData.vFences[frameSyncData.iCurrentFrameIndex]);
     auto& frameQueries = frameSyncData.vFrameQueries[frameSyncData.iCurrentFrameIndex];
 
+    // The GPU finished reading the streaming buffer region of this frame so it can be reused.
+    pStreamingBuffer->onBeginFrame(frameSyncData.iCurrentFrameIndex);
+
+    // Manage texture memory and upload textures that were loaded asynchronously.
+    pTextureManager->updateTextureResidency();
+    pTextureManager->uploadDecodedTextures();
+#if defined(ENGINE_DEBUG_TOOLS)
+    {
+        const auto textureStats = pTextureManager->getStreamingStats();
+        auto& debugStats = DebugConsole::getStats();
+        debugStats.iDecodingTextureCount = textureStats.iDecodingTextureCount;
+        debugStats.iTexturePendingUploadBytes = textureStats.iPendingUploadBytes;
+        debugStats.iTextureUploadedBytesLastFrame = textureStats.iUploadedBytesLastFrame;
+        debugStats.iTextureResidentBytes = textureStats.iResidentBytes;
+        debugStats.iTextureMemoryBudgetBytes = textureStats.iMemoryBudgetBytes;
+        debugStats.iReducedTextureCount = textureStats.iReducedTextureCount;
+        debugStats.iEvictedTextureCount = textureStats.iEvictedTextureCount;
+        debugStats.iTotalTextureEvictionCount = textureStats.iTotalEvictionCount;
+        debugStats.iStreamedBytesLastFrame = pStreamingBuffer->getStreamedBytesLastFrame();
+        debugStats.iStreamingBufferFrameRegionBytes = pStreamingBuffer->getFrameRegionSize();
+
+        const auto vaoStats = GpuMemoryTracker::getStats(GpuResourceCategory::VERTEX_ARRAY_OBJECT);
+        const auto bufferStats = GpuMemoryTracker::getStats(GpuResourceCategory::BUFFER);
+        const auto framebufferStats = GpuMemoryTracker::getStats(GpuResourceCategory::FRAMEBUFFER);
+        const auto gpuTextureStats = GpuMemoryTracker::getStats(GpuResourceCategory::TEXTURE);
+        debugStats.iGpuVertexArrayBytes = vaoStats.iTotalBytes;
+        debugStats.iGpuVertexArrayPeakBytes = vaoStats.iPeakBytes;
+        debugStats.iGpuBufferBytes = bufferStats.iTotalBytes;
+        debugStats.iGpuBufferPeakBytes = bufferStats.iPeakBytes;
+        debugStats.iGpuFramebufferBytes = framebufferStats.iTotalBytes;
+        debugStats.iGpuFramebufferPeakBytes = framebufferStats.iPeakBytes;
+        debugStats.iGpuTextureBytes = gpuTextureStats.iTotalBytes;
+        debugStats.iGpuTexturePeakBytes = gpuTextureStats.iPeakBytes;
+    }
+#endif
+
     auto& mtxWorlds = pWindow->getGameManager()->getWorlds();
     std::scoped_lock guardWorlds(mtxWorlds.first);
 
@@ -418,6 +461,7 @@ void Renderer::drawNextFrame(float timeSincePrevCallInSec) {
                     this,
                     viewportSize,
                     renderData.viewMatrix,
+                    renderData.projectionMatrix,
                     renderData.viewProjectionMatrix,
                     frustum,
                     pWorld->getLightSourceManager(),
@@ -689,4 +733,6 @@ FontManager& Renderer::getFontManager() { return *pFontManager; }
 
 TextureManager& Renderer::getTextureManager() { return *pTextureManager; }
 
+FrameStreamingBuffer& Renderer::getStreamingBuffer() { return *pStreamingBuffer; }
+
 RenderStatistics& Renderer::getRenderStatistics() { return renderStats; }
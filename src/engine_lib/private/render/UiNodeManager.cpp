@@ -32,6 +32,13 @@
 // External.
 #include "glad/glad.h"
 
+namespace {
+    /** Handles to shader uniforms that are set per UI node. */
+    const ShaderUniformHandle colorUniform = ShaderProgram::getUniformHandle("color");
+    const ShaderUniformHandle isUsingTextureUniform = ShaderProgram::getUniformHandle("bIsUsingTexture");
+    const ShaderUniformHandle textColorUniform = ShaderProgram::getUniformHandle("textColor");
+}
+
 #define ADD_NODE_TO_RENDERING(nodeType)                                                                      \
     /** Find an array of nodes to add the node to according to the node's depth. */                          \
     std::unordered_set<nodeType*>* pNodeArray = nullptr;                                                     \
@@ -1079,13 +1086,13 @@ void UiNodeManager::drawRectNodesDataLocked(
             auto size = pRectNode->getSize();
 
             // Set shader parameters.
-            pShaderProgram->setVector4ToActiveProgram("color", pRectNode->getColor());
+            pShaderProgram->setVector4ToActiveProgram(colorUniform, pRectNode->getColor());
             if (pRectNode->pTexture != nullptr) {
-                pShaderProgram->setBoolToActiveProgram("bIsUsingTexture", true);
+                pShaderProgram->setBoolToActiveProgram(isUsingTextureUniform, true);
                 glActiveTexture(GL_TEXTURE0);
                 glBindTexture(GL_TEXTURE_2D, pRectNode->pTexture->getTextureId());
             } else {
-                pShaderProgram->setBoolToActiveProgram("bIsUsingTexture", false);
+                pShaderProgram->setBoolToActiveProgram(isUsingTextureUniform, false);
             }
 
             pos = glm::vec2(
@@ -1139,13 +1146,13 @@ void UiNodeManager::drawProgressBarNodesDataLocked(
             auto relativeSize = pProgressBarNode->getSize();
 
             // Set background shader parameters.
-            pShaderProgram->setVector4ToActiveProgram("color", pProgressBarNode->getColor());
+            pShaderProgram->setVector4ToActiveProgram(colorUniform, pProgressBarNode->getColor());
             if (pProgressBarNode->pTexture != nullptr) {
-                pShaderProgram->setBoolToActiveProgram("bIsUsingTexture", true);
+                pShaderProgram->setBoolToActiveProgram(isUsingTextureUniform, true);
                 glActiveTexture(GL_TEXTURE0);
                 glBindTexture(GL_TEXTURE_2D, pProgressBarNode->pTexture->getTextureId());
             } else {
-                pShaderProgram->setBoolToActiveProgram("bIsUsingTexture", false);
+                pShaderProgram->setBoolToActiveProgram(isUsingTextureUniform, false);
             }
 
             // Draw background.
@@ -1164,13 +1171,13 @@ void UiNodeManager::drawProgressBarNodesDataLocked(
                 glm::vec4(0.0f, yClip.x, 1.0f, yClip.y));
 
             // Set foreground shader parameters.
-            pShaderProgram->setVector4ToActiveProgram("color", pProgressBarNode->getForegroundColor());
+            pShaderProgram->setVector4ToActiveProgram(colorUniform, pProgressBarNode->getForegroundColor());
             if (pProgressBarNode->pForegroundTexture != nullptr) {
-                pShaderProgram->setBoolToActiveProgram("bIsUsingTexture", true);
+                pShaderProgram->setBoolToActiveProgram(isUsingTextureUniform, true);
                 glActiveTexture(GL_TEXTURE0);
                 glBindTexture(GL_TEXTURE_2D, pProgressBarNode->pForegroundTexture->getTextureId());
             } else {
-                pShaderProgram->setBoolToActiveProgram("bIsUsingTexture", false);
+                pShaderProgram->setBoolToActiveProgram(isUsingTextureUniform, false);
             }
 
             // Draw foreground.
@@ -1210,7 +1217,7 @@ void UiNodeManager::drawCheckboxNodesDataLocked(
     glUseProgram(shaderInfo.pShaderProgram->getShaderProgramId());
 
     glBindVertexArray(mtxData.second.pScreenQuadGeometry->getVao().getVertexArrayObjectId());
-    pShaderProgram->setBoolToActiveProgram("bIsUsingTexture", false);
+    pShaderProgram->setBoolToActiveProgram(isUsingTextureUniform, false);
 
     constexpr float boundsWidthInPix = 2.0f;
     constexpr float backgroundPaddingInPix = 6.0f;
@@ -1234,7 +1241,7 @@ void UiNodeManager::drawCheckboxNodesDataLocked(
             size.x *= 1.0f / aspectRatio;
 
             // Draw bounds.
-            pShaderProgram->setVector4ToActiveProgram("color", pCheckboxNode->getForegroundColor());
+            pShaderProgram->setVector4ToActiveProgram(colorUniform, pCheckboxNode->getForegroundColor());
             pos = glm::vec2(
                 pos.x * static_cast<float>(iWindowWidth), pos.y * static_cast<float>(iWindowHeight));
             size = glm::vec2(
@@ -1250,7 +1257,7 @@ void UiNodeManager::drawCheckboxNodesDataLocked(
                 clipRect);
 
             // Draw background.
-            pShaderProgram->setVector4ToActiveProgram("color", pCheckboxNode->getBackgroundColor());
+            pShaderProgram->setVector4ToActiveProgram(colorUniform, pCheckboxNode->getBackgroundColor());
             pos += boundsWidthInPix;
             size -= boundsWidthInPix * 2.0f;
             drawQuad(
@@ -1262,7 +1269,7 @@ void UiNodeManager::drawCheckboxNodesDataLocked(
                 clipRect);
 
             if (pCheckboxNode->isChecked()) {
-                pShaderProgram->setVector4ToActiveProgram("color", pCheckboxNode->getForegroundColor());
+                pShaderProgram->setVector4ToActiveProgram(colorUniform, pCheckboxNode->getForegroundColor());
                 pos += backgroundPaddingInPix;
                 size -= backgroundPaddingInPix * 2.0f;
                 drawQuad(
@@ -1299,7 +1306,7 @@ void UiNodeManager::drawSliderNodesDataLocked(
     glUseProgram(shaderInfo.pShaderProgram->getShaderProgramId());
 
     glBindVertexArray(mtxData.second.pScreenQuadGeometry->getVao().getVertexArrayObjectId());
-    pShaderProgram->setBoolToActiveProgram("bIsUsingTexture", false);
+    pShaderProgram->setBoolToActiveProgram(isUsingTextureUniform, false);
 
     constexpr float sliderHeightToWidthRatio = 0.5f;
     constexpr float sliderHandleWidth = 0.1f; // in range [0.0; 1.0] relative to slider width
@@ -1317,7 +1324,7 @@ void UiNodeManager::drawSliderNodesDataLocked(
             const auto handlePos = pSliderNode->getHandlePosition();
 
             // Draw slider base.
-            pShaderProgram->setVector4ToActiveProgram("color", pSliderNode->getSliderColor());
+            pShaderProgram->setVector4ToActiveProgram(colorUniform, pSliderNode->getSliderColor());
             const auto baseHeight = size.y * sliderHeightToWidthRatio;
             const auto yClip = pSliderNode->getYClip();
             const auto clipRect = glm::vec4(0.0f, yClip.x, 1.0f, yClip.y);
@@ -1334,7 +1341,7 @@ void UiNodeManager::drawSliderNodesDataLocked(
                 clipRect);
 
             // Draw slider handle.
-            pShaderProgram->setVector4ToActiveProgram("color", pSliderNode->getSliderHandleColor());
+            pShaderProgram->setVector4ToActiveProgram(colorUniform, pSliderNode->getSliderHandleColor());
             const auto handleWidth = size.x * sliderHandleWidth;
             const auto handleCenterPos = glm::vec2(pos.x + handlePos * size.x, pos.y);
             drawQuad(
@@ -1483,7 +1490,7 @@ void UiNodeManager::drawTextEditNodesDataLocked(
             }
 
             // Set color.
-            pShaderProgram->setVector4ToActiveProgram("textColor", pTextEditNode->getTextColor());
+            pShaderProgram->setVector4ToActiveProgram(textColorUniform, pTextEditNode->getTextColor());
 
             // Switch to the first row of text.
             screenY += textHeightInPixels;
@@ -1701,8 +1708,8 @@ void UiNodeManager::drawTextEditNodesDataLocked(
             // Draw cursors.
 
             // Set shader parameters.
-            pShaderProgram->setVector4ToActiveProgram("color", glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
-            pShaderProgram->setBoolToActiveProgram("bIsUsingTexture", false);
+            pShaderProgram->setVector4ToActiveProgram(colorUniform, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+            pShaderProgram->setBoolToActiveProgram(isUsingTextureUniform, false);
 
             for (const auto& cursorInfo : vCursorScreenPosToDraw) {
                 const float cursorWidth = 2.0f;
@@ -1723,10 +1730,10 @@ void UiNodeManager::drawTextEditNodesDataLocked(
             // Draw selections.
 
             // Set shader parameters.
-            pShaderProgram->setBoolToActiveProgram("bIsUsingTexture", false);
+            pShaderProgram->setBoolToActiveProgram(isUsingTextureUniform, false);
 
             for (auto& selectionInfo : vTextSelectionToDraw) {
-                pShaderProgram->setVector4ToActiveProgram("color", selectionInfo.color);
+                pShaderProgram->setVector4ToActiveProgram(colorUniform, selectionInfo.color);
 
                 for (auto& [startPos, endPos] : selectionInfo.vLineStartEndScreenPos) {
                     const auto width = endPos.x - startPos.x;
@@ -1822,10 +1829,10 @@ void UiNodeManager::drawScrollBarsDataLocked(
     glBindVertexArray(mtxData.second.pScreenQuadGeometry->getVao().getVertexArrayObjectId());
 
     // Set shader parameters.
-    pShaderProgram->setBoolToActiveProgram("bIsUsingTexture", false);
+    pShaderProgram->setBoolToActiveProgram(isUsingTextureUniform, false);
 
     for (auto& scrollBarInfo : vScrollBarsToDraw) {
-        pShaderProgram->setVector4ToActiveProgram("color", scrollBarInfo.color);
+        pShaderProgram->setVector4ToActiveProgram(colorUniform, scrollBarInfo.color);
 
         const auto width = std::round(scrollBarWidthRelativeScreen * static_cast<float>(iWindowWidth));
         auto height = scrollBarInfo.heightInPixels * scrollBarInfo.verticalSize;
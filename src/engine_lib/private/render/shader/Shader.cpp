@@ -8,12 +8,20 @@
 #include "glad/glad.h"
 
 Shader::~Shader() {
-    pShaderManager->onShaderBeingDestroyed(sPathToShaderRelativeRes);
+    pShaderManager->onShaderBeingDestroyed(sPathToShaderRelativeRes, features);
 
-    GL_CHECK_ERROR(glDeleteShader(iShaderId));
+    if (iShaderId != 0) {
+        GL_CHECK_ERROR(glDeleteShader(iShaderId));
+    }
 }
 
 Shader::Shader(
-    ShaderManager* pShaderManager, const std::string& sPathToShaderRelativeRes, unsigned int iShaderId)
-    : iShaderId(iShaderId), sPathToShaderRelativeRes(sPathToShaderRelativeRes),
+    ShaderManager* pShaderManager,
+    const std::string& sPathToShaderRelativeRes,
+    std::string&& sSourceCode,
+    uint64_t iSourceCodeHash,
+    int iShaderType,
+    ShaderFeature features)
+    : sSourceCode(std::move(sSourceCode)), iSourceCodeHash(iSourceCodeHash), iShaderType(iShaderType),
+      features(features), sPathToShaderRelativeRes(sPathToShaderRelativeRes),
       pShaderManager(pShaderManager) {}
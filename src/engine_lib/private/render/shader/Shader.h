@@ -2,13 +2,18 @@
 
 // Standard.
 #include <string>
+#include <cstdint>
+
+// Custom.
+#include "render/ShaderFeature.hpp"
 
 class ShaderManager;
 
 /**
- * Compiled GLSL shader.
+ * Preprocessed GLSL shader that is compiled only when a shader program that uses it can't be loaded
+ * from the program binary cache.
  *
- * @remark Deletes GL shader program in destructor.
+ * @remark Deletes GL shader in destructor.
  */
 class Shader {
     // Only shader manager is allowed to create objects of this type.
@@ -32,23 +37,57 @@ public:
     /**
      * Returns OpenGL ID of the compiled shader.
      *
-     * @return ID.
+     * @return ID (0 if not compiled yet).
      */
     unsigned int getShaderId() const { return iShaderId; }
 
+    /**
+     * Returns hash of the preprocessed source code (including defined macros).
+     *
+     * @return Hash.
+     */
+    uint64_t getSourceCodeHash() const { return iSourceCodeHash; }
+
+    /**
+     * Returns features that were defined as macros in the source code.
+     *
+     * @return Features.
+     */
+    ShaderFeature getFeatures() const { return features; }
+
 private:
     /**
      * Creates a new shader.
      *
      * @param pShaderManager           Manager that created this shader.
      * @param sPathToShaderRelativeRes Path to .glsl file relative `res` directory.
-     * @param iShaderId                OpenGL ID of the compiled shader.
+     * @param sSourceCode              Preprocessed source code.
+     * @param iSourceCodeHash          Hash of the preprocessed source code.
+     * @param iShaderType              OpenGL type of the shader.
+     * @param features                 Features that were defined as macros in the source code.
      */
     Shader(
-        ShaderManager* pShaderManager, const std::string& sPathToShaderRelativeRes, unsigned int iShaderId);
+        ShaderManager* pShaderManager,
+        const std::string& sPathToShaderRelativeRes,
+        std::string&& sSourceCode,
+        uint64_t iSourceCodeHash,
+        int iShaderType,
+        ShaderFeature features);
+
+    /** Preprocessed source code. */
+    const std::string sSourceCode;
+
+    /** Hash of @ref sSourceCode. */
+    const uint64_t iSourceCodeHash = 0;
+
+    /** OpenGL type of the shader (vertex, fragment, etc). */
+    const int iShaderType = 0;
+
+    /** Features that were defined as macros in @ref sSourceCode. */
+    const ShaderFeature features = ShaderFeature::NONE;
 
-    /** OpenGL ID of the compiled shader. */
-    const unsigned int iShaderId = 0;
+    /** OpenGL ID of the compiled shader, 0 if not compiled yet. */
+    unsigned int iShaderId = 0;
 
     /** Path to .glsl file relative `res` directory. */
     const std::string sPathToShaderRelativeRes;
@@ -0,0 +1,116 @@
+#include "render/shader/ShaderCompileThread.h"
+
+// Standard.
+#include <format>
+
+// Custom.
+#include "io/Log.h"
+#include "misc/Error.h"
+
+#if defined(ENGINE_PROFILER_ENABLED)
+#include "tracy/public/common/TracySystem.hpp"
+#endif
+
+std::unique_ptr<ShaderCompileThread> ShaderCompileThread::create() {
+    const auto pMainWindow = SDL_GL_GetCurrentWindow();
+    const auto pMainContext = SDL_GL_GetCurrentContext();
+    if (pMainWindow == nullptr || pMainContext == nullptr) [[unlikely]] {
+        Log::warn("unable to create a shader compile thread because there is no current OpenGL context");
+        return nullptr;
+    }
+
+    // Some platforms (EGL) don't allow the same window surface to be current on multiple threads.
+    const auto pHiddenWindow = SDL_CreateWindow("", 1, 1, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+    if (pHiddenWindow == nullptr) {
+        Log::warn(std::format(
+            "failed to create a hidden window for the shader compile thread, shaders will be compiled "
+            "on the main thread, error: {}",
+            SDL_GetError()));
+        return nullptr;
+    }
+
+    // Create a context that shares objects with the main one (this makes the new context current).
+    SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+    const auto pSharedContext = SDL_GL_CreateContext(pHiddenWindow);
+    SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+    if (pSharedContext == nullptr) {
+        Log::warn(std::format(
+            "failed to create a shared OpenGL context, shaders will be compiled on the main thread, "
+            "error: {}",
+            SDL_GetError()));
+        SDL_DestroyWindow(pHiddenWindow);
+        SDL_GL_MakeCurrent(pMainWindow, pMainContext);
+        return nullptr;
+    }
+
+    // Release the shared context so that the thread can make it current and restore the main context.
+    SDL_GL_MakeCurrent(pHiddenWindow, nullptr);
+    if (!SDL_GL_MakeCurrent(pMainWindow, pMainContext)) [[unlikely]] {
+        Error::showErrorAndThrowException(SDL_GetError());
+    }
+
+    return std::unique_ptr<ShaderCompileThread>(new ShaderCompileThread(pHiddenWindow, pSharedContext));
+}
+
+ShaderCompileThread::ShaderCompileThread(SDL_Window* pHiddenWindow, SDL_GLContext pSharedContext)
+    : pHiddenWindow(pHiddenWindow), pSharedContext(pSharedContext) {
+    thread = std::thread(&ShaderCompileThread::processTasksThread, this);
+}
+
+ShaderCompileThread::~ShaderCompileThread() {
+    bIsShuttingDown.test_and_set();
+    {
+        // Lock to make sure the thread is either waiting or will see the flag before waiting.
+        std::scoped_lock guard(mtxTaskQueue.first);
+    }
+    cvNewTasks.notify_one();
+    thread.join();
+
+    SDL_GL_DestroyContext(pSharedContext);
+    SDL_DestroyWindow(pHiddenWindow);
+}
+
+std::future<CompiledShaderProgram>
+ShaderCompileThread::addTask(std::packaged_task<CompiledShaderProgram()>&& task) {
+    auto future = task.get_future();
+    {
+        std::scoped_lock guard(mtxTaskQueue.first);
+        mtxTaskQueue.second.push(std::move(task));
+    }
+    cvNewTasks.notify_one();
+
+    return future;
+}
+
+void ShaderCompileThread::processTasksThread() {
+#if defined(ENGINE_PROFILER_ENABLED)
+    tracy::SetThreadName("shader compile thread");
+#endif
+
+    if (!SDL_GL_MakeCurrent(pHiddenWindow, pSharedContext)) [[unlikely]] {
+        Error::showErrorAndThrowException(
+            std::format("failed to make shared OpenGL context current, error: {}", SDL_GetError()));
+    }
+
+    while (true) {
+        std::packaged_task<CompiledShaderProgram()> task;
+        {
+            std::unique_lock guard(mtxTaskQueue.first);
+            cvNewTasks.wait(
+                guard, [this] { return !mtxTaskQueue.second.empty() || bIsShuttingDown.test(); });
+
+            // Finish queued tasks before exiting because someone might be waiting for the results.
+            if (mtxTaskQueue.second.empty()) {
+                break;
+            }
+
+            task = std::move(mtxTaskQueue.second.front());
+            mtxTaskQueue.second.pop();
+        }
+
+        // Exceptions are stored in the future.
+        task();
+    }
+
+    SDL_GL_MakeCurrent(pHiddenWindow, nullptr);
+}
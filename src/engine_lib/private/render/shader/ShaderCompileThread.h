@@ -0,0 +1,91 @@
+#pragma once
+
+// Standard.
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <future>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+
+// External.
+#include "glad/glad.h"
+#include "SDL3/SDL_video.h"
+
+/** Result of compiling (or loading from the cache) a shader program. */
+struct CompiledShaderProgram {
+    /** ID of the linked shader program. */
+    unsigned int iShaderProgramId = 0;
+
+    /** ID of the linked shader program which has only vertex shader linked (0 if not needed). */
+    unsigned int iVertexOnlyShaderProgramId = 0;
+
+    /**
+     * Fence that is signaled once the GPU commands that created the programs are finished,
+     * `nullptr` if the programs were created on the main thread (no synchronization needed).
+     */
+    GLsync pFence = nullptr;
+};
+
+/**
+ * Thread with its own OpenGL context (that shares objects with the main context) that compiles and
+ * links shader programs so that the main thread does not stall.
+ */
+class ShaderCompileThread {
+public:
+    ShaderCompileThread(const ShaderCompileThread&) = delete;
+    ShaderCompileThread& operator=(const ShaderCompileThread&) = delete;
+
+    /** Waits for queued tasks to be finished and destroys the context. */
+    ~ShaderCompileThread();
+
+    /**
+     * Creates a shared OpenGL context and starts the thread.
+     *
+     * @remark Expects the main OpenGL context to be current on the calling thread.
+     *
+     * @return `nullptr` if a shared context is not supported (shaders should be compiled on the main
+     * thread then).
+     */
+    static std::unique_ptr<ShaderCompileThread> create();
+
+    /**
+     * Queues a task to be executed on the compile thread (with the shared context being current).
+     *
+     * @param task Task that creates shader programs.
+     *
+     * @return Future that will store the result of the task.
+     */
+    std::future<CompiledShaderProgram> addTask(std::packaged_task<CompiledShaderProgram()>&& task);
+
+private:
+    /**
+     * Initializes the object.
+     *
+     * @param pHiddenWindow  Hidden window that is used to make the shared context current.
+     * @param pSharedContext Context that shares objects with the main context.
+     */
+    ShaderCompileThread(SDL_Window* pHiddenWindow, SDL_GLContext pSharedContext);
+
+    /** Function that the thread is executing. */
+    void processTasksThread();
+
+    /** Tasks waiting to be executed. */
+    std::pair<std::mutex, std::queue<std::packaged_task<CompiledShaderProgram()>>> mtxTaskQueue;
+
+    /** Condition variable to wait until new tasks are added. */
+    std::condition_variable cvNewTasks;
+
+    /** Set when the thread should finish. */
+    std::atomic_flag bIsShuttingDown;
+
+    /** Hidden window that is used to make the shared context current (some platforms require a surface). */
+    SDL_Window* const pHiddenWindow = nullptr;
+
+    /** Context that shares objects with the main context. */
+    const SDL_GLContext pSharedContext = nullptr;
+
+    /** Thread that executes tasks. */
+    std::thread thread;
+};
@@ -3,20 +3,130 @@
 // Standard.
 #include <format>
 #include <array>
+#include <fstream>
+#include <string_view>
 
 // Custom.
 #include "misc/Error.h"
 #include "render/shader/Shader.h"
 #include "misc/ProjectPaths.h"
 #include "render/wrapper/ShaderProgram.h"
+#include "render/shader/ShaderCompileThread.h"
 #include "misc/Profiler.hpp"
 #include "io/Log.h"
 
 // External.
 #include "glad/glad.h"
 #include "GLSL-Include/src/glsl_include.hpp"
+#include "SDL3/SDL_timer.h"
 
-std::shared_ptr<Shader> ShaderManager::compileShader(const std::string& sPathToShaderRelativeRes) {
+namespace {
+    /** Name of the directory (in the engine configs directory) that stores program binaries. */
+    constexpr std::string_view sProgramBinaryCacheDirectoryName = "shader_cache";
+
+    /** Magic number in the beginning of program binary files. */
+    constexpr uint32_t iProgramBinaryMagic = 0x4250454C; // "LEPB" in little endian
+
+    /** Version of the program binary file format. */
+    constexpr uint32_t iProgramBinaryFormatVersion = 1;
+
+    /** Initial value of FNV-1a hash. */
+    constexpr uint64_t iFnv1aOffsetBasis = 14695981039346656037ULL;
+
+    /** Describes a macro that is defined when a shader feature is enabled. */
+    struct ShaderFeatureMacro {
+        /** Feature. */
+        ShaderFeature feature;
+
+        /** Name of the macro to define. */
+        std::string_view sMacro;
+
+        /** OpenGL type of shaders that the feature affects. */
+        int iShaderType;
+    };
+
+    /** Macros of all shader features. */
+    constexpr std::array<ShaderFeatureMacro, 4> vShaderFeatureMacros = {{
+        {ShaderFeature::DIFFUSE_TEXTURE, "ENGINE_DIFFUSE_TEXTURE", GL_FRAGMENT_SHADER},
+        {ShaderFeature::DISTANCE_FOG, "ENGINE_DISTANCE_FOG", GL_FRAGMENT_SHADER},
+        {ShaderFeature::SHADOWS, "ENGINE_SHADOWS", GL_FRAGMENT_SHADER},
+        {ShaderFeature::OUTLINE, "ENGINE_OUTLINE", GL_VERTEX_SHADER},
+    }};
+}
+
+/**
+ * Continues calculating FNV-1a hash with the specified bytes.
+ *
+ * @param iHash  Current hash.
+ * @param pData  Bytes to hash.
+ * @param iSize  Number of bytes.
+ *
+ * @return Hash.
+ */
+inline uint64_t combineFnv1aHash(uint64_t iHash, const void* pData, size_t iSize) {
+    const auto pBytes = static_cast<const uint8_t*>(pData);
+    for (size_t i = 0; i < iSize; i++) {
+        iHash ^= pBytes[i];
+        iHash *= 1099511628211ULL;
+    }
+    return iHash;
+}
+
+/**
+ * Determines OpenGL shader type from the name of a shader file.
+ *
+ * @param sPathToShader Path to .glsl file.
+ *
+ * @return 0 if unable to determine, otherwise shader type.
+ */
+inline int getShaderTypeFromFileName(std::string_view sPathToShader) {
+    if (sPathToShader.ends_with(".vert.glsl")) {
+        return GL_VERTEX_SHADER;
+    }
+    if (sPathToShader.ends_with(".frag.glsl")) {
+        return GL_FRAGMENT_SHADER;
+    }
+    if (sPathToShader.ends_with(".comp.glsl")) {
+        return GL_COMPUTE_SHADER;
+    }
+    return 0;
+}
+
+/**
+ * Removes features that don't affect shaders of the specified type.
+ *
+ * @param features    Features.
+ * @param iShaderType OpenGL type of the shader.
+ *
+ * @return Features that affect the shader.
+ */
+inline ShaderFeature filterShaderFeatures(ShaderFeature features, int iShaderType) {
+    auto filteredFeatures = ShaderFeature::NONE;
+    for (const auto& macro : vShaderFeatureMacros) {
+        if (macro.iShaderType == iShaderType && (features & macro.feature) != ShaderFeature::NONE) {
+            filteredFeatures |= macro.feature;
+        }
+    }
+    return filteredFeatures;
+}
+
+/**
+ * Returns a string that uniquely identifies a shader file loaded with the specified features.
+ *
+ * @param sPathToShaderRelativeRes Path to .glsl file relative `res` directory.
+ * @param features                 Features.
+ *
+ * @return Unique key.
+ */
+inline std::string getShaderKey(const std::string& sPathToShaderRelativeRes, ShaderFeature features) {
+    if (features == ShaderFeature::NONE) {
+        return sPathToShaderRelativeRes;
+    }
+    return std::format("{}#{:x}", sPathToShaderRelativeRes, static_cast<uint32_t>(features));
+}
+
+std::shared_ptr<Shader>
+ShaderManager::loadShader(const std::string& sPathToShaderRelativeRes, ShaderFeature features) {
     PROFILE_FUNC
 
     // Construct full path.
@@ -40,15 +150,8 @@ std::shared_ptr<Shader> ShaderManager::compileShader(const std::string& sPathToS
     auto sSourceCode = std::get<std::string>(std::move(result));
 
     // Prepare GL shader type.
-    int shaderType = 0;
-    std::string sFilename = pathToShader.filename().string();
-    if (sFilename.ends_with(".vert.glsl")) {
-        shaderType = GL_VERTEX_SHADER;
-    } else if (sFilename.ends_with(".frag.glsl")) {
-        shaderType = GL_FRAGMENT_SHADER;
-    } else if (sFilename.ends_with(".comp.glsl")) {
-        shaderType = GL_COMPUTE_SHADER;
-    } else [[unlikely]] {
+    const int shaderType = getShaderTypeFromFileName(sPathToShaderRelativeRes);
+    if (shaderType == 0) [[unlikely]] {
         Error::showErrorAndThrowException(std::format(
             "unable to determine shader type (vertex, fragment, etc) from shader file name, shader: {}",
             sPathToShaderRelativeRes));
@@ -67,6 +170,11 @@ std::shared_ptr<Shader> ShaderManager::compileShader(const std::string& sPathToS
 #if defined(ENGINE_EDITOR)
     vDefinedMacros.push_back("ENGINE_EDITOR");
 #endif
+    for (const auto& macro : vShaderFeatureMacros) {
+        if ((features & macro.feature) != ShaderFeature::NONE) {
+            vDefinedMacros.push_back(macro.sMacro);
+        }
+    }
 
     if (!vDefinedMacros.empty()) {
         // Insert macros into the source code.
@@ -87,7 +195,23 @@ std::shared_ptr<Shader> ShaderManager::compileShader(const std::string& sPathToS
         sSourceCode.insert(iVersionLineEndPos + 1, sMacrosString);
     }
 
-    const auto iShaderId = glCreateShader(shaderType);
+    // Hash final source code (defined macros are included).
+    const auto iSourceCodeHash = combineFnv1aHash(iFnv1aOffsetBasis, sSourceCode.data(), sSourceCode.size());
+
+    return std::shared_ptr<Shader>(new Shader(
+        this, sPathToShaderRelativeRes, std::move(sSourceCode), iSourceCodeHash, shaderType, features));
+}
+
+void ShaderManager::compileShader(Shader& shader) {
+    PROFILE_FUNC
+
+    if (shader.iShaderId != 0) {
+        return;
+    }
+
+    const auto& sSourceCode = shader.sSourceCode;
+    const auto& sPathToShaderRelativeRes = shader.sPathToShaderRelativeRes;
+    const auto iShaderId = glCreateShader(shader.iShaderType);
 
     // Attach source code and compile.
     std::array<const char*, 1> vCodesToAttach = {sSourceCode.c_str()};
@@ -123,77 +247,283 @@ std::shared_ptr<Shader> ShaderManager::compileShader(const std::string& sPathToS
             infoLog.data()));
     }
 
-    return std::shared_ptr<Shader>(new Shader(this, sPathToShaderRelativeRes, iShaderId));
+    shader.iShaderId = iShaderId;
 }
 
-std::shared_ptr<ShaderProgram> ShaderManager::compileShaderProgram(
-    const std::string& sProgramName,
-    const std::vector<std::shared_ptr<Shader>>& vLinkedShaders,
-    const std::shared_ptr<Shader>& pVertexShader) {
-    const auto showCompilationError = [](unsigned int iShaderProgramId,
-                                         const std::vector<std::shared_ptr<Shader>>& vShaders) {
-        std::string sShaderNames;
+unsigned int ShaderManager::createProgram(const std::vector<std::shared_ptr<Shader>>& vShaders) {
+    PROFILE_FUNC
+
+    const auto iStartCounter = SDL_GetPerformanceCounter();
+
+    // Calculate program hash.
+    uint64_t iProgramHash = combineFnv1aHash(iFnv1aOffsetBasis, &iDriverHash, sizeof(iDriverHash));
+    for (const auto& pShader : vShaders) {
+        const auto iSourceCodeHash = pShader->getSourceCodeHash();
+        iProgramHash = combineFnv1aHash(iProgramHash, &iSourceCodeHash, sizeof(iSourceCodeHash));
+    }
+
+    // Try the cache first.
+    auto iShaderProgramId = tryLoadProgramBinary(iProgramHash);
+    const bool bLoadedFromCache = iShaderProgramId != 0;
+    if (!bLoadedFromCache) {
+        iShaderProgramId = GL_CHECK_ERROR(glCreateProgram());
+
+        // Link shaders.
         for (const auto& pShader : vShaders) {
-            sShaderNames += pShader->getPathToShaderRelativeRes() + ", ";
+            compileShader(*pShader);
+            GL_CHECK_ERROR(glAttachShader(iShaderProgramId, pShader->getShaderId()));
+        }
+        if (!pathToProgramBinaryCache.empty()) {
+            GL_CHECK_ERROR(
+                glProgramParameteri(iShaderProgramId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
         }
-        sShaderNames.pop_back();
-        sShaderNames.pop_back();
+        GL_CHECK_ERROR(glLinkProgram(iShaderProgramId));
+
+        // See if there were any linking errors.
+        int iSuccess = 0;
+        glGetProgramiv(iShaderProgramId, GL_LINK_STATUS, &iSuccess);
+        if (iSuccess == 0) [[unlikely]] {
+            std::string sShaderNames;
+            for (const auto& pShader : vShaders) {
+                sShaderNames += pShader->getPathToShaderRelativeRes() + ", ";
+            }
+            sShaderNames.pop_back();
+            sShaderNames.pop_back();
 
-        GLint iLogLength = 0;
-        glGetProgramiv(iShaderProgramId, GL_INFO_LOG_LENGTH, &iLogLength);
+            GLint iLogLength = 0;
+            glGetProgramiv(iShaderProgramId, GL_INFO_LOG_LENGTH, &iLogLength);
 
-        std::vector<char> vInfoLog;
-        vInfoLog.resize(static_cast<size_t>(iLogLength));
-        glGetProgramInfoLog(iShaderProgramId, static_cast<int>(vInfoLog.size()), nullptr, vInfoLog.data());
+            std::vector<char> vInfoLog;
+            vInfoLog.resize(static_cast<size_t>(iLogLength));
+            glGetProgramInfoLog(
+                iShaderProgramId, static_cast<int>(vInfoLog.size()), nullptr, vInfoLog.data());
 
-        Error::showErrorAndThrowException(
-            std::format("failed to link shader(s) {} together, error: {}", sShaderNames, vInfoLog.data()));
-    };
+            Error::showErrorAndThrowException(std::format(
+                "failed to link shader(s) {} together, error: {}", sShaderNames, vInfoLog.data()));
+        }
 
-    const auto iShaderProgramId = GL_CHECK_ERROR(glCreateProgram());
+        saveProgramBinary(iShaderProgramId, iProgramHash);
+    }
+
+    {
+        std::scoped_lock guard(mtxProgramCreationStats.first);
+        auto& stats = mtxProgramCreationStats.second;
+
+        if (bLoadedFromCache) {
+            stats.iProgramsLoadedFromCacheCount += 1;
+        } else {
+            stats.iProgramsCompiledCount += 1;
+        }
+        stats.programCreationTimeMs += static_cast<float>(SDL_GetPerformanceCounter() - iStartCounter) *
+                                       1000.0f / static_cast<float>(SDL_GetPerformanceFrequency());
+    }
+
+    return iShaderProgramId;
+}
+
+unsigned int ShaderManager::tryLoadProgramBinary(uint64_t iProgramHash) {
+    PROFILE_FUNC
+
+    if (pathToProgramBinaryCache.empty()) {
+        return 0;
+    }
+
+    const auto pathToBinary = getPathToProgramBinary(iProgramHash);
+    std::ifstream file(pathToBinary, std::ios::binary);
+    if (!file.is_open()) {
+        return 0;
+    }
+
+    // Read header.
+    uint32_t iMagic = 0;
+    uint32_t iFormatVersion = 0;
+    uint64_t iStoredProgramHash = 0;
+    uint32_t iBinaryFormat = 0;
+    uint32_t iBinarySize = 0;
+    file.read(reinterpret_cast<char*>(&iMagic), sizeof(iMagic));
+    file.read(reinterpret_cast<char*>(&iFormatVersion), sizeof(iFormatVersion));
+    file.read(reinterpret_cast<char*>(&iStoredProgramHash), sizeof(iStoredProgramHash));
+    file.read(reinterpret_cast<char*>(&iBinaryFormat), sizeof(iBinaryFormat));
+    file.read(reinterpret_cast<char*>(&iBinarySize), sizeof(iBinarySize));
+    if (!file || iMagic != iProgramBinaryMagic || iFormatVersion != iProgramBinaryFormatVersion ||
+        iStoredProgramHash != iProgramHash || iBinarySize == 0) [[unlikely]] {
+        Log::warn(std::format("ignoring invalid program binary \"{}\"", pathToBinary.string()));
+        return 0;
+    }
+
+    std::vector<char> vBinary(iBinarySize);
+    file.read(vBinary.data(), static_cast<std::streamsize>(vBinary.size()));
+    if (!file) [[unlikely]] {
+        Log::warn(std::format("ignoring truncated program binary \"{}\"", pathToBinary.string()));
+        return 0;
+    }
+    file.close();
 
-    // Link shaders.
-    for (const auto& pShader : vLinkedShaders) {
-        GL_CHECK_ERROR(glAttachShader(iShaderProgramId, pShader->getShaderId()));
+    // The driver can reject the binary (for example after a driver update that kept the same version).
+    const auto iShaderProgramId = GL_CHECK_ERROR(glCreateProgram());
+    glProgramBinary(iShaderProgramId, iBinaryFormat, vBinary.data(), static_cast<int>(vBinary.size()));
+    while (glGetError() != GL_NO_ERROR) {
+        // Clear errors of unsupported binary formats, we check the link status below.
     }
-    GL_CHECK_ERROR(glLinkProgram(iShaderProgramId));
-    // See if there were any linking errors.
     int iSuccess = 0;
     glGetProgramiv(iShaderProgramId, GL_LINK_STATUS, &iSuccess);
     if (iSuccess == 0) {
-        showCompilationError(iShaderProgramId, vLinkedShaders);
+        Log::info(std::format(
+            "program binary \"{}\" was rejected by the driver, compiling the program",
+            pathToBinary.filename().string()));
+        GL_CHECK_ERROR(glDeleteProgram(iShaderProgramId));
+
+        std::error_code errorCode;
+        std::filesystem::remove(pathToBinary, errorCode);
+        return 0;
     }
 
-    unsigned int iVertexOnlyShaderProgramId = 0;
-    if (pVertexShader != nullptr) {
-        iVertexOnlyShaderProgramId = GL_CHECK_ERROR(glCreateProgram());
-        GL_CHECK_ERROR(glAttachShader(iVertexOnlyShaderProgramId, pVertexShader->getShaderId()));
-        GL_CHECK_ERROR(glAttachShader(iVertexOnlyShaderProgramId, pEmptyFragmentShader->getShaderId()));
-        GL_CHECK_ERROR(glLinkProgram(iVertexOnlyShaderProgramId));
-        iSuccess = 0;
-        glGetProgramiv(iVertexOnlyShaderProgramId, GL_LINK_STATUS, &iSuccess);
-        if (iSuccess == 0) {
-            showCompilationError(iVertexOnlyShaderProgramId, {pVertexShader});
+    return iShaderProgramId;
+}
+
+void ShaderManager::saveProgramBinary(unsigned int iProgramId, uint64_t iProgramHash) {
+    PROFILE_FUNC
+
+    if (pathToProgramBinaryCache.empty()) {
+        return;
+    }
+
+    int iBinarySize = 0;
+    glGetProgramiv(iProgramId, GL_PROGRAM_BINARY_LENGTH, &iBinarySize);
+    if (iBinarySize <= 0) {
+        return;
+    }
+
+    std::vector<char> vBinary(static_cast<size_t>(iBinarySize));
+    GLenum iBinaryFormat = 0;
+    GL_CHECK_ERROR(glGetProgramBinary(iProgramId, iBinarySize, nullptr, &iBinaryFormat, vBinary.data()));
+
+    // Write to a temporary file first so that a crash does not leave a broken file.
+    const auto pathToBinary = getPathToProgramBinary(iProgramHash);
+    auto pathToTemporaryFile = pathToBinary;
+    pathToTemporaryFile += ".tmp";
+    {
+        std::ofstream file(pathToTemporaryFile, std::ios::binary);
+        if (!file.is_open()) [[unlikely]] {
+            Log::warn(std::format("failed to create program binary file \"{}\"", pathToBinary.string()));
+            return;
+        }
+
+        const uint32_t iMagic = iProgramBinaryMagic;
+        const uint32_t iFormatVersion = iProgramBinaryFormatVersion;
+        const uint32_t iFormat = iBinaryFormat;
+        const auto iSize = static_cast<uint32_t>(iBinarySize);
+        file.write(reinterpret_cast<const char*>(&iMagic), sizeof(iMagic));
+        file.write(reinterpret_cast<const char*>(&iFormatVersion), sizeof(iFormatVersion));
+        file.write(reinterpret_cast<const char*>(&iProgramHash), sizeof(iProgramHash));
+        file.write(reinterpret_cast<const char*>(&iFormat), sizeof(iFormat));
+        file.write(reinterpret_cast<const char*>(&iSize), sizeof(iSize));
+        file.write(vBinary.data(), static_cast<std::streamsize>(vBinary.size()));
+        if (!file) [[unlikely]] {
+            Log::warn(std::format("failed to write program binary file \"{}\"", pathToBinary.string()));
+            return;
         }
     }
 
+    std::error_code errorCode;
+    std::filesystem::rename(pathToTemporaryFile, pathToBinary, errorCode);
+    if (errorCode) [[unlikely]] {
+        Log::warn(std::format(
+            "failed to rename program binary file \"{}\", error: {}",
+            pathToTemporaryFile.string(),
+            errorCode.message()));
+    }
+}
+
+std::filesystem::path ShaderManager::getPathToProgramBinary(uint64_t iProgramHash) const {
+    return pathToProgramBinaryCache / std::format("{:016x}.bin", iProgramHash);
+}
+
+CompiledShaderProgram ShaderManager::createPrograms(
+    const std::string& sProgramName,
+    const std::vector<std::shared_ptr<Shader>>& vLinkedShaders,
+    const std::shared_ptr<Shader>& pVertexShader,
+    bool bCreateFence) {
+    PROFILE_FUNC
+    PROFILE_ADD_SCOPE_TEXT(sProgramName.data(), sProgramName.size());
+
+    const auto iStartCounter = SDL_GetPerformanceCounter();
+
+    CompiledShaderProgram result;
+    result.iShaderProgramId = createProgram(vLinkedShaders);
+    if (pVertexShader != nullptr) {
+        result.iVertexOnlyShaderProgramId = createProgram({pVertexShader, pEmptyFragmentShader});
+    }
+
+    if (bCreateFence) {
+        // The main context will wait for this fence before using the programs.
+        result.pFence = GL_CHECK_ERROR(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        glFlush();
+    }
+
+#if defined(ENGINE_PROFILER_ENABLED)
+    const auto sMessage = std::format(
+        "shader program \"{}\" created in {:.1F} ms",
+        sProgramName,
+        static_cast<float>(SDL_GetPerformanceCounter() - iStartCounter) * 1000.0f /
+            static_cast<float>(SDL_GetPerformanceFrequency()));
+    PROFILE_MESSAGE(sMessage.data(), sMessage.size());
+#else
+    (void)iStartCounter;
+#endif
+
+    return result;
+}
+
+std::shared_ptr<ShaderProgram> ShaderManager::compileShaderProgram(
+    const std::string& sProgramName,
+    const std::vector<std::shared_ptr<Shader>>& vLinkedShaders,
+    const std::shared_ptr<Shader>& pVertexShader) {
+    const bool bUseCompileThread = pCompileThread != nullptr;
+    std::packaged_task<CompiledShaderProgram()> task(
+        [this, sProgramName, vLinkedShaders, pVertexShader, bUseCompileThread]() {
+            return createPrograms(sProgramName, vLinkedShaders, pVertexShader, bUseCompileThread);
+        });
+
+    std::future<CompiledShaderProgram> compilationResult;
+    if (bUseCompileThread) {
+        compilationResult = pCompileThread->addTask(std::move(task));
+    } else {
+        compilationResult = task.get_future();
+        task();
+    }
+
     return std::shared_ptr<ShaderProgram>(
-        new ShaderProgram(this, vLinkedShaders, iShaderProgramId, sProgramName, iVertexOnlyShaderProgramId));
+        new ShaderProgram(this, vLinkedShaders, sProgramName, std::move(compilationResult)));
 }
 
 std::shared_ptr<ShaderProgram> ShaderManager::getShaderProgram(
-    const std::string& sPathToVertexShaderRelativeRes, const std::string& sPathToFragmentShaderRelativeRes) {
+    const std::string& sPathToVertexShaderRelativeRes,
+    const std::string& sPathToFragmentShaderRelativeRes,
+    ShaderFeature features) {
+    auto pShaderProgram =
+        getShaderProgramAsync(sPathToVertexShaderRelativeRes, sPathToFragmentShaderRelativeRes, features);
+    pShaderProgram->waitUntilReady();
+
+    return pShaderProgram;
+}
+
+std::shared_ptr<ShaderProgram> ShaderManager::getShaderProgramAsync(
+    const std::string& sPathToVertexShaderRelativeRes,
+    const std::string& sPathToFragmentShaderRelativeRes,
+    ShaderFeature features) {
     PROFILE_FUNC
 
     // Get shaders.
-    auto pVertexShader = getShader(sPathToVertexShaderRelativeRes);
-    auto pFragmentShader = getShader(sPathToFragmentShaderRelativeRes);
+    auto pVertexShader = getShader(sPathToVertexShaderRelativeRes, features);
+    auto pFragmentShader = getShader(sPathToFragmentShaderRelativeRes, features);
 
     std::scoped_lock guard(mtxDatabase.first);
 
-    // Find program.
+    // Find program (each shader key already includes features that affect the shader).
     const auto sCombinedName =
-        pVertexShader->getPathToShaderRelativeRes() + pFragmentShader->getPathToShaderRelativeRes();
+        getShaderKey(pVertexShader->getPathToShaderRelativeRes(), pVertexShader->getFeatures()) +
+        getShaderKey(pFragmentShader->getPathToShaderRelativeRes(), pFragmentShader->getFeatures());
 
     const auto it = mtxDatabase.second.find(sCombinedName);
     if (it == mtxDatabase.second.end()) {
@@ -216,32 +546,102 @@ ShaderManager::getShaderProgram(const std::string& sPathToComputeShaderRelativeR
 
     auto pComputeShader = getShader(sPathToComputeShaderRelativeRes);
 
-    std::scoped_lock guard(mtxDatabase.first);
+    std::shared_ptr<ShaderProgram> pShaderProgram;
+    {
+        std::scoped_lock guard(mtxDatabase.first);
+
+        // Find program.
+        const auto sName = pComputeShader->getPathToShaderRelativeRes();
+
+        const auto it = mtxDatabase.second.find(sName);
+        if (it == mtxDatabase.second.end()) {
+            // Load and compile.
+            pShaderProgram = compileShaderProgram(sName, {pComputeShader}, nullptr);
+            auto& [pWeak, pRaw] = mtxDatabase.second[sName];
+            pWeak = pShaderProgram;
+            pRaw = pShaderProgram.get();
+        } else {
+            pShaderProgram = it->second.first.lock();
+        }
+    }
 
-    // Find program.
-    const auto sName = pComputeShader->getPathToShaderRelativeRes();
+    pShaderProgram->waitUntilReady();
 
-    const auto it = mtxDatabase.second.find(sName);
-    if (it == mtxDatabase.second.end()) {
-        // Load and compile.
-        const auto pShaderProgram = compileShaderProgram(sName, {pComputeShader}, nullptr);
-        auto& [pWeak, pRaw] = mtxDatabase.second[sName];
-        pWeak = pShaderProgram;
-        pRaw = pShaderProgram.get();
+    return pShaderProgram;
+}
 
-        return pShaderProgram;
+void ShaderManager::prewarmShaderPrograms(const std::vector<ShaderProgramVariant>& vVariants) {
+    PROFILE_FUNC
+
+    vPrewarmedShaderPrograms.reserve(vPrewarmedShaderPrograms.size() + vVariants.size());
+    for (const auto& variant : vVariants) {
+        vPrewarmedShaderPrograms.push_back(getShaderProgramAsync(
+            variant.sPathToVertexShaderRelativeRes,
+            variant.sPathToFragmentShaderRelativeRes,
+            variant.features));
     }
 
-    return it->second.first.lock();
+    Log::info(std::format("prewarming {} shader program variant(s)", vVariants.size()));
 }
 
+void ShaderManager::releasePrewarmedShaderPrograms() { vPrewarmedShaderPrograms.clear(); }
+
 ShaderManager::ShaderManager(Renderer* pRenderer) : pRenderer(pRenderer) {
     pEmptyFragmentShader = getShader("engine/shaders/Empty.frag.glsl");
+    pCompileThread = ShaderCompileThread::create();
+
+    // Program binaries are only valid for the driver that produced them.
+    iDriverHash = iFnv1aOffsetBasis;
+    for (const auto iStringName : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        const auto pString = reinterpret_cast<const char*>(glGetString(iStringName));
+        const std::string_view sString = pString == nullptr ? "" : pString;
+        iDriverHash = combineFnv1aHash(iDriverHash, sString.data(), sString.size());
+    }
+
+    int iBinaryFormatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &iBinaryFormatCount);
+    if (iBinaryFormatCount <= 0) {
+        Log::info("the driver does not support program binaries, shader programs will not be cached");
+        return;
+    }
+
+    // Use a separate directory per driver and remove caches of other drivers.
+    const auto pathToCacheRoot =
+        ProjectPaths::getPathToEngineConfigsDirectory() / sProgramBinaryCacheDirectoryName;
+    const auto sDriverDirectoryName = std::format("{:016x}", iDriverHash);
+    std::error_code errorCode;
+    if (std::filesystem::exists(pathToCacheRoot)) {
+        for (const auto& entry : std::filesystem::directory_iterator(pathToCacheRoot, errorCode)) {
+            if (entry.path().filename().string() != sDriverDirectoryName) {
+                std::filesystem::remove_all(entry.path(), errorCode);
+            }
+        }
+    }
+    const auto pathToDriverCache = pathToCacheRoot / sDriverDirectoryName;
+    std::filesystem::create_directories(pathToDriverCache, errorCode);
+    if (errorCode) [[unlikely]] {
+        Log::warn(std::format(
+            "failed to create directory \"{}\" for program binaries, shader programs will not be cached, "
+            "error: {}",
+            pathToDriverCache.string(),
+            errorCode.message()));
+        return;
+    }
+    pathToProgramBinaryCache = pathToDriverCache;
 }
 
 ShaderManager::~ShaderManager() {
+    vPrewarmedShaderPrograms.clear();
+    pCompileThread = nullptr; // finishes queued tasks (which might reference shaders)
     pEmptyFragmentShader = nullptr;
 
+    const auto stats = getProgramCreationStats();
+    Log::info(std::format(
+        "shader programs: {} loaded from the binary cache, {} compiled, {:.1F} ms spent creating programs",
+        stats.iProgramsLoadedFromCacheCount,
+        stats.iProgramsCompiledCount,
+        stats.programCreationTimeMs));
+
     std::scoped_lock guard(mtxPathsToShaders.first);
 
     const auto iShaderCount = mtxPathsToShaders.second.size();
@@ -251,14 +651,24 @@ ShaderManager::~ShaderManager() {
     }
 }
 
-std::shared_ptr<Shader> ShaderManager::getShader(const std::string& sPathToShaderRelativeRes) {
+ShaderProgramCreationStats ShaderManager::getProgramCreationStats() {
+    std::scoped_lock guard(mtxProgramCreationStats.first);
+    return mtxProgramCreationStats.second;
+}
+
+std::shared_ptr<Shader>
+ShaderManager::getShader(const std::string& sPathToShaderRelativeRes, ShaderFeature features) {
+    // Only keep features that affect this shader to avoid loading duplicate shaders.
+    features = filterShaderFeatures(features, getShaderTypeFromFileName(sPathToShaderRelativeRes));
+    const auto sShaderKey = getShaderKey(sPathToShaderRelativeRes, features);
+
     std::scoped_lock guard(mtxPathsToShaders.first);
 
-    const auto it = mtxPathsToShaders.second.find(sPathToShaderRelativeRes);
+    const auto it = mtxPathsToShaders.second.find(sShaderKey);
     if (it == mtxPathsToShaders.second.end()) {
-        // Load and compile.
-        const auto pShader = compileShader(sPathToShaderRelativeRes);
-        mtxPathsToShaders.second[sPathToShaderRelativeRes] = pShader;
+        // Load (compiled only when needed).
+        const auto pShader = loadShader(sPathToShaderRelativeRes, features);
+        mtxPathsToShaders.second[sShaderKey] = pShader;
 
         return pShader;
     }
@@ -266,14 +676,17 @@ std::shared_ptr<Shader> ShaderManager::getShader(const std::string& sPathToShade
     return it->second.lock();
 }
 
-void ShaderManager::onShaderBeingDestroyed(const std::string& sPathToShaderRelativeRes) {
+void ShaderManager::onShaderBeingDestroyed(
+    const std::string& sPathToShaderRelativeRes, ShaderFeature features) {
+    const auto sShaderKey = getShaderKey(sPathToShaderRelativeRes, features);
+
     std::scoped_lock guard(mtxPathsToShaders.first);
 
     // Erase.
-    const auto it = mtxPathsToShaders.second.find(sPathToShaderRelativeRes);
+    const auto it = mtxPathsToShaders.second.find(sShaderKey);
     if (it == mtxPathsToShaders.second.end()) [[unlikely]] {
         Error::showErrorAndThrowException(
-            std::format("unable to find shader \"{}\" previously loaded", sPathToShaderRelativeRes));
+            std::format("unable to find shader \"{}\" previously loaded", sShaderKey));
     }
     mtxPathsToShaders.second.erase(it);
 }
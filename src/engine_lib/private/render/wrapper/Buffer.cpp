@@ -6,11 +6,15 @@
 // Custom.
 #include "misc/Error.h"
 #include "render/GpuResourceManager.h"
+#include "render/GpuMemoryTracker.h"
 
 // External.
 #include "glad/glad.h"
 
-Buffer::~Buffer() { GL_CHECK_ERROR(glDeleteBuffers(1, &iBufferId)); }
+Buffer::~Buffer() {
+    GL_CHECK_ERROR(glDeleteBuffers(1, &iBufferId));
+    GpuMemoryTracker::unregisterResource(iTrackedResourceId);
+}
 
 void Buffer::copyDataToBuffer(unsigned int iStartOffset, unsigned int iDataSize, const void* pData) const {
     if (!bCpuWriteAccess) [[unlikely]] {
@@ -26,5 +30,13 @@ void Buffer::copyDataToBuffer(unsigned int iStartOffset, unsigned int iDataSize,
     glBindBuffer(iGlType, 0);
 }
 
-Buffer::Buffer(unsigned int iSizeInBytes, unsigned int iBufferId, int iGlType, bool bCpuWriteAccess)
-    : iSizeInBytes(iSizeInBytes), iBufferId(iBufferId), iGlType(iGlType), bCpuWriteAccess(bCpuWriteAccess) {}
+Buffer::Buffer(
+    unsigned int iSizeInBytes,
+    unsigned int iBufferId,
+    int iGlType,
+    bool bCpuWriteAccess,
+    const std::source_location& location)
+    : iSizeInBytes(iSizeInBytes), iBufferId(iBufferId), iGlType(iGlType),
+      iTrackedResourceId(
+          GpuMemoryTracker::registerResource(GpuResourceCategory::BUFFER, iSizeInBytes, location)),
+      bCpuWriteAccess(bCpuWriteAccess) {}
@@ -1,5 +1,8 @@
 #pragma once
 
+// Standard.
+#include <source_location>
+
 /**
  * Manages OpenGL buffer object.
  *
@@ -21,8 +24,14 @@ public:
      * @param iBufferId    ID of the Buffer.
      * @param iGlType      OpenGL type of this buffer.
      * @param bCpuWriteAccess `true` if buffer data can be updated from the CPU.
+     * @param location     Location of the code that requested the buffer (used in memory tracking).
      */
-    Buffer(unsigned int iSizeInBytes, unsigned int iBufferId, int iGlType, bool bCpuWriteAccess);
+    Buffer(
+        unsigned int iSizeInBytes,
+        unsigned int iBufferId,
+        int iGlType,
+        bool bCpuWriteAccess,
+        const std::source_location& location);
 
     ~Buffer();
 
@@ -60,6 +69,9 @@ private:
     /** OpenGL type of this buffer. */
     const int iGlType = 0;
 
+    /** ID of this buffer in the GPU memory tracker. */
+    const size_t iTrackedResourceId = 0;
+
     /** `true` if @ref copyDataToBuffer can be used. */
     const bool bCpuWriteAccess = false;
 };
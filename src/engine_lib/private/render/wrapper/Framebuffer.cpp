@@ -2,6 +2,7 @@
 
 // Custom.
 #include "misc/Error.h"
+#include "render/GpuMemoryTracker.h"
 
 // External.
 #include "glad/glad.h"
@@ -11,12 +12,17 @@ Framebuffer::Framebuffer(
     unsigned int iColorTextureId,
     unsigned int iDepthStencilBufferId,
     unsigned int iWidth,
-    unsigned int iHeight)
+    unsigned int iHeight,
+    size_t iSizeInBytes,
+    const std::source_location& location)
     : iFramebufferId(iFramebufferId), iColorTextureId(iColorTextureId),
-      iDepthStencilBufferId(iDepthStencilBufferId), size({iWidth, iHeight}) {}
+      iDepthStencilBufferId(iDepthStencilBufferId), size({iWidth, iHeight}),
+      iTrackedResourceId(
+          GpuMemoryTracker::registerResource(GpuResourceCategory::FRAMEBUFFER, iSizeInBytes, location)) {}
 
 Framebuffer::~Framebuffer() {
     GL_CHECK_ERROR(glDeleteFramebuffers(1, &iFramebufferId));
     GL_CHECK_ERROR(glDeleteTextures(1, &iColorTextureId));
     GL_CHECK_ERROR(glDeleteRenderbuffers(1, &iDepthStencilBufferId));
+    GpuMemoryTracker::unregisterResource(iTrackedResourceId);
 }
@@ -2,6 +2,7 @@
 
 // Standard.
 #include <utility>
+#include <source_location>
 
 /**
  * Groups OpenGL-related resources (such as framebuffer and textures) to draw on.
@@ -57,13 +58,17 @@ private:
      * @param iDepthStencilBufferId ID of the depth/stencil buffer in @ref iFramebufferId.
      * @param iWidth                Width of the framebuffer in pixels.
      * @param iHeight               Height of the framebuffer in pixels.
+     * @param iSizeInBytes          Size of textures owned by the framebuffer.
+     * @param location              Location of the code that requested the framebuffer.
      */
     Framebuffer(
         unsigned int iFramebufferId,
         unsigned int iColorTextureId,
         unsigned int iDepthStencilBufferId,
         unsigned int iWidth,
-        unsigned int iHeight);
+        unsigned int iHeight,
+        size_t iSizeInBytes,
+        const std::source_location& location);
 
     /** ID of the framebuffer. */
     const unsigned int iFramebufferId = 0;
@@ -76,4 +81,7 @@ private:
 
     /** Size (in pixels) of the framebuffer. */
     const std::pair<unsigned int, unsigned int> size = {0, 0};
+
+    /** ID of this framebuffer in the GPU memory tracker. */
+    const size_t iTrackedResourceId = 0;
 };
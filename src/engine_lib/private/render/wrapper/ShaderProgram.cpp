@@ -2,25 +2,154 @@
 
 // Standard.
 #include <array>
+#include <chrono>
 
 // Custom.
 #include "render/ShaderManager.h"
+#include "misc/Profiler.hpp"
+#include "io/Log.h"
+
+namespace {
+    /** Names of uniforms that have handles (index is a handle) and a map to find handles by names. */
+    struct UniformNameRegistry {
+        /** Names of registered uniforms where index is @ref ShaderUniformHandle::iIndex. */
+        std::vector<std::string> vNames;
+
+        /** Handle indices of registered uniform names. */
+        std::unordered_map<std::string, unsigned int> indices;
+    };
+
+    /**
+     * Returns global registry of uniform names.
+     *
+     * @remark Function-local static so that handles can be registered during static initialization.
+     *
+     * @return Registry.
+     */
+    inline std::pair<std::mutex, UniformNameRegistry>& getUniformNameRegistry() {
+        static std::pair<std::mutex, UniformNameRegistry> mtxRegistry;
+        return mtxRegistry;
+    }
+}
 
 ShaderProgram::~ShaderProgram() {
     pShaderManager->onShaderProgramBeingDestroyed(sShaderProgramName);
 
-    GL_CHECK_ERROR(glDeleteProgram(iShaderProgramId));
-    GL_CHECK_ERROR(glDeleteProgram(iVertexOnlyShaderProgramId));
+    // Wait for the compilation to get IDs to delete.
+    if (compilationResult.valid()) {
+        try {
+            takeCompilationResult();
+        } catch (...) {
+            // Compilation failed so there are no IDs to delete (and we can't throw from the destructor).
+        }
+    }
+    if (pCompilationFence != nullptr) {
+        glDeleteSync(pCompilationFence);
+    }
+
+    if (iShaderProgramId != 0) {
+        GL_CHECK_ERROR(glDeleteProgram(iShaderProgramId));
+    }
+    if (iVertexOnlyShaderProgramId != 0) {
+        GL_CHECK_ERROR(glDeleteProgram(iVertexOnlyShaderProgramId));
+    }
 }
 
 ShaderProgram::ShaderProgram(
     ShaderManager* pShaderManager,
     const std::vector<std::shared_ptr<Shader>>& vLinkedShaders,
-    unsigned int iShaderProgramId,
     const std::string& sShaderProgramName,
-    unsigned int iVertexOnlyShaderProgramId)
+    std::future<CompiledShaderProgram>&& compilationResult)
     : vLinkedShaders(vLinkedShaders), sShaderProgramName(sShaderProgramName), pShaderManager(pShaderManager),
-      iShaderProgramId(iShaderProgramId), iVertexOnlyShaderProgramId(iVertexOnlyShaderProgramId) {
+      compilationResult(std::move(compilationResult)) {}
+
+ShaderUniformHandle ShaderProgram::getUniformHandle(const std::string& sUniformName) {
+    auto& mtxRegistry = getUniformNameRegistry();
+    std::scoped_lock guard(mtxRegistry.first);
+    auto& registry = mtxRegistry.second;
+
+    const auto it = registry.indices.find(sUniformName);
+    if (it != registry.indices.end()) {
+        return ShaderUniformHandle(it->second);
+    }
+
+    const auto iIndex = static_cast<unsigned int>(registry.vNames.size());
+    registry.vNames.push_back(sUniformName);
+    registry.indices[sUniformName] = iIndex;
+
+    return ShaderUniformHandle(iIndex);
+}
+
+std::string ShaderProgram::getUniformName(ShaderUniformHandle uniform) {
+    auto& mtxRegistry = getUniformNameRegistry();
+    std::scoped_lock guard(mtxRegistry.first);
+
+    if (uniform.iIndex >= mtxRegistry.second.vNames.size()) {
+        return "";
+    }
+
+    return mtxRegistry.second.vNames[uniform.iIndex];
+}
+
+bool ShaderProgram::isReady() {
+    if (bIsReady) {
+        return true;
+    }
+
+    if (compilationResult.valid()) {
+        if (compilationResult.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return false;
+        }
+        takeCompilationResult();
+    }
+
+    if (pCompilationFence != nullptr) {
+        if (glClientWaitSync(pCompilationFence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            return false;
+        }
+        glDeleteSync(pCompilationFence);
+        pCompilationFence = nullptr;
+    }
+
+    onCompilationFinished();
+    return true;
+}
+
+void ShaderProgram::waitUntilReady() {
+    if (bIsReady) {
+        return;
+    }
+
+    PROFILE_FUNC
+
+    if (compilationResult.valid()) {
+        takeCompilationResult();
+    }
+
+    if (pCompilationFence != nullptr) {
+        constexpr GLuint64 iTimeoutNs = 1000000000; // 1 second
+        while (glClientWaitSync(pCompilationFence, 0, iTimeoutNs) == GL_TIMEOUT_EXPIRED) {
+            Log::warn(std::format("still waiting for shader program \"{}\" to compile", sShaderProgramName));
+        }
+        glDeleteSync(pCompilationFence);
+        pCompilationFence = nullptr;
+    }
+
+    onCompilationFinished();
+}
+
+void ShaderProgram::takeCompilationResult() {
+    // Rethrows errors from the compile thread.
+    const auto result = compilationResult.get();
+
+    iShaderProgramId = result.iShaderProgramId;
+    iVertexOnlyShaderProgramId = result.iVertexOnlyShaderProgramId;
+    pCompilationFence = result.pFence;
+}
+
+void ShaderProgram::onCompilationFinished() {
+    PROFILE_FUNC
+
     // Get total uniform count.
     int iUniformCount = 0;
     GL_CHECK_ERROR(glGetProgramiv(iShaderProgramId, GL_ACTIVE_UNIFORMS, &iUniformCount));
@@ -48,8 +177,13 @@ ShaderProgram::ShaderProgram(
             continue;
         }
 
-        // Cache location.
-        cachedUniformLocations[vNameBuffer.data()] = iLocation;
+        // Cache location (resolve the name to a handle once so that values can be set by handles).
+        const auto uniform = getUniformHandle(vNameBuffer.data());
+        if (uniform.iIndex >= vUniformLocations.size()) {
+            vUniformLocations.resize(uniform.iIndex + 1, -1);
+        }
+        vUniformLocations[uniform.iIndex] = iLocation;
+        cachedUniformHandles[vNameBuffer.data()] = uniform;
     }
 
     // Get uniform block count.
@@ -73,4 +207,6 @@ ShaderProgram::ShaderProgram(
         // Cache location.
         cachedUniformBlockBindingIndices[vNameBuffer.data()] = iBindingIndex;
     }
+
+    bIsReady = true;
 }
@@ -2,10 +2,12 @@
 
 // Standard.
 #include <memory>
+#include <limits>
 #include <vector>
 #include <string>
 #include <mutex>
 #include <unordered_set>
+#include <unordered_map>
 #include <format>
 
 // Custom.
@@ -13,6 +15,7 @@
 #include "math/GLMath.hpp"
 #include "render/wrapper/Buffer.h"
 #include "render/ShaderManager.h"
+#include "render/shader/ShaderCompileThread.h"
 
 // External.
 #include "glad/glad.h"
@@ -20,9 +23,48 @@
 class Shader;
 class MeshNode;
 
+/**
+ * Small integer that identifies a name of a shader `uniform` variable (in all shader programs).
+ *
+ * @remark Get a handle once (using @ref ShaderProgram::getUniformHandle) and then use it to set values
+ * to shader programs without hashing uniform names every frame.
+ */
+class ShaderUniformHandle {
+    // Creates handles and uses their indices.
+    friend class ShaderProgram;
+
+public:
+    /** Creates an invalid handle. */
+    ShaderUniformHandle() = default;
+
+    /**
+     * Tells if this handle was created using @ref ShaderProgram::getUniformHandle.
+     *
+     * @return `false` if invalid.
+     */
+    bool isValid() const { return iIndex != iInvalidIndex; }
+
+private:
+    /**
+     * Creates a handle.
+     *
+     * @param iIndex Index of the uniform name.
+     */
+    explicit ShaderUniformHandle(unsigned int iIndex) : iIndex(iIndex) {}
+
+    /** Value of @ref iIndex for invalid handles. */
+    static constexpr unsigned int iInvalidIndex = std::numeric_limits<unsigned int>::max();
+
+    /** Index of the uniform name in a global registry of names. */
+    unsigned int iIndex = iInvalidIndex;
+};
+
 /**
  * Groups shaders used in an OpenGL shader program.
  *
+ * @remark The program might still be compiling (on the shader compile thread) after being created,
+ * use @ref isReady or @ref waitUntilReady before using its IDs or uniform locations.
+ *
  * @remark RAII-like object that automatically deletes OpenGL objects during destruction.
  */
 class ShaderProgram {
@@ -43,6 +85,34 @@ public:
 
     ~ShaderProgram();
 
+    /**
+     * Checks if the program finished compiling and can be used (without waiting).
+     *
+     * @remark Must be called on the main thread.
+     *
+     * @return `true` if ready to be used.
+     */
+    bool isReady();
+
+    /**
+     * Blocks the calling thread until the program finished compiling.
+     *
+     * @remark Must be called on the main thread.
+     */
+    void waitUntilReady();
+
+    /**
+     * Returns a handle to a uniform name (registers the name if it was not registered before).
+     *
+     * @remark Thread-safe but uses a mutex, get handles once (for example during initialization)
+     * and store them.
+     *
+     * @param sUniformName Name of the uniform variable from shader code.
+     *
+     * @return Handle that can be used with any shader program.
+     */
+    static ShaderUniformHandle getUniformHandle(const std::string& sUniformName);
+
     /**
      * Sets the specified buffer to shader.
      *
@@ -59,6 +129,14 @@ public:
      */
     inline void setMatrix4ToActiveProgram(const std::string& sUniformName, const glm::mat4x4& matrix);
 
+    /**
+     * Sets the specified value to a `uniform` in shaders.
+     *
+     * @param uniform Handle to the uniform variable from shader code.
+     * @param matrix  Matrix to set.
+     */
+    inline void setMatrix4ToActiveProgram(ShaderUniformHandle uniform, const glm::mat4x4& matrix);
+
     /**
      * Sets the specified value to a `uniform` with the specified name in shaders.
      *
@@ -69,6 +147,16 @@ public:
     inline void
     setMatrix4ArrayToActiveProgram(const std::string& sUniformName, int iArraySize, const float* pArrayStart);
 
+    /**
+     * Sets the specified value to a `uniform` in shaders.
+     *
+     * @param uniform     Handle to the uniform variable from shader code.
+     * @param iArraySize  Size of the GLSL array.
+     * @param pArrayStart Start of the array's data to copy.
+     */
+    inline void
+    setMatrix4ArrayToActiveProgram(ShaderUniformHandle uniform, int iArraySize, const float* pArrayStart);
+
     /**
      * Sets the specified value to a `uniform` with the specified name in shaders.
      *
@@ -77,6 +165,14 @@ public:
      */
     inline void setMatrix3ToActiveProgram(const std::string& sUniformName, const glm::mat3x3& matrix);
 
+    /**
+     * Sets the specified value to a `uniform` in shaders.
+     *
+     * @param uniform Handle to the uniform variable from shader code.
+     * @param matrix  Matrix to set.
+     */
+    inline void setMatrix3ToActiveProgram(ShaderUniformHandle uniform, const glm::mat3x3& matrix);
+
     /**
      * Sets the specified value to a `uniform` with the specified name in shaders.
      *
@@ -85,6 +181,14 @@ public:
      */
     inline void setVector2ToActiveProgram(const std::string& sUniformName, const glm::vec2& vector);
 
+    /**
+     * Sets the specified value to a `uniform` in shaders.
+     *
+     * @param uniform Handle to the uniform variable from shader code.
+     * @param vector  Vector to set.
+     */
+    inline void setVector2ToActiveProgram(ShaderUniformHandle uniform, const glm::vec2& vector);
+
     /**
      * Sets the specified value to a `uniform` with the specified name in shaders.
      *
@@ -93,6 +197,14 @@ public:
      */
     inline void setUvector2ToActiveProgram(const std::string& sUniformName, const glm::uvec2& vector);
 
+    /**
+     * Sets the specified value to a `uniform` in shaders.
+     *
+     * @param uniform Handle to the uniform variable from shader code.
+     * @param vector  Vector to set.
+     */
+    inline void setUvector2ToActiveProgram(ShaderUniformHandle uniform, const glm::uvec2& vector);
+
     /**
      * Sets the specified value to a `uniform` with the specified name in shaders.
      *
@@ -101,6 +213,14 @@ public:
      */
     inline void setVector3ToActiveProgram(const std::string& sUniformName, const glm::vec3& vector);
 
+    /**
+     * Sets the specified value to a `uniform` in shaders.
+     *
+     * @param uniform Handle to the uniform variable from shader code.
+     * @param vector  Vector to set.
+     */
+    inline void setVector3ToActiveProgram(ShaderUniformHandle uniform, const glm::vec3& vector);
+
     /**
      * Sets the specified value to a `uniform` with the specified name in shaders.
      *
@@ -109,6 +229,14 @@ public:
      */
     inline void setVector4ToActiveProgram(const std::string& sUniformName, const glm::vec4& vector);
 
+    /**
+     * Sets the specified value to a `uniform` in shaders.
+     *
+     * @param uniform Handle to the uniform variable from shader code.
+     * @param vector  Vector to set.
+     */
+    inline void setVector4ToActiveProgram(ShaderUniformHandle uniform, const glm::vec4& vector);
+
     /**
      * Sets the specified value to a `uniform` with the specified name in shaders.
      *
@@ -117,6 +245,14 @@ public:
      */
     inline void setFloatToActiveProgram(const std::string& sUniformName, float value);
 
+    /**
+     * Sets the specified value to a `uniform` in shaders.
+     *
+     * @param uniform Handle to the uniform variable from shader code.
+     * @param value   Value to set.
+     */
+    inline void setFloatToActiveProgram(ShaderUniformHandle uniform, float value);
+
     /**
      * Sets the specified value to a `uniform` with the specified name in shaders.
      *
@@ -125,6 +261,14 @@ public:
      */
     inline void setUintToActiveProgram(const std::string& sUniformName, unsigned int iValue);
 
+    /**
+     * Sets the specified value to a `uniform` in shaders.
+     *
+     * @param uniform Handle to the uniform variable from shader code.
+     * @param iValue  Value to set.
+     */
+    inline void setUintToActiveProgram(ShaderUniformHandle uniform, unsigned int iValue);
+
     /**
      * Sets the specified value to a `uniform` with the specified name in shaders.
      *
@@ -133,6 +277,14 @@ public:
      */
     inline void setIntToActiveProgram(const std::string& sUniformName, int iValue);
 
+    /**
+     * Sets the specified value to a `uniform` in shaders.
+     *
+     * @param uniform Handle to the uniform variable from shader code.
+     * @param iValue  Value to set.
+     */
+    inline void setIntToActiveProgram(ShaderUniformHandle uniform, int iValue);
+
     /**
      * Sets the specified value to a `uniform` with the specified name in shaders.
      *
@@ -141,6 +293,14 @@ public:
      */
     inline void setBoolToActiveProgram(const std::string& sUniformName, bool bValue);
 
+    /**
+     * Sets the specified value to a `uniform` in shaders.
+     *
+     * @param uniform Handle to the uniform variable from shader code.
+     * @param bValue  Value to set.
+     */
+    inline void setBoolToActiveProgram(ShaderUniformHandle uniform, bool bValue);
+
     /**
      * Returns location of a shader uniform with the specified name or -1 if not found.
      *
@@ -163,6 +323,26 @@ public:
      */
     inline int getShaderUniformLocation(const std::string& sUniformName);
 
+    /**
+     * Returns location of a shader uniform or -1 if not found.
+     *
+     * @param uniform Handle to the uniform.
+     *
+     * @return Location.
+     */
+    inline int tryGetShaderUniformLocation(ShaderUniformHandle uniform) const;
+
+    /**
+     * Returns location of a shader uniform.
+     *
+     * @warning Shows an error if not found.
+     *
+     * @param uniform Handle to the uniform.
+     *
+     * @return Location.
+     */
+    inline int getShaderUniformLocation(ShaderUniformHandle uniform) const;
+
     /**
      * Returns binding index of a shader uniform block with the specified name.
      *
@@ -211,19 +391,55 @@ private:
      *
      * @param pShaderManager     Manager that created this program.
      * @param vLinkedShaders     Linked shaders.
-     * @param iShaderProgramId   ID of the compiled shader program.
      * @param sShaderProgramName Unique identifier of this shader program.
-     * @param iVertexOnlyShaderProgramId ID of the shader program which has only vertex shader linked.
+     * @param compilationResult  Future that will store IDs of the compiled programs.
      */
     ShaderProgram(
         ShaderManager* pShaderManager,
         const std::vector<std::shared_ptr<Shader>>& vLinkedShaders,
-        unsigned int iShaderProgramId,
         const std::string& sShaderProgramName,
-        unsigned int iVertexOnlyShaderProgramId);
+        std::future<CompiledShaderProgram>&& compilationResult);
+
+    /**
+     * Takes IDs of the compiled programs from @ref compilationResult.
+     *
+     * @remark Blocks if the compilation is not finished yet.
+     */
+    void takeCompilationResult();
+
+    /** Caches uniform locations and marks the program as ready. */
+    void onCompilationFinished();
+
+    /**
+     * Returns handle to a uniform used in this program.
+     *
+     * @warning Shows an error if not found.
+     *
+     * @param sUniformName Name of a uniform.
+     *
+     * @return Handle.
+     */
+    inline ShaderUniformHandle getCachedUniformHandle(const std::string& sUniformName) const;
+
+    /**
+     * Returns name of the uniform that the specified handle references.
+     *
+     * @remark Used for error messages.
+     *
+     * @param uniform Handle to the uniform.
+     *
+     * @return Empty string if the handle is invalid.
+     */
+    static std::string getUniformName(ShaderUniformHandle uniform);
 
-    /** Locations of all uniform variables. */
-    std::unordered_map<std::string, int> cachedUniformLocations;
+    /** Handles to all uniform variables used in this program (for string-based lookups). */
+    std::unordered_map<std::string, ShaderUniformHandle> cachedUniformHandles;
+
+    /**
+     * Locations of uniform variables where index is @ref ShaderUniformHandle::iIndex,
+     * -1 for uniforms not used in this program.
+     */
+    std::vector<int> vUniformLocations;
 
     /** Binding indices of all uniform blocks. */
     std::unordered_map<std::string, unsigned int> cachedUniformBlockBindingIndices;
@@ -237,16 +453,25 @@ private:
     /** Manager that created this program. */
     ShaderManager* const pShaderManager = nullptr;
 
-    /** ID of the created shader program. */
-    const unsigned int iShaderProgramId = 0;
+    /** Valid until the compilation result is taken. */
+    std::future<CompiledShaderProgram> compilationResult;
+
+    /** Not `nullptr` if the GPU might still be executing commands that created the programs. */
+    GLsync pCompilationFence = nullptr;
+
+    /** ID of the created shader program (0 until the compilation result is taken). */
+    unsigned int iShaderProgramId = 0;
 
     /** ID of the shader program which has only vertex shader linked. */
-    const unsigned int iVertexOnlyShaderProgramId = 0;
+    unsigned int iVertexOnlyShaderProgramId = 0;
+
+    /** `true` if finished compiling and uniform locations are cached. */
+    bool bIsReady = false;
 };
 
-inline int ShaderProgram::getShaderUniformLocation(const std::string& sUniformName) {
-    const auto cachedIt = cachedUniformLocations.find(sUniformName);
-    if (cachedIt == cachedUniformLocations.end()) [[unlikely]] {
+inline ShaderUniformHandle ShaderProgram::getCachedUniformHandle(const std::string& sUniformName) const {
+    const auto cachedIt = cachedUniformHandles.find(sUniformName);
+    if (cachedIt == cachedUniformHandles.end()) [[unlikely]] {
         Error::showErrorAndThrowException(
             std::format("unable to find uniform \"{}\" location", sUniformName));
     }
@@ -254,13 +479,35 @@ inline int ShaderProgram::getShaderUniformLocation(const std::string& sUniformNa
     return cachedIt->second;
 }
 
+inline int ShaderProgram::tryGetShaderUniformLocation(ShaderUniformHandle uniform) const {
+    if (uniform.iIndex >= vUniformLocations.size()) {
+        return -1;
+    }
+
+    return vUniformLocations[uniform.iIndex];
+}
+
+inline int ShaderProgram::getShaderUniformLocation(ShaderUniformHandle uniform) const {
+    const auto iLocation = tryGetShaderUniformLocation(uniform);
+    if (iLocation < 0) [[unlikely]] {
+        Error::showErrorAndThrowException(
+            std::format("unable to find uniform \"{}\" location", getUniformName(uniform)));
+    }
+
+    return iLocation;
+}
+
+inline int ShaderProgram::getShaderUniformLocation(const std::string& sUniformName) {
+    return getShaderUniformLocation(getCachedUniformHandle(sUniformName));
+}
+
 inline int ShaderProgram::tryGetShaderUniformLocation(const std::string& sUniformName) {
-    const auto cachedIt = cachedUniformLocations.find(sUniformName);
-    if (cachedIt == cachedUniformLocations.end()) {
+    const auto cachedIt = cachedUniformHandles.find(sUniformName);
+    if (cachedIt == cachedUniformHandles.end()) {
         return -1;
     }
 
-    return cachedIt->second;
+    return tryGetShaderUniformLocation(cachedIt->second);
 }
 
 inline unsigned int ShaderProgram::getShaderUniformBlockBindingIndex(const std::string& sUniformBlockName) {
@@ -275,53 +522,98 @@ inline unsigned int ShaderProgram::getShaderUniformBlockBindingIndex(const std::
 
 inline void
 ShaderProgram::setMatrix4ToActiveProgram(const std::string& sUniformName, const glm::mat4x4& matrix) {
-    glUniformMatrix4fv(getShaderUniformLocation(sUniformName), 1, GL_FALSE, glm::value_ptr(matrix));
+    setMatrix4ToActiveProgram(getCachedUniformHandle(sUniformName), matrix);
+}
+
+inline void ShaderProgram::setMatrix4ToActiveProgram(ShaderUniformHandle uniform, const glm::mat4x4& matrix) {
+    glUniformMatrix4fv(getShaderUniformLocation(uniform), 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
 inline void ShaderProgram::setMatrix4ArrayToActiveProgram(
     const std::string& sUniformName, int iArraySize, const float* pArrayStart) {
-    glUniformMatrix4fv(getShaderUniformLocation(sUniformName), iArraySize, GL_FALSE, pArrayStart);
+    setMatrix4ArrayToActiveProgram(getCachedUniformHandle(sUniformName), iArraySize, pArrayStart);
+}
+
+inline void ShaderProgram::setMatrix4ArrayToActiveProgram(
+    ShaderUniformHandle uniform, int iArraySize, const float* pArrayStart) {
+    glUniformMatrix4fv(getShaderUniformLocation(uniform), iArraySize, GL_FALSE, pArrayStart);
 }
 
 inline void
 ShaderProgram::setMatrix3ToActiveProgram(const std::string& sUniformName, const glm::mat3x3& matrix) {
-    glUniformMatrix3fv(getShaderUniformLocation(sUniformName), 1, GL_FALSE, glm::value_ptr(matrix));
+    setMatrix3ToActiveProgram(getCachedUniformHandle(sUniformName), matrix);
+}
+
+inline void ShaderProgram::setMatrix3ToActiveProgram(ShaderUniformHandle uniform, const glm::mat3x3& matrix) {
+    glUniformMatrix3fv(getShaderUniformLocation(uniform), 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
 inline void
 ShaderProgram::setVector2ToActiveProgram(const std::string& sUniformName, const glm::vec2& vector) {
-    glUniform2fv(getShaderUniformLocation(sUniformName), 1, glm::value_ptr(vector));
+    setVector2ToActiveProgram(getCachedUniformHandle(sUniformName), vector);
+}
+
+inline void ShaderProgram::setVector2ToActiveProgram(ShaderUniformHandle uniform, const glm::vec2& vector) {
+    glUniform2fv(getShaderUniformLocation(uniform), 1, glm::value_ptr(vector));
 }
 
 inline void
 ShaderProgram::setUvector2ToActiveProgram(const std::string& sUniformName, const glm::uvec2& vector) {
-    glUniform2uiv(getShaderUniformLocation(sUniformName), 1, glm::value_ptr(vector));
+    setUvector2ToActiveProgram(getCachedUniformHandle(sUniformName), vector);
+}
+
+inline void ShaderProgram::setUvector2ToActiveProgram(ShaderUniformHandle uniform, const glm::uvec2& vector) {
+    glUniform2uiv(getShaderUniformLocation(uniform), 1, glm::value_ptr(vector));
 }
 
 inline void
 ShaderProgram::setVector3ToActiveProgram(const std::string& sUniformName, const glm::vec3& vector) {
-    glUniform3fv(getShaderUniformLocation(sUniformName), 1, glm::value_ptr(vector));
+    setVector3ToActiveProgram(getCachedUniformHandle(sUniformName), vector);
+}
+
+inline void ShaderProgram::setVector3ToActiveProgram(ShaderUniformHandle uniform, const glm::vec3& vector) {
+    glUniform3fv(getShaderUniformLocation(uniform), 1, glm::value_ptr(vector));
 }
 
 inline void
 ShaderProgram::setVector4ToActiveProgram(const std::string& sUniformName, const glm::vec4& vector) {
-    glUniform4fv(getShaderUniformLocation(sUniformName), 1, glm::value_ptr(vector));
+    setVector4ToActiveProgram(getCachedUniformHandle(sUniformName), vector);
 }
 
-inline void ShaderProgram::setBoolToActiveProgram(const std::string& sUniformName, bool bValue) {
-    glUniform1i(getShaderUniformLocation(sUniformName), static_cast<int>(bValue));
+inline void ShaderProgram::setVector4ToActiveProgram(ShaderUniformHandle uniform, const glm::vec4& vector) {
+    glUniform4fv(getShaderUniformLocation(uniform), 1, glm::value_ptr(vector));
 }
 
 inline void ShaderProgram::setFloatToActiveProgram(const std::string& sUniformName, float value) {
-    glUniform1f(getShaderUniformLocation(sUniformName), value);
+    setFloatToActiveProgram(getCachedUniformHandle(sUniformName), value);
+}
+
+inline void ShaderProgram::setFloatToActiveProgram(ShaderUniformHandle uniform, float value) {
+    glUniform1f(getShaderUniformLocation(uniform), value);
 }
 
 inline void ShaderProgram::setUintToActiveProgram(const std::string& sUniformName, unsigned int iValue) {
-    glUniform1ui(getShaderUniformLocation(sUniformName), iValue);
+    setUintToActiveProgram(getCachedUniformHandle(sUniformName), iValue);
+}
+
+inline void ShaderProgram::setUintToActiveProgram(ShaderUniformHandle uniform, unsigned int iValue) {
+    glUniform1ui(getShaderUniformLocation(uniform), iValue);
 }
 
 inline void ShaderProgram::setIntToActiveProgram(const std::string& sUniformName, int iValue) {
-    glUniform1i(getShaderUniformLocation(sUniformName), iValue);
+    setIntToActiveProgram(getCachedUniformHandle(sUniformName), iValue);
+}
+
+inline void ShaderProgram::setIntToActiveProgram(ShaderUniformHandle uniform, int iValue) {
+    glUniform1i(getShaderUniformLocation(uniform), iValue);
+}
+
+inline void ShaderProgram::setBoolToActiveProgram(const std::string& sUniformName, bool bValue) {
+    setBoolToActiveProgram(getCachedUniformHandle(sUniformName), bValue);
+}
+
+inline void ShaderProgram::setBoolToActiveProgram(ShaderUniformHandle uniform, bool bValue) {
+    glUniform1i(getShaderUniformLocation(uniform), static_cast<int>(bValue));
 }
 
 inline void
@@ -2,11 +2,23 @@
 
 // Custom.
 #include "misc/Error.h"
+#include "render/GpuMemoryTracker.h"
 
 // External.
 #include "glad/glad.h"
 
-Texture::~Texture() { GL_CHECK_ERROR(glDeleteTextures(1, &iTextureId)); }
+Texture::~Texture() {
+    GL_CHECK_ERROR(glDeleteTextures(1, &iTextureId));
+    GpuMemoryTracker::unregisterResource(iTrackedResourceId);
+}
 
-Texture::Texture(unsigned int iTextureId, unsigned int iWidth, unsigned int iHeight, int iGlFormat)
-    : iTextureId(iTextureId), size(iWidth, iHeight), iGlFormat(iGlFormat) {}
+Texture::Texture(
+    unsigned int iTextureId,
+    unsigned int iWidth,
+    unsigned int iHeight,
+    int iGlFormat,
+    size_t iSizeInBytes,
+    const std::source_location& location)
+    : iTextureId(iTextureId), size(iWidth, iHeight), iGlFormat(iGlFormat),
+      iTrackedResourceId(
+          GpuMemoryTracker::registerResource(GpuResourceCategory::TEXTURE, iSizeInBytes, location)) {}
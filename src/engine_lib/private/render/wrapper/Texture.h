@@ -2,6 +2,7 @@
 
 // Standard.
 #include <utility>
+#include <source_location>
 
 /**
  * Manages OpenGL texture object.
@@ -51,7 +52,13 @@ private:
      * @param iHeight    Height of the texture in pixels.
      * @param iGlFormat  OpenGL format of the texture.
      */
-    Texture(unsigned int iTextureId, unsigned int iWidth, unsigned int iHeight, int iGlFormat);
+    Texture(
+        unsigned int iTextureId,
+        unsigned int iWidth,
+        unsigned int iHeight,
+        int iGlFormat,
+        size_t iSizeInBytes,
+        const std::source_location& location);
 
     /** OpenGL ID of the texture. */
     const unsigned int iTextureId = 0;
@@ -61,4 +68,7 @@ private:
 
     /** OpenGL format of the texture. */
     const int iGlFormat = 0;
+
+    /** ID of this texture in the GPU memory tracker. */
+    const size_t iTrackedResourceId = 0;
 };
@@ -3,6 +3,7 @@
 // External.
 #include "glad/glad.h"
 #include "misc/Error.h"
+#include "render/GpuMemoryTracker.h"
 
 VertexArrayObject::~VertexArrayObject() {
     GL_CHECK_ERROR(glDeleteVertexArrays(1, &iVertexArrayObjectId));
@@ -10,6 +11,7 @@ VertexArrayObject::~VertexArrayObject() {
     if (iIndexBufferObjectId.has_value()) {
         GL_CHECK_ERROR(glDeleteBuffers(1, &*iIndexBufferObjectId));
     }
+    GpuMemoryTracker::unregisterResource(iTrackedResourceId);
 }
 
 VertexArrayObject::VertexArrayObject(
@@ -17,6 +19,10 @@ VertexArrayObject::VertexArrayObject(
     unsigned int iVertexBufferObjectId,
     unsigned int iVertexCount,
     std::optional<unsigned int> iIndexBufferObjectId,
-    std::optional<int> iIndexCount)
+    std::optional<int> iIndexCount,
+    size_t iSizeInBytes,
+    const std::source_location& location)
     : iVertexArrayObjectId(iVertexArrayObjectId), iVertexBufferObjectId(iVertexBufferObjectId),
-      iVertexCount(iVertexCount), iIndexBufferObjectId(iIndexBufferObjectId), iIndexCount(iIndexCount) {}
+      iVertexCount(iVertexCount), iIndexBufferObjectId(iIndexBufferObjectId), iIndexCount(iIndexCount),
+      iTrackedResourceId(GpuMemoryTracker::registerResource(
+          GpuResourceCategory::VERTEX_ARRAY_OBJECT, iSizeInBytes, location)) {}
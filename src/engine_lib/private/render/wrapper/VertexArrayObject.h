@@ -2,6 +2,7 @@
 
 // Standard.
 #include <optional>
+#include <source_location>
 
 // Custom.
 #include "misc/Error.h"
@@ -30,13 +31,17 @@ public:
      * @param iVertexCount          Number of vertices in the vertex buffer.
      * @param iIndexBufferObjectId  ID of the index buffer object (if used).
      * @param iIndexCount           Number of indices to draw (from used index buffer).
+     * @param iSizeInBytes          Total size of the vertex and index buffers.
+     * @param location              Location of the code that requested the VAO.
      */
     VertexArrayObject(
         unsigned int iVertexArrayObjectId,
         unsigned int iVertexBufferObjectId,
         unsigned int iVertexCount,
-        std::optional<unsigned int> iIndexBufferObjectId = {},
-        std::optional<int> iIndexCount = {});
+        std::optional<unsigned int> iIndexBufferObjectId,
+        std::optional<int> iIndexCount,
+        size_t iSizeInBytes,
+        const std::source_location& location);
 
     /**
      * Returns VAO.
@@ -88,4 +93,7 @@ private:
 
     /** Number of indices to draw. */
     std::optional<int> iIndexCount;
+
+    /** ID of this VAO in the GPU memory tracker. */
+    size_t iTrackedResourceId = 0;
 };
@@ -30,9 +30,18 @@ public:
         /** Total number of currently active moving bodies. */
         size_t iActiveMovingBodyCount = 0;
 
+        /** Total number of simulated bodies (active and sleeping). */
+        size_t iTotalSimulatedBodyCount = 0;
+
+        /** Total number of moving bodies (active and sleeping). */
+        size_t iTotalMovingBodyCount = 0;
+
         /** Total number of currently active simulated character bodies. */
         size_t iActiveCharacterBodyCount = 0;
 
+        /** Number of skeleton nodes (in all worlds) that played animations last frame. */
+        size_t iAnimatedSkeletonCount = 0;
+
         /** Total number of meshes rendered last frame. */
         size_t iRenderedMeshCount = 0;
 
@@ -42,9 +51,71 @@ public:
         /** Total number of active light sources culled from rendering last frame. */
         size_t iCulledLightSourceCount = 0;
 
+        /** Number of textures that are being decoded in the thread pool. */
+        size_t iDecodingTextureCount = 0;
+
+        /** Size (in bytes) of decoded textures that wait to be uploaded to the GPU. */
+        size_t iTexturePendingUploadBytes = 0;
+
+        /** Size (in bytes) of textures uploaded to the GPU last frame. */
+        size_t iTextureUploadedBytesLastFrame = 0;
+
+        /** Total size (in bytes) of loaded textures in the GPU memory. */
+        size_t iTextureResidentBytes = 0;
+
+        /** Memory budget (in bytes) for streamed textures, 0 if not limited. */
+        size_t iTextureMemoryBudgetBytes = 0;
+
+        /** Number of textures that currently have their top mips dropped. */
+        size_t iReducedTextureCount = 0;
+
+        /** Number of textures that are currently evicted from the GPU memory. */
+        size_t iEvictedTextureCount = 0;
+
+        /** Total number of texture evictions. */
+        size_t iTotalTextureEvictionCount = 0;
+
+        /** Size (in bytes) of dynamic data (particles, debug geometry) uploaded last frame. */
+        size_t iStreamedBytesLastFrame = 0;
+
+        /** Size (in bytes) of the streaming buffer region used by one frame. */
+        size_t iStreamingBufferFrameRegionBytes = 0;
+
+        /** Size (in bytes) of alive vertex array objects (their vertex and index buffers). */
+        size_t iGpuVertexArrayBytes = 0;
+
+        /** The biggest value that @ref iGpuVertexArrayBytes ever had. */
+        size_t iGpuVertexArrayPeakBytes = 0;
+
+        /** Size (in bytes) of alive buffers (uniform, storage, streaming). */
+        size_t iGpuBufferBytes = 0;
+
+        /** The biggest value that @ref iGpuBufferBytes ever had. */
+        size_t iGpuBufferPeakBytes = 0;
+
+        /** Size (in bytes) of textures owned by alive framebuffers. */
+        size_t iGpuFramebufferBytes = 0;
+
+        /** The biggest value that @ref iGpuFramebufferBytes ever had. */
+        size_t iGpuFramebufferPeakBytes = 0;
+
+        /** Size (in bytes) of alive textures created by the renderer (not including loaded textures). */
+        size_t iGpuTextureBytes = 0;
+
+        /** The biggest value that @ref iGpuTextureBytes ever had. */
+        size_t iGpuTexturePeakBytes = 0;
+
         /** Time in milliseconds that the CPU spent doing the last tick. */
         float cpuTickTimeMs = 0.0f;
 
+        /**
+         * Time in milliseconds that the CPU spent updating animations (of all worlds) during the last tick.
+         */
+        float animationUpdateTimeMs = 0.0f;
+
+        /** Time in milliseconds that the CPU spent applying physics results to nodes during the last tick. */
+        float physicsWriteBackTimeMs = 0.0f;
+
         /** Time in milliseconds that the CPU spent submitting the last frame. */
         float cpuSubmitFrameTimeMs = 0.0f;
 
@@ -0,0 +1,110 @@
+#pragma once
+
+// Standard.
+#include <filesystem>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Stores a square grid of terrain heights to be converted to a height field shape for physics.
+ *
+ * @remark Heights are stored as 16-bit samples in range [min height; max height] to keep files small.
+ */
+class HeightFieldGeometry {
+public:
+    HeightFieldGeometry() = default;
+    ~HeightFieldGeometry() = default;
+
+    /** Copy constructor. */
+    HeightFieldGeometry(const HeightFieldGeometry&) = default;
+    /** Copy assignment. @return this. */
+    HeightFieldGeometry& operator=(const HeightFieldGeometry&) = default;
+
+    /** Move constructor. */
+    HeightFieldGeometry(HeightFieldGeometry&&) noexcept = default;
+    /** Move assignment. @return this. */
+    HeightFieldGeometry& operator=(HeightFieldGeometry&&) noexcept = default;
+
+    /**
+     * Deserializes the geometry from the file (also see @ref serialize).
+     *
+     * @param pathToFile File to deserialize from.
+     *
+     * @return Geometry.
+     */
+    static HeightFieldGeometry deserialize(const std::filesystem::path& pathToFile);
+
+    /**
+     * Serializes the geometry data into a file.
+     *
+     * @param pathToFile File to serialize to.
+     */
+    void serialize(const std::filesystem::path& pathToFile) const;
+
+    /**
+     * Sets heights of the grid (converted to 16-bit samples).
+     *
+     * @param vHeights     Heights (in meters) in row-major order (X changes first, then Z).
+     * @param iSampleCount Number of samples along each side of the grid, the number of heights must be
+     * equal to `iSampleCount * iSampleCount`.
+     */
+    void setHeights(const std::vector<float>& vHeights, unsigned int iSampleCount);
+
+    /**
+     * Sets distance between 2 neighbour samples.
+     *
+     * @param spacing Distance in meters.
+     */
+    void setSampleSpacing(float spacing);
+
+    /**
+     * Returns heights of the grid converted from 16-bit samples.
+     *
+     * @return Heights (in meters) in row-major order (X changes first, then Z).
+     */
+    std::vector<float> getHeights() const;
+
+    /**
+     * Returns the number of samples along each side of the grid.
+     *
+     * @return Sample count.
+     */
+    unsigned int getSampleCount() const { return iSampleCount; }
+
+    /**
+     * Returns distance between 2 neighbour samples.
+     *
+     * @return Distance in meters.
+     */
+    float getSampleSpacing() const { return sampleSpacing; }
+
+    /**
+     * Returns height that corresponds to a sample of 0.
+     *
+     * @return Height in meters.
+     */
+    float getMinHeight() const { return minHeight; }
+
+    /**
+     * Returns height that corresponds to the maximum sample value.
+     *
+     * @return Height in meters.
+     */
+    float getMaxHeight() const { return maxHeight; }
+
+private:
+    /** Samples where 0 is @ref minHeight and the maximum value is @ref maxHeight. */
+    std::vector<uint16_t> vSamples;
+
+    /** Number of samples along each side of the grid. */
+    unsigned int iSampleCount = 0;
+
+    /** Distance (in meters) between 2 neighbour samples. */
+    float sampleSpacing = 1.0f;
+
+    /** Height (in meters) of a sample of 0. */
+    float minHeight = 0.0f;
+
+    /** Height (in meters) of a sample with the maximum value. */
+    float maxHeight = 0.0f;
+};
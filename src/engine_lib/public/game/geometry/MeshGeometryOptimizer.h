@@ -0,0 +1,128 @@
+#pragma once
+
+// Standard.
+#include <vector>
+#include <variant>
+
+// Custom.
+#include "math/GLMath.hpp"
+#include "misc/Error.h"
+#include "game/geometry/MeshNodeGeometry.h"
+#include "game/geometry/SkeletalMeshNodeGeometry.h"
+
+/** Describes results of a mesh optimization. */
+struct MeshOptimizationStats {
+    /** Average cache miss ratio (transformed vertices per triangle) before the optimization. */
+    float acmrBefore = 0.0f;
+
+    /** Average cache miss ratio (transformed vertices per triangle) after the optimization. */
+    float acmrAfter = 0.0f;
+
+    /** Number of vertices before the optimization. */
+    size_t iVertexCountBefore = 0;
+
+    /** Number of vertices after the optimization. */
+    size_t iVertexCountAfter = 0;
+
+    /** Number of triangles before the optimization. */
+    size_t iTriangleCountBefore = 0;
+
+    /** Number of triangles after the optimization (degenerate triangles are removed). */
+    size_t iTriangleCountAfter = 0;
+};
+
+/**
+ * Provides static functions for CPU-side optimization of mesh geometry (usually done once during the import)
+ * to reduce the amount of work the GPU does when rendering the mesh.
+ */
+class MeshGeometryOptimizer {
+public:
+    MeshGeometryOptimizer() = delete;
+
+    /** Size of the FIFO post-transform vertex cache that we optimize for and use to calculate ACMR. */
+    static constexpr size_t iVertexCacheSize = 16;
+
+    /**
+     * Default threshold for @ref optimizeOverdraw, specifies how much the ACMR is allowed to grow
+     * (1.05 means up to 5% worse ACMR) in exchange of less overdraw.
+     */
+    static constexpr float defaultOverdrawThreshold = 1.05f;
+
+    /**
+     * Runs all optimization stages on the geometry: removes duplicate vertices and degenerate triangles,
+     * reorders triangles for post-transform vertex cache locality, reorders clusters of triangles to
+     * reduce overdraw and reorders vertices to improve vertex fetch locality.
+     *
+     * @param geometry Geometry to optimize.
+     *
+     * @return Error if the geometry is invalid, otherwise optimization stats.
+     */
+    [[nodiscard]] static std::variant<Error, MeshOptimizationStats> optimize(MeshNodeGeometry& geometry);
+
+    /**
+     * Runs all optimization stages on the geometry: removes duplicate vertices and degenerate triangles,
+     * reorders triangles for post-transform vertex cache locality, reorders clusters of triangles to
+     * reduce overdraw and reorders vertices to improve vertex fetch locality.
+     *
+     * @param geometry Geometry to optimize.
+     *
+     * @return Error if the geometry is invalid, otherwise optimization stats.
+     */
+    [[nodiscard]] static std::variant<Error, MeshOptimizationStats>
+    optimize(SkeletalMeshNodeGeometry& geometry);
+
+    /**
+     * Calculates average cache miss ratio (number of transformed vertices per triangle) by simulating
+     * a FIFO post-transform vertex cache. The best possible value is 0.5, the worst is 3.0.
+     *
+     * @param vIndices   Triangle list indices.
+     * @param iCacheSize Size of the simulated cache.
+     *
+     * @return ACMR (0 if there are no triangles).
+     */
+    static float
+    calculateAcmr(const std::vector<MeshIndexType>& vIndices, size_t iCacheSize = iVertexCacheSize);
+
+    /**
+     * Reorders triangles to improve post-transform vertex cache locality (Tipsify algorithm).
+     *
+     * @param vIndices     Triangle list indices.
+     * @param iVertexCount Total number of vertices that indices reference.
+     * @param iCacheSize   Size of the cache to optimize for.
+     *
+     * @return Reordered triangle list indices.
+     */
+    static std::vector<MeshIndexType> optimizeVertexCache(
+        const std::vector<MeshIndexType>& vIndices,
+        size_t iVertexCount,
+        size_t iCacheSize = iVertexCacheSize);
+
+    /**
+     * Splits triangles (expected to be already optimized by @ref optimizeVertexCache) into clusters
+     * and sorts clusters so that triangles facing outwards of the mesh are drawn first which reduces
+     * overdraw.
+     *
+     * @param vIndices   Triangle list indices to reorder.
+     * @param vPositions Positions of the vertices.
+     * @param threshold  How much the ACMR is allowed to grow (1.05 means up to 5% worse ACMR), smaller
+     * values result in larger clusters.
+     * @param iCacheSize Size of the cache used to find cluster boundaries.
+     */
+    static void optimizeOverdraw(
+        std::vector<MeshIndexType>& vIndices,
+        const std::vector<glm::vec3>& vPositions,
+        float threshold = defaultOverdrawThreshold,
+        size_t iCacheSize = iVertexCacheSize);
+
+    /**
+     * Calculates a vertex remap table that places vertices in the order of their first use
+     * in the index buffer (improves vertex fetch locality), unused vertices are removed.
+     *
+     * @param vIndices     Triangle list indices, will be remapped to the new vertex order.
+     * @param iVertexCount Total number of vertices that indices reference.
+     *
+     * @return For each new vertex index - index of the old vertex.
+     */
+    static std::vector<size_t>
+    optimizeVertexFetch(std::vector<MeshIndexType>& vIndices, size_t iVertexCount);
+};
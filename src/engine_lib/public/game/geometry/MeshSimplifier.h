@@ -0,0 +1,34 @@
+#pragma once
+
+// Standard.
+#include <vector>
+
+// Custom.
+#include "game/geometry/MeshNodeGeometry.h"
+
+/**
+ * Provides static functions for reducing the number of triangles in a mesh (usually used to generate LODs
+ * during the import).
+ */
+class MeshSimplifier {
+public:
+    MeshSimplifier() = delete;
+
+    /**
+     * Simplifies the geometry using quadric error metric driven edge collapses (each collapse moves
+     * one vertex into a neighbour vertex so the resulting vertices are a subset of the original vertices).
+     *
+     * @remark Vertices with the same position but different attributes (UV or normal seams) are
+     * collapsed together, open borders of the mesh are preserved.
+     *
+     * @param geometry             Geometry to simplify.
+     * @param iTargetTriangleCount Simplification stops once the triangle count is equal or below this value.
+     * @param maxError             Simplification stops once the error of the next collapse exceeds this value,
+     * the error is a distance relative to the size of the mesh (diagonal of the mesh's bounding box),
+     * for example 0.01 means 1% of the mesh size.
+     *
+     * @return Simplified geometry (unused vertices are removed).
+     */
+    static MeshNodeGeometry
+    simplify(const MeshNodeGeometry& geometry, size_t iTargetTriangleCount, float maxError);
+};
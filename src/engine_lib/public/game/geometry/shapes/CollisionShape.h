@@ -70,6 +70,15 @@ public:
      */
     virtual JPH::Result<JPH::Ref<JPH::Shape>> createShape(float density = 1000.0f) const;
 
+    /**
+     * Returns a string that identifies the Jolt shape created by @ref createShape (shape type and its
+     * parameters), collision shapes with equal keys create identical Jolt shapes so physics bodies can
+     * share a single Jolt shape.
+     *
+     * @return Empty string if the shape should not be shared (default implementation).
+     */
+    virtual std::string getShapeCacheKey() const;
+
 protected:
     /** Must be called by derived classes after they change some property of the shape. */
     void propertyChanged();
@@ -133,6 +142,13 @@ public:
      */
     virtual JPH::Result<JPH::Ref<JPH::Shape>> createShape(float density = 1000.0f) const override;
 
+    /**
+     * Returns a string that identifies the Jolt shape created by @ref createShape.
+     *
+     * @return Shape type and its parameters.
+     */
+    virtual std::string getShapeCacheKey() const override;
+
 private:
     /** Half the size of the box. */
     glm::vec3 halfExtent = glm::vec3(0.5f, 0.5f, 0.5f);
@@ -192,6 +208,13 @@ public:
      */
     virtual JPH::Result<JPH::Ref<JPH::Shape>> createShape(float density = 1000.0f) const override;
 
+    /**
+     * Returns a string that identifies the Jolt shape created by @ref createShape.
+     *
+     * @return Shape type and its parameters.
+     */
+    virtual std::string getShapeCacheKey() const override;
+
 private:
     /** Radius of the sphere. */
     float radius = 0.5f;
@@ -265,6 +288,13 @@ public:
      */
     virtual JPH::Result<JPH::Ref<JPH::Shape>> createShape(float density = 1000.0f) const override;
 
+    /**
+     * Returns a string that identifies the Jolt shape created by @ref createShape.
+     *
+     * @return Shape type and its parameters.
+     */
+    virtual std::string getShapeCacheKey() const override;
+
 private:
     /** Half height of the capsule. */
     float halfHeight = 0.8f;
@@ -341,6 +371,13 @@ public:
      */
     virtual JPH::Result<JPH::Ref<JPH::Shape>> createShape(float density = 1000.0f) const override;
 
+    /**
+     * Returns a string that identifies the Jolt shape created by @ref createShape.
+     *
+     * @return Shape type and its parameters.
+     */
+    virtual std::string getShapeCacheKey() const override;
+
 private:
     /** Half height of the cylinder. */
     float halfHeight = 0.5f;
@@ -395,7 +432,28 @@ public:
     std::string getPathToGeometryRelativeRes() const { return sPathToGeometryRelativeRes; }
 
     /**
-     * Creates a shape for Jolt physics.
+     * Builds a convex hull from the specified geometry file and saves it next to the geometry (see
+     * @ref getPathToCookedConvexHull) so that @ref createShape loads the hull instead of building it.
+     *
+     * @remark The cooked hull is ignored if the geometry file was modified after the hull was cooked.
+     *
+     * @param pathToGeometryFile Path to the file that stores convex shape geometry.
+     *
+     * @return Error if something went wrong.
+     */
+    [[nodiscard]] static std::optional<Error> cookConvexHull(const std::filesystem::path& pathToGeometryFile);
+
+    /**
+     * Returns path to the file that stores a cooked convex hull of the specified geometry file.
+     *
+     * @param pathToGeometryFile Path to the file that stores convex shape geometry.
+     *
+     * @return Path to the cooked hull (the file might not exist).
+     */
+    static std::filesystem::path getPathToCookedConvexHull(const std::filesystem::path& pathToGeometryFile);
+
+    /**
+     * Creates a shape for Jolt physics, loads a cooked convex hull if it exists (see @ref cookConvexHull).
      *
      * @param density Uniform density of the interior of the convex object (kg / m^3).
      *
@@ -403,7 +461,200 @@ public:
      */
     virtual JPH::Result<JPH::Ref<JPH::Shape>> createShape(float density = 1000.0f) const override;
 
+    /**
+     * Returns a string that identifies the Jolt shape created by @ref createShape.
+     *
+     * @return Shape type and its parameters.
+     */
+    virtual std::string getShapeCacheKey() const override;
+
 private:
     /** Path (relative to the `res` directory) to the file that stores convex shape geometry. */
     std::string sPathToGeometryRelativeRes;
 };
+
+// ------------------------------------------------------------------------------------------------
+
+/**
+ * Triangle mesh collision built from a mesh node geometry file, mostly used for static level geometry.
+ *
+ * @remark Can only be used by static bodies (such as collision nodes) because a triangle mesh has no volume.
+ */
+class MeshCollisionShape : public CollisionShape {
+public:
+    MeshCollisionShape() = default;
+    virtual ~MeshCollisionShape() override = default;
+
+    /**
+     * Returns reflection info about this type.
+     *
+     * @return Type reflection.
+     */
+    static TypeReflectionInfo getReflectionInfo();
+
+    /**
+     * Returns GUID of the type, this GUID is used to retrieve reflection information from the reflected type
+     * database.
+     *
+     * @return GUID.
+     */
+    static std::string getTypeGuidStatic();
+
+    /**
+     * Returns GUID of the type, this GUID is used to retrieve reflection information from the reflected type
+     * database.
+     *
+     * @return GUID.
+     */
+    virtual std::string getTypeGuid() const override;
+
+    /**
+     * Sets path (relative to the `res` directory) to the file that stores mesh node geometry.
+     *
+     * @param sRelativePath New path.
+     */
+    void setPathToGeometryRelativeRes(const std::string& sRelativePath);
+
+    /**
+     * Returns path (relative to the `res` directory) to the file that stores mesh node geometry.
+     *
+     * @return Relative path.
+     */
+    std::string getPathToGeometryRelativeRes() const { return sPathToGeometryRelativeRes; }
+
+    /**
+     * Builds a triangle mesh shape (with its bounding volume hierarchy) from the specified geometry file and
+     * saves it next to the geometry (see @ref getPathToCookedMesh) so that @ref createShape loads the shape
+     * instead of building it.
+     *
+     * @remark The cooked mesh is ignored if the geometry file was modified after the mesh was cooked.
+     *
+     * @param pathToGeometryFile Path to the file that stores mesh node geometry.
+     *
+     * @return Error if something went wrong.
+     */
+    [[nodiscard]] static std::optional<Error> cookMesh(const std::filesystem::path& pathToGeometryFile);
+
+    /**
+     * Returns path to the file that stores a cooked triangle mesh of the specified geometry file.
+     *
+     * @param pathToGeometryFile Path to the file that stores mesh node geometry.
+     *
+     * @return Path to the cooked mesh (the file might not exist).
+     */
+    static std::filesystem::path getPathToCookedMesh(const std::filesystem::path& pathToGeometryFile);
+
+    /**
+     * Creates a shape for Jolt physics, loads a cooked mesh if it exists (see @ref cookMesh).
+     *
+     * @param density Ignored since the shape can only be used by static bodies.
+     *
+     * @return Shape.
+     */
+    virtual JPH::Result<JPH::Ref<JPH::Shape>> createShape(float density = 1000.0f) const override;
+
+    /**
+     * Returns a string that identifies the Jolt shape created by @ref createShape.
+     *
+     * @return Shape type and its parameters.
+     */
+    virtual std::string getShapeCacheKey() const override;
+
+private:
+    /** Path (relative to the `res` directory) to the file that stores mesh node geometry. */
+    std::string sPathToGeometryRelativeRes;
+};
+
+// ------------------------------------------------------------------------------------------------
+
+/**
+ * Height field (terrain) collision built from a height field geometry file (see @ref HeightFieldGeometry),
+ * the grid is centered at the origin of the shape.
+ *
+ * @remark Can only be used by static bodies (such as collision nodes) because a height field has no volume.
+ */
+class HeightFieldCollisionShape : public CollisionShape {
+public:
+    HeightFieldCollisionShape() = default;
+    virtual ~HeightFieldCollisionShape() override = default;
+
+    /**
+     * Returns reflection info about this type.
+     *
+     * @return Type reflection.
+     */
+    static TypeReflectionInfo getReflectionInfo();
+
+    /**
+     * Returns GUID of the type, this GUID is used to retrieve reflection information from the reflected type
+     * database.
+     *
+     * @return GUID.
+     */
+    static std::string getTypeGuidStatic();
+
+    /**
+     * Returns GUID of the type, this GUID is used to retrieve reflection information from the reflected type
+     * database.
+     *
+     * @return GUID.
+     */
+    virtual std::string getTypeGuid() const override;
+
+    /**
+     * Sets path (relative to the `res` directory) to the file that stores height field geometry.
+     *
+     * @param sRelativePath New path.
+     */
+    void setPathToGeometryRelativeRes(const std::string& sRelativePath);
+
+    /**
+     * Returns path (relative to the `res` directory) to the file that stores height field geometry.
+     *
+     * @return Relative path.
+     */
+    std::string getPathToGeometryRelativeRes() const { return sPathToGeometryRelativeRes; }
+
+    /**
+     * Builds a height field shape from the specified geometry file and saves it next to the geometry (see
+     * @ref getPathToCookedHeightField) so that @ref createShape loads the shape instead of building it.
+     *
+     * @remark The cooked height field is ignored if the geometry file was modified after it was cooked.
+     *
+     * @param pathToGeometryFile Path to the file that stores height field geometry.
+     *
+     * @return Error if something went wrong.
+     */
+    [[nodiscard]] static std::optional<Error>
+    cookHeightField(const std::filesystem::path& pathToGeometryFile);
+
+    /**
+     * Returns path to the file that stores a cooked height field of the specified geometry file.
+     *
+     * @param pathToGeometryFile Path to the file that stores height field geometry.
+     *
+     * @return Path to the cooked height field (the file might not exist).
+     */
+    static std::filesystem::path getPathToCookedHeightField(const std::filesystem::path& pathToGeometryFile);
+
+    /**
+     * Creates a shape for Jolt physics, loads a cooked height field if it exists (see
+     * @ref cookHeightField).
+     *
+     * @param density Ignored since the shape can only be used by static bodies.
+     *
+     * @return Shape.
+     */
+    virtual JPH::Result<JPH::Ref<JPH::Shape>> createShape(float density = 1000.0f) const override;
+
+    /**
+     * Returns a string that identifies the Jolt shape created by @ref createShape.
+     *
+     * @return Shape type and its parameters.
+     */
+    virtual std::string getShapeCacheKey() const override;
+
+private:
+    /** Path (relative to the `res` directory) to the file that stores height field geometry. */
+    std::string sPathToGeometryRelativeRes;
+};
@@ -1,5 +1,8 @@
 #pragma once
 
+// Standard.
+#include <array>
+
 // Custom.
 #include "math/GLMath.hpp"
 #include "game/node/SpatialNode.h"
@@ -7,6 +10,7 @@
 #include "material/Material.h"
 #include "render/wrapper/VertexArrayObject.h"
 #include "game/geometry/shapes/AABB.h"
+#include "render/MeshLodLimits.hpp"
 
 class MeshRenderingHandle;
 
@@ -98,6 +102,21 @@ public:
      */
     void setMeshGeometryBeforeSpawned(MeshNodeGeometry&& meshGeometry);
 
+    /**
+     * Sets a simplified version of the mesh geometry that will be rendered instead of the original
+     * geometry when the mesh becomes small on the screen.
+     *
+     * @remark LODs are only used if they are specified without gaps, for example if LOD 2 is specified
+     * but LOD 1 is empty then only the original geometry will be used.
+     *
+     * @warning If this function is used while the node is spawned an error message will be shown.
+     *
+     * @param iLodIndex    Index of the LOD in range [1; MAX_MESH_LOD_COUNT - 1] where 1 is the most detailed
+     * simplified version (0 is the original geometry).
+     * @param meshGeometry Simplified geometry, specify empty geometry to remove the LOD.
+     */
+    void setLodGeometryBeforeSpawned(size_t iLodIndex, MeshNodeGeometry&& meshGeometry);
+
     /**
      * Sets whether this mesh is visible or not.
      *
@@ -121,6 +140,15 @@ public:
      */
     MeshNodeGeometry copyMeshData() const { return meshGeometry; }
 
+    /**
+     * Returns a copy of the geometry of the specified LOD.
+     *
+     * @param iLodIndex Index of the LOD in range [1; MAX_MESH_LOD_COUNT - 1].
+     *
+     * @return Geometry (empty if the LOD is not specified).
+     */
+    MeshNodeGeometry copyLodMeshData(size_t iLodIndex) const;
+
     /**
      * Tells whether this mesh is currently visible or not.
      *
@@ -229,6 +257,9 @@ private:
     /** Mesh geometry. */
     MeshNodeGeometry meshGeometry;
 
+    /** Simplified versions of @ref meshGeometry (LOD 1, LOD 2 and so on), empty if not used. */
+    std::array<MeshNodeGeometry, MAX_MESH_LOD_COUNT - 1> vLodGeometries;
+
     /** AABB in model space. */
     AABB aabbLocal;
 
@@ -238,6 +269,9 @@ private:
     /** Not `nullptr` while spawned. */
     std::unique_ptr<VertexArrayObject> pVao;
 
+    /** VAOs of @ref vLodGeometries, not `nullptr` while spawned and the LOD is used. */
+    std::array<std::unique_ptr<VertexArrayObject>, MAX_MESH_LOD_COUNT - 1> vLodVaos;
+
     /** Not `nullptr` if spawned and visible. */
     std::unique_ptr<MeshRenderingHandle> pRenderingHandle;
 
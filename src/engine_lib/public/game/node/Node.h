@@ -824,6 +824,19 @@ private:
         AttachmentRule rotationRule,
         AttachmentRule scaleRule);
 
+    /**
+     * Serializes the node tree (see the public overload for details).
+     *
+     * @param pathToFile    File to write the node tree to.
+     * @param bEnableBackup If 'true' will also use a backup (copy) file.
+     * @param bSkipGeometry `true` to keep the existing geometry directory and not write geometry
+     * files (used when geometry files were already written using Serializable::serializeGeometry).
+     *
+     * @return Error if something went wrong.
+     */
+    [[nodiscard]] std::optional<Error>
+    serializeNodeTree(std::filesystem::path pathToFile, bool bEnableBackup, bool bSkipGeometry);
+
     /**
      * Locks @ref mtxChildNodes mutex for self and recursively for all children.
      * After a node with children was locked this makes the whole node tree to be
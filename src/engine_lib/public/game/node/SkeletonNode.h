@@ -13,6 +13,8 @@
 #include "ozz/base/maths/soa_transform.h"
 #include "ozz/base/containers/vector.h"
 #include "ozz/animation/runtime/sampling_job.h"
+#include "ozz/animation/runtime/blending_job.h"
+#include "ozz/base/span.h"
 
 namespace ozz {
     namespace animation {
@@ -20,8 +22,9 @@ namespace ozz {
         class Animation;
     }
 }
+struct SkeletonAsset;
 
-/** Groups data needed to sample an animation. */
+/** Groups data needed to sample an animation (the animation itself is shared between nodes). */
 class AnimationSampler {
 public:
     AnimationSampler() = delete;
@@ -30,10 +33,11 @@ public:
      * Initializes the sampler.
      *
      * @param pInAnimation Animation to sample.
-     * @param pSkeleton  Skeleton that will be used with the animation.
+     * @param pSkeleton    Skeleton that will be used with the animation.
      */
     AnimationSampler(
-        std::unique_ptr<ozz::animation::Animation> pInAnimation, ozz::animation::Skeleton* pSkeleton);
+        std::shared_ptr<const ozz::animation::Animation> pInAnimation,
+        const ozz::animation::Skeleton* pSkeleton);
 
     AnimationSampler(const AnimationSampler&) = delete;
     AnimationSampler& operator=(const AnimationSampler&) = delete;
@@ -54,10 +58,14 @@ public:
     /**
      * Updates playing animation state.
      *
+     * @remark Can be called from a worker thread (only uses the state of this sampler).
+     *
      * @param deltaTime Delta time.
      * @param bSampleBoneMatrices `true` to sample bone matrices (do animation sampling).
+     *
+     * @return `false` if failed to sample the animation.
      */
-    void updateAnimation(float deltaTime, bool bSampleBoneMatrices);
+    bool updateAnimation(float deltaTime, bool bSampleBoneMatrices);
 
     /**
      * Sets playback speed where 1.0 means default speed.
@@ -95,8 +103,8 @@ public:
     ozz::vector<ozz::math::SoaTransform>& getLocalTransforms() { return vLocalTransforms; }
 
 private:
-    /** Loaded animation. */
-    std::unique_ptr<ozz::animation::Animation> pAnimation;
+    /** Loaded animation (shared with other nodes that play the same animation). */
+    std::shared_ptr<const ozz::animation::Animation> pAnimation;
 
     /** Context for sampling animation state. */
     std::unique_ptr<ozz::animation::SamplingJob::Context> pSamplingJobContext;
@@ -105,7 +113,7 @@ private:
     ozz::vector<ozz::math::SoaTransform> vLocalTransforms;
 
     /** Skeleton. */
-    ozz::animation::Skeleton* pSkeleton = nullptr;
+    const ozz::animation::Skeleton* pSkeleton = nullptr;
 
     /** Current position of the animation in range [0; 1] where 0 means animation start and 1 means end. */
     float animationRatio = 0.0f;
@@ -120,8 +128,18 @@ private:
     bool bLoopAnimation = false;
 };
 
-/** Plays animations and moves child nodes SkeletalMeshNode according to their per-vertex weights. */
+/**
+ * Plays animations and moves child nodes SkeletalMeshNode according to their per-vertex weights.
+ *
+ * @remark Animations of all spawned skeleton nodes are updated in parallel by the animation manager
+ * after the first tick group and before the second one. The node itself is still called every frame in
+ * the first tick group (so `onBeforeNewFrame` of derived nodes sees the pose of the previous frame and
+ * can change playing animations for this frame).
+ */
 class SkeletonNode : public SpatialNode {
+    // Updates animations and provides memory for skinning matrices.
+    friend class AnimationManager;
+
     /** The maximum number of bones allowed (per skeleton). */
     static constexpr unsigned int iMaxBoneCountAllowed = 64; // same as in shaders
 
@@ -211,11 +229,11 @@ public:
      * Returns matrices used for skinning.
      * Returned matrices are updated every frame if an animation is being played.
      *
-     * @return Matrices.
+     * @remark Returned reference stays valid while the node is spawned.
+     *
+     * @return Matrices (identity matrices if the node is not spawned).
      */
-    const std::array<glm::mat4x4, iMaxBoneCountAllowed>& getSkinningMatrices() const {
-        return vSkinningMatrices;
-    }
+    const std::array<glm::mat4x4, iMaxBoneCountAllowed>& getSkinningMatrices() const;
 
     /**
      * Returns matrices that convert skeleton bones from local space to model space.
@@ -266,18 +284,19 @@ protected:
     virtual void onDespawning() override;
 
     /**
-     * Called before a new frame is rendered.
+     * Updates playing animations and skinning matrices, called every frame while an animation is playing.
+     *
+     * @remark Called by the animation manager from worker threads while other skeleton nodes are being
+     * updated so only use the state of this node.
      *
      * @warning If overriding you must call the parent's version of this function first
-     * (before executing your logic) to execute parent's logic (if there is any).
+     * (before executing your logic) to execute parent's logic.
      *
-     * @remark This function is disabled by default, use @ref setIsCalledEveryFrame to enable it.
-     * @remark This function will only be called while this node is spawned.
+     * @param deltaTime Time in seconds that has passed since the last update.
      *
-     * @param timeSincePrevFrameInSec Also known as deltatime - time in seconds that has passed since
-     * the last frame was rendered.
+     * @return `false` if an animation job failed.
      */
-    virtual void onBeforeNewFrame(float timeSincePrevFrameInSec) override;
+    virtual bool updateAnimations(float deltaTime);
 
 private:
     /** State of the node. */
@@ -290,23 +309,11 @@ private:
     };
 
     /**
-     * Loads skeleton from file.
-     *
-     * @param pathToSkeleton Path to skeleton .ozz file.
-     * @param vInverseBindPoseMatrices Inverse bind pose matrices.
-     *
-     * @return Loaded skeleton.
-     */
-    static std::unique_ptr<ozz::animation::Skeleton> loadSkeleton(
-        const std::filesystem::path& pathToSkeleton, std::vector<glm::mat4x4>& vInverseBindPoseMatrices);
-
-    /**
-     * Loads animation and adds it to @ref loadedAnimations.
+     * Gets the animation from the animation manager and creates a sampler for it in @ref loadedAnimations.
      *
      * @param sRelativePathToAnimation Path to .ozz animation file relative to the `res` directory.
-     * @param pSkeleton                Skeleton that will be used with the animation.
      */
-    void loadAnimation(const std::string& sRelativePathToAnimation, ozz::animation::Skeleton* pSkeleton);
+    void loadAnimation(const std::string& sRelativePathToAnimation);
 
     /**
      * Looks if the animation is loaded in @ref loadedAnimations and returns it, otherwise
@@ -327,19 +334,31 @@ private:
     /** Unloads everything that was loaded in @ref loadAnimationContextData (if it was loaded). */
     void unloadAnimationContextData();
 
-    /** Converts @ref vResultingLocalTransforms to @ref vSkinningMatrices. */
+    /**
+     * Converts local bone transforms to @ref vBoneMatrices and @ref pSkinningMatrices.
+     *
+     * @param vLocalTransforms Local bone transforms (relative to parent bone).
+     *
+     * @return `false` if the conversion job failed.
+     */
+    bool convertLocalTransformsToSkinning(ozz::span<const ozz::math::SoaTransform> vLocalTransforms);
+
+    /** Converts @ref vResultingLocalTransforms to skinning matrices, shows an error if failed. */
     void convertResultingLocalTransformsToSkinning();
 
     /** State of the node. */
     AnimationState animState;
 
-    /** `nullptr` if the skeleton is not loaded. */
-    std::unique_ptr<ozz::animation::Skeleton> pSkeleton;
+    /**
+     * Skeleton and its inverse bind pose matrices (shared with other nodes that use the same skeleton),
+     * `nullptr` if the skeleton is not loaded.
+     */
+    std::shared_ptr<const SkeletonAsset> pSkeleton;
 
     /**
      * Pairs of
      * - key: path to .ozz anim file relative to `res` directory
-     * - value: deserialized and loaded animations ready to be played.
+     * - value: playback state of loaded animations ready to be played.
      */
     std::unordered_map<std::string, std::unique_ptr<AnimationSampler>> loadedAnimations;
 
@@ -352,21 +371,24 @@ private:
     /** Result of sampling/blending playing animations. 1 soa transform can store multiple (4) bones. */
     ozz::vector<ozz::math::SoaTransform> vResultingLocalTransforms;
 
+    /** Layers of playing animations, reused between frames to blend animations. */
+    ozz::vector<ozz::animation::BlendingJob::Layer> vBlendLayers;
+
     /** Matrices that transform bone from local space to model space. In ozz-animation system. */
     ozz::vector<ozz::math::Float4x4> vBoneMatrices;
 
-    /** Matrix per bone in @ref vBoneMatrices to create @ref vSkinningMatrices. */
-    std::vector<glm::mat4x4> vInverseBindPoseMatrices;
-
     /**
-     * Matrices used for skinning.
+     * Matrices used for skinning, located in the skinning buffer of the animation manager
+     * (`nullptr` if not spawned).
      *
-     * @warning Using `std::array` because skeletal mesh node saves a pointer to this array
-     * and does not expect the data to be moved.
+     * @warning Skeletal mesh node saves a pointer to this array and does not expect the data to be moved.
      *
-     * Actual (used) size of this array is size of @ref vInverseBindPoseMatrices.
+     * Actual (used) size of this array is the number of bones in the skeleton.
      */
-    std::array<glm::mat4x4, iMaxBoneCountAllowed> vSkinningMatrices;
+    std::array<glm::mat4x4, iMaxBoneCountAllowed>* pSkinningMatrices = nullptr;
+
+    /** Index of this node in the array of spawned skeletons of the animation manager. */
+    size_t iSpawnedSkeletonIndex = 0;
 
     /** Path to the `skeleton.ozz` file relative to the `res` directory. */
     std::string sPathToSkeletonRelativeRes;
@@ -102,6 +102,15 @@ public:
      */
     void setWorldScale(const glm::vec3& scale);
 
+    /**
+     * Same as calling @ref setWorldLocation and @ref setWorldRotation but recalculates the world matrix
+     * (and notifies child nodes) only once.
+     *
+     * @param location Location that the node should take in the world.
+     * @param rotation Rotation that the node should take in the world.
+     */
+    void setWorldLocationRotation(const glm::vec3& location, const glm::vec3& rotation);
+
     /**
      * Returns node's relative location (see @ref setRelativeLocation).
      *
@@ -358,13 +358,19 @@ private:
     /**
      * Called after @ref onBeforePhysicsUpdate (after user logic) to calculate updated body position.
      *
+     * @remark Only updates the Jolt character (not the node) so it can be called from a worker thread, use
+     * @ref applyCharacterPosition on the main thread after that.
+     *
      * @param physicsSystem Physics system.
-     * @param tempAllocator Temp allocator.
+     * @param tempAllocator Temp allocator (only used by this thread).
      * @param deltaTime Time (in seconds) that has passed since the last physics update.
      */
     void updateCharacterPosition(
         JPH::PhysicsSystem& physicsSystem, JPH::TempAllocator& tempAllocator, float deltaTime);
 
+    /** Called after @ref updateCharacterPosition to move the node to the updated body position. */
+    void applyCharacterPosition();
+
     /** Called by physics manager after the physics update is finished to process @ref mtxContactsToProcess.
      */
     void processContactEvents();
@@ -387,7 +393,7 @@ private:
     /** Maximum height of the stairs to automatically step up on. */
     float maxStepHeight = 0.4f;
 
-    /** `true` if inside of @ref updateCharacterPosition. */
+    /** `true` if inside of @ref applyCharacterPosition. */
     bool bIsApplyingUpdateResults = false;
 
 #if defined(DEBUG)
@@ -193,6 +193,9 @@ private:
     /** Not `nullptr` when spawned. */
     JPH::Body* pBody = nullptr;
 
+    /** Body transforms of the last 2 physics ticks. */
+    PhysicsBodyInterpolationState physicsInterpolationState;
+
     /** `true` if we are in the @ref setPhysicsSimulationResults. */
     bool bIsApplyingSimulationResults = false;
 
@@ -12,6 +12,41 @@ namespace JPH {
 
 class CollisionShape;
 
+/**
+ * Transform of a physics body before and after the last physics tick, used to render the body in-between
+ * fixed physics ticks.
+ */
+struct PhysicsBodyInterpolationState {
+    /**
+     * Makes both states equal to the specified transform (for example after the body was teleported).
+     *
+     * @param worldLocation World location of the body.
+     * @param worldRotation World rotation of the body in degrees.
+     */
+    void reset(const glm::vec3& worldLocation, const glm::vec3& worldRotation) {
+        previousLocation = worldLocation;
+        currentLocation = worldLocation;
+        previousRotation = glm::quat(glm::radians(worldRotation));
+        currentRotation = previousRotation;
+        bIsSettled = true;
+    }
+
+    /** World location of the body before the last physics tick. */
+    glm::vec3 previousLocation = glm::vec3(0.0f);
+
+    /** World location of the body after the last physics tick. */
+    glm::vec3 currentLocation = glm::vec3(0.0f);
+
+    /** World rotation of the body before the last physics tick. */
+    glm::quat previousRotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+
+    /** World rotation of the body after the last physics tick. */
+    glm::quat currentRotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+
+    /** `true` if the body is not moving and the node already has its final transform. */
+    bool bIsSettled = true;
+};
+
 /**
  * Simple simulated body that is moved by forces and is affected by the gravity. For example it may be used
  * to simulate an object that the player throws with some initial impulse (such as a grenade).
@@ -247,6 +282,9 @@ private:
     /** Not `nullptr` when spawned. */
     JPH::Body* pBody = nullptr;
 
+    /** Body transforms of the last 2 physics ticks. */
+    PhysicsBodyInterpolationState physicsInterpolationState;
+
     /** Uniform density of the interior of the convex object (kg / m^3). */
     float density = 1000.0f;
 
@@ -8,6 +8,42 @@
 // Custom.
 #include "misc/Error.h"
 
+/** Groups optional settings for importing GLTF/GLB files as node trees. */
+struct GltfImportOptions {
+    /**
+     * Number of simplified geometry versions (LODs) to generate for each non-skeletal mesh
+     * (0 to disable LOD generation). Clamped to `MAX_MESH_LOD_COUNT - 1`.
+     */
+    size_t iLodCount = 0;
+
+    /** Target triangle count of the next LOD relative to the triangle count of the previous LOD. */
+    float lodTriangleRatio = 0.5f;
+
+    /**
+     * Maximum allowed simplification error of a LOD relative to the size of the mesh
+     * (0.05 means 5% of the mesh size).
+     */
+    float lodMaxError = 0.05f;
+
+    /**
+     * Maximum error (in meters) of a joint position that is allowed when removing redundant animation keys
+     * (0 to keep all keys).
+     */
+    float animationOptimizationTolerance = 0.001f;
+
+    /**
+     * Distance (in meters) from a joint at which the animation optimization error is measured
+     * (approximates the size of the skinned mesh around the joint).
+     */
+    float animationOptimizationDistance = 0.1f;
+
+    /**
+     * Number of threads that convert meshes and write files in parallel, 0 to use a thread per hardware
+     * thread (results don't depend on this value).
+     */
+    unsigned int iWorkerThreadCount = 0;
+};
+
 /**
  * Provides static functions for importing files in special formats (such as GLTF/GLB) as meshes,
  * textures, etc. into engine formats (such as nodes).
@@ -28,6 +64,7 @@ public:
      * (allowed characters A-z and numbers 0-9, maximum length is 10 characters), for example: `mesh`.
      * @param onProgress                  Callback that will be called to report some text description of
      * the current import stage.
+     * @param options                     Additional import settings.
      *
      * @return Error if something went wrong.
      */
@@ -35,7 +72,8 @@ public:
         const std::filesystem::path& pathToFile,
         const std::string& sPathToOutputDirRelativeRes,
         const std::string& sOutputDirectoryName,
-        const std::function<void(std::string_view)>& onProgress);
+        const std::function<void(std::string_view)>& onProgress,
+        const GltfImportOptions& options = {});
 
     /**
      * Imports a file in a special format (such as GTLF/GLB) and converts information
@@ -58,6 +58,12 @@ struct SerializableObjectInformation {
 
     /** Map of object attributes (custom information) that will be also serialized/deserialized. */
     std::unordered_map<std::string, std::string> customAttributes;
+
+    /**
+     * `true` to not write geometry of @ref pObject to the geometry files (for example because the files
+     * were already written using Serializable::serializeGeometry).
+     */
+    bool bSkipGeometry = false;
 };
 
 /** Information about an object that was deserialized. */
@@ -219,6 +225,24 @@ public:
         const std::vector<SerializableObjectInformation>& vObjects,
         bool bEnableBackup);
 
+    /**
+     * Writes reflected geometry variables (mesh and skeletal mesh geometry) of the object to binary
+     * files in the geometry directory (see @ref getNodeTreeGeometryDirSuffix) next to the specified file.
+     *
+     * @remark Called by @ref serializeMultiple, can be used separately to write geometry of multiple
+     * objects in parallel (see SerializableObjectInformation::bSkipGeometry).
+     *
+     * @param pathToFile      Path to the TOML file that stores (or will store) the object.
+     * @param sEntityId       Unique ID of the object in the file.
+     * @param pOriginalObject Optional. Original object to only write changed geometry.
+     *
+     * @return Error if something went wrong.
+     */
+    [[nodiscard]] std::optional<Error> serializeGeometry(
+        const std::filesystem::path& pathToFile,
+        const std::string& sEntityId,
+        Serializable* pOriginalObject = nullptr);
+
     /**
      * If this object was deserialized from a file that is located in the `res` directory
      * of this project returns file path.
@@ -316,6 +340,7 @@ private:
      * function to process reflected field (sub entity).
      * @param customAttributes   Optional. Custom pairs of values that will be saved as this object's
      * additional information and could be later retrieved in @ref deserialize.
+     * @param bSkipGeometry      Optional. `true` to not write geometry files (see @ref serializeGeometry).
      *
      * @return Error if something went wrong, otherwise name of the TOML section that was used to store this
      * entity.
@@ -325,7 +350,8 @@ private:
         toml::value& tomlData,
         Serializable* pOriginalObject = nullptr,
         std::string sEntityId = "",
-        const std::unordered_map<std::string, std::string>& customAttributes = {});
+        const std::unordered_map<std::string, std::string>& customAttributes = {},
+        bool bSkipGeometry = false);
 
     /**
      * If this object was deserialized from a file that is located in the `res` directory
@@ -1082,7 +1108,10 @@ inline std::variant<std::unique_ptr<T>, Error> Serializable::deserializeFromSect
                        (sEntityId + "." + sVariableName + "." + std::string(sBinaryFileExtension));
             };
 
-            size_t iNotFoundMeshGeometryCount = 0;
+            // Some geometry variables are optional (for example SkeletalMeshNode has empty mesh node
+            // geometry and meshes may have no LODs) so only warn if no geometry file was found at all.
+            std::vector<std::string> vNotFoundGeometryFiles;
+            bool bFoundGeometryFile = false;
 
             // Mesh geometry.
             if (!typeInfo.reflectedVariables.meshNodeGeometries.empty()) {
@@ -1090,13 +1119,10 @@ inline std::variant<std::unique_ptr<T>, Error> Serializable::deserializeFromSect
                      typeInfo.reflectedVariables.meshNodeGeometries) {
                     const auto pathToMeshGeometry = getPathToGeometryFile(sVariableName);
                     if (!std::filesystem::exists(pathToMeshGeometry)) {
-                        if (!bUsedOriginalObject) {
-                            // There may be node geometry file in case this is a SkeletalMeshNode which has
-                            // skeletal mesh node geometry but empty mesh node geometry.
-                            iNotFoundMeshGeometryCount += 1; // make sure there will be a skeletal geometry
-                        }
+                        vNotFoundGeometryFiles.push_back(pathToMeshGeometry.filename().string());
                         continue;
                     }
+                    bFoundGeometryFile = true;
 
                     auto meshGeometry = MeshNodeGeometry::deserialize(pathToMeshGeometry);
                     variableInfo.setter(pDeserializedObject.get(), meshGeometry);
@@ -1109,33 +1135,26 @@ inline std::variant<std::unique_ptr<T>, Error> Serializable::deserializeFromSect
                      typeInfo.reflectedVariables.skeletalMeshNodeGeometries) {
                     const auto pathToMeshGeometry = getPathToGeometryFile(sVariableName);
                     if (!std::filesystem::exists(pathToMeshGeometry)) {
-                        if (!bUsedOriginalObject) {
-                            Log::warn(std::format(
-                                "unable to find geometry file for variable \"{}\" for file \"{}\" (expected "
-                                "file \"{}\")",
-                                sVariableName,
-                                pathToFile.filename().string(),
-                                pathToMeshGeometry.filename().string()));
-                        }
+                        vNotFoundGeometryFiles.push_back(pathToMeshGeometry.filename().string());
                         continue;
                     }
-
-                    if (iNotFoundMeshGeometryCount > 0) {
-                        iNotFoundMeshGeometryCount -= 1;
-                    }
+                    bFoundGeometryFile = true;
 
                     auto meshGeometry = SkeletalMeshNodeGeometry::deserialize(pathToMeshGeometry);
                     variableInfo.setter(pDeserializedObject.get(), meshGeometry);
                 }
             }
 
-            if (iNotFoundMeshGeometryCount > 0) {
+            if (!bFoundGeometryFile && !bUsedOriginalObject && !vNotFoundGeometryFiles.empty()) {
+                std::string sExpectedFiles;
+                for (const auto& sExpectedFile : vNotFoundGeometryFiles) {
+                    sExpectedFiles += std::format("\"{}\" ", sExpectedFile);
+                }
                 Log::warn(std::format(
-                    "unable to find geometry file(s) for {} variable(s) for file \"{}\", make sure these "
-                    "files "
-                    "exist and have correct names",
-                    iNotFoundMeshGeometryCount,
-                    pathToFile.filename().string()));
+                    "unable to find geometry file for file \"{}\", make sure one of the following files "
+                    "exists: {}",
+                    pathToFile.filename().string(),
+                    sExpectedFiles));
             }
         }
     }
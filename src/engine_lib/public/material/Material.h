@@ -8,6 +8,7 @@
 // Custom.
 #include "material/TextureHandle.h"
 #include "math/GLMath.hpp"
+#include "render/ShaderFeature.hpp"
 
 class MeshNode;
 class Renderer;
@@ -60,6 +61,25 @@ public:
      */
     void setEnableTransparency(bool bEnable);
 
+    /**
+     * Enables distance fog (if the world has distance fog enabled) on this material.
+     *
+     * @remark Disabling distance fog on materials that don't need it (for example far away sky objects)
+     * selects a cheaper shader variant.
+     *
+     * @param bEnable New state.
+     */
+    void setEnableDistanceFog(bool bEnable);
+
+    /**
+     * Enables receiving shadows from light sources on this material.
+     *
+     * @remark Disabling shadows on materials that don't need them selects a cheaper shader variant.
+     *
+     * @param bEnable New state.
+     */
+    void setEnableShadows(bool bEnable);
+
     /**
      * Sets value in range [0.0; 1.0] where 1.0 means opaque and 0.0 transparent.
      *
@@ -146,6 +166,28 @@ public:
      */
     bool isTransparencyEnabled() const { return bIsTransparencyEnabled; }
 
+    /**
+     * Determines if distance fog is applied to this material.
+     *
+     * @return State.
+     */
+    bool isDistanceFogEnabled() const { return bIsDistanceFogEnabled; }
+
+    /**
+     * Determines if this material receives shadows.
+     *
+     * @return State.
+     */
+    bool isShadowsEnabled() const { return bIsShadowsEnabled; }
+
+    /**
+     * Returns shader features (compile-time shader variant) that this material needs according
+     * to its current state, can be used to prewarm shader programs (see ShaderManager).
+     *
+     * @return Features.
+     */
+    ShaderFeature getShaderFeatures() const;
+
     /**
      * Returns GLSL shader that the material uses instead of the default one.
      *
@@ -173,6 +215,8 @@ public:
      * @warning Do not delete (free) returned pointer. Note that returned pointer will become invalid when the
      * spawned node (that uses this material) is despawned.
      *
+     * @remark Returned program might still be compiling, see `ShaderProgram::isReady`.
+     *
      * @return `nullptr` if this material is not used on a spawned node (shader program is not requested yet).
      */
     ShaderProgram* getShaderProgram() const { return pShaderProgram.get(); }
@@ -243,4 +287,10 @@ private:
 
     /** Determines if @ref diffuseColor alpha (W component) is ignored or not. */
     bool bIsTransparencyEnabled = false;
+
+    /** Determines if distance fog is applied. */
+    bool bIsDistanceFogEnabled = true;
+
+    /** Determines if shadows are received. */
+    bool bIsShadowsEnabled = true;
 };
@@ -0,0 +1,146 @@
+#pragma once
+
+// Standard.
+#include <cstdint>
+#include <vector>
+#include <variant>
+#include <optional>
+#include <filesystem>
+
+// Custom.
+#include "misc/Error.h"
+
+/** Block compressed formats that textures can be compressed to. */
+enum class CompressedTextureFormat : uint8_t {
+    ETC2_RGB8,     //< 8 bytes per 4x4 block, no alpha.
+    ETC2_RGBA8_EAC //< 16 bytes per 4x4 block (8 for alpha and 8 for color).
+};
+
+/** Texture data compressed to a format that can be directly uploaded to the GPU. */
+struct CompressedTexture {
+    /** Format of all mips. */
+    CompressedTextureFormat format = CompressedTextureFormat::ETC2_RGB8;
+
+    /** Width (in pixels) of the first mip. */
+    unsigned int iWidth = 0;
+
+    /** Height (in pixels) of the first mip. */
+    unsigned int iHeight = 0;
+
+    /** Compressed data of each mip (starting from the largest one). */
+    std::vector<std::vector<uint8_t>> vMips;
+};
+
+/**
+ * Encodes textures to ETC2 (supported by all OpenGL ES 3.0+ devices) on the CPU and caches
+ * the results on the disk (in "cooked" files next to the source textures).
+ */
+class TextureCompressor {
+public:
+    TextureCompressor() = delete;
+
+    /**
+     * Compresses the specified pixels.
+     *
+     * @remark Uses ETC2_RGBA8_EAC only if some pixel is not fully opaque.
+     *
+     * @param pPixels          Pixels in the RGBA8 format (row by row).
+     * @param iWidth           Width of the image in pixels.
+     * @param iHeight          Height of the image in pixels.
+     * @param bGenerateMipmaps `true` to also generate and compress all mips down to 1x1.
+     *
+     * @return Compressed texture.
+     */
+    static CompressedTexture
+    compress(const uint8_t* pPixels, unsigned int iWidth, unsigned int iHeight, bool bGenerateMipmaps);
+
+    /**
+     * Loads the cooked version of the specified texture file if it's up to date (the cooked file
+     * stores hash of the source file and compression settings), otherwise loads the source file,
+     * compresses it and writes a new cooked file next to the source file.
+     *
+     * @remark An invalid or corrupted cooked file is logged as a warning and cooked again.
+     *
+     * @param pathToSourceTexture Path to the PNG/JPG texture file.
+     * @param bGenerateMipmaps    `true` to also generate and compress all mips down to 1x1.
+     * @param iMaxTextureSize     Maximum width and height (in pixels) that the texture is allowed
+     * to have (usually `GL_MAX_TEXTURE_SIZE`).
+     *
+     * @return Error if something went wrong, otherwise compressed texture.
+     */
+    static std::variant<Error, CompressedTexture> loadOrCook(
+        const std::filesystem::path& pathToSourceTexture,
+        bool bGenerateMipmaps,
+        unsigned int iMaxTextureSize);
+
+    /**
+     * Returns path to the file that stores cooked version of the specified texture.
+     *
+     * @param pathToSourceTexture Path to the PNG/JPG texture file.
+     *
+     * @return Path to the cooked file (might not exist).
+     */
+    static std::filesystem::path getPathToCookedTexture(const std::filesystem::path& pathToSourceTexture);
+
+    /**
+     * Returns size (in bytes) of a compressed image.
+     *
+     * @param format  Compressed format.
+     * @param iWidth  Width of the image in pixels.
+     * @param iHeight Height of the image in pixels.
+     *
+     * @return Size in bytes.
+     */
+    static size_t
+    getCompressedSize(CompressedTextureFormat format, unsigned int iWidth, unsigned int iHeight);
+
+private:
+    /**
+     * Compresses a single image (mip).
+     *
+     * @param pPixels    Pixels in the RGBA8 format (row by row).
+     * @param iWidth     Width of the image in pixels.
+     * @param iHeight    Height of the image in pixels.
+     * @param format     Format to use.
+     *
+     * @return Compressed data.
+     */
+    static std::vector<uint8_t> compressImage(
+        const uint8_t* pPixels, unsigned int iWidth, unsigned int iHeight, CompressedTextureFormat format);
+
+    /**
+     * Reads the cooked file.
+     *
+     * @remark Size of the texture and its mips are validated against the size of the file before
+     * anything is allocated.
+     *
+     * @param pathToCookedTexture Path to the cooked file.
+     * @param iSourceHash         Hash of the source file that the cooked file is expected to store.
+     * @param iSettings           Compression settings that the cooked file is expected to store.
+     * @param iMaxTextureSize     Maximum width and height (in pixels) that the texture is allowed to have.
+     *
+     * @return Error if the file is corrupted, empty if the file does not exist or is outdated,
+     * otherwise compressed texture.
+     */
+    static std::variant<Error, std::optional<CompressedTexture>> readCookedTexture(
+        const std::filesystem::path& pathToCookedTexture,
+        uint64_t iSourceHash,
+        uint32_t iSettings,
+        unsigned int iMaxTextureSize);
+
+    /**
+     * Writes the cooked file (through a temporary file that then replaces the cooked file).
+     *
+     * @param pathToCookedTexture Path to the cooked file.
+     * @param texture             Compressed texture.
+     * @param iSourceHash         Hash of the source file.
+     * @param iSettings           Compression settings.
+     *
+     * @return Error if something went wrong.
+     */
+    static std::optional<Error> writeCookedTexture(
+        const std::filesystem::path& pathToCookedTexture,
+        const CompressedTexture& texture,
+        uint64_t iSourceHash,
+        uint32_t iSettings);
+};
@@ -33,6 +33,14 @@ public:
      */
     unsigned int getTextureId() const { return iTextureId; }
 
+    /**
+     * Tells if the texture's data is in the GPU memory. Textures loaded asynchronously use
+     * a placeholder (with the same texture ID) until their data is uploaded and while they are evicted.
+     *
+     * @return `false` while the texture uses a placeholder.
+     */
+    bool isReady() const;
+
 private:
     /**
      * Creates a new texture handle that references a specific texture resource.
@@ -8,11 +8,44 @@
 #include <memory>
 #include <variant>
 #include <optional>
+#include <deque>
+#include <vector>
+#include <source_location>
 
 // Custom.
 #include "misc/Error.h"
 #include "material/TextureHandle.h"
 #include "material/TextureUsage.hpp"
+#include "material/TextureCompressor.h"
+
+class Renderer;
+
+/** Statistics of asynchronous texture loading. */
+struct TextureStreamingStats {
+    /** Number of textures that were requested asynchronously but are not decoded yet. */
+    size_t iDecodingTextureCount = 0;
+
+    /** Size (in bytes) of decoded textures that wait to be uploaded to the GPU. */
+    size_t iPendingUploadBytes = 0;
+
+    /** Size (in bytes) of textures uploaded to the GPU during the last frame. */
+    size_t iUploadedBytesLastFrame = 0;
+
+    /** Total size (in bytes) of loaded textures in the GPU memory (placeholders are not counted). */
+    size_t iResidentBytes = 0;
+
+    /** Memory budget (in bytes) for asynchronously loaded textures, 0 if not limited. */
+    size_t iMemoryBudgetBytes = 0;
+
+    /** Number of textures that currently have their top mips dropped. */
+    size_t iReducedTextureCount = 0;
+
+    /** Number of textures that are currently evicted (replaced with a placeholder). */
+    size_t iEvictedTextureCount = 0;
+
+    /** Total number of evictions since the start. */
+    size_t iTotalEvictionCount = 0;
+};
 
 /** Controls texture loading and owns all textures. */
 class TextureManager {
@@ -24,6 +57,9 @@ class TextureManager {
     // Only renderer is supposed to create this.
     friend class Renderer;
 
+    // Mesh renderer notifies the manager about textures of visible meshes.
+    friend class MeshRenderer;
+
 public:
     TextureManager(const TextureManager&) = delete;
     TextureManager& operator=(const TextureManager&) = delete;
@@ -48,6 +84,17 @@ public:
      */
     void setUsePointFiltering(bool bUsePointFiltering);
 
+    /**
+     * Sets the global setting for compressing diffuse textures to ETC2 (with precomputed mips).
+     * Textures are compressed on the first load and cached in files next to the source textures.
+     *
+     * @remark Only affects textures that are loaded after this call.
+     *
+     * @param bUseTextureCompression `true` (default) to use compressed diffuse textures, `false` to
+     * upload uncompressed pixels.
+     */
+    void setUseTextureCompression(bool bUseTextureCompression);
+
     /**
      * Looks if the specified texture is loaded in the GPU memory or not and if not loads it
      * in the GPU memory and returns a new handle that references this texture (if the texture is
@@ -67,6 +114,56 @@ public:
     std::variant<std::unique_ptr<TextureHandle>, Error>
     getTexture(const std::string& sPathToTextureRelativeRes, TextureUsage usage);
 
+    /**
+     * Same as @ref getTexture but if the texture is not loaded yet it will be loaded asynchronously:
+     * the returned handle references a 1x1 placeholder texture until the texture is decoded
+     * in the thread pool and uploaded to the GPU (texture ID of the handle stays the same).
+     *
+     * @remark Cubemaps are always loaded synchronously.
+     *
+     * @param sPathToTextureRelativeRes Path to the texture file relative to the `res` directory.
+     * @param usage                     Describes how the texture is going to be used.
+     *
+     * @return Error if something went wrong, otherwise texture handle.
+     */
+    std::variant<std::unique_ptr<TextureHandle>, Error>
+    getTextureAsync(const std::string& sPathToTextureRelativeRes, TextureUsage usage);
+
+    /**
+     * Sets the maximum number of bytes of asynchronously loaded textures that can be uploaded to the GPU
+     * per frame (at least 1 texture is uploaded per frame even if it's bigger than the budget).
+     *
+     * @param iBudgetInBytes Budget in bytes.
+     */
+    void setUploadBudgetPerFrame(size_t iBudgetInBytes);
+
+    /**
+     * Sets the maximum size of textures (loaded using @ref getTextureAsync) in the GPU memory.
+     * When the budget is exceeded textures that were not used by visible meshes for the longest
+     * time are evicted (replaced with a placeholder) until they are visible again.
+     *
+     * @param iBudgetInBytes Budget in bytes, 0 to disable the limit.
+     */
+    void setMemoryBudget(size_t iBudgetInBytes);
+
+    /**
+     * Sets the number of frames after which a texture (loaded using @ref getTextureAsync) that is not
+     * used by visible meshes drops its top mips. Full mips are streamed back once a mesh that uses
+     * the texture becomes visible again.
+     *
+     * @remark Only compressed textures (see @ref setUseTextureCompression) drop mips.
+     *
+     * @param iFrameCount Number of frames, 0 to never drop mips.
+     */
+    void setFramesBeforeMipDrop(size_t iFrameCount);
+
+    /**
+     * Returns statistics of asynchronous texture loading.
+     *
+     * @return Stats.
+     */
+    TextureStreamingStats getStreamingStats();
+
     /**
      * Returns the current state of the global setting for texture filtering.
      *
@@ -74,6 +171,13 @@ public:
      */
     bool isUsingPointFiltering() const { return bIsUsingPointFiltering; }
 
+    /**
+     * Returns the current state of the global setting for texture compression.
+     *
+     * @return `true` (default) if diffuse textures are compressed.
+     */
+    bool isUsingTextureCompression() const { return bIsUsingTextureCompression; }
+
 private:
     /** Groups information about a texture. */
     struct TextureResource {
@@ -83,11 +187,198 @@ private:
         /** Describes how much active texture handles there are that point to this texture. */
         size_t iActiveTextureHandleCount = 0;
 
+        /** Unique ID of the load request, used to ignore decoded data of released textures. */
+        size_t iLoadRequestId = 0;
+
+        /** Size (in bytes) of the texture in the GPU memory, 0 while a placeholder is used. */
+        size_t iSizeInBytes = 0;
+
+        /** Number of mip levels allocated in the GPU memory. */
+        size_t iAllocatedMipCount = 1;
+
+        /** Number of mips of the texture at full resolution, 1 while not loaded. */
+        size_t iFullMipCount = 1;
+
+        /** Number of top mips that are skipped in the latest requested (or uploaded) data. */
+        size_t iSkippedMipCount = 0;
+
+        /** Index of the frame (see @ref iResidencyFrameIndex) when a visible mesh used the texture. */
+        size_t iLastVisibleFrameIndex = 0;
+
         /** Initial usage that was specified when the texture was first requested. */
         TextureUsage usage = TextureUsage::DIFFUSE;
+
+        /** `true` if the texture was loaded using @ref getTextureAsync and is managed by the budget. */
+        bool bIsStreamable = false;
+
+        /** `true` if the texture was evicted and now uses a placeholder. */
+        bool bIsEvicted = false;
+
+        /** `true` if the uploaded data is compressed (has precomputed mips). */
+        bool bIsCompressed = false;
+
+        /** ID of the texture in @ref GpuMemoryTracker, empty if not registered yet. */
+        std::optional<size_t> optTrackedResourceId;
     };
 
-    TextureManager() = default;
+    /** Texture data decoded from a file and ready to be uploaded to the GPU. */
+    struct DecodedTexture {
+        /** Path to texture file relative to the `res` directory. */
+        std::string sPathToTextureRelativeRes;
+
+        /** ID of the load request that created this data. */
+        size_t iLoadRequestId = 0;
+
+        /** Usage of the texture. */
+        TextureUsage usage = TextureUsage::DIFFUSE;
+
+        /** Compressed data if compression is used. */
+        std::optional<CompressedTexture> optCompressed;
+
+        /** RGBA8 pixels if compression is not used. */
+        std::vector<uint8_t> vPixels;
+
+        /** Width of the texture in pixels. */
+        unsigned int iWidth = 0;
+
+        /** Height of the texture in pixels. */
+        unsigned int iHeight = 0;
+
+        /** Number of top mips that were skipped (only for compressed textures). */
+        size_t iSkippedMipCount = 0;
+
+        /**
+         * Returns size of the data to upload.
+         *
+         * @return Size in bytes.
+         */
+        size_t getUploadSize() const;
+
+        /**
+         * Returns the number of mip levels that the texture will have in the GPU memory.
+         *
+         * @return Mip count.
+         */
+        size_t getMipCount() const;
+    };
+
+    /**
+     * Creates a new manager.
+     *
+     * @param pRenderer Renderer that owns the manager.
+     */
+    TextureManager(Renderer* pRenderer);
+
+    /**
+     * Loads and decodes (or loads a compressed version of) the specified texture file.
+     *
+     * @remark Thread safe and does not use OpenGL.
+     *
+     * @param pathToTexture          Path to the texture file.
+     * @param usage                  Describes how the texture is going to be used.
+     * @param bUseTextureCompression Whether texture compression is enabled or not.
+     * @param iMaxTextureSize        Maximum width and height (in pixels) that the texture is allowed
+     * to have.
+     * @param iSkippedMipCount       Number of top mips to skip (only for compressed textures, at least
+     * 1 mip is always kept).
+     *
+     * @return Error if something went wrong, otherwise decoded data (path and request ID are not set).
+     */
+    static std::variant<Error, DecodedTexture> decodeTexture(
+        const std::filesystem::path& pathToTexture,
+        TextureUsage usage,
+        bool bUseTextureCompression,
+        unsigned int iMaxTextureSize,
+        size_t iSkippedMipCount = 0);
+
+    /**
+     * Copies decoded data to the specified texture object (through a pixel buffer) and sets
+     * texture parameters.
+     *
+     * @param iTextureId         OpenGL ID of the texture.
+     * @param iAllocatedMipCount Number of mip levels that the texture currently has in the GPU memory
+     * (mips that the new data does not have will be freed).
+     * @param texture            Decoded data.
+     *
+     * @return Size (in bytes) of the texture in the GPU memory.
+     */
+    size_t
+    uploadDecodedTexture(unsigned int iTextureId, size_t iAllocatedMipCount, const DecodedTexture& texture);
+
+    /**
+     * Replaces contents of the specified texture object with a 1x1 white image.
+     *
+     * @param iTextureId         OpenGL ID of the texture.
+     * @param iAllocatedMipCount Number of mip levels that the texture currently has in the GPU memory
+     * (all mips except for the first one will be freed).
+     * @param usage              Usage of the texture.
+     */
+    void uploadPlaceholderTexture(unsigned int iTextureId, size_t iAllocatedMipCount, TextureUsage usage);
+
+    /**
+     * Registers the current size of the texture (see @ref TextureResource::iSizeInBytes)
+     * in @ref GpuMemoryTracker, replaces the previous registration if it exists.
+     *
+     * @param resource Texture to register.
+     * @param location Location of the code that created (or resized) the texture.
+     */
+    static void trackTextureSize(
+        TextureResource& resource, const std::source_location& location = std::source_location::current());
+
+    /**
+     * Starts decoding the specified texture in the thread pool, the result will be uploaded
+     * in @ref uploadDecodedTextures (previous requests of this texture will be ignored).
+     *
+     * @remark Expects that @ref mtxLoadedTextures is locked.
+     *
+     * @param sPathToTextureRelativeRes Path to the texture file relative to the `res` directory.
+     * @param resource                  Texture to load.
+     * @param iSkippedMipCount          Number of top mips to skip.
+     */
+    void requestTextureStreaming(
+        const std::string& sPathToTextureRelativeRes, TextureResource& resource, size_t iSkippedMipCount);
+
+    /**
+     * Called by the mesh renderer for each drawn mesh to tell that the specified texture is used
+     * by a visible mesh.
+     *
+     * @remark Must be called only from the render thread.
+     *
+     * @param iTextureId OpenGL ID of the texture (0 is ignored).
+     */
+    void markTextureAsVisible(unsigned int iTextureId) {
+        if (iTextureId == 0) {
+            return;
+        }
+        if (iTextureId >= vVisibleFrameIndexPerTextureId.size()) {
+            vVisibleFrameIndexPerTextureId.resize(static_cast<size_t>(iTextureId) + 1, 0);
+        }
+
+        // Stamp the frame that the next residency update will process (the same texture is usually
+        // marked by many meshes so the stamp is just overwritten).
+        vVisibleFrameIndexPerTextureId[iTextureId] = iResidencyFrameIndex + 1;
+    }
+
+    /**
+     * Called by the renderer every frame (before drawing) to process textures that were marked
+     * as visible during the previous frame: drops top mips of textures that were not visible for a long
+     * time, streams full mips of visible textures back and evicts least recently visible textures
+     * if the memory budget is exceeded.
+     */
+    void updateTextureResidency();
+
+    /**
+     * Sets wrapping and filtering parameters to the currently bound 2D texture.
+     *
+     * @param usage Usage of the texture.
+     */
+    void setTextureParameters(TextureUsage usage) const;
+
+    /**
+     * Called by the renderer every frame to upload decoded textures (requested using @ref getTextureAsync)
+     * to the GPU according to the upload budget.
+     */
+    void uploadDecodedTextures();
 
     /**
      * Called by texture handles in their destructor to notify the manager about a texture
@@ -98,6 +389,15 @@ private:
      */
     void releaseTextureIfNotUsed(const std::string& sPathToTextureRelativeRes);
 
+    /**
+     * Called by texture handles to check if the texture's data was uploaded to the GPU.
+     *
+     * @param sPathToTextureRelativeRes Path to texture relative to the `res` directory.
+     *
+     * @return `false` while the texture uses a placeholder.
+     */
+    bool isTextureReady(const std::string& sPathToTextureRelativeRes);
+
     /**
      * Creates a new texture handle for the specified path by using @ref mtxLoadedTextures.
      *
@@ -127,6 +427,48 @@ private:
      */
     std::pair<std::recursive_mutex, std::unordered_map<std::string, TextureResource>> mtxLoadedTextures;
 
+    /** Decoded textures (requested asynchronously) that wait to be uploaded to the GPU. */
+    std::pair<std::mutex, std::deque<DecodedTexture>> mtxDecodedTextures;
+
+    /** Statistics of asynchronous texture loading. */
+    std::pair<std::mutex, TextureStreamingStats> mtxStreamingStats;
+
+    /**
+     * Index of the frame (see @ref iResidencyFrameIndex) when a texture was last marked as visible
+     * (see @ref markTextureAsVisible), indexed by OpenGL texture IDs (which are small and reused).
+     */
+    std::vector<size_t> vVisibleFrameIndexPerTextureId;
+
+    /** Do not delete (free) this pointer. Renderer that owns this manager. */
+    Renderer* const pRenderer = nullptr;
+
+    /** OpenGL ID of the pixel buffer used to upload textures, 0 if not created yet. */
+    unsigned int iPixelUnpackBufferId = 0;
+
+    /** Value of `GL_MAX_TEXTURE_SIZE`, textures that are larger are not loaded. */
+    unsigned int iMaxTextureSize = 0;
+
+    /** ID of the next load request. */
+    size_t iNextLoadRequestId = 0;
+
+    /** Maximum number of bytes of asynchronously loaded textures to upload per frame. */
+    size_t iUploadBudgetPerFrameInBytes = 4 * 1024 * 1024; // NOLINT
+
+    /** Maximum size of asynchronously loaded textures in the GPU memory, 0 if not limited. */
+    size_t iMemoryBudgetInBytes = 256 * 1024 * 1024; // NOLINT
+
+    /** Number of frames without visible users after which a texture drops its top mips, 0 to disable. */
+    size_t iFramesBeforeMipDrop = 300; // NOLINT
+
+    /** Index of the current frame, incremented in @ref updateTextureResidency. */
+    size_t iResidencyFrameIndex = 0;
+
+    /** Total number of evictions. */
+    size_t iTotalEvictionCount = 0;
+
     /** Global setting for texture filtering, `true` for point filtering, `false` for linear. */
     bool bIsUsingPointFiltering = true;
+
+    /** Global setting for compressing diffuse textures. */
+    bool bIsUsingTextureCompression = true;
 };
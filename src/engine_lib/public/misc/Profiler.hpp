@@ -5,8 +5,10 @@
 #define PROFILE_FUNC ZoneScoped;
 #define PROFILE_SCOPE(name) ZoneScopedN(name);
 #define PROFILE_ADD_SCOPE_TEXT(text, size) ZoneText(text, size)
+#define PROFILE_MESSAGE(text, size) TracyMessage(text, size)
 #else
 #define PROFILE_FUNC
 #define PROFILE_SCOPE(name)
 #define PROFILE_ADD_SCOPE_TEXT(text, size)
+#define PROFILE_MESSAGE(text, size)
 #endif
@@ -24,14 +24,14 @@ class DebugDrawer {
 public:
     /** Data used to draw a mesh. */
     struct Mesh {
-        /** World matrix to transform @ref vTrianglePositions. */
+        /** World matrix to transform @ref vPositions. */
         glm::mat4x4 worldMatrix = glm::identity<glm::mat4x4>();
 
         /** Color of the mesh. */
         glm::vec4 color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
 
-        /** VAO used for drawing the mesh. */
-        std::unique_ptr<VertexArrayObject> pVao;
+        /** Line (if wireframe) or triangle positions, copied to the GPU every frame while drawn. */
+        std::vector<glm::vec3> vPositions;
 
         /** Time after which the mesh should no longer be rendered. */
         float timeLeftSec = 0.0f;
@@ -287,6 +287,9 @@ private:
     /** Quad used for rendering text. */
     std::unique_ptr<ScreenQuadGeometry> pScreenQuadGeometry;
 
+    /** VAO used to draw meshes, positions are taken from the renderer's streaming buffer. */
+    std::unique_ptr<VertexArrayObject> pStreamedMeshVao;
+
     /** Uniform location for @ref pMeshShaderProgram. */
     int iMeshProgramViewProjectionMatrixUniform = 0;
 
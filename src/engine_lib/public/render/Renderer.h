@@ -19,6 +19,7 @@ typedef struct __GLsync* GLsync;
 class Window;
 class FontManager;
 class TextureManager;
+class FrameStreamingBuffer;
 class CameraProperties;
 class ScreenQuadGeometry;
 class Framebuffer;
@@ -203,6 +204,13 @@ public:
      */
     TextureManager& getTextureManager();
 
+    /**
+     * Returns ring buffer used to upload data that changes every frame (particles, debug geometry).
+     *
+     * @return Buffer.
+     */
+    FrameStreamingBuffer& getStreamingBuffer();
+
     /**
      * Returns various statistics about the rendering.
      *
@@ -313,6 +321,9 @@ private:
     /** Texture loading and management. */
     std::unique_ptr<TextureManager> pTextureManager;
 
+    /** Ring buffer for data that is uploaded every frame. */
+    std::unique_ptr<FrameStreamingBuffer> pStreamingBuffer;
+
     /** .ttf loading and rendering. */
     std::unique_ptr<FontManager> pFontManager;
 
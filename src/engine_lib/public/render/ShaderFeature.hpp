@@ -0,0 +1,54 @@
+#pragma once
+
+// Standard.
+#include <cstdint>
+
+/**
+ * Optional features of the default mesh shaders. Each used combination of features is compiled
+ * into a separate shader program (permutation) where disabled features are removed at compile time
+ * (instead of branching on uniforms at runtime).
+ */
+enum class ShaderFeature : uint32_t {
+    NONE = 0,
+    DIFFUSE_TEXTURE = 1 << 0, //< Defines `ENGINE_DIFFUSE_TEXTURE` in fragment shaders.
+    DISTANCE_FOG = 1 << 1,    //< Defines `ENGINE_DISTANCE_FOG` in fragment shaders.
+    SHADOWS = 1 << 2,         //< Defines `ENGINE_SHADOWS` in fragment shaders.
+    OUTLINE = 1 << 3,         //< Defines `ENGINE_OUTLINE` in vertex shaders.
+};
+
+/**
+ * Combines features.
+ *
+ * @param left  Features.
+ * @param right Features.
+ *
+ * @return Combined features.
+ */
+constexpr ShaderFeature operator|(ShaderFeature left, ShaderFeature right) {
+    return static_cast<ShaderFeature>(static_cast<uint32_t>(left) | static_cast<uint32_t>(right));
+}
+
+/**
+ * Returns features that exist in both arguments.
+ *
+ * @param left  Features.
+ * @param right Features.
+ *
+ * @return Common features.
+ */
+constexpr ShaderFeature operator&(ShaderFeature left, ShaderFeature right) {
+    return static_cast<ShaderFeature>(static_cast<uint32_t>(left) & static_cast<uint32_t>(right));
+}
+
+/**
+ * Adds features.
+ *
+ * @param left  Features to modify.
+ * @param right Features to add.
+ *
+ * @return Modified features.
+ */
+constexpr ShaderFeature& operator|=(ShaderFeature& left, ShaderFeature right) {
+    left = left | right;
+    return left;
+}
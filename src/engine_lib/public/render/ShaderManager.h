@@ -6,12 +6,51 @@
 #include <memory>
 #include <mutex>
 #include <vector>
+#include <cstdint>
+#include <filesystem>
+
+// Custom.
+#include "render/ShaderFeature.hpp"
 
 class Renderer;
 class Shader;
 class ShaderProgram;
+class ShaderCompileThread;
+struct CompiledShaderProgram;
+
+/** Describes a shader program variant (permutation) to compile. */
+struct ShaderProgramVariant {
+    /** Path to .glsl vertex shader file relative `res` directory. */
+    std::string sPathToVertexShaderRelativeRes;
+
+    /** Path to .glsl fragment shader file relative `res` directory. */
+    std::string sPathToFragmentShaderRelativeRes;
+
+    /** Features to define as macros in the shaders. */
+    ShaderFeature features = ShaderFeature::NONE;
+};
 
-/** Loads, compiles GLSL code and keeps track of all loaded shaders. */
+/** Statistics of shader programs created by the shader manager. */
+struct ShaderProgramCreationStats {
+    /** Number of programs loaded from the program binary cache. */
+    size_t iProgramsLoadedFromCacheCount = 0;
+
+    /** Number of programs compiled and linked (because they were not found in the cache). */
+    size_t iProgramsCompiledCount = 0;
+
+    /** Total time in milliseconds spent creating programs (loading from the cache or compiling). */
+    float programCreationTimeMs = 0.0f;
+};
+
+/**
+ * Loads, compiles GLSL code and keeps track of all loaded shaders.
+ *
+ * Linked shader programs are cached on the disk (as driver-specific binaries) so that next launches
+ * don't need to compile shaders.
+ *
+ * Shader programs are compiled on a separate thread (that has a shared OpenGL context) if the platform
+ * supports it.
+ */
 class ShaderManager {
     // Only renderer is expected to create objects of this type.
     friend class Renderer;
@@ -23,18 +62,39 @@ class ShaderManager {
 public:
     ~ShaderManager();
 
+    /**
+     * Looks if a shader from the specified path was already requested previously (cached) to return it,
+     * otherwise loads the shader from disk and starts compiling it on the shader compile thread.
+     *
+     * @remark Returned program might not be ready to be used yet, see `ShaderProgram::isReady`.
+     *
+     * @param sPathToVertexShaderRelativeRes   Path to .glsl vertex shader file relative `res` directory.
+     * @param sPathToFragmentShaderRelativeRes Path to .glsl fragment shader file relative `res` directory.
+     * @param features                         Features to define as macros (each combination of features
+     * results in a separate shader program).
+     *
+     * @return Shader program that is compiled or being compiled.
+     */
+    std::shared_ptr<ShaderProgram> getShaderProgramAsync(
+        const std::string& sPathToVertexShaderRelativeRes,
+        const std::string& sPathToFragmentShaderRelativeRes,
+        ShaderFeature features = ShaderFeature::NONE);
+
     /**
      * Looks if a shader from the specified path was already requested previously (cached) to return it,
      * otherwise loads the shader from disk, compiles and returns it.
      *
      * @param sPathToVertexShaderRelativeRes   Path to .glsl vertex shader file relative `res` directory.
      * @param sPathToFragmentShaderRelativeRes Path to .glsl fragment shader file relative `res` directory.
+     * @param features                         Features to define as macros (each combination of features
+     * results in a separate shader program).
      *
      * @return Compiled shader program.
      */
     std::shared_ptr<ShaderProgram> getShaderProgram(
         const std::string& sPathToVertexShaderRelativeRes,
-        const std::string& sPathToFragmentShaderRelativeRes);
+        const std::string& sPathToFragmentShaderRelativeRes,
+        ShaderFeature features = ShaderFeature::NONE);
 
     /**
      * Looks if a shader from the specified path was already requested previously (cached) to return it,
@@ -46,6 +106,20 @@ public:
      */
     std::shared_ptr<ShaderProgram> getShaderProgram(const std::string& sPathToComputeShaderRelativeRes);
 
+    /**
+     * Starts compiling the specified shader program variants (if they are not loaded yet) and keeps them
+     * loaded until @ref releasePrewarmedShaderPrograms is called so that spawning nodes that use these
+     * variants later will not cause hitches.
+     *
+     * @remark Expected to be called on the main thread (for example while showing a loading screen).
+     *
+     * @param vVariants Variants to compile.
+     */
+    void prewarmShaderPrograms(const std::vector<ShaderProgramVariant>& vVariants);
+
+    /** Releases shader programs that were kept loaded by @ref prewarmShaderPrograms. */
+    void releasePrewarmedShaderPrograms();
+
     /**
      * Returns all loaded shader programs.
      *
@@ -58,6 +132,22 @@ public:
         return mtxDatabase;
     }
 
+    /**
+     * Returns statistics of programs created since the manager was created.
+     *
+     * @remark Thread safe.
+     *
+     * @return Statistics.
+     */
+    ShaderProgramCreationStats getProgramCreationStats();
+
+    /**
+     * Returns directory of the program binary cache for the current GL driver.
+     *
+     * @return Empty if the driver does not support program binaries.
+     */
+    const std::filesystem::path& getPathToProgramBinaryCache() const { return pathToProgramBinaryCache; }
+
     /**
      * Returns renderer that created this manager.
      *
@@ -76,23 +166,87 @@ private:
     ShaderManager(Renderer* pRenderer);
 
     /**
-     * Compiles a .glsl shader file.
+     * Loads a .glsl shader file and preprocesses its source code (the shader is compiled
+     * in @ref compileShader only if needed).
      *
      * @param sPathToShaderRelativeRes Path to .glsl file relative `res` directory.
+     * @param features                 Features to define as macros.
+     *
+     * @return Loaded shader.
+     */
+    std::shared_ptr<Shader> loadShader(const std::string& sPathToShaderRelativeRes, ShaderFeature features);
+
+    /**
+     * Compiles the specified shader if it's not compiled yet.
+     *
+     * @param shader Shader to compile.
+     */
+    void compileShader(Shader& shader);
+
+    /**
+     * Loads the specified program from the program binary cache or compiles and links the specified
+     * shaders and stores the result in the cache.
      *
-     * @return Compiled shader.
+     * @param vShaders Shaders to link.
+     *
+     * @return OpenGL ID of the linked program.
      */
-    std::shared_ptr<Shader> compileShader(const std::string& sPathToShaderRelativeRes);
+    unsigned int createProgram(const std::vector<std::shared_ptr<Shader>>& vShaders);
 
     /**
-     * Compiles a shader program from 1 or more shaders.
+     * Looks for the program with the specified hash in the program binary cache and loads it.
+     *
+     * @param iProgramHash Hash of the program.
+     *
+     * @return OpenGL ID of the linked program or 0 if not found in the cache (or the driver rejected
+     * the binary).
+     */
+    unsigned int tryLoadProgramBinary(uint64_t iProgramHash);
+
+    /**
+     * Stores binary of the specified linked program in the program binary cache.
+     *
+     * @param iProgramId   OpenGL ID of the linked program.
+     * @param iProgramHash Hash of the program.
+     */
+    void saveProgramBinary(unsigned int iProgramId, uint64_t iProgramHash);
+
+    /**
+     * Returns path to the file in the program binary cache for the specified program.
+     *
+     * @param iProgramHash Hash of the program.
+     *
+     * @return Path to the file (might not exist).
+     */
+    std::filesystem::path getPathToProgramBinary(uint64_t iProgramHash) const;
+
+    /**
+     * Creates (loads from the cache or compiles) the program and the vertex-only program.
+     *
+     * @remark Called on the shader compile thread (if it exists).
+     *
+     * @param sProgramName   Unique name of the shader program.
+     * @param vLinkedShaders Shaders to link to the program.
+     * @param pVertexShader  Vertex shader to create a vertex-only program or `nullptr`.
+     * @param bCreateFence   `true` to create a fence that is signaled once the programs are created.
+     *
+     * @return Created programs.
+     */
+    CompiledShaderProgram createPrograms(
+        const std::string& sProgramName,
+        const std::vector<std::shared_ptr<Shader>>& vLinkedShaders,
+        const std::shared_ptr<Shader>& pVertexShader,
+        bool bCreateFence);
+
+    /**
+     * Starts compiling a shader program from 1 or more shaders.
      *
      * @param sProgramName   Unique name of the shader program.
      * @param vLinkedShaders Shaders to link to this program.
      * @param pVertexShader  Specify vertex shader program if linked shaders has a vertex shader, otherwise
      * `nullptr`.
      *
-     * @return Compiled shader program.
+     * @return Shader program that is compiled or being compiled on the shader compile thread.
      */
     std::shared_ptr<ShaderProgram> compileShaderProgram(
         const std::string& sProgramName,
@@ -104,17 +258,21 @@ private:
      * otherwise loads the shader from disk, compiles and returns it.
      *
      * @param sPathToShaderRelativeRes Path to .glsl file relative `res` directory.
+     * @param features                 Features to define as macros (only features that affect
+     * the type of the shader are used).
      *
      * @return Loaded and compiled shader.
      */
-    std::shared_ptr<Shader> getShader(const std::string& sPathToShaderRelativeRes);
+    std::shared_ptr<Shader>
+    getShader(const std::string& sPathToShaderRelativeRes, ShaderFeature features = ShaderFeature::NONE);
 
     /**
      * Called from shader's destructor.
      *
      * @param sPathToShaderRelativeRes Path to .glsl file relative `res` directory.
+     * @param features                 Features that the shader was loaded with.
      */
-    void onShaderBeingDestroyed(const std::string& sPathToShaderRelativeRes);
+    void onShaderBeingDestroyed(const std::string& sPathToShaderRelativeRes, ShaderFeature features);
 
     /**
      * Called from shader program's destructor.
@@ -124,7 +282,7 @@ private:
     void onShaderProgramBeingDestroyed(const std::string& sShaderProgramId);
 
     /**
-     * Stores pairs of "path to .glsl file relative `res` directory" - "loaded shader".
+     * Stores pairs of "path to .glsl file relative `res` directory (with features)" - "loaded shader".
      *
      * @remark Storing weak_ptr here is safe because the Shader object will notify the manager in destructor.
      */
@@ -145,9 +303,27 @@ private:
         std::unordered_map<std::string, std::pair<std::weak_ptr<ShaderProgram>, ShaderProgram*>>>
         mtxDatabase;
 
+    /** Shader programs compiled in @ref prewarmShaderPrograms that are kept loaded. */
+    std::vector<std::shared_ptr<ShaderProgram>> vPrewarmedShaderPrograms;
+
+    /** `nullptr` if shared OpenGL contexts are not supported, thread that compiles shader programs. */
+    std::unique_ptr<ShaderCompileThread> pCompileThread;
+
     /** Always valid empty fragment shader used for depth only passes. */
     std::shared_ptr<Shader> pEmptyFragmentShader;
 
+    /**
+     * Directory of the program binary cache for the current GL driver (vendor, renderer and version),
+     * empty if the driver does not support program binaries.
+     */
+    std::filesystem::path pathToProgramBinaryCache;
+
+    /** Hash of the GL vendor, renderer and version strings. */
+    uint64_t iDriverHash = 0;
+
+    /** Statistics of created programs (programs are created on the shader compile thread). */
+    std::pair<std::mutex, ShaderProgramCreationStats> mtxProgramCreationStats;
+
     /** Do not delete/free. Renderer that created this manager. */
     Renderer* const pRenderer = nullptr;
 };
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Number of warnings that tests produced on purpose (for example to check that an invalid cache file
+ * is reported), such warnings don't fail the test run.
+ */
+inline std::atomic<size_t> iExpectedLogWarningCount{0};
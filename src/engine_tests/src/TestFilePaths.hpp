@@ -5,7 +5,7 @@
 
 static constexpr std::string_view sTestDirName = "test";
 
-static constexpr std::array<std::string_view, 13> vUsedTestFileNames = {
+static constexpr std::array<std::string_view, 26> vUsedTestFileNames = {
     "serializable",
     "serializable_derived",
     "node_tree",
@@ -18,4 +18,17 @@ static constexpr std::array<std::string_view, 13> vUsedTestFileNames = {
     "load_node_tree_as_world",
     "layout_ui",
     "external2_node_tree",
-    "custom.frag.glsl"};
+    "custom.frag.glsl",
+    "convex_shape",
+    "mesh_collision",
+    "height_field",
+    "skeleton",
+    "texture_compressor",
+    "gpu_memory_texture",
+    "gltf_import",
+    "two_bone_skeleton",
+    "bone_chain_skeleton",
+    "gltf_skin",
+    "texture_budget",
+    "texture_mip_streaming",
+    "texture_async"};
@@ -0,0 +1,693 @@
+// Standard.
+#include <array>
+#include <cmath>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <optional>
+#include <memory>
+#include <chrono>
+#include <format>
+#include <algorithm>
+
+// Custom.
+#include "game/GameInstance.h"
+#include "game/GameManager.h"
+#include "game/World.h"
+#include "game/Window.h"
+#include "game/node/SkeletonNode.h"
+#include "game/animation/AnimationManager.h"
+#include "io/Serializable.h"
+#include "io/Log.h"
+#include "math/GLMath.hpp"
+#include "misc/ProjectPaths.h"
+#include "TestFilePaths.hpp"
+
+// External.
+#include "catch2/catch_test_macros.hpp"
+#include "ozz/animation/offline/raw_skeleton.h"
+#include "ozz/animation/offline/raw_animation.h"
+#include "ozz/animation/offline/skeleton_builder.h"
+#include "ozz/animation/offline/animation_builder.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+
+namespace {
+    /** Translation (along the X axis) of the bone in the animation that moves the bone. */
+    constexpr float movedBoneOffset = 10.0f;
+
+    /** Paths (relative to the `res` directory) to files created by @ref createTestAnimationFiles. */
+    struct TestAnimationPaths {
+        /** Path to the skeleton. */
+        std::string sSkeleton;
+
+        /** Path to the animation that keeps the bone at the origin. */
+        std::string sStillAnimation;
+
+        /** Path to the animation that moves the bone by @ref movedBoneOffset. */
+        std::string sMovedAnimation;
+    };
+
+    /**
+     * Serializes an ozz object to a file.
+     *
+     * @param object     Object to serialize.
+     * @param pathToFile Path to the resulting file.
+     */
+    template <typename T> void writeOzzFile(const T& object, const std::filesystem::path& pathToFile) {
+        ozz::io::File file(pathToFile.string().c_str(), "wb");
+        REQUIRE(file.opened());
+
+        ozz::io::OArchive archive(&file);
+        archive << object;
+    }
+
+    /**
+     * Creates (if not created yet) a skeleton with a single bone and 2 animations for it, since the
+     * animations only have a single key the pose does not depend on the time.
+     *
+     * @return Paths to created files.
+     */
+    TestAnimationPaths createTestAnimationFiles() {
+        const auto sRelativePathToDir = std::string(sTestDirName) + "/" + std::string(vUsedTestFileNames[16]);
+        const TestAnimationPaths paths{
+            .sSkeleton = sRelativePathToDir + "/skeleton.ozz",
+            .sStillAnimation = sRelativePathToDir + "/still.ozz",
+            .sMovedAnimation = sRelativePathToDir + "/moved.ozz"};
+
+        const auto pathToDir =
+            ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sRelativePathToDir;
+        if (std::filesystem::exists(pathToDir)) {
+            return paths;
+        }
+        std::filesystem::create_directories(pathToDir);
+
+        // Skeleton.
+        ozz::animation::offline::RawSkeleton rawSkeleton;
+        rawSkeleton.roots.resize(1);
+        rawSkeleton.roots[0].name = "root";
+        rawSkeleton.roots[0].transform = ozz::math::Transform::identity();
+
+        ozz::animation::offline::SkeletonBuilder skeletonBuilder;
+        const auto pSkeleton = skeletonBuilder(rawSkeleton);
+        REQUIRE(pSkeleton != nullptr);
+        writeOzzFile(*pSkeleton, pathToDir / "skeleton.ozz");
+
+        // Inverse bind pose (the bone is at the origin).
+        {
+            const auto sFileName =
+                "skeletonInverseBindPose." + std::string(Serializable::getBinaryFileExtension());
+            std::ofstream file(pathToDir / sFileName, std::ios::binary);
+            REQUIRE(file.is_open());
+
+            const unsigned int iMatrixCount = 1;
+            const auto identityMatrix = glm::identity<glm::mat4x4>();
+            file.write(reinterpret_cast<const char*>(&iMatrixCount), sizeof(iMatrixCount));
+            file.write(
+                reinterpret_cast<const char*>(glm::value_ptr(identityMatrix)), sizeof(identityMatrix));
+        }
+
+        // Animations.
+        const auto writeAnimation = [&](float offset, const std::string& sFileName) {
+            ozz::animation::offline::RawAnimation rawAnimation;
+            rawAnimation.duration = 1.0f;
+            rawAnimation.tracks.resize(1);
+
+            auto& track = rawAnimation.tracks[0];
+            track.translations.push_back({0.0f, ozz::math::Float3(offset, 0.0f, 0.0f)});
+            track.rotations.push_back({0.0f, ozz::math::Quaternion::identity()});
+            track.scales.push_back({0.0f, ozz::math::Float3::one()});
+            REQUIRE(rawAnimation.Validate());
+
+            ozz::animation::offline::AnimationBuilder animationBuilder;
+            const auto pAnimation = animationBuilder(rawAnimation);
+            REQUIRE(pAnimation != nullptr);
+            writeOzzFile(*pAnimation, pathToDir / sFileName);
+        };
+        writeAnimation(0.0f, "still.ozz");
+        writeAnimation(movedBoneOffset, "moved.ozz");
+
+        return paths;
+    }
+
+    /** Local transform of a bone in an animation key. */
+    struct BonePose {
+        /** Translation relative to the parent bone. */
+        glm::vec3 translation = glm::vec3(0.0f);
+
+        /** Rotation relative to the parent bone. */
+        glm::quat rotation = glm::identity<glm::quat>();
+
+        /** Scale relative to the parent bone. */
+        glm::vec3 scale = glm::vec3(1.0f);
+    };
+
+    /**
+     * Creates a skeleton where each bone is a child of the previous bone.
+     *
+     * @param sDirName                 Name of the directory (in the test directory) to create files in,
+     * existing directory is removed.
+     * @param vInverseBindPoseMatrices Inverse bind pose matrix per bone (defines bone count).
+     *
+     * @return Path to the directory with `skeleton.ozz` relative to the `res` directory.
+     */
+    std::string createBoneChainSkeletonFiles(
+        std::string_view sDirName, const std::vector<glm::mat4x4>& vInverseBindPoseMatrices) {
+        const auto sRelativePathToDir = std::string(sTestDirName) + "/" + std::string(sDirName);
+        const auto pathToDir =
+            ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sRelativePathToDir;
+        if (std::filesystem::exists(pathToDir)) {
+            std::filesystem::remove_all(pathToDir);
+        }
+        std::filesystem::create_directories(pathToDir);
+
+        // Skeleton.
+        ozz::animation::offline::RawSkeleton rawSkeleton;
+        rawSkeleton.roots.resize(1);
+        auto pJoint = &rawSkeleton.roots[0];
+        for (size_t i = 0; i < vInverseBindPoseMatrices.size(); i++) {
+            pJoint->name = std::format("bone{}", i);
+            pJoint->transform = ozz::math::Transform::identity();
+            if (i + 1 < vInverseBindPoseMatrices.size()) {
+                pJoint->children.resize(1);
+                pJoint = &pJoint->children[0];
+            }
+        }
+
+        ozz::animation::offline::SkeletonBuilder skeletonBuilder;
+        const auto pSkeleton = skeletonBuilder(rawSkeleton);
+        REQUIRE(pSkeleton != nullptr);
+        writeOzzFile(*pSkeleton, pathToDir / "skeleton.ozz");
+
+        // Inverse bind pose.
+        const auto sFileName =
+            "skeletonInverseBindPose." + std::string(Serializable::getBinaryFileExtension());
+        std::ofstream file(pathToDir / sFileName, std::ios::binary);
+        REQUIRE(file.is_open());
+
+        const auto iMatrixCount = static_cast<unsigned int>(vInverseBindPoseMatrices.size());
+        file.write(reinterpret_cast<const char*>(&iMatrixCount), sizeof(iMatrixCount));
+        for (const auto& matrix : vInverseBindPoseMatrices) {
+            file.write(reinterpret_cast<const char*>(glm::value_ptr(matrix)), sizeof(matrix));
+        }
+
+        return sRelativePathToDir;
+    }
+
+    /**
+     * Creates an animation for a skeleton from @ref createBoneChainSkeletonFiles.
+     *
+     * @param sRelativePathToDir Directory returned by @ref createBoneChainSkeletonFiles.
+     * @param sFileName          Name of the animation file to create.
+     * @param vKeysPerBone       Keys (evenly distributed in time) of each bone.
+     *
+     * @return Path to the animation relative to the `res` directory.
+     */
+    std::string writeBoneChainAnimation(
+        const std::string& sRelativePathToDir,
+        const std::string& sFileName,
+        const std::vector<std::vector<BonePose>>& vKeysPerBone) {
+        ozz::animation::offline::RawAnimation rawAnimation;
+        rawAnimation.duration = 1.0f;
+        rawAnimation.tracks.resize(vKeysPerBone.size());
+
+        for (size_t iBone = 0; iBone < vKeysPerBone.size(); iBone++) {
+            auto& track = rawAnimation.tracks[iBone];
+            const auto& vKeys = vKeysPerBone[iBone];
+            for (size_t iKey = 0; iKey < vKeys.size(); iKey++) {
+                const auto time = vKeys.size() == 1
+                                      ? 0.0f
+                                      : static_cast<float>(iKey) / static_cast<float>(vKeys.size() - 1);
+                const auto& pose = vKeys[iKey];
+                track.translations.push_back(
+                    {time, ozz::math::Float3(pose.translation.x, pose.translation.y, pose.translation.z)});
+                track.rotations.push_back(
+                    {time,
+                     ozz::math::Quaternion(
+                         pose.rotation.x, pose.rotation.y, pose.rotation.z, pose.rotation.w)});
+                track.scales.push_back({time, ozz::math::Float3(pose.scale.x, pose.scale.y, pose.scale.z)});
+            }
+        }
+        REQUIRE(rawAnimation.Validate());
+
+        ozz::animation::offline::AnimationBuilder animationBuilder;
+        const auto pAnimation = animationBuilder(rawAnimation);
+        REQUIRE(pAnimation != nullptr);
+        writeOzzFile(
+            *pAnimation,
+            ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sRelativePathToDir / sFileName);
+
+        return sRelativePathToDir + "/" + sFileName;
+    }
+
+    /**
+     * Spawns a skeleton node that blends test animations.
+     *
+     * @param pParent     Spawned node to attach the new node to.
+     * @param paths       Test files.
+     * @param blendFactor Blend factor between the still and the moved animations.
+     * @param pNewNode    Node to spawn.
+     *
+     * @return Spawned node.
+     */
+    template <typename T>
+    T* spawnBlendingSkeleton(
+        Node* pParent, const TestAnimationPaths& paths, float blendFactor, std::unique_ptr<T> pNewNode) {
+        pNewNode->setPathToSkeletonRelativeRes(paths.sSkeleton);
+
+        const auto pNode = pParent->addChildNode(std::move(pNewNode));
+        pNode->playBlendedAnimations({paths.sStillAnimation, paths.sMovedAnimation}, blendFactor);
+
+        return pNode;
+    }
+}
+
+TEST_CASE("skeleton nodes with the same files share loaded skeleton and animations") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            createWorld([this](Node* pRootNode) {
+                const auto paths = createTestAnimationFiles();
+                auto& animationManager =
+                    pRootNode->getWorldWhileSpawned()->getGameManager().getAnimationManager();
+                REQUIRE(animationManager.getLoadedSkeletonCount() == 0);
+                REQUIRE(animationManager.getLoadedAnimationCount() == 0);
+
+                const auto pFirstNode =
+                    spawnBlendingSkeleton(pRootNode, paths, 0.5f, std::make_unique<SkeletonNode>());
+                const auto pSecondNode =
+                    spawnBlendingSkeleton(pRootNode, paths, 0.5f, std::make_unique<SkeletonNode>());
+
+                // Each file is loaded once.
+                REQUIRE(animationManager.getLoadedSkeletonCount() == 1);
+                REQUIRE(animationManager.getLoadedAnimationCount() == 2);
+
+                // Both nodes reference the same instances (plus the pointers below).
+                auto pSkeleton = animationManager.getSkeleton(paths.sSkeleton);
+                auto pAnimation = animationManager.getAnimation(paths.sMovedAnimation, pSkeleton->skeleton);
+                REQUIRE(pSkeleton.use_count() == 3);
+                REQUIRE(pAnimation.use_count() == 3);
+
+                const std::weak_ptr<const SkeletonAsset> pWeakSkeleton = pSkeleton;
+                const std::weak_ptr<const ozz::animation::Animation> pWeakAnimation = pAnimation;
+                pSkeleton = nullptr;
+                pAnimation = nullptr;
+
+                // Assets are released after the last user is despawned.
+                pFirstNode->unsafeDetachFromParentAndDespawn();
+                REQUIRE(!pWeakSkeleton.expired());
+                REQUIRE(!pWeakAnimation.expired());
+                REQUIRE(animationManager.getLoadedSkeletonCount() == 1);
+
+                pSecondNode->unsafeDetachFromParentAndDespawn();
+                REQUIRE(pWeakSkeleton.expired());
+                REQUIRE(pWeakAnimation.expired());
+                REQUIRE(animationManager.getLoadedSkeletonCount() == 0);
+                REQUIRE(animationManager.getLoadedAnimationCount() == 0);
+
+                // Files are loaded again for new users.
+                const auto pThirdNode =
+                    spawnBlendingSkeleton(pRootNode, paths, 1.0f, std::make_unique<SkeletonNode>());
+                REQUIRE(animationManager.getLoadedSkeletonCount() == 1);
+                REQUIRE(animationManager.getLoadedAnimationCount() == 2);
+
+                pSkeleton = animationManager.getSkeleton(paths.sSkeleton);
+                REQUIRE(pSkeleton.use_count() == 2);
+                REQUIRE(pSkeleton->skeleton.num_joints() == 1);
+                pSkeleton = nullptr;
+
+                pThirdNode->unsafeDetachFromParentAndDespawn();
+
+                getWindow()->close();
+            });
+        }
+        virtual ~TestGameInstance() override {}
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("skeletons updated in parallel have the same pose as a skeleton updated alone") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            paths = createTestAnimationFiles();
+
+            // First update a single skeleton.
+            createWorld([this](Node* pRootNode) {
+                vSkeletons.push_back(spawnBlendingSkeleton(
+                    pRootNode, paths, vBlendFactors[1], std::make_unique<SkeletonNode>()));
+            });
+        }
+        virtual ~TestGameInstance() override {}
+
+        virtual void onBeforeNewFrame(float timeSincePrevCallInSec) override {
+            if (vSkeletons.empty()) {
+                return;
+            }
+
+            // Wait for a few updates.
+            iFrameCount += 1;
+            if (iFrameCount < 3) {
+                return;
+            }
+            iFrameCount = 0;
+
+            if (!optSingleSkeletonMatrix.has_value()) {
+                optSingleSkeletonMatrix = vSkeletons[0]->getSkinningMatrices()[0];
+                REQUIRE(
+                    std::abs((*optSingleSkeletonMatrix)[3].x - vBlendFactors[1] * movedBoneOffset) < 0.0001f);
+
+                // Now update a lot of skeletons (more than a single job) with different poses.
+                vSkeletons.clear();
+                createWorld([this](Node* pRootNode) {
+                    for (size_t i = 0; i < iSkeletonCount; i++) {
+                        vSkeletons.push_back(spawnBlendingSkeleton(
+                            pRootNode,
+                            paths,
+                            vBlendFactors[i % vBlendFactors.size()],
+                            std::make_unique<SkeletonNode>()));
+                    }
+                });
+                return;
+            }
+
+            REQUIRE(vSkeletons.size() == iSkeletonCount);
+            for (size_t i = 0; i < vSkeletons.size(); i++) {
+                const auto blendFactor = vBlendFactors[i % vBlendFactors.size()];
+                const auto& matrix = vSkeletons[i]->getSkinningMatrices()[0];
+                REQUIRE(std::abs(matrix[3].x - blendFactor * movedBoneOffset) < 0.0001f);
+
+                if (blendFactor == vBlendFactors[1]) {
+                    REQUIRE(matrix == *optSingleSkeletonMatrix);
+                }
+            }
+
+            getWindow()->close();
+        }
+
+    private:
+        const size_t iSkeletonCount = 200;
+        const std::array<float, 5> vBlendFactors = {0.0f, 0.25f, 0.5f, 0.75f, 1.0f};
+
+        TestAnimationPaths paths;
+        std::vector<SkeletonNode*> vSkeletons;
+        std::optional<glm::mat4x4> optSingleSkeletonMatrix;
+        size_t iFrameCount = 0;
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("skeleton that failed to update its animations in a worker thread is reported") {
+    class FailingSkeletonNode : public SkeletonNode {
+    public:
+        FailingSkeletonNode() : SkeletonNode("failing skeleton") {}
+        virtual ~FailingSkeletonNode() override = default;
+
+        bool bFailUpdate = false;
+
+    protected:
+        virtual bool updateAnimations(float deltaTime) override {
+            if (bFailUpdate) {
+                return false;
+            }
+
+            return SkeletonNode::updateAnimations(deltaTime);
+        }
+    };
+
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            createWorld([this](Node* pRootNode) {
+                const auto paths = createTestAnimationFiles();
+                pWorld = pRootNode->getWorldWhileSpawned();
+
+                // Put the failing node in the middle so that it's probably updated by a worker thread.
+                for (size_t i = 0; i < iSkeletonCount; i++) {
+                    if (i == iSkeletonCount / 2) {
+                        pFailingNode = spawnBlendingSkeleton(
+                            pRootNode, paths, 0.5f, std::make_unique<FailingSkeletonNode>());
+                        continue;
+                    }
+                    spawnBlendingSkeleton(pRootNode, paths, 0.5f, std::make_unique<SkeletonNode>());
+                }
+            });
+        }
+        virtual ~TestGameInstance() override {}
+
+        virtual void onBeforeNewFrame(float timeSincePrevCallInSec) override {
+            if (pFailingNode == nullptr) {
+                return;
+            }
+
+            auto& animationManager = pWorld->getGameManager().getAnimationManager();
+
+            // Update on this thread (the world also updates skeletons every frame).
+            pFailingNode->bFailUpdate = true;
+            auto optionalError = animationManager.updateSkeletons(pWorld, timeSincePrevCallInSec);
+            pFailingNode->bFailUpdate = false;
+
+            REQUIRE(optionalError.has_value());
+            REQUIRE(
+                optionalError->getInitialMessage().find(pFailingNode->getNodeName()) != std::string::npos);
+
+            // Next update succeeds.
+            optionalError = animationManager.updateSkeletons(pWorld, timeSincePrevCallInSec);
+            REQUIRE(!optionalError.has_value());
+
+            getWindow()->close();
+        }
+
+    private:
+        const size_t iSkeletonCount = 64;
+
+        World* pWorld = nullptr;
+        FailingSkeletonNode* pFailingNode = nullptr;
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("skinning matrices with non-identity inverse bind pose match the scalar glm result") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            createWorld([this](Node* pRootNode) {
+                // Parent and child bones with translation, rotation and scale.
+                vPoses = {
+                    BonePose{
+                        .translation = glm::vec3(1.0f, 2.0f, 3.0f),
+                        .rotation = glm::angleAxis(glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f)),
+                        .scale = glm::vec3(2.0f)},
+                    BonePose{
+                        .translation = glm::vec3(0.0f, 5.0f, 0.0f),
+                        .rotation = glm::angleAxis(glm::radians(30.0f), glm::vec3(1.0f, 0.0f, 0.0f)),
+                        .scale = glm::vec3(1.0f)}};
+
+                // Bind pose is different from the animated pose.
+                vInverseBindPoseMatrices = {
+                    glm::inverse(glm::translate(glm::vec3(0.0f, 1.0f, 0.0f))),
+                    glm::inverse(
+                        glm::translate(glm::vec3(0.0f, 4.0f, 1.0f)) *
+                        glm::mat4_cast(glm::angleAxis(glm::radians(45.0f), glm::vec3(0.0f, 0.0f, 1.0f))))};
+
+                const auto sRelativePathToDir =
+                    createBoneChainSkeletonFiles(vUsedTestFileNames[20], vInverseBindPoseMatrices);
+                const auto sPathToAnimation =
+                    writeBoneChainAnimation(sRelativePathToDir, "pose.ozz", {{vPoses[0]}, {vPoses[1]}});
+
+                auto pNewNode = std::make_unique<SkeletonNode>();
+                pNewNode->setPathToSkeletonRelativeRes(sRelativePathToDir + "/skeleton.ozz");
+                pSkeleton = pRootNode->addChildNode(std::move(pNewNode));
+                pSkeleton->playAnimation(sPathToAnimation, true);
+            });
+        }
+        virtual ~TestGameInstance() override {}
+
+        virtual void onBeforeNewFrame(float timeSincePrevCallInSec) override {
+            if (pSkeleton == nullptr) {
+                return;
+            }
+
+            // Wait for a few updates.
+            iFrameCount += 1;
+            if (iFrameCount < 3) {
+                return;
+            }
+
+            // Calculate the result that the scalar glm loop used to produce.
+            std::array<glm::mat4x4, 2> vBoneMatrices;
+            glm::mat4x4 parentMatrix = glm::identity<glm::mat4x4>();
+            for (size_t i = 0; i < vBoneMatrices.size(); i++) {
+                vBoneMatrices[i] = parentMatrix * glm::translate(vPoses[i].translation) *
+                                   glm::mat4_cast(vPoses[i].rotation) * glm::scale(vPoses[i].scale);
+                parentMatrix = vBoneMatrices[i];
+            }
+
+            const auto& vSkinningMatrices = pSkeleton->getSkinningMatrices();
+            for (size_t i = 0; i < vBoneMatrices.size(); i++) {
+                const auto expected = vInverseBindPoseMatrices[i] * vBoneMatrices[i];
+                for (int iColumn = 0; iColumn < 4; iColumn++) {
+                    for (int iRow = 0; iRow < 4; iRow++) {
+                        INFO(std::format("bone {}, column {}, row {}", i, iColumn, iRow));
+                        REQUIRE(
+                            std::abs(vSkinningMatrices[i][iColumn][iRow] - expected[iColumn][iRow]) <
+                            0.0001f);
+                    }
+                }
+            }
+
+            getWindow()->close();
+        }
+
+    private:
+        std::vector<BonePose> vPoses;
+        std::vector<glm::mat4x4> vInverseBindPoseMatrices;
+        SkeletonNode* pSkeleton = nullptr;
+        size_t iFrameCount = 0;
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("measure animation update time of 200 skeletons with 32 bones") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            createWorld([this](Node* pRootNode) {
+                pWorld = pRootNode->getWorldWhileSpawned();
+
+                // Each bone is offset from its parent (like a spine) and bends in the animations.
+                std::vector<glm::mat4x4> vInverseBindPoseMatrices(iBoneCount);
+                for (size_t i = 0; i < iBoneCount; i++) {
+                    vInverseBindPoseMatrices[i] =
+                        glm::inverse(glm::translate(glm::vec3(0.0f, static_cast<float>(i), 0.0f)));
+                }
+                const auto sRelativePathToDir =
+                    createBoneChainSkeletonFiles(vUsedTestFileNames[21], vInverseBindPoseMatrices);
+
+                const auto writeBendAnimation = [&](const std::string& sFileName, const glm::vec3& axis) {
+                    std::vector<std::vector<BonePose>> vKeysPerBone(iBoneCount);
+                    for (size_t i = 0; i < iBoneCount; i++) {
+                        const auto translation = glm::vec3(0.0f, i == 0 ? 0.0f : 1.0f, 0.0f);
+                        for (float angle : {0.0f, 10.0f, -10.0f, 0.0f}) {
+                            vKeysPerBone[i].push_back(BonePose{
+                                .translation = translation,
+                                .rotation = glm::angleAxis(glm::radians(angle), axis)});
+                        }
+                    }
+                    return writeBoneChainAnimation(sRelativePathToDir, sFileName, vKeysPerBone);
+                };
+                const std::vector<std::string> vAnimations = {
+                    writeBendAnimation("bend_x.ozz", glm::vec3(1.0f, 0.0f, 0.0f)),
+                    writeBendAnimation("bend_z.ozz", glm::vec3(0.0f, 0.0f, 1.0f))};
+
+                for (size_t i = 0; i < iSkeletonCount; i++) {
+                    auto pNewNode = std::make_unique<SkeletonNode>();
+                    pNewNode->setPathToSkeletonRelativeRes(sRelativePathToDir + "/skeleton.ozz");
+                    const auto pNode = pRootNode->addChildNode(std::move(pNewNode));
+                    pNode->playBlendedAnimations(
+                        vAnimations, static_cast<float>(i) / static_cast<float>(iSkeletonCount));
+                }
+                bSpawned = true;
+            });
+        }
+        virtual ~TestGameInstance() override {}
+
+        virtual void onBeforeNewFrame(float timeSincePrevCallInSec) override {
+            if (!bSpawned) {
+                return;
+            }
+
+            // Update on this thread (the world also updates skeletons every frame).
+            auto& animationManager = pWorld->getGameManager().getAnimationManager();
+            float totalTimeMs = 0.0f;
+            float maxTimeMs = 0.0f;
+            for (size_t i = 0; i < iUpdateCount; i++) {
+                const auto startTime = std::chrono::steady_clock::now();
+                auto optionalError = animationManager.updateSkeletons(pWorld, 1.0f / 60.0f);
+                const auto timeMs =
+                    std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime)
+                        .count();
+                REQUIRE(!optionalError.has_value());
+
+                totalTimeMs += timeMs;
+                maxTimeMs = std::max(maxTimeMs, timeMs);
+            }
+
+            Log::info(std::format(
+                "animation update of {} skeletons with {} bones: average {:.3F} ms, max {:.3F} ms "
+                "({} updates)",
+                iSkeletonCount,
+                iBoneCount,
+                totalTimeMs / static_cast<float>(iUpdateCount),
+                maxTimeMs,
+                iUpdateCount));
+
+            getWindow()->close();
+        }
+
+    private:
+        const size_t iSkeletonCount = 200;
+        const size_t iBoneCount = 32;
+        const size_t iUpdateCount = 100;
+
+        World* pWorld = nullptr;
+        bool bSpawned = false;
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
@@ -0,0 +1,201 @@
+// Standard.
+#include <random>
+#include <algorithm>
+#include <array>
+#include <tuple>
+
+// Custom.
+#include "game/geometry/MeshGeometryOptimizer.h"
+
+// External.
+#include "catch2/catch_test_macros.hpp"
+
+namespace {
+    /**
+     * Creates a flat grid of quads with shuffled triangles (to simulate a badly ordered index buffer).
+     *
+     * @param iQuadsPerSide Number of quads on one side of the grid.
+     *
+     * @return Geometry.
+     */
+    MeshNodeGeometry createShuffledGrid(size_t iQuadsPerSide) {
+        MeshNodeGeometry geometry;
+
+        const size_t iVertsPerSide = iQuadsPerSide + 1;
+        for (size_t y = 0; y < iVertsPerSide; y++) {
+            for (size_t x = 0; x < iVertsPerSide; x++) {
+                MeshNodeVertex vertex;
+                vertex.position = glm::vec3(static_cast<float>(x), static_cast<float>(y), 0.0f);
+                vertex.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+                vertex.uv = glm::vec2(
+                    static_cast<float>(x) / static_cast<float>(iQuadsPerSide),
+                    static_cast<float>(y) / static_cast<float>(iQuadsPerSide));
+                geometry.getVertices().push_back(vertex);
+            }
+        }
+
+        std::vector<std::array<MeshIndexType, 3>> vTriangles;
+        for (size_t y = 0; y < iQuadsPerSide; y++) {
+            for (size_t x = 0; x < iQuadsPerSide; x++) {
+                const auto i0 = static_cast<MeshIndexType>(y * iVertsPerSide + x);
+                const auto i1 = static_cast<MeshIndexType>(i0 + 1);
+                const auto i2 = static_cast<MeshIndexType>(i0 + iVertsPerSide);
+                const auto i3 = static_cast<MeshIndexType>(i2 + 1);
+                vTriangles.push_back({i0, i1, i2});
+                vTriangles.push_back({i2, i1, i3});
+            }
+        }
+
+        std::mt19937 generator(42); // NOLINT: fixed seed for reproducible tests
+        std::shuffle(vTriangles.begin(), vTriangles.end(), generator);
+
+        for (const auto& triangle : vTriangles) {
+            geometry.getIndices().insert(geometry.getIndices().end(), triangle.begin(), triangle.end());
+        }
+
+        return geometry;
+    }
+
+    /**
+     * Converts triangles to a sorted list of triangle positions (with preserved winding order)
+     * to compare geometry that uses different vertex/triangle order.
+     *
+     * @param geometry Geometry.
+     *
+     * @return Sorted triangles.
+     */
+    std::vector<std::array<float, 9>> getSortedTriangles(const MeshNodeGeometry& geometry) {
+        std::vector<std::array<float, 9>> vTriangles;
+
+        const auto& vIndices = geometry.getIndices();
+        const auto& vVertices = geometry.getVertices();
+        for (size_t i = 0; i < vIndices.size(); i += 3) {
+            std::array<glm::vec3, 3> vCorners = {
+                vVertices[vIndices[i]].position,
+                vVertices[vIndices[i + 1]].position,
+                vVertices[vIndices[i + 2]].position};
+
+            // Rotate corners (keeps winding) so that the smallest corner is first.
+            const auto isLess = [](const glm::vec3& a, const glm::vec3& b) {
+                return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+            };
+            const auto minIt = std::min_element(vCorners.begin(), vCorners.end(), isLess);
+            std::rotate(vCorners.begin(), minIt, vCorners.end());
+
+            std::array<float, 9> vTriangle{};
+            for (size_t iCorner = 0; iCorner < 3; iCorner++) {
+                vTriangle[iCorner * 3] = vCorners[iCorner].x;
+                vTriangle[iCorner * 3 + 1] = vCorners[iCorner].y;
+                vTriangle[iCorner * 3 + 2] = vCorners[iCorner].z;
+            }
+            vTriangles.push_back(vTriangle);
+        }
+
+        std::sort(vTriangles.begin(), vTriangles.end());
+        return vTriangles;
+    }
+}
+
+TEST_CASE("mesh optimization improves ACMR and keeps the same triangles") {
+    auto geometry = createShuffledGrid(32);
+    const auto vTrianglesBefore = getSortedTriangles(geometry);
+
+    auto result = MeshGeometryOptimizer::optimize(geometry);
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        INFO(std::get<Error>(result).getFullErrorMessage());
+        REQUIRE(false);
+    }
+    const auto stats = std::get<MeshOptimizationStats>(result);
+
+    REQUIRE(stats.acmrBefore > 2.0f);
+    REQUIRE(stats.acmrAfter < 1.0f);
+    REQUIRE(stats.acmrAfter == MeshGeometryOptimizer::calculateAcmr(geometry.getIndices()));
+    REQUIRE(stats.iVertexCountAfter == stats.iVertexCountBefore);
+    REQUIRE(stats.iTriangleCountAfter == stats.iTriangleCountBefore);
+
+    REQUIRE(getSortedTriangles(geometry) == vTrianglesBefore);
+}
+
+TEST_CASE("mesh optimization removes duplicate vertices and degenerate triangles") {
+    // Create geometry where each triangle has its own vertices.
+    const auto indexedGeometry = createShuffledGrid(8);
+    MeshNodeGeometry geometry;
+    for (const auto iIndex : indexedGeometry.getIndices()) {
+        geometry.getIndices().push_back(static_cast<MeshIndexType>(geometry.getVertices().size()));
+        geometry.getVertices().push_back(indexedGeometry.getVertices()[iIndex]);
+    }
+
+    // Add a degenerate triangle.
+    geometry.getIndices().push_back(0);
+    geometry.getIndices().push_back(0);
+    geometry.getIndices().push_back(1);
+
+    auto result = MeshGeometryOptimizer::optimize(geometry);
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        INFO(std::get<Error>(result).getFullErrorMessage());
+        REQUIRE(false);
+    }
+    const auto stats = std::get<MeshOptimizationStats>(result);
+
+    REQUIRE(stats.iVertexCountBefore == indexedGeometry.getIndices().size());
+    REQUIRE(stats.iVertexCountAfter == indexedGeometry.getVertices().size());
+    REQUIRE(stats.iTriangleCountAfter == indexedGeometry.getIndices().size() / 3);
+    REQUIRE(getSortedTriangles(geometry) == getSortedTriangles(indexedGeometry));
+}
+
+TEST_CASE("mesh optimization places vertices in the order of first use") {
+    auto geometry = createShuffledGrid(16);
+
+    auto result = MeshGeometryOptimizer::optimize(geometry);
+    REQUIRE(!std::holds_alternative<Error>(result));
+
+    size_t iNextNewVertex = 0;
+    for (const auto iIndex : geometry.getIndices()) {
+        REQUIRE(iIndex <= iNextNewVertex);
+        if (iIndex == iNextNewVertex) {
+            iNextNewVertex += 1;
+        }
+    }
+    REQUIRE(iNextNewVertex == geometry.getVertices().size());
+}
+
+TEST_CASE("skeletal mesh optimization keeps bone data of vertices") {
+    const auto grid = createShuffledGrid(8);
+
+    SkeletalMeshNodeGeometry geometry;
+    geometry.getIndices() = grid.getIndices();
+    for (const auto& vertex : grid.getVertices()) {
+        SkeletalMeshNodeVertex skeletalVertex;
+        skeletalVertex.position = vertex.position;
+        skeletalVertex.normal = vertex.normal;
+        skeletalVertex.uv = vertex.uv;
+        skeletalVertex.vBoneIndices = {
+            static_cast<SkeletalMeshNodeVertex::BoneIndexType>(vertex.position.x), 0, 0, 0};
+        skeletalVertex.vBoneWeights = {vertex.position.y, 0.0f, 0.0f, 0.0f};
+        geometry.getVertices().push_back(skeletalVertex);
+    }
+
+    auto result = MeshGeometryOptimizer::optimize(geometry);
+    REQUIRE(!std::holds_alternative<Error>(result));
+
+    REQUIRE(geometry.getVertices().size() == grid.getVertices().size());
+    for (const auto& vertex : geometry.getVertices()) {
+        REQUIRE(
+            vertex.vBoneIndices[0] ==
+            static_cast<SkeletalMeshNodeVertex::BoneIndexType>(vertex.position.x));
+        REQUIRE(vertex.vBoneWeights[0] == vertex.position.y);
+    }
+}
+
+TEST_CASE("mesh optimization fails on invalid geometry") {
+    MeshNodeGeometry geometry;
+    geometry.getVertices().resize(3);
+    geometry.getIndices() = {0, 1, 3};
+
+    auto result = MeshGeometryOptimizer::optimize(geometry);
+    REQUIRE(std::holds_alternative<Error>(result));
+
+    // Make sure geometry was not modified.
+    REQUIRE(geometry.getVertices().size() == 3);
+    REQUIRE(geometry.getIndices() == std::vector<MeshIndexType>{0, 1, 3});
+}
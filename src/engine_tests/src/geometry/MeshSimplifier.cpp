@@ -0,0 +1,112 @@
+// Standard.
+#include <cmath>
+
+// Custom.
+#include "game/geometry/MeshSimplifier.h"
+
+// External.
+#include "catch2/catch_test_macros.hpp"
+
+namespace {
+    /**
+     * Creates a grid of quads (on XY plane) with an optional bump in the middle.
+     *
+     * @param iQuadsPerSide Number of quads on one side of the grid.
+     * @param bumpHeight    Height of the bump (Z).
+     *
+     * @return Geometry.
+     */
+    MeshNodeGeometry createGrid(size_t iQuadsPerSide, float bumpHeight) {
+        MeshNodeGeometry geometry;
+
+        const size_t iVertsPerSide = iQuadsPerSide + 1;
+        const float center = static_cast<float>(iQuadsPerSide) * 0.5f;
+        for (size_t y = 0; y < iVertsPerSide; y++) {
+            for (size_t x = 0; x < iVertsPerSide; x++) {
+                const float offsetX = static_cast<float>(x) - center;
+                const float offsetY = static_cast<float>(y) - center;
+                const float distance = std::sqrt(offsetX * offsetX + offsetY * offsetY);
+
+                MeshNodeVertex vertex;
+                vertex.position = glm::vec3(
+                    static_cast<float>(x),
+                    static_cast<float>(y),
+                    bumpHeight * std::exp(-distance * distance / (center * center)));
+                vertex.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+                vertex.uv = glm::vec2(
+                    static_cast<float>(x) / static_cast<float>(iQuadsPerSide),
+                    static_cast<float>(y) / static_cast<float>(iQuadsPerSide));
+                geometry.getVertices().push_back(vertex);
+            }
+        }
+
+        for (size_t y = 0; y < iQuadsPerSide; y++) {
+            for (size_t x = 0; x < iQuadsPerSide; x++) {
+                const auto i0 = static_cast<MeshIndexType>(y * iVertsPerSide + x);
+                const auto i1 = static_cast<MeshIndexType>(i0 + 1);
+                const auto i2 = static_cast<MeshIndexType>(i0 + iVertsPerSide);
+                const auto i3 = static_cast<MeshIndexType>(i2 + 1);
+                geometry.getIndices().insert(geometry.getIndices().end(), {i0, i1, i2, i2, i1, i3});
+            }
+        }
+
+        return geometry;
+    }
+}
+
+TEST_CASE("mesh simplification of a flat grid keeps its borders") {
+    const auto grid = createGrid(16, 0.0f);
+
+    const auto simplified = MeshSimplifier::simplify(grid, 0, 0.01f);
+
+    // A flat rectangle can be represented using just 2 triangles.
+    REQUIRE(simplified.getIndices().size() / 3 < grid.getIndices().size() / 3 / 10);
+    REQUIRE(simplified.getVertices().size() < grid.getVertices().size());
+
+    // Make sure corners are kept.
+    const auto hasVertexAt = [&](float x, float y) {
+        for (const auto& vertex : simplified.getVertices()) {
+            if (vertex.position.x == x && vertex.position.y == y) {
+                return true;
+            }
+        }
+        return false;
+    };
+    REQUIRE(hasVertexAt(0.0f, 0.0f));
+    REQUIRE(hasVertexAt(16.0f, 0.0f));
+    REQUIRE(hasVertexAt(0.0f, 16.0f));
+    REQUIRE(hasVertexAt(16.0f, 16.0f));
+
+    // Make sure all vertices are still on the borders' lines or inside.
+    for (const auto& vertex : simplified.getVertices()) {
+        REQUIRE(vertex.position.x >= 0.0f);
+        REQUIRE(vertex.position.x <= 16.0f);
+        REQUIRE(vertex.position.y >= 0.0f);
+        REQUIRE(vertex.position.y <= 16.0f);
+    }
+
+    // Make sure all indices are valid.
+    for (const auto iIndex : simplified.getIndices()) {
+        REQUIRE(iIndex < simplified.getVertices().size());
+    }
+}
+
+TEST_CASE("mesh simplification respects target triangle count and max error") {
+    const auto grid = createGrid(16, 4.0f);
+    const size_t iTriangleCount = grid.getIndices().size() / 3;
+
+    // Target triangle count.
+    const auto halved = MeshSimplifier::simplify(grid, iTriangleCount / 2, 1.0f);
+    REQUIRE(halved.getIndices().size() / 3 <= iTriangleCount / 2);
+    REQUIRE(halved.getIndices().size() / 3 > iTriangleCount / 4);
+
+    // Zero error should not remove triangles from a curved surface.
+    const auto unchanged = MeshSimplifier::simplify(grid, 0, 0.0f);
+    REQUIRE(unchanged.getIndices().size() / 3 == iTriangleCount);
+
+    // Larger error allows more collapses.
+    const auto coarse = MeshSimplifier::simplify(grid, 0, 0.01f);
+    const auto coarser = MeshSimplifier::simplify(grid, 0, 0.05f);
+    REQUIRE(coarse.getIndices().size() / 3 < iTriangleCount);
+    REQUIRE(coarser.getIndices().size() / 3 < coarse.getIndices().size() / 3);
+}
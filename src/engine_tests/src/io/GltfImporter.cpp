@@ -0,0 +1,356 @@
+// Standard.
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <iterator>
+#include <array>
+#include <cmath>
+#include <format>
+
+// Custom.
+#include "io/GltfImporter.h"
+#include "misc/ProjectPaths.h"
+#include "io/Serializable.h"
+#include "math/GLMath.hpp"
+#include "TestFilePaths.hpp"
+
+// External.
+#include "catch2/catch_test_macros.hpp"
+#include "ozz/animation/runtime/skeleton.h"
+#include "ozz/animation/runtime/animation.h"
+#include "ozz/base/io/archive.h"
+#include "ozz/base/io/stream.h"
+
+namespace {
+    /** Collects binary data of a GLTF file and describes it as accessors. */
+    class TestGltfBuffer {
+    public:
+        /**
+         * Appends data to the buffer and adds an accessor (with its own buffer view) for it.
+         *
+         * @param pData          Data to append.
+         * @param iSizeInBytes   Size of the data.
+         * @param iComponentType GLTF component type (for example 5126 for float).
+         * @param iCount         Number of elements.
+         * @param sType          GLTF element type (for example "VEC3").
+         * @param sExtraJson     Additional accessor properties (starting with a comma) or empty.
+         *
+         * @return Index of the new accessor.
+         */
+        size_t addAccessor(
+            const void* pData,
+            size_t iSizeInBytes,
+            int iComponentType,
+            size_t iCount,
+            const std::string& sType,
+            const std::string& sExtraJson = "") {
+            // Keep 4 byte alignment.
+            vData.resize((vData.size() + 3) / 4 * 4, 0);
+            const auto iByteOffset = vData.size();
+            const auto pBytes = static_cast<const char*>(pData);
+            vData.insert(vData.end(), pBytes, pBytes + iSizeInBytes);
+
+            const auto iIndex = iAccessorCount++;
+            if (iIndex != 0) {
+                sBufferViews += ",";
+                sAccessors += ",";
+            }
+            sBufferViews += "{\"buffer\":0,\"byteOffset\":" + std::to_string(iByteOffset) +
+                            ",\"byteLength\":" + std::to_string(iSizeInBytes) + "}";
+            sAccessors += "{\"bufferView\":" + std::to_string(iIndex) +
+                          ",\"componentType\":" + std::to_string(iComponentType) +
+                          ",\"count\":" + std::to_string(iCount) + ",\"type\":\"" + sType + "\"" +
+                          sExtraJson + "}";
+            return iIndex;
+        }
+
+        /**
+         * Writes the .gltf file and the buffer (next to it).
+         *
+         * @param pathToGltfFile Path to the .gltf file to create.
+         * @param sJson          GLTF properties (scenes, nodes, meshes, etc.) except for accessors, buffer
+         * views and buffers (without the outer braces).
+         */
+        void write(const std::filesystem::path& pathToGltfFile, const std::string& sJson) const {
+            const auto pathToBuffer =
+                pathToGltfFile.parent_path() / (pathToGltfFile.stem().string() + ".bin");
+            std::ofstream bufferFile(pathToBuffer, std::ios::binary);
+            bufferFile.write(vData.data(), static_cast<std::streamsize>(vData.size()));
+            bufferFile.close();
+
+            std::ofstream gltfFile(pathToGltfFile);
+            gltfFile << "{\"asset\":{\"version\":\"2.0\"}," << sJson << ",\"accessors\":[" << sAccessors
+                     << "],\"bufferViews\":[" << sBufferViews << "],\"buffers\":[{\"uri\":\""
+                     << pathToBuffer.filename().string() << "\",\"byteLength\":" << vData.size() << "}]}";
+        }
+
+    private:
+        /** Binary data. */
+        std::vector<char> vData;
+
+        /** JSON array items of buffer views. */
+        std::string sBufferViews;
+
+        /** JSON array items of accessors. */
+        std::string sAccessors;
+
+        /** Number of added accessors. */
+        size_t iAccessorCount = 0;
+    };
+
+    /** GLTF component type of floats. */
+    constexpr int iGltfFloat = 5126;
+
+    /** GLTF component type of unsigned shorts. */
+    constexpr int iGltfUnsignedShort = 5123;
+
+    /** GLTF component type of unsigned bytes. */
+    constexpr int iGltfUnsignedByte = 5121;
+
+    /**
+     * Writes a GLTF file (and its binary buffer) with a node hierarchy where each node has its own mesh.
+     *
+     * @param pathToGltfFile Path to the .gltf file to create (the buffer is written next to it).
+     * @param iMeshCount     Number of nodes (and meshes) to create, the first half of the nodes are
+     * children of the first node and the second half are children of the node in the middle.
+     */
+    void writeTestGltfFile(const std::filesystem::path& pathToGltfFile, size_t iMeshCount) {
+        TestGltfBuffer buffer;
+        std::string sMeshes;
+        std::string sNodes;
+
+        const size_t iHalf = iMeshCount / 2;
+        for (size_t iMesh = 0; iMesh < iMeshCount; iMesh++) {
+            // Each mesh is a quad, make each quad a bit different.
+            const float size = 1.0F + static_cast<float>(iMesh);
+            const std::array<float, 12> vPositions = {
+                0.0F, 0.0F, 0.0F, size, 0.0F, 0.0F, size, size, 0.0F, 0.0F, size, 0.0F};
+            const std::array<float, 12> vNormals = {
+                0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 1.0F};
+            const std::array<float, 8> vUvs = {0.0F, 1.0F, 1.0F, 1.0F, 1.0F, 0.0F, 0.0F, 0.0F};
+            const std::array<unsigned short, 6> vIndices = {0, 1, 2, 2, 3, 0};
+
+            const auto sSize = std::to_string(size);
+            const auto iPositions = buffer.addAccessor(
+                vPositions.data(),
+                sizeof(vPositions),
+                iGltfFloat,
+                4,
+                "VEC3",
+                ",\"min\":[0,0,0],\"max\":[" + sSize + "," + sSize + ",0]");
+            const auto iNormals =
+                buffer.addAccessor(vNormals.data(), sizeof(vNormals), iGltfFloat, 4, "VEC3");
+            const auto iUvs = buffer.addAccessor(vUvs.data(), sizeof(vUvs), iGltfFloat, 4, "VEC2");
+            const auto iIndices =
+                buffer.addAccessor(vIndices.data(), sizeof(vIndices), iGltfUnsignedShort, 6, "SCALAR");
+
+            if (iMesh != 0) {
+                sMeshes += ",";
+                sNodes += ",";
+            }
+            sMeshes += "{\"primitives\":[{\"attributes\":{\"POSITION\":" + std::to_string(iPositions) +
+                       ",\"NORMAL\":" + std::to_string(iNormals) +
+                       ",\"TEXCOORD_0\":" + std::to_string(iUvs) +
+                       "},\"indices\":" + std::to_string(iIndices) + "}]}";
+
+            sNodes += "{\"name\":\"node" + std::to_string(iMesh) +
+                      "\",\"mesh\":" + std::to_string(iMesh) + ",\"translation\":[" + std::to_string(iMesh) +
+                      ",0,0]";
+            if (iMesh == 0 || iMesh == iHalf) {
+                std::string sChildren;
+                const size_t iLastChild = iMesh == 0 ? iHalf : iMeshCount;
+                for (size_t iChild = iMesh + 1; iChild < iLastChild; iChild++) {
+                    sChildren += (sChildren.empty() ? "" : ",") + std::to_string(iChild);
+                }
+                sNodes += ",\"children\":[" + sChildren + "]";
+            }
+            sNodes += "}";
+        }
+
+        buffer.write(
+            pathToGltfFile,
+            "\"scene\":0,\"scenes\":[{\"nodes\":[0," + std::to_string(iHalf) + "]}],\"nodes\":[" + sNodes +
+                "],\"meshes\":[" + sMeshes + "]");
+    }
+
+    /**
+     * Reads all files in the specified directory (recursively).
+     *
+     * @param pathToDirectory Directory to read.
+     *
+     * @return Paths relative to the directory and file contents.
+     */
+    std::map<std::string, std::vector<char>> readDirectory(const std::filesystem::path& pathToDirectory) {
+        std::map<std::string, std::vector<char>> files;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(pathToDirectory)) {
+            if (!entry.is_regular_file()) {
+                continue;
+            }
+            std::ifstream file(entry.path(), std::ios::binary);
+            files[std::filesystem::relative(entry.path(), pathToDirectory).generic_string()] =
+                std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        return files;
+    }
+}
+
+TEST_CASE("importing GLTF with 1 and multiple worker threads produces the same files") {
+    const auto sPathToTestDirRelativeRes =
+        std::string(sTestDirName) + "/" + std::string(vUsedTestFileNames[19]);
+    const auto pathToTestDir =
+        ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sPathToTestDirRelativeRes;
+    if (std::filesystem::exists(pathToTestDir)) {
+        std::filesystem::remove_all(pathToTestDir);
+    }
+    std::filesystem::create_directories(pathToTestDir);
+
+    const auto pathToGltfFile = pathToTestDir / "model.gltf";
+    constexpr size_t iMeshCount = 12;
+    writeTestGltfFile(pathToGltfFile, iMeshCount);
+
+    // Import using the same output directory name (in different parent directories) so that the results
+    // can be compared.
+    const auto importWithWorkers = [&](const std::string& sParentDirName, unsigned int iWorkerThreadCount) {
+        std::filesystem::create_directory(pathToTestDir / sParentDirName);
+        auto optionalError = GltfImporter::importFileAsNodeTree(
+            pathToGltfFile,
+            sPathToTestDirRelativeRes + "/" + sParentDirName,
+            "model",
+            [](std::string_view) {},
+            GltfImportOptions{.iWorkerThreadCount = iWorkerThreadCount});
+        if (optionalError.has_value()) [[unlikely]] {
+            optionalError->addCurrentLocationToErrorStack();
+            INFO(optionalError->getFullErrorMessage());
+            REQUIRE(false);
+        }
+        return readDirectory(pathToTestDir / sParentDirName / "model");
+    };
+
+    const auto singleWorkerFiles = importWithWorkers("single", 1);
+    const auto multipleWorkersFiles = importWithWorkers("multiple", 8);
+
+    // Make sure geometry was written (1 file per mesh node + node tree file).
+    REQUIRE(singleWorkerFiles.size() >= iMeshCount + 1);
+
+    REQUIRE(singleWorkerFiles.size() == multipleWorkersFiles.size());
+    for (const auto& [sRelativePath, vContent] : singleWorkerFiles) {
+        const auto it = multipleWorkersFiles.find(sRelativePath);
+        INFO(sRelativePath);
+        REQUIRE(it != multipleWorkersFiles.end());
+        REQUIRE(it->second == vContent);
+    }
+}
+
+TEST_CASE("import skinned GLTF as skeleton, animation and inverse bind pose") {
+    const auto sPathToTestDirRelativeRes =
+        std::string(sTestDirName) + "/" + std::string(vUsedTestFileNames[22]);
+    const auto pathToTestDir =
+        ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sPathToTestDirRelativeRes;
+    if (std::filesystem::exists(pathToTestDir)) {
+        std::filesystem::remove_all(pathToTestDir);
+    }
+    std::filesystem::create_directories(pathToTestDir);
+
+    // Triangle skinned to 2 bones where the second bone is a child of the first one.
+    TestGltfBuffer buffer;
+    const std::array<float, 9> vPositions = {0.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F};
+    const std::array<unsigned char, 12> vJoints = {0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0};
+    const std::array<float, 12> vWeights = {
+        1.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 0.0F};
+    const std::array<unsigned short, 3> vIndices = {0, 1, 2};
+
+    // Use different (symmetric so that matrix layout does not matter) inverse bind pose matrices.
+    const std::array<glm::mat4x4, 2> vInverseBindPose = {
+        glm::identity<glm::mat4x4>(), glm::scale(glm::vec3(0.5F, 0.25F, 2.0F))};
+
+    // Animation moves the child bone.
+    const std::array<float, 2> vKeyTimes = {0.0F, 1.0F};
+    const std::array<float, 6> vKeyTranslations = {0.0F, 1.0F, 0.0F, 0.0F, 2.0F, 0.0F};
+
+    const auto iPositions = buffer.addAccessor(
+        vPositions.data(), sizeof(vPositions), iGltfFloat, 3, "VEC3", ",\"min\":[0,0,0],\"max\":[1,1,0]");
+    const auto iJoints = buffer.addAccessor(vJoints.data(), sizeof(vJoints), iGltfUnsignedByte, 3, "VEC4");
+    const auto iWeights = buffer.addAccessor(vWeights.data(), sizeof(vWeights), iGltfFloat, 3, "VEC4");
+    const auto iIndices =
+        buffer.addAccessor(vIndices.data(), sizeof(vIndices), iGltfUnsignedShort, 3, "SCALAR");
+    const auto iInverseBindPose =
+        buffer.addAccessor(vInverseBindPose.data(), sizeof(vInverseBindPose), iGltfFloat, 2, "MAT4");
+    const auto iKeyTimes = buffer.addAccessor(
+        vKeyTimes.data(), sizeof(vKeyTimes), iGltfFloat, 2, "SCALAR", ",\"min\":[0],\"max\":[1]");
+    const auto iKeyTranslations =
+        buffer.addAccessor(vKeyTranslations.data(), sizeof(vKeyTranslations), iGltfFloat, 2, "VEC3");
+
+    const auto pathToGltfFile = pathToTestDir / "character.gltf";
+    buffer.write(
+        pathToGltfFile,
+        std::format(
+            "\"scene\":0,\"scenes\":[{{\"nodes\":[0,1]}}],"
+            "\"nodes\":[{{\"name\":\"body\",\"mesh\":0,\"skin\":0}},"
+            "{{\"name\":\"root\",\"children\":[2]}},{{\"name\":\"child\",\"translation\":[0,1,0]}}],"
+            "\"meshes\":[{{\"primitives\":[{{\"attributes\":{{\"POSITION\":{},\"JOINTS_0\":{},"
+            "\"WEIGHTS_0\":{}}},\"indices\":{}}}]}}],"
+            "\"skins\":[{{\"joints\":[1,2],\"inverseBindMatrices\":{}}}],"
+            "\"animations\":[{{\"name\":\"move\",\"channels\":[{{\"sampler\":0,\"target\":"
+            "{{\"node\":2,\"path\":\"translation\"}}}}],\"samplers\":[{{\"input\":{},\"output\":{},"
+            "\"interpolation\":\"LINEAR\"}}]}}]",
+            iPositions,
+            iJoints,
+            iWeights,
+            iIndices,
+            iInverseBindPose,
+            iKeyTimes,
+            iKeyTranslations));
+
+    auto optionalError = GltfImporter::importFileAsNodeTree(
+        pathToGltfFile, sPathToTestDirRelativeRes, "character", [](std::string_view) {});
+    if (optionalError.has_value()) [[unlikely]] {
+        optionalError->addCurrentLocationToErrorStack();
+        INFO(optionalError->getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const auto pathToAnimDir = pathToTestDir / "character" / "character_anim";
+    REQUIRE(std::filesystem::exists(pathToAnimDir));
+
+    // Skeleton.
+    ozz::animation::Skeleton skeleton;
+    {
+        ozz::io::File file((pathToAnimDir / "skeleton.ozz").string().c_str(), "rb");
+        REQUIRE(file.opened());
+        ozz::io::IArchive archive(&file);
+        REQUIRE(archive.TestTag<ozz::animation::Skeleton>());
+        archive >> skeleton;
+    }
+    REQUIRE(skeleton.num_joints() == 2);
+
+    // Animation.
+    ozz::animation::Animation animation;
+    {
+        ozz::io::File file((pathToAnimDir / "move.ozz").string().c_str(), "rb");
+        REQUIRE(file.opened());
+        ozz::io::IArchive archive(&file);
+        REQUIRE(archive.TestTag<ozz::animation::Animation>());
+        archive >> animation;
+    }
+    REQUIRE(animation.num_tracks() == skeleton.num_joints());
+    REQUIRE(std::abs(animation.duration() - 1.0F) < 0.0001F);
+
+    // Inverse bind pose.
+    const auto pathToInverseBindPose =
+        pathToAnimDir / ("skeletonInverseBindPose." + std::string(Serializable::getBinaryFileExtension()));
+    std::ifstream file(pathToInverseBindPose, std::ios::binary);
+    REQUIRE(file.is_open());
+
+    unsigned int iMatrixCount = 0;
+    file.read(reinterpret_cast<char*>(&iMatrixCount), sizeof(iMatrixCount));
+    REQUIRE(iMatrixCount == vInverseBindPose.size());
+    for (const auto& expectedMatrix : vInverseBindPose) {
+        glm::mat4x4 matrix;
+        file.read(reinterpret_cast<char*>(glm::value_ptr(matrix)), sizeof(matrix));
+        REQUIRE(file.good());
+        REQUIRE(matrix == expectedMatrix);
+    }
+    REQUIRE(file.peek() == std::ifstream::traits_type::eof());
+}
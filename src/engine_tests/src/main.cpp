@@ -9,6 +9,7 @@
 // Custom.
 #include "io/Log.h"
 #include "TestFilePaths.hpp"
+#include "ExpectedLogWarnings.hpp"
 #include "misc/ProjectPaths.h"
 
 // External.
@@ -72,7 +73,8 @@ int main() {
     }
 
     // Check warnings/errors logged.
-    if (Log::getTotalWarningsProduced() > 0 || Log::getTotalErrorsProduced() > 0) {
+    if (Log::getTotalWarningsProduced() > iExpectedLogWarningCount.load() ||
+        Log::getTotalErrorsProduced() > 0) {
         Log::info("all tests passed but some warnings/errors were logged");
         return 1;
     }
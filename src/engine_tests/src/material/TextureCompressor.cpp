@@ -0,0 +1,264 @@
+// Standard.
+#include <array>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+#include <fstream>
+#include <filesystem>
+#include <string>
+
+// Custom.
+#include "material/TextureCompressor.h"
+#include "misc/ProjectPaths.h"
+#include "io/Log.h"
+#include "TestFilePaths.hpp"
+#include "ExpectedLogWarnings.hpp"
+
+// External.
+#include "catch2/catch_test_macros.hpp"
+#include "stb/stb_image_write.h"
+
+namespace {
+    /**
+     * Decodes a compressed image (only modes that the compressor produces) to RGBA8 pixels.
+     *
+     * @param vData   Compressed image.
+     * @param format  Format of the image.
+     * @param iWidth  Width of the image.
+     * @param iHeight Height of the image.
+     *
+     * @return Pixels.
+     */
+    std::vector<uint8_t> decompress(
+        const std::vector<uint8_t>& vData,
+        CompressedTextureFormat format,
+        unsigned int iWidth,
+        unsigned int iHeight) {
+        constexpr std::array<std::array<int, 2>, 8> vColorModifiers = {
+            {{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}}};
+        constexpr std::array<std::array<int, 8>, 16> vAlphaModifiers = {{
+            {-3, -6, -9, -15, 2, 5, 8, 14},
+            {-3, -7, -10, -13, 2, 6, 9, 12},
+            {-2, -5, -8, -13, 1, 4, 7, 12},
+            {-2, -4, -6, -13, 1, 3, 5, 12},
+            {-3, -6, -8, -12, 2, 5, 7, 11},
+            {-3, -7, -9, -11, 2, 6, 8, 10},
+            {-4, -7, -8, -11, 3, 6, 7, 10},
+            {-3, -5, -8, -11, 2, 4, 7, 10},
+            {-2, -6, -8, -10, 1, 5, 7, 9},
+            {-2, -5, -8, -10, 1, 4, 7, 9},
+            {-2, -4, -8, -10, 1, 3, 7, 9},
+            {-2, -5, -7, -10, 1, 4, 6, 9},
+            {-3, -4, -7, -10, 2, 3, 6, 9},
+            {-1, -2, -3, -10, 0, 1, 2, 9},
+            {-4, -6, -8, -9, 3, 5, 7, 8},
+            {-3, -5, -7, -9, 2, 4, 6, 8},
+        }};
+
+        const auto readBigEndian = [&](size_t iOffset) {
+            uint64_t iValue = 0;
+            for (size_t i = 0; i < 8; i++) {
+                iValue = (iValue << 8) | vData[iOffset + i];
+            }
+            return iValue;
+        };
+
+        const bool bHasAlpha = format == CompressedTextureFormat::ETC2_RGBA8_EAC;
+        const unsigned int iBlockCountX = (iWidth + 3) / 4;
+        std::vector<uint8_t> vPixels(static_cast<size_t>(iWidth) * iHeight * 4, 255);
+        for (unsigned int iBlockY = 0; iBlockY < (iHeight + 3) / 4; iBlockY++) {
+            for (unsigned int iBlockX = 0; iBlockX < iBlockCountX; iBlockX++) {
+                const size_t iBlockIndex = static_cast<size_t>(iBlockY) * iBlockCountX + iBlockX;
+                size_t iOffset = iBlockIndex * (bHasAlpha ? 16 : 8);
+
+                uint64_t iAlphaBlock = 0;
+                if (bHasAlpha) {
+                    iAlphaBlock = readBigEndian(iOffset);
+                    iOffset += 8;
+                }
+                const uint64_t iColorBlock = readBigEndian(iOffset);
+
+                // Decode base colors.
+                const bool bIsDiff = ((iColorBlock >> 33) & 1) != 0;
+                const bool bIsFlip = ((iColorBlock >> 32) & 1) != 0;
+                std::array<std::array<int, 3>, 2> vBaseColors{};
+                for (size_t iChannel = 0; iChannel < 3; iChannel++) {
+                    const auto iShift = 56 - iChannel * 8;
+                    if (bIsDiff) {
+                        const int iFirst = static_cast<int>((iColorBlock >> (iShift + 3)) & 0x1F);
+                        int iDiff = static_cast<int>((iColorBlock >> iShift) & 0x7);
+                        iDiff = iDiff >= 4 ? iDiff - 8 : iDiff;
+                        const int iSecond = iFirst + iDiff;
+                        vBaseColors[0][iChannel] = (iFirst << 3) | (iFirst >> 2);
+                        vBaseColors[1][iChannel] = (iSecond << 3) | (iSecond >> 2);
+                    } else {
+                        vBaseColors[0][iChannel] = static_cast<int>((iColorBlock >> (iShift + 4)) & 0xF) * 17;
+                        vBaseColors[1][iChannel] = static_cast<int>((iColorBlock >> iShift) & 0xF) * 17;
+                    }
+                }
+                const std::array<size_t, 2> vTables = {
+                    static_cast<size_t>((iColorBlock >> 37) & 0x7),
+                    static_cast<size_t>((iColorBlock >> 34) & 0x7)};
+
+                for (unsigned int iPixel = 0; iPixel < 16; iPixel++) {
+                    const unsigned int iX = iPixel / 4;
+                    const unsigned int iY = iPixel % 4;
+                    if (iBlockX * 4 + iX >= iWidth || iBlockY * 4 + iY >= iHeight) {
+                        continue;
+                    }
+                    uint8_t* pPixel =
+                        &vPixels[((static_cast<size_t>(iBlockY) * 4 + iY) * iWidth + iBlockX * 4 + iX) * 4];
+
+                    const size_t iSubblock = bIsFlip ? iY / 2 : iX / 2;
+                    const auto iIndex =
+                        ((iColorBlock >> iPixel) & 1) | (((iColorBlock >> (16 + iPixel)) & 1) << 1);
+                    int iModifier = vColorModifiers[vTables[iSubblock]][iIndex & 1];
+                    iModifier = (iIndex & 2) != 0 ? -iModifier : iModifier;
+                    for (size_t iChannel = 0; iChannel < 3; iChannel++) {
+                        pPixel[iChannel] = static_cast<uint8_t>(
+                            std::clamp(vBaseColors[iSubblock][iChannel] + iModifier, 0, 255));
+                    }
+
+                    if (bHasAlpha) {
+                        const int iBase = static_cast<int>(iAlphaBlock >> 56);
+                        const int iMultiplier = static_cast<int>((iAlphaBlock >> 52) & 0xF);
+                        const size_t iTable = (iAlphaBlock >> 48) & 0xF;
+                        const size_t iAlphaIndex = (iAlphaBlock >> (45 - iPixel * 3)) & 0x7;
+                        pPixel[3] = static_cast<uint8_t>(
+                            std::clamp(iBase + vAlphaModifiers[iTable][iAlphaIndex] * iMultiplier, 0, 255));
+                    }
+                }
+            }
+        }
+
+        return vPixels;
+    }
+}
+
+TEST_CASE("compress a solid color texture with mipmaps") {
+    constexpr unsigned int iSize = 8;
+    std::vector<uint8_t> vPixels;
+    for (size_t i = 0; i < iSize * iSize; i++) {
+        vPixels.insert(vPixels.end(), {200, 100, 50, 255});
+    }
+
+    const auto texture = TextureCompressor::compress(vPixels.data(), iSize, iSize, true);
+
+    // Opaque textures don't need alpha.
+    REQUIRE(texture.format == CompressedTextureFormat::ETC2_RGB8);
+
+    // 8x8, 4x4, 2x2, 1x1.
+    REQUIRE(texture.vMips.size() == 4);
+    REQUIRE(texture.vMips[0].size() == 4 * 8);
+    REQUIRE(texture.vMips[1].size() == 8);
+    REQUIRE(texture.vMips[3].size() == 8);
+
+    unsigned int iMipSize = iSize;
+    for (const auto& vMip : texture.vMips) {
+        const auto vDecoded = decompress(vMip, texture.format, iMipSize, iMipSize);
+        for (size_t i = 0; i < vDecoded.size(); i += 4) {
+            REQUIRE(std::abs(static_cast<int>(vDecoded[i + 0]) - 200) <= 4);
+            REQUIRE(std::abs(static_cast<int>(vDecoded[i + 1]) - 100) <= 4);
+            REQUIRE(std::abs(static_cast<int>(vDecoded[i + 2]) - 50) <= 4);
+        }
+        iMipSize /= 2;
+    }
+}
+
+TEST_CASE("compress a gradient texture with alpha") {
+    constexpr unsigned int iWidth = 16;
+    constexpr unsigned int iHeight = 6; // not a multiple of the block size
+    std::vector<uint8_t> vPixels;
+    for (unsigned int iY = 0; iY < iHeight; iY++) {
+        for (unsigned int iX = 0; iX < iWidth; iX++) {
+            vPixels.insert(
+                vPixels.end(),
+                {static_cast<uint8_t>(iX * 6),
+                 static_cast<uint8_t>(iY * 10),
+                 static_cast<uint8_t>(255 - iX * 8),
+                 static_cast<uint8_t>(iX * 17)});
+        }
+    }
+
+    const auto texture = TextureCompressor::compress(vPixels.data(), iWidth, iHeight, false);
+    REQUIRE(texture.format == CompressedTextureFormat::ETC2_RGBA8_EAC);
+    REQUIRE(texture.vMips.size() == 1);
+    REQUIRE(texture.vMips[0].size() == TextureCompressor::getCompressedSize(texture.format, iWidth, iHeight));
+
+    // Compare average error per channel.
+    const auto vDecoded = decompress(texture.vMips[0], texture.format, iWidth, iHeight);
+    std::array<size_t, 4> vTotalError{};
+    for (size_t i = 0; i < vDecoded.size(); i++) {
+        vTotalError[i % 4] += static_cast<size_t>(std::abs(static_cast<int>(vDecoded[i]) - vPixels[i]));
+    }
+    for (const auto iError : vTotalError) {
+        REQUIRE(iError / (iWidth * iHeight) <= 6);
+    }
+}
+
+TEST_CASE("invalid cooked texture is cooked again") {
+    const auto pathToSourceTexture = ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) /
+                                     sTestDirName / (std::string(vUsedTestFileNames[17]) + ".png");
+    const auto pathToCookedTexture = TextureCompressor::getPathToCookedTexture(pathToSourceTexture);
+    constexpr unsigned int iMaxTextureSize = 2048;
+
+    // Prepare source texture.
+    constexpr int iSize = 8;
+    std::vector<uint8_t> vPixels;
+    for (int i = 0; i < iSize * iSize; i++) {
+        vPixels.insert(vPixels.end(), {200, 100, 50, 255});
+    }
+    REQUIRE(
+        stbi_write_png(pathToSourceTexture.string().c_str(), iSize, iSize, 4, vPixels.data(), iSize * 4) !=
+        0);
+
+    // Invalid cooked files are expected to be reported as warnings.
+    size_t iWarningCount = 0;
+    const auto pLogCallbackGuard = Log::setCallback([&](LogMessageCategory category, const std::string&) {
+        if (category == LogMessageCategory::WARNING) {
+            iWarningCount += 1;
+        }
+    });
+
+    const auto loadTexture = [&]() {
+        auto result = TextureCompressor::loadOrCook(pathToSourceTexture, true, iMaxTextureSize);
+        if (std::holds_alternative<Error>(result)) [[unlikely]] {
+            INFO(std::get<Error>(result).getFullErrorMessage());
+            REQUIRE(false);
+        }
+        REQUIRE(std::get<CompressedTexture>(result).vMips.size() == 4);
+    };
+
+    // Cook.
+    loadTexture();
+    REQUIRE(std::filesystem::exists(pathToCookedTexture));
+    const auto iCookedFileSize = std::filesystem::file_size(pathToCookedTexture);
+    REQUIRE(iWarningCount == 0);
+
+    // Simulate a crash while the file was written.
+    std::filesystem::resize_file(pathToCookedTexture, iCookedFileSize - 5);
+    loadTexture();
+    REQUIRE(iWarningCount == 1);
+    REQUIRE(std::filesystem::file_size(pathToCookedTexture) == iCookedFileSize);
+    REQUIRE(!std::filesystem::exists(pathToCookedTexture.string() + ".tmp"));
+
+    // Corrupt the width in the header (after magic, version, hash, settings and format).
+    {
+        std::fstream file(pathToCookedTexture, std::ios::binary | std::ios::in | std::ios::out);
+        const uint32_t iHugeWidth = 1U << 30;
+        file.seekp(4 + 4 + 8 + 4 + 1);
+        file.write(reinterpret_cast<const char*>(&iHugeWidth), sizeof(iHugeWidth));
+    }
+    loadTexture();
+    REQUIRE(iWarningCount == 2);
+    REQUIRE(std::filesystem::file_size(pathToCookedTexture) == iCookedFileSize);
+
+    // Now it's valid again.
+    loadTexture();
+    REQUIRE(iWarningCount == 2);
+
+    iExpectedLogWarningCount += iWarningCount;
+
+    std::filesystem::remove(pathToSourceTexture);
+    std::filesystem::remove(pathToCookedTexture);
+}
@@ -0,0 +1,404 @@
+// Standard.
+#include <vector>
+#include <string>
+#include <memory>
+
+// Custom.
+#include "game/GameInstance.h"
+#include "game/World.h"
+#include "game/Window.h"
+#include "game/node/CameraNode.h"
+#include "game/node/MeshNode.h"
+#include "render/Renderer.h"
+#include "material/TextureManager.h"
+#include "misc/ProjectPaths.h"
+#include "TestFilePaths.hpp"
+
+// External.
+#include "catch2/catch_test_macros.hpp"
+#include "stb/stb_image_write.h"
+
+namespace {
+    /**
+     * Writes an RGBA PNG texture to the test directory.
+     *
+     * @param sName Name of the file (without extension).
+     * @param iSize Width and height of the texture.
+     *
+     * @return Path to the texture relative to the `res` directory.
+     */
+    std::string writeTestTexture(const std::string& sName, int iSize) {
+        const auto sPathToTextureRelativeRes = std::string(sTestDirName) + "/" + sName + ".png";
+        const auto pathToTexture =
+            ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sPathToTextureRelativeRes;
+
+        // Gradient (so that the compressor has something to do).
+        std::vector<uint8_t> vPixels(static_cast<size_t>(iSize * iSize * 4), 255);
+        for (int iY = 0; iY < iSize; iY++) {
+            for (int iX = 0; iX < iSize; iX++) {
+                const auto iPixelIndex = static_cast<size_t>((iY * iSize + iX) * 4);
+                vPixels[iPixelIndex] = static_cast<uint8_t>(iX * 255 / iSize);
+                vPixels[iPixelIndex + 1] = static_cast<uint8_t>(iY * 255 / iSize);
+            }
+        }
+        REQUIRE(
+            stbi_write_png(pathToTexture.string().c_str(), iSize, iSize, 4, vPixels.data(), iSize * 4) != 0);
+
+        return sPathToTextureRelativeRes;
+    }
+
+    /**
+     * Returns size of an uncompressed RGBA texture with mips in the GPU memory.
+     *
+     * @param iSize Width and height of the texture.
+     *
+     * @return Size in bytes.
+     */
+    size_t getUncompressedTextureSize(int iSize) {
+        const auto iFirstMipSize = static_cast<size_t>(iSize * iSize * 4);
+        return iFirstMipSize + iFirstMipSize / 3; // all mips take 1/3 of the first mip
+    }
+
+    /**
+     * Spawns a mesh that uses the specified diffuse texture in front of the camera.
+     *
+     * @param pRootNode                 World's root node.
+     * @param sPathToTextureRelativeRes Path to the texture relative to the `res` directory.
+     * @param location                  Location of the mesh.
+     */
+    void
+    spawnTexturedMesh(Node* pRootNode, const std::string& sPathToTextureRelativeRes, glm::vec3 location) {
+        auto pMesh = std::make_unique<MeshNode>();
+        pMesh->getMaterial().setPathToDiffuseTexture(sPathToTextureRelativeRes);
+        pMesh->setRelativeLocation(location);
+        pRootNode->addChildNode(std::move(pMesh));
+    }
+}
+
+TEST_CASE("textures that are not visible are evicted when the memory budget is exceeded") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            auto& textureManager = getRenderer()->getTextureManager();
+            textureManager.setUseTextureCompression(false);
+            textureManager.setFramesBeforeMipDrop(0);
+
+            // Only the big texture and 1 small texture fit.
+            textureManager.setMemoryBudget(
+                getUncompressedTextureSize(iBigTextureSize) + getUncompressedTextureSize(iSmallTextureSize));
+
+            const auto sBaseName = std::string(vUsedTestFileNames[23]);
+            sPathToBigTexture = writeTestTexture(sBaseName + "_big", iBigTextureSize);
+            for (size_t i = 0; i < 2; i++) {
+                vPathsToSmallTextures.push_back(
+                    writeTestTexture(sBaseName + "_small" + std::to_string(i), iSmallTextureSize));
+            }
+
+            createWorld([this](Node* pRootNode) {
+                pWorldRootNode = pRootNode;
+
+                const auto pCamera = pRootNode->addChildNode(std::make_unique<CameraNode>());
+                pCamera->makeActive();
+
+                // Small textures are loaded but not used by visible meshes.
+                auto& textureManager = getRenderer()->getTextureManager();
+                for (const auto& sPathToTexture : vPathsToSmallTextures) {
+                    auto result = textureManager.getTextureAsync(sPathToTexture, TextureUsage::DIFFUSE);
+                    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+                        INFO(std::get<Error>(result).getFullErrorMessage());
+                        REQUIRE(false);
+                    }
+                    vSmallTextures.push_back(std::get<std::unique_ptr<TextureHandle>>(std::move(result)));
+                }
+            });
+        }
+        virtual ~TestGameInstance() override {}
+
+        virtual void onBeforeNewFrame(float timeSincePrevCallInSec) override {
+            if (pWorldRootNode == nullptr) {
+                return;
+            }
+            iFrameCount += 1;
+            REQUIRE(iFrameCount < iMaxFrameCount);
+
+            const auto stats = getRenderer()->getTextureManager().getStreamingStats();
+            const bool bIsLoading = stats.iDecodingTextureCount > 0 || stats.iPendingUploadBytes > 0;
+            const auto iBigSize = getUncompressedTextureSize(iBigTextureSize);
+            const auto iSmallSize = getUncompressedTextureSize(iSmallTextureSize);
+
+            if (!bSpawnedBigMesh) {
+                if (bIsLoading || stats.iResidentBytes < iSmallSize * 2) {
+                    return;
+                }
+
+                // Both fit, now a visible mesh needs more memory (small textures were visible a longer
+                // time ago so one of them should be evicted).
+                REQUIRE(stats.iTotalEvictionCount == 0);
+                spawnTexturedMesh(pWorldRootNode, sPathToBigTexture, glm::vec3(0.0f, 0.0f, -5.0f));
+                bSpawnedBigMesh = true;
+                return;
+            }
+
+            if (!bSpawnedSmallMeshes) {
+                if (bIsLoading || stats.iTotalEvictionCount == 0) {
+                    return;
+                }
+
+                REQUIRE(stats.iTotalEvictionCount == 1);
+                REQUIRE(stats.iEvictedTextureCount == 1);
+                REQUIRE(stats.iResidentBytes == iBigSize + iSmallSize);
+                REQUIRE(stats.iResidentBytes <= stats.iMemoryBudgetBytes);
+
+                // Make the evicted texture visible again.
+                for (size_t i = 0; i < vPathsToSmallTextures.size(); i++) {
+                    spawnTexturedMesh(
+                        pWorldRootNode,
+                        vPathsToSmallTextures[i],
+                        glm::vec3(i == 0 ? -2.0f : 2.0f, 0.0f, -5.0f));
+                }
+                bSpawnedSmallMeshes = true;
+                return;
+            }
+
+            if (bIsLoading || stats.iEvictedTextureCount > 0) {
+                return;
+            }
+
+            // Visible textures are streamed back and never evicted (even if they exceed the budget).
+            REQUIRE(stats.iResidentBytes == iBigSize + iSmallSize * 2);
+            REQUIRE(stats.iResidentBytes > stats.iMemoryBudgetBytes);
+            REQUIRE(stats.iTotalEvictionCount == 1);
+
+            vSmallTextures.clear();
+            getWindow()->close();
+        }
+
+    private:
+        const int iBigTextureSize = 128;
+        const int iSmallTextureSize = 64;
+        const size_t iMaxFrameCount = 1000;
+
+        Node* pWorldRootNode = nullptr;
+        std::string sPathToBigTexture;
+        std::vector<std::string> vPathsToSmallTextures;
+        std::vector<std::unique_ptr<TextureHandle>> vSmallTextures;
+        size_t iFrameCount = 0;
+        bool bSpawnedBigMesh = false;
+        bool bSpawnedSmallMeshes = false;
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("texture that is not visible drops top mips and streams them back once visible") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            auto& textureManager = getRenderer()->getTextureManager();
+            textureManager.setUseTextureCompression(true); // only compressed textures drop mips
+            textureManager.setMemoryBudget(0);
+            textureManager.setFramesBeforeMipDrop(0); // enabled after the full texture is loaded
+
+            sPathToTexture = writeTestTexture(std::string(vUsedTestFileNames[24]), 64);
+
+            createWorld([this](Node* pRootNode) {
+                pWorldRootNode = pRootNode;
+
+                const auto pCamera = pRootNode->addChildNode(std::make_unique<CameraNode>());
+                pCamera->makeActive();
+
+                auto result = getRenderer()->getTextureManager().getTextureAsync(
+                    sPathToTexture, TextureUsage::DIFFUSE);
+                if (std::holds_alternative<Error>(result)) [[unlikely]] {
+                    INFO(std::get<Error>(result).getFullErrorMessage());
+                    REQUIRE(false);
+                }
+                pTexture = std::get<std::unique_ptr<TextureHandle>>(std::move(result));
+            });
+        }
+        virtual ~TestGameInstance() override {}
+
+        virtual void onBeforeNewFrame(float timeSincePrevCallInSec) override {
+            if (pWorldRootNode == nullptr) {
+                return;
+            }
+            iFrameCount += 1;
+            REQUIRE(iFrameCount < iMaxFrameCount);
+
+            auto& textureManager = getRenderer()->getTextureManager();
+            const auto stats = textureManager.getStreamingStats();
+            const bool bIsLoading = stats.iDecodingTextureCount > 0 || stats.iPendingUploadBytes > 0;
+
+            if (iFullSizeInBytes == 0) {
+                if (bIsLoading || stats.iResidentBytes == 0) {
+                    return;
+                }
+
+                // Full texture is loaded, the texture is not used by visible meshes.
+                REQUIRE(stats.iReducedTextureCount == 0);
+                iFullSizeInBytes = stats.iResidentBytes;
+                textureManager.setFramesBeforeMipDrop(iFramesBeforeMipDrop);
+                return;
+            }
+
+            if (!bSpawnedMesh) {
+                if (bIsLoading || stats.iResidentBytes == iFullSizeInBytes) {
+                    return;
+                }
+
+                // 2 top mips take most of the memory.
+                REQUIRE(stats.iReducedTextureCount == 1);
+                REQUIRE(stats.iResidentBytes < iFullSizeInBytes / 4);
+                REQUIRE(iFrameCount > iFramesBeforeMipDrop);
+
+                spawnTexturedMesh(pWorldRootNode, sPathToTexture, glm::vec3(0.0f, 0.0f, -5.0f));
+                bSpawnedMesh = true;
+                return;
+            }
+
+            if (bIsLoading || stats.iResidentBytes != iFullSizeInBytes) {
+                return;
+            }
+
+            // Full mips were streamed back.
+            REQUIRE(stats.iReducedTextureCount == 0);
+            REQUIRE(stats.iEvictedTextureCount == 0);
+
+            // Stays full while visible.
+            iVisibleFullFrameCount += 1;
+            if (iVisibleFullFrameCount < iFramesBeforeMipDrop * 2) {
+                return;
+            }
+
+            pTexture = nullptr;
+            getWindow()->close();
+        }
+
+    private:
+        const size_t iFramesBeforeMipDrop = 5;
+        const size_t iMaxFrameCount = 1000;
+
+        Node* pWorldRootNode = nullptr;
+        std::string sPathToTexture;
+        std::unique_ptr<TextureHandle> pTexture;
+        size_t iFullSizeInBytes = 0;
+        size_t iFrameCount = 0;
+        size_t iVisibleFullFrameCount = 0;
+        bool bSpawnedMesh = false;
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("textures requested asynchronously are uploaded within the per frame budget and become ready") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            auto& textureManager = getRenderer()->getTextureManager();
+            textureManager.setUseTextureCompression(false);
+            textureManager.setMemoryBudget(0);
+            textureManager.setUploadBudgetPerFrame(iUploadSize * iTexturesPerFrame);
+
+            for (size_t i = 0; i < iTextureCount; i++) {
+                const auto sPathToTexture = writeTestTexture(
+                    std::string(vUsedTestFileNames[25]) + std::to_string(i), static_cast<int>(iTextureSize));
+
+                auto result = textureManager.getTextureAsync(sPathToTexture, TextureUsage::DIFFUSE);
+                if (std::holds_alternative<Error>(result)) [[unlikely]] {
+                    INFO(std::get<Error>(result).getFullErrorMessage());
+                    REQUIRE(false);
+                }
+                auto pTexture = std::get<std::unique_ptr<TextureHandle>>(std::move(result));
+
+                // Uses a placeholder until uploaded.
+                REQUIRE(pTexture->getTextureId() != 0);
+                REQUIRE(!pTexture->isReady());
+                vTextures.push_back(std::move(pTexture));
+            }
+        }
+        virtual ~TestGameInstance() override {}
+
+        virtual void onBeforeNewFrame(float timeSincePrevCallInSec) override {
+            if (vTextures.empty()) {
+                return;
+            }
+            iFrameCount += 1;
+            REQUIRE(iFrameCount < iMaxFrameCount);
+
+            // Stats of the previous frame.
+            const auto stats = getRenderer()->getTextureManager().getStreamingStats();
+            REQUIRE(stats.iUploadedBytesLastFrame <= iUploadSize * iTexturesPerFrame);
+            if (stats.iUploadedBytesLastFrame > 0) {
+                iFramesWithUploads += 1;
+                iTotalUploadedBytes += stats.iUploadedBytesLastFrame;
+            }
+
+            size_t iReadyCount = 0;
+            for (const auto& pTexture : vTextures) {
+                if (pTexture->isReady()) {
+                    iReadyCount += 1;
+                }
+            }
+            REQUIRE(iReadyCount * iUploadSize <= iTotalUploadedBytes);
+            if (iReadyCount < vTextures.size()) {
+                return;
+            }
+
+            // All textures were uploaded, spread over multiple frames.
+            REQUIRE(iTotalUploadedBytes == iUploadSize * iTextureCount);
+            REQUIRE(iFramesWithUploads >= iTextureCount / iTexturesPerFrame);
+            REQUIRE(stats.iDecodingTextureCount == 0);
+            REQUIRE(stats.iPendingUploadBytes == 0);
+            REQUIRE(
+                stats.iResidentBytes ==
+                getUncompressedTextureSize(static_cast<int>(iTextureSize)) * iTextureCount);
+
+            vTextures.clear();
+            getWindow()->close();
+        }
+
+    private:
+        const size_t iTextureCount = 8;
+        const size_t iTexturesPerFrame = 2;
+        const size_t iTextureSize = 64;
+        const size_t iUploadSize = iTextureSize * iTextureSize * 4; // RGBA without mips
+        const size_t iMaxFrameCount = 1000;
+
+        std::vector<std::unique_ptr<TextureHandle>> vTextures;
+        size_t iFrameCount = 0;
+        size_t iFramesWithUploads = 0;
+        size_t iTotalUploadedBytes = 0;
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
@@ -0,0 +1,1276 @@
+// Standard.
+#include <chrono>
+#include <format>
+#include <cmath>
+#include <array>
+#include <optional>
+#include <random>
+#include <vector>
+
+// Custom.
+#include "game/GameInstance.h"
+#include "game/GameManager.h"
+#include "game/World.h"
+#include "game/Window.h"
+#include "game/node/physics/CollisionNode.h"
+#include "game/node/physics/SimulatedBodyNode.h"
+#include "game/node/physics/TriggerVolumeNode.h"
+#include "game/node/physics/CharacterBodyNode.h"
+#include "game/node/MeshNode.h"
+#include "game/geometry/shapes/CollisionShape.h"
+#include "game/physics/PhysicsManager.h"
+#include "game/DebugConsole.h"
+#include "game/physics/CollisionShapeCache.h"
+#include "game/geometry/ConvexShapeGeometry.h"
+#include "game/geometry/HeightFieldGeometry.h"
+#include "game/geometry/PrimitiveMeshGenerator.h"
+#include "io/Log.h"
+#include "TestFilePaths.hpp"
+
+// External.
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+TEST_CASE("measure frame time with 2000 simulated bodies with sync and async physics step") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            createWorld([this](Node* pRootNode) {
+                // Floor.
+                auto pFloor = std::make_unique<CollisionNode>();
+                auto pFloorShape = std::make_unique<BoxCollisionShape>();
+                pFloorShape->setHalfExtent(glm::vec3(100.0f, 0.5f, 100.0f));
+                pFloor->setShape(std::move(pFloorShape));
+                pFloor->setRelativeLocation(glm::vec3(0.0f, -0.5f, 0.0f));
+                pRootNode->addChildNode(std::move(pFloor));
+
+                // Boxes that fall on the floor and stay there (with meshes to also measure the write-back
+                // of physics results to render data).
+                for (size_t iLayer = 0; iLayer < iLayerCount; iLayer++) {
+                    for (size_t iX = 0; iX < iGridSize; iX++) {
+                        for (size_t iZ = 0; iZ < iGridSize; iZ++) {
+                            auto pBody = std::make_unique<SimulatedBodyNode>();
+                            pBody->setRelativeLocation(glm::vec3(
+                                static_cast<float>(iX) * 2.0f - static_cast<float>(iGridSize),
+                                1.0f + static_cast<float>(iLayer) * 2.0f,
+                                static_cast<float>(iZ) * 2.0f - static_cast<float>(iGridSize)));
+                            pBody->addChildNode(std::make_unique<MeshNode>());
+                            pRootNode->addChildNode(std::move(pBody));
+                        }
+                    }
+                }
+
+                // Body that never stops falling to check that the simulation is running.
+                auto pFallingBody = std::make_unique<SimulatedBodyNode>();
+                pFallingBody->setRelativeLocation(glm::vec3(1000.0f, 1000.0f, 1000.0f));
+                pFallingBodyNode = pRootNode->addChildNode(std::move(pFallingBody));
+            });
+        }
+        virtual ~TestGameInstance() override {}
+
+        virtual void onBeforeNewFrame(float timeSincePrevCallInSec) override {
+            if (pFallingBodyNode == nullptr) {
+                return;
+            }
+
+            const auto currentTime = std::chrono::steady_clock::now();
+            iFrameCount += 1;
+
+            // Write-back of the previous frame.
+            if (iFrameCount > iWarmupFrameCount && iFrameCount <= iWarmupFrameCount + iMeasuredFrameCount) {
+                totalWriteBackTimeMs += DebugConsole::getStats().physicsWriteBackTimeMs;
+            }
+
+            if (iFrameCount == iWarmupFrameCount) {
+                measureStartTime = currentTime;
+            } else if (iFrameCount == iWarmupFrameCount + iMeasuredFrameCount) {
+                syncFrameTimeMs = getAverageFrameTimeMs(currentTime);
+                Log::info(std::format(
+                    "average time to write physics results of {} bodies with meshes to nodes: {:.3F} ms",
+                    iLayerCount * iGridSize * iGridSize + 1,
+                    totalWriteBackTimeMs / static_cast<float>(iMeasuredFrameCount)));
+
+                auto& physicsManager =
+                    pFallingBodyNode->getWorldWhileSpawned()->getGameManager().getPhysicsManager();
+                physicsManager.setEnableAsyncPhysicsStep(true);
+                REQUIRE(physicsManager.isAsyncPhysicsStepEnabled());
+
+                fallingBodyHeightBeforeAsync = pFallingBodyNode->getWorldLocation().y;
+            } else if (iFrameCount == iWarmupFrameCount * 2 + iMeasuredFrameCount) {
+                measureStartTime = currentTime;
+            } else if (iFrameCount == (iWarmupFrameCount + iMeasuredFrameCount) * 2) {
+                const auto asyncFrameTimeMs = getAverageFrameTimeMs(currentTime);
+                Log::info(std::format(
+                    "average frame time with {} simulated bodies: sync physics step {:.2F} ms, async physics "
+                    "step {:.2F} ms",
+                    iLayerCount * iGridSize * iGridSize + 1,
+                    syncFrameTimeMs,
+                    asyncFrameTimeMs));
+
+                // Results of the async step should be applied to nodes.
+                REQUIRE(pFallingBodyNode->getWorldLocation().y < fallingBodyHeightBeforeAsync);
+
+                getWindow()->close();
+            }
+        }
+
+    private:
+        /**
+         * Returns average frame time since @ref measureStartTime.
+         *
+         * @param currentTime Current time.
+         *
+         * @return Time in milliseconds.
+         */
+        float getAverageFrameTimeMs(std::chrono::steady_clock::time_point currentTime) const {
+            const auto durationMs =
+                std::chrono::duration<float, std::milli>(currentTime - measureStartTime).count();
+            return durationMs / static_cast<float>(iMeasuredFrameCount);
+        }
+
+        const size_t iGridSize = 20;
+        const size_t iLayerCount = 5;
+        const size_t iWarmupFrameCount = 10;
+        const size_t iMeasuredFrameCount = 120;
+
+        SimulatedBodyNode* pFallingBodyNode = nullptr;
+        std::chrono::steady_clock::time_point measureStartTime;
+        size_t iFrameCount = 0;
+        float syncFrameTimeMs = 0.0f;
+        float totalWriteBackTimeMs = 0.0f;
+        float fallingBodyHeightBeforeAsync = 0.0f;
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("benchmark spawning 1000 convex bodies with and without the shape cache") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            createWorld([this](Node* pRootNode) {
+                constexpr size_t iBodyCount = 1000;
+
+                // Use a unique directory so that cooked files of previous runs are never picked up.
+                const auto sBenchmarkDirRelativeRes = std::format(
+                    "{}/{}_{}",
+                    sTestDirName,
+                    vUsedTestFileNames[13],
+                    std::chrono::steady_clock::now().time_since_epoch().count());
+                const auto pathToBenchmarkDir =
+                    ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sBenchmarkDirRelativeRes;
+                std::filesystem::create_directories(pathToBenchmarkDir);
+
+                // Prepare convex geometry (points on a sphere).
+                const auto sPathToGeometryRelativeRes =
+                    sBenchmarkDirRelativeRes + "/" + std::string(vUsedTestFileNames[13]);
+                const auto pathToGeometry = ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) /
+                                            sPathToGeometryRelativeRes;
+                ConvexShapeGeometry geometry;
+                for (size_t iRing = 0; iRing < 8; iRing++) {
+                    const auto pitch = glm::pi<float>() * (static_cast<float>(iRing) + 0.5f) / 8.0f;
+                    for (size_t iSegment = 0; iSegment < 8; iSegment++) {
+                        const auto yaw = glm::two_pi<float>() * static_cast<float>(iSegment) / 8.0f;
+                        geometry.getPositions().push_back(glm::vec3(
+                            std::sin(pitch) * std::cos(yaw),
+                            std::cos(pitch),
+                            std::sin(pitch) * std::sin(yaw)));
+                    }
+                }
+                geometry.serialize(pathToGeometry);
+
+                auto& shapeCache = pRootNode->getWorldWhileSpawned()
+                                       ->getGameManager()
+                                       .getPhysicsManager()
+                                       .getCollisionShapeCache();
+
+                const auto spawnAndDespawnBodies = [pRootNode, &sPathToGeometryRelativeRes]() {
+                    auto pParentNode = std::make_unique<Node>();
+                    for (size_t i = 0; i < iBodyCount; i++) {
+                        auto pShape = std::make_unique<ConvexCollisionShape>();
+                        pShape->setPathToGeometryRelativeRes(sPathToGeometryRelativeRes);
+
+                        auto pBody = std::make_unique<SimulatedBodyNode>();
+                        pBody->setShape(std::move(pShape));
+                        pBody->setRelativeLocation(glm::vec3(static_cast<float>(i) * 3.0f, 0.0f, 0.0f));
+                        pParentNode->addChildNode(std::move(pBody));
+                    }
+                    pRootNode->addChildNode(std::move(pParentNode))->unsafeDetachFromParentAndDespawn(true);
+                };
+
+                shapeCache.setEnabled(false);
+                BENCHMARK("without cache, building hulls") { spawnAndDespawnBodies(); };
+
+                auto optionalError = ConvexCollisionShape::cookConvexHull(pathToGeometry);
+                if (optionalError.has_value()) [[unlikely]] {
+                    optionalError->addCurrentLocationToErrorStack();
+                    INFO(optionalError->getFullErrorMessage());
+                    REQUIRE(false);
+                }
+                REQUIRE(
+                    std::filesystem::exists(ConvexCollisionShape::getPathToCookedConvexHull(pathToGeometry)));
+
+                BENCHMARK("without cache, cooked hulls") { spawnAndDespawnBodies(); };
+
+                shapeCache.setEnabled(true);
+                BENCHMARK("with cache") { spawnAndDespawnBodies(); };
+
+                // All bodies used the same shape.
+                REQUIRE(shapeCache.getCachedShapeCount() == 1);
+
+                std::filesystem::remove_all(pathToBenchmarkDir);
+                REQUIRE(!std::filesystem::exists(pathToBenchmarkDir));
+
+                getWindow()->close();
+            });
+        }
+        virtual ~TestGameInstance() override {}
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("measure level spawn time with 10000 static bodies") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            createWorld([this](Node* pRootNode) {
+                constexpr size_t iGridSize = 100;
+
+                // Prepare a level with static bodies.
+                auto pLevelNode = std::make_unique<Node>();
+                for (size_t iX = 0; iX < iGridSize; iX++) {
+                    for (size_t iZ = 0; iZ < iGridSize; iZ++) {
+                        auto pCollisionNode = std::make_unique<CollisionNode>();
+                        pCollisionNode->setRelativeLocation(
+                            glm::vec3(static_cast<float>(iX) * 2.0f, 0.0f, static_cast<float>(iZ) * 2.0f));
+                        pLevelNode->addChildNode(std::move(pCollisionNode));
+                    }
+                }
+
+                // Spawn.
+                const auto spawnStartTime = std::chrono::steady_clock::now();
+                const auto pSpawnedLevelNode = pRootNode->addChildNode(std::move(pLevelNode));
+                const auto spawnTimeMs = std::chrono::duration<float, std::milli>(
+                                             std::chrono::steady_clock::now() - spawnStartTime)
+                                             .count();
+
+                // All bodies should be in the physics world.
+                auto& physicsManager =
+                    pRootNode->getWorldWhileSpawned()->getGameManager().getPhysicsManager();
+                for (size_t i = 0; i < iGridSize; i++) {
+                    const auto location = static_cast<float>(i) * 2.0f;
+                    const auto optionalHit = physicsManager.castRayUntilHit(
+                        glm::vec3(location, 10.0f, location), glm::vec3(location, -10.0f, location));
+                    REQUIRE(optionalHit.has_value());
+                }
+
+                // Despawn.
+                const auto despawnStartTime = std::chrono::steady_clock::now();
+                pSpawnedLevelNode->unsafeDetachFromParentAndDespawn(true);
+                const auto despawnTimeMs = std::chrono::duration<float, std::milli>(
+                                               std::chrono::steady_clock::now() - despawnStartTime)
+                                               .count();
+
+                Log::info(std::format(
+                    "level with {} static bodies: spawn time {:.2F} ms, despawn time {:.2F} ms",
+                    iGridSize * iGridSize,
+                    spawnTimeMs,
+                    despawnTimeMs));
+
+                // Bodies should be removed from the physics world.
+                const auto optionalHit = physicsManager.castRayUntilHit(
+                    glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f, -10.0f, 0.0f));
+                REQUIRE(!optionalHit.has_value());
+
+                getWindow()->close();
+            });
+        }
+        virtual ~TestGameInstance() override {}
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("deactivated simulated body is moved out of awake nodes and its node is no longer updated") {
+    class CountingBodyNode : public SimulatedBodyNode {
+    public:
+        size_t iTransformChangeCount = 0;
+
+    protected:
+        virtual void onWorldLocationRotationScaleChanged() override {
+            SimulatedBodyNode::onWorldLocationRotationScaleChanged();
+
+            iTransformChangeCount += 1;
+        }
+    };
+
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            createWorld([this](Node* pRootNode) {
+                // Both bodies fall (no floor).
+                auto pStopped = std::make_unique<CountingBodyNode>();
+                pStopped->setRelativeLocation(glm::vec3(0.0f, 10.0f, 0.0f));
+                pStoppedNode = pRootNode->addChildNode(std::move(pStopped));
+
+                auto pFalling = std::make_unique<SimulatedBodyNode>();
+                pFalling->setRelativeLocation(glm::vec3(5.0f, 10.0f, 0.0f));
+                pFallingNode = pRootNode->addChildNode(std::move(pFalling));
+            });
+        }
+        virtual ~TestGameInstance() override {}
+
+        virtual void onBeforeNewFrame(float timeSincePrevCallInSec) override {
+            if (pStoppedNode == nullptr) {
+                return;
+            }
+
+            timePassedSec += timeSincePrevCallInSec;
+            if (timePassedSec < 0.3f) {
+                return;
+            }
+            timePassedSec = 0.0f;
+
+            auto& physicsManager = pStoppedNode->getWorldWhileSpawned()->getGameManager().getPhysicsManager();
+            REQUIRE(physicsManager.getSimulatedBodyNodeCount(false) == 2);
+
+            switch (iStep) {
+            case 0: {
+                // Both bodies are simulated.
+                REQUIRE(physicsManager.getSimulatedBodyNodeCount(true) == 2);
+                REQUIRE(pStoppedNode->getWorldLocation().y < 10.0f);
+
+                pStoppedNode->setIsSimulated(false);
+                break;
+            }
+            case 1: {
+                // The node received its final transform and was moved out of awake nodes.
+                REQUIRE(physicsManager.getSimulatedBodyNodeCount(true) == 1);
+
+                stoppedLocation = pStoppedNode->getWorldLocation();
+                iStoppedTransformChangeCount = pStoppedNode->iTransformChangeCount;
+                fallingLocation = pFallingNode->getWorldLocation();
+                break;
+            }
+            case 2: {
+                // Only the awake node was updated.
+                REQUIRE(physicsManager.getSimulatedBodyNodeCount(true) == 1);
+                REQUIRE(pStoppedNode->iTransformChangeCount == iStoppedTransformChangeCount);
+                REQUIRE(pStoppedNode->getWorldLocation() == stoppedLocation);
+                REQUIRE(pFallingNode->getWorldLocation().y < fallingLocation.y);
+
+                // Activation moves the node back to awake nodes.
+                pStoppedNode->setIsSimulated(true);
+                REQUIRE(physicsManager.getSimulatedBodyNodeCount(true) == 2);
+                break;
+            }
+            default: {
+                // The node receives new transforms again.
+                REQUIRE(physicsManager.getSimulatedBodyNodeCount(true) == 2);
+                REQUIRE(pStoppedNode->iTransformChangeCount > iStoppedTransformChangeCount);
+                REQUIRE(pStoppedNode->getWorldLocation().y < stoppedLocation.y);
+
+                getWindow()->close();
+                break;
+            }
+            }
+
+            iStep += 1;
+        }
+
+    private:
+        CountingBodyNode* pStoppedNode = nullptr;
+        SimulatedBodyNode* pFallingNode = nullptr;
+        glm::vec3 stoppedLocation = glm::vec3(0.0f);
+        glm::vec3 fallingLocation = glm::vec3(0.0f);
+        size_t iStoppedTransformChangeCount = 0;
+        size_t iStep = 0;
+        float timePassedSec = 0.0f;
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("benchmark 10000 batched rays against separate ray casts") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            createWorld([this](Node* pRootNode) {
+                constexpr size_t iGridSize = 100;
+
+                // Prepare a level with static bodies.
+                auto pLevelNode = std::make_unique<Node>();
+                for (size_t iX = 0; iX < iGridSize; iX++) {
+                    for (size_t iZ = 0; iZ < iGridSize; iZ++) {
+                        auto pCollisionNode = std::make_unique<CollisionNode>();
+                        pCollisionNode->setRelativeLocation(
+                            glm::vec3(static_cast<float>(iX) * 2.0f, 0.0f, static_cast<float>(iZ) * 2.0f));
+                        pLevelNode->addChildNode(std::move(pCollisionNode));
+                    }
+                }
+                pRootNode->addChildNode(std::move(pLevelNode));
+
+                // Every odd ray goes between bodies and should not hit anything.
+                std::vector<PhysicsManager::CastQuery> vQueries;
+                vQueries.reserve(iGridSize * iGridSize);
+                for (size_t iX = 0; iX < iGridSize; iX++) {
+                    for (size_t iZ = 0; iZ < iGridSize; iZ++) {
+                        const auto offset = (iZ % 2 == 0) ? 0.0f : 1.0f;
+                        const auto location = glm::vec3(
+                            static_cast<float>(iX) * 2.0f + offset,
+                            0.0f,
+                            static_cast<float>(iZ) * 2.0f + offset);
+                        vQueries.push_back(PhysicsManager::CastQuery{
+                            .startPosition = location + glm::vec3(0.0f, 10.0f, 0.0f),
+                            .endPosition = location - glm::vec3(0.0f, 10.0f, 0.0f)});
+                    }
+                }
+
+                auto& physicsManager =
+                    pRootNode->getWorldWhileSpawned()->getGameManager().getPhysicsManager();
+
+                // Separate casts.
+                std::vector<std::optional<PhysicsManager::RayCastHit>> vSeparateHits(vQueries.size());
+                const auto separateStartTime = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < vQueries.size(); i++) {
+                    vSeparateHits[i] =
+                        physicsManager.castRayUntilHit(vQueries[i].startPosition, vQueries[i].endPosition);
+                }
+                const auto separateTimeMs = std::chrono::duration<float, std::milli>(
+                                                std::chrono::steady_clock::now() - separateStartTime)
+                                                .count();
+
+                // Batched casts.
+                std::vector<std::optional<PhysicsManager::RayCastHit>> vBatchedHits(vQueries.size());
+                const auto batchedStartTime = std::chrono::steady_clock::now();
+                physicsManager.castRaysUntilHit(vQueries, vBatchedHits);
+                const auto batchedTimeMs = std::chrono::duration<float, std::milli>(
+                                               std::chrono::steady_clock::now() - batchedStartTime)
+                                               .count();
+
+                Log::info(std::format(
+                    "{} rays: separate casts {:.2F} ms, batched casts {:.2F} ms",
+                    vQueries.size(),
+                    separateTimeMs,
+                    batchedTimeMs));
+
+                // Results should be the same.
+                for (size_t i = 0; i < vQueries.size(); i++) {
+                    REQUIRE(vSeparateHits[i].has_value() == (i % 2 == 0));
+                    REQUIRE(vBatchedHits[i].has_value() == vSeparateHits[i].has_value());
+                    if (vBatchedHits[i].has_value()) {
+                        REQUIRE(vBatchedHits[i]->bodyId == vSeparateHits[i]->bodyId);
+                        REQUIRE(
+                            glm::all(glm::epsilonEqual(
+                                vBatchedHits[i]->hitPosition, vSeparateHits[i]->hitPosition, 0.001f)));
+                    }
+                }
+
+                // Ignored bodies are used by all rays.
+                const std::array<JPH::BodyID, 1> vIgnoredBodies = {vBatchedHits[0]->bodyId};
+                physicsManager.castRaysUntilHit(
+                    std::span(vQueries).first(2), std::span(vBatchedHits).first(2), vIgnoredBodies);
+                REQUIRE(!vBatchedHits[0].has_value());
+
+                // Spheres that are wide enough should hit bodies between rays.
+                physicsManager.castSpheresUntilHit(vQueries, 1.0f, vBatchedHits);
+                for (const auto& optionalHit : vBatchedHits) {
+                    REQUIRE(optionalHit.has_value());
+                }
+
+                getWindow()->close();
+            });
+        }
+        virtual ~TestGameInstance() override {}
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("body falls asleep on the floor and a trigger volume enabled around it wakes it up") {
+    class CountingBodyNode : public SimulatedBodyNode {
+    public:
+        size_t iTransformChangeCount = 0;
+
+    protected:
+        virtual void onWorldLocationRotationScaleChanged() override {
+            SimulatedBodyNode::onWorldLocationRotationScaleChanged();
+
+            iTransformChangeCount += 1;
+        }
+    };
+
+    class CountingTriggerVolumeNode : public TriggerVolumeNode {
+    public:
+        CountingTriggerVolumeNode() = default;
+        virtual ~CountingTriggerVolumeNode() override = default;
+
+        size_t iAddedContactCount = 0;
+        size_t iRemovedContactCount = 0;
+
+    protected:
+        virtual void
+        onContactAdded(Node* pNode, const glm::vec3& hitWorldPosition, const glm::vec3& hitNormal) override {
+            iAddedContactCount += 1;
+        }
+        virtual void onContactRemoved(Node* pNode) override { iRemovedContactCount += 1; }
+    };
+
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            createWorld([this](Node* pRootNode) {
+                auto pFloor = std::make_unique<CollisionNode>();
+                auto pFloorShape = std::make_unique<BoxCollisionShape>();
+                pFloorShape->setHalfExtent(glm::vec3(10.0f, 0.5f, 10.0f));
+                pFloor->setShape(std::move(pFloorShape));
+                pFloor->setRelativeLocation(glm::vec3(0.0f, -0.5f, 0.0f));
+                pRootNode->addChildNode(std::move(pFloor));
+
+                auto pBody = std::make_unique<CountingBodyNode>();
+                pBody->setRelativeLocation(glm::vec3(0.0f, 2.0f, 0.0f));
+                pBodyNode = pRootNode->addChildNode(std::move(pBody));
+
+                // Disabled until the body falls asleep.
+                auto pTrigger = std::make_unique<CountingTriggerVolumeNode>();
+                auto pTriggerShape = std::make_unique<BoxCollisionShape>();
+                pTriggerShape->setHalfExtent(glm::vec3(3.0f, 3.0f, 3.0f));
+                pTrigger->setShape(std::move(pTriggerShape));
+                pTrigger->setIsTriggerEnabled(false);
+                pTriggerNode = pRootNode->addChildNode(std::move(pTrigger));
+            });
+        }
+        virtual ~TestGameInstance() override {}
+
+        virtual void onBeforeNewFrame(float timeSincePrevCallInSec) override {
+            if (pBodyNode == nullptr) {
+                return;
+            }
+
+            timePassedSec += timeSincePrevCallInSec;
+            if (timePassedSec > 20.0f) [[unlikely]] {
+                INFO(std::format("stuck at step {}", iStep));
+                REQUIRE(false);
+            }
+
+            const auto& physicsManager =
+                pBodyNode->getWorldWhileSpawned()->getGameManager().getPhysicsManager();
+            const auto iAwakeCount = physicsManager.getSimulatedBodyNodeCount(true);
+            REQUIRE(physicsManager.getSimulatedBodyNodeCount(false) == 1);
+
+            switch (iStep) {
+            case 0: {
+                // Wait for the body to land and fall asleep.
+                if (iAwakeCount != 0) {
+                    return;
+                }
+                REQUIRE(pBodyNode->getWorldLocation().y < 1.0f);
+                iTransformChangeCount = pBodyNode->iTransformChangeCount;
+                iSleepingFrameCount = 0;
+                break;
+            }
+            case 1: {
+                // Sleeping node is not updated.
+                REQUIRE(iAwakeCount == 0);
+                REQUIRE(pBodyNode->iTransformChangeCount == iTransformChangeCount);
+                iSleepingFrameCount += 1;
+                if (iSleepingFrameCount < 30) {
+                    return;
+                }
+
+                // Static sensors don't detect sleeping bodies so the body should be woken up.
+                pTriggerNode->setIsTriggerEnabled(true);
+                break;
+            }
+            case 2: {
+                // Wait for the contact.
+                if (pTriggerNode->iAddedContactCount == 0) {
+                    return;
+                }
+                REQUIRE(pTriggerNode->iAddedContactCount == 1);
+                break;
+            }
+            default: {
+                // Falls asleep again while keeping the contact.
+                if (iAwakeCount != 0) {
+                    return;
+                }
+                REQUIRE(pTriggerNode->iAddedContactCount == 1);
+                REQUIRE(pTriggerNode->iRemovedContactCount == 0);
+
+                getWindow()->close();
+                return;
+            }
+            }
+
+            iStep += 1;
+        }
+
+    private:
+        CountingBodyNode* pBodyNode = nullptr;
+        CountingTriggerVolumeNode* pTriggerNode = nullptr;
+        size_t iTransformChangeCount = 0;
+        size_t iSleepingFrameCount = 0;
+        size_t iStep = 0;
+        float timePassedSec = 0.0f;
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("trigger volume receives 5000 simultaneous contacts") {
+    class CountingTriggerVolumeNode : public TriggerVolumeNode {
+    public:
+        CountingTriggerVolumeNode() = default;
+        virtual ~CountingTriggerVolumeNode() override = default;
+
+        size_t iAddedContactCount = 0;
+        size_t iRemovedContactCount = 0;
+
+    protected:
+        virtual void
+        onContactAdded(Node* pNode, const glm::vec3& hitWorldPosition, const glm::vec3& hitNormal) override {
+            iAddedContactCount += 1;
+        }
+        virtual void onContactRemoved(Node* pNode) override { iRemovedContactCount += 1; }
+    };
+
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            createWorld([this](Node* pRootNode) {
+                // Trigger that contains all bodies.
+                auto pTrigger = std::make_unique<CountingTriggerVolumeNode>();
+                auto pTriggerShape = std::make_unique<BoxCollisionShape>();
+                pTriggerShape->setHalfExtent(glm::vec3(
+                    static_cast<float>(iGridSizeX) + 10.0f, 50.0f, static_cast<float>(iGridSizeZ) + 10.0f));
+                pTrigger->setShape(std::move(pTriggerShape));
+                pTriggerNode = pRootNode->addChildNode(std::move(pTrigger));
+
+                // Bodies that don't touch each other.
+                for (size_t iX = 0; iX < iGridSizeX; iX++) {
+                    for (size_t iZ = 0; iZ < iGridSizeZ; iZ++) {
+                        auto pBody = std::make_unique<SimulatedBodyNode>();
+                        pBody->setRelativeLocation(glm::vec3(
+                            static_cast<float>(iX) * 2.0f - static_cast<float>(iGridSizeX),
+                            0.0f,
+                            static_cast<float>(iZ) * 2.0f - static_cast<float>(iGridSizeZ)));
+                        pRootNode->addChildNode(std::move(pBody));
+                    }
+                }
+            });
+        }
+        virtual ~TestGameInstance() override {}
+
+        virtual void onBeforeNewFrame(float timeSincePrevCallInSec) override {
+            if (pTriggerNode == nullptr) {
+                return;
+            }
+
+            iFrameCount += 1;
+            if (iFrameCount < 10) {
+                return;
+            }
+
+            // Bodies are still falling inside of the trigger.
+            REQUIRE(pTriggerNode->iAddedContactCount == iGridSizeX * iGridSizeZ);
+            REQUIRE(pTriggerNode->iRemovedContactCount == 0);
+            REQUIRE(
+                pTriggerNode->getWorldWhileSpawned()
+                    ->getGameManager()
+                    .getPhysicsManager()
+                    .getDroppedContactEventCount() == 0);
+
+            getWindow()->close();
+        }
+
+    private:
+        const size_t iGridSizeX = 50;
+        const size_t iGridSizeZ = 100;
+
+        CountingTriggerVolumeNode* pTriggerNode = nullptr;
+        size_t iFrameCount = 0;
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("crowd of characters is updated in parallel and characters still block each other") {
+    class WalkingCharacterNode : public CharacterBodyNode {
+    public:
+        WalkingCharacterNode(const glm::vec3& velocity) : velocity(velocity) {}
+        virtual ~WalkingCharacterNode() override = default;
+
+    protected:
+        virtual void onBeforePhysicsUpdate(float deltaTime) override {
+            CharacterBodyNode::onBeforePhysicsUpdate(deltaTime);
+            setLinearVelocity(velocity);
+        }
+
+    private:
+        const glm::vec3 velocity;
+    };
+
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            createWorld([this](Node* pRootNode) {
+                // Floor.
+                auto pFloor = std::make_unique<CollisionNode>();
+                auto pFloorShape = std::make_unique<BoxCollisionShape>();
+                pFloorShape->setHalfExtent(glm::vec3(200.0f, 0.5f, 200.0f));
+                pFloor->setShape(std::move(pFloorShape));
+                pFloor->setRelativeLocation(glm::vec3(0.0f, -0.5f, 0.0f));
+                pRootNode->addChildNode(std::move(pFloor));
+
+                // Characters far from each other that walk forward.
+                for (size_t iX = 0; iX < iGridSize; iX++) {
+                    for (size_t iZ = 0; iZ < iGridSize * 2; iZ++) {
+                        auto pCharacter = std::make_unique<WalkingCharacterNode>(glm::vec3(0.0f, 0.0f, 1.0f));
+                        pCharacter->setRelativeLocation(glm::vec3(
+                            static_cast<float>(iX) * 6.0f + 10.0f, 0.0f, static_cast<float>(iZ) * 6.0f));
+                        vWalkingCharacters.push_back(pRootNode->addChildNode(std::move(pCharacter)));
+                    }
+                }
+
+                // 2 characters that walk into each other.
+                auto pLeftCharacter = std::make_unique<WalkingCharacterNode>(glm::vec3(2.0f, 0.0f, 0.0f));
+                pLeftCharacter->setRelativeLocation(glm::vec3(-3.0f, 0.0f, -20.0f));
+                pLeftCharacterNode = pRootNode->addChildNode(std::move(pLeftCharacter));
+
+                auto pRightCharacter = std::make_unique<WalkingCharacterNode>(glm::vec3(-2.0f, 0.0f, 0.0f));
+                pRightCharacter->setRelativeLocation(glm::vec3(3.0f, 0.0f, -20.0f));
+                pRightCharacterNode = pRootNode->addChildNode(std::move(pRightCharacter));
+            });
+        }
+        virtual ~TestGameInstance() override {}
+
+        virtual void onBeforeNewFrame(float timeSincePrevCallInSec) override {
+            if (pLeftCharacterNode == nullptr) {
+                return;
+            }
+
+            timePassedSec += timeSincePrevCallInSec;
+            if (timePassedSec < 3.0f) {
+                return;
+            }
+
+            // Characters walked.
+            for (size_t i = 0; i < vWalkingCharacters.size(); i++) {
+                const auto iZ = i % (iGridSize * 2);
+                REQUIRE(vWalkingCharacters[i]->getWorldLocation().z > static_cast<float>(iZ) * 6.0f + 1.0f);
+            }
+
+            // Characters that walked into each other did not pass through each other.
+            const auto leftLocation = pLeftCharacterNode->getWorldLocation();
+            const auto rightLocation = pRightCharacterNode->getWorldLocation();
+            REQUIRE(leftLocation.x < rightLocation.x);
+            REQUIRE(
+                rightLocation.x - leftLocation.x > pLeftCharacterNode->getBodyShape().getRadius() * 1.5f);
+
+            getWindow()->close();
+        }
+
+    private:
+        const size_t iGridSize = 10;
+
+        std::vector<WalkingCharacterNode*> vWalkingCharacters;
+        WalkingCharacterNode* pLeftCharacterNode = nullptr;
+        WalkingCharacterNode* pRightCharacterNode = nullptr;
+        float timePassedSec = 0.0f;
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("character is teleported while the async physics step is pending") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            createWorld([this](Node* pRootNode) {
+                // Floor.
+                auto pFloor = std::make_unique<CollisionNode>();
+                auto pFloorShape = std::make_unique<BoxCollisionShape>();
+                pFloorShape->setHalfExtent(glm::vec3(100.0f, 0.5f, 100.0f));
+                pFloor->setShape(std::move(pFloorShape));
+                pFloor->setRelativeLocation(glm::vec3(0.0f, -0.5f, 0.0f));
+                pRootNode->addChildNode(std::move(pFloor));
+
+                // Bodies to keep the simulation busy while the character is teleported.
+                for (size_t i = 0; i < 200; i++) {
+                    auto pBody = std::make_unique<SimulatedBodyNode>();
+                    pBody->setRelativeLocation(glm::vec3(
+                        static_cast<float>(i % 10) * 2.0f + 20.0f,
+                        1.0f + static_cast<float>(i / 10) * 2.0f,
+                        0.0f));
+                    pRootNode->addChildNode(std::move(pBody));
+                }
+
+                pCharacterNode = pRootNode->addChildNode(std::make_unique<CharacterBodyNode>());
+
+                auto& physicsManager =
+                    pRootNode->getWorldWhileSpawned()->getGameManager().getPhysicsManager();
+                physicsManager.setEnableAsyncPhysicsStep(true);
+            });
+        }
+        virtual ~TestGameInstance() override {}
+
+        virtual void onBeforeNewFrame(float timeSincePrevCallInSec) override {
+            if (pCharacterNode == nullptr) {
+                return;
+            }
+
+            auto& physicsManager =
+                pCharacterNode->getWorldWhileSpawned()->getGameManager().getPhysicsManager();
+            if (!physicsManager.isAsyncPhysicsStepPending()) {
+                return;
+            }
+
+            if (iTeleportCount > 0) {
+                // The previous teleport was applied (the character only falls down to the floor).
+                const auto location = pCharacterNode->getWorldLocation();
+                REQUIRE(std::abs(location.x - lastTarget.x) < 0.01f);
+                REQUIRE(std::abs(location.z - lastTarget.z) < 0.01f);
+            }
+            if (iTeleportCount == iTotalTeleportCount) {
+                getWindow()->close();
+                return;
+            }
+
+            // Teleport while the step is running on the physics thread.
+            lastTarget = glm::vec3(
+                static_cast<float>(iTeleportCount % 5) * 3.0f,
+                0.5f,
+                static_cast<float>(iTeleportCount % 7) * 3.0f);
+            pCharacterNode->setWorldLocation(lastTarget);
+            iTeleportCount += 1;
+        }
+
+    private:
+        const size_t iTotalTeleportCount = 60;
+
+        CharacterBodyNode* pCharacterNode = nullptr;
+        glm::vec3 lastTarget = glm::vec3(0.0f);
+        size_t iTeleportCount = 0;
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("overlapping crowds of characters end up at the same positions in every run") {
+    class GatheringCharacterNode : public CharacterBodyNode {
+    public:
+        GatheringCharacterNode(const glm::vec3& velocity) : velocity(velocity) {}
+        virtual ~GatheringCharacterNode() override = default;
+
+        static constexpr size_t iTicksToRecord = 120;
+
+        std::optional<glm::vec3> optRecordedLocation;
+
+    protected:
+        virtual void onBeforePhysicsUpdate(float deltaTime) override {
+            CharacterBodyNode::onBeforePhysicsUpdate(deltaTime);
+            setLinearVelocity(velocity);
+
+            // Count ticks instead of time so that both runs simulate the same number of ticks.
+            iTickCount += 1;
+            if (iTickCount == iTicksToRecord) {
+                optRecordedLocation = getWorldLocation();
+            }
+        }
+
+    private:
+        const glm::vec3 velocity;
+        size_t iTickCount = 0;
+    };
+
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override { createCrowds(); }
+        virtual ~TestGameInstance() override {}
+
+        virtual void onBeforeNewFrame(float timeSincePrevCallInSec) override {
+            if (vCharacters.empty()) {
+                return;
+            }
+
+            for (const auto& pCharacter : vCharacters) {
+                if (!pCharacter->optRecordedLocation.has_value()) {
+                    return;
+                }
+            }
+
+            if (vFirstRunLocations.empty()) {
+                for (const auto& pCharacter : vCharacters) {
+                    vFirstRunLocations.push_back(*pCharacter->optRecordedLocation);
+                }
+
+                // Run again in a new world.
+                vCharacters.clear();
+                createCrowds();
+                return;
+            }
+
+            REQUIRE(vCharacters.size() == vFirstRunLocations.size());
+            for (size_t i = 0; i < vCharacters.size(); i++) {
+                const auto location = *vCharacters[i]->optRecordedLocation;
+                REQUIRE(glm::all(glm::epsilonEqual(location, vFirstRunLocations[i], 0.0001f)));
+            }
+
+            getWindow()->close();
+        }
+
+    private:
+        void createCrowds() {
+            createWorld([this](Node* pRootNode) {
+                // Floor.
+                auto pFloor = std::make_unique<CollisionNode>();
+                auto pFloorShape = std::make_unique<BoxCollisionShape>();
+                pFloorShape->setHalfExtent(glm::vec3(200.0f, 0.5f, 200.0f));
+                pFloor->setShape(std::move(pFloorShape));
+                pFloor->setRelativeLocation(glm::vec3(0.0f, -0.5f, 0.0f));
+                pRootNode->addChildNode(std::move(pFloor));
+
+                // Far away crowds (updated in parallel) where characters walk into each other.
+                for (size_t iCrowdX = 0; iCrowdX < iCrowdGridSize; iCrowdX++) {
+                    for (size_t iCrowdZ = 0; iCrowdZ < iCrowdGridSize; iCrowdZ++) {
+                        const auto crowdCenter = glm::vec3(
+                            static_cast<float>(iCrowdX) * 40.0f, 0.0f, static_cast<float>(iCrowdZ) * 40.0f);
+
+                        for (size_t iX = 0; iX < iCrowdSize; iX++) {
+                            for (size_t iZ = 0; iZ < iCrowdSize; iZ++) {
+                                const auto offset = glm::vec3(
+                                    (static_cast<float>(iX) - static_cast<float>(iCrowdSize / 2)) * 1.5f,
+                                    0.0f,
+                                    (static_cast<float>(iZ) - static_cast<float>(iCrowdSize / 2)) * 1.5f);
+
+                                // Walk to the center of the crowd.
+                                auto pCharacter = std::make_unique<GatheringCharacterNode>(-offset);
+                                pCharacter->setRelativeLocation(crowdCenter + offset);
+                                vCharacters.push_back(pRootNode->addChildNode(std::move(pCharacter)));
+                            }
+                        }
+                    }
+                }
+            });
+        }
+
+        const size_t iCrowdGridSize = 4;
+        const size_t iCrowdSize = 5;
+
+        std::vector<GatheringCharacterNode*> vCharacters;
+        std::vector<glm::vec3> vFirstRunLocations;
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+namespace {
+    /**
+     * Reference grouping of overlapping spheres that checks all pairs (the way characters were grouped
+     * before sort and sweep).
+     *
+     * @param vSpheres Spheres (center and radius).
+     *
+     * @return Group of each sphere (smallest sphere index of the group).
+     */
+    std::vector<size_t> groupOverlappingSpheresAllPairs(const std::vector<glm::vec4>& vSpheres) {
+        std::vector<size_t> vParents(vSpheres.size());
+        for (size_t i = 0; i < vParents.size(); i++) {
+            vParents[i] = i;
+        }
+        const auto findRoot = [&vParents](size_t i) {
+            while (vParents[i] != i) {
+                i = vParents[i];
+            }
+            return i;
+        };
+
+        for (size_t i = 0; i < vSpheres.size(); i++) {
+            for (size_t j = i + 1; j < vSpheres.size(); j++) {
+                const auto maxDistance = vSpheres[i].w + vSpheres[j].w;
+                const auto toSecond = glm::vec3(vSpheres[j]) - glm::vec3(vSpheres[i]);
+                if (glm::dot(toSecond, toSecond) > maxDistance * maxDistance) {
+                    continue;
+                }
+                const auto iFirstRoot = findRoot(i);
+                const auto iSecondRoot = findRoot(j);
+                vParents[std::max(iFirstRoot, iSecondRoot)] = std::min(iFirstRoot, iSecondRoot);
+            }
+        }
+        for (size_t i = 0; i < vParents.size(); i++) {
+            vParents[i] = findRoot(i);
+        }
+
+        return vParents;
+    }
+}
+
+TEST_CASE("measure grouping of a dense crowd of 200 characters with sort and sweep and all pairs") {
+    constexpr size_t iCharacterCount = 200;
+    constexpr size_t iRepeatCount = 1000;
+
+    // Reach of a character with the default capsule and max step height that walks at 3 m/s.
+    constexpr float reach = 1.1f + 0.4f + 3.0f * PhysicsManager::physicsTickTimeSec + 1.0f;
+
+    // Dense crowd: a grid of characters 1.5 m apart (all touch each other), then the same number of
+    // characters scattered over a 150 m square (only some touch each other).
+    std::vector<glm::vec4> vDenseCrowd;
+    for (size_t i = 0; i < iCharacterCount; i++) {
+        vDenseCrowd.push_back(glm::vec4(
+            static_cast<float>(i % 20) * 1.5f, 1.1f, static_cast<float>(i / 20) * 1.5f, reach));
+    }
+    std::vector<glm::vec4> vScatteredCrowd;
+    std::mt19937 generator(42); // fixed seed to get the same crowd in every run
+    std::uniform_real_distribution<float> distribution(0.0f, 150.0f);
+    for (size_t i = 0; i < iCharacterCount; i++) {
+        vScatteredCrowd.push_back(glm::vec4(distribution(generator), 1.1f, distribution(generator), reach));
+    }
+
+    for (const auto& [sCrowdName, vSpheres] :
+         {std::pair{"dense", vDenseCrowd}, std::pair{"scattered", vScatteredCrowd}}) {
+        // Both ways find the same groups.
+        std::vector<size_t> vGroups;
+        std::vector<size_t> vSweepOrder;
+        PhysicsManager::groupOverlappingSpheres(vSpheres, vGroups, vSweepOrder);
+        const auto vReferenceGroups = groupOverlappingSpheresAllPairs(vSpheres);
+        REQUIRE(vGroups == vReferenceGroups);
+
+        size_t iGroupCount = 0;
+        for (size_t i = 0; i < vGroups.size(); i++) {
+            if (vGroups[i] == i) {
+                iGroupCount += 1;
+            }
+        }
+
+        // Measure.
+        size_t iChecksum = 0;
+        auto startTime = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iRepeatCount; i++) {
+            iChecksum += groupOverlappingSpheresAllPairs(vSpheres).back();
+        }
+        const auto allPairsTimeMs =
+            std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+        startTime = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iRepeatCount; i++) {
+            PhysicsManager::groupOverlappingSpheres(vSpheres, vGroups, vSweepOrder);
+            iChecksum += vGroups.back();
+        }
+        const auto sweepTimeMs =
+            std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        REQUIRE(iChecksum == vReferenceGroups.back() * iRepeatCount * 2);
+
+        Log::info(std::format(
+            "grouping {} crowd of {} characters: {} groups, all pairs {:.4F} ms, sort and sweep {:.4F} ms "
+            "({:.1F}x faster)",
+            sCrowdName,
+            iCharacterCount,
+            iGroupCount,
+            allPairsTimeMs / static_cast<float>(iRepeatCount),
+            sweepTimeMs / static_cast<float>(iRepeatCount),
+            allPairsTimeMs / std::max(sweepTimeMs, 0.001f)));
+    }
+}
+
+TEST_CASE("cooked mesh and height field collision shapes") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            createWorld([this](Node* pRootNode) {
+                const auto pathToTestDir =
+                    ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sTestDirName;
+                const auto sPathToMeshRelativeRes =
+                    std::string(sTestDirName) + "/" + std::string(vUsedTestFileNames[14]);
+                const auto sPathToHeightFieldRelativeRes =
+                    std::string(sTestDirName) + "/" + std::string(vUsedTestFileNames[15]);
+
+                // Prepare and cook mesh.
+                const auto pathToMesh = pathToTestDir / vUsedTestFileNames[14];
+                PrimitiveMeshGenerator::createCube(2.0f).serialize(pathToMesh);
+                auto optionalError = MeshCollisionShape::cookMesh(pathToMesh);
+                if (optionalError.has_value()) [[unlikely]] {
+                    optionalError->addCurrentLocationToErrorStack();
+                    INFO(optionalError->getFullErrorMessage());
+                    REQUIRE(false);
+                }
+                REQUIRE(std::filesystem::exists(MeshCollisionShape::getPathToCookedMesh(pathToMesh)));
+
+                // Prepare and cook height field (a slope).
+                constexpr unsigned int iSampleCount = 16;
+                std::vector<float> vHeights(iSampleCount * iSampleCount);
+                for (unsigned int iZ = 0; iZ < iSampleCount; iZ++) {
+                    for (unsigned int iX = 0; iX < iSampleCount; iX++) {
+                        vHeights[iZ * iSampleCount + iX] = static_cast<float>(iX) * 0.5f;
+                    }
+                }
+                HeightFieldGeometry heightField;
+                heightField.setHeights(vHeights, iSampleCount);
+                heightField.setSampleSpacing(2.0f);
+
+                const auto pathToHeightField = pathToTestDir / vUsedTestFileNames[15];
+                heightField.serialize(pathToHeightField);
+                optionalError = HeightFieldCollisionShape::cookHeightField(pathToHeightField);
+                if (optionalError.has_value()) [[unlikely]] {
+                    optionalError->addCurrentLocationToErrorStack();
+                    INFO(optionalError->getFullErrorMessage());
+                    REQUIRE(false);
+                }
+                REQUIRE(std::filesystem::exists(
+                    HeightFieldCollisionShape::getPathToCookedHeightField(pathToHeightField)));
+
+                // 16-bit samples should keep heights precise.
+                const auto deserializedHeightField = HeightFieldGeometry::deserialize(pathToHeightField);
+                REQUIRE(deserializedHeightField.getSampleCount() == iSampleCount);
+                const auto vDeserializedHeights = deserializedHeightField.getHeights();
+                for (size_t i = 0; i < vHeights.size(); i++) {
+                    REQUIRE(std::abs(vDeserializedHeights[i] - vHeights[i]) < 0.001f);
+                }
+
+                // Spawn bodies.
+                auto pMeshShape = std::make_unique<MeshCollisionShape>();
+                pMeshShape->setPathToGeometryRelativeRes(sPathToMeshRelativeRes);
+                auto pMeshNode = std::make_unique<CollisionNode>();
+                pMeshNode->setShape(std::move(pMeshShape));
+                pRootNode->addChildNode(std::move(pMeshNode));
+
+                auto pHeightFieldShape = std::make_unique<HeightFieldCollisionShape>();
+                pHeightFieldShape->setPathToGeometryRelativeRes(sPathToHeightFieldRelativeRes);
+                auto pHeightFieldNode = std::make_unique<CollisionNode>();
+                pHeightFieldNode->setShape(std::move(pHeightFieldShape));
+                pHeightFieldNode->setRelativeLocation(glm::vec3(100.0f, 0.0f, 0.0f));
+                pRootNode->addChildNode(std::move(pHeightFieldNode));
+
+                // Check collision.
+                auto& physicsManager =
+                    pRootNode->getWorldWhileSpawned()->getGameManager().getPhysicsManager();
+                const auto optionalMeshHit = physicsManager.castRayUntilHit(
+                    glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f, -10.0f, 0.0f));
+                REQUIRE(optionalMeshHit.has_value());
+                REQUIRE(optionalMeshHit->hitPosition.y > 0.0f);
+
+                // The grid is centered so the center of the height field is in the middle of the slope.
+                const auto optionalHeightFieldHit = physicsManager.castRayUntilHit(
+                    glm::vec3(100.0f, 10.0f, 0.0f), glm::vec3(100.0f, -10.0f, 0.0f));
+                REQUIRE(optionalHeightFieldHit.has_value());
+                REQUIRE(std::abs(optionalHeightFieldHit->hitPosition.y - 3.75f) < 0.1f);
+
+                getWindow()->close();
+            });
+        }
+        virtual ~TestGameInstance() override {}
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
@@ -0,0 +1,135 @@
+// Standard.
+#include <memory>
+#include <optional>
+
+// Custom.
+#include "game/GameInstance.h"
+#include "game/World.h"
+#include "game/Window.h"
+#include "game/node/CameraNode.h"
+#include "game/node/ParticleEmitterNode.h"
+#include "render/Renderer.h"
+#include "render/FrameStreamingBuffer.h"
+#include "render/GpuMemoryTracker.h"
+
+// External.
+#include "catch2/catch_test_macros.hpp"
+
+TEST_CASE("streaming buffer reuses frame regions and frees a grown buffer after its frames finished") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            createWorld([this](Node* pRootNode) {
+                pWorldRootNode = pRootNode;
+
+                // Particles are only drawn for an active camera.
+                const auto pCamera = pRootNode->addChildNode(std::make_unique<CameraNode>());
+                pCamera->makeActive();
+
+                // Each emitter streams a full particle uniform block every frame.
+                spawnEmitters(iEmitterCount);
+
+                const auto& streamingBuffer = getRenderer()->getStreamingBuffer();
+                iInitialFrameRegionSize = streamingBuffer.getFrameRegionSize();
+                REQUIRE(iEmitterCount * iParticleBlockSize < iInitialFrameRegionSize);
+            });
+        }
+        virtual ~TestGameInstance() override {}
+
+        virtual void onBeforeNewFrame(float timeSincePrevCallInSec) override {
+            if (pWorldRootNode == nullptr) {
+                return;
+            }
+            iFrameCount += 1;
+
+            const auto& streamingBuffer = getRenderer()->getStreamingBuffer();
+            const auto bufferStats = GpuMemoryTracker::getStats(GpuResourceCategory::BUFFER);
+
+            if (!bSpawnedMoreEmitters) {
+                // Data of all frames together does not fit into a region so regions must be reused.
+                REQUIRE(streamingBuffer.getFrameRegionSize() == iInitialFrameRegionSize);
+                if (iFrameCount < iWrapAroundFrameCount) {
+                    return;
+                }
+                REQUIRE(streamingBuffer.getStreamedBytesLastFrame() > 0);
+                REQUIRE(iWrapAroundFrameCount * iEmitterCount * iParticleBlockSize > iInitialFrameRegionSize);
+
+                // Make a single frame need more space than a region has.
+                spawnEmitters(iEmitterCount);
+                bSpawnedMoreEmitters = true;
+                return;
+            }
+
+            if (!optGrowFrame.has_value()) {
+                if (streamingBuffer.getFrameRegionSize() == iInitialFrameRegionSize) {
+                    // Wait for new particles to be drawn.
+                    REQUIRE(iFrameCount < iWrapAroundFrameCount * 2);
+                    return;
+                }
+
+                // The old buffer is still alive because the GPU might still read it.
+                optGrowFrame = iFrameCount;
+                iBufferBytesAfterGrow = bufferStats.iTotalBytes;
+                return;
+            }
+
+            // The region should not grow again.
+            REQUIRE(streamingBuffer.getFrameRegionSize() > iInitialFrameRegionSize);
+            REQUIRE(streamingBuffer.getFrameRegionSize() >= iEmitterCount * 2 * iParticleBlockSize);
+
+            if (iFrameCount - *optGrowFrame < iFramesInFlight) {
+                // Frames in-flight that could use the old buffer did not finish yet.
+                REQUIRE(bufferStats.iTotalBytes == iBufferBytesAfterGrow);
+                return;
+            }
+
+            // All frames that could use the old buffer finished (their fences were waited).
+            REQUIRE(
+                bufferStats.iTotalBytes ==
+                iBufferBytesAfterGrow - static_cast<size_t>(iInitialFrameRegionSize) * iFramesInFlight);
+
+            getWindow()->close();
+        }
+
+    private:
+        /**
+         * Spawns particle emitters that keep their particles alive.
+         *
+         * @param iCount Number of emitters to spawn.
+         */
+        void spawnEmitters(size_t iCount) {
+            for (size_t i = 0; i < iCount; i++) {
+                auto pEmitter = std::make_unique<ParticleEmitterNode>();
+                pEmitter->setRelativeLocation(glm::vec3(5.0f, 0.0f, 0.0f));
+                pEmitter->setTimeToLive(100.0f);
+                pEmitter->setDelayBetweenSpawns(0.1f);
+                pWorldRootNode->addChildNode(std::move(pEmitter));
+            }
+        }
+
+        /** Size of the particle uniform block in the shader (512 particles of 32 bytes). */
+        const size_t iParticleBlockSize = 512 * 32;
+
+        const size_t iEmitterCount = 20;
+        const size_t iWrapAroundFrameCount = 30;
+
+        Node* pWorldRootNode = nullptr;
+        unsigned int iInitialFrameRegionSize = 0;
+        size_t iFrameCount = 0;
+        bool bSpawnedMoreEmitters = false;
+        std::optional<size_t> optGrowFrame;
+        size_t iBufferBytesAfterGrow = 0;
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
@@ -0,0 +1,117 @@
+// Standard.
+#include <vector>
+#include <string>
+
+// Custom.
+#include "game/GameInstance.h"
+#include "game/Window.h"
+#include "render/GpuResourceManager.h"
+#include "render/GpuMemoryTracker.h"
+#include "render/Renderer.h"
+#include "material/TextureManager.h"
+#include "misc/ProjectPaths.h"
+#include "TestFilePaths.hpp"
+
+// External.
+#include "catch2/catch_test_macros.hpp"
+#include "stb/stb_image_write.h"
+
+TEST_CASE("GPU memory tracker counts created and destroyed buffers") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            constexpr unsigned int iBufferSize = 4096;
+
+            const auto initialStats = GpuMemoryTracker::getStats(GpuResourceCategory::BUFFER);
+            {
+                const auto pBuffer = GpuResourceManager::createUniformBuffer(iBufferSize, true);
+
+                const auto stats = GpuMemoryTracker::getStats(GpuResourceCategory::BUFFER);
+                REQUIRE(stats.iLiveResourceCount == initialStats.iLiveResourceCount + 1);
+                REQUIRE(stats.iTotalBytes == initialStats.iTotalBytes + iBufferSize);
+                REQUIRE(stats.iPeakBytes >= stats.iTotalBytes);
+            }
+
+            // Peak should stay.
+            const auto stats = GpuMemoryTracker::getStats(GpuResourceCategory::BUFFER);
+            REQUIRE(stats.iLiveResourceCount == initialStats.iLiveResourceCount);
+            REQUIRE(stats.iTotalBytes == initialStats.iTotalBytes);
+            REQUIRE(stats.iPeakBytes >= initialStats.iTotalBytes + iBufferSize);
+
+            getWindow()->close();
+        }
+        virtual ~TestGameInstance() override {}
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("GPU memory tracker counts textures of the texture manager") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            // Prepare a texture.
+            constexpr int iSize = 8;
+            const auto sPathToTextureRelativeRes =
+                std::string(sTestDirName) + "/" + std::string(vUsedTestFileNames[18]) + ".png";
+            const auto pathToTexture =
+                ProjectPaths::getPathToResDirectory(ResourceDirectory::ROOT) / sPathToTextureRelativeRes;
+            const std::vector<uint8_t> vPixels(static_cast<size_t>(iSize * iSize * 4), 255);
+            REQUIRE(
+                stbi_write_png(pathToTexture.string().c_str(), iSize, iSize, 4, vPixels.data(), iSize * 4) !=
+                0);
+
+            auto& textureManager = getRenderer()->getTextureManager();
+            const auto bWasUsingTextureCompression = textureManager.isUsingTextureCompression();
+            textureManager.setUseTextureCompression(false);
+
+            const auto initialStats = GpuMemoryTracker::getStats(GpuResourceCategory::TEXTURE);
+            {
+                auto result = textureManager.getTexture(sPathToTextureRelativeRes, TextureUsage::DIFFUSE);
+                if (std::holds_alternative<Error>(result)) [[unlikely]] {
+                    INFO(std::get<Error>(result).getFullErrorMessage());
+                    REQUIRE(false);
+                }
+                const auto pTexture = std::get<std::unique_ptr<TextureHandle>>(std::move(result));
+
+                // The first mip plus all other mips.
+                constexpr size_t iFirstMipSize = static_cast<size_t>(iSize * iSize * 4);
+                const auto stats = GpuMemoryTracker::getStats(GpuResourceCategory::TEXTURE);
+                REQUIRE(stats.iLiveResourceCount == initialStats.iLiveResourceCount + 1);
+                REQUIRE(stats.iTotalBytes == initialStats.iTotalBytes + iFirstMipSize + iFirstMipSize / 3);
+            }
+
+            // Released texture should be unregistered.
+            const auto stats = GpuMemoryTracker::getStats(GpuResourceCategory::TEXTURE);
+            REQUIRE(stats.iLiveResourceCount == initialStats.iLiveResourceCount);
+            REQUIRE(stats.iTotalBytes == initialStats.iTotalBytes);
+
+            textureManager.setUseTextureCompression(bWasUsingTextureCompression);
+
+            getWindow()->close();
+        }
+        virtual ~TestGameInstance() override {}
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
@@ -0,0 +1,238 @@
+// Standard.
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+
+// Custom.
+#include "game/GameInstance.h"
+#include "game/Window.h"
+#include "render/Renderer.h"
+#include "render/ShaderManager.h"
+#include "render/wrapper/ShaderProgram.h"
+#include "io/Log.h"
+
+// External.
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "glad/glad.h"
+
+namespace {
+    /** Results of a single window session that created engine shader programs. */
+    struct ShaderCacheSessionResult {
+        /** Time from the start of the window creation to the first game frame. */
+        float timeToFirstFrameMs = 0.0f;
+
+        /** Time from the start of the window creation to the moment no more programs were created. */
+        float timeToAllProgramsCreatedMs = 0.0f;
+
+        /** Program statistics of the shader manager at the end of the session. */
+        ShaderProgramCreationStats stats;
+
+        /** Directory of the program binary cache (empty if program binaries are not supported). */
+        std::filesystem::path pathToProgramBinaryCache;
+    };
+
+    /** Result of the last session started by @ref runShaderCacheSession. */
+    ShaderCacheSessionResult lastShaderCacheSession;
+
+    /** Time when the last session started creating its window. */
+    std::chrono::steady_clock::time_point sessionStartTime;
+
+    /**
+     * Creates a window, waits until the renderer stops creating shader programs and closes the window.
+     *
+     * @return Session results.
+     */
+    ShaderCacheSessionResult runShaderCacheSession() {
+        class TestGameInstance : public GameInstance {
+        public:
+            TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+            virtual ~TestGameInstance() override {}
+
+            virtual void onBeforeNewFrame(float timeSincePrevCallInSec) override {
+                auto& shaderManager = getRenderer()->getShaderManager();
+                const auto stats = shaderManager.getProgramCreationStats();
+                const auto iCreatedProgramCount =
+                    stats.iProgramsCompiledCount + stats.iProgramsLoadedFromCacheCount;
+
+                if (iFrameCount == 0) {
+                    lastShaderCacheSession.timeToFirstFrameMs = getTimeSinceSessionStartMs();
+                }
+                iFrameCount += 1;
+
+                // Some programs are created on the shader compile thread, wait for them.
+                if (iCreatedProgramCount != iLastCreatedProgramCount) {
+                    iLastCreatedProgramCount = iCreatedProgramCount;
+                    iStableFrameCount = 0;
+                    lastShaderCacheSession.timeToAllProgramsCreatedMs = getTimeSinceSessionStartMs();
+                    return;
+                }
+                iStableFrameCount += 1;
+                if (iStableFrameCount < iRequiredStableFrameCount) {
+                    return;
+                }
+
+                lastShaderCacheSession.stats = stats;
+                lastShaderCacheSession.pathToProgramBinaryCache = shaderManager.getPathToProgramBinaryCache();
+
+                getWindow()->close();
+            }
+
+        private:
+            static float getTimeSinceSessionStartMs() {
+                return std::chrono::duration<float, std::milli>(
+                           std::chrono::steady_clock::now() - sessionStartTime)
+                    .count();
+            }
+
+            const size_t iRequiredStableFrameCount = 10;
+
+            size_t iFrameCount = 0;
+            size_t iStableFrameCount = 0;
+            size_t iLastCreatedProgramCount = 0;
+        };
+
+        lastShaderCacheSession = {};
+        sessionStartTime = std::chrono::steady_clock::now();
+
+        auto result = WindowBuilder().hidden().build();
+        if (std::holds_alternative<Error>(result)) [[unlikely]] {
+            Error error = std::get<Error>(std::move(result));
+            error.addCurrentLocationToErrorStack();
+            INFO(error.getFullErrorMessage());
+            REQUIRE(false);
+        }
+
+        const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+        pMainWindow->processEvents<TestGameInstance>();
+
+        return lastShaderCacheSession;
+    }
+}
+
+TEST_CASE("uniform handles reference the same locations as uniform names") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            const auto colorUniform = ShaderProgram::getUniformHandle("color");
+            REQUIRE(colorUniform.isValid());
+            REQUIRE(!ShaderUniformHandle().isValid());
+
+            const auto pShaderProgram = getRenderer()->getShaderManager().getShaderProgram(
+                "engine/shaders/ui/UiScreenQuad.vert.glsl", "engine/shaders/ui/RectUiNode.frag.glsl");
+            REQUIRE(pShaderProgram->isReady());
+
+            REQUIRE(pShaderProgram->getShaderUniformLocation(colorUniform) >= 0);
+            REQUIRE(
+                pShaderProgram->getShaderUniformLocation(colorUniform) ==
+                pShaderProgram->getShaderUniformLocation("color"));
+
+            // Uniforms that the program does not use.
+            const auto unusedUniform = ShaderProgram::getUniformHandle("thisUniformDoesNotExist");
+            REQUIRE(pShaderProgram->tryGetShaderUniformLocation(unusedUniform) == -1);
+            REQUIRE(pShaderProgram->tryGetShaderUniformLocation(ShaderUniformHandle()) == -1);
+
+            getWindow()->close();
+        }
+        virtual ~TestGameInstance() override {}
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("benchmark setting 10k uniforms per frame by names and by handles") {
+    class TestGameInstance : public GameInstance {
+    public:
+        TestGameInstance(Window* pWindow) : GameInstance(pWindow) {}
+        virtual void onGameStarted() override {
+            constexpr size_t iUniformsPerFrame = 10000;
+
+            const auto pShaderProgram = getRenderer()->getShaderManager().getShaderProgram(
+                "engine/shaders/ui/UiScreenQuad.vert.glsl", "engine/shaders/ui/RectUiNode.frag.glsl");
+            glUseProgram(pShaderProgram->getShaderProgramId());
+
+            const glm::vec4 color(1.0f, 0.5f, 0.25f, 1.0f);
+
+            BENCHMARK("by names") {
+                for (size_t i = 0; i < iUniformsPerFrame / 2; i++) {
+                    pShaderProgram->setVector4ToActiveProgram("color", color);
+                    pShaderProgram->setBoolToActiveProgram("bIsUsingTexture", false);
+                }
+            };
+
+            const auto colorUniform = ShaderProgram::getUniformHandle("color");
+            const auto isUsingTextureUniform = ShaderProgram::getUniformHandle("bIsUsingTexture");
+
+            BENCHMARK("by handles") {
+                for (size_t i = 0; i < iUniformsPerFrame / 2; i++) {
+                    pShaderProgram->setVector4ToActiveProgram(colorUniform, color);
+                    pShaderProgram->setBoolToActiveProgram(isUsingTextureUniform, false);
+                }
+            };
+
+            glUseProgram(0);
+
+            getWindow()->close();
+        }
+        virtual ~TestGameInstance() override {}
+    };
+
+    auto result = WindowBuilder().hidden().build();
+    if (std::holds_alternative<Error>(result)) [[unlikely]] {
+        Error error = std::get<Error>(std::move(result));
+        error.addCurrentLocationToErrorStack();
+        INFO(error.getFullErrorMessage());
+        REQUIRE(false);
+    }
+
+    const std::unique_ptr<Window> pMainWindow = std::get<std::unique_ptr<Window>>(std::move(result));
+    pMainWindow->processEvents<TestGameInstance>();
+}
+
+TEST_CASE("measure cold and warm startup with the shader program binary cache") {
+    // Find where the cache of this driver is stored and clear it.
+    const auto pathToCache = runShaderCacheSession().pathToProgramBinaryCache;
+    if (pathToCache.empty()) {
+        WARN("the driver does not support program binaries, skipping the test");
+        return;
+    }
+    std::filesystem::remove_all(pathToCache);
+
+    // Cold: all programs are compiled and stored in the cache.
+    const auto cold = runShaderCacheSession();
+    REQUIRE(cold.stats.iProgramsCompiledCount > 0);
+    REQUIRE(cold.stats.iProgramsLoadedFromCacheCount == 0);
+    REQUIRE(std::filesystem::exists(pathToCache));
+
+    // Warm: the same programs are loaded from the cache.
+    const auto warm = runShaderCacheSession();
+    REQUIRE(warm.stats.iProgramsCompiledCount == 0);
+    REQUIRE(warm.stats.iProgramsLoadedFromCacheCount == cold.stats.iProgramsCompiledCount);
+
+    Log::info(std::format(
+        "cold startup: {:.1F} ms to first frame, {:.1F} ms until all programs created, {} programs compiled "
+        "in {:.1F} ms",
+        cold.timeToFirstFrameMs,
+        cold.timeToAllProgramsCreatedMs,
+        cold.stats.iProgramsCompiledCount,
+        cold.stats.programCreationTimeMs));
+    Log::info(std::format(
+        "warm startup: {:.1F} ms to first frame, {:.1F} ms until all programs created, {} programs loaded "
+        "from the cache in {:.1F} ms ({:.1F}x faster program creation)",
+        warm.timeToFirstFrameMs,
+        warm.timeToAllProgramsCreatedMs,
+        warm.stats.iProgramsLoadedFromCacheCount,
+        warm.stats.programCreationTimeMs,
+        cold.stats.programCreationTimeMs / std::max(warm.stats.programCreationTimeMs, 0.001f)));
+}